@@ -33,6 +33,8 @@ Item {
     property string extension: ""
     property string sectionKey: ""
     property var itemData: null
+    // Bound to the model's value role so external changes refresh the editor in place
+    property var value: undefined
     property int complexityLevel: 0
     
     height: itemLayout.height
@@ -104,6 +106,7 @@ Item {
     }
     
     Component.onCompleted: loadValue()
+    onValueChanged: loadValue()
     
     RowLayout {
         id: itemLayout
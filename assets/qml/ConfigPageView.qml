@@ -30,10 +30,16 @@ Item {
     property string extension: ""
     property int complexityLevel: 0
     
+    // Sections filtered by complexity in C++; values are patched in place by the bridge
+    property var sectionsModel: (domain && extension) ?
+                                ConfigManagerBridge.sectionsModel(domain, extension) : null
+    property var pageInfo: (domain && extension) ?
+                           ConfigManagerBridge.getPageInfo(domain, extension) : ({})
+
     function refresh() {
-        loadPage()
+        pageInfo = (domain && extension) ? ConfigManagerBridge.getPageInfo(domain, extension) : ({})
     }
-    
+
     function complexityToIndex(c) {
         var v = (c || "basic").toString().toLowerCase()
         if (v === "advanced") return 1
@@ -41,39 +47,6 @@ Item {
         if (v === "developer" || v === "dev") return 3
         return 0
     }
-
-    function loadPage() {
-        if (!domain || !extension) {
-            return
-        }
-        
-        var page = ConfigManagerBridge.getConfigPage(domain, extension)
-        if (!page || !page.sections) {
-            sectionsData = []
-            return
-        }
-        
-        // Filter sections by complexity level
-        var filtered = []
-        for (var i = 0; i < page.sections.length; i++) {
-            var section = page.sections[i]
-            if (complexityToIndex(section.complexity) <= complexityLevel) {
-                filtered.push(section)
-            }
-        }
-        sectionsData = filtered
-        
-        pageTitle.text = page.title || ""
-        pageDescription.text = page.description || ""
-    }
-    
-    onDomainChanged: loadPage()
-    onExtensionChanged: loadPage()
-    onComplexityLevelChanged: loadPage()
-    
-    Component.onCompleted: loadPage()
-    
-    property var sectionsData: []
     
     ColumnLayout {
         anchors.fill: parent
@@ -87,6 +60,7 @@ Item {
             
             Text {
                 id: pageTitle
+                text: root.pageInfo.title || ""
                 font.pixelSize: 20
                 font.bold: true
                 color: ThemeManager.textColor
@@ -95,6 +69,7 @@ Item {
             
             Text {
                 id: pageDescription
+                text: root.pageInfo.description || ""
                 font.pixelSize: 13
                 color: ThemeManager.textSecondaryColor
                 wrapMode: Text.WordWrap
@@ -122,10 +97,10 @@ Item {
                 spacing: 20
                 
                 Repeater {
-                    model: sectionsData ? sectionsData.length : 0
+                    model: root.sectionsModel
                     
                     delegate: ColumnLayout {
-                        property var section: sectionsData[index]
+                        property var section: model
                         Layout.fillWidth: true
                         spacing: 10
                         
@@ -154,7 +129,7 @@ Item {
                                 Layout.preferredWidth: complexityText.width + 16
                                 Layout.preferredHeight: 20
                                 color: {
-                                    var c = section && (section.complexity || "basic").toString().toLowerCase()
+                                    var c = section && (section.complexityName || "basic").toString().toLowerCase()
                                     if (c === "basic") return "#4CAF50"
                                     if (c === "advanced") return "#FF9800"
                                     if (c === "expert") return "#F44336"
@@ -162,13 +137,13 @@ Item {
                                     return "#9E9E9E"
                                 }
                                 radius: 10
-                                visible: section && complexityToIndex(section.complexity) > 0
+                                visible: section && complexityToIndex(section.complexityName) > 0
                                 
                                 Text {
                                     id: complexityText
                                     anchors.centerIn: parent
                                     text: {
-                                        var c = section && (section.complexity || "basic").toString().toLowerCase()
+                                        var c = section && (section.complexityName || "basic").toString().toLowerCase()
                                         if (c === "basic") return "Basic"
                                         if (c === "advanced") return "Advanced"
                                         if (c === "expert") return "Expert"
@@ -198,13 +173,14 @@ Item {
                             spacing: 15
                             
                             Repeater {
-                                model: section && section.items ? section.items.length : 0
+                                model: section ? section.items : null
                                 delegate: ConfigItemView {
                                     Layout.fillWidth: true
                                     domain: root.domain
                                     extension: root.extension
                                     sectionKey: section ? section.key : ""
-                                    itemData: section ? section.items[index] : null
+                                    itemData: model.itemData
+                                    value: model.value
                                     complexityLevel: root.complexityLevel
                                 }
                             }
@@ -230,7 +206,7 @@ Item {
                     horizontalAlignment: Text.AlignHCenter
                     Layout.fillWidth: true
                     Layout.topMargin: 50
-                    visible: !sectionsData || sectionsData.length === 0
+                    visible: !root.sectionsModel || root.sectionsModel.count === 0
                 }
             }
         }
@@ -39,69 +39,21 @@ Rectangle {
     signal closed()
     
     Component.onCompleted: {
-        loadConfigPages()
+        selectInitialPage()
     }
-    
-    // Domain/page data for sidebar; array of { domain, pages: [{extension,title}] }
-    property var domainsData: [];
-
-    function complexityToIndex(c) {
-        var v = (c || "basic").toString().toLowerCase();
-        if (v === "advanced") return 1;
-        if (v === "expert") return 2;
-        if (v === "developer" || v === "dev") return 3;
-        return 0;
-    }
-
-    function loadConfigPages() {
-        var pages = ConfigManagerBridge.getAllConfigPages();
-        var grouped = {};
-
-        // Group pages by domain, filtering by complexity level
-        for (var i = 0; i < pages.length; i++) {
-            var page = pages[i];
-            // Filter pages by complexity level
-            if (complexityToIndex(page.complexity) > currentComplexity) {
-                continue
-            }
-            if (!grouped[page.domain]) {
-                grouped[page.domain] = [];
-            }
-            grouped[page.domain].push({ extension: page.extension, title: page.title });
-        }
 
-        // Convert to ordered array for UI, prioritising system and user interface
-        var result = [];
-        var priorityDomains = ["system", "user interface"];
-        
-        // Add priority domains first (in order)
-        for (var p = 0; p < priorityDomains.length; p++) {
-            var priorityDomain = priorityDomains[p];
-            if (grouped[priorityDomain]) {
-                result.push({ domain: priorityDomain, pages: grouped[priorityDomain] });
-            }
-        }
-        
-        // Add remaining domains
-        for (var d in grouped) {
-            if (priorityDomains.indexOf(d) === -1) {
-                result.push({ domain: d, pages: grouped[d] });
-            }
-        }
-        domainsData = result;
+    // Pages come from a C++ model that is filtered by complexity and ordered with the
+    // system and user interface domains first; no JS-side regrouping is needed.
+    readonly property var pagesModel: ConfigManagerBridge.pagesModel
 
-        // Select initial or first domain and extension
+    function selectInitialPage() {
         if (initialDomain !== "" && initialExtension !== "") {
             currentDomain = initialDomain;
             currentExtension = initialExtension;
-        } else if (domainsData.length > 0) {
-            currentDomain = domainsData[0].domain;
-            var firstPages = domainsData[0].pages || [];
-            if (firstPages.length > 0) {
-                currentExtension = firstPages[0].extension;
-            } else {
-                currentExtension = "";
-            }
+        } else if (pagesModel && pagesModel.count > 0) {
+            var first = pagesModel.get(0);
+            currentDomain = first.domain;
+            currentExtension = first.extension;
         } else {
             currentDomain = "";
             currentExtension = "";
@@ -110,17 +62,13 @@ Rectangle {
 
     // Programmatic navigation helper
     function openPage(domain, extension) {
-        if (!domainsData || domainsData.length === 0) return;
-        for (var i = 0; i < domainsData.length; ++i) {
-            var d = domainsData[i];
-            if (d.domain === domain) {
-                for (var j = 0; j < d.pages.length; ++j) {
-                    if (d.pages[j].extension === extension) {
-                        currentDomain = domain;
-                        currentExtension = extension;
-                        return;
-                    }
-                }
+        if (!pagesModel) return;
+        for (var i = 0; i < pagesModel.count; ++i) {
+            var page = pagesModel.get(i);
+            if (page.domain === domain && page.extension === extension) {
+                currentDomain = domain;
+                currentExtension = extension;
+                return;
             }
         }
     }
@@ -159,8 +107,6 @@ Rectangle {
                     onCurrentIndexChanged: {
                         currentComplexity = currentIndex
                         ConfigManagerBridge.setComplexityLevel(model[currentIndex])
-                        // Reload pages when complexity changes
-                        loadConfigPages()
                     }
                 }
             }
@@ -211,66 +157,55 @@ Rectangle {
                         color: ThemeManager.textColor
                     }
 
-                    // Use JS-array-backed model to support nested pages without ListModel role limits
                     ListView {
                         Layout.fillWidth: true
                         Layout.fillHeight: true
-                        model: domainsData
+                        model: root.pagesModel
                         ScrollBar.vertical: ScrollBar { }
 
-                        delegate: ColumnLayout {
-                            width: parent ? parent.width : 0
-                            spacing: 2
-                            property string domainName: (modelData && modelData.domain) ? modelData.domain : ""
-
-                            // Domain header
-                            Rectangle {
-                                Layout.fillWidth: true
-                                height: 35
-                                color: "transparent"
+                        // Domain header
+                        section.property: "domain"
+                        section.delegate: Rectangle {
+                            width: ListView.view ? ListView.view.width : 0
+                            height: 35
+                            color: "transparent"
 
-                                Text {
-                                    anchors.left: parent.left
-                                    anchors.leftMargin: 5
-                                    anchors.verticalCenter: parent.verticalCenter
-                                    text: (domainName || "").toUpperCase()
-                                    font.pixelSize: 14
-                                    font.bold: true
-                                    color: ThemeManager.accentColor
-                                }
+                            Text {
+                                anchors.left: parent.left
+                                anchors.leftMargin: 5
+                                anchors.verticalCenter: parent.verticalCenter
+                                text: (section || "").toUpperCase()
+                                font.pixelSize: 14
+                                font.bold: true
+                                color: ThemeManager.accentColor
                             }
+                        }
 
-                            // Extension list for this domain
-                            Repeater {
-                                model: (modelData && modelData.pages) ? modelData.pages : []
-
-                                Rectangle {
-                                    Layout.fillWidth: true
-                                    height: 40
-                                    color: (modelData && modelData.extension && currentExtension === modelData.extension &&
-                                           currentDomain === domainName) ? ThemeManager.accentColor : "transparent"
-                                    radius: 3
-
-                                    MouseArea {
-                                        anchors.fill: parent
-                                        onClicked: {
-                                            currentDomain = domainName
-                                            if (modelData && modelData.extension)
-                                                currentExtension = modelData.extension
-                                        }
-                                    }
+                        // Extension entry within its domain
+                        delegate: Rectangle {
+                            width: ListView.view ? ListView.view.width : 0
+                            height: 40
+                            color: (currentExtension === model.extension &&
+                                   currentDomain === model.domain) ? ThemeManager.accentColor : "transparent"
+                            radius: 3
 
-                                    Text {
-                                        anchors.left: parent.left
-                                        anchors.leftMargin: 15
-                                        anchors.verticalCenter: parent.verticalCenter
-                                        text: (modelData && modelData.title) ? modelData.title : ""
-                                        font.pixelSize: 13
-                                        color: (modelData && modelData.extension && currentExtension === modelData.extension &&
-                                               currentDomain === domainName) ? "white" : ThemeManager.textColor
-                                    }
+                            MouseArea {
+                                anchors.fill: parent
+                                onClicked: {
+                                    currentDomain = model.domain
+                                    currentExtension = model.extension
                                 }
                             }
+
+                            Text {
+                                anchors.left: parent.left
+                                anchors.leftMargin: 15
+                                anchors.verticalCenter: parent.verticalCenter
+                                text: model.title || ""
+                                font.pixelSize: 13
+                                color: (currentExtension === model.extension &&
+                                       currentDomain === model.domain) ? "white" : ThemeManager.textColor
+                            }
                         }
                     }
                 }
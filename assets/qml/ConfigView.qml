@@ -64,6 +64,10 @@ Item {
                     text: "Extensions"
                 }
                 
+                TabButton {
+                    text: "Diagnostics"
+                }
+                
                 TabButton {
                     text: "System"
                 }
@@ -88,6 +92,10 @@ Item {
                     id: extensionList
                 }
                 
+                // Diagnostics Tab
+                ExtensionDiagnosticsView {
+                }
+                
                 // System Tab
                 Item {
                     Text {
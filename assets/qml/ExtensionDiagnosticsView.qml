@@ -0,0 +1,232 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+import CrankshaftReborn.UI 1.0
+
+Item {
+    id: extensionDiagnosticsView
+
+    function formatBytes(bytes) {
+        if (bytes < 1024)
+            return Math.round(bytes) + " B";
+        if (bytes < 1024 * 1024)
+            return (bytes / 1024).toFixed(1) + " KiB";
+        return (bytes / (1024 * 1024)).toFixed(1) + " MiB";
+    }
+
+    function formatRate(bytesPerSecond) {
+        return formatBytes(bytesPerSecond) + "/s";
+    }
+
+    // Rows update with each resource snapshot; sample immediately when shown
+    onVisibleChanged: {
+        if (visible)
+            ExtensionDiagnosticsBridge.refresh();
+    }
+
+    ColumnLayout {
+        anchors.fill: parent
+        spacing: 10
+
+        // Column headings
+        RowLayout {
+            Layout.fillWidth: true
+            Layout.leftMargin: 25
+            Layout.rightMargin: 25
+            spacing: 15
+
+            Text {
+                text: "Extension"
+                Layout.fillWidth: true
+                font.pixelSize: 12
+                font.bold: true
+                color: ThemeManager.textColor
+            }
+
+            Repeater {
+                model: ["CPU", "Network", "Storage", "Events"]
+
+                Text {
+                    text: modelData
+                    Layout.preferredWidth: 140
+                    font.pixelSize: 12
+                    font.bold: true
+                    color: ThemeManager.textColor
+                }
+            }
+        }
+
+        Rectangle {
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            color: ThemeManager.cardColor
+            radius: 8
+            border.color: ThemeManager.borderColor
+            border.width: 1
+
+            ListView {
+                id: diagnosticsListView
+                anchors.fill: parent
+                anchors.margins: 10
+                spacing: 8
+                clip: true
+                model: ExtensionDiagnosticsBridge.extensions
+
+                delegate: Rectangle {
+                    width: diagnosticsListView.width - 20
+                    height: 64
+                    color: ThemeManager.backgroundColor
+                    radius: 6
+                    border.color: modelData.cpu_percent >= 25 ? "#F44336" : ThemeManager.borderColor
+                    border.width: 1
+
+                    RowLayout {
+                        anchors.fill: parent
+                        anchors.margins: 15
+                        spacing: 15
+
+                        ColumnLayout {
+                            Layout.fillWidth: true
+                            spacing: 2
+
+                            Text {
+                                text: modelData.id
+                                font.pixelSize: 16
+                                font.bold: true
+                                color: ThemeManager.textColor
+                                elide: Text.ElideRight
+                                Layout.fillWidth: true
+                            }
+
+                            Text {
+                                text: modelData.calls + " calls, " + modelData.cpu_ms.toFixed(0)
+                                      + " ms CPU, " + modelData.wall_ms.toFixed(0) + " ms wall"
+                                font.pixelSize: 11
+                                color: ThemeManager.textColor
+                                opacity: 0.7
+                            }
+                        }
+
+                        Text {
+                            text: modelData.cpu_percent.toFixed(1) + " %"
+                            Layout.preferredWidth: 140
+                            font.pixelSize: 14
+                            color: modelData.cpu_percent >= 25 ? "#F44336" : ThemeManager.textColor
+                        }
+
+                        Text {
+                            text: "↓ " + formatRate(modelData.net_in_rate) + "\n↑ "
+                                  + formatRate(modelData.net_out_rate)
+                            Layout.preferredWidth: 140
+                            font.pixelSize: 12
+                            color: ThemeManager.textColor
+                        }
+
+                        Text {
+                            text: "R " + formatRate(modelData.fs_read_rate) + "\nW "
+                                  + formatRate(modelData.fs_write_rate)
+                            Layout.preferredWidth: 140
+                            font.pixelSize: 12
+                            color: ThemeManager.textColor
+                        }
+
+                        Text {
+                            text: "out " + modelData.events_out_rate.toFixed(1) + "/s\nin "
+                                  + modelData.events_in_rate.toFixed(1) + "/s"
+                            Layout.preferredWidth: 140
+                            font.pixelSize: 12
+                            color: ThemeManager.textColor
+                        }
+                    }
+                }
+
+                Text {
+                    anchors.centerIn: parent
+                    visible: diagnosticsListView.count === 0
+                    text: "No extension activity recorded yet"
+                    font.pixelSize: 14
+                    color: ThemeManager.textColor
+                    opacity: 0.6
+                }
+            }
+        }
+
+        // GUI stalls reported by the stall watchdog, newest first
+        Text {
+            text: "Recent UI stalls"
+            visible: stallListView.count > 0
+            Layout.leftMargin: 25
+            font.pixelSize: 12
+            font.bold: true
+            color: ThemeManager.textColor
+        }
+
+        Rectangle {
+            Layout.fillWidth: true
+            Layout.preferredHeight: 180
+            visible: stallListView.count > 0
+            color: ThemeManager.cardColor
+            radius: 8
+            border.color: ThemeManager.borderColor
+            border.width: 1
+
+            ListView {
+                id: stallListView
+                anchors.fill: parent
+                anchors.margins: 10
+                spacing: 6
+                clip: true
+                model: ExtensionDiagnosticsBridge.stalls
+
+                delegate: RowLayout {
+                    width: stallListView.width - 20
+                    spacing: 15
+
+                    Text {
+                        text: new Date(modelData.started_at).toLocaleTimeString()
+                        Layout.preferredWidth: 90
+                        font.pixelSize: 12
+                        color: ThemeManager.textColor
+                        opacity: 0.7
+                    }
+
+                    Text {
+                        text: modelData.duration_ms.toFixed(0) + " ms"
+                        Layout.preferredWidth: 70
+                        font.pixelSize: 12
+                        font.bold: true
+                        color: modelData.duration_ms >= 1000 ? "#F44336" : ThemeManager.textColor
+                    }
+
+                    Text {
+                        text: (modelData.blame !== "" ? modelData.blame : "Unknown")
+                              + (modelData.operation !== "" ? " · " + modelData.operation : "")
+                              + (modelData.detail !== "" ? " " + modelData.detail : "")
+                        Layout.fillWidth: true
+                        font.pixelSize: 12
+                        color: ThemeManager.textColor
+                        elide: Text.ElideRight
+                    }
+                }
+            }
+        }
+    }
+}
@@ -537,7 +537,25 @@ ApplicationWindow {
             // Each extension loads in isolated Loader
             Loader {
                 required property var modelData
-                
+                required property int index
+
+                // Placeholders of deferred extensions load on first open, after the
+                // extension has been activated
+                readonly property bool isCurrent: stackLayout.currentIndex === index + 1
+                property bool opened: false
+
+                function markOpened() {
+                    if (opened)
+                        return;
+                    if (modelData.lazy)
+                        ExtensionRegistry.notifyViewOpened(modelData.componentId);
+                    opened = true;
+                }
+
+                onIsCurrentChanged: if (isCurrent) markOpened()
+                Component.onCompleted: if (isCurrent) markOpened()
+
+                active: !modelData.lazy || opened
                 source: modelData.qmlPath || ""
                 asynchronous: true
                 
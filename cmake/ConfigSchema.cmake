@@ -0,0 +1,68 @@
+# Project: Crankshaft
+# This file is part of Crankshaft project.
+# Copyright (C) 2025 OpenCarDev Team
+#
+#  Crankshaft is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation; either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  Crankshaft is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+
+# Build-time config schema support
+#
+# crankshaft_add_config_schema(<target> <schema.json> <symbol>)
+#   Generates <schema-name>_schema.hpp in the target's binary dir containing a static
+#   ConfigPageDescriptor named <symbol> in opencardev::crankshaft::core::config::schema,
+#   and adds that dir to the target's include path. A trailing "_schema" in the file
+#   name is not repeated, so config_schema.json gives config_schema.hpp.
+#
+#   The header is also generated at configure time and listed in the global property
+#   CRANKSHAFT_CONFIG_SCHEMA_HEADERS, so lupdate (cmake/Translations.cmake) can extract
+#   its display text; its strings are marked with QT_TRANSLATE_NOOP("ConfigSchema", ...).
+
+set(CRANKSHAFT_CONFIG_SCHEMA_GENERATOR ${CMAKE_CURRENT_LIST_DIR}/GenerateConfigSchema.cmake)
+
+function(crankshaft_add_config_schema target schema symbol)
+    get_filename_component(schema_path "${schema}" ABSOLUTE)
+    get_filename_component(schema_name "${schema}" NAME_WE)
+    string(REGEX REPLACE "_schema$" "" schema_name "${schema_name}")
+    set(output_dir "${CMAKE_CURRENT_BINARY_DIR}/config_schemas")
+    set(output "${output_dir}/${schema_name}_schema.hpp")
+
+    file(MAKE_DIRECTORY "${output_dir}")
+    execute_process(
+        COMMAND ${CMAKE_COMMAND}
+            -DSCHEMA=${schema_path}
+            -DOUTPUT=${output}
+            -DSYMBOL=${symbol}
+            -P ${CRANKSHAFT_CONFIG_SCHEMA_GENERATOR}
+        RESULT_VARIABLE result
+    )
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Cannot generate config descriptors from ${schema}")
+    endif()
+    set_property(GLOBAL APPEND PROPERTY CRANKSHAFT_CONFIG_SCHEMA_HEADERS "${output}")
+
+    add_custom_command(
+        OUTPUT "${output}"
+        COMMAND ${CMAKE_COMMAND} -E make_directory "${output_dir}"
+        COMMAND ${CMAKE_COMMAND}
+            -DSCHEMA=${schema_path}
+            -DOUTPUT=${output}
+            -DSYMBOL=${symbol}
+            -P ${CRANKSHAFT_CONFIG_SCHEMA_GENERATOR}
+        DEPENDS "${schema_path}" ${CRANKSHAFT_CONFIG_SCHEMA_GENERATOR}
+        COMMENT "Generating config descriptors from ${schema_name}.json"
+        VERBATIM
+    )
+
+    target_sources(${target} PRIVATE "${output}")
+    target_include_directories(${target} PRIVATE "${output_dir}")
+endfunction()
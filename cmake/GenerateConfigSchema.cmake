@@ -0,0 +1,285 @@
+# Project: Crankshaft
+# This file is part of Crankshaft project.
+# Copyright (C) 2025 OpenCarDev Team
+#
+#  Crankshaft is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation; either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  Crankshaft is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+
+# Script mode generator: turns a config page JSON schema into a header of static
+# ConfigPageDescriptor tables (see src/core/config/ConfigDescriptor.hpp).
+#
+# Usage:
+#   cmake -DSCHEMA=<schema.json> -DOUTPUT=<header.hpp> -DSYMBOL=<kPageName> -P GenerateConfigSchema.cmake
+#
+# Schema layout (optional members in brackets):
+#   { "domain", "extension", "title", ["description"], ["icon"], ["complexity"],
+#     "sections": [ { "key", "title", ["description"], ["icon"], ["complexity"],
+#       "items": [ { "key", "label", "type", ["description"], ["complexity"], ["default"],
+#                    ["properties"], ["unit"], ["icon"], ["required"], ["readOnly"],
+#                    ["secret"] } ] } ] }
+
+cmake_minimum_required(VERSION 3.19)  # string(JSON)
+
+foreach(var SCHEMA OUTPUT SYMBOL)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "GenerateConfigSchema: ${var} is required")
+    endif()
+endforeach()
+
+file(READ "${SCHEMA}" schema_json)
+
+# Escape text for use inside a C++ string literal
+function(_cs_escape out text)
+    string(REPLACE "\\" "\\\\" text "${text}")
+    string(REPLACE "\"" "\\\"" text "${text}")
+    string(REPLACE "\n" "\\n" text "${text}")
+    string(REPLACE "\t" "\\t" text "${text}")
+    set(${out} "${text}" PARENT_SCOPE)
+endfunction()
+
+# Read an optional member; sets <out> to <default> when absent
+function(_cs_get out default)
+    string(JSON value ERROR_VARIABLE err GET "${schema_json}" ${ARGN})
+    if(err)
+        set(value "${default}")
+    endif()
+    set(${out} "${value}" PARENT_SCOPE)
+endfunction()
+
+function(_cs_require out)
+    string(JSON value ERROR_VARIABLE err GET "${schema_json}" ${ARGN})
+    if(err)
+        string(REPLACE ";" "." path "${ARGN}")
+        message(FATAL_ERROR "${SCHEMA}: missing required member '${path}'")
+    endif()
+    set(${out} "${value}" PARENT_SCOPE)
+endfunction()
+
+function(_cs_u16 out text)
+    _cs_escape(text "${text}")
+    set(${out} "u\"${text}\"" PARENT_SCOPE)
+endfunction()
+
+# Display text, marked for lupdate in the context ConfigDescriptor.cpp translates it in
+function(_cs_u8 out text)
+    if(text STREQUAL "")
+        set(${out} "nullptr" PARENT_SCOPE)
+    else()
+        _cs_escape(text "${text}")
+        set(${out} "QT_TRANSLATE_NOOP(\"ConfigSchema\", \"${text}\")" PARENT_SCOPE)
+    endif()
+endfunction()
+
+function(_cs_bool out value)
+    if(value)
+        set(${out} "true" PARENT_SCOPE)
+    else()
+        set(${out} "false" PARENT_SCOPE)
+    endif()
+endfunction()
+
+function(_cs_complexity out name)
+    string(TOLOWER "${name}" name)
+    if(name STREQUAL "" OR name STREQUAL "basic")
+        set(value "Basic")
+    elseif(name STREQUAL "advanced")
+        set(value "Advanced")
+    elseif(name STREQUAL "expert")
+        set(value "Expert")
+    elseif(name STREQUAL "developer")
+        set(value "Developer")
+    else()
+        message(FATAL_ERROR "${SCHEMA}: unknown complexity '${name}'")
+    endif()
+    set(${out} "ConfigComplexity::${value}" PARENT_SCOPE)
+endfunction()
+
+function(_cs_item_type out name)
+    set(types boolean integer double string selection multiselection color file directory custom)
+    set(enums Boolean Integer Double String Selection MultiSelection Color File Directory Custom)
+    string(TOLOWER "${name}" name)
+    list(FIND types "${name}" idx)
+    if(idx EQUAL -1)
+        message(FATAL_ERROR "${SCHEMA}: unknown item type '${name}'")
+    endif()
+    list(GET enums ${idx} value)
+    set(${out} "ConfigItemType::${value}" PARENT_SCOPE)
+endfunction()
+
+# Resolve the default value into a ConfigDefaultKind and literal
+function(_cs_default out_kind out_value)
+    string(JSON type ERROR_VARIABLE err TYPE "${schema_json}" ${ARGN})
+    if(err OR type STREQUAL "NULL")
+        set(kind "None")
+        set(value "")
+    elseif(type STREQUAL "BOOLEAN")
+        string(JSON raw GET "${schema_json}" ${ARGN})
+        set(kind "Boolean")
+        if(raw)
+            set(value "true")
+        else()
+            set(value "false")
+        endif()
+    elseif(type STREQUAL "NUMBER")
+        string(JSON value GET "${schema_json}" ${ARGN})
+        if(value MATCHES "[.eE]")
+            set(kind "Double")
+        else()
+            set(kind "Integer")
+        endif()
+    elseif(type STREQUAL "STRING")
+        string(JSON value GET "${schema_json}" ${ARGN})
+        set(kind "String")
+    else()
+        # Arrays/objects: GET returns the JSON text, parsed at registration
+        string(JSON value GET "${schema_json}" ${ARGN})
+        string(REGEX REPLACE "[\n\r]+ *" "" value "${value}")
+        set(kind "Json")
+    endif()
+    set(${out_kind} "ConfigDefaultKind::${kind}" PARENT_SCOPE)
+    _cs_u16(value "${value}")
+    set(${out_value} "${value}" PARENT_SCOPE)
+endfunction()
+
+_cs_require(page_domain domain)
+_cs_require(page_extension extension)
+_cs_require(page_title title)
+_cs_get(page_description "" description)
+_cs_get(page_icon "" icon)
+_cs_get(page_complexity "" complexity)
+
+string(MAKE_C_IDENTIFIER "${SYMBOL}_detail" detail_ns)
+set(tables "")
+set(section_rows "")
+
+string(JSON section_count LENGTH "${schema_json}" sections)
+if(section_count GREATER 0)
+    math(EXPR last_section "${section_count} - 1")
+    foreach(s RANGE ${last_section})
+        _cs_require(section_key sections ${s} key)
+        _cs_require(section_title sections ${s} title)
+        _cs_get(section_description "" sections ${s} description)
+        _cs_get(section_icon "" sections ${s} icon)
+        _cs_get(section_complexity "" sections ${s} complexity)
+
+        string(MAKE_C_IDENTIFIER "${section_key}" section_id)
+        set(items_symbol "k_${section_id}_items")
+        set(item_rows "")
+
+        string(JSON item_count ERROR_VARIABLE err LENGTH "${schema_json}" sections ${s} items)
+        if(err)
+            set(item_count 0)
+        endif()
+        if(item_count GREATER 0)
+            math(EXPR last_item "${item_count} - 1")
+            foreach(i RANGE ${last_item})
+                set(path sections ${s} items ${i})
+                _cs_require(key ${path} key)
+                _cs_require(label ${path} label)
+                _cs_require(type ${path} type)
+                _cs_get(description "" ${path} description)
+                _cs_get(complexity "" ${path} complexity)
+                _cs_get(properties "" ${path} properties)
+                _cs_get(unit "" ${path} unit)
+                _cs_get(icon "" ${path} icon)
+                _cs_get(required OFF ${path} required)
+                _cs_get(read_only OFF ${path} readOnly)
+                _cs_get(secret OFF ${path} secret)
+                string(REGEX REPLACE "[\n\r]+ *" "" properties "${properties}")
+
+                _cs_u16(key "${key}")
+                _cs_u8(label "${label}")
+                _cs_u8(description "${description}")
+                _cs_item_type(type "${type}")
+                _cs_complexity(complexity "${complexity}")
+                _cs_default(default_kind default_value ${path} default)
+                _cs_u16(properties "${properties}")
+                _cs_u16(unit "${unit}")
+                _cs_u16(icon "${icon}")
+                _cs_bool(required "${required}")
+                _cs_bool(read_only "${read_only}")
+                _cs_bool(secret "${secret}")
+
+                string(APPEND item_rows
+                    "    {${key}, ${label},\n"
+                    "     ${description},\n"
+                    "     ${type}, ${complexity}, ${default_kind}, ${default_value},\n"
+                    "     ${properties}, ${unit}, ${icon}, ${required}, ${read_only}, ${secret}},\n")
+            endforeach()
+            string(APPEND tables
+                "inline constexpr ConfigItemDescriptor ${items_symbol}[] = {\n"
+                "${item_rows}"
+                "};\n\n")
+            set(items_ref "${items_symbol}")
+        else()
+            set(items_ref "nullptr")
+        endif()
+
+        _cs_u16(section_key "${section_key}")
+        _cs_u8(section_title "${section_title}")
+        _cs_u8(section_description "${section_description}")
+        _cs_u16(section_icon "${section_icon}")
+        _cs_complexity(section_complexity "${section_complexity}")
+        string(APPEND section_rows
+            "    {${section_key}, ${section_title},\n"
+            "     ${section_description},\n"
+            "     ${section_icon}, ${section_complexity}, ${items_ref}, ${item_count}},\n")
+    endforeach()
+    string(APPEND tables
+        "inline constexpr ConfigSectionDescriptor kSections[] = {\n"
+        "${section_rows}"
+        "};\n")
+    set(sections_ref "${detail_ns}::kSections")
+else()
+    set(sections_ref "nullptr")
+endif()
+
+_cs_u16(page_domain "${page_domain}")
+_cs_u16(page_extension "${page_extension}")
+_cs_u8(page_title "${page_title}")
+_cs_u8(page_description "${page_description}")
+_cs_u16(page_icon "${page_icon}")
+_cs_complexity(page_complexity "${page_complexity}")
+
+get_filename_component(schema_name "${SCHEMA}" NAME)
+set(content
+"// Generated from ${schema_name} by cmake/GenerateConfigSchema.cmake. Do not edit.
+
+#pragma once
+
+#include <QtGlobal>
+#include \"core/config/ConfigDescriptor.hpp\"
+
+namespace opencardev::crankshaft::core::config::schema {
+
+namespace ${detail_ns} {
+
+${tables}
+}  // namespace ${detail_ns}
+
+inline constexpr ConfigPageDescriptor ${SYMBOL} = {
+    ${page_domain}, ${page_extension}, ${page_title},
+    ${page_description},
+    ${page_icon}, ${page_complexity}, ${sections_ref}, ${section_count}};
+
+}  // namespace opencardev::crankshaft::core::config::schema
+")
+
+# Only touch the header when it changes so dependants are not rebuilt needlessly
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" existing)
+    if(existing STREQUAL content)
+        return()
+    endif()
+endif()
+file(WRITE "${OUTPUT}" "${content}")
@@ -61,6 +61,15 @@ set(CORE_SOURCES
     ${CMAKE_SOURCE_DIR}/assets/qml/ConfigItemView.qml
 )
 
+# Display text of the config pages generated from JSON schemas (cmake/ConfigSchema.cmake)
+get_property(CONFIG_SCHEMA_HEADERS GLOBAL PROPERTY CRANKSHAFT_CONFIG_SCHEMA_HEADERS)
+foreach(_header IN LISTS CONFIG_SCHEMA_HEADERS)
+    string(FIND "${_header}" "${CMAKE_BINARY_DIR}/src/" _at)
+    if(_at EQUAL 0)
+        list(APPEND CORE_SOURCES ${_header})
+    endif()
+endforeach()
+
 # Create translation source files (.ts) from sources and compile to .qm via built-in Qt toolchain
 qt6_create_translation(CORE_QM_FILES ${CORE_SOURCES} ${CORE_TS_FILES}
     OPTIONS -no-obsolete
@@ -90,6 +99,13 @@ function(add_extension_translations EXTENSION_NAME EXTENSION_DIR)
         "${EXTENSION_DIR}/*.hpp"
         "${EXTENSION_DIR}/*.qml"
     )
+    file(RELATIVE_PATH EXT_RELATIVE_DIR "${CMAKE_SOURCE_DIR}" "${EXTENSION_DIR}")
+    foreach(_header IN LISTS CONFIG_SCHEMA_HEADERS)
+        string(FIND "${_header}" "${CMAKE_BINARY_DIR}/${EXT_RELATIVE_DIR}/" _at)
+        if(_at EQUAL 0)
+            list(APPEND EXT_SOURCES ${_header})
+        endif()
+    endforeach()
     
     if(EXT_SOURCES)
         set(EXT_QM_FILES)
@@ -118,7 +134,7 @@ add_extension_translations(wireless ${CMAKE_SOURCE_DIR}/extensions/wireless)
 
 if(LUPDATE)
     add_custom_target(update_translations
-        COMMAND ${LUPDATE} ${CMAKE_SOURCE_DIR} -recursive -locations relative -no-obsolete -ts ${ALL_TS_FILES}
+        COMMAND ${LUPDATE} ${CMAKE_SOURCE_DIR} ${CONFIG_SCHEMA_HEADERS} -recursive -locations relative -no-obsolete -ts ${ALL_TS_FILES}
         WORKING_DIRECTORY ${CMAKE_SOURCE_DIR}
         COMMENT "Running lupdate to refresh all .ts files"
     )
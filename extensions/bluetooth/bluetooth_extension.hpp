@@ -47,6 +47,8 @@ class BluetoothExtension : public Extension {
     void start() override;
     void stop() override;
     void cleanup() override;
+    // Device subscription is made on the main thread, which owns the adapter
+    bool supportsConcurrentInitialize() const override { return true; }
 
     // Metadata
     QString id() const override { return "bluetooth"; }
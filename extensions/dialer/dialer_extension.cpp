@@ -22,8 +22,10 @@
 #include <QDebug>
 #include <QDir>
 #include <QFile>
+#include "../../src/core/config/ConfigDescriptor.hpp"
 #include "../../src/core/config/ConfigManager.hpp"
 #include "../../src/core/config/ConfigTypes.hpp"
+#include "config_schema.hpp"  // Generated from config_schema.json
 
 namespace opencardev::crankshaft {
 namespace extensions {
@@ -80,32 +82,8 @@ void DialerExtension::cleanup() {
 void DialerExtension::registerConfigItems(core::config::ConfigManager* manager) {
     using namespace core::config;
 
-    ConfigPage page;
-    page.domain = "phone";
-    page.extension = "dialer";
-    page.title = "Dialler Settings";
-    page.description = "Configure dialler preferences";
-    page.icon = "qrc:/icons/phone.svg";
-
-    ConfigSection general;
-    general.key = "general";
-    general.title = "General";
-    general.description = "Dialler preferences";
-    general.complexity = ConfigComplexity::Basic;
-
-    ConfigItem lastNum;
-    lastNum.key = "last_number";
-    lastNum.label = "Last dialled number";
-    lastNum.description = "Stores last dialled number";
-    lastNum.type = ConfigItemType::String;
-    lastNum.defaultValue = QString("");
-    lastNum.complexity = ConfigComplexity::Basic;
-    lastNum.readOnly = false;
-    lastNum.required = false;
-    general.items.append(lastNum);
-
-    page.sections.append(general);
-    manager->registerConfigPage(page);
+    // Page layout lives in config_schema.json and is compiled into static descriptors
+    manager->registerConfigPage(configPageFromDescriptor(schema::kDialerPage));
 }
 
 void DialerExtension::setupEventHandlers() {
@@ -38,6 +38,8 @@ class DialerExtension : public Extension {
     void start() override;
     void stop() override;
     void cleanup() override;
+    // initialize() only looks up capabilities
+    bool supportsConcurrentInitialize() const override { return true; }
 
     // Metadata
     QString id() const override { return "dialer"; }
@@ -41,10 +41,7 @@ GStreamerEngine::~GStreamerEngine() {
     shutdown();
 }
 
-bool GStreamerEngine::initialize() {
-    qInfo() << "Initialising GStreamer media engine...";
-
-    // Initialise GStreamer
+bool GStreamerEngine::initialiseLibrary() {
     GError* error = nullptr;
     if (!gst_init_check(nullptr, nullptr, &error)) {
         qCritical() << "Failed to initialise GStreamer:" 
@@ -53,6 +50,17 @@ bool GStreamerEngine::initialize() {
             g_error_free(error);
         return false;
     }
+    return true;
+}
+
+bool GStreamerEngine::initialize() {
+    qInfo() << "Initialising GStreamer media engine...";
+
+    // Initialise GStreamer
+    if (!initialiseLibrary()) {
+        return false;
+    }
+    GError* error = nullptr;
 
     qInfo() << "GStreamer version:" 
             << GST_VERSION_MAJOR << "." 
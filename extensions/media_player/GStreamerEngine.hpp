@@ -51,6 +51,12 @@ class GStreamerEngine : public IMediaEngine {
     explicit GStreamerEngine(QObject* parent = nullptr);
     ~GStreamerEngine() override;
 
+    /**
+     * Initialise the GStreamer library (loads the plugin registry). Safe to call from any
+     * thread and more than once; initialize() calls it too.
+     */
+    static bool initialiseLibrary();
+
     // IMediaEngine implementation
     bool initialize() override;
     void shutdown() override;
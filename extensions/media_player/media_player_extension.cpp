@@ -21,7 +21,9 @@
 #include "GStreamerEngine.hpp"
 #include <QDebug>
 #include "../../src/core/config/ConfigManager.hpp"
+#include "../../src/core/config/ConfigDescriptor.hpp"
 #include "../../src/core/config/ConfigTypes.hpp"
+#include "config_schema.hpp"  // Generated from config_schema.json
 
 namespace opencardev::crankshaft {
 namespace extensions {
@@ -36,22 +38,37 @@ bool MediaPlayerExtension::initialize() {
         return false;
     }
 
-    // Create and initialise media engine (GStreamer by default)
-    mediaEngine_ = std::make_unique<GStreamerEngine>();
-    if (!mediaEngine_->initialize()) {
+    // Loading the GStreamer plugin registry is the slow part; it needs no main thread
+    if (!GStreamerEngine::initialiseLibrary()) {
         qCritical() << "Failed to initialise media engine";
         return false;
     }
 
-    qInfo() << "Media engine capabilities:";
-    auto caps = mediaEngine_->capabilities();
-    qInfo() << "  Video support:" << caps.supportsVideo;
-    qInfo() << "  Gapless playback:" << caps.supportsGapless;
-    qInfo() << "  Hardware decode:" << caps.supportsHardwareDecode;
-    qInfo() << "  Streaming:" << caps.supportsStreaming;
-    qInfo() << "  Seek:" << caps.supportsSeek;
+    // The engine's timers and signal connections belong to the main thread
+    bool engineReady = false;
+    runOnMainThread([this, &engineReady]() {
+        // Create and initialise media engine (GStreamer by default)
+        mediaEngine_ = std::make_unique<GStreamerEngine>();
+        if (!mediaEngine_->initialize()) {
+            qCritical() << "Failed to initialise media engine";
+            return;
+        }
+
+        qInfo() << "Media engine capabilities:";
+        auto caps = mediaEngine_->capabilities();
+        qInfo() << "  Video support:" << caps.supportsVideo;
+        qInfo() << "  Gapless playback:" << caps.supportsGapless;
+        qInfo() << "  Hardware decode:" << caps.supportsHardwareDecode;
+        qInfo() << "  Streaming:" << caps.supportsStreaming;
+        qInfo() << "  Seek:" << caps.supportsSeek;
+
+        setupEngineCallbacks();
+        engineReady = true;
+    });
+    if (!engineReady) {
+        return false;
+    }
 
-    setupEngineCallbacks();
     setupEventHandlers();
     
     return true;
@@ -86,149 +103,8 @@ void MediaPlayerExtension::cleanup() {
 void MediaPlayerExtension::registerConfigItems(core::config::ConfigManager* manager) {
     using namespace core::config;
 
-    ConfigPage page;
-    page.domain = "media";
-    page.extension = "player";
-    page.title = "Media Player Settings";
-    page.description = "Configure media playback and library options";
-    page.icon = "qrc:/icons/media.svg";
-
-    // Playback Settings Section
-    ConfigSection playbackSection;
-    playbackSection.key = "playback";
-    playbackSection.title = "Playback Settings";
-    playbackSection.description = "Control media playback behavior";
-    playbackSection.complexity = ConfigComplexity::Basic;
-
-    ConfigItem volumeItem;
-    volumeItem.key = "default_volume";
-    volumeItem.label = "Default volume";
-    volumeItem.description = "Default volume level when starting playback";
-    volumeItem.type = ConfigItemType::Integer;
-    volumeItem.defaultValue = 75;
-    volumeItem.properties["minValue"] = 0;
-    volumeItem.properties["maxValue"] = 100;
-    volumeItem.unit = "%";
-    volumeItem.complexity = ConfigComplexity::Basic;
-    volumeItem.required = false;
-    volumeItem.readOnly = false;
-    playbackSection.items.append(volumeItem);
-
-    ConfigItem autoPlayItem;
-    autoPlayItem.key = "auto_play";
-    autoPlayItem.label = "Auto-play on connect";
-    autoPlayItem.description = "Automatically start playback when audio source connects";
-    autoPlayItem.type = ConfigItemType::Boolean;
-    autoPlayItem.defaultValue = true;
-    autoPlayItem.complexity = ConfigComplexity::Basic;
-    autoPlayItem.required = false;
-    autoPlayItem.readOnly = false;
-    playbackSection.items.append(autoPlayItem);
-
-    ConfigItem repeatModeItem;
-    repeatModeItem.key = "repeat_mode";
-    repeatModeItem.label = "Repeat mode";
-    repeatModeItem.description = "Default repeat mode for playlists";
-    repeatModeItem.type = ConfigItemType::Selection;
-    repeatModeItem.properties["options"] = QStringList{"Off", "One", "All"};
-    repeatModeItem.defaultValue = "All";
-    repeatModeItem.complexity = ConfigComplexity::Basic;
-    repeatModeItem.required = false;
-    repeatModeItem.readOnly = false;
-    playbackSection.items.append(repeatModeItem);
-
-    ConfigItem shuffleItem;
-    shuffleItem.key = "shuffle";
-    shuffleItem.label = "Enable shuffle";
-    shuffleItem.description = "Shuffle playback order by default";
-    shuffleItem.type = ConfigItemType::Boolean;
-    shuffleItem.defaultValue = false;
-    shuffleItem.complexity = ConfigComplexity::Basic;
-    shuffleItem.required = false;
-    shuffleItem.readOnly = false;
-    playbackSection.items.append(shuffleItem);
-
-    page.sections.append(playbackSection);
-
-    // Audio Quality Section
-    ConfigSection qualitySection;
-    qualitySection.key = "quality";
-    qualitySection.title = "Audio Quality";
-    qualitySection.description = "Configure audio quality and processing";
-    qualitySection.complexity = ConfigComplexity::Advanced;
-
-    ConfigItem equalizerItem;
-    equalizerItem.key = "equalizer";
-    equalizerItem.label = "Enable equalizer";
-    equalizerItem.description = "Enable audio equalizer for sound customization";
-    equalizerItem.type = ConfigItemType::Boolean;
-    equalizerItem.defaultValue = false;
-    equalizerItem.complexity = ConfigComplexity::Advanced;
-    equalizerItem.required = false;
-    equalizerItem.readOnly = false;
-    qualitySection.items.append(equalizerItem);
-
-    ConfigItem equalizerPresetItem;
-    equalizerPresetItem.key = "equalizer_preset";
-    equalizerPresetItem.label = "Equalizer preset";
-    equalizerPresetItem.description = "Audio equalizer preset";
-    equalizerPresetItem.type = ConfigItemType::Selection;
-    equalizerPresetItem.properties["options"] = QStringList{
-        "Flat", "Pop", "Rock", "Jazz", "Classical", "Bass Boost", "Treble Boost", "Custom"};
-    equalizerPresetItem.defaultValue = "Flat";
-    equalizerPresetItem.complexity = ConfigComplexity::Advanced;
-    equalizerPresetItem.required = false;
-    equalizerPresetItem.readOnly = false;
-    qualitySection.items.append(equalizerPresetItem);
-
-    ConfigItem normalizationItem;
-    normalizationItem.key = "volume_normalization";
-    normalizationItem.label = "Volume normalization";
-    normalizationItem.description = "Normalize volume levels across different tracks";
-    normalizationItem.type = ConfigItemType::Boolean;
-    normalizationItem.defaultValue = true;
-    normalizationItem.complexity = ConfigComplexity::Advanced;
-    normalizationItem.required = false;
-    normalizationItem.readOnly = false;
-    qualitySection.items.append(normalizationItem);
-
-    page.sections.append(qualitySection);
-
-    // Library Settings Section
-    ConfigSection librarySection;
-    librarySection.key = "library";
-    librarySection.title = "Library Settings";
-    librarySection.description = "Configure media library and scanning";
-    librarySection.complexity = ConfigComplexity::Basic;
-
-    ConfigItem libraryPathsItem;
-    libraryPathsItem.key = "library_paths";
-    libraryPathsItem.label = "Library directories";
-    libraryPathsItem.description = "Directories to scan for media files";
-    libraryPathsItem.type = ConfigItemType::MultiSelection;
-    libraryPathsItem.properties["options"] =
-        QStringList{"/media/music", "/media/usb", "/media/sdcard"};
-    libraryPathsItem.defaultValue = QStringList{"/media/music"};
-    libraryPathsItem.complexity = ConfigComplexity::Basic;
-    libraryPathsItem.required = false;
-    libraryPathsItem.readOnly = false;
-    librarySection.items.append(libraryPathsItem);
-
-    ConfigItem autoScanItem;
-    autoScanItem.key = "auto_scan";
-    autoScanItem.label = "Auto-scan library";
-    autoScanItem.description = "Automatically scan for new media files on startup";
-    autoScanItem.type = ConfigItemType::Boolean;
-    autoScanItem.defaultValue = true;
-    autoScanItem.complexity = ConfigComplexity::Basic;
-    autoScanItem.required = false;
-    autoScanItem.readOnly = false;
-    librarySection.items.append(autoScanItem);
-
-    page.sections.append(librarySection);
-
-    // Register the page
-    manager->registerConfigPage(page);
+    // Page layout lives in config_schema.json and is compiled into static descriptors
+    manager->registerConfigPage(configPageFromDescriptor(schema::kMediaPlayerPage));
     qInfo() << "Media Player extension registered config items";
 }
 
@@ -39,6 +39,8 @@ class MediaPlayerExtension : public Extension {
     void start() override;
     void stop() override;
     void cleanup() override;
+    // GStreamer registry loading runs off-thread; the engine lives on the main thread
+    bool supportsConcurrentInitialize() const override { return true; }
 
     // Metadata
     QString id() const override { return "media_player"; }
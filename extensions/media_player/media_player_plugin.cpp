@@ -0,0 +1,44 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QObject>
+#include "../../src/extensions/extension_plugin.hpp"
+#include "media_player_extension.hpp"
+
+namespace opencardev::crankshaft {
+namespace extensions {
+namespace media {
+
+// Entry point of media_player.so, loaded by ExtensionManager from the manifest's entry_point
+class MediaPlayerPlugin : public QObject, public ExtensionPlugin {
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID CRANKSHAFT_EXTENSION_PLUGIN_IID FILE "manifest.json")
+    Q_INTERFACES(opencardev::crankshaft::extensions::ExtensionPlugin)
+
+  public:
+    std::shared_ptr<Extension> createExtension() override {
+        return std::make_shared<MediaPlayerExtension>();
+    }
+};
+
+}  // namespace media
+}  // namespace extensions
+}  // namespace opencardev::crankshaft
+
+#include "media_player_plugin.moc"
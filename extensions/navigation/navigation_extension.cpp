@@ -24,24 +24,36 @@
 #include "../../src/core/capabilities/LocationCapability.hpp"
 #include "../../src/core/capabilities/NetworkCapability.hpp"
 #include "../../src/core/capabilities/UICapability.hpp"
+#include "../../src/core/config/ConfigDescriptor.hpp"
 #include "../../src/core/config/ConfigManager.hpp"
 #include "../../src/core/config/ConfigTypes.hpp"
 #include "OSRMProvider.hpp"
+#include "config_schema.hpp"  // Generated from config_schema.json
 
 namespace opencardev::crankshaft {
 namespace extensions {
 namespace navigation {
 
+namespace {
+
+constexpr int kDefaultMapCacheMb = 500;
+// Evict map tiles early rather than let the cache fill the volume
+constexpr qint64 kMinFreeSpaceBytes = 256LL * 1024 * 1024;
+
+}  // namespace
+
 bool NavigationExtension::initialize() {
     qInfo() << "Initializing Navigation extension (capability-based)...";
     isNavigating_ = false;
 
-    // Initialize routing provider
-    routingProvider_ = new OSRMProvider(nullptr);
-    QObject::connect(routingProvider_, &RoutingProvider::routeCalculated,
-                     [this](const Route& route) { handleRouteCalculated(route); });
-    QObject::connect(routingProvider_, &RoutingProvider::routeError,
-                     [this](const QString& error) { handleRouteError(error); });
+    // Initialize routing provider; its network manager must live on the main thread
+    runOnMainThread([this]() {
+        routingProvider_ = new OSRMProvider(nullptr);
+        QObject::connect(routingProvider_, &RoutingProvider::routeCalculated,
+                         [this](const Route& route) { handleRouteCalculated(route); });
+        QObject::connect(routingProvider_, &RoutingProvider::routeError,
+                         [this](const QString& error) { handleRouteError(error); });
+    });
 
     // Check required capabilities
     if (!hasCapability("location")) {
@@ -75,11 +87,14 @@ void NavigationExtension::start() {
     // Subscribe to events using Event capability
     setupEventHandlers();
 
-    // Subscribe to location updates using Location capability
+    // Subscribe to smoothed location updates, so a multipath jump does not move the route
     auto locationCap = getCapability<core::capabilities::LocationCapability>();
     if (locationCap) {
+        core::capabilities::LocationCapability::UpdatePolicy policy;
+        policy.smoothed = true;
         location_subscription_id_ = locationCap->subscribeToUpdates(
-            [this](const QGeoCoordinate& coord) { updateCurrentLocation(coord); });
+            policy,
+            [this](const QGeoPositionInfo& fix) { updateCurrentLocation(fix.coordinate()); });
         qInfo() << "Navigation: Subscribed to location updates";
     }
 }
@@ -99,205 +114,42 @@ void NavigationExtension::stop() {
 void NavigationExtension::cleanup() {
     qInfo() << "Cleaning up Navigation extension...";
     currentRoute_.clear();
+    QObject::disconnect(cache_size_connection_);
 }
 
 void NavigationExtension::registerConfigItems(core::config::ConfigManager* manager) {
     using namespace core::config;
 
-    ConfigPage page;
-    page.domain = "navigation";
-    page.extension = "core";
-    page.title = "Navigation Settings";
-    page.description = "Configure GPS navigation and routing preferences";
-    page.icon = "qrc:/icons/navigation.svg";
-
-    // Route Settings Section
-    ConfigSection routeSection;
-    routeSection.key = "routing";
-    routeSection.title = "Route Settings";
-    routeSection.description = "Configure route calculation preferences";
-    routeSection.complexity = ConfigComplexity::Basic;
-
-    ConfigItem routingModeItem;
-    routingModeItem.key = "routing_mode";
-    routingModeItem.label = "Routing mode";
-    routingModeItem.description = "Preferred routing mode for navigation";
-    routingModeItem.type = ConfigItemType::Selection;
-    routingModeItem.properties["options"] =
-        QStringList{"Fastest", "Shortest", "Eco", "Avoid Highways", "Avoid Tolls"};
-    routingModeItem.defaultValue = "Fastest";
-    routingModeItem.complexity = ConfigComplexity::Basic;
-    routingModeItem.required = false;
-    routingModeItem.readOnly = false;
-    routeSection.items.append(routingModeItem);
-
-    ConfigItem avoidItem;
-    avoidItem.key = "avoid_features";
-    avoidItem.label = "Avoid features";
-    avoidItem.description = "Route features to avoid";
-    avoidItem.type = ConfigItemType::MultiSelection;
-    avoidItem.properties["options"] = QStringList{"Highways", "Tolls", "Ferries", "Unpaved Roads"};
-    avoidItem.defaultValue = QStringList{};
-    avoidItem.complexity = ConfigComplexity::Basic;
-    avoidItem.required = false;
-    avoidItem.readOnly = false;
-    routeSection.items.append(avoidItem);
-
-    ConfigItem autoRecalculateItem;
-    autoRecalculateItem.key = "auto_recalculate";
-    autoRecalculateItem.label = "Auto-recalculate route";
-    autoRecalculateItem.description = "Automatically recalculate route when deviating";
-    autoRecalculateItem.type = ConfigItemType::Boolean;
-    autoRecalculateItem.defaultValue = true;
-    autoRecalculateItem.complexity = ConfigComplexity::Basic;
-    autoRecalculateItem.required = false;
-    autoRecalculateItem.readOnly = false;
-    routeSection.items.append(autoRecalculateItem);
-
-    ConfigItem recalculateThresholdItem;
-    recalculateThresholdItem.key = "recalculate_threshold";
-    recalculateThresholdItem.label = "Recalculation threshold";
-    recalculateThresholdItem.description = "Distance threshold before triggering recalculation";
-    recalculateThresholdItem.type = ConfigItemType::Integer;
-    recalculateThresholdItem.defaultValue = 100;
-    recalculateThresholdItem.properties["minValue"] = 50;
-    recalculateThresholdItem.properties["maxValue"] = 500;
-    recalculateThresholdItem.unit = "meters";
-    recalculateThresholdItem.complexity = ConfigComplexity::Advanced;
-    recalculateThresholdItem.required = false;
-    recalculateThresholdItem.readOnly = false;
-    routeSection.items.append(recalculateThresholdItem);
-
-    page.sections.append(routeSection);
-
-    // Display Settings Section
-    ConfigSection displaySection;
-    displaySection.key = "display";
-    displaySection.title = "Display Settings";
-    displaySection.description = "Configure map display and orientation";
-    displaySection.complexity = ConfigComplexity::Basic;
-
-    ConfigItem mapOrientationItem;
-    mapOrientationItem.key = "map_orientation";
-    mapOrientationItem.label = "Map orientation";
-    mapOrientationItem.description = "How to orient the map display";
-    mapOrientationItem.type = ConfigItemType::Selection;
-    mapOrientationItem.properties["options"] = QStringList{"North Up", "Heading Up", "3D"};
-    mapOrientationItem.defaultValue = "Heading Up";
-    mapOrientationItem.complexity = ConfigComplexity::Basic;
-    mapOrientationItem.required = false;
-    mapOrientationItem.readOnly = false;
-    displaySection.items.append(mapOrientationItem);
-
-    ConfigItem showTrafficItem;
-    showTrafficItem.key = "show_traffic";
-    showTrafficItem.label = "Show traffic";
-    showTrafficItem.description = "Display real-time traffic information";
-    showTrafficItem.type = ConfigItemType::Boolean;
-    showTrafficItem.defaultValue = true;
-    showTrafficItem.complexity = ConfigComplexity::Basic;
-    showTrafficItem.required = false;
-    showTrafficItem.readOnly = false;
-    displaySection.items.append(showTrafficItem);
-
-    ConfigItem speedLimitItem;
-    speedLimitItem.key = "show_speed_limit";
-    speedLimitItem.label = "Show speed limit";
-    speedLimitItem.description = "Display current speed limit on route";
-    speedLimitItem.type = ConfigItemType::Boolean;
-    speedLimitItem.defaultValue = true;
-    speedLimitItem.complexity = ConfigComplexity::Basic;
-    speedLimitItem.required = false;
-    speedLimitItem.readOnly = false;
-    displaySection.items.append(speedLimitItem);
-
-    page.sections.append(displaySection);
-
-    // Voice Guidance Section
-    ConfigSection voiceSection;
-    voiceSection.key = "voice";
-    voiceSection.title = "Voice Guidance";
-    voiceSection.description = "Configure voice navigation instructions";
-    voiceSection.complexity = ConfigComplexity::Basic;
-
-    ConfigItem voiceGuidanceItem;
-    voiceGuidanceItem.key = "enable_voice";
-    voiceGuidanceItem.label = "Enable voice guidance";
-    voiceGuidanceItem.description = "Provide turn-by-turn voice instructions";
-    voiceGuidanceItem.type = ConfigItemType::Boolean;
-    voiceGuidanceItem.defaultValue = true;
-    voiceGuidanceItem.complexity = ConfigComplexity::Basic;
-    voiceGuidanceItem.required = false;
-    voiceGuidanceItem.readOnly = false;
-    voiceSection.items.append(voiceGuidanceItem);
-
-    ConfigItem voiceVolumeItem;
-    voiceVolumeItem.key = "voice_volume";
-    voiceVolumeItem.label = "Voice volume";
-    voiceVolumeItem.description = "Volume level for voice guidance";
-    voiceVolumeItem.type = ConfigItemType::Integer;
-    voiceVolumeItem.defaultValue = 80;
-    voiceVolumeItem.properties["minValue"] = 0;
-    voiceVolumeItem.properties["maxValue"] = 100;
-    voiceVolumeItem.unit = "%";
-    voiceVolumeItem.complexity = ConfigComplexity::Basic;
-    voiceVolumeItem.required = false;
-    voiceVolumeItem.readOnly = false;
-    voiceSection.items.append(voiceVolumeItem);
-
-    ConfigItem voiceLanguageItem;
-    voiceLanguageItem.key = "voice_language";
-    voiceLanguageItem.label = "Voice language";
-    voiceLanguageItem.description = "Language for voice guidance";
-    voiceLanguageItem.type = ConfigItemType::Selection;
-    voiceLanguageItem.properties["options"] =
-        QStringList{"English (UK)", "English (US)", "French", "German", "Spanish", "Italian"};
-    voiceLanguageItem.defaultValue = "English (UK)";
-    voiceLanguageItem.complexity = ConfigComplexity::Basic;
-    voiceLanguageItem.required = false;
-    voiceLanguageItem.readOnly = false;
-    voiceSection.items.append(voiceLanguageItem);
-
-    page.sections.append(voiceSection);
-
-    // Advanced Settings Section
-    ConfigSection advancedSection;
-    advancedSection.key = "advanced";
-    advancedSection.title = "Advanced Settings";
-    advancedSection.description = "Configure advanced routing and map options";
-    advancedSection.complexity = ConfigComplexity::Advanced;
-
-    ConfigItem osrmServerItem;
-    osrmServerItem.key = "osrm_server";
-    osrmServerItem.label = "OSRM server URL";
-    osrmServerItem.description = "URL of the OSRM routing server";
-    osrmServerItem.type = ConfigItemType::String;
-    osrmServerItem.defaultValue = "http://router.project-osrm.org";
-    osrmServerItem.properties["placeholder"] = "http://server:port";
-    osrmServerItem.complexity = ConfigComplexity::Expert;
-    osrmServerItem.required = false;
-    osrmServerItem.readOnly = false;
-    advancedSection.items.append(osrmServerItem);
-
-    ConfigItem cacheSizeItem;
-    cacheSizeItem.key = "map_cache_size";
-    cacheSizeItem.label = "Map cache size";
-    cacheSizeItem.description = "Maximum size for offline map cache";
-    cacheSizeItem.type = ConfigItemType::Integer;
-    cacheSizeItem.defaultValue = 500;
-    cacheSizeItem.properties["minValue"] = 100;
-    cacheSizeItem.properties["maxValue"] = 2000;
-    cacheSizeItem.unit = "MB";
-    cacheSizeItem.complexity = ConfigComplexity::Advanced;
-    cacheSizeItem.required = false;
-    cacheSizeItem.readOnly = false;
-    advancedSection.items.append(cacheSizeItem);
-
-    page.sections.append(advancedSection);
-
-    // Register the page
-    manager->registerConfigPage(page);
+    // Page layout lives in config_schema.json and is compiled into static descriptors
+    manager->registerConfigPage(configPageFromDescriptor(schema::kNavigationPage));
     qInfo() << "Navigation extension registered config items";
+
+    // The map cache lives in the filesystem scope; keep it within the configured size
+    applyMapCacheSize(manager->getValue("navigation", "core", "advanced", "map_cache_size"));
+    QObject::disconnect(cache_size_connection_);
+    cache_size_connection_ = QObject::connect(
+        manager, &ConfigManager::configValueChanged, manager,
+        [this](const QString& domain, const QString& extension, const QString& section,
+               const QString& key, const QVariant& value) {
+            if (domain == "navigation" && extension == "core" && section == "advanced" &&
+                key == "map_cache_size") {
+                applyMapCacheSize(value);
+            }
+        });
+}
+
+void NavigationExtension::applyMapCacheSize(const QVariant& megabytes) {
+    auto fsCap = getCapability<core::capabilities::FileSystemCapability>();
+    if (!fsCap) {
+        qWarning() << "Navigation: FileSystem capability not granted; map cache is unbounded";
+        return;
+    }
+    const int size_mb = megabytes.toInt() > 0 ? megabytes.toInt() : kDefaultMapCacheMb;
+    core::capabilities::FileSystemCapability::CacheQuota quota;
+    quota.max_bytes = qint64(size_mb) * 1024 * 1024;
+    quota.min_free_bytes = kMinFreeSpaceBytes;
+    fsCap->setCacheQuota(quota);
+    qInfo() << "Navigation: Map cache limited to" << size_mb << "MB";
 }
 
 void NavigationExtension::setupEventHandlers() {
@@ -20,6 +20,7 @@
 #pragma once
 
 #include <QGeoCoordinate>
+#include <QMetaObject>
 #include <QString>
 #include <QVector>
 #include "../../src/extensions/extension.hpp"
@@ -46,6 +47,8 @@ class NavigationExtension : public Extension {
     void start() override;
     void stop() override;
     void cleanup() override;
+    // The routing provider is created on the main thread
+    bool supportsConcurrentInitialize() const override { return true; }
 
     // Metadata
     QString id() const override { return "navigation"; }
@@ -66,6 +69,8 @@ class NavigationExtension : public Extension {
     void publishNavigationUpdate();
     void handleRouteCalculated(const Route& route);
     void handleRouteError(const QString& error);
+    // Apply the map_cache_size setting as the filesystem scope's cache quota
+    void applyMapCacheSize(const QVariant& megabytes);
 
     QGeoCoordinate currentLocation_;
     QGeoCoordinate destination_;
@@ -73,6 +78,7 @@ class NavigationExtension : public Extension {
     bool isNavigating_;
     int location_subscription_id_ = -1;
     RoutingProvider* routingProvider_ = nullptr;
+    QMetaObject::Connection cache_size_connection_;
 };
 
 }  // namespace navigation
@@ -33,6 +33,7 @@ import QtQuick.Layouts 1.15
 import QtPositioning 5.15
 import QtLocation 5.15
 import CrankshaftReborn.UI 1.0
+import CrankshaftReborn.Navigation 1.0
 
 pragma ComponentBehavior: Bound
 
@@ -54,6 +55,7 @@ Item {
     // Current location (updated by extension via events)
     property real currentLat: 51.5074
     property real currentLng: -0.1278
+    property bool hasFix: false
     property real destLat: 51.5074
     property real destLng: -0.1278
     property real distanceRemaining: 0
@@ -73,10 +75,25 @@ Item {
     property bool avoidMotorways: false
     property string distanceUnit: "metric" // "metric" or "imperial"
     // GPS hardware settings
-    property var gpsDevices: ["Internal", "USB Receiver", "GNSS Hat", "Mock (Static)", "Mock (IP)"];
+    property var gpsDevices: ["Internal", "USB Receiver", "GNSS Hat", "Mock (Static)", "Mock (IP)", "Replay"];
     property string selectedGpsDevice: "Internal"
     signal gpsDeviceChanged(string device)
     
+    // Dead-reckoned position between GNSS fixes, refreshed at display rate
+    Timer {
+        interval: 16
+        repeat: true
+        running: root.visible
+        onTriggered: {
+            var fix = NavigationBridge.predictedPosition();
+            if (!fix.valid)
+                return;
+            root.hasFix = true;
+            root.currentLat = fix.latitude;
+            root.currentLng = fix.longitude;
+        }
+    }
+    
     // OSM Map Plugin
     Plugin {
         id: mapPlugin
@@ -104,8 +121,9 @@ Item {
         center: QtPositioning.coordinate(root.currentLat, root.currentLng)
         zoomLevel: root.isNavigating ? 16 : 14
         
-        // Smooth animations
+        // Smooth animations; a live position already moves every frame
         Behavior on center {
+            enabled: !root.hasFix
             CoordinateAnimation { duration: 500; easing.type: Easing.InOutQuad }
         }
         Behavior on zoomLevel {
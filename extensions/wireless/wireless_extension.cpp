@@ -24,6 +24,8 @@
 #include <QDebug>
 #include "../../src/core/capabilities/EventCapability.hpp"
 #include "../../src/core/capabilities/UICapability.hpp"
+#include "../../src/core/config/ConfigDescriptor.hpp"
+#include "config_schema.hpp"  // Generated from config_schema.json
 
 // Ensure QRC resources are initialised from global namespace to match rcc symbols
 static void init_wireless_resources() {
@@ -146,150 +148,8 @@ void WirelessExtension::cleanup() {
 void WirelessExtension::registerConfigItems(core::config::ConfigManager* manager) {
     using namespace core::config;
 
-    ConfigPage page;
-    page.domain = "connectivity";
-    page.extension = "wireless";
-    page.title = "WiFi Settings";
-    page.description = "Configure wireless network connections and access point mode";
-    page.icon = "qrc:/icons/wifi.svg";
-    page.complexity = ConfigComplexity::Basic;
-
-    // Network Settings Section
-    ConfigSection networkSection;
-    networkSection.key = "network";
-    networkSection.title = "Network Settings";
-    networkSection.description = "WiFi network connection settings";
-    networkSection.complexity = ConfigComplexity::Basic;
-
-    ConfigItem autoConnectItem;
-    autoConnectItem.key = "auto_connect";
-    autoConnectItem.label = "Auto-connect to known networks";
-    autoConnectItem.description = "Automatically connect to saved networks when in range";
-    autoConnectItem.type = ConfigItemType::Boolean;
-    autoConnectItem.defaultValue = true;
-    autoConnectItem.complexity = ConfigComplexity::Basic;
-    autoConnectItem.required = false;
-    autoConnectItem.readOnly = false;
-    networkSection.items.append(autoConnectItem);
-
-    ConfigItem scanIntervalItem;
-    scanIntervalItem.key = "scan_interval";
-    scanIntervalItem.label = "Network scan interval";
-    scanIntervalItem.description = "How often to scan for available networks";
-    scanIntervalItem.type = ConfigItemType::Integer;
-    scanIntervalItem.defaultValue = 15;
-    scanIntervalItem.properties["minValue"] = 5;
-    scanIntervalItem.properties["maxValue"] = 60;
-    scanIntervalItem.unit = "seconds";
-    scanIntervalItem.complexity = ConfigComplexity::Advanced;
-    scanIntervalItem.required = false;
-    scanIntervalItem.readOnly = false;
-    networkSection.items.append(scanIntervalItem);
-
-    ConfigItem powerSaveItem;
-    powerSaveItem.key = "power_save";
-    powerSaveItem.label = "WiFi power saving mode";
-    powerSaveItem.description = "Enable power saving to reduce battery consumption";
-    powerSaveItem.type = ConfigItemType::Boolean;
-    powerSaveItem.defaultValue = true;
-    powerSaveItem.complexity = ConfigComplexity::Advanced;
-    powerSaveItem.required = false;
-    powerSaveItem.readOnly = false;
-    networkSection.items.append(powerSaveItem);
-
-    page.sections.append(networkSection);
-
-    // Access Point Settings Section
-    ConfigSection apSection;
-    apSection.key = "access_point";
-    apSection.title = "Access Point Mode";
-    apSection.description = "Configure device as a WiFi access point";
-    apSection.complexity = ConfigComplexity::Advanced;
-
-    ConfigItem apEnabledItem;
-    apEnabledItem.key = "ap_enabled";
-    apEnabledItem.label = "Enable access point mode";
-    apEnabledItem.description = "Allow other devices to connect to this device";
-    apEnabledItem.type = ConfigItemType::Boolean;
-    apEnabledItem.defaultValue = false;
-    apEnabledItem.complexity = ConfigComplexity::Advanced;
-    apEnabledItem.required = false;
-    apEnabledItem.readOnly = false;
-    apSection.items.append(apEnabledItem);
-
-    ConfigItem apSsidItem;
-    apSsidItem.key = "ap_ssid";
-    apSsidItem.label = "Access point name (SSID)";
-    apSsidItem.description = "Network name visible to other devices";
-    apSsidItem.type = ConfigItemType::String;
-    apSsidItem.defaultValue = "Crankshaft-AP";
-    apSsidItem.complexity = ConfigComplexity::Advanced;
-    apSsidItem.required = false;
-    apSsidItem.readOnly = false;
-    apSection.items.append(apSsidItem);
-
-    ConfigItem apPasswordItem;
-    apPasswordItem.key = "ap_password";
-    apPasswordItem.label = "Access point password";
-    apPasswordItem.description = "Password for access point (minimum 8 characters)";
-    apPasswordItem.type = ConfigItemType::String;
-    apPasswordItem.defaultValue = "";
-    apPasswordItem.properties["minLength"] = 8;
-    apPasswordItem.properties["maxLength"] = 63;
-    apPasswordItem.properties["secret"] = true;
-    apPasswordItem.complexity = ConfigComplexity::Advanced;
-    apPasswordItem.required = false;
-    apPasswordItem.readOnly = false;
-    apSection.items.append(apPasswordItem);
-
-    ConfigItem apChannelItem;
-    apChannelItem.key = "ap_channel";
-    apChannelItem.label = "WiFi channel";
-    apChannelItem.description = "WiFi channel for access point (1-11)";
-    apChannelItem.type = ConfigItemType::Integer;
-    apChannelItem.defaultValue = 6;
-    apChannelItem.properties["minValue"] = 1;
-    apChannelItem.properties["maxValue"] = 11;
-    apChannelItem.complexity = ConfigComplexity::Expert;
-    apChannelItem.required = false;
-    apChannelItem.readOnly = false;
-    apSection.items.append(apChannelItem);
-
-    page.sections.append(apSection);
-
-    // Security Settings Section
-    ConfigSection securitySection;
-    securitySection.key = "security";
-    securitySection.title = "Security Settings";
-    securitySection.description = "Advanced security and encryption options";
-    securitySection.complexity = ConfigComplexity::Expert;
-
-    ConfigItem hiddenNetworksItem;
-    hiddenNetworksItem.key = "show_hidden";
-    hiddenNetworksItem.label = "Show hidden networks";
-    hiddenNetworksItem.description = "Display networks that don't broadcast SSID";
-    hiddenNetworksItem.type = ConfigItemType::Boolean;
-    hiddenNetworksItem.defaultValue = false;
-    hiddenNetworksItem.complexity = ConfigComplexity::Expert;
-    hiddenNetworksItem.required = false;
-    hiddenNetworksItem.readOnly = false;
-    securitySection.items.append(hiddenNetworksItem);
-
-    ConfigItem randomMacItem;
-    randomMacItem.key = "random_mac";
-    randomMacItem.label = "Randomize MAC address";
-    randomMacItem.description = "Use random MAC address for improved privacy";
-    randomMacItem.type = ConfigItemType::Boolean;
-    randomMacItem.defaultValue = false;
-    randomMacItem.complexity = ConfigComplexity::Expert;
-    randomMacItem.required = false;
-    randomMacItem.readOnly = false;
-    securitySection.items.append(randomMacItem);
-
-    page.sections.append(securitySection);
-
-    // Register the page
-    manager->registerConfigPage(page);
+    // Page layout lives in config_schema.json and is compiled into static descriptors
+    manager->registerConfigPage(configPageFromDescriptor(schema::kWirelessPage));
     qInfo() << "Wireless extension registered config items";
 }
 
@@ -299,6 +159,12 @@ void WirelessExtension::setupNetworkManager() {
         new QDBusInterface("org.freedesktop.NetworkManager", "/org/freedesktop/NetworkManager",
                            "org.freedesktop.NetworkManager", QDBusConnection::systemBus());
 
+    // Introspection above blocks on the bus, so this may run off the main thread during
+    // concurrent startup; the proxies themselves belong to the main thread
+    QThread* mainThread = QCoreApplication::instance() ? QCoreApplication::instance()->thread()
+                                                        : QThread::currentThread();
+    nmInterface_->moveToThread(mainThread);
+
     if (!nmInterface_->isValid()) {
         qWarning() << "Failed to connect to NetworkManager:" << nmInterface_->lastError().message();
         return;
@@ -307,6 +173,7 @@ void WirelessExtension::setupNetworkManager() {
     settingsInterface_ = new QDBusInterface(
         "org.freedesktop.NetworkManager", "/org/freedesktop/NetworkManager/Settings",
         "org.freedesktop.NetworkManager.Settings", QDBusConnection::systemBus());
+    settingsInterface_->moveToThread(mainThread);
 
     qInfo() << "Connected to NetworkManager D-Bus service";
 }
@@ -48,6 +48,8 @@ class WirelessExtension : public Extension {
     void start() override;
     void stop() override;
     void cleanup() override;
+    // D-Bus proxies are set up off-thread and handed to the main thread
+    bool supportsConcurrentInitialize() const override { return true; }
 
     // Metadata
     QString id() const override { return "wireless"; }
@@ -0,0 +1,44 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QObject>
+#include "../../src/extensions/extension_plugin.hpp"
+#include "wireless_extension.hpp"
+
+namespace opencardev::crankshaft {
+namespace extensions {
+namespace wireless {
+
+// Entry point of wireless.so, loaded by ExtensionManager from the manifest's entry_point
+class WirelessPlugin : public QObject, public ExtensionPlugin {
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID CRANKSHAFT_EXTENSION_PLUGIN_IID FILE "manifest.json")
+    Q_INTERFACES(opencardev::crankshaft::extensions::ExtensionPlugin)
+
+  public:
+    std::shared_ptr<Extension> createExtension() override {
+        return std::make_shared<WirelessExtension>();
+    }
+};
+
+}  // namespace wireless
+}  // namespace extensions
+}  // namespace opencardev::crankshaft
+
+#include "wireless_plugin.moc"
@@ -1,6 +1,329 @@
 <?xml version="1.0" encoding="utf-8"?>
 <!DOCTYPE TS>
 <TS version="2.1" language="en_GB">
+<context>
+    <name>ConfigSchema</name>
+    <message>
+        <source>User Interface</source>
+        <translation>User Interface</translation>
+    </message>
+    <message>
+        <source>Global UI preferences including keyboard shortcuts</source>
+        <translation>Global UI preferences including keyboard shortcuts</translation>
+    </message>
+    <message>
+        <source>General</source>
+        <translation>General</translation>
+    </message>
+    <message>
+        <source>General user interface preferences</source>
+        <translation>General user interface preferences</translation>
+    </message>
+    <message>
+        <source>Language</source>
+        <translation>Language</translation>
+    </message>
+    <message>
+        <source>Application language (requires translation files)</source>
+        <translation>Application language (requires translation files)</translation>
+    </message>
+    <message>
+        <source>Enable first run setup</source>
+        <translation>Enable first run setup</translation>
+    </message>
+    <message>
+        <source>Show General settings on first application launch</source>
+        <translation>Show General settings on first application launch</translation>
+    </message>
+    <message>
+        <source>Keyboard Shortcuts</source>
+        <translation>Keyboard Shortcuts</translation>
+    </message>
+    <message>
+        <source>Configure global shortcut keys</source>
+        <translation>Configure global shortcut keys</translation>
+    </message>
+    <message>
+        <source>Open settings</source>
+        <translation>Open settings</translation>
+    </message>
+    <message>
+        <source>Shortcut key to open the Settings page</source>
+        <translation>Shortcut key to open the Settings page</translation>
+    </message>
+    <message>
+        <source>Toggle theme</source>
+        <translation>Toggle theme</translation>
+    </message>
+    <message>
+        <source>Shortcut key to toggle light/dark theme</source>
+        <translation>Shortcut key to toggle light/dark theme</translation>
+    </message>
+    <message>
+        <source>Go to Home</source>
+        <translation>Go to Home</translation>
+    </message>
+    <message>
+        <source>Shortcut key to switch to the Home tab</source>
+        <translation>Shortcut key to switch to the Home tab</translation>
+    </message>
+    <message>
+        <source>Cycle tabs left</source>
+        <translation>Cycle tabs left</translation>
+    </message>
+    <message>
+        <source>Shortcut key to cycle to the previous tab</source>
+        <translation>Shortcut key to cycle to the previous tab</translation>
+    </message>
+    <message>
+        <source>Cycle tabs right</source>
+        <translation>Cycle tabs right</translation>
+    </message>
+    <message>
+        <source>Shortcut key to cycle to the next tab</source>
+        <translation>Shortcut key to cycle to the next tab</translation>
+    </message>
+    <message>
+        <source>Show shortcuts help</source>
+        <translation>Show shortcuts help</translation>
+    </message>
+    <message>
+        <source>Shortcut key to toggle the on-screen shortcuts help overlay</source>
+        <translation>Shortcut key to toggle the on-screen shortcuts help overlay</translation>
+    </message>
+    <message>
+        <source>Extensions</source>
+        <translation>Extensions</translation>
+    </message>
+    <message>
+        <source>Enable or disable built-in extensions</source>
+        <translation>Enable or disable built-in extensions</translation>
+    </message>
+    <message>
+        <source>Manage Extensions</source>
+        <translation>Manage Extensions</translation>
+    </message>
+    <message>
+        <source>Toggle extensions on or off</source>
+        <translation>Toggle extensions on or off</translation>
+    </message>
+    <message>
+        <source>Enable Navigation</source>
+        <translation>Enable Navigation</translation>
+    </message>
+    <message>
+        <source>Show the Navigation tab and services</source>
+        <translation>Show the Navigation tab and services</translation>
+    </message>
+    <message>
+        <source>Enable Bluetooth</source>
+        <translation>Enable Bluetooth</translation>
+    </message>
+    <message>
+        <source>Enable Bluetooth integration</source>
+        <translation>Enable Bluetooth integration</translation>
+    </message>
+    <message>
+        <source>Enable Media Player</source>
+        <translation>Enable Media Player</translation>
+    </message>
+    <message>
+        <source>Enable media playback controls</source>
+        <translation>Enable media playback controls</translation>
+    </message>
+    <message>
+        <source>Enable Dialler</source>
+        <translation>Enable Dialler</translation>
+    </message>
+    <message>
+        <source>Enable phone dialler integration</source>
+        <translation>Enable phone dialler integration</translation>
+    </message>
+    <message>
+        <source>Enable Wireless</source>
+        <translation>Enable Wireless</translation>
+    </message>
+    <message>
+        <source>Enable wireless settings integration</source>
+        <translation>Enable wireless settings integration</translation>
+    </message>
+    <message>
+        <source>Rate Limits</source>
+        <translation>Rate Limits</translation>
+    </message>
+    <message>
+        <source>Per-extension limits on capability usage</source>
+        <translation>Per-extension limits on capability usage</translation>
+    </message>
+    <message>
+        <source>Network requests</source>
+        <translation>Network requests</translation>
+    </message>
+    <message>
+        <source>Requests per second each extension may make; 0 removes the limit</source>
+        <translation>Requests per second each extension may make; 0 removes the limit</translation>
+    </message>
+    <message>
+        <source>Event emissions</source>
+        <translation>Event emissions</translation>
+    </message>
+    <message>
+        <source>Events per second each extension may emit; 0 removes the limit</source>
+        <translation>Events per second each extension may emit; 0 removes the limit</translation>
+    </message>
+    <message>
+        <source>File system writes</source>
+        <translation>File system writes</translation>
+    </message>
+    <message>
+        <source>Write operations per second each extension may perform; 0 removes the limit</source>
+        <translation>Write operations per second each extension may perform; 0 removes the limit</translation>
+    </message>
+    <message>
+        <source>Permissions</source>
+        <translation>Permissions</translation>
+    </message>
+    <message>
+        <source>System policy applied on top of each extension&apos;s declared permissions</source>
+        <translation>System policy applied on top of each extension&apos;s declared permissions</translation>
+    </message>
+    <message>
+        <source>Permission overrides</source>
+        <translation>Permission overrides</translation>
+    </message>
+    <message>
+        <source>Keyed by extension id, or * for every extension: allow and deny lists of permissions. Denials win</source>
+        <translation>Keyed by extension id, or * for every extension: allow and deny lists of permissions. Denials win</translation>
+    </message>
+    <message>
+        <source>Process Isolation</source>
+        <translation>Process Isolation</translation>
+    </message>
+    <message>
+        <source>Run extensions in their own host process; applies the next time an extension is loaded</source>
+        <translation>Run extensions in their own host process; applies the next time an extension is loaded</translation>
+    </message>
+    <message>
+        <source>Isolate Navigation</source>
+        <translation>Isolate Navigation</translation>
+    </message>
+    <message>
+        <source>Run in a separate process that is restarted if it crashes</source>
+        <translation>Run in a separate process that is restarted if it crashes</translation>
+    </message>
+    <message>
+        <source>Isolate Bluetooth</source>
+        <translation>Isolate Bluetooth</translation>
+    </message>
+    <message>
+        <source>Isolate Media Player</source>
+        <translation>Isolate Media Player</translation>
+    </message>
+    <message>
+        <source>Isolate Dialler</source>
+        <translation>Isolate Dialler</translation>
+    </message>
+    <message>
+        <source>Isolate Wireless</source>
+        <translation>Isolate Wireless</translation>
+    </message>
+    <message>
+        <source>Diagnostics</source>
+        <translation>Diagnostics</translation>
+    </message>
+    <message>
+        <source>Detection of extensions that block the user interface</source>
+        <translation>Detection of extensions that block the user interface</translation>
+    </message>
+    <message>
+        <source>UI stall threshold</source>
+        <translation>UI stall threshold</translation>
+    </message>
+    <message>
+        <source>Report the extension responsible when the UI thread is blocked for longer than this; 0 turns detection off</source>
+        <translation>Report the extension responsible when the UI thread is blocked for longer than this; 0 turns detection off</translation>
+    </message>
+    <message>
+        <source>Sample UI thread stacks</source>
+        <translation>Sample UI thread stacks</translation>
+    </message>
+    <message>
+        <source>Blame stalls in code the core did not dispatch by sampling the UI thread&apos;s stack; the sampling signal can interrupt blocking calls, so leave off outside development</source>
+        <translation>Blame stalls in code the core did not dispatch by sampling the UI thread&apos;s stack; the sampling signal can interrupt blocking calls, so leave off outside development</translation>
+    </message>
+    <message>
+        <source>Location</source>
+        <translation>Location</translation>
+    </message>
+    <message>
+        <source>GNSS receivers shared by navigation and other location users</source>
+        <translation>GNSS receivers shared by navigation and other location users</translation>
+    </message>
+    <message>
+        <source>Serial Receivers</source>
+        <translation>Serial Receivers</translation>
+    </message>
+    <message>
+        <source>NMEA receivers used by the USB Receiver and GNSS Hat GPS devices</source>
+        <translation>NMEA receivers used by the USB Receiver and GNSS Hat GPS devices</translation>
+    </message>
+    <message>
+        <source>USB receiver device</source>
+        <translation>USB receiver device</translation>
+    </message>
+    <message>
+        <source>Serial device of a USB GNSS receiver</source>
+        <translation>Serial device of a USB GNSS receiver</translation>
+    </message>
+    <message>
+        <source>GNSS Hat device</source>
+        <translation>GNSS Hat device</translation>
+    </message>
+    <message>
+        <source>Serial device of a GNSS Hat on the GPIO header UART</source>
+        <translation>Serial device of a GNSS Hat on the GPIO header UART</translation>
+    </message>
+    <message>
+        <source>Baud rate</source>
+        <translation>Baud rate</translation>
+    </message>
+    <message>
+        <source>Serial speed of both receivers; 9600 for most, 38400 or more for 10 Hz output</source>
+        <translation>Serial speed of both receivers; 9600 for most, 38400 or more for 10 Hz output</translation>
+    </message>
+    <message>
+        <source>Replay</source>
+        <translation>Replay</translation>
+    </message>
+    <message>
+        <source>Recorded drive played back by the Replay GPS device, for testing navigation</source>
+        <translation>Recorded drive played back by the Replay GPS device, for testing navigation</translation>
+    </message>
+    <message>
+        <source>Recording</source>
+        <translation>Recording</translation>
+    </message>
+    <message>
+        <source>GPX track or NMEA log to replay</source>
+        <translation>GPX track or NMEA log to replay</translation>
+    </message>
+    <message>
+        <source>Speed</source>
+        <translation>Speed</translation>
+    </message>
+    <message>
+        <source>Multiple of real time, or max to replay as fast as possible</source>
+        <translation>Multiple of real time, or max to replay as fast as possible</translation>
+    </message>
+    <message>
+        <source>Loop</source>
+        <translation>Loop</translation>
+    </message>
+    <message>
+        <source>Start again from the beginning at the end of the recording</source>
+        <translation>Start again from the beginning at the end of the recording</translation>
+    </message>
+</context>
 <context>
     <name>Main</name>
     <message>
@@ -129,37 +452,4 @@
         <translation>Extensions: </translation>
     </message>
 </context>
-<context>
-    <name>QObject</name>
-    <message>
-        <location filename="../src/main.cpp" line="163"/>
-        <source>User Interface</source>
-        <translation>User Interface</translation>
-    </message>
-    <message>
-        <location filename="../src/main.cpp" line="164"/>
-        <source>Global UI preferences including keyboard shortcuts</source>
-        <translation>Global UI preferences including keyboard shortcuts</translation>
-    </message>
-    <message>
-        <location filename="../src/main.cpp" line="171"/>
-        <source>General</source>
-        <translation>General</translation>
-    </message>
-    <message>
-        <location filename="../src/main.cpp" line="172"/>
-        <source>General user interface preferences</source>
-        <translation>General user interface preferences</translation>
-    </message>
-    <message>
-        <location filename="../src/main.cpp" line="177"/>
-        <source>Language</source>
-        <translation>Language</translation>
-    </message>
-    <message>
-        <location filename="../src/main.cpp" line="178"/>
-        <source>Application language (requires translation files)</source>
-        <translation>Application language (requires translation files)</translation>
-    </message>
-</context>
 </TS>
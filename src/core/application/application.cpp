@@ -19,8 +19,17 @@
 
 #include "application.hpp"
 #include <QDebug>
+#include <QStandardPaths>
 #include "../../extensions/extension_manager.hpp"
+#include "../config/ConfigDescriptor.hpp"
 #include "../config/ConfigManager.hpp"
+#include "../diagnostics/Trace.hpp"
+#include "../location/LocationHub.hpp"
+#include "../location/NmeaSerialSource.hpp"
+#include "../location/ReplaySource.hpp"
+#include "system_extensions_schema.hpp"  // Generated from src/core/config/schemas
+#include "system_location_schema.hpp"    // Generated from src/core/config/schemas
+#include "system_ui_schema.hpp"          // Generated from src/core/config/schemas
 
 namespace opencardev::crankshaft::core {
 
@@ -29,6 +38,7 @@ Application::Application(QObject* parent)
       event_bus_(std::make_unique<EventBus>()),
       websocket_server_(std::make_unique<WebSocketServer>()),
       capability_manager_(nullptr),
+      stall_watchdog_(nullptr),
       config_manager_(nullptr),
       extension_manager_(nullptr) {}
 
@@ -39,12 +49,15 @@ Application::~Application() {
 }
 
 auto Application::initialize() -> bool {
+    CRANKSHAFT_TRACE_SCOPE("startup", "Application::initialize");
     qInfo() << "Initializing Crankshaft Reborn Application (Capability-Based Architecture)...";
 
     setupEventBus();
     setupWebSocketServer();
     setupCapabilityManager();
     setupConfigManager();
+    setupStallWatchdog();
+    setupLocation();
     loadExtensions();
 
     qInfo() << "Application initialized successfully";
@@ -64,30 +77,148 @@ void Application::shutdown() {
 }
 
 void Application::setupEventBus() {
+    CRANKSHAFT_TRACE_SCOPE("startup", "Application::setupEventBus");
     qDebug() << "Setting up event bus...";
     // Event bus initialization
 }
 
 void Application::setupWebSocketServer() {
+    CRANKSHAFT_TRACE_SCOPE("startup", "Application::setupWebSocketServer");
     qDebug() << "Setting up WebSocket server...";
     constexpr int kDefaultWebsocketPort = 8080;
     websocket_server_->start(kDefaultWebsocketPort);
 }
 
 void Application::setupCapabilityManager() {
+    CRANKSHAFT_TRACE_SCOPE("startup", "Application::setupCapabilityManager");
     qDebug() << "Setting up capability manager...";
     capability_manager_ =
         std::make_unique<CapabilityManager>(event_bus_.get(), websocket_server_.get());
+    capability_manager_->enableAuditPersistence(
+        QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) +
+        QStringLiteral("/audit"));
+    // Per-extension CPU, I/O and event counters for diagnostics views and exporters
+    constexpr int kResourceSnapshotIntervalMs = 2000;
+    capability_manager_->enableResourceSnapshots(kResourceSnapshotIntervalMs);
     qInfo() << "Capability manager initialized - extensions will use capability-based security";
 }
 
 void Application::setupConfigManager() {
+    CRANKSHAFT_TRACE_SCOPE("startup", "Application::setupConfigManager");
     qDebug() << "Setting up config manager...";
     config_manager_ = new opencardev::crankshaft::core::config::ConfigManager();
+    // Core pages come from build-time descriptors (src/core/config/schemas/*.json). They are
+    // registered before anything reads them, so the stall watchdog, location receivers and
+    // extension manager start with the saved values rather than the defaults
+    config_manager_->registerConfigPage(
+        config::configPageFromDescriptor(config::schema::kSystemUiPage));
+    config_manager_->registerConfigPage(
+        config::configPageFromDescriptor(config::schema::kSystemExtensionsPage));
+    config_manager_->registerConfigPage(
+        config::configPageFromDescriptor(config::schema::kSystemLocationPage));
     config_manager_->load();
+    // Pick up files dropped into the config directory by provisioning scripts
+    config_manager_->setFileWatchingEnabled(true);
     qInfo() << "Config manager initialized";
 }
 
+void Application::setupStallWatchdog() {
+    CRANKSHAFT_TRACE_SCOPE("startup", "Application::setupStallWatchdog");
+    qDebug() << "Setting up GUI stall watchdog...";
+    constexpr int kDefaultStallThresholdMs = 250;
+    stall_watchdog_ = std::make_unique<diagnostics::StallWatchdog>(event_bus_.get());
+    // Opt-in: sampling interrupts the GUI thread with a signal (see setStackSampling)
+    stall_watchdog_->setStackSampling(
+        qEnvironmentVariableIntValue("CRANKSHAFT_STALL_STACKS") != 0 ||
+        config_manager_->getValue("system", "extensions", "diagnostics", "sample_stacks")
+            .toBool());
+    const QVariant threshold =
+        config_manager_->getValue("system", "extensions", "diagnostics", "stall_threshold_ms");
+    stall_watchdog_->start(threshold.isValid() ? threshold.toInt() : kDefaultStallThresholdMs);
+
+    connect(config_manager_, &config::ConfigManager::configValueChanged, this,
+            [this](const QString& domain, const QString& extension, const QString& section,
+                   const QString& key, const QVariant& value) {
+                if (domain != "system" || extension != "extensions" ||
+                    section != "diagnostics") {
+                    return;
+                }
+                if (key == "stall_threshold_ms") {
+                    stall_watchdog_->start(value.toInt());
+                } else if (key == "sample_stacks") {
+                    stall_watchdog_->setStackSampling(
+                        qEnvironmentVariableIntValue("CRANKSHAFT_STALL_STACKS") != 0 ||
+                        value.toBool());
+                }
+            });
+}
+
+void Application::setupLocation() {
+    CRANKSHAFT_TRACE_SCOPE("startup", "Application::setupLocation");
+    using DeviceMode = location::LocationHub::DeviceMode;
+    location::LocationHub* hub = capability_manager_->locationHub();
+    const auto value = [this](const char* section, const char* key, const QString& fallback) {
+        const QVariant v = config_manager_->getValue("system", "location", section, key);
+        return v.isValid() && !v.toString().isEmpty() ? v.toString() : fallback;
+    };
+    // "max" replays as fast as possible; anything unparsable at real time
+    const auto replaySpeed = [](const QString& speed) {
+        if (speed.compare("max", Qt::CaseInsensitive) == 0) {
+            return location::ReplaySource::kAsFastAsPossible;
+        }
+        bool ok = false;
+        const double multiple = speed.toDouble(&ok);
+        return ok && multiple > 0.0 ? multiple : 1.0;
+    };
+
+    // Serial ports of the USB and Hat receivers, opened only when selected as GPS device
+    const auto applyReceivers = [hub, value]() {
+        const int baud_rate =
+            value("receivers", "baud_rate",
+                  QString::number(location::NmeaSerialSource::kDefaultBaudRate))
+                .toInt();
+        hub->setSerialReceiver(
+            DeviceMode::USB,
+            value("receivers", "usb_device", location::LocationHub::kDefaultUsbDevice),
+            baud_rate);
+        hub->setSerialReceiver(
+            DeviceMode::Hat,
+            value("receivers", "hat_device", location::LocationHub::kDefaultHatDevice),
+            baud_rate);
+    };
+    const auto applyReplay = [this, hub, value, replaySpeed]() {
+        hub->setReplay(value("replay", "file", QString()),
+                       replaySpeed(value("replay", "speed", "1")),
+                       config_manager_->getValue("system", "location", "replay", "loop").toBool());
+    };
+    applyReceivers();
+
+    // CRANKSHAFT_LOCATION_REPLAY replays a recording whatever GPS device is selected
+    const QString replay_file = qEnvironmentVariable("CRANKSHAFT_LOCATION_REPLAY");
+    if (!replay_file.isEmpty()) {
+        const QString speed = qEnvironmentVariable("CRANKSHAFT_LOCATION_REPLAY_SPEED", "1");
+        qInfo() << "Replaying" << replay_file << "at speed" << speed << "for all location users";
+        hub->setReplay(replay_file, replaySpeed(speed), true);
+        hub->pinDevice(DeviceMode::Replay);
+    } else {
+        applyReplay();
+    }
+
+    connect(config_manager_, &config::ConfigManager::configValueChanged, this,
+            [applyReceivers, applyReplay, hub](const QString& domain, const QString& extension,
+                                               const QString& section, const QString&,
+                                               const QVariant&) {
+                if (domain != "system" || extension != "location") {
+                    return;
+                }
+                if (section == "receivers") {
+                    applyReceivers();
+                } else if (section == "replay" && !hub->isDevicePinned()) {
+                    applyReplay();
+                }
+            });
+}
+
 auto Application::configManager() const -> opencardev::crankshaft::core::config::ConfigManager* {
     return config_manager_;
 }
@@ -107,13 +238,15 @@ void Application::registerBuiltInExtensions() {
 }
 
 void Application::loadExtensions() {
+    CRANKSHAFT_TRACE_SCOPE("startup", "Application::loadExtensions");
     qDebug() << "Loading extensions with capability-based security...";
     // Create extension manager if not already created
     if (extension_manager_ == nullptr) {
         extension_manager_ = new opencardev::crankshaft::extensions::ExtensionManager();
     }
     extension_manager_->initialize(capability_manager_.get(), config_manager_);
-    extension_manager_->loadAll();
+    // Discovered extensions are loaded by main.cpp once the built-ins are registered, so a
+    // built-in's plugin is not loaded twice and its deferred activation is kept
 }
 
 }  // namespace opencardev::crankshaft::core
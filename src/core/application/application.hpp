@@ -22,6 +22,7 @@
 #include <QObject>
 #include <memory>
 #include "../capabilities/CapabilityManager.hpp"
+#include "../diagnostics/StallWatchdog.hpp"
 #include "../events/event_bus.hpp"
 #include "../network/websocket_server.hpp"
 
@@ -51,6 +52,7 @@ class Application : public QObject {
     EventBus* eventBus() const { return event_bus_.get(); }
     WebSocketServer* webSocketServer() const { return websocket_server_.get(); }
     CapabilityManager* capabilityManager() const { return capability_manager_.get(); }
+    diagnostics::StallWatchdog* stallWatchdog() const { return stall_watchdog_.get(); }
     config::ConfigManager* configManager() const;
     extensions::ExtensionManager* extensionManager() const;
 
@@ -59,11 +61,14 @@ class Application : public QObject {
     void setupWebSocketServer();
     void setupCapabilityManager();
     void setupConfigManager();
+    void setupStallWatchdog();
+    void setupLocation();
     void loadExtensions();
 
     std::unique_ptr<EventBus> event_bus_;
     std::unique_ptr<WebSocketServer> websocket_server_;
     std::unique_ptr<CapabilityManager> capability_manager_;
+    std::unique_ptr<diagnostics::StallWatchdog> stall_watchdog_;
     config::ConfigManager* config_manager_;
     extensions::ExtensionManager* extension_manager_;
 };
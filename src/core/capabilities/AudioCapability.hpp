@@ -47,6 +47,8 @@ class AudioCapability : public Capability {
     ~AudioCapability() override = default;
 
     QString id() const override { return "audio"; }
+    static constexpr CapabilitySlot kSlot = CapabilitySlot::Audio;
+    CapabilitySlot slot() const final { return kSlot; }
 
     /**
      * Audio device information.
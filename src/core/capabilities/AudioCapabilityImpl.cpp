@@ -34,6 +34,7 @@ auto AudioCapabilityImpl::extensionId() const -> QString { return extension_id_;
 auto AudioCapabilityImpl::isValid() const -> bool { return is_valid_; }
 void AudioCapabilityImpl::invalidate() {
     is_valid_ = false;
+    state_subscribers_.clear();
 }
 
 void AudioCapabilityImpl::play(const QUrl& source, StreamType streamType,
@@ -43,7 +44,8 @@ void AudioCapabilityImpl::play(const QUrl& source, StreamType streamType,
         return;
     }
     Q_UNUSED(streamType);
-    manager_->logCapabilityUsage(extension_id_, "audio", "play", source.toString());
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("audio"), QStringLiteral("play"),
+                                 source.toString());
     const int playback_id = next_playback_id_++;
     playback_state_[playback_id] = PlaybackState::Playing;
     playback_volume_[playback_id] = 1.0F;
@@ -52,19 +54,23 @@ void AudioCapabilityImpl::play(const QUrl& source, StreamType streamType,
 
 void AudioCapabilityImpl::stop(int playbackId) {
     playback_state_[playbackId] = PlaybackState::Stopped;
-    manager_->logCapabilityUsage(extension_id_, "audio", "stop", QString::number(playbackId));
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("audio"), QStringLiteral("stop"),
+                                 QString::number(playbackId));
 }
 void AudioCapabilityImpl::pause(int playbackId) {
     playback_state_[playbackId] = PlaybackState::Paused;
-    manager_->logCapabilityUsage(extension_id_, "audio", "pause", QString::number(playbackId));
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("audio"), QStringLiteral("pause"),
+                                 QString::number(playbackId));
 }
 void AudioCapabilityImpl::resume(int playbackId) {
     playback_state_[playbackId] = PlaybackState::Playing;
-    manager_->logCapabilityUsage(extension_id_, "audio", "resume", QString::number(playbackId));
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("audio"), QStringLiteral("resume"),
+                                 QString::number(playbackId));
 }
 void AudioCapabilityImpl::seek(int playbackId, qint64 positionMs) {
     Q_UNUSED(positionMs);
-    manager_->logCapabilityUsage(extension_id_, "audio", "seek", QString::number(playbackId));
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("audio"), QStringLiteral("seek"),
+                                 QString::number(playbackId));
 }
 auto AudioCapabilityImpl::getPlaybackState(int playbackId) const -> AudioCapability::PlaybackState {
     return playback_state_.value(playbackId, PlaybackState::Stopped);
@@ -32,7 +32,7 @@ class AudioCapabilityImpl : public AudioCapability {
     AudioCapabilityImpl(QString extension_id, core::CapabilityManager* manager);
     QString extensionId() const override;
     bool isValid() const override;
-    void invalidate();
+    void invalidate() override;
 
     void play(const QUrl& source, StreamType streamType,
               std::function<void(int, const QString&)> callback) override;
@@ -0,0 +1,266 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AuditLog.hpp"
+#include <QDateTime>
+#include <QDebug>
+#include <QHash>
+#include <QMutexLocker>
+#include <algorithm>
+#include <chrono>
+
+namespace opencardev::crankshaft::core::capabilities {
+
+static_assert((AuditLog::kCapacity & (AuditLog::kCapacity - 1)) == 0,
+              "AuditLog capacity must be a power of two");
+static_assert(AuditLog::kDetailChars % 4 == 0, "Detail prefix must fill whole words");
+
+// ============================================================================
+// AuditStringPool
+// ============================================================================
+
+AuditStringPool::AuditStringPool()
+    : buckets_(new std::atomic<const Entry*>[kBuckets]),
+      by_id_(new std::atomic<const Entry*>[kMaxStrings + 1]),
+      count_(0) {
+    for (quint32 i = 0; i < kBuckets; ++i) {
+        buckets_[i].store(nullptr, std::memory_order_relaxed);
+    }
+    for (quint32 i = 0; i <= kMaxStrings; ++i) {
+        by_id_[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+AuditStringPool::~AuditStringPool() {
+    const quint32 count = count_.load(std::memory_order_acquire);
+    for (quint32 id = 1; id <= count; ++id) {
+        delete by_id_[id].load(std::memory_order_relaxed);
+    }
+}
+
+const AuditStringPool::Entry* AuditStringPool::probe(const QString& text, size_t hash,
+                                                     quint32* freeBucket) const {
+    quint32 bucket = static_cast<quint32>(hash) & (kBuckets - 1);
+    for (quint32 step = 0; step < kBuckets; ++step) {
+        const Entry* entry = buckets_[bucket].load(std::memory_order_acquire);
+        if (entry == nullptr) {
+            if (freeBucket != nullptr) {
+                *freeBucket = bucket;
+            }
+            return nullptr;
+        }
+        if (entry->text == text) {
+            return entry;
+        }
+        bucket = (bucket + 1) & (kBuckets - 1);
+    }
+    return nullptr;
+}
+
+quint32 AuditStringPool::intern(const QString& text) {
+    const size_t hash = qHash(text);
+    if (const Entry* entry = probe(text, hash, nullptr)) {
+        return entry->id;
+    }
+
+    // First sighting: serialise inserts so buckets are only ever filled once
+    QMutexLocker locker(&insert_mutex_);
+    quint32 freeBucket = 0;
+    if (const Entry* entry = probe(text, hash, &freeBucket)) {
+        return entry->id;
+    }
+
+    const quint32 id = count_.load(std::memory_order_relaxed) + 1;
+    if (id > kMaxStrings) {
+        static bool warned = false;
+        if (!warned) {
+            qWarning() << "Audit string pool full; further new names are not recorded";
+            warned = true;
+        }
+        return kInvalidId;
+    }
+
+    // Deep copy so the pool never references caller-owned raw data
+    auto* entry = new Entry{QString(text.constData(), text.size()), id};
+    by_id_[id].store(entry, std::memory_order_release);
+    buckets_[freeBucket].store(entry, std::memory_order_release);
+    count_.store(id, std::memory_order_release);
+    return id;
+}
+
+quint32 AuditStringPool::find(const QString& text) const {
+    const Entry* entry = probe(text, qHash(text), nullptr);
+    return entry != nullptr ? entry->id : kInvalidId;
+}
+
+QString AuditStringPool::lookup(quint32 id) const {
+    if (id == kInvalidId || id > count_.load(std::memory_order_acquire)) {
+        return QString();
+    }
+    const Entry* entry = by_id_[id].load(std::memory_order_acquire);
+    return entry != nullptr ? entry->text : QString();
+}
+
+// ============================================================================
+// AuditLog
+// ============================================================================
+
+AuditLog::AuditLog()
+    : slots_(new Slot[kCapacity]),
+      head_(0),
+      epoch_anchor_ms_(QDateTime::currentMSecsSinceEpoch()),
+      monotonic_anchor_ns_(monotonicNs()) {}
+
+AuditLog::~AuditLog() = default;
+
+qint64 AuditLog::monotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+qint64 AuditLog::toEpochMs(qint64 timestampNs) const {
+    return epoch_anchor_ms_ + (timestampNs - monotonic_anchor_ns_) / 1000000;
+}
+
+void AuditLog::append(const QString& extensionId, const QString& capabilityType,
+                      const QString& action, QStringView details) {
+    const quint64 subject = (quint64(strings_.intern(extensionId)) << 32) |
+                            strings_.intern(capabilityType);
+    const qsizetype length = std::min<qsizetype>(details.size(), kDetailChars);
+    quint64 actionWord = (quint64(strings_.intern(action)) << 32) | quint64(length);
+    if (details.size() > kDetailChars) {
+        actionWord |= kTruncatedFlag;
+    }
+
+    std::array<quint64, kDetailWords> words{};
+    for (qsizetype i = 0; i < length; ++i) {
+        words[i / 4] |= quint64(details[i].unicode()) << (16 * (i % 4));
+    }
+    const qint64 timestamp = monotonicNs();
+
+    // Claim a slot, then publish it seqlock-style so readers can detect torn records
+    const quint64 index = head_.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots_[index & (kCapacity - 1)];
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timestamp_ns.store(timestamp, std::memory_order_relaxed);
+    slot.subject.store(subject, std::memory_order_relaxed);
+    slot.action.store(actionWord, std::memory_order_relaxed);
+    for (int w = 0; w < kDetailWords; ++w) {
+        slot.detail[w].store(words[w], std::memory_order_relaxed);
+    }
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+AuditLog::ReadStatus AuditLog::readRecord(quint64 index, Record* record) const {
+    const Slot& slot = slots_[index & (kCapacity - 1)];
+    const quint64 expected = 2 * index + 2;
+    const quint64 before = slot.sequence.load(std::memory_order_acquire);
+    if (before != expected) {
+        // Lower: claimed but not yet published. Higher: a newer record took the slot
+        return before < expected ? ReadStatus::Pending : ReadStatus::Overwritten;
+    }
+    record->timestamp_ns = slot.timestamp_ns.load(std::memory_order_relaxed);
+    record->subject = slot.subject.load(std::memory_order_relaxed);
+    record->action = slot.action.load(std::memory_order_relaxed);
+    for (int w = 0; w < kDetailWords; ++w) {
+        record->detail[w] = slot.detail[w].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == expected ? ReadStatus::Ready
+                                                                     : ReadStatus::Overwritten;
+}
+
+AuditEntry AuditLog::format(quint64 index, const Record& record) const {
+    const int length = int(record.action & 0xFFFF);
+    QString details(length, Qt::Uninitialized);
+    for (int i = 0; i < length; ++i) {
+        details[i] = QChar(char16_t(record.detail[i / 4] >> (16 * (i % 4))));
+    }
+    if ((record.action & kTruncatedFlag) != 0) {
+        details.append(QChar(0x2026));  // Ellipsis
+    }
+
+    AuditEntry entry;
+    entry.sequence = index;
+    entry.timestamp_ms = toEpochMs(record.timestamp_ns);
+    entry.extension_id = strings_.lookup(quint32(record.subject >> 32));
+    entry.capability_type = strings_.lookup(quint32(record.subject & 0xFFFFFFFF));
+    entry.action = strings_.lookup(quint32(record.action >> 32));
+    entry.details = details;
+    return entry;
+}
+
+QList<QVariantMap> AuditLog::entries(const QString& extensionId, int limit) const {
+    QList<QVariantMap> result;
+
+    quint32 extensionFilter = AuditStringPool::kInvalidId;
+    if (!extensionId.isEmpty()) {
+        extensionFilter = strings_.find(extensionId);
+        if (extensionFilter == AuditStringPool::kInvalidId) {
+            return result;
+        }
+    }
+
+    const quint64 head = head_.load(std::memory_order_acquire);
+    const quint64 oldest = head > kCapacity ? head - kCapacity : 0;
+    for (quint64 index = head; index > oldest && (limit <= 0 || result.size() < limit);
+         --index) {
+        Record record;
+        if (readRecord(index - 1, &record) != ReadStatus::Ready) {
+            continue;
+        }
+        if (extensionFilter != AuditStringPool::kInvalidId &&
+            quint32(record.subject >> 32) != extensionFilter) {
+            continue;
+        }
+        result.append(format(index - 1, record).toMap());
+    }
+
+    return result;
+}
+
+quint64 AuditLog::collectSince(quint64 fromSequence, QList<AuditEntry>* out) const {
+    const quint64 head = head_.load(std::memory_order_acquire);
+    quint64 index = std::max(fromSequence, head > kCapacity ? head - kCapacity : 0);
+    for (; index < head; ++index) {
+        Record record;
+        const ReadStatus status = readRecord(index, &record);
+        if (status == ReadStatus::Pending) {
+            break;  // Resume here once the writer has published it
+        }
+        if (status == ReadStatus::Ready) {
+            out->append(format(index, record));
+        }
+    }
+    return index;
+}
+
+QVariantMap AuditEntry::toMap() const {
+    QVariantMap map;
+    map["timestamp"] = timestamp_ms;
+    map["extension_id"] = extension_id;
+    map["capability_type"] = capability_type;
+    map["action"] = action;
+    map["details"] = details;
+    return map;
+}
+
+}  // namespace opencardev::crankshaft::core::capabilities
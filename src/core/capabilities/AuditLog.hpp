@@ -0,0 +1,161 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringView>
+#include <QVariantMap>
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace opencardev::crankshaft::core::capabilities {
+
+/**
+ * Append-only string intern pool with lock-free lookups.
+ *
+ * Extension IDs, capability types and action names repeat constantly in the audit
+ * log, so each is stored once and referred to by a 32-bit ID. Lookups of strings
+ * that are already interned never take a lock; only the first sighting of a new
+ * string serialises on an internal mutex. Entries live until the pool is destroyed.
+ */
+class AuditStringPool {
+  public:
+    static constexpr quint32 kInvalidId = 0;
+    static constexpr quint32 kMaxStrings = 2048;
+
+    AuditStringPool();
+    ~AuditStringPool();
+
+    AuditStringPool(const AuditStringPool&) = delete;
+    AuditStringPool& operator=(const AuditStringPool&) = delete;
+
+    // Returns the ID for text, adding it if needed; kInvalidId once the pool is full
+    quint32 intern(const QString& text);
+    // Returns the ID for text without adding it; kInvalidId if unknown
+    quint32 find(const QString& text) const;
+    QString lookup(quint32 id) const;
+
+  private:
+    struct Entry {
+        QString text;
+        quint32 id;
+    };
+
+    static constexpr quint32 kBuckets = kMaxStrings * 2;  // Power of two, load <= 0.5
+
+    const Entry* probe(const QString& text, size_t hash, quint32* freeBucket) const;
+
+    std::unique_ptr<std::atomic<const Entry*>[]> buckets_;
+    std::unique_ptr<std::atomic<const Entry*>[]> by_id_;
+    std::atomic<quint32> count_;
+    QMutex insert_mutex_;
+};
+
+// A formatted audit record
+struct AuditEntry {
+    quint64 sequence = 0;  // Position in the log since start-up
+    qint64 timestamp_ms = 0;
+    QString extension_id;
+    QString capability_type;
+    QString action;
+    QString details;
+
+    QVariantMap toMap() const;
+};
+
+/**
+ * Fixed-capacity, lock-free audit log of capability usage.
+ *
+ * Writers claim a slot with a single atomic increment and publish it through a
+ * per-slot sequence number, so logging never blocks and never allocates. Records
+ * are compact (interned IDs, a monotonic timestamp and a short detail prefix); they
+ * are only formatted into QVariantMaps when entries() is called. Once full, the
+ * oldest records are overwritten.
+ */
+class AuditLog {
+  public:
+    static constexpr quint64 kCapacity = 16384;  // Power of two
+    static constexpr int kDetailChars = 40;      // Longer details are truncated
+
+    AuditLog();
+    ~AuditLog();
+
+    AuditLog(const AuditLog&) = delete;
+    AuditLog& operator=(const AuditLog&) = delete;
+
+    void append(const QString& extensionId, const QString& capabilityType, const QString& action,
+                QStringView details);
+
+    /**
+     * Newest-first formatted entries.
+     *
+     * @param extensionId Only entries for this extension (empty = all)
+     * @param limit Maximum number of entries (0 = all retained)
+     */
+    QList<QVariantMap> entries(const QString& extensionId, int limit) const;
+
+    /**
+     * Oldest-first copy of the published records from fromSequence onwards, for
+     * spilling to persistent storage. Records already overwritten are skipped.
+     *
+     * @return Sequence to resume from on the next call
+     */
+    quint64 collectSince(quint64 fromSequence, QList<AuditEntry>* out) const;
+
+    // Total number of records ever appended, including overwritten ones
+    quint64 totalAppended() const { return head_.load(std::memory_order_relaxed); }
+
+  private:
+    static constexpr int kDetailWords = kDetailChars / 4;  // Four UTF-16 units per word
+    static constexpr quint64 kTruncatedFlag = Q_UINT64_C(1) << 31;
+
+    struct alignas(64) Slot {
+        std::atomic<quint64> sequence{0};  // 2n+1 while writing record n, 2n+2 once published
+        std::atomic<qint64> timestamp_ns{0};
+        std::atomic<quint64> subject{0};  // extension ID << 32 | capability ID
+        std::atomic<quint64> action{0};   // action ID << 32 | detail length (+ truncated flag)
+        std::array<std::atomic<quint64>, kDetailWords> detail{};
+    };
+
+    struct Record {
+        qint64 timestamp_ns;
+        quint64 subject;
+        quint64 action;
+        std::array<quint64, kDetailWords> detail;
+    };
+
+    enum class ReadStatus { Ready, Pending, Overwritten };
+
+    ReadStatus readRecord(quint64 index, Record* record) const;
+    AuditEntry format(quint64 index, const Record& record) const;
+    qint64 toEpochMs(qint64 timestampNs) const;
+    static qint64 monotonicNs();
+
+    AuditStringPool strings_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<quint64> head_;
+    qint64 epoch_anchor_ms_;
+    qint64 monotonic_anchor_ns_;
+};
+
+}  // namespace opencardev::crankshaft::core::capabilities
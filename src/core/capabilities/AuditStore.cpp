@@ -0,0 +1,502 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AuditStore.hpp"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <algorithm>
+
+namespace opencardev::crankshaft::core::capabilities {
+
+namespace {
+
+constexpr quint32 kSegmentMagic = 0x43534153;  // "CSAS"
+constexpr quint32 kIndexMagic = 0x43534149;    // "CSAI"
+constexpr quint16 kFormatVersion = 1;
+constexpr QDataStream::Version kStreamVersion = QDataStream::Qt_6_0;
+
+// Segment entry kinds
+constexpr quint8 kStringEntry = 0;  // quint32 id, QString text
+constexpr quint8 kRecordEntry = 1;  // qint64 ts, quint32 extension, capability, action, QString
+
+constexpr int kCachedIndexes = 4;
+
+}  // namespace
+
+AuditStore::AuditStore(const AuditLog* log, const QString& directory, QObject* parent)
+    : QObject(parent), log_(log), directory_(directory), index_cache_(kCachedIndexes) {
+    flush_timer_.setInterval(kFlushIntervalMs);
+    connect(&flush_timer_, &QTimer::timeout, this, &AuditStore::flush);
+}
+
+AuditStore::~AuditStore() {
+    flush_timer_.stop();
+    flush();
+    QMutexLocker locker(&mutex_);
+    sealActiveSegment();
+}
+
+QString AuditStore::segmentPath(const QString& directory, quint64 base) {
+    return QStringLiteral("%1/audit-%2.seg").arg(directory).arg(base, 16, 16, QLatin1Char('0'));
+}
+
+QString AuditStore::indexPath(const QString& segmentPath) {
+    return segmentPath.left(segmentPath.size() - 4) + QStringLiteral(".idx");
+}
+
+bool AuditStore::open() {
+    QMutexLocker locker(&mutex_);
+
+    if (!QDir().mkpath(directory_)) {
+        qWarning() << "Cannot create audit directory:" << directory_;
+        return false;
+    }
+
+    // Fixed-width hex bases, so name order is record order
+    const QStringList names = QDir(directory_).entryList({QStringLiteral("audit-*.seg")},
+                                                         QDir::Files, QDir::Name);
+    quint64 nextBase = 0;
+    for (const QString& name : names) {
+        const QString path = directory_ + QLatin1Char('/') + name;
+        SegmentIndex index;
+        if (!readIndex(indexPath(path), &index) || index.data_size != QFileInfo(path).size()) {
+            // Unsealed (e.g. after a crash) or stale: rebuild from the records themselves
+            if (!scanSegment(path, &index)) {
+                qWarning() << "Skipping unreadable audit segment:" << path;
+                continue;
+            }
+            if (index.count() > 0 && index.data_size < QFileInfo(path).size()) {
+                QFile::resize(path, index.data_size);  // Drop a torn trailing record
+            }
+            if (index.count() > 0) {
+                writeIndex(indexPath(path), index);
+            }
+        }
+        if (index.count() == 0) {
+            QFile::remove(path);
+            QFile::remove(indexPath(path));
+            continue;
+        }
+
+        sealed_.append({path, index.base, index.count(), index.min_ts, index.max_ts});
+        nextBase = index.base + index.count();
+        last_timestamp_ = std::max(last_timestamp_, index.max_ts);
+    }
+
+    pruneSegments();
+    if (!startSegment(nextBase)) {
+        return false;
+    }
+
+    flush_timer_.start();
+    qInfo() << "Audit store opened:" << directory_ << "with" << sealed_.size() << "segments";
+    return true;
+}
+
+bool AuditStore::startSegment(quint64 base) {
+    const QString path = segmentPath(directory_, base);
+    active_file_.setFileName(path);
+    if (!active_file_.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Cannot open audit segment:" << path << active_file_.errorString();
+        return false;
+    }
+    active_stream_.setDevice(&active_file_);
+    active_stream_.setVersion(kStreamVersion);
+    active_stream_ << kSegmentMagic << kFormatVersion << base;
+
+    active_index_ = std::make_unique<SegmentIndex>();
+    active_index_->base = base;
+    active_info_ = SegmentInfo{path, base, 0, 0, 0};
+    return true;
+}
+
+void AuditStore::sealActiveSegment() {
+    if (!active_file_.isOpen()) {
+        return;
+    }
+
+    active_index_->data_size = active_file_.pos();
+    active_stream_.setDevice(nullptr);
+    active_file_.close();
+
+    const QString path = active_info_.path;
+    if (active_index_->count() == 0) {
+        QFile::remove(path);
+        active_index_.reset();
+        return;
+    }
+
+    writeIndex(indexPath(path), *active_index_);
+    sealed_.append(active_info_);
+    index_cache_.insert(path, active_index_.release());
+    pruneSegments();
+}
+
+void AuditStore::pruneSegments() {
+    // The active segment counts towards the budget
+    while (!sealed_.isEmpty() && sealed_.size() + 1 > kMaxSegments) {
+        const SegmentInfo oldest = sealed_.takeFirst();
+        index_cache_.remove(oldest.path);
+        QFile::remove(oldest.path);
+        QFile::remove(indexPath(oldest.path));
+    }
+}
+
+quint32 AuditStore::internActive(const QString& text) {
+    auto it = active_index_->ids.constFind(text);
+    if (it != active_index_->ids.constEnd()) {
+        return it.value();
+    }
+    const quint32 id = quint32(active_index_->strings.size()) + 1;
+    active_stream_ << kStringEntry << id << text;
+    active_index_->strings.append(text);
+    active_index_->ids.insert(text, id);
+    return id;
+}
+
+void AuditStore::indexRecord(SegmentIndex* index, qint64 offset, qint64 timestamp,
+                             quint32 extension, quint32 capability, quint32 action) {
+    const quint32 local = index->count();
+    index->offsets.append(offset);
+    index->timestamps.append(timestamp);
+    index->by_extension[extension].append(local);
+    index->by_capability[capability].append(local);
+    index->by_action[action].append(local);
+    index->min_ts = std::min(index->min_ts, timestamp);
+    index->max_ts = std::max(index->max_ts, timestamp);
+}
+
+void AuditStore::flush() {
+    QMutexLocker locker(&mutex_);
+    if (!active_file_.isOpen()) {
+        return;
+    }
+
+    QList<AuditEntry> entries;
+    const quint64 expected = log_cursor_;
+    log_cursor_ = log_->collectSince(log_cursor_, &entries);
+    if (entries.isEmpty()) {
+        return;
+    }
+    if (entries.first().sequence > expected) {
+        qWarning() << "Audit log wrapped before flush;" << entries.first().sequence - expected
+                   << "records were not persisted";
+    }
+
+    for (const AuditEntry& entry : entries) {
+        if (active_index_->count() >= quint32(kMaxRecordsPerSegment) ||
+            active_file_.pos() >= kMaxSegmentBytes) {
+            const quint64 nextBase = active_info_.base + active_index_->count();
+            sealActiveSegment();
+            if (!startSegment(nextBase)) {
+                return;
+            }
+        }
+
+        const quint32 extension = internActive(entry.extension_id);
+        const quint32 capability = internActive(entry.capability_type);
+        const quint32 action = internActive(entry.action);
+        const qint64 timestamp = std::max(entry.timestamp_ms, last_timestamp_);
+        last_timestamp_ = timestamp;
+
+        const qint64 offset = active_file_.pos();
+        active_stream_ << kRecordEntry << timestamp << extension << capability << action
+                       << entry.details;
+        indexRecord(active_index_.get(), offset, timestamp, extension, capability, action);
+    }
+
+    active_info_.count = active_index_->count();
+    active_info_.min_ts = active_index_->min_ts;
+    active_info_.max_ts = active_index_->max_ts;
+
+    if (active_stream_.status() != QDataStream::Ok || !active_file_.flush()) {
+        qWarning() << "Failed writing audit segment:" << active_info_.path
+                   << active_file_.errorString();
+    }
+}
+
+bool AuditStore::scanSegment(const QString& path, SegmentIndex* index) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream in(&file);
+    in.setVersion(kStreamVersion);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version >> index->base;
+    if (in.status() != QDataStream::Ok || magic != kSegmentMagic || version != kFormatVersion) {
+        return false;
+    }
+
+    index->data_size = file.pos();
+    while (!in.atEnd()) {
+        const qint64 offset = file.pos();
+        quint8 kind = 0;
+        in >> kind;
+        if (kind == kStringEntry) {
+            quint32 id = 0;
+            QString text;
+            in >> id >> text;
+            if (in.status() != QDataStream::Ok || id != quint32(index->strings.size()) + 1) {
+                break;
+            }
+            index->strings.append(text);
+        } else if (kind == kRecordEntry) {
+            qint64 timestamp = 0;
+            quint32 extension = 0, capability = 0, action = 0;
+            QString details;
+            in >> timestamp >> extension >> capability >> action >> details;
+            if (in.status() != QDataStream::Ok) {
+                break;
+            }
+            indexRecord(index, offset, timestamp, extension, capability, action);
+        } else {
+            break;
+        }
+        index->data_size = file.pos();
+    }
+
+    for (int i = 0; i < index->strings.size(); ++i) {
+        index->ids.insert(index->strings.at(i), quint32(i) + 1);
+    }
+    return true;
+}
+
+bool AuditStore::writeIndex(const QString& path, const SegmentIndex& index) {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write audit index:" << path << file.errorString();
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(kStreamVersion);
+    out << kIndexMagic << kFormatVersion << index.base << index.data_size << index.min_ts
+        << index.max_ts << index.strings << index.offsets << index.timestamps
+        << index.by_extension << index.by_capability << index.by_action;
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+bool AuditStore::readIndex(const QString& path, SegmentIndex* index) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream in(&file);
+    in.setVersion(kStreamVersion);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != kIndexMagic || version != kFormatVersion) {
+        return false;
+    }
+    in >> index->base >> index->data_size >> index->min_ts >> index->max_ts >> index->strings
+        >> index->offsets >> index->timestamps >> index->by_extension >> index->by_capability
+        >> index->by_action;
+    if (in.status() != QDataStream::Ok || index->offsets.size() != index->timestamps.size()) {
+        *index = SegmentIndex();
+        return false;
+    }
+
+    for (int i = 0; i < index->strings.size(); ++i) {
+        index->ids.insert(index->strings.at(i), quint32(i) + 1);
+    }
+    return true;
+}
+
+const AuditStore::SegmentIndex* AuditStore::indexFor(const SegmentInfo& info) const {
+    if (active_index_ && info.path == active_info_.path) {
+        return active_index_.get();
+    }
+    if (SegmentIndex* cached = index_cache_.object(info.path)) {
+        return cached;
+    }
+
+    auto index = std::make_unique<SegmentIndex>();
+    if (!readIndex(indexPath(info.path), index.get())) {
+        *index = SegmentIndex();
+        if (!scanSegment(info.path, index.get())) {
+            qWarning() << "Audit segment unreadable:" << info.path;
+            return nullptr;
+        }
+        writeIndex(indexPath(info.path), *index);
+    }
+
+    SegmentIndex* loaded = index.release();
+    index_cache_.insert(info.path, loaded);
+    return loaded;
+}
+
+AuditQueryResult AuditStore::query(const AuditQuery& query) const {
+    QMutexLocker locker(&mutex_);
+
+    AuditQueryResult result;
+    const int limit = query.limit > 0 ? query.limit : std::numeric_limits<int>::max() - 1;
+
+    QList<const SegmentInfo*> segments;
+    if (active_index_) {
+        segments.append(&active_info_);
+    }
+    for (auto it = sealed_.crbegin(); it != sealed_.crend(); ++it) {
+        segments.append(&*it);
+    }
+
+    for (const SegmentInfo* info : segments) {
+        // One extra entry tells us whether another page exists
+        if (result.entries.size() > limit) {
+            break;
+        }
+        if (info->count == 0 || info->base >= query.before || info->max_ts < query.from_ms ||
+            info->min_ts > query.to_ms) {
+            continue;
+        }
+        if (const SegmentIndex* index = indexFor(*info)) {
+            querySegment(*info, *index, query, &result);
+        }
+    }
+
+    if (result.entries.size() > limit) {
+        result.entries.resize(limit);
+        result.has_more = true;
+    }
+    if (!result.entries.isEmpty()) {
+        result.next_cursor = result.entries.constLast().sequence;
+    }
+    return result;
+}
+
+void AuditStore::querySegment(const SegmentInfo& info, const SegmentIndex& index,
+                              const AuditQuery& query, AuditQueryResult* result) const {
+    const int limit = query.limit > 0 ? query.limit : std::numeric_limits<int>::max() - 1;
+
+    // Time range and cursor narrow the window of local record numbers to [first, last)
+    const auto& timestamps = index.timestamps;
+    quint32 first = quint32(std::lower_bound(timestamps.cbegin(), timestamps.cend(),
+                                             query.from_ms) -
+                            timestamps.cbegin());
+    quint32 last = quint32(std::upper_bound(timestamps.cbegin(), timestamps.cend(),
+                                            query.to_ms) -
+                           timestamps.cbegin());
+    if (query.before - index.base < last) {
+        last = quint32(query.before - index.base);
+    }
+    if (first >= last) {
+        return;
+    }
+
+    // Posting lists for each filter; an unknown value means no matches in this segment
+    QList<const QList<quint32>*> postings;
+    auto addFilter = [&](const QString& value,
+                         const QHash<quint32, QList<quint32>>& lists) -> bool {
+        if (value.isEmpty()) {
+            return true;
+        }
+        auto it = lists.constFind(index.ids.value(value));
+        if (it == lists.constEnd()) {
+            return false;
+        }
+        postings.append(&it.value());
+        return true;
+    };
+    if (!addFilter(query.extension_id, index.by_extension) ||
+        !addFilter(query.capability_type, index.by_capability) ||
+        !addFilter(query.action, index.by_action)) {
+        return;
+    }
+
+    QList<quint32> matches;
+    if (postings.isEmpty()) {
+        matches.reserve(int(last - first));
+        for (quint32 i = first; i < last; ++i) {
+            matches.append(i);
+        }
+    } else {
+        // Walk the shortest list and probe the others
+        std::sort(postings.begin(), postings.end(),
+                  [](const QList<quint32>* a, const QList<quint32>* b) {
+                      return a->size() < b->size();
+                  });
+        const QList<quint32>& shortest = *postings.constFirst();
+        auto begin = std::lower_bound(shortest.cbegin(), shortest.cend(), first);
+        auto end = std::lower_bound(begin, shortest.cend(), last);
+        for (auto it = begin; it != end; ++it) {
+            const bool inAll = std::all_of(
+                postings.cbegin() + 1, postings.cend(), [&](const QList<quint32>* list) {
+                    return std::binary_search(list->cbegin(), list->cend(), *it);
+                });
+            if (inAll) {
+                matches.append(*it);
+            }
+        }
+    }
+    if (matches.isEmpty()) {
+        return;
+    }
+
+    QFile file(info.path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Cannot read audit segment:" << info.path << file.errorString();
+        return;
+    }
+    QDataStream in(&file);
+    in.setVersion(kStreamVersion);
+
+    auto text = [&](quint32 id) {
+        return id > 0 && id <= quint32(index.strings.size()) ? index.strings.at(int(id) - 1)
+                                                             : QString();
+    };
+
+    for (auto it = matches.crbegin(); it != matches.crend() && result->entries.size() <= limit;
+         ++it) {
+        if (!file.seek(index.offsets.at(int(*it)))) {
+            break;
+        }
+        quint8 kind = 0;
+        qint64 timestamp = 0;
+        quint32 extension = 0, capability = 0, action = 0;
+        AuditEntry entry;
+        in >> kind >> timestamp >> extension >> capability >> action >> entry.details;
+        if (in.status() != QDataStream::Ok || kind != kRecordEntry) {
+            qWarning() << "Corrupt audit record in" << info.path << "at" << *it;
+            break;
+        }
+        entry.sequence = index.base + *it;
+        entry.timestamp_ms = timestamp;
+        entry.extension_id = text(extension);
+        entry.capability_type = text(capability);
+        entry.action = text(action);
+        result->entries.append(entry);
+    }
+}
+
+quint64 AuditStore::recordCount() const {
+    QMutexLocker locker(&mutex_);
+    quint64 count = active_index_ ? active_index_->count() : 0;
+    for (const SegmentInfo& info : sealed_) {
+        count += info.count;
+    }
+    return count;
+}
+
+}  // namespace opencardev::crankshaft::core::capabilities
@@ -0,0 +1,159 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QCache>
+#include <QDataStream>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <limits>
+#include <memory>
+#include "AuditLog.hpp"
+
+namespace opencardev::crankshaft::core::capabilities {
+
+// Filter and page position for AuditStore::query(); empty strings match anything
+struct AuditQuery {
+    QString extension_id;
+    QString capability_type;
+    QString action;
+    qint64 from_ms = 0;                                     // Inclusive
+    qint64 to_ms = std::numeric_limits<qint64>::max();      // Inclusive
+    quint64 before = std::numeric_limits<quint64>::max();   // Cursor from a previous page
+    int limit = 100;
+};
+
+struct AuditQueryResult {
+    QList<AuditEntry> entries;  // Newest first; sequence is the persistent record number
+    quint64 next_cursor = 0;    // Pass as AuditQuery::before to fetch the next page
+    bool has_more = false;
+};
+
+/**
+ * Persistent, indexed store for the capability audit trail.
+ *
+ * Records are periodically drained from an AuditLog into append-only segment files
+ * (audit-<first record>.seg) in a single directory. Each segment carries its own
+ * string dictionary, so extension IDs, capability types and action names are written
+ * once per segment. Segments rotate by record count or size and the oldest are deleted
+ * beyond a fixed budget.
+ *
+ * When a segment is sealed an index (.idx) is written next to it holding record
+ * offsets, timestamps and posting lists per extension, capability and action. Queries
+ * walk segments newest first, skip those outside the time range, binary search the
+ * timestamps and intersect posting lists, then read only the matching records. Indexes
+ * of sealed segments are loaded on demand and kept in a small cache.
+ *
+ * Timestamps are clamped to be non-decreasing when written so the per-segment time
+ * column stays sorted even if the wall clock steps backwards.
+ */
+class AuditStore : public QObject {
+    Q_OBJECT
+
+  public:
+    static constexpr int kMaxRecordsPerSegment = 50000;
+    static constexpr qint64 kMaxSegmentBytes = 8 * 1024 * 1024;
+    static constexpr int kMaxSegments = 20;
+    static constexpr int kFlushIntervalMs = 2000;
+
+    AuditStore(const AuditLog* log, const QString& directory, QObject* parent = nullptr);
+    ~AuditStore() override;
+
+    /**
+     * Scan existing segments, rebuild missing indexes and start a new active segment.
+     *
+     * @return false if the directory cannot be created or written
+     */
+    bool open();
+
+    // Append records published to the log since the previous flush
+    void flush();
+
+    AuditQueryResult query(const AuditQuery& query) const;
+
+    QString directory() const { return directory_; }
+    // Records held across all segments
+    quint64 recordCount() const;
+
+  private:
+    struct SegmentIndex {
+        quint64 base = 0;  // Persistent number of the segment's first record
+        qint64 data_size = 0;
+        qint64 min_ts = std::numeric_limits<qint64>::max();
+        qint64 max_ts = std::numeric_limits<qint64>::min();
+        QStringList strings;  // Segment-local ID - 1 -> text
+        QList<qint64> offsets;
+        QList<qint64> timestamps;
+        QHash<quint32, QList<quint32>> by_extension;
+        QHash<quint32, QList<quint32>> by_capability;
+        QHash<quint32, QList<quint32>> by_action;
+        QHash<QString, quint32> ids;  // Derived from strings on load
+
+        quint32 count() const { return quint32(offsets.size()); }
+    };
+
+    // Always-resident summary used to skip segments without loading their index
+    struct SegmentInfo {
+        QString path;
+        quint64 base = 0;
+        quint32 count = 0;
+        qint64 min_ts = 0;
+        qint64 max_ts = 0;
+    };
+
+    bool startSegment(quint64 base);
+    void sealActiveSegment();
+    void pruneSegments();
+    quint32 internActive(const QString& text);
+
+    static QString segmentPath(const QString& directory, quint64 base);
+    static QString indexPath(const QString& segmentPath);
+    static bool scanSegment(const QString& path, SegmentIndex* index);
+    static bool writeIndex(const QString& path, const SegmentIndex& index);
+    static bool readIndex(const QString& path, SegmentIndex* index);
+    static void indexRecord(SegmentIndex* index, qint64 offset, qint64 timestamp,
+                            quint32 extension, quint32 capability, quint32 action);
+
+    const SegmentIndex* indexFor(const SegmentInfo& info) const;
+    void querySegment(const SegmentInfo& info, const SegmentIndex& index,
+                      const AuditQuery& query, AuditQueryResult* result) const;
+
+    const AuditLog* log_;
+    QString directory_;
+    quint64 log_cursor_ = 0;
+    qint64 last_timestamp_ = 0;
+
+    QList<SegmentInfo> sealed_;  // Oldest first
+    SegmentInfo active_info_;
+    std::unique_ptr<SegmentIndex> active_index_;
+    QFile active_file_;
+    QDataStream active_stream_;
+
+    QTimer flush_timer_;
+    mutable QCache<QString, SegmentIndex> index_cache_;
+    mutable QMutex mutex_;
+};
+
+}  // namespace opencardev::crankshaft::core::capabilities
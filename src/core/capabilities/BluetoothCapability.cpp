@@ -62,7 +62,7 @@ class BluetoothCapabilityImpl : public BluetoothCapability {
     QString extensionId() const override { return extension_id_; }
     bool isValid() const override { return is_valid_; }
 
-    void invalidate() { is_valid_ = false; }
+    void invalidate() override { is_valid_ = false; }
 
     QStringList listAdapters() const override {
         if (!is_valid_)
@@ -82,7 +82,8 @@ class BluetoothCapabilityImpl : public BluetoothCapability {
             return false;
         // In future we might validate against listAdapters(); for now always accept.
         current_adapter_ = adapterId;
-        manager_->logCapabilityUsage(extension_id_, "bluetooth", "selectAdapter", adapterId);
+        manager_->logCapabilityUsage(extension_id_, QStringLiteral("bluetooth"),
+                                     QStringLiteral("selectAdapter"), adapterId);
         return true;
     }
 
@@ -106,7 +107,8 @@ class BluetoothCapabilityImpl : public BluetoothCapability {
         }
         devices_.clear();
         discovery_agent_->start(QBluetoothDeviceDiscoveryAgent::ClassicMethod);
-        manager_->logCapabilityUsage(extension_id_, "bluetooth", "startDiscovery",
+        manager_->logCapabilityUsage(extension_id_, QStringLiteral("bluetooth"),
+                                     QStringLiteral("startDiscovery"),
                                      QString::number(timeoutMs));
         if (timeoutMs <= 0)
             timeoutMs = 10000;  // default 10s
@@ -127,7 +129,8 @@ class BluetoothCapabilityImpl : public BluetoothCapability {
         }
         if (discovery_timer_)
             discovery_timer_->stop();
-        manager_->logCapabilityUsage(extension_id_, "bluetooth", "stopDiscovery", QString());
+        manager_->logCapabilityUsage(extension_id_, QStringLiteral("bluetooth"),
+                                     QStringLiteral("stopDiscovery"), QString());
         notifySubscribers();
     }
 
@@ -138,7 +141,8 @@ class BluetoothCapabilityImpl : public BluetoothCapability {
             auto dev = devices_[address];
             dev.paired = true;  // Simulated pairing success
             devices_[address] = dev;
-            manager_->logCapabilityUsage(extension_id_, "bluetooth", "pairDevice", address);
+            manager_->logCapabilityUsage(extension_id_, QStringLiteral("bluetooth"),
+                                         QStringLiteral("pairDevice"), address);
             notifySubscribers();
             if (local_device_ && local_device_->isValid()) {
                 QBluetoothAddress addr(address);
@@ -156,7 +160,8 @@ class BluetoothCapabilityImpl : public BluetoothCapability {
             auto dev = devices_[address];
             dev.connected = true;  // Logical connection
             devices_[address] = dev;
-            manager_->logCapabilityUsage(extension_id_, "bluetooth", "connectDevice", address);
+            manager_->logCapabilityUsage(extension_id_, QStringLiteral("bluetooth"),
+                                         QStringLiteral("connectDevice"), address);
             notifySubscribers();
             return true;
         }
@@ -170,7 +175,8 @@ class BluetoothCapabilityImpl : public BluetoothCapability {
             auto dev = devices_[address];
             dev.connected = false;
             devices_[address] = dev;
-            manager_->logCapabilityUsage(extension_id_, "bluetooth", "disconnectDevice", address);
+            manager_->logCapabilityUsage(extension_id_, QStringLiteral("bluetooth"),
+                                         QStringLiteral("disconnectDevice"), address);
             notifySubscribers();
             return true;
         }
@@ -185,7 +191,8 @@ class BluetoothCapabilityImpl : public BluetoothCapability {
         // under some environments.
         subscriptions_.append(QPair<int, std::function<void(const QList<Device>&)>>(id, callback));
         callback(listDevices());
-        manager_->logCapabilityUsage(extension_id_, "bluetooth", "subscribeDevices",
+        manager_->logCapabilityUsage(extension_id_, QStringLiteral("bluetooth"),
+                                     QStringLiteral("subscribeDevices"),
                                      QString::number(id));
         return id;
     }
@@ -197,7 +204,8 @@ class BluetoothCapabilityImpl : public BluetoothCapability {
                 break;
             }
         }
-        manager_->logCapabilityUsage(extension_id_, "bluetooth", "unsubscribeDevices",
+        manager_->logCapabilityUsage(extension_id_, QStringLiteral("bluetooth"),
+                                     QStringLiteral("unsubscribeDevices"),
                                      QString::number(subscriptionId));
     }
 
@@ -217,7 +225,8 @@ class BluetoothCapabilityImpl : public BluetoothCapability {
     }
 
     void onDiscoveryFinished() {
-        manager_->logCapabilityUsage(extension_id_, "bluetooth", "discoveryFinished", QString());
+        manager_->logCapabilityUsage(extension_id_, QStringLiteral("bluetooth"),
+                                     QStringLiteral("discoveryFinished"), QString());
         notifySubscribers();
     }
 
@@ -59,6 +59,8 @@ class BluetoothCapability : public Capability {
     ~BluetoothCapability() override = default;
 
     QString id() const override { return "bluetooth"; }
+    static constexpr CapabilitySlot kSlot = CapabilitySlot::Bluetooth;
+    CapabilitySlot slot() const final { return kSlot; }
 
     // List available adapters (addresses or symbolic names).
     virtual QStringList listAdapters() const = 0;
@@ -26,6 +26,25 @@ namespace opencardev::crankshaft {
 namespace core {
 namespace capabilities {
 
+/**
+ * Built-in capability interfaces, each with a fixed slot in an extension's capability
+ * table so Extension::getCapability<T>() is an indexed load. Capability types contributed
+ * through registered factories have no slot and are found by scanning.
+ */
+enum class CapabilitySlot : int {
+    None = -1,
+    Location,
+    Network,
+    FileSystem,
+    UI,
+    Event,
+    Bluetooth,
+    Audio,
+    Video,
+    Wireless,
+    Count
+};
+
 /**
  * Base capability interface for extension security model.
  *
@@ -45,6 +64,11 @@ class Capability {
      */
     virtual QString id() const = 0;
 
+    /**
+     * Slot of the built-in interface this capability implements; fixed by the interface.
+     */
+    virtual CapabilitySlot slot() const { return CapabilitySlot::None; }
+
     /**
      * Check if this capability is still valid.
      * Returns false if capability has been revoked by core.
@@ -56,6 +80,13 @@ class Capability {
      */
     virtual QString extensionId() const = 0;
 
+    /**
+     * Mark this capability as revoked. After this call isValid() returns false
+     * and the capability must refuse further operations.
+     * Called by CapabilityManager only.
+     */
+    virtual void invalidate() = 0;
+
   protected:
     // Only CapabilityManager can construct capabilities
     Capability() = default;
@@ -32,7 +32,10 @@
 #include <QStandardPaths>
 #include <QStorageInfo>
 #include <QTimer>
+#include <algorithm>
+#include "../diagnostics/DispatchContext.hpp"
 #include "../events/event_bus.hpp"
+#include "../location/LocationHub.hpp"
 #include "../network/websocket_server.hpp"
 #include "../ui/UIRegistrar.hpp"
 #include "AudioCapabilityImpl.hpp"
@@ -77,40 +80,140 @@ namespace core {
 // ============================================================================
 
 CapabilityManager::CapabilityManager(EventBus* event_bus, WebSocketServer* ws_server)
-    : event_bus_(event_bus), ws_server_(ws_server) {}
+    : event_bus_(event_bus),
+      ws_server_(ws_server),
+      location_hub_(std::make_unique<location::LocationHub>()) {
+    registerBuiltInFactories();
+
+    // Geofence transitions go out in the owning extension's namespace
+    QObject::connect(location_hub_->geofences(), &location::GeofenceService::fenceEvent,
+                     location_hub_.get(),
+                     [this](const QString& owner, const QString& type, const QVariantMap& event) {
+                         if (event_bus_) {
+                             event_bus_->publish(owner + QStringLiteral(".geofence.") + type,
+                                                 event);
+                         }
+                     });
+
+    // Declaring "event" keeps the historic subscription scopes unless policy denies them
+    policy_.setImplied(QStringLiteral("event"),
+                       {QStringLiteral("event.core"), QStringLiteral("event.wildcard")});
+
+    // Generous defaults that only stop runaway loops; ConfigManager may override them
+    capabilities::RateLimit network;
+    network.rate = 20;
+    network.burst = 40;
+    // Requests return their reply synchronously and usually come from the GUI thread, where
+    // acquireBlocking() cannot wait, so Delay would only ever reject; say so explicitly
+    network.policy = capabilities::RateLimitPolicy::Reject;
+    rate_limiter_.setDefaultLimit(QStringLiteral("network"), network);
+
+    capabilities::RateLimit event;
+    event.rate = 200;
+    event.burst = 400;
+    event.policy = capabilities::RateLimitPolicy::Coalesce;
+    rate_limiter_.setDefaultLimit(QStringLiteral("event"), event);
+
+    capabilities::RateLimit filesystem;
+    filesystem.rate = 50;
+    filesystem.burst = 100;
+    filesystem.policy = capabilities::RateLimitPolicy::Delay;
+    rate_limiter_.setDefaultLimit(QStringLiteral("filesystem"), filesystem);
+}
 
 CapabilityManager::~CapabilityManager() {
     // Invalidate all capabilities
     for (auto& extensionCaps : granted_capabilities_) {
         for (auto& cap : extensionCaps) {
-            if (auto locCap =
-                    std::dynamic_pointer_cast<capabilities::LocationCapabilityImpl>(cap)) {
-                locCap->invalidate();
-            } else if (auto netCap =
-                           std::dynamic_pointer_cast<capabilities::NetworkCapabilityImpl>(cap)) {
-                netCap->invalidate();
-            } else if (auto fsCap =
-                           std::dynamic_pointer_cast<capabilities::FileSystemCapabilityImpl>(cap)) {
-                fsCap->invalidate();
-            } else if (auto uiCap =
-                           std::dynamic_pointer_cast<capabilities::UICapabilityImpl>(cap)) {
-                uiCap->invalidate();
-            } else if (auto evCap =
-                           std::dynamic_pointer_cast<capabilities::EventCapabilityImpl>(cap)) {
-                evCap->invalidate();
-            } else if (auto audCap =
-                           std::dynamic_pointer_cast<capabilities::AudioCapabilityImpl>(cap)) {
-                audCap->invalidate();
-            } else if (auto tokCap =
-                           std::dynamic_pointer_cast<capabilities::TokenCapabilityImpl>(cap)) {
-                tokCap->invalidate();
-            }
+            cap->invalidate();
         }
     }
 }
 
+void CapabilityManager::registerBuiltInFactories() {
+    registerCapabilityFactory("location", [this](const QString& id, const QVariantMap& options) {
+        return createLocationCapability(id, options);
+    });
+    registerCapabilityFactory("network", [this](const QString& id, const QVariantMap& options) {
+        return createNetworkCapability(id, options);
+    });
+    registerCapabilityFactory("filesystem", [this](const QString& id, const QVariantMap& options) {
+        return createFileSystemCapability(id, options);
+    });
+    registerCapabilityFactory("ui", [this](const QString& id, const QVariantMap& options) {
+        return createUICapability(id, options);
+    });
+    registerCapabilityFactory("event", [this](const QString& id, const QVariantMap& options) {
+        return createEventCapability(id, options);
+    });
+    registerCapabilityFactory("bluetooth", [this](const QString& id, const QVariantMap& options) {
+        return createBluetoothCapability(id, options);
+    });
+    registerCapabilityFactory("wireless", [this](const QString& id, const QVariantMap& options) {
+        return createWirelessCapability(id, options);
+    });
+    registerCapabilityFactory("audio", [this](const QString& id, const QVariantMap& options) {
+        return createAudioCapability(id, options);
+    });
+
+    // Simple permission flags share the token implementation
+    for (const QString& token : {QStringLiteral("contacts"), QStringLiteral("phone")}) {
+        registerCapabilityFactory(token, [this, token](const QString& id, const QVariantMap&) {
+            return createTokenCapability(id, token);
+        });
+    }
+}
+
+bool CapabilityManager::registerCapabilityFactory(const QString& capabilityType,
+                                                  CapabilityFactory factory) {
+    QMutexLocker locker(&mutex_);
+
+    if (capabilityType.isEmpty() || !factory) {
+        qWarning() << "Ignoring invalid capability factory registration:" << capabilityType;
+        return false;
+    }
+    if (factories_.contains(capabilityType)) {
+        qWarning() << "Capability factory already registered:" << capabilityType;
+        return false;
+    }
+
+    factories_.insert(capabilityType, std::move(factory));
+    return true;
+}
+
+void CapabilityManager::unregisterCapabilityFactory(const QString& capabilityType) {
+    QMutexLocker locker(&mutex_);
+
+    if (factories_.remove(capabilityType) == 0) {
+        return;
+    }
+
+    for (const QString& extensionId : granted_capabilities_.keys()) {
+        revokeCapability(extensionId, capabilityType);
+    }
+}
+
+QStringList CapabilityManager::registeredCapabilityTypes() const {
+    QMutexLocker locker(&mutex_);
+    return factories_.keys();
+}
+
 std::shared_ptr<capabilities::Capability> CapabilityManager::grantCapability(
     const QString& extensionId, const QString& capabilityType, const QVariantMap& options) {
+    // The provider of an unknown type may be waiting for activation. The activator runs
+    // unlocked, as the provider registers its factory from another call.
+    CapabilityActivator activator;
+    {
+        QMutexLocker locker(&mutex_);
+        if (!factories_.contains(capabilityType) &&
+            shouldGrantPermission(extensionId, capabilityType, options)) {
+            activator = capability_activator_;
+        }
+    }
+    if (activator) {
+        activator(extensionId, capabilityType);
+    }
+
     QMutexLocker locker(&mutex_);
 
     // Check if permission should be granted
@@ -120,48 +223,31 @@ std::shared_ptr<capabilities::Capability> CapabilityManager::grantCapability(
     }
 
     // Check if already granted
-    if (granted_capabilities_.contains(extensionId) &&
-        granted_capabilities_[extensionId].contains(capabilityType)) {
-        return granted_capabilities_[extensionId][capabilityType];
+    auto extensionCaps = granted_capabilities_.find(extensionId);
+    if (extensionCaps != granted_capabilities_.end()) {
+        auto existing = extensionCaps->constFind(capabilityType);
+        if (existing != extensionCaps->cend()) {
+            return existing.value();
+        }
     }
 
     // Create capability
-    std::shared_ptr<capabilities::Capability> capability;
-
-    if (capabilityType == "location") {
-        capability = createLocationCapability(extensionId, options);
-    } else if (capabilityType == "network") {
-        capability = createNetworkCapability(extensionId, options);
-    } else if (capabilityType == "filesystem") {
-        capability = createFileSystemCapability(extensionId, options);
-    } else if (capabilityType == "ui") {
-        capability = createUICapability(extensionId, options);
-    } else if (capabilityType == "event") {
-        capability = createEventCapability(extensionId, options);
-    } else if (capabilityType == "bluetooth") {
-        capability = createBluetoothCapability(extensionId, options);
-    } else if (capabilityType == "wireless") {
-        capability = createWirelessCapability(extensionId, options);
-    } else if (capabilityType == "audio") {
-        capability = createAudioCapability(extensionId, options);
-    } else if (capabilityType == "contacts" || capabilityType == "phone") {
-        capability = createTokenCapability(extensionId, capabilityType);
-    } else {
+    const auto factory = factories_.constFind(capabilityType);
+    if (factory == factories_.cend()) {
         qWarning() << "Unknown capability type:" << capabilityType;
         return nullptr;
     }
 
+    std::shared_ptr<capabilities::Capability> capability = factory.value()(extensionId, options);
+
     if (capability) {
         granted_capabilities_[extensionId][capabilityType] = capability;
 
         qInfo() << "Granted capability:" << extensionId << "->" << capabilityType;
 
-        logCapabilityUsage(extensionId, capabilityType, "granted", "");
-
-        qDebug() << "Capability granted successfully, returning from grantCapability";
+        logCapabilityUsage(extensionId, capabilityType, QStringLiteral("granted"));
     }
 
-    qDebug() << "Exiting grantCapability for:" << extensionId << capabilityType;
     return capability;
 }
 
@@ -169,68 +255,37 @@ void CapabilityManager::revokeCapability(const QString& extensionId,
                                          const QString& capabilityType) {
     QMutexLocker locker(&mutex_);
 
-    if (granted_capabilities_.contains(extensionId) &&
-        granted_capabilities_[extensionId].contains(capabilityType)) {
-        auto cap = granted_capabilities_[extensionId][capabilityType];
-
-        // Invalidate capability
-        if (auto locCap = std::dynamic_pointer_cast<capabilities::LocationCapabilityImpl>(cap)) {
-            locCap->invalidate();
-        } else if (auto netCap =
-                       std::dynamic_pointer_cast<capabilities::NetworkCapabilityImpl>(cap)) {
-            netCap->invalidate();
-        } else if (auto fsCap =
-                       std::dynamic_pointer_cast<capabilities::FileSystemCapabilityImpl>(cap)) {
-            fsCap->invalidate();
-        } else if (auto uiCap = std::dynamic_pointer_cast<capabilities::UICapabilityImpl>(cap)) {
-            uiCap->invalidate();
-        } else if (auto evCap = std::dynamic_pointer_cast<capabilities::EventCapabilityImpl>(cap)) {
-            evCap->invalidate();
-        } else if (auto audCap =
-                       std::dynamic_pointer_cast<capabilities::AudioCapabilityImpl>(cap)) {
-            audCap->invalidate();
-        } else if (auto tokCap =
-                       std::dynamic_pointer_cast<capabilities::TokenCapabilityImpl>(cap)) {
-            tokCap->invalidate();
-        }
+    auto extensionCaps = granted_capabilities_.find(extensionId);
+    if (extensionCaps == granted_capabilities_.end()) {
+        return;
+    }
+    auto cap = extensionCaps->take(capabilityType);
+    if (!cap) {
+        return;
+    }
 
-        granted_capabilities_[extensionId].remove(capabilityType);
+    cap->invalidate();
+    if (revocation_listener_) {
+        revocation_listener_(extensionId, capabilityType);
+    }
 
-        logCapabilityUsage(extensionId, capabilityType, "revoked", "");
+    logCapabilityUsage(extensionId, capabilityType, QStringLiteral("revoked"));
 
-        qInfo() << "Revoked capability:" << extensionId << "->" << capabilityType;
-    }
+    qInfo() << "Revoked capability:" << extensionId << "->" << capabilityType;
 }
 
 void CapabilityManager::revokeAllCapabilities(const QString& extensionId) {
     QMutexLocker locker(&mutex_);
 
     if (granted_capabilities_.contains(extensionId)) {
-        for (const QString& capType : granted_capabilities_[extensionId].keys()) {
-            auto cap = granted_capabilities_[extensionId][capType];
-
-            // Invalidate
-            if (auto locCap =
-                    std::dynamic_pointer_cast<capabilities::LocationCapabilityImpl>(cap)) {
-                locCap->invalidate();
-            } else if (auto netCap =
-                           std::dynamic_pointer_cast<capabilities::NetworkCapabilityImpl>(cap)) {
-                netCap->invalidate();
-            } else if (auto fsCap =
-                           std::dynamic_pointer_cast<capabilities::FileSystemCapabilityImpl>(cap)) {
-                fsCap->invalidate();
-            } else if (auto uiCap =
-                           std::dynamic_pointer_cast<capabilities::UICapabilityImpl>(cap)) {
-                uiCap->invalidate();
-            } else if (auto evCap =
-                           std::dynamic_pointer_cast<capabilities::EventCapabilityImpl>(cap)) {
-                evCap->invalidate();
-            }
+        for (const auto& cap : granted_capabilities_.take(extensionId)) {
+            cap->invalidate();
+        }
+        if (revocation_listener_) {
+            revocation_listener_(extensionId, QString());
         }
 
-        granted_capabilities_.remove(extensionId);
-
-        logCapabilityUsage(extensionId, "all", "revoked_all", "");
+        logCapabilityUsage(extensionId, QStringLiteral("all"), QStringLiteral("revoked_all"));
 
         qInfo() << "Revoked all capabilities for:" << extensionId;
     }
@@ -259,64 +314,226 @@ std::shared_ptr<capabilities::LocationCapability> CapabilityManager::getLocation
 void CapabilityManager::logCapabilityUsage(const QString& extensionId,
                                            const QString& capabilityType, const QString& action,
                                            const QString& details) {
-    QMutexLocker locker(&mutex_);
+    audit_log_.append(extensionId, capabilityType, action, details);
+    diagnostics::DispatchContext::recordCapabilityCall(extensionId, capabilityType, action);
+}
 
-    AuditLogEntry entry;
-    entry.timestamp = QDateTime::currentMSecsSinceEpoch();
-    entry.extension_id = extensionId;
-    entry.capability_type = capabilityType;
-    entry.action = action;
-    entry.details = details;
+QList<QVariantMap> CapabilityManager::getAuditLog(const QString& extensionId, int limit) const {
+    return audit_log_.entries(extensionId, limit);
+}
 
-    audit_log_.append(entry);
+bool CapabilityManager::enableAuditPersistence(const QString& directory) {
+    QMutexLocker locker(&mutex_);
+    if (audit_store_) {
+        return audit_store_->directory() == directory;
+    }
 
-    // Keep log size reasonable (last 10000 entries)
-    if (audit_log_.size() > 10000) {
-        audit_log_.removeFirst();
+    auto store = std::make_unique<capabilities::AuditStore>(&audit_log_, directory);
+    if (!store->open()) {
+        qWarning() << "Audit persistence disabled; could not open" << directory;
+        return false;
     }
+    audit_store_ = std::move(store);
+    return true;
 }
 
-QList<QVariantMap> CapabilityManager::getAuditLog(const QString& extensionId, int limit) const {
-    QMutexLocker locker(&mutex_);
+void CapabilityManager::flushAuditLog() {
+    if (audit_store_) {
+        audit_store_->flush();
+    }
+}
 
-    QList<QVariantMap> result;
+quint64 CapabilityManager::collectAuditLog(quint64 fromSequence,
+                                           QList<capabilities::AuditEntry>* out) const {
+    return audit_log_.collectSince(fromSequence, out);
+}
 
-    for (int i = audit_log_.size() - 1; i >= 0 && (limit == 0 || result.size() < limit); --i) {
-        const auto& entry = audit_log_[i];
+capabilities::AuditQueryResult CapabilityManager::queryAuditLog(
+    const capabilities::AuditQuery& query) const {
+    if (audit_store_) {
+        audit_store_->flush();
+        return audit_store_->query(query);
+    }
 
-        if (!extensionId.isEmpty() && entry.extension_id != extensionId) {
+    // In-memory fallback: same filters over the records the ring buffer still holds
+    QList<capabilities::AuditEntry> entries;
+    audit_log_.collectSince(0, &entries);
+
+    capabilities::AuditQueryResult result;
+    const int limit = query.limit > 0 ? query.limit : int(entries.size());
+    for (auto it = entries.crbegin(); it != entries.crend(); ++it) {
+        if (it->sequence >= query.before || it->timestamp_ms < query.from_ms ||
+            it->timestamp_ms > query.to_ms ||
+            (!query.extension_id.isEmpty() && it->extension_id != query.extension_id) ||
+            (!query.capability_type.isEmpty() && it->capability_type != query.capability_type) ||
+            (!query.action.isEmpty() && it->action != query.action)) {
             continue;
         }
-
-        QVariantMap map;
-        map["timestamp"] = entry.timestamp;
-        map["extension_id"] = entry.extension_id;
-        map["capability_type"] = entry.capability_type;
-        map["action"] = entry.action;
-        map["details"] = entry.details;
-
-        result.append(map);
+        if (result.entries.size() == limit) {
+            result.has_more = true;
+            break;
+        }
+        result.entries.append(*it);
+        result.next_cursor = it->sequence;
     }
-
     return result;
 }
 
 bool CapabilityManager::shouldGrantPermission(const QString& extensionId,
                                               const QString& capabilityType,
                                               const QVariantMap& options) const {
-    // TODO: Check against manifest permissions
-    // For now, grant all permissions (development mode)
-    return true;
+    Q_UNUSED(options);
+    return hasPermission(extensionId, capabilityType);
+}
+
+void CapabilityManager::setExtensionPermissions(const QString& extensionId,
+                                                const QStringList& permissions) {
+    QMutexLocker locker(&mutex_);
+    declared_permissions_.insert(extensionId, permissions);
+    recompilePermissions(extensionId);
+    qDebug() << "Permissions for" << extensionId << ":" << effectivePermissions(extensionId);
+}
+
+void CapabilityManager::clearExtensionPermissions(const QString& extensionId) {
+    QMutexLocker locker(&mutex_);
+    revokeAllCapabilities(extensionId);
+    declared_permissions_.remove(extensionId);
+    permission_sets_.remove(extensionId);
+    publishPermissions();
+}
+
+void CapabilityManager::setPolicyOverride(const QString& extensionId, const QStringList& allow,
+                                          const QStringList& deny) {
+    QMutexLocker locker(&mutex_);
+    policy_.setOverride(extensionId, allow, deny);
+
+    if (extensionId == QLatin1String(capabilities::PermissionPolicy::kAllExtensions)) {
+        for (const QString& id : declared_permissions_.keys()) {
+            recompilePermissions(id);
+        }
+    } else if (declared_permissions_.contains(extensionId)) {
+        recompilePermissions(extensionId);
+    }
+}
+
+void CapabilityManager::recompilePermissions(const QString& extensionId) {
+    const auto previous = permission_sets_.value(extensionId);
+    const auto current = policy_.compile(extensionId, declared_permissions_.value(extensionId));
+    permission_sets_.insert(extensionId, current);
+    // Published before revoking, so revocation listeners see the new permissions
+    publishPermissions();
+
+    const auto lost = previous & ~current;
+    if (lost.none()) {
+        return;
+    }
+
+    // Only capabilities backed by a withdrawn permission are revoked
+    const QStringList lostNames = policy_.names(lost);
+    for (const QString& type : granted_capabilities_.value(extensionId).keys()) {
+        const bool affected =
+            std::any_of(lostNames.cbegin(), lostNames.cend(), [&type](const QString& name) {
+                return capabilities::PermissionPolicy::isScopedTo(name, type);
+            });
+        if (affected) {
+            qInfo() << "Policy change revokes" << type << "from" << extensionId;
+            revokeCapability(extensionId, type);
+        }
+    }
+}
+
+void CapabilityManager::publishPermissions() {
+    auto snapshot = std::make_shared<PermissionSnapshot>();
+    snapshot->bits = policy_.bits();
+    snapshot->sets = permission_sets_;
+    std::atomic_store_explicit(&permission_snapshot_,
+                               std::shared_ptr<const PermissionSnapshot>(std::move(snapshot)),
+                               std::memory_order_release);
+}
+
+void CapabilityManager::setRateLimits(const QString& extensionId, const QVariantMap& limits) {
+    QHash<QString, capabilities::RateLimit> parsed;
+    for (auto it = limits.cbegin(); it != limits.cend(); ++it) {
+        parsed.insert(it.key(), capabilities::RateLimit::fromMap(it.value().toMap()));
+    }
+    rate_limiter_.setExtensionLimits(extensionId, parsed);
+}
+
+void CapabilityManager::setDefaultRateLimit(const QString& capabilityType,
+                                            const capabilities::RateLimit& limit) {
+    rate_limiter_.setDefaultLimit(capabilityType, limit);
+}
+
+capabilities::RateLimit CapabilityManager::defaultRateLimit(const QString& capabilityType) const {
+    return rate_limiter_.defaultLimit(capabilityType);
+}
+
+QVariantMap CapabilityManager::getRateLimitUsage(const QString& extensionId) const {
+    return rate_limiter_.usage(extensionId);
+}
+
+std::shared_ptr<capabilities::ResourceUsage> CapabilityManager::resourceUsage(
+    const QString& extensionId) {
+    return resource_accounting_.usage(extensionId);
+}
+
+QVariantList CapabilityManager::getResourceUsage() const {
+    return resource_accounting_.snapshot();
+}
+
+void CapabilityManager::enableResourceSnapshots(int intervalMs) {
+    if (intervalMs <= 0) {
+        resource_snapshot_timer_.reset();
+        return;
+    }
+    if (!resource_snapshot_timer_) {
+        resource_snapshot_timer_ = std::make_unique<QTimer>();
+        QTimer* timer = resource_snapshot_timer_.get();
+        QObject::connect(timer, &QTimer::timeout, timer, [this, timer]() {
+            if (!event_bus_) {
+                return;
+            }
+            QVariantMap snapshot;
+            snapshot["timestamp"] = QDateTime::currentMSecsSinceEpoch();
+            snapshot["interval_ms"] = timer->interval();
+            snapshot["extensions"] = getResourceUsage();
+            event_bus_->publish(QStringLiteral("core.diagnostics.resources"), snapshot);
+        });
+    }
+    resource_snapshot_timer_->start(intervalMs);
+}
+
+bool CapabilityManager::hasPermission(const QString& extensionId,
+                                      const QString& permission) const {
+    const auto snapshot =
+        std::atomic_load_explicit(&permission_snapshot_, std::memory_order_acquire);
+    if (!snapshot) {
+        return false;
+    }
+    const int bit = snapshot->bits.value(permission, -1);
+    if (bit < 0) {
+        return false;
+    }
+    const auto set = snapshot->sets.constFind(extensionId);
+    return set != snapshot->sets.cend() && set->test(size_t(bit));
+}
+
+QStringList CapabilityManager::effectivePermissions(const QString& extensionId) const {
+    QMutexLocker locker(&mutex_);
+    return policy_.names(permission_sets_.value(extensionId));
 }
 
 std::shared_ptr<capabilities::LocationCapability> CapabilityManager::createLocationCapability(
     const QString& extensionId, const QVariantMap& options) {
-    return capabilities::createLocationCapabilityInstance(extensionId, this);
+    return capabilities::createLocationCapabilityInstance(extensionId, this,
+                                                           location_hub_.get());
 }
 
 std::shared_ptr<capabilities::NetworkCapability> CapabilityManager::createNetworkCapability(
     const QString& extensionId, const QVariantMap& options) {
-    return capabilities::createNetworkCapabilityInstance(extensionId, this);
+    return capabilities::createNetworkCapabilityInstance(
+        extensionId, this, rate_limiter_.bucket(extensionId, QStringLiteral("network")),
+        resource_accounting_.usage(extensionId));
 }
 
 std::shared_ptr<capabilities::FileSystemCapability> CapabilityManager::createFileSystemCapability(
@@ -330,7 +547,10 @@ std::shared_ptr<capabilities::FileSystemCapability> CapabilityManager::createFil
                     "/extensions/" + extensionId;
     }
 
-    return capabilities::createFileSystemCapabilityInstance(extensionId, this, scopePath);
+    return capabilities::createFileSystemCapabilityInstance(
+        extensionId, this, scopePath,
+        rate_limiter_.bucket(extensionId, QStringLiteral("filesystem")),
+        resource_accounting_.usage(extensionId));
 }
 
 std::shared_ptr<capabilities::UICapability> CapabilityManager::createUICapability(
@@ -340,7 +560,18 @@ std::shared_ptr<capabilities::UICapability> CapabilityManager::createUICapabilit
 
 std::shared_ptr<capabilities::EventCapability> CapabilityManager::createEventCapability(
     const QString& extensionId, const QVariantMap& options) {
-    return capabilities::createEventCapabilityInstance(extensionId, this, event_bus_);
+    // Scopes are fixed for the capability's lifetime; losing one revokes the capability
+    quint8 scopes = capabilities::EventCapabilityImpl::kOwnEvents;
+    if (hasPermission(extensionId, QStringLiteral("event.core"))) {
+        scopes |= capabilities::EventCapabilityImpl::kCoreEvents;
+    }
+    if (hasPermission(extensionId, QStringLiteral("event.wildcard"))) {
+        scopes |= capabilities::EventCapabilityImpl::kWildcardEvents;
+    }
+    return capabilities::createEventCapabilityInstance(
+        extensionId, this, event_bus_, scopes,
+        rate_limiter_.bucket(extensionId, QStringLiteral("event")),
+        resource_accounting_.usage(extensionId));
 }
 
 std::shared_ptr<capabilities::Capability> CapabilityManager::createBluetoothCapability(
@@ -380,5 +611,15 @@ void CapabilityManager::setUIRegistrar(ui::UIRegistrar* registrar) {
     ui_registrar_ = registrar;
 }
 
+void CapabilityManager::setCapabilityActivator(CapabilityActivator activator) {
+    QMutexLocker locker(&mutex_);
+    capability_activator_ = std::move(activator);
+}
+
+void CapabilityManager::setRevocationListener(RevocationListener listener) {
+    QMutexLocker locker(&mutex_);
+    revocation_listener_ = std::move(listener);
+}
+
 }  // namespace core
 }  // namespace opencardev::crankshaft
@@ -19,23 +19,33 @@
 
 #pragma once
 
+#include <QHash>
 #include <QMap>
 #include <QMutex>
 #include <QMutexLocker>
 #include <QString>
+#include <QStringList>
 #include <QVariantMap>
+#include <functional>
 #include <memory>
+#include "AuditLog.hpp"
 #include "AudioCapability.hpp"
+#include "AuditStore.hpp"
 #include "BluetoothCapability.hpp"
 #include "Capability.hpp"
 #include "EventCapability.hpp"
 #include "FileSystemCapability.hpp"
 #include "LocationCapability.hpp"
 #include "NetworkCapability.hpp"
+#include "PermissionPolicy.hpp"
+#include "RateLimiter.hpp"
+#include "ResourceAccounting.hpp"
 #include "UICapability.hpp"
 #include "VideoCapability.hpp"
 #include "WirelessCapability.hpp"
 
+class QTimer;
+
 namespace opencardev::crankshaft {
 namespace core {
 
@@ -45,6 +55,9 @@ class WebSocketServer;
 namespace ui {
 class UIRegistrar;
 }
+namespace location {
+class LocationHub;
+}
 
 /**
  * CapabilityManager grants, revokes, and audits capabilities for extensions.
@@ -59,9 +72,111 @@ class UIRegistrar;
  */
 class CapabilityManager {
   public:
+    /**
+     * Creates a capability instance for an extension.
+     * Receives the options passed to grantCapability(); returns nullptr on failure.
+     */
+    using CapabilityFactory = std::function<std::shared_ptr<capabilities::Capability>(
+        const QString& extensionId, const QVariantMap& options)>;
+
+    /**
+     * Called by grantCapability() for a type with no factory yet, before the request is
+     * refused, so a deferred extension providing that type can be activated first.
+     */
+    using CapabilityActivator =
+        std::function<void(const QString& requesterId, const QString& capabilityType)>;
+
+    /**
+     * Called once a capability has been revoked, with the manager locked, so whoever
+     * handed it to the extension can drop it. capabilityType is empty when all of the
+     * extension's capabilities were revoked.
+     */
+    using RevocationListener =
+        std::function<void(const QString& extensionId, const QString& capabilityType)>;
+
     explicit CapabilityManager(EventBus* event_bus, WebSocketServer* ws_server);
     ~CapabilityManager();
 
+    /**
+     * Register a factory for a capability type.
+     * Built-in types are registered on construction; plugins may add their own.
+     *
+     * @param capabilityType Type name requested through grantCapability()
+     * @param factory Factory creating the capability
+     * @return false if the type is already registered or the factory is empty
+     */
+    bool registerCapabilityFactory(const QString& capabilityType, CapabilityFactory factory);
+
+    /**
+     * Remove a capability factory. Capabilities of this type that are still
+     * granted are revoked, as the code backing them may be about to unload.
+     *
+     * @param capabilityType Type to remove
+     */
+    void unregisterCapabilityFactory(const QString& capabilityType);
+
+    // Capability types that can currently be granted
+    QStringList registeredCapabilityTypes() const;
+
+    /**
+     * Compile an extension's manifest permissions, with system policy overrides, into
+     * its permission set. Must be called before capabilities are granted; extensions
+     * without a permission set are denied everything.
+     *
+     * @param extensionId Extension being loaded
+     * @param permissions requirements.required_permissions from the manifest
+     */
+    void setExtensionPermissions(const QString& extensionId, const QStringList& permissions);
+
+    // Drop an extension's permission set and revoke everything it holds
+    void clearExtensionPermissions(const QString& extensionId);
+
+    /**
+     * Replace the system policy override for an extension ("*" for all). Affected
+     * permission sets are recompiled and capabilities that lost a permission they
+     * depend on are revoked.
+     *
+     * @param allow Permissions granted even if the manifest does not declare them
+     * @param deny Permissions withheld even if the manifest declares them
+     */
+    void setPolicyOverride(const QString& extensionId, const QStringList& allow,
+                           const QStringList& deny);
+
+    // Single bit test against the compiled permission set, without the manager's lock
+    bool hasPermission(const QString& extensionId, const QString& permission) const;
+
+    // Compiled permission names, for diagnostics
+    QStringList effectivePermissions(const QString& extensionId) const;
+
+    /**
+     * Apply an extension's declared rate limits (requirements.rate_limits in the
+     * manifest): capability type -> { rate, burst, policy, max_delay_ms }.
+     * Declared limits can only tighten the system defaults.
+     */
+    void setRateLimits(const QString& extensionId, const QVariantMap& limits);
+
+    // System-wide limit for a capability type, applied to every extension
+    void setDefaultRateLimit(const QString& capabilityType, const capabilities::RateLimit& limit);
+    capabilities::RateLimit defaultRateLimit(const QString& capabilityType) const;
+
+    // Capability type -> { limit, allowed, rejected, delayed, coalesced } for an extension
+    QVariantMap getRateLimitUsage(const QString& extensionId) const;
+
+    /**
+     * Resource counters for an extension, created on first use. Capabilities charge
+     * their I/O and event volume here; hold a ResourceScope on it to charge time.
+     */
+    std::shared_ptr<capabilities::ResourceUsage> resourceUsage(const QString& extensionId);
+
+    // One { id, wall_ms, cpu_ms, calls, net/fs bytes, events } map per extension
+    QVariantList getResourceUsage() const;
+
+    /**
+     * Publish getResourceUsage() as "core.diagnostics.resources" every intervalMs:
+     * { timestamp, interval_ms, extensions }. An interval <= 0 stops publishing.
+     */
+    void enableResourceSnapshots(int intervalMs);
+
     /**
      * Grant a capability to an extension.
      * Checks manifest permissions and creates appropriate capability.
@@ -107,6 +222,8 @@ class CapabilityManager {
 
     /**
      * Log capability usage for security audit.
+     * Allocation-free, and lock-free off the main thread (which also records the call for
+     * stall blame); safe to call on hot paths from any thread.
      *
      * @param extensionId Extension using capability
      * @param capabilityType Type of capability
@@ -125,6 +242,36 @@ class CapabilityManager {
      */
     QList<QVariantMap> getAuditLog(const QString& extensionId = QString(), int limit = 100) const;
 
+    /**
+     * Persist the audit trail to indexed segment files in a directory.
+     * Records are written in the background every few seconds.
+     *
+     * @param directory Directory for audit segments (created if missing)
+     * @return false if the store could not be opened; auditing stays in memory only
+     */
+    bool enableAuditPersistence(const QString& directory);
+
+    // Persistent audit store, or nullptr when persistence is disabled
+    capabilities::AuditStore* auditStore() const { return audit_store_.get(); }
+
+    /**
+     * Query the audit trail by extension, capability, action and time range.
+     * Searches the persistent store when enabled (flushing pending records first),
+     * otherwise the records still held in memory.
+     */
+    capabilities::AuditQueryResult queryAuditLog(const capabilities::AuditQuery& query) const;
+
+    // Write pending audit records to the persistent store now
+    void flushAuditLog();
+
+    /**
+     * Oldest-first copy of the audit records from fromSequence onwards, for forwarding
+     * them to another process's log (see AuditLog::collectSince()).
+     *
+     * @return Sequence to resume from on the next call
+     */
+    quint64 collectAuditLog(quint64 fromSequence, QList<capabilities::AuditEntry>* out) const;
+
     /**
      * Check if a permission should be granted based on manifest.
      * Override this to implement custom permission logic.
@@ -141,7 +288,23 @@ class CapabilityManager {
     void setUIRegistrar(ui::UIRegistrar* registrar);
     ui::UIRegistrar* uiRegistrar() const { return ui_registrar_; }
 
+    EventBus* eventBus() const { return event_bus_; }
+
+    // Position source shared by every location capability
+    location::LocationHub* locationHub() const { return location_hub_.get(); }
+
+    // Hook for activating capability providers on demand; pass {} to remove
+    void setCapabilityActivator(CapabilityActivator activator);
+
+    // Hook notified of revocations; pass {} to remove
+    void setRevocationListener(RevocationListener listener);
+
   private:
+    void registerBuiltInFactories();
+    void recompilePermissions(const QString& extensionId);
+    // Publish the compiled permission sets for hasPermission(); called with mutex_ held
+    void publishPermissions();
+
     // Factory methods for creating concrete capability implementations
     std::shared_ptr<capabilities::LocationCapability> createLocationCapability(
         const QString& extensionId, const QVariantMap& options);
@@ -174,20 +337,42 @@ class CapabilityManager {
     EventBus* event_bus_;
     WebSocketServer* ws_server_;
 
+    // Capability factories keyed by type name
+    QHash<QString, CapabilityFactory> factories_;
+    CapabilityActivator capability_activator_;
+    RevocationListener revocation_listener_;
+
+    // Permission names to bits, and each loaded extension's compiled set
+    capabilities::PermissionPolicy policy_;
+    QHash<QString, QStringList> declared_permissions_;
+    QHash<QString, capabilities::PermissionPolicy::PermissionSet> permission_sets_;
+    // Immutable copy of the above, swapped atomically whenever they change, so permission
+    // checks never wait for a grant or revocation in progress
+    struct PermissionSnapshot {
+        QHash<QString, int> bits;
+        QHash<QString, capabilities::PermissionPolicy::PermissionSet> sets;
+    };
+    std::shared_ptr<const PermissionSnapshot> permission_snapshot_;
+
+    // Token buckets per extension and capability; internally synchronised
+    capabilities::RateLimiter rate_limiter_;
+
+    // Per-extension time, I/O and event counters; internally synchronised
+    capabilities::ResourceAccounting resource_accounting_;
+    std::unique_ptr<QTimer> resource_snapshot_timer_;
+
+    // Declared before granted_capabilities_ so location capabilities detach from it first
+    std::unique_ptr<location::LocationHub> location_hub_;
+
     // Granted capabilities: extensionId -> (capabilityType -> capability)
     QMap<QString, QMap<QString, std::shared_ptr<capabilities::Capability>>> granted_capabilities_;
 
-    // Audit log: list of usage events
-    struct AuditLogEntry {
-        qint64 timestamp;
-        QString extension_id;
-        QString capability_type;
-        QString action;
-        QString details;
-    };
-    QList<AuditLogEntry> audit_log_;
+    // Audit log of usage events; has its own lock-free synchronisation
+    capabilities::AuditLog audit_log_;
+    // Declared after audit_log_ so it drains the log before the log is destroyed
+    std::unique_ptr<capabilities::AuditStore> audit_store_;
 
-    // Thread safety
+    // Thread safety (grants, permissions, factories and registrar; not the audit log)
     mutable QRecursiveMutex mutex_;
 
     // Non-owned pointer to UI registrar (implemented in UI module)
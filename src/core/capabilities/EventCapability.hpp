@@ -45,6 +45,8 @@ class EventCapability : public Capability {
     ~EventCapability() override = default;
 
     QString id() const override { return "event"; }
+    static constexpr CapabilitySlot kSlot = CapabilitySlot::Event;
+    CapabilitySlot slot() const final { return kSlot; }
 
     /**
      * Emit an event to the event bus.
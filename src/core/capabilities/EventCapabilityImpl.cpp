@@ -18,20 +18,31 @@
  */
 #include "EventCapabilityImpl.hpp"
 #include <QDebug>
+#include <QMutexLocker>
+#include <QTimer>
+#include <algorithm>
+#include "../diagnostics/DispatchContext.hpp"
 #include "../events/event_bus.hpp"
 #include "CapabilityManager.hpp"
 
 using namespace opencardev::crankshaft::core::capabilities;
 using opencardev::crankshaft::core::CapabilityManager;
 using opencardev::crankshaft::core::EventBus;
+using opencardev::crankshaft::core::diagnostics::DispatchScope;
 
 EventCapabilityImpl::EventCapabilityImpl(const QString& extension_id, CapabilityManager* manager,
-                                         EventBus* event_bus)
+                                         EventBus* event_bus, quint8 scopes,
+                                         std::shared_ptr<RateLimitBucket> rate_limit,
+                                         std::shared_ptr<ResourceUsage> usage)
     : extension_id_(extension_id),
       manager_(manager),
       event_bus_(event_bus),
       is_valid_(true),
-      next_subscription_id_(1) {}
+      scopes_(scopes),
+      next_subscription_id_(1),
+      rate_limit_(std::move(rate_limit)),
+      pending_(std::make_shared<PendingEvents>()),
+      usage_(std::move(usage)) {}
 
 QString EventCapabilityImpl::extensionId() const {
     return extension_id_;
@@ -41,8 +52,18 @@ bool EventCapabilityImpl::isValid() const {
 }
 void EventCapabilityImpl::invalidate() {
     is_valid_ = false;
-    for (auto subId : subscriptions_.keys()) {
-        event_bus_->unsubscribe(subId);
+    {
+        // Drop deferred events, whose payloads may reference a plugin's static data; timers
+        // already queued see alive == false
+        QMutexLocker locker(&pending_->mutex);
+        pending_->alive = false;
+        pending_->order.clear();
+        pending_->latest.clear();
+        pending_->delayed.clear();
+    }
+    // The bus holds the callbacks; none may outlive an unloaded plugin
+    for (int busId : subscriptions_.values()) {
+        event_bus_->unsubscribe(busId);
     }
     subscriptions_.clear();
 }
@@ -51,11 +72,104 @@ bool EventCapabilityImpl::emitEvent(const QString& eventName, const QVariantMap&
     if (!is_valid_ || !event_bus_)
         return false;
     QString fullEventName = extension_id_ + "." + eventName;
-    manager_->logCapabilityUsage(extension_id_, "event", "emit", fullEventName);
-    event_bus_->publish(fullEventName, eventData);
+
+    RateLimitBucket::Verdict verdict;
+    if (rate_limit_) {
+        verdict =
+            rate_limit_->acquire(RateLimitBucket::kCanWait | RateLimitBucket::kCanCoalesce);
+    }
+
+    switch (verdict.decision) {
+        case RateLimitBucket::Decision::Allow:
+            break;
+        case RateLimitBucket::Decision::Reject:
+            manager_->logCapabilityUsage(extension_id_, QStringLiteral("event"),
+                                         QStringLiteral("rate_limited"), fullEventName);
+            return false;
+        case RateLimitBucket::Decision::Delay: {
+            // The token is already reserved; publish when it falls due. The event is held in
+            // pending_ rather than the timer, so invalidate() can release it
+            quint64 delayedId = 0;
+            {
+                QMutexLocker locker(&pending_->mutex);
+                delayedId = pending_->next_delayed_id++;
+                pending_->delayed.insert(delayedId, {fullEventName, eventData});
+            }
+            auto pending = pending_;
+            EventBus* bus = event_bus_;
+            QTimer::singleShot(verdict.delay_ms, bus, [pending, bus, delayedId]() {
+                QPair<QString, QVariantMap> event;
+                {
+                    QMutexLocker locker(&pending->mutex);
+                    if (!pending->alive || !pending->delayed.contains(delayedId)) {
+                        return;
+                    }
+                    event = pending->delayed.take(delayedId);
+                }
+                bus->publish(event.first, event.second);
+            });
+            break;
+        }
+        case RateLimitBucket::Decision::Coalesce: {
+            QMutexLocker locker(&pending_->mutex);
+            if (!pending_->latest.contains(fullEventName)) {
+                pending_->order.append(fullEventName);
+            }
+            pending_->latest.insert(fullEventName, eventData);
+            if (!pending_->drain_scheduled) {
+                pending_->drain_scheduled = true;
+                locker.unlock();
+                scheduleDrain(pending_, rate_limit_, event_bus_, verdict.delay_ms);
+            }
+            if (usage_) {
+                usage_->addEventEmitted();
+            }
+            return true;
+        }
+    }
+
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("event"), QStringLiteral("emit"),
+                                 fullEventName);
+    if (usage_) {
+        usage_->addEventEmitted();
+    }
+    if (verdict.decision == RateLimitBucket::Decision::Allow) {
+        event_bus_->publish(fullEventName, eventData);
+    }
     return true;
 }
 
+void EventCapabilityImpl::scheduleDrain(std::shared_ptr<PendingEvents> pending,
+                                        std::shared_ptr<RateLimitBucket> bucket, EventBus* bus,
+                                        int delayMs) {
+    QTimer::singleShot(std::max(delayMs, 1), bus, [pending, bucket, bus]() {
+        QList<QPair<QString, QVariantMap>> ready;
+        int retryMs = -1;
+        {
+            QMutexLocker locker(&pending->mutex);
+            if (!pending->alive) {
+                return;
+            }
+            while (!pending->order.isEmpty() && bucket->tryAcquire()) {
+                const QString name = pending->order.takeFirst();
+                ready.append({name, pending->latest.take(name)});
+            }
+            if (pending->order.isEmpty()) {
+                pending->drain_scheduled = false;
+            } else {
+                retryMs = bucket->msUntilAvailable();
+            }
+        }
+
+        for (const auto& event : ready) {
+            bus->publish(event.first, event.second);
+        }
+        if (retryMs >= 0) {
+            scheduleDrain(pending, bucket, bus, retryMs);
+        }
+    });
+}
+
 int EventCapabilityImpl::subscribe(const QString& eventPattern,
                                    std::function<void(const QVariantMap&)> callback) {
     if (!is_valid_ || !event_bus_)
@@ -65,9 +179,20 @@ int EventCapabilityImpl::subscribe(const QString& eventPattern,
         return -1;
     }
     int localId = next_subscription_id_++;
-    int busId = event_bus_->subscribe(eventPattern, callback);
+    if (usage_) {
+        // Charge delivery, and the time the callback takes, to this extension
+        callback = [usage = usage_, id = extension_id_, pattern = eventPattern,
+                    inner = std::move(callback)](const QVariantMap& data) {
+            DispatchScope dispatch(id, QStringLiteral("event callback"), pattern);
+            ResourceScope scope(usage.get());
+            usage->addEventReceived();
+            inner(data);
+        };
+    }
+    int busId = event_bus_->subscribe(eventPattern, std::move(callback));
     subscriptions_[localId] = busId;
-    manager_->logCapabilityUsage(extension_id_, "event", "subscribe", eventPattern);
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("event"),
+                                 QStringLiteral("subscribe"), eventPattern);
     return localId;
 }
 
@@ -77,7 +202,8 @@ void EventCapabilityImpl::unsubscribe(int subscriptionId) {
     if (subscriptions_.contains(subscriptionId)) {
         event_bus_->unsubscribe(subscriptions_[subscriptionId]);
         subscriptions_.remove(subscriptionId);
-        manager_->logCapabilityUsage(extension_id_, "event", "unsubscribe",
+        manager_->logCapabilityUsage(extension_id_, QStringLiteral("event"),
+                                     QStringLiteral("unsubscribe"),
                                      QString::number(subscriptionId));
     }
 }
@@ -90,8 +216,8 @@ bool EventCapabilityImpl::canSubscribe(const QString& eventPattern) const {
     if (eventPattern.startsWith(extension_id_ + "."))
         return true;
     if (eventPattern.startsWith("core."))
-        return true;
+        return (scopes_ & kCoreEvents) != 0;
     if (eventPattern == "*" || eventPattern.startsWith("*."))
-        return true;
+        return (scopes_ & kWildcardEvents) != 0;
     return false;
 }
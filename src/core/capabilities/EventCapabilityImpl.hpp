@@ -18,8 +18,15 @@
  */
 #pragma once
 
+#include <QHash>
 #include <QMap>
+#include <QMutex>
+#include <QPair>
+#include <QStringList>
+#include <memory>
 #include "EventCapability.hpp"
+#include "RateLimiter.hpp"
+#include "ResourceAccounting.hpp"
 
 namespace opencardev::crankshaft::core {
 class CapabilityManager;
@@ -30,11 +37,20 @@ namespace opencardev::crankshaft::core::capabilities {
 
 class EventCapabilityImpl : public EventCapability {
   public:
+    // Subscription scopes, compiled from the extension's "event.*" permissions
+    enum Scope : quint8 {
+        kOwnEvents = 0,  // Always allowed
+        kCoreEvents = 1 << 0,
+        kWildcardEvents = 1 << 1,
+    };
+
     EventCapabilityImpl(const QString& extension_id, core::CapabilityManager* manager,
-                        core::EventBus* event_bus);
+                        core::EventBus* event_bus, quint8 scopes,
+                        std::shared_ptr<RateLimitBucket> rate_limit,
+                        std::shared_ptr<ResourceUsage> usage);
     QString extensionId() const override;
     bool isValid() const override;
-    void invalidate();
+    void invalidate() override;
     bool emitEvent(const QString& eventName, const QVariantMap& eventData) override;
     int subscribe(const QString& eventPattern,
                   std::function<void(const QVariantMap&)> callback) override;
@@ -43,19 +59,40 @@ class EventCapabilityImpl : public EventCapability {
     bool canSubscribe(const QString& eventPattern) const override;
 
   private:
+    // Events held back by a Coalesce policy; only the latest payload per name survives.
+    // Delayed events wait in delayed until their timer publishes them
+    struct PendingEvents {
+        QMutex mutex;
+        QStringList order;
+        QHash<QString, QVariantMap> latest;
+        QHash<quint64, QPair<QString, QVariantMap>> delayed;
+        quint64 next_delayed_id = 0;
+        bool alive = true;
+        bool drain_scheduled = false;
+    };
+
+    // Publish pending events as tokens become available; outlives the capability safely
+    static void scheduleDrain(std::shared_ptr<PendingEvents> pending,
+                              std::shared_ptr<RateLimitBucket> bucket, core::EventBus* bus,
+                              int delayMs);
+
     QString extension_id_;
     core::CapabilityManager* manager_;
     core::EventBus* event_bus_;
     bool is_valid_;
+    quint8 scopes_;
     QMap<int, int> subscriptions_;  // local ID -> bus ID
     int next_subscription_id_;
+    std::shared_ptr<RateLimitBucket> rate_limit_;
+    std::shared_ptr<PendingEvents> pending_;
+    std::shared_ptr<ResourceUsage> usage_;
 };
 
-inline std::shared_ptr<EventCapability> createEventCapabilityInstance(const QString& extensionId,
-                                                                      core::CapabilityManager* mgr,
-                                                                      core::EventBus* bus) {
-    return std::static_pointer_cast<EventCapability>(
-        std::make_shared<EventCapabilityImpl>(extensionId, mgr, bus));
+inline std::shared_ptr<EventCapability> createEventCapabilityInstance(
+    const QString& extensionId, core::CapabilityManager* mgr, core::EventBus* bus, quint8 scopes,
+    std::shared_ptr<RateLimitBucket> rateLimit, std::shared_ptr<ResourceUsage> usage) {
+    return std::static_pointer_cast<EventCapability>(std::make_shared<EventCapabilityImpl>(
+        extensionId, mgr, bus, scopes, std::move(rateLimit), std::move(usage)));
 }
 
 }  // namespace opencardev::crankshaft::core::capabilities
@@ -23,6 +23,8 @@
 #include <QFile>
 #include <QIODevice>
 #include <QStringList>
+#include <functional>
+#include <memory>
 #include "Capability.hpp"
 
 namespace opencardev::crankshaft {
@@ -34,8 +36,10 @@ namespace capabilities {
  *
  * Extensions with this capability can:
  * - Read/write files within their scope directory
- * - List files in their scope
+ * - Map files within their scope read-only, without copying
+ * - List files in their scope, synchronously or streamed from a worker thread
  * - Create/delete files/directories in their scope
+ * - Bound their scope as a self-cleaning cache with a byte quota
  *
  * Extensions CANNOT access files outside their scope.
  * Typical scopes: $CACHE/extensions/{extension-id}/
@@ -46,6 +50,79 @@ class FileSystemCapability : public Capability {
     ~FileSystemCapability() override = default;
 
     QString id() const override { return "filesystem"; }
+    static constexpr CapabilitySlot kSlot = CapabilitySlot::FileSystem;
+    CapabilitySlot slot() const final { return kSlot; }
+
+    struct ScanOptions {
+        QStringList name_filters;  // e.g. {"*.png", "*.jpg"}; empty lists every file
+        int max_depth = -1;        // Subdirectory levels to descend; 0 = scope root only
+        int batch_size = 256;      // Paths per callback
+    };
+
+    // Receives relative paths in batches; finished is set on the last, possibly empty, one
+    using ScanCallback = std::function<void(const QStringList& files, bool finished)>;
+
+    // How a mapped file will be read, passed on to the kernel with posix_madvise()
+    enum class AccessHint {
+        Normal,
+        Sequential,  // Read ahead aggressively and drop pages soon after use
+        Random,      // No read-ahead
+        WillNeed,    // Start reading the pages in now
+    };
+
+    // Which files a cache over quota gives up first
+    enum class EvictionPolicy {
+        LeastRecentlyUsed,
+        LeastFrequentlyUsed,  // Ties go to the least recently used
+    };
+
+    struct CacheQuota {
+        qint64 max_bytes = 0;       // Evict once the scope holds more than this; 0 = no limit
+        qint64 min_free_bytes = 0;  // ...or once the volume has less space available than this
+        EvictionPolicy policy = EvictionPolicy::LeastRecentlyUsed;
+    };
+
+    struct CacheStats {
+        qint64 bytes = 0;  // Size of the files in the scope
+        int files = 0;
+        quint64 hits = 0;    // Reads (openFile() or mapFile()) of files that were there
+        quint64 misses = 0;  // Reads, and fileExists() checks, of files that were not
+        quint64 evicted_files = 0;
+        qint64 evicted_bytes = 0;
+
+        double hitRate() const {
+            return hits + misses > 0 ? double(hits) / double(hits + misses) : 0.0;
+        }
+    };
+
+    /**
+     * Read-only mapping of a file in the scope. The data is the page cache itself: it is
+     * not copied, and is shared with every other process mapping the same file.
+     *
+     * Once the capability is revoked or destroyed, data() returns null, size() 0 and no new
+     * mappings are made. Pages already handed out stay mapped until the last handle is
+     * released, so a pointer taken earlier stays readable while the handle is held.
+     */
+    class MappedFile {
+      public:
+        virtual ~MappedFile() = default;
+
+        virtual const uchar* data() const = 0;
+        virtual qint64 size() const = 0;
+        // false once unmapped
+        virtual bool isValid() const = 0;
+
+        /**
+         * Hint how part of the mapping will be read.
+         *
+         * @param length Bytes from offset; negative means to the end
+         * @return false if unmapped, out of range or not supported on this platform
+         */
+        virtual bool advise(AccessHint hint, qint64 offset = 0, qint64 length = -1) = 0;
+
+      protected:
+        MappedFile() = default;
+    };
 
     /**
      * Open a file within the capability's scope.
@@ -57,6 +134,29 @@ class FileSystemCapability : public Capability {
      */
     virtual QFile* openFile(const QString& relativePath, QIODevice::OpenMode mode) = 0;
 
+    /**
+     * Map a file within the capability's scope read-only. Prefer this to openFile() for
+     * large, read-mostly data such as map tiles, artwork and offline databases.
+     *
+     * @param relativePath Path relative to scope
+     * @param hint Initial access hint for the whole file
+     * @return Mapping, or nullptr if access is denied or the file cannot be mapped
+     */
+    virtual std::shared_ptr<MappedFile> mapFile(const QString& relativePath,
+                                                AccessHint hint = AccessHint::Normal) = 0;
+
+    /**
+     * Bound the scope as a cache. Files are indexed with their size and when and how often
+     * they were read; once the scope is over quota, or the volume runs short of space, the
+     * least valuable files are deleted on a worker thread until the scope is back under
+     * 90% of max_bytes. Files open for writing are never evicted.
+     *
+     * Recency is kept in memory; after a restart, files start from their modification time.
+     */
+    virtual void setCacheQuota(const CacheQuota& quota) = 0;
+
+    virtual CacheStats cacheStats() const = 0;
+
     /**
      * Get the scoped directory (read-only access to QDir).
      * Extensions can use this to check file existence, but cannot
@@ -66,12 +166,28 @@ class FileSystemCapability : public Capability {
 
     /**
      * List all files in the scope (recursive).
+     * Blocks until the scope has been walked; prefer scanFiles() on the GUI thread.
      *
      * @param nameFilters Optional filters (e.g., {"*.png", "*.jpg"})
      * @return List of relative file paths within scope
      */
     virtual QStringList listFiles(const QStringList& nameFilters = QStringList()) const = 0;
 
+    /**
+     * List files in the scope without blocking. The scope is walked on a worker thread
+     * and results are delivered in batches on the GUI thread. Directories walked before
+     * are served from an in-memory index that is kept current by watching them, so
+     * repeat listings do not touch the disk.
+     *
+     * @return Scan id for cancelScan(), or -1 if the capability has been revoked
+     */
+    virtual int scanFiles(const ScanOptions& options, ScanCallback callback) = 0;
+
+    /**
+     * Stop a scan; its callback is not called again. Unknown ids are ignored.
+     */
+    virtual void cancelScan(int scanId) = 0;
+
     /**
      * Check if a file exists within scope.
      *
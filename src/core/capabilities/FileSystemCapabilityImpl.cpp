@@ -19,22 +19,183 @@
 #include "FileSystemCapabilityImpl.hpp"
 #include <QDebug>
 #include <QDir>
-#include <QDirIterator>
 #include <QFile>
+#include <QFileInfo>
+#include <QSet>
 #include <QStorageInfo>
+#include <QThreadPool>
+#include <algorithm>
+#include <limits>
+#include "../diagnostics/DispatchContext.hpp"
 #include "CapabilityManager.hpp"
 
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 using namespace opencardev::crankshaft::core::capabilities;
 using opencardev::crankshaft::core::CapabilityManager;
+using opencardev::crankshaft::core::diagnostics::DispatchScope;
+
+namespace {
+
+// QFile handed to extensions; charges the bytes it moves to the owning extension and,
+// when opened for writing, reports the file's final size to the scope's cache on close
+class AccountedFile : public QFile {
+  public:
+    AccountedFile(const QString& path, std::shared_ptr<ResourceUsage> usage)
+        : QFile(path), usage_(std::move(usage)) {}
+    ~AccountedFile() override { close(); }
+
+    // Before open(), so an eviction cannot remove the file once it is open for writing
+    void trackWrites(std::shared_ptr<ScopeCache> cache, const QString& relativePath) {
+        cache_ = std::move(cache);
+        relative_path_ = relativePath;
+        cache_->writeStarted(relative_path_);
+    }
+
+    // open() failed after trackWrites()
+    void abortWrites() {
+        if (cache_) {
+            cache_->writeAborted(relative_path_);
+            cache_.reset();
+        }
+    }
+
+    void close() override {
+        const bool finished = cache_ && isOpen();
+        QFile::close();
+        if (finished) {
+            cache_->writeFinished(relative_path_, size());
+            cache_.reset();
+        }
+    }
+
+  protected:
+    qint64 readData(char* data, qint64 maxSize) override {
+        const qint64 read = QFile::readData(data, maxSize);
+        if (read > 0 && usage_) {
+            usage_->addFileRead(quint64(read));
+        }
+        return read;
+    }
+
+    qint64 writeData(const char* data, qint64 size) override {
+        const qint64 written = QFile::writeData(data, size);
+        if (written > 0 && usage_) {
+            usage_->addFileWritten(quint64(written));
+        }
+        return written;
+    }
+
+  private:
+    std::shared_ptr<ResourceUsage> usage_;
+    std::shared_ptr<ScopeCache> cache_;
+    QString relative_path_;
+};
+
+// Whole-file read-only mapping; QFile maps it MAP_SHARED, straight onto the page cache.
+// Revoking only hides it: the pages stay mapped until the last handle goes, so a pointer
+// the extension is still reading through never faults.
+class MappedRegion : public FileSystemCapability::MappedFile {
+  public:
+    explicit MappedRegion(const QString& path) : file_(path) {}
+    ~MappedRegion() override {
+        if (data_)
+            file_.unmap(data_);
+    }
+
+    bool map() {
+        if (!file_.open(QIODevice::ReadOnly))
+            return false;
+        size_ = file_.size();
+        // An empty file cannot be mapped, but is a valid, empty region
+        if (size_ == 0)
+            return true;
+        data_ = file_.map(0, size_);
+        return data_ != nullptr;
+    }
+
+    void revoke() { revoked_ = true; }
+
+    const uchar* data() const override { return revoked_ ? nullptr : data_; }
+    qint64 size() const override { return revoked_ ? 0 : size_; }
+    bool isValid() const override { return !revoked_ && file_.isOpen(); }
+
+    bool advise(FileSystemCapability::AccessHint hint, qint64 offset, qint64 length) override {
+        if (revoked_ || !data_ || offset < 0 || offset >= size_)
+            return false;
+        if (length < 0 || length > size_ - offset)
+            length = size_ - offset;
+#ifdef Q_OS_UNIX
+        int advice = POSIX_MADV_NORMAL;
+        switch (hint) {
+            case FileSystemCapability::AccessHint::Normal:
+                advice = POSIX_MADV_NORMAL;
+                break;
+            case FileSystemCapability::AccessHint::Sequential:
+                advice = POSIX_MADV_SEQUENTIAL;
+                break;
+            case FileSystemCapability::AccessHint::Random:
+                advice = POSIX_MADV_RANDOM;
+                break;
+            case FileSystemCapability::AccessHint::WillNeed:
+                advice = POSIX_MADV_WILLNEED;
+                break;
+        }
+        // The advised range has to start on a page boundary; the mapping itself does
+        static const qint64 page = sysconf(_SC_PAGESIZE);
+        const qint64 start = offset - offset % page;
+        return posix_madvise(data_ + start, size_t(offset + length - start), advice) == 0;
+#else
+        Q_UNUSED(hint);
+        return false;
+#endif
+    }
+
+  private:
+    QFile file_;
+    uchar* data_ = nullptr;
+    qint64 size_ = 0;
+    std::atomic_bool revoked_{false};
+};
+
+}  // namespace
 
 FileSystemCapabilityImpl::FileSystemCapabilityImpl(const QString& extension_id,
                                                    CapabilityManager* manager,
-                                                   const QString& scope_path)
-    : extension_id_(extension_id), manager_(manager), is_valid_(true), scope_path_(scope_path) {
+                                                   const QString& scope_path,
+                                                   std::shared_ptr<RateLimitBucket> rate_limit,
+                                                   std::shared_ptr<ResourceUsage> usage)
+    : extension_id_(extension_id),
+      manager_(manager),
+      is_valid_(true),
+      scope_path_(scope_path),
+      rate_limit_(std::move(rate_limit)),
+      usage_(std::move(usage)),
+      index_(std::make_shared<ScopeIndex>(scope_path)),
+      cache_(std::make_shared<ScopeCache>(index_)),
+      watcher_(std::make_unique<QFileSystemWatcher>()),
+      delivery_(std::make_shared<ScanDelivery>()) {
     QDir dir;
     if (!dir.mkpath(scope_path_)) {
         qWarning() << "Failed to create filesystem scope:" << scope_path_;
     }
+    QObject::connect(watcher_.get(), &QFileSystemWatcher::directoryChanged, watcher_.get(),
+                     [index = index_](const QString& path) { index->invalidate(path); });
+    delivery_->context = watcher_.get();
+}
+
+FileSystemCapabilityImpl::~FileSystemCapabilityImpl() {
+    {
+        QMutexLocker lock(&delivery_->mutex);
+        delivery_->context = nullptr;
+    }
+    cancelAllScans();
+    // Batches already posted are dropped with their context
+    watcher_.reset();
+    revokeMappings();
 }
 
 QString FileSystemCapabilityImpl::extensionId() const {
@@ -45,6 +206,23 @@ bool FileSystemCapabilityImpl::isValid() const {
 }
 void FileSystemCapabilityImpl::invalidate() {
     is_valid_ = false;
+    cancelAllScans();
+    // Give the inotify watches back; a revoked capability lists nothing
+    if (!watcher_->directories().isEmpty())
+        watcher_->removePaths(watcher_->directories());
+    index_->clear();
+    revokeMappings();
+    if (free_space_timer_)
+        free_space_timer_->stop();
+}
+
+bool FileSystemCapabilityImpl::admitWrite(const QString& action) {
+    if (!rate_limit_ || rate_limit_->acquireBlocking()) {
+        return true;
+    }
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("filesystem"),
+                                 QStringLiteral("rate_limited"), action);
+    return false;
 }
 
 QFile* FileSystemCapabilityImpl::openFile(const QString& relativePath, QIODevice::OpenMode mode) {
@@ -54,18 +232,79 @@ QFile* FileSystemCapabilityImpl::openFile(const QString& relativePath, QIODevice
         qWarning() << "Rejected suspicious file path:" << relativePath;
         return nullptr;
     }
+    // Reads are not limited; anything that can modify the scope is
+    const bool writes = mode & (QIODevice::WriteOnly | QIODevice::Append | QIODevice::Truncate);
+    if (writes && !admitWrite(QStringLiteral("openFile"))) {
+        return nullptr;
+    }
     QString absolutePath = QDir(scope_path_).filePath(relativePath);
-    manager_->logCapabilityUsage(extension_id_, "filesystem", "openFile",
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("filesystem"),
+                                 QStringLiteral("openFile"),
                                  QString("%1 (mode=%2)").arg(relativePath).arg((int)mode));
-    QFile* file = new QFile(absolutePath);
+    auto* file = new AccountedFile(absolutePath, usage_);
+    if (writes)
+        file->trackWrites(cache_, relativePath);
     if (!file->open(mode)) {
         qWarning() << "Failed to open file:" << absolutePath;
+        if (writes)
+            file->abortWrites();
+        else
+            cache_->recordRead(relativePath, false);
         delete file;
         return nullptr;
     }
+    if (writes) {
+        invalidateIndex(relativePath);
+    } else {
+        cache_->recordRead(relativePath, true);
+    }
     return file;
 }
 
+std::shared_ptr<FileSystemCapability::MappedFile> FileSystemCapabilityImpl::mapFile(
+    const QString& relativePath, AccessHint hint) {
+    if (!is_valid_)
+        return nullptr;
+    if (relativePath.contains("..") || relativePath.startsWith("/")) {
+        qWarning() << "Rejected suspicious file path:" << relativePath;
+        return nullptr;
+    }
+    QString absolutePath = QDir(scope_path_).filePath(relativePath);
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("filesystem"),
+                                 QStringLiteral("mapFile"), relativePath);
+    auto region = std::make_shared<MappedRegion>(absolutePath);
+    if (!region->map()) {
+        qWarning() << "Failed to map file:" << absolutePath;
+        if (!QFile::exists(absolutePath))
+            cache_->recordRead(relativePath, false);
+        return nullptr;
+    }
+    cache_->recordRead(relativePath, true);
+    if (hint != AccessHint::Normal)
+        region->advise(hint, 0, -1);
+
+    QMutexLocker lock(&mappings_mutex_);
+    // Revoked while this one was being mapped
+    if (mappings_revoked_)
+        return nullptr;
+    // Forget regions the extension has already released
+    mappings_.erase(std::remove_if(mappings_.begin(), mappings_.end(),
+                                   [](const auto& mapping) { return mapping.expired(); }),
+                    mappings_.end());
+    mappings_.push_back(region);
+    return region;
+}
+
+void FileSystemCapabilityImpl::revokeMappings() {
+    QMutexLocker lock(&mappings_mutex_);
+    for (const auto& mapping : mappings_) {
+        if (const auto region = std::static_pointer_cast<MappedRegion>(mapping.lock()))
+            region->revoke();
+    }
+    mappings_.clear();
+    mappings_revoked_ = true;
+}
+
 QDir FileSystemCapabilityImpl::scopedDirectory() const {
     return QDir(scope_path_);
 }
@@ -73,37 +312,177 @@ QDir FileSystemCapabilityImpl::scopedDirectory() const {
 QStringList FileSystemCapabilityImpl::listFiles(const QStringList& nameFilters) const {
     if (!is_valid_)
         return {};
-    QDir dir(scope_path_);
     QStringList files;
-    QDirIterator it(scope_path_, nameFilters.isEmpty() ? QStringList{"*"} : nameFilters,
-                    QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
-    while (it.hasNext()) {
-        QString absPath = it.next();
-        files << dir.relativeFilePath(absPath);
-    }
+    index_->walk(nameFilters, -1, std::numeric_limits<int>::max(),
+                 [&files](const QStringList& batch, bool) {
+                     files += batch;
+                     return true;
+                 });
+    watchNewDirectories();
     return files;
 }
 
+int FileSystemCapabilityImpl::scanFiles(const ScanOptions& options, ScanCallback callback) {
+    if (!is_valid_ || !callback)
+        return -1;
+    const int scanId = next_scan_id_++;
+    auto scan = std::make_shared<Scan>();
+    scan->callback = std::move(callback);
+    scans_.insert(scanId, scan);
+
+    // The worker never touches the capability: batches reach it through the watcher's
+    // event queue, which is cleared when the capability is destroyed
+    QThreadPool::globalInstance()->start(
+        [this, scanId, scan, options, index = index_, delivery = delivery_]() {
+            const auto post = [&](const QStringList& files, bool finished) {
+                QMutexLocker lock(&delivery->mutex);
+                if (!delivery->context || scan->cancelled.load(std::memory_order_relaxed))
+                    return false;
+                QMetaObject::invokeMethod(
+                    delivery->context,
+                    [this, scanId, scan, files, finished]() {
+                        deliverScan(scanId, scan, files, finished);
+                    },
+                    Qt::QueuedConnection);
+                return true;
+            };
+            index->walk(options.name_filters, options.max_depth, std::max(1, options.batch_size),
+                        post, &scan->cancelled);
+        });
+    return scanId;
+}
+
+void FileSystemCapabilityImpl::cancelScan(int scanId) {
+    const auto scan = scans_.take(scanId);
+    if (scan)
+        scan->cancelled = true;
+}
+
+void FileSystemCapabilityImpl::cancelAllScans() {
+    // Workers may hold a scan a while longer; the callback must not outlive a plugin
+    for (const auto& scan : std::as_const(scans_)) {
+        scan->cancelled = true;
+        scan->callback = nullptr;
+    }
+    scans_.clear();
+}
+
+void FileSystemCapabilityImpl::deliverScan(int scanId, const std::shared_ptr<Scan>& scan,
+                                           const QStringList& files, bool finished) {
+    if (scan->cancelled.load(std::memory_order_relaxed))
+        return;
+    watchNewDirectories();
+    if (finished)
+        scans_.remove(scanId);
+    // Charge the callback's time to this extension, as for event callbacks
+    DispatchScope dispatch(extension_id_, QStringLiteral("filesystem scan"));
+    ResourceScope scope(usage_.get());
+    const auto callback = scan->callback;
+    callback(files, finished);
+}
+
+void FileSystemCapabilityImpl::watchNewDirectories() const {
+    const QStringList directories = index_->takeUnwatched();
+    if (directories.isEmpty())
+        return;
+    const QStringList watchedList = watcher_->directories();
+    const QSet<QString> watched(watchedList.cbegin(), watchedList.cend());
+    QStringList added;
+    for (const QString& directory : directories) {
+        if (!watched.contains(directory))
+            added.append(directory);
+    }
+    const QStringList failedList = added.isEmpty() ? QStringList() : watcher_->addPaths(added);
+    const QSet<QString> failed(failedList.cbegin(), failedList.cend());
+    if (!failed.isEmpty()) {
+        // Out of inotify watches: these stay indexed, checked by mtime on every walk
+        qWarning() << "Cannot watch" << failed.size() << "directories in" << scope_path_;
+    }
+    for (const QString& directory : directories) {
+        if (!failed.contains(directory))
+            index_->setWatched(directory);
+    }
+}
+
+void FileSystemCapabilityImpl::invalidateIndex(const QString& relativePath) {
+    // Invalidate every ancestor: mkpath() may have created several levels
+    const QString root = index_->root();
+    QString directory = QDir::cleanPath(
+        QFileInfo(QDir(scope_path_).filePath(relativePath)).absolutePath());
+    while (directory.startsWith(root)) {
+        index_->invalidate(directory);
+        if (directory.size() <= root.size())
+            break;
+        directory = QFileInfo(directory).absolutePath();
+    }
+}
+
 bool FileSystemCapabilityImpl::fileExists(const QString& relativePath) const {
     if (!is_valid_ || relativePath.contains("..") || relativePath.startsWith("/"))
         return false;
-    return QFile::exists(QDir(scope_path_).filePath(relativePath));
+    if (QFile::exists(QDir(scope_path_).filePath(relativePath)))
+        return true;
+    // Checking before reading is how most caches look up; a hit is counted by the read
+    cache_->recordRead(relativePath, false);
+    return false;
 }
 
 bool FileSystemCapabilityImpl::createDirectory(const QString& relativePath) {
     if (!is_valid_ || relativePath.contains("..") || relativePath.startsWith("/"))
         return false;
+    if (!admitWrite(QStringLiteral("createDirectory")))
+        return false;
     QString absolutePath = QDir(scope_path_).filePath(relativePath);
-    manager_->logCapabilityUsage(extension_id_, "filesystem", "createDirectory", relativePath);
-    return QDir().mkpath(absolutePath);
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("filesystem"),
+                                 QStringLiteral("createDirectory"), relativePath);
+    if (!QDir().mkpath(absolutePath))
+        return false;
+    invalidateIndex(relativePath);
+    return true;
 }
 
 bool FileSystemCapabilityImpl::deleteFile(const QString& relativePath) {
     if (!is_valid_ || relativePath.contains("..") || relativePath.startsWith("/"))
         return false;
+    if (!admitWrite(QStringLiteral("deleteFile")))
+        return false;
     QString absolutePath = QDir(scope_path_).filePath(relativePath);
-    manager_->logCapabilityUsage(extension_id_, "filesystem", "deleteFile", relativePath);
-    return QFile::remove(absolutePath);
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("filesystem"),
+                                 QStringLiteral("deleteFile"), relativePath);
+    if (!QFile::remove(absolutePath))
+        return false;
+    cache_->recordRemoved(relativePath);
+    invalidateIndex(relativePath);
+    return true;
+}
+
+void FileSystemCapabilityImpl::setCacheQuota(const CacheQuota& quota) {
+    if (!is_valid_)
+        return;
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("filesystem"),
+                                 QStringLiteral("setCacheQuota"),
+                                 QString("max=%1 min_free=%2 policy=%3")
+                                     .arg(quota.max_bytes)
+                                     .arg(quota.min_free_bytes)
+                                     .arg(int(quota.policy)));
+    cache_->setQuota(quota);
+    // Other writers fill the volume too; look at its free space now and then
+    if (quota.min_free_bytes > 0) {
+        if (!free_space_timer_) {
+            free_space_timer_ = std::make_unique<QTimer>();
+            free_space_timer_->setInterval(kFreeSpaceCheckMs);
+            free_space_timer_->callOnTimeout([cache = cache_]() { cache->requestEviction(); });
+        }
+        free_space_timer_->start();
+    } else if (free_space_timer_) {
+        free_space_timer_->stop();
+    }
+    if (quota.max_bytes > 0 || quota.min_free_bytes > 0)
+        cache_->requestEviction();
+}
+
+FileSystemCapability::CacheStats FileSystemCapabilityImpl::cacheStats() const {
+    return cache_->stats();
 }
 
 QString FileSystemCapabilityImpl::scopePath() const {
@@ -21,8 +21,19 @@
 #include <QDir>
 #include <QDirIterator>
 #include <QFile>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QMutex>
 #include <QStorageInfo>
+#include <QTimer>
+#include <atomic>
+#include <memory>
+#include <vector>
 #include "FileSystemCapability.hpp"
+#include "RateLimiter.hpp"
+#include "ResourceAccounting.hpp"
+#include "ScopeCache.hpp"
+#include "ScopeIndex.hpp"
 
 namespace opencardev::crankshaft::core {
 class CapabilityManager;
@@ -33,30 +44,84 @@ namespace opencardev::crankshaft::core::capabilities {
 class FileSystemCapabilityImpl : public FileSystemCapability {
   public:
     FileSystemCapabilityImpl(const QString& extension_id, core::CapabilityManager* manager,
-                             const QString& scope_path);
+                             const QString& scope_path,
+                             std::shared_ptr<RateLimitBucket> rate_limit,
+                             std::shared_ptr<ResourceUsage> usage);
+    ~FileSystemCapabilityImpl() override;
     QString extensionId() const override;
     bool isValid() const override;
-    void invalidate();
+    void invalidate() override;
     QFile* openFile(const QString& relativePath, QIODevice::OpenMode mode) override;
+    std::shared_ptr<MappedFile> mapFile(const QString& relativePath, AccessHint hint) override;
     QDir scopedDirectory() const override;
     QStringList listFiles(const QStringList& nameFilters) const override;
+    int scanFiles(const ScanOptions& options, ScanCallback callback) override;
+    void cancelScan(int scanId) override;
     bool fileExists(const QString& relativePath) const override;
     bool createDirectory(const QString& relativePath) override;
     bool deleteFile(const QString& relativePath) override;
+    void setCacheQuota(const CacheQuota& quota) override;
+    CacheStats cacheStats() const override;
     QString scopePath() const override;
     qint64 availableSpace() const override;
 
   private:
+    // How often the volume's free space is checked while a min_free_bytes quota is set
+    static constexpr int kFreeSpaceCheckMs = 60000;
+
+    struct Scan {
+        std::atomic_bool cancelled{false};
+        ScanCallback callback;
+    };
+
+    // Where scan workers post their batches; cleared before the capability goes away
+    struct ScanDelivery {
+        QMutex mutex;
+        QObject* context = nullptr;
+    };
+
+    // Rate limit check for writes; rejected calls are audited
+    bool admitWrite(const QString& action);
+    // Hand a batch from a scan worker to its callback, on the GUI thread
+    void deliverScan(int scanId, const std::shared_ptr<Scan>& scan, const QStringList& files,
+                     bool finished);
+    void cancelAllScans();
+    // Hide every region still held by the extension; each is unmapped with its last handle
+    void revokeMappings();
+    // Watch directories the index read since the last call
+    void watchNewDirectories() const;
+    // A file or directory at relativePath is about to be created or removed
+    void invalidateIndex(const QString& relativePath);
+
     QString extension_id_;
     core::CapabilityManager* manager_;
     bool is_valid_;
     QString scope_path_;
+    std::shared_ptr<RateLimitBucket> rate_limit_;
+    std::shared_ptr<ResourceUsage> usage_;
+
+    std::shared_ptr<ScopeIndex> index_;
+    std::shared_ptr<ScopeCache> cache_;
+    std::unique_ptr<QTimer> free_space_timer_;
+    // Watches the indexed directories; also the GUI-thread context scan batches arrive on
+    std::unique_ptr<QFileSystemWatcher> watcher_;
+    std::shared_ptr<ScanDelivery> delivery_;
+    QHash<int, std::shared_ptr<Scan>> scans_;
+    int next_scan_id_ = 1;
+
+    // Regions handed out by mapFile(); revoked with the capability. mapFile() may run on
+    // any thread the extension calls from.
+    QMutex mappings_mutex_;
+    std::vector<std::weak_ptr<MappedFile>> mappings_;
+    bool mappings_revoked_ = false;
 };
 
 inline std::shared_ptr<FileSystemCapability> createFileSystemCapabilityInstance(
-    const QString& extensionId, core::CapabilityManager* mgr, const QString& scopePath) {
+    const QString& extensionId, core::CapabilityManager* mgr, const QString& scopePath,
+    std::shared_ptr<RateLimitBucket> rateLimit, std::shared_ptr<ResourceUsage> usage) {
     return std::static_pointer_cast<FileSystemCapability>(
-        std::make_shared<FileSystemCapabilityImpl>(extensionId, mgr, scopePath));
+        std::make_shared<FileSystemCapabilityImpl>(extensionId, mgr, scopePath,
+                                                   std::move(rateLimit), std::move(usage)));
 }
 
 }  // namespace opencardev::crankshaft::core::capabilities
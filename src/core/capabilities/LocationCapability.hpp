@@ -20,6 +20,8 @@
 #pragma once
 
 #include <QGeoCoordinate>
+#include <QtPositioning/QGeoPositionInfo>
+#include <QtPositioning/QGeoShape>
 #include <functional>
 #include "Capability.hpp"
 
@@ -34,6 +36,7 @@ namespace capabilities {
  * - Get current GPS position
  * - Subscribe to location updates
  * - Get location accuracy and metadata
+ * - Be notified on entering or leaving geofences
  *
  * Extensions cannot directly access Qt positioning APIs.
  */
@@ -42,12 +45,28 @@ class LocationCapability : public Capability {
     ~LocationCapability() override = default;
 
     QString id() const override { return "location"; }
+    static constexpr CapabilitySlot kSlot = CapabilitySlot::Location;
+    CapabilitySlot slot() const final { return kSlot; }
 
     // GPS device modes supported by the location capability.
-    // Internal/USB/Hat use the underlying platform position source.
+    // Internal uses the platform position source; USB and Hat read NMEA from the
+    // configured serial receiver. These receivers are shared by all extensions.
     // MockStatic provides a fixed coordinate for development.
     // MockIP resolves approximate location from public IP (network required).
-    enum class DeviceMode { Internal, USB, Hat, MockStatic, MockIP };
+    // Replay plays back the GPX or NMEA recording configured for the receivers.
+    enum class DeviceMode { Internal, USB, Hat, MockStatic, MockIP, Replay };
+
+    /**
+     * Which fixes a subscriber wants. The receiver is shared by all extensions; fixes are
+     * decimated per subscriber, and the receiver runs no faster than the most demanding
+     * subscriber needs.
+     */
+    struct UpdatePolicy {
+        int min_interval_ms = 0;      // At most one fix per interval; 0 = every fix
+        double min_distance_m = 0.0;  // Skip fixes closer than this to the last one delivered
+        double max_accuracy_m = 0.0;  // Skip fixes with worse horizontal accuracy; 0 = any
+        bool smoothed = false;        // Kalman-filtered fixes, with outliers withheld
+    };
 
     /**
      * Get the current GPS position.
@@ -64,6 +83,17 @@ class LocationCapability : public Capability {
      */
     virtual int subscribeToUpdates(std::function<void(const QGeoCoordinate&)> callback) = 0;
 
+    /**
+     * Subscribe to location fixes under a policy. Fixes carry their timestamp and, when
+     * the receiver reports them, accuracy, speed and heading.
+     *
+     * @param policy Rate, displacement and accuracy the subscriber needs
+     * @param callback Function to call with each fix that passes the policy
+     * @return Subscription ID for unsubscribe
+     */
+    virtual int subscribeToUpdates(const UpdatePolicy& policy,
+                                   std::function<void(const QGeoPositionInfo&)> callback) = 0;
+
     /**
      * Unsubscribe from location updates.
      *
@@ -71,6 +101,27 @@ class LocationCapability : public Capability {
      */
     virtual void unsubscribe(int subscriptionId) = 0;
 
+    /**
+     * Smoothed position extrapolated to now from the latest fixes, with speed and heading.
+     * Cheap enough to call on every frame, to move a map marker smoothly between 1 Hz
+     * fixes. Invalid before the first fix.
+     */
+    virtual QGeoPositionInfo predictPosition() const = 0;
+
+    /**
+     * Watch an area (a QGeoCircle, QGeoRectangle or QGeoPolygon) without computing distances
+     * on every fix. Entering and leaving it publish <extension id>.geofence.enter and
+     * .geofence.exit events, and staying inside for dwell_ms a .geofence.dwell event, each
+     * with { id, name, latitude, longitude, timestamp }. Fences are checked against smoothed
+     * fixes from the shared receiver, which runs at least once a second while any exist.
+     *
+     * @param name Passed back in the events
+     * @param dwell_ms Time inside before a dwell event; 0 for none
+     * @return Fence ID, or -1 if the area is invalid or of another shape
+     */
+    virtual int addGeofence(const QString& name, const QGeoShape& area, int dwell_ms = 0) = 0;
+    virtual void removeGeofence(int fenceId) = 0;
+
     /**
      * Get location accuracy in metres.
      */
@@ -17,32 +17,36 @@
  *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
  */
 #include "LocationCapabilityImpl.hpp"
-#include <QGeoPositionInfoSource>
+#include <QDateTime>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QTimer>
+#include "../diagnostics/DispatchContext.hpp"
+#include "../location/LocationHub.hpp"
 #include "CapabilityManager.hpp"
 
 using namespace opencardev::crankshaft::core::capabilities;
 using opencardev::crankshaft::core::CapabilityManager;
+using opencardev::crankshaft::core::diagnostics::DispatchScope;
+using opencardev::crankshaft::core::location::LocationHub;
 
 LocationCapabilityImpl::LocationCapabilityImpl(const QString& extension_id,
-                                               CapabilityManager* manager)
+                                               CapabilityManager* manager, LocationHub* hub)
     : extension_id_(extension_id),
       manager_(manager),
+      hub_(hub),
+      usage_(manager ? manager->resourceUsage(extension_id) : nullptr),
       is_valid_(true),
       next_subscription_id_(1),
-      position_source_(nullptr),
       device_mode_(DeviceMode::Internal),
       mock_timer_(nullptr) {}
 
 LocationCapabilityImpl::~LocationCapabilityImpl() {
-    if (position_source_) {
-        position_source_->stopUpdates();
-        delete position_source_;
-    }
+    detachAllFromHub();
+    removeAllGeofences();
+    delete mock_timer_;
 }
 
 QString LocationCapabilityImpl::extensionId() const {
@@ -53,48 +57,136 @@ bool LocationCapabilityImpl::isValid() const {
 }
 void LocationCapabilityImpl::invalidate() {
     is_valid_ = false;
+    // Let the hub slow down or stop the receiver if nobody else needs it
+    detachAllFromHub();
+    removeAllGeofences();
+    if (mock_timer_)
+        mock_timer_->stop();
+    // The callbacks' code may belong to a plugin that is about to be unloaded
+    subscriptions_.clear();
+}
+
+bool LocationCapabilityImpl::usesHub() const {
+    return device_mode_ != DeviceMode::MockStatic && device_mode_ != DeviceMode::MockIP;
+}
+
+void LocationCapabilityImpl::attachToHub(int subscriptionId) {
+    auto it = subscriptions_.find(subscriptionId);
+    if (it == subscriptions_.end() || it->hub_id >= 0 || !hub_)
+        return;
+    // Charge the callback's time to this extension, as for event callbacks
+    it->hub_id = hub_->subscribe(
+        extension_id_, it->policy,
+        [this, subscriptionId, id = extension_id_, usage = usage_](const QGeoPositionInfo& info) {
+            const auto sub = subscriptions_.constFind(subscriptionId);
+            if (!is_valid_ || sub == subscriptions_.cend())
+                return;
+            DispatchScope dispatch(id, QStringLiteral("location callback"));
+            ResourceScope scope(usage.get());
+            const auto callback = sub->callback;
+            callback(info);
+        });
 }
 
-void LocationCapabilityImpl::ensurePositionSource() {
-    if (!position_source_) {
-        position_source_ = QGeoPositionInfoSource::createDefaultSource(nullptr);
-        if (position_source_) {
-            position_source_->startUpdates();
-            QObject::connect(position_source_, &QGeoPositionInfoSource::positionUpdated,
-                             [this](const QGeoPositionInfo& info) { onPositionUpdated(info); });
-        }
+void LocationCapabilityImpl::detachAllFromHub() {
+    for (auto& sub : subscriptions_) {
+        if (sub.hub_id >= 0 && hub_)
+            hub_->unsubscribe(sub.hub_id);
+        sub.hub_id = -1;
     }
 }
 
 QGeoCoordinate LocationCapabilityImpl::getCurrentPosition() const {
     if (!is_valid_)
         return QGeoCoordinate();
-    if (device_mode_ == DeviceMode::MockStatic || device_mode_ == DeviceMode::MockIP) {
+    if (!usesHub()) {
         return mock_coordinate_;
     }
-    const_cast<LocationCapabilityImpl*>(this)->ensurePositionSource();
-    if (!position_source_)
+    if (!hub_)
         return QGeoCoordinate();
-    manager_->logCapabilityUsage(extension_id_, "location", "getCurrentPosition");
-    auto lastPos = position_source_->lastKnownPosition();
-    return lastPos.coordinate();
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("location"),
+                                 QStringLiteral("getCurrentPosition"));
+    return hub_->lastFix().coordinate();
+}
+
+QGeoPositionInfo LocationCapabilityImpl::predictPosition() const {
+    if (!is_valid_)
+        return QGeoPositionInfo();
+    if (!usesHub())
+        return QGeoPositionInfo(mock_coordinate_, QDateTime::currentDateTimeUtc());
+    // Not audited: meant to be called on every frame
+    return hub_ ? hub_->predictedPosition() : QGeoPositionInfo();
+}
+
+int LocationCapabilityImpl::addGeofence(const QString& name, const QGeoShape& area,
+                                        int dwell_ms) {
+    if (!is_valid_ || !hub_)
+        return -1;
+    const int id = hub_->geofences()->addFence(extension_id_, name, area, dwell_ms);
+    if (id < 0)
+        return -1;
+    fence_ids_.insert(id);
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("location"),
+                                 QStringLiteral("addGeofence"),
+                                 QString("fence_id=%1 name=%2").arg(id).arg(name));
+    return id;
+}
+
+void LocationCapabilityImpl::removeGeofence(int fenceId) {
+    // Only the extension's own fences
+    if (!fence_ids_.remove(fenceId) || !hub_)
+        return;
+    hub_->geofences()->removeFence(fenceId);
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("location"),
+                                 QStringLiteral("removeGeofence"),
+                                 QString("fence_id=%1").arg(fenceId));
+}
+
+void LocationCapabilityImpl::removeAllGeofences() {
+    if (hub_) {
+        for (int id : std::as_const(fence_ids_))
+            hub_->geofences()->removeFence(id);
+    }
+    fence_ids_.clear();
 }
 
 int LocationCapabilityImpl::subscribeToUpdates(
     std::function<void(const QGeoCoordinate&)> callback) {
+    return subscribeToUpdates(UpdatePolicy(), [callback = std::move(callback)](
+                                                  const QGeoPositionInfo& info) {
+        callback(info.coordinate());
+    });
+}
+
+int LocationCapabilityImpl::subscribeToUpdates(
+    const UpdatePolicy& policy, std::function<void(const QGeoPositionInfo&)> callback) {
     if (!is_valid_)
         return -1;
-    ensurePositionSource();
     int id = next_subscription_id_++;
-    subscriptions_[id] = callback;
-    manager_->logCapabilityUsage(extension_id_, "location", "subscribeToUpdates",
-                                 QString("subscription_id=%1").arg(id));
+    Subscription sub;
+    sub.policy = policy;
+    sub.callback = std::move(callback);
+    subscriptions_.insert(id, std::move(sub));
+    if (usesHub())
+        attachToHub(id);
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("location"),
+                                 QStringLiteral("subscribeToUpdates"),
+                                 QString("subscription_id=%1 interval_ms=%2 distance_m=%3")
+                                     .arg(id)
+                                     .arg(policy.min_interval_ms)
+                                     .arg(policy.min_distance_m));
     return id;
 }
 
 void LocationCapabilityImpl::unsubscribe(int subscriptionId) {
-    subscriptions_.remove(subscriptionId);
-    manager_->logCapabilityUsage(extension_id_, "location", "unsubscribe",
+    const auto it = subscriptions_.constFind(subscriptionId);
+    if (it == subscriptions_.cend())
+        return;
+    if (it->hub_id >= 0 && hub_)
+        hub_->unsubscribe(it->hub_id);
+    subscriptions_.erase(it);
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("location"),
+                                 QStringLiteral("unsubscribe"),
                                  QString("subscription_id=%1").arg(subscriptionId));
 }
 
@@ -105,9 +197,9 @@ double LocationCapabilityImpl::getAccuracy() const {
         return 25.0;
     if (device_mode_ == DeviceMode::MockIP)
         return 5000.0;
-    if (!position_source_)
+    if (!hub_)
         return -1.0;
-    auto lastPos = position_source_->lastKnownPosition();
+    const QGeoPositionInfo lastPos = hub_->lastFix();
     return lastPos.hasAttribute(QGeoPositionInfo::HorizontalAccuracy)
                ? lastPos.attribute(QGeoPositionInfo::HorizontalAccuracy)
                : -1.0;
@@ -116,23 +208,23 @@ double LocationCapabilityImpl::getAccuracy() const {
 bool LocationCapabilityImpl::isAvailable() const {
     if (!is_valid_)
         return false;
-    if (device_mode_ == DeviceMode::MockStatic || device_mode_ == DeviceMode::MockIP)
+    if (!usesHub())
         return true;
-    return position_source_ != nullptr;
+    return hub_ && hub_->isAvailable();
 }
 
 void LocationCapabilityImpl::setDeviceMode(DeviceMode mode) {
     if (device_mode_ == mode)
         return;
     device_mode_ = mode;
-    if (position_source_)
-        position_source_->stopUpdates();
     if (mock_timer_)
         mock_timer_->stop();
     if (mode == DeviceMode::MockStatic) {
+        detachAllFromHub();
         mock_coordinate_ = QGeoCoordinate(51.5074, -0.1278);
         ensureMockTimer();
     } else if (mode == DeviceMode::MockIP) {
+        detachAllFromHub();
         QNetworkAccessManager* nm = new QNetworkAccessManager();
         QObject::connect(nm, &QNetworkAccessManager::finished, [this, nm](QNetworkReply* reply) {
             if (reply->error() == QNetworkReply::NoError) {
@@ -157,9 +249,11 @@ void LocationCapabilityImpl::setDeviceMode(DeviceMode mode) {
         });
         nm->get(QNetworkRequest(QUrl("http://ip-api.com/json")));
     } else {
-        ensurePositionSource();
-        if (mock_timer_)
-            mock_timer_->stop();
+        // Receiver modes share the hub's source; the last mode selected applies to all
+        if (hub_)
+            hub_->useDevice(mode);
+        for (int id : subscriptions_.keys())
+            attachToHub(id);
     }
 }
 
@@ -167,22 +261,15 @@ LocationCapability::DeviceMode LocationCapabilityImpl::deviceMode() const {
     return device_mode_;
 }
 
-void LocationCapabilityImpl::onPositionUpdated(const QGeoPositionInfo& info) {
-    if (!is_valid_)
-        return;
-    QGeoCoordinate coord = info.coordinate();
-    for (const auto& cb : subscriptions_)
-        cb(coord);
-}
-
 void LocationCapabilityImpl::ensureMockTimer() {
     if (!mock_timer_) {
         mock_timer_ = new QTimer();
         QObject::connect(mock_timer_, &QTimer::timeout, [this]() {
-            if (device_mode_ == DeviceMode::MockStatic || device_mode_ == DeviceMode::MockIP) {
-                for (const auto& cb : subscriptions_)
-                    cb(mock_coordinate_);
-            }
+            if (!is_valid_ || usesHub())
+                return;
+            const QGeoPositionInfo info(mock_coordinate_, QDateTime::currentDateTimeUtc());
+            for (const auto& sub : subscriptions_)
+                sub.callback(info);
         });
     }
     mock_timer_->start(5000);
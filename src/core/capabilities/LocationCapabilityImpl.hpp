@@ -20,56 +20,81 @@
 
 #include <QGeoCoordinate>
 #include <QMap>
+#include <QPointer>
+#include <QSet>
 #include <QTimer>
 #include <QtPositioning/QGeoPositionInfo>
-#include <QtPositioning/QGeoPositionInfoSource>
 #include <functional>
 #include "LocationCapability.hpp"
+#include "ResourceAccounting.hpp"
 
 namespace opencardev::crankshaft::core {
 class CapabilityManager;  // fwd
+namespace location {
+class LocationHub;
 }
+}  // namespace opencardev::crankshaft::core
 
 namespace opencardev::crankshaft::core::capabilities {
 
+/**
+ * Per-extension view of the shared location hub. In the receiver modes (Internal, USB,
+ * Hat) subscriptions are registered with the hub; the mock modes are served locally.
+ */
 class LocationCapabilityImpl : public LocationCapability {
   public:
-    LocationCapabilityImpl(const QString& extension_id, core::CapabilityManager* manager);
+    LocationCapabilityImpl(const QString& extension_id, core::CapabilityManager* manager,
+                           location::LocationHub* hub);
     ~LocationCapabilityImpl() override;
 
     QString extensionId() const override;
     bool isValid() const override;
     QGeoCoordinate getCurrentPosition() const override;
     int subscribeToUpdates(std::function<void(const QGeoCoordinate&)> callback) override;
+    int subscribeToUpdates(const UpdatePolicy& policy,
+                           std::function<void(const QGeoPositionInfo&)> callback) override;
     void unsubscribe(int subscriptionId) override;
+    QGeoPositionInfo predictPosition() const override;
+    int addGeofence(const QString& name, const QGeoShape& area, int dwell_ms = 0) override;
+    void removeGeofence(int fenceId) override;
     double getAccuracy() const override;
     bool isAvailable() const override;
     void setDeviceMode(DeviceMode mode) override;
     DeviceMode deviceMode() const override;
 
-    void invalidate();
+    void invalidate() override;
 
   private:
-    void ensurePositionSource();
-    void onPositionUpdated(const QGeoPositionInfo& info);
+    struct Subscription {
+        UpdatePolicy policy;
+        std::function<void(const QGeoPositionInfo&)> callback;
+        int hub_id = -1;  // Registration with the hub while in a receiver mode
+    };
+
+    bool usesHub() const;
+    void attachToHub(int subscriptionId);
+    void detachAllFromHub();
+    void removeAllGeofences();
     void ensureMockTimer();
 
     QString extension_id_;
     core::CapabilityManager* manager_;
+    QPointer<location::LocationHub> hub_;
+    std::shared_ptr<ResourceUsage> usage_;
     bool is_valid_;
-    QGeoPositionInfoSource* position_source_;
-    QMap<int, std::function<void(const QGeoCoordinate&)>> subscriptions_;
+    QMap<int, Subscription> subscriptions_;
     int next_subscription_id_;
     DeviceMode device_mode_;
     QTimer* mock_timer_;
     QGeoCoordinate mock_coordinate_;
+    QSet<int> fence_ids_;  // Registered with the hub's geofence service
 };
 
 // Factory helper
 inline std::shared_ptr<LocationCapability> createLocationCapabilityInstance(
-    const QString& extensionId, core::CapabilityManager* mgr) {
+    const QString& extensionId, core::CapabilityManager* mgr, location::LocationHub* hub) {
     return std::static_pointer_cast<LocationCapability>(
-        std::make_shared<LocationCapabilityImpl>(extensionId, mgr));
+        std::make_shared<LocationCapabilityImpl>(extensionId, mgr, hub));
 }
 
 }  // namespace opencardev::crankshaft::core::capabilities
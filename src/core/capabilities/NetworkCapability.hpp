@@ -45,6 +45,8 @@ class NetworkCapability : public Capability {
     ~NetworkCapability() override = default;
 
     QString id() const override { return "network"; }
+    static constexpr CapabilitySlot kSlot = CapabilitySlot::Network;
+    CapabilitySlot slot() const final { return kSlot; }
 
     /**
      * Perform HTTP GET request.
@@ -17,6 +17,7 @@
  *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
  */
 #include "NetworkCapabilityImpl.hpp"
+#include <QNetworkReply>
 #include <QNetworkRequest>
 #include "CapabilityManager.hpp"
 
@@ -24,11 +25,15 @@ using namespace opencardev::crankshaft::core::capabilities;
 using opencardev::crankshaft::core::CapabilityManager;
 
 NetworkCapabilityImpl::NetworkCapabilityImpl(const QString& extension_id,
-                                             CapabilityManager* manager)
+                                             CapabilityManager* manager,
+                                             std::shared_ptr<RateLimitBucket> rate_limit,
+                                             std::shared_ptr<ResourceUsage> usage)
     : extension_id_(extension_id),
       manager_(manager),
       is_valid_(true),
-      network_manager_(new QNetworkAccessManager()) {}
+      network_manager_(new QNetworkAccessManager()),
+      rate_limit_(std::move(rate_limit)),
+      usage_(std::move(usage)) {}
 
 NetworkCapabilityImpl::~NetworkCapabilityImpl() {
     delete network_manager_;
@@ -44,48 +49,77 @@ void NetworkCapabilityImpl::invalidate() {
     is_valid_ = false;
 }
 
+bool NetworkCapabilityImpl::admit(const QString& action) {
+    if (!rate_limit_ || rate_limit_->acquireBlocking()) {
+        return true;
+    }
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("network"),
+                                 QStringLiteral("rate_limited"), action);
+    return false;
+}
+
+QNetworkReply* NetworkCapabilityImpl::track(QNetworkReply* reply, qint64 bytesOut) {
+    if (!reply || !usage_) {
+        return reply;
+    }
+    usage_->addNetworkOut(quint64(bytesOut));
+    // downloadProgress reports a running total; charge only what is new
+    auto usage = usage_;
+    QObject::connect(reply, &QNetworkReply::downloadProgress, reply,
+                     [usage, seen = qint64(0)](qint64 received, qint64) mutable {
+                         if (received > seen) {
+                             usage->addNetworkIn(quint64(received - seen));
+                             seen = received;
+                         }
+                     });
+    return reply;
+}
+
 QNetworkReply* NetworkCapabilityImpl::get(const QUrl& url) {
-    if (!is_valid_)
+    if (!is_valid_ || !admit(QStringLiteral("get")))
         return nullptr;
-    manager_->logCapabilityUsage(extension_id_, "network", "get", url.toString());
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("network"), QStringLiteral("get"),
+                                 url.toString());
     QNetworkRequest request(url);
     request.setHeader(QNetworkRequest::UserAgentHeader, "CrankshaftReborn/1.0");
-    return network_manager_->get(request);
+    return track(network_manager_->get(request), 0);
 }
 
 QNetworkReply* NetworkCapabilityImpl::post(const QUrl& url, const QByteArray& data) {
-    if (!is_valid_)
+    if (!is_valid_ || !admit(QStringLiteral("post")))
         return nullptr;
-    manager_->logCapabilityUsage(extension_id_, "network", "post",
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("network"), QStringLiteral("post"),
                                  QString("%1 (%2 bytes)").arg(url.toString()).arg(data.size()));
     QNetworkRequest request(url);
     request.setHeader(QNetworkRequest::UserAgentHeader, "CrankshaftReborn/1.0");
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-    return network_manager_->post(request, data);
+    return track(network_manager_->post(request, data), data.size());
 }
 
 QNetworkReply* NetworkCapabilityImpl::put(const QUrl& url, const QByteArray& data) {
-    if (!is_valid_)
+    if (!is_valid_ || !admit(QStringLiteral("put")))
         return nullptr;
-    manager_->logCapabilityUsage(extension_id_, "network", "put",
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("network"), QStringLiteral("put"),
                                  QString("%1 (%2 bytes)").arg(url.toString()).arg(data.size()));
     QNetworkRequest request(url);
     request.setHeader(QNetworkRequest::UserAgentHeader, "CrankshaftReborn/1.0");
-    return network_manager_->put(request, data);
+    return track(network_manager_->put(request, data), data.size());
 }
 
 QNetworkReply* NetworkCapabilityImpl::deleteResource(const QUrl& url) {
-    if (!is_valid_)
+    if (!is_valid_ || !admit(QStringLiteral("delete")))
         return nullptr;
-    manager_->logCapabilityUsage(extension_id_, "network", "delete", url.toString());
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("network"), QStringLiteral("delete"),
+                                 url.toString());
     QNetworkRequest request(url);
-    return network_manager_->deleteResource(request);
+    return track(network_manager_->deleteResource(request), 0);
 }
 
 QNetworkReply* NetworkCapabilityImpl::downloadFile(const QUrl& url, const QString& localPath) {
     if (!is_valid_)
         return nullptr;
-    manager_->logCapabilityUsage(extension_id_, "network", "downloadFile",
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("network"),
+                                 QStringLiteral("downloadFile"),
                                  QString("%1 -> %2").arg(url.toString(), localPath));
     return get(url);  // TODO implement proper download
 }
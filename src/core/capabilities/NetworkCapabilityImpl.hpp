@@ -20,6 +20,8 @@
 
 #include <QNetworkAccessManager>
 #include "NetworkCapability.hpp"
+#include "RateLimiter.hpp"
+#include "ResourceAccounting.hpp"
 
 namespace opencardev::crankshaft::core {
 class CapabilityManager;
@@ -29,12 +31,14 @@ namespace opencardev::crankshaft::core::capabilities {
 
 class NetworkCapabilityImpl : public NetworkCapability {
   public:
-    NetworkCapabilityImpl(const QString& extension_id, core::CapabilityManager* manager);
+    NetworkCapabilityImpl(const QString& extension_id, core::CapabilityManager* manager,
+                          std::shared_ptr<RateLimitBucket> rate_limit,
+                          std::shared_ptr<ResourceUsage> usage);
     ~NetworkCapabilityImpl() override;
 
     QString extensionId() const override;
     bool isValid() const override;
-    void invalidate();
+    void invalidate() override;
 
     QNetworkReply* get(const QUrl& url) override;
     QNetworkReply* post(const QUrl& url, const QByteArray& data) override;
@@ -44,16 +48,24 @@ class NetworkCapabilityImpl : public NetworkCapability {
     bool isOnline() const override;
 
   private:
+    // Rate limit check; rejected calls are audited
+    bool admit(const QString& action);
+    // Charge request and response bytes to the extension
+    QNetworkReply* track(QNetworkReply* reply, qint64 bytesOut);
+
     QString extension_id_;
     core::CapabilityManager* manager_;
     bool is_valid_;
     QNetworkAccessManager* network_manager_;
+    std::shared_ptr<RateLimitBucket> rate_limit_;
+    std::shared_ptr<ResourceUsage> usage_;
 };
 
 inline std::shared_ptr<NetworkCapability> createNetworkCapabilityInstance(
-    const QString& extensionId, core::CapabilityManager* mgr) {
-    return std::static_pointer_cast<NetworkCapability>(
-        std::make_shared<NetworkCapabilityImpl>(extensionId, mgr));
+    const QString& extensionId, core::CapabilityManager* mgr,
+    std::shared_ptr<RateLimitBucket> rateLimit, std::shared_ptr<ResourceUsage> usage) {
+    return std::static_pointer_cast<NetworkCapability>(std::make_shared<NetworkCapabilityImpl>(
+        extensionId, mgr, std::move(rateLimit), std::move(usage)));
 }
 
 }  // namespace opencardev::crankshaft::core::capabilities
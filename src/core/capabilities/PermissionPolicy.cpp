@@ -0,0 +1,103 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PermissionPolicy.hpp"
+#include <QDebug>
+
+namespace opencardev::crankshaft::core::capabilities {
+
+int PermissionPolicy::bitFor(const QString& permission) {
+    auto it = bits_.constFind(permission);
+    if (it != bits_.constEnd()) {
+        return it.value();
+    }
+    if (names_.size() >= kMaxPermissions) {
+        qWarning() << "Permission table full; cannot grant" << permission;
+        return -1;
+    }
+    const int bit = int(names_.size());
+    bits_.insert(permission, bit);
+    names_.append(permission);
+    return bit;
+}
+
+int PermissionPolicy::findBit(const QString& permission) const {
+    return bits_.value(permission, -1);
+}
+
+void PermissionPolicy::setImplied(const QString& permission, const QStringList& implied) {
+    implied_.insert(permission, implied);
+}
+
+void PermissionPolicy::setOverride(const QString& extensionId, const QStringList& allow,
+                                   const QStringList& deny) {
+    if (allow.isEmpty() && deny.isEmpty()) {
+        overrides_.remove(extensionId);
+    } else {
+        overrides_.insert(extensionId, Override{allow, deny});
+    }
+}
+
+void PermissionPolicy::setNames(PermissionSet* set, const QStringList& permissions) {
+    for (const QString& permission : permissions) {
+        const int bit = bitFor(permission);
+        if (bit >= 0) {
+            set->set(size_t(bit));
+        }
+    }
+}
+
+PermissionPolicy::PermissionSet PermissionPolicy::compile(const QString& extensionId,
+                                                          const QStringList& declared) {
+    PermissionSet allowed;
+    setNames(&allowed, declared);
+    for (const QString& permission : declared) {
+        setNames(&allowed, implied_.value(permission));
+    }
+
+    PermissionSet denied;
+    for (const QString& key : {extensionId, QString::fromLatin1(kAllExtensions)}) {
+        auto it = overrides_.constFind(key);
+        if (it != overrides_.constEnd()) {
+            setNames(&allowed, it->allow);
+            setNames(&denied, it->deny);
+        }
+    }
+
+    return allowed & ~denied;
+}
+
+QStringList PermissionPolicy::names(const PermissionSet& set) const {
+    QStringList result;
+    for (int bit = 0; bit < names_.size(); ++bit) {
+        if (set.test(size_t(bit))) {
+            result.append(names_.at(bit));
+        }
+    }
+    return result;
+}
+
+bool PermissionPolicy::isScopedTo(const QString& permission, const QString& capabilityType) {
+    return permission == capabilityType ||
+           (permission.size() > capabilityType.size() &&
+            permission.startsWith(capabilityType) &&
+            permission.at(capabilityType.size()) == QLatin1Char('.'));
+}
+
+}  // namespace opencardev::crankshaft::core::capabilities
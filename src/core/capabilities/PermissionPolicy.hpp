@@ -0,0 +1,92 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <bitset>
+
+namespace opencardev::crankshaft::core::capabilities {
+
+/**
+ * Compiles permission names into fixed-size bitsets.
+ *
+ * Every permission name (a capability type such as "network", or a scoped permission
+ * such as "event.wildcard") is assigned a bit the first time it is seen. An extension's
+ * declared manifest permissions are compiled once, together with the system policy
+ * overrides, into a PermissionSet; checks afterwards are single bit tests.
+ *
+ * Compilation order: declared permissions, plus the scoped permissions they imply,
+ * plus overrides allowed for the extension or for everyone ("*"), minus overrides
+ * denied for the extension or for everyone. Denials always win.
+ *
+ * Not thread-safe; CapabilityManager serialises access.
+ */
+class PermissionPolicy {
+  public:
+    static constexpr int kMaxPermissions = 128;
+    static constexpr const char* kAllExtensions = "*";
+
+    using PermissionSet = std::bitset<kMaxPermissions>;
+
+    // Bit for a permission, assigning one on first use; -1 once all bits are taken
+    int bitFor(const QString& permission);
+    // Bit for a permission without assigning one; -1 if never seen
+    int findBit(const QString& permission) const;
+    // Every assigned permission name and its bit
+    QHash<QString, int> bits() const { return bits_; }
+
+    // Scoped permissions granted along with a base permission unless denied
+    void setImplied(const QString& permission, const QStringList& implied);
+
+    /**
+     * Replace the system override for an extension ("*" for all extensions).
+     * Empty lists remove the override.
+     */
+    void setOverride(const QString& extensionId, const QStringList& allow,
+                     const QStringList& deny);
+
+    PermissionSet compile(const QString& extensionId, const QStringList& declared);
+
+    // Permission names set in a compiled set, for diagnostics
+    QStringList names(const PermissionSet& set) const;
+
+    /**
+     * Whether a change of permission affects a capability type: the type's own
+     * permission or one scoped under it ("<type>.<scope>").
+     */
+    static bool isScopedTo(const QString& permission, const QString& capabilityType);
+
+  private:
+    struct Override {
+        QStringList allow;
+        QStringList deny;
+    };
+
+    void setNames(PermissionSet* set, const QStringList& permissions);
+
+    QHash<QString, int> bits_;
+    QStringList names_;  // Bit -> name
+    QHash<QString, QStringList> implied_;
+    QHash<QString, Override> overrides_;
+};
+
+}  // namespace opencardev::crankshaft::core::capabilities
@@ -0,0 +1,282 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RateLimiter.hpp"
+#include <QCoreApplication>
+#include <QMutexLocker>
+#include <QThread>
+#include <algorithm>
+#include <cmath>
+
+namespace opencardev::crankshaft::core::capabilities {
+
+// ============================================================================
+// RateLimit
+// ============================================================================
+
+QString RateLimit::policyName(RateLimitPolicy policy) {
+    switch (policy) {
+        case RateLimitPolicy::Delay:
+            return QStringLiteral("delay");
+        case RateLimitPolicy::Coalesce:
+            return QStringLiteral("coalesce");
+        case RateLimitPolicy::Reject:
+            break;
+    }
+    return QStringLiteral("reject");
+}
+
+RateLimitPolicy RateLimit::policyFromName(const QString& name) {
+    const QString lower = name.toLower();
+    if (lower == QLatin1String("delay")) {
+        return RateLimitPolicy::Delay;
+    }
+    if (lower == QLatin1String("coalesce")) {
+        return RateLimitPolicy::Coalesce;
+    }
+    return RateLimitPolicy::Reject;
+}
+
+RateLimit RateLimit::fromMap(const QVariantMap& map) {
+    RateLimit limit;
+    limit.rate = map.value("rate").toDouble();
+    limit.burst = map.value("burst").toDouble();
+    limit.policy = policyFromName(map.value("policy").toString());
+    limit.max_delay_ms = map.value("max_delay_ms", limit.max_delay_ms).toInt();
+    return limit;
+}
+
+QVariantMap RateLimit::toMap() const {
+    QVariantMap map;
+    map["rate"] = rate;
+    map["burst"] = burst;
+    map["policy"] = policyName(policy);
+    map["max_delay_ms"] = max_delay_ms;
+    return map;
+}
+
+QVariantMap RateLimitCounters::toMap() const {
+    QVariantMap map;
+    map["allowed"] = allowed;
+    map["rejected"] = rejected;
+    map["delayed"] = delayed;
+    map["coalesced"] = coalesced;
+    return map;
+}
+
+// ============================================================================
+// RateLimitBucket
+// ============================================================================
+
+RateLimitBucket::RateLimitBucket(const RateLimit& limit)
+    : limit_(limit), tokens_(0.0), last_refill_ns_(0) {
+    clock_.start();
+    tokens_ = capacity();
+}
+
+double RateLimitBucket::capacity() const {
+    return limit_.burst > 0.0 ? limit_.burst : std::max(limit_.rate, 1.0);
+}
+
+void RateLimitBucket::configure(const RateLimit& limit) {
+    QMutexLocker locker(&mutex_);
+    refill();
+    limit_ = limit;
+    tokens_ = std::min(tokens_, capacity());
+}
+
+RateLimit RateLimitBucket::limit() const {
+    QMutexLocker locker(&mutex_);
+    return limit_;
+}
+
+void RateLimitBucket::refill() {
+    const qint64 now = clock_.nsecsElapsed();
+    const double elapsed = double(now - last_refill_ns_) / 1e9;
+    last_refill_ns_ = now;
+    if (!limit_.isUnlimited()) {
+        tokens_ = std::min(capacity(), tokens_ + elapsed * limit_.rate);
+    }
+}
+
+RateLimitBucket::Verdict RateLimitBucket::acquire(quint8 deferrals) {
+    QMutexLocker locker(&mutex_);
+    Verdict verdict;
+
+    if (limit_.isUnlimited()) {
+        ++counters_.allowed;
+        return verdict;
+    }
+
+    refill();
+    if (tokens_ >= 1.0) {
+        tokens_ -= 1.0;
+        ++counters_.allowed;
+        return verdict;
+    }
+
+    // Time until the token this call needs (tokens may already be reserved below zero)
+    const int wait = int(std::ceil((1.0 - tokens_) / limit_.rate * 1000.0));
+
+    if (limit_.policy == RateLimitPolicy::Delay && (deferrals & kCanWait) != 0 &&
+        wait <= limit_.max_delay_ms) {
+        tokens_ -= 1.0;  // Reserve, so later callers queue behind this one
+        ++counters_.delayed;
+        verdict.decision = Decision::Delay;
+        verdict.delay_ms = wait;
+        return verdict;
+    }
+    if (limit_.policy == RateLimitPolicy::Coalesce && (deferrals & kCanCoalesce) != 0) {
+        ++counters_.coalesced;
+        verdict.decision = Decision::Coalesce;
+        verdict.delay_ms = wait;
+        return verdict;
+    }
+
+    ++counters_.rejected;
+    verdict.decision = Decision::Reject;
+    return verdict;
+}
+
+bool RateLimitBucket::tryAcquire() {
+    QMutexLocker locker(&mutex_);
+    if (!limit_.isUnlimited()) {
+        refill();
+        if (tokens_ < 1.0) {
+            return false;
+        }
+        tokens_ -= 1.0;
+    }
+    ++counters_.allowed;
+    return true;
+}
+
+bool RateLimitBucket::acquireBlocking() {
+    // Never stall the GUI thread; there a Delay policy degrades to rejection
+    const QCoreApplication* app = QCoreApplication::instance();
+    const bool onGuiThread = app != nullptr && QThread::currentThread() == app->thread();
+
+    const Verdict verdict = acquire(onGuiThread ? kNoDeferral : kCanWait);
+    if (verdict.decision == Decision::Delay) {
+        QThread::msleep(static_cast<unsigned long>(verdict.delay_ms));
+        return true;
+    }
+    return verdict.decision == Decision::Allow;
+}
+
+int RateLimitBucket::msUntilAvailable() const {
+    QMutexLocker locker(&mutex_);
+    if (limit_.isUnlimited()) {
+        return 0;
+    }
+    const double elapsed = double(clock_.nsecsElapsed() - last_refill_ns_) / 1e9;
+    const double tokens = std::min(capacity(), tokens_ + elapsed * limit_.rate);
+    return tokens >= 1.0 ? 0 : int(std::ceil((1.0 - tokens) / limit_.rate * 1000.0));
+}
+
+RateLimitCounters RateLimitBucket::counters() const {
+    QMutexLocker locker(&mutex_);
+    return counters_;
+}
+
+// ============================================================================
+// RateLimiter
+// ============================================================================
+
+void RateLimiter::setDefaultLimit(const QString& capabilityType, const RateLimit& limit) {
+    QMutexLocker locker(&mutex_);
+    defaults_.insert(capabilityType, limit);
+    for (auto it = buckets_.cbegin(); it != buckets_.cend(); ++it) {
+        if (auto bucket = it->value(capabilityType)) {
+            bucket->configure(effectiveLimit(it.key(), capabilityType));
+        }
+    }
+}
+
+RateLimit RateLimiter::defaultLimit(const QString& capabilityType) const {
+    QMutexLocker locker(&mutex_);
+    return defaults_.value(capabilityType);
+}
+
+void RateLimiter::setExtensionLimits(const QString& extensionId,
+                                     const QHash<QString, RateLimit>& limits) {
+    QMutexLocker locker(&mutex_);
+    if (limits.isEmpty()) {
+        extension_limits_.remove(extensionId);
+    } else {
+        extension_limits_.insert(extensionId, limits);
+    }
+    reconfigure(extensionId);
+}
+
+void RateLimiter::removeExtension(const QString& extensionId) {
+    QMutexLocker locker(&mutex_);
+    extension_limits_.remove(extensionId);
+    buckets_.remove(extensionId);
+}
+
+RateLimit RateLimiter::effectiveLimit(const QString& extensionId,
+                                      const QString& capabilityType) const {
+    const RateLimit system = defaults_.value(capabilityType);
+    const auto declared = extension_limits_.constFind(extensionId);
+    if (declared == extension_limits_.cend() || !declared->contains(capabilityType)) {
+        return system;
+    }
+
+    RateLimit limit = declared->value(capabilityType);
+    if (!system.isUnlimited()) {
+        // Manifests may only tighten the system limit
+        limit.rate = limit.isUnlimited() ? system.rate : std::min(limit.rate, system.rate);
+        limit.burst = limit.burst > 0.0 && system.burst > 0.0 ? std::min(limit.burst, system.burst)
+                                                              : system.burst;
+        limit.max_delay_ms = std::min(limit.max_delay_ms, system.max_delay_ms);
+    }
+    return limit;
+}
+
+void RateLimiter::reconfigure(const QString& extensionId) {
+    const auto buckets = buckets_.value(extensionId);
+    for (auto it = buckets.cbegin(); it != buckets.cend(); ++it) {
+        it.value()->configure(effectiveLimit(extensionId, it.key()));
+    }
+}
+
+std::shared_ptr<RateLimitBucket> RateLimiter::bucket(const QString& extensionId,
+                                                     const QString& capabilityType) {
+    QMutexLocker locker(&mutex_);
+    auto& bucket = buckets_[extensionId][capabilityType];
+    if (!bucket) {
+        bucket = std::make_shared<RateLimitBucket>(effectiveLimit(extensionId, capabilityType));
+    }
+    return bucket;
+}
+
+QVariantMap RateLimiter::usage(const QString& extensionId) const {
+    QMutexLocker locker(&mutex_);
+    QVariantMap result;
+    const auto buckets = buckets_.value(extensionId);
+    for (auto it = buckets.cbegin(); it != buckets.cend(); ++it) {
+        QVariantMap entry = it.value()->counters().toMap();
+        entry["limit"] = it.value()->limit().toMap();
+        result.insert(it.key(), entry);
+    }
+    return result;
+}
+
+}  // namespace opencardev::crankshaft::core::capabilities
@@ -0,0 +1,149 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVariantMap>
+#include <memory>
+
+namespace opencardev::crankshaft::core::capabilities {
+
+// What happens to a call that finds its bucket empty
+enum class RateLimitPolicy {
+    Reject,    // Fail the call immediately
+    // Reserve the next token and run the call once it is due. Events are deferred from
+    // any thread; synchronous calls wait, except on the GUI thread where they are rejected
+    Delay,
+    Coalesce,  // Merge with pending calls of the same kind and run the latest later
+};
+
+struct RateLimit {
+    double rate = 0.0;   // Tokens per second; <= 0 means unlimited
+    double burst = 0.0;  // Bucket size; <= 0 means one second's worth
+    RateLimitPolicy policy = RateLimitPolicy::Reject;
+    int max_delay_ms = 1000;  // Delayed calls due later than this are rejected instead
+
+    bool isUnlimited() const { return rate <= 0.0; }
+
+    /**
+     * Parse { "rate": 10, "burst": 20, "policy": "delay", "max_delay_ms": 500 }
+     * as used in manifests (requirements.rate_limits.<capability>).
+     */
+    static RateLimit fromMap(const QVariantMap& map);
+    QVariantMap toMap() const;
+
+    static QString policyName(RateLimitPolicy policy);
+    static RateLimitPolicy policyFromName(const QString& name);
+};
+
+struct RateLimitCounters {
+    quint64 allowed = 0;
+    quint64 rejected = 0;
+    quint64 delayed = 0;
+    quint64 coalesced = 0;
+
+    QVariantMap toMap() const;
+};
+
+/**
+ * Token bucket guarding one capability of one extension.
+ *
+ * Buckets are shared between the RateLimiter, which reconfigures them when limits
+ * change, and the capability implementation, which holds on to its bucket so the hot
+ * path is a short critical section with no lookups.
+ */
+class RateLimitBucket {
+  public:
+    // Deferrals the calling site can carry out; policies it cannot honour reject
+    enum Deferral : quint8 {
+        kNoDeferral = 0,
+        kCanWait = 1 << 0,
+        kCanCoalesce = 1 << 1,
+    };
+
+    enum class Decision { Allow, Reject, Delay, Coalesce };
+
+    struct Verdict {
+        Decision decision = Decision::Allow;
+        int delay_ms = 0;  // For Delay and Coalesce: when to run
+    };
+
+    explicit RateLimitBucket(const RateLimit& limit);
+
+    void configure(const RateLimit& limit);
+    RateLimit limit() const;
+
+    Verdict acquire(quint8 deferrals);
+    // Take a token only if one is available now; used when draining coalesced calls
+    bool tryAcquire();
+    // Admission for synchronous calls: waits out a Delay verdict unless on the GUI thread
+    bool acquireBlocking();
+    int msUntilAvailable() const;
+
+    RateLimitCounters counters() const;
+
+  private:
+    void refill();
+    double capacity() const;
+
+    mutable QMutex mutex_;
+    RateLimit limit_;
+    double tokens_;
+    qint64 last_refill_ns_;
+    QElapsedTimer clock_;
+    RateLimitCounters counters_;
+};
+
+/**
+ * Per-extension, per-capability rate limits.
+ *
+ * System defaults apply to every extension; an extension's manifest may declare its own
+ * limits, which can tighten but never loosen a limited default.
+ */
+class RateLimiter {
+  public:
+    void setDefaultLimit(const QString& capabilityType, const RateLimit& limit);
+    RateLimit defaultLimit(const QString& capabilityType) const;
+
+    // Replace an extension's declared limits (capability type -> limit)
+    void setExtensionLimits(const QString& extensionId, const QHash<QString, RateLimit>& limits);
+    void removeExtension(const QString& extensionId);
+
+    // Bucket for an extension's capability, created on first use
+    std::shared_ptr<RateLimitBucket> bucket(const QString& extensionId,
+                                            const QString& capabilityType);
+
+    // Capability type -> { limit, counters } for an extension
+    QVariantMap usage(const QString& extensionId) const;
+
+  private:
+    RateLimit effectiveLimit(const QString& extensionId, const QString& capabilityType) const;
+    void reconfigure(const QString& extensionId);
+
+    mutable QMutex mutex_;
+    QHash<QString, RateLimit> defaults_;
+    QHash<QString, QHash<QString, RateLimit>> extension_limits_;
+    QHash<QString, QHash<QString, std::shared_ptr<RateLimitBucket>>> buckets_;
+};
+
+}  // namespace opencardev::crankshaft::core::capabilities
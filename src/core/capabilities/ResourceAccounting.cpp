@@ -0,0 +1,178 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ResourceAccounting.hpp"
+#include <QMutexLocker>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+
+namespace opencardev::crankshaft::core::capabilities {
+
+namespace {
+
+thread_local ResourceScope* t_current_scope = nullptr;
+
+qint64 wallNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+qint64 threadCpuNowNs() {
+#ifdef CLOCK_THREAD_CPUTIME_ID
+    timespec ts{};
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+        return qint64(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+#endif
+    return 0;
+}
+
+}  // namespace
+
+// ============================================================================
+// ResourceCounters / ResourceUsage
+// ============================================================================
+
+QVariantMap ResourceCounters::toMap() const {
+    QVariantMap map;
+    map["wall_ms"] = double(wall_ns) / 1e6;
+    map["cpu_ms"] = double(cpu_ns) / 1e6;
+    map["calls"] = calls;
+    map["net_bytes_in"] = net_bytes_in;
+    map["net_bytes_out"] = net_bytes_out;
+    map["fs_bytes_read"] = fs_bytes_read;
+    map["fs_bytes_written"] = fs_bytes_written;
+    map["events_emitted"] = events_emitted;
+    map["events_received"] = events_received;
+    return map;
+}
+
+void ResourceUsage::addTime(quint64 wallNs, quint64 cpuNs) {
+    wall_ns_.fetch_add(wallNs, std::memory_order_relaxed);
+    cpu_ns_.fetch_add(cpuNs, std::memory_order_relaxed);
+    calls_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ResourceUsage::addCounters(const ResourceCounters& counters) {
+    wall_ns_.fetch_add(counters.wall_ns, std::memory_order_relaxed);
+    cpu_ns_.fetch_add(counters.cpu_ns, std::memory_order_relaxed);
+    calls_.fetch_add(counters.calls, std::memory_order_relaxed);
+    net_bytes_in_.fetch_add(counters.net_bytes_in, std::memory_order_relaxed);
+    net_bytes_out_.fetch_add(counters.net_bytes_out, std::memory_order_relaxed);
+    fs_bytes_read_.fetch_add(counters.fs_bytes_read, std::memory_order_relaxed);
+    fs_bytes_written_.fetch_add(counters.fs_bytes_written, std::memory_order_relaxed);
+    events_emitted_.fetch_add(counters.events_emitted, std::memory_order_relaxed);
+    events_received_.fetch_add(counters.events_received, std::memory_order_relaxed);
+}
+
+ResourceCounters ResourceUsage::counters() const {
+    ResourceCounters counters;
+    counters.wall_ns = wall_ns_.load(std::memory_order_relaxed);
+    counters.cpu_ns = cpu_ns_.load(std::memory_order_relaxed);
+    counters.calls = calls_.load(std::memory_order_relaxed);
+    counters.net_bytes_in = net_bytes_in_.load(std::memory_order_relaxed);
+    counters.net_bytes_out = net_bytes_out_.load(std::memory_order_relaxed);
+    counters.fs_bytes_read = fs_bytes_read_.load(std::memory_order_relaxed);
+    counters.fs_bytes_written = fs_bytes_written_.load(std::memory_order_relaxed);
+    counters.events_emitted = events_emitted_.load(std::memory_order_relaxed);
+    counters.events_received = events_received_.load(std::memory_order_relaxed);
+    return counters;
+}
+
+// ============================================================================
+// ResourceScope
+// ============================================================================
+
+ResourceScope::ResourceScope(ResourceUsage* usage)
+    : usage_(usage),
+      parent_(nullptr),
+      wall_start_ns_(0),
+      cpu_start_ns_(0),
+      wall_ns_(0),
+      cpu_ns_(0) {
+    if (!usage_) {
+        return;
+    }
+    parent_ = t_current_scope;
+    if (parent_) {
+        parent_->pause();
+    }
+    t_current_scope = this;
+    resume();
+}
+
+ResourceScope::~ResourceScope() {
+    if (!usage_) {
+        return;
+    }
+    pause();
+    usage_->addTime(wall_ns_, cpu_ns_);
+    t_current_scope = parent_;
+    if (parent_) {
+        parent_->resume();
+    }
+}
+
+void ResourceScope::resume() {
+    wall_start_ns_ = wallNowNs();
+    cpu_start_ns_ = threadCpuNowNs();
+}
+
+void ResourceScope::pause() {
+    wall_ns_ += quint64(std::max<qint64>(0, wallNowNs() - wall_start_ns_));
+    cpu_ns_ += quint64(std::max<qint64>(0, threadCpuNowNs() - cpu_start_ns_));
+}
+
+// ============================================================================
+// ResourceAccounting
+// ============================================================================
+
+std::shared_ptr<ResourceUsage> ResourceAccounting::usage(const QString& extensionId) {
+    QMutexLocker locker(&mutex_);
+    auto& usage = usage_[extensionId];
+    if (!usage) {
+        usage = std::make_shared<ResourceUsage>();
+    }
+    return usage;
+}
+
+ResourceCounters ResourceAccounting::counters(const QString& extensionId) const {
+    QMutexLocker locker(&mutex_);
+    const auto usage = usage_.value(extensionId);
+    return usage ? usage->counters() : ResourceCounters();
+}
+
+QVariantList ResourceAccounting::snapshot() const {
+    QMutexLocker locker(&mutex_);
+    QStringList ids = usage_.keys();
+    std::sort(ids.begin(), ids.end());
+
+    QVariantList result;
+    result.reserve(ids.size());
+    for (const QString& id : ids) {
+        QVariantMap entry = usage_.value(id)->counters().toMap();
+        entry["id"] = id;
+        result.append(entry);
+    }
+    return result;
+}
+
+}  // namespace opencardev::crankshaft::core::capabilities
@@ -0,0 +1,132 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVariantList>
+#include <QVariantMap>
+#include <atomic>
+#include <memory>
+
+namespace opencardev::crankshaft::core::capabilities {
+
+// Point-in-time copy of an extension's resource counters
+struct ResourceCounters {
+    quint64 wall_ns = 0;  // Time spent inside the extension's callbacks and lifecycle methods
+    quint64 cpu_ns = 0;   // Thread CPU time over the same spans
+    quint64 calls = 0;    // Number of timed spans
+    quint64 net_bytes_in = 0;
+    quint64 net_bytes_out = 0;
+    quint64 fs_bytes_read = 0;
+    quint64 fs_bytes_written = 0;
+    quint64 events_emitted = 0;
+    quint64 events_received = 0;
+
+    QVariantMap toMap() const;
+};
+
+/**
+ * Live resource counters for one extension.
+ *
+ * Shared between ResourceAccounting and the capabilities, reply handlers and event
+ * subscriptions doing work on the extension's behalf; updates are relaxed atomic adds.
+ */
+class ResourceUsage {
+  public:
+    void addTime(quint64 wallNs, quint64 cpuNs);
+    void addNetworkIn(quint64 bytes) { net_bytes_in_.fetch_add(bytes, std::memory_order_relaxed); }
+    void addNetworkOut(quint64 bytes) {
+        net_bytes_out_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    void addFileRead(quint64 bytes) { fs_bytes_read_.fetch_add(bytes, std::memory_order_relaxed); }
+    void addFileWritten(quint64 bytes) {
+        fs_bytes_written_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    void addEventEmitted() { events_emitted_.fetch_add(1, std::memory_order_relaxed); }
+    void addEventReceived() { events_received_.fetch_add(1, std::memory_order_relaxed); }
+    // Fold in counters gathered elsewhere, such as in an extension host process
+    void addCounters(const ResourceCounters& counters);
+
+    ResourceCounters counters() const;
+
+  private:
+    std::atomic<quint64> wall_ns_{0};
+    std::atomic<quint64> cpu_ns_{0};
+    std::atomic<quint64> calls_{0};
+    std::atomic<quint64> net_bytes_in_{0};
+    std::atomic<quint64> net_bytes_out_{0};
+    std::atomic<quint64> fs_bytes_read_{0};
+    std::atomic<quint64> fs_bytes_written_{0};
+    std::atomic<quint64> events_emitted_{0};
+    std::atomic<quint64> events_received_{0};
+};
+
+/**
+ * Attributes the wall and CPU time of the enclosing block to an extension.
+ *
+ * Scopes nest per thread: while an inner scope is open (say, an event callback run
+ * synchronously from another extension's callback) the outer one is paused, so each
+ * nanosecond is charged to exactly one extension. A null usage makes the scope a no-op.
+ */
+class ResourceScope {
+  public:
+    explicit ResourceScope(ResourceUsage* usage);
+    ~ResourceScope();
+
+    ResourceScope(const ResourceScope&) = delete;
+    ResourceScope& operator=(const ResourceScope&) = delete;
+
+  private:
+    void resume();
+    void pause();
+
+    ResourceUsage* usage_;
+    ResourceScope* parent_;
+    qint64 wall_start_ns_;
+    qint64 cpu_start_ns_;
+    quint64 wall_ns_;
+    quint64 cpu_ns_;
+};
+
+/**
+ * Per-extension resource accounting: time in callbacks and lifecycle methods, network
+ * and filesystem bytes moved through capabilities, and event volume.
+ *
+ * Counters are cumulative for the lifetime of the process, so a snapshot taken after an
+ * extension is unloaded still shows what it consumed.
+ */
+class ResourceAccounting {
+  public:
+    // Counters for an extension, created on first use
+    std::shared_ptr<ResourceUsage> usage(const QString& extensionId);
+
+    ResourceCounters counters(const QString& extensionId) const;
+
+    // One { id, wall_ms, cpu_ms, calls, net_bytes_in, ... } map per extension, by id
+    QVariantList snapshot() const;
+
+  private:
+    mutable QMutex mutex_;
+    QHash<QString, std::shared_ptr<ResourceUsage>> usage_;
+};
+
+}  // namespace opencardev::crankshaft::core::capabilities
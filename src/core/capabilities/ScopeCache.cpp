@@ -0,0 +1,331 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ScopeCache.hpp"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSet>
+#include <QStorageInfo>
+#include <QThreadPool>
+#include <algorithm>
+#include <vector>
+
+namespace opencardev::crankshaft::core::capabilities {
+
+namespace {
+
+qint64 nowMs() {
+    return QDateTime::currentMSecsSinceEpoch();
+}
+
+}  // namespace
+
+ScopeCache::ScopeCache(std::shared_ptr<ScopeIndex> index)
+    : index_(std::move(index)), root_(index_->root()) {}
+
+void ScopeCache::setQuota(const CacheQuota& quota) {
+    QMutexLocker lock(&mutex_);
+    quota_ = quota;
+}
+
+ScopeCache::CacheQuota ScopeCache::quota() const {
+    QMutexLocker lock(&mutex_);
+    return quota_;
+}
+
+void ScopeCache::recordRead(const QString& relative_path, bool hit) {
+    const QString path = key(relative_path);
+    QMutexLocker lock(&mutex_);
+    if (!hit) {
+        ++stats_.misses;
+        return;
+    }
+    ++stats_.hits;
+    auto it = entries_.find(path);
+    if (it == entries_.end()) {
+        // Appeared behind the capability's back; index it now it is in use
+        if (!loaded_) {
+            return;
+        }
+        lock.unlock();
+        const qint64 size = QFileInfo(root_ + QLatin1Char('/') + path).size();
+        lock.relock();
+        it = entries_.find(path);
+        if (it == entries_.end()) {
+            entryLocked(path, size, 0);
+            it = entries_.find(path);
+        }
+    }
+    it->last_read_ms = nowMs();
+    ++it->reads;
+}
+
+void ScopeCache::writeStarted(const QString& relative_path) {
+    const QString path = key(relative_path);
+    QMutexLocker lock(&mutex_);
+    // Opening the file before the eviction removes it would leave the writer an unlinked file
+    for (auto it = entries_.constFind(path); it != entries_.cend() && it->evicting;
+         it = entries_.constFind(path)) {
+        evicted_.wait(&mutex_);
+    }
+    entryLocked(path, 0, nowMs()).writers++;
+}
+
+void ScopeCache::writeAborted(const QString& relative_path) {
+    const QString path = key(relative_path);
+    const bool exists = QFileInfo::exists(root_ + QLatin1Char('/') + path);
+    QMutexLocker lock(&mutex_);
+    const auto it = entries_.find(path);
+    if (it == entries_.end()) {
+        return;
+    }
+    it->writers = std::max(0, it->writers - 1);
+    if (it->writers == 0 && !exists) {
+        stats_.bytes -= it->size;
+        --stats_.files;
+        entries_.erase(it);
+    }
+}
+
+void ScopeCache::writeFinished(const QString& relative_path, qint64 size) {
+    const QString path = key(relative_path);
+    QMutexLocker lock(&mutex_);
+    Entry& entry = entryLocked(path, 0, nowMs());
+    stats_.bytes += size - entry.size;
+    entry.size = size;
+    entry.last_read_ms = nowMs();
+    entry.writers = std::max(0, entry.writers - 1);
+    const bool over = overQuotaLocked();
+    lock.unlock();
+    if (over) {
+        requestEviction();
+    }
+}
+
+void ScopeCache::recordRemoved(const QString& relative_path) {
+    QMutexLocker lock(&mutex_);
+    const auto it = entries_.constFind(key(relative_path));
+    if (it == entries_.cend()) {
+        return;
+    }
+    stats_.bytes -= it->size;
+    --stats_.files;
+    entries_.erase(it);
+}
+
+void ScopeCache::requestEviction() {
+    eviction_requested_ = true;
+    if (eviction_running_.exchange(true)) {
+        return;
+    }
+    QThreadPool::globalInstance()->start([self = shared_from_this()]() {
+        for (;;) {
+            while (self->eviction_requested_.exchange(false)) {
+                self->load();
+                self->evict();
+            }
+            self->eviction_running_ = false;
+            // A request that arrived after the last pass, but saw this one still running
+            if (!self->eviction_requested_ || self->eviction_running_.exchange(true)) {
+                break;
+            }
+        }
+    });
+}
+
+void ScopeCache::load() {
+    {
+        QMutexLocker lock(&mutex_);
+        if (loaded_) {
+            return;
+        }
+    }
+
+    QHash<QString, Entry> found;
+    QDirIterator it(root_, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        Entry entry;
+        entry.size = info.size();
+        entry.last_read_ms = info.lastModified().toMSecsSinceEpoch();
+        found.insert(info.filePath().mid(root_.size() + 1), entry);
+    }
+
+    QMutexLocker lock(&mutex_);
+    // Files read or written while loading are already known, and more current
+    for (auto entry = found.cbegin(); entry != found.cend(); ++entry) {
+        if (!entries_.contains(entry.key())) {
+            entryLocked(entry.key(), entry->size, entry->last_read_ms);
+        }
+    }
+    loaded_ = true;
+}
+
+qint64 ScopeCache::evict() {
+    const CacheQuota quota = this->quota();
+    const qint64 available =
+        quota.min_free_bytes > 0 ? QStorageInfo(root_).bytesAvailable() : qint64(-1);
+
+    struct Candidate {
+        QString path;
+        qint64 last_read_ms;
+        quint32 reads;
+    };
+    std::vector<Candidate> candidates;
+    qint64 excess = 0;
+    {
+        QMutexLocker lock(&mutex_);
+        if (quota.max_bytes > 0 && stats_.bytes > quota.max_bytes) {
+            excess = stats_.bytes - qint64(double(quota.max_bytes) * kLowWatermark);
+        }
+        if (available >= 0 && available < quota.min_free_bytes) {
+            excess = std::max(excess, quota.min_free_bytes - available);
+        }
+        if (excess <= 0) {
+            return 0;
+        }
+        candidates.reserve(size_t(entries_.size()));
+        for (auto it = entries_.cbegin(); it != entries_.cend(); ++it) {
+            if (it->writers == 0) {
+                candidates.push_back({it.key(), it->last_read_ms, it->reads});
+            }
+        }
+    }
+
+    const bool lfu = quota.policy == FileSystemCapability::EvictionPolicy::LeastFrequentlyUsed;
+    std::sort(candidates.begin(), candidates.end(),
+              [lfu](const Candidate& a, const Candidate& b) {
+                  if (lfu && a.reads != b.reads) {
+                      return a.reads < b.reads;
+                  }
+                  return a.last_read_ms < b.last_read_ms;
+              });
+
+    // Pick the victims under the lock, re-checking each, and mark them so no other
+    // eviction takes them; the files are removed without holding the lock
+    struct Victim {
+        QString path;
+        qint64 size;
+        bool removed = false;
+        bool gone = false;
+    };
+    std::vector<Victim> victims;
+    {
+        QMutexLocker lock(&mutex_);
+        qint64 planned = 0;
+        for (const Candidate& candidate : candidates) {
+            if (planned >= excess) {
+                break;
+            }
+            const auto it = entries_.find(candidate.path);
+            // Read or reopened since the candidates were taken: no longer the least valuable
+            if (it == entries_.end() || it->writers > 0 || it->evicting ||
+                it->last_read_ms != candidate.last_read_ms) {
+                continue;
+            }
+            it->evicting = true;
+            planned += it->size;
+            victims.push_back({candidate.path, it->size});
+        }
+    }
+
+    for (Victim& victim : victims) {
+        const QString path = root_ + QLatin1Char('/') + victim.path;
+        victim.removed = QFile::remove(path);
+        victim.gone = victim.removed || !QFileInfo::exists(path);
+        if (!victim.gone) {
+            qWarning() << "Cannot evict cached file:" << path;
+        }
+    }
+
+    qint64 freed = 0;
+    int evicted = 0;
+    QSet<QString> directories;
+    {
+        QMutexLocker lock(&mutex_);
+        for (const Victim& victim : victims) {
+            const auto it = entries_.find(victim.path);
+            // Removed through the capability meanwhile, which already accounted for it
+            if (it == entries_.end()) {
+                continue;
+            }
+            it->evicting = false;
+            if (!victim.gone) {
+                continue;
+            }
+            // A file already gone is forgotten, but was not evicted
+            if (victim.removed) {
+                freed += victim.size;
+                ++evicted;
+                ++stats_.evicted_files;
+                stats_.evicted_bytes += victim.size;
+            }
+            directories.insert(QFileInfo(root_ + QLatin1Char('/') + victim.path).absolutePath());
+            // Writers wait in writeStarted() while a victim is evicting, so none holds it
+            stats_.bytes -= it->size;
+            --stats_.files;
+            entries_.erase(it);
+        }
+    }
+    evicted_.wakeAll();
+
+    for (const QString& directory : std::as_const(directories)) {
+        index_->invalidate(directory);
+    }
+    if (evicted > 0) {
+        qInfo() << "Evicted" << evicted << "files," << freed << "bytes, from" << root_;
+    }
+    return freed;
+}
+
+ScopeCache::CacheStats ScopeCache::stats() const {
+    QMutexLocker lock(&mutex_);
+    return stats_;
+}
+
+QString ScopeCache::key(const QString& relative_path) {
+    return QDir::cleanPath(relative_path);
+}
+
+bool ScopeCache::overQuotaLocked() const {
+    return quota_.max_bytes > 0 && stats_.bytes > quota_.max_bytes;
+}
+
+ScopeCache::Entry& ScopeCache::entryLocked(const QString& key, qint64 size,
+                                           qint64 last_read_ms) {
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        Entry entry;
+        entry.size = size;
+        entry.last_read_ms = last_read_ms;
+        it = entries_.insert(key, entry);
+        stats_.bytes += size;
+        ++stats_.files;
+    }
+    return *it;
+}
+
+}  // namespace opencardev::crankshaft::core::capabilities
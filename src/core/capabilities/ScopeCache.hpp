@@ -0,0 +1,112 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+#include <atomic>
+#include <memory>
+#include "FileSystemCapability.hpp"
+#include "ScopeIndex.hpp"
+
+namespace opencardev::crankshaft::core::capabilities {
+
+/**
+ * Quota and eviction index for a filesystem capability's scope.
+ *
+ * Every file is remembered with its size, when it was last read and how often. The
+ * capability reports reads, writes and deletes as they happen; files it has not seen are
+ * picked up from disk before the first eviction, with their mtime as the last read.
+ *
+ * Evictions run on the global thread pool, one pass at a time, and mark the directories
+ * they touch stale in the scope's ScopeIndex. All methods are thread-safe; the cache is
+ * shared with the files it handed out, so it outlives a revoked capability.
+ */
+class ScopeCache : public std::enable_shared_from_this<ScopeCache> {
+  public:
+    using CacheQuota = FileSystemCapability::CacheQuota;
+    using CacheStats = FileSystemCapability::CacheStats;
+
+    // Evictions free space down to this fraction of max_bytes, so not every write evicts
+    static constexpr double kLowWatermark = 0.9;
+
+    explicit ScopeCache(std::shared_ptr<ScopeIndex> index);
+
+    void setQuota(const CacheQuota& quota);
+    CacheQuota quota() const;
+
+    // A read of relative_path found the file (hit) or not
+    void recordRead(const QString& relative_path, bool hit);
+    // relative_path is about to be opened for writing; it is not evicted until
+    // writeFinished() or writeAborted(). Waits for an eviction already removing the file.
+    void writeStarted(const QString& relative_path);
+    // The open after writeStarted() failed; forgets a file that never came to exist
+    void writeAborted(const QString& relative_path);
+    // Requests an eviction if the write took the scope over quota
+    void writeFinished(const QString& relative_path, qint64 size);
+    void recordRemoved(const QString& relative_path);
+
+    // Load the index if needed and evict in the background; coalesced while a pass runs
+    void requestEviction();
+
+    /**
+     * Index every file on disk not known yet. Run by the first eviction; blocking.
+     */
+    void load();
+
+    /**
+     * Delete files until the scope is within quota. Blocking.
+     *
+     * @return Bytes freed
+     */
+    qint64 evict();
+
+    CacheStats stats() const;
+
+  private:
+    struct Entry {
+        qint64 size = 0;
+        qint64 last_read_ms = 0;
+        quint32 reads = 0;
+        int writers = 0;  // Open for writing; pinned
+        bool evicting = false;  // Picked by evict(), which is removing the file
+    };
+
+    static QString key(const QString& relative_path);
+    bool overQuotaLocked() const;
+    // Entry for key; a file not seen before is added with the given size and last read
+    Entry& entryLocked(const QString& key, qint64 size, qint64 last_read_ms);
+
+    const std::shared_ptr<ScopeIndex> index_;
+    const QString root_;
+    mutable QMutex mutex_;
+    QWaitCondition evicted_;  // Victims' evicting flags were cleared
+    QHash<QString, Entry> entries_;  // Path relative to the scope -> entry
+    CacheQuota quota_;
+    CacheStats stats_;  // bytes and files kept current with entries_
+    bool loaded_ = false;
+    std::atomic_bool eviction_running_{false};
+    std::atomic_bool eviction_requested_{false};
+};
+
+}  // namespace opencardev::crankshaft::core::capabilities
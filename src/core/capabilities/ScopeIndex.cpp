@@ -0,0 +1,204 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ScopeIndex.hpp"
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QRegularExpression>
+
+namespace opencardev::crankshaft::core::capabilities {
+
+namespace {
+
+qint64 mtimeMs(const QString& path) {
+    return QFileInfo(path).lastModified().toMSecsSinceEpoch();
+}
+
+QString joined(const QString& parent, const QString& name) {
+    return parent.isEmpty() ? name : parent + QLatin1Char('/') + name;
+}
+
+}  // namespace
+
+ScopeIndex::ScopeIndex(const QString& root) : root_(QDir::cleanPath(QDir(root).absolutePath())) {}
+
+bool ScopeIndex::walk(const QStringList& name_filters, int max_depth, int batch_size,
+                      const Sink& sink, const std::atomic_bool* cancelled) {
+    // Same matching as QDir name filters: wildcards, case-insensitive
+    QList<QRegularExpression> patterns;
+    for (const QString& filter : name_filters) {
+        patterns.append(QRegularExpression(QRegularExpression::wildcardToRegularExpression(filter),
+                                           QRegularExpression::CaseInsensitiveOption));
+    }
+    const auto matches = [&patterns](const QString& name) {
+        if (patterns.isEmpty()) {
+            return true;
+        }
+        for (const QRegularExpression& pattern : patterns) {
+            if (pattern.match(name).hasMatch()) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    struct Pending {
+        QString relative;
+        int depth;
+    };
+    QList<Pending> pending{Pending{QString(), 0}};
+    QStringList batch;
+    while (!pending.isEmpty()) {
+        if (cancelled && cancelled->load(std::memory_order_relaxed)) {
+            return false;
+        }
+        const Pending dir = pending.takeLast();
+        const Listing contents =
+            listing(dir.relative.isEmpty() ? root_ : root_ + QLatin1Char('/') + dir.relative);
+
+        for (const QString& file : contents.files) {
+            if (!matches(file)) {
+                continue;
+            }
+            batch.append(joined(dir.relative, file));
+            if (batch.size() >= batch_size) {
+                if (!sink(batch, false)) {
+                    return false;
+                }
+                batch.clear();
+            }
+        }
+        if (max_depth < 0 || dir.depth < max_depth) {
+            // Reversed so subdirectories are visited in listing order
+            for (auto it = contents.directories.crbegin(); it != contents.directories.crend();
+                 ++it) {
+                pending.append(Pending{joined(dir.relative, *it), dir.depth + 1});
+            }
+        }
+    }
+    return sink(batch, true);
+}
+
+void ScopeIndex::invalidate(const QString& directory) {
+    const QString key = QDir::cleanPath(QDir(directory).absolutePath());
+    // A removed directory is no longer watched; forget it so a new one is watched again
+    const bool exists = QFileInfo(key).isDir();
+    QMutexLocker lock(&mutex_);
+    ++generation_;
+    if (!exists) {
+        listings_.remove(key);
+        unwatched_.remove(key);
+        return;
+    }
+    auto it = listings_.find(key);
+    if (it != listings_.end()) {
+        it->stale = true;
+    }
+}
+
+void ScopeIndex::clear() {
+    QMutexLocker lock(&mutex_);
+    ++generation_;
+    listings_.clear();
+    unwatched_.clear();
+}
+
+QStringList ScopeIndex::takeUnwatched() {
+    QMutexLocker lock(&mutex_);
+    const QStringList directories = unwatched_.values();
+    unwatched_.clear();
+    return directories;
+}
+
+void ScopeIndex::setWatched(const QString& directory) {
+    const qint64 mtime = mtimeMs(directory);
+    QMutexLocker lock(&mutex_);
+    auto it = listings_.find(directory);
+    if (it == listings_.end()) {
+        return;
+    }
+    it->watched = true;
+    if (it->mtime_ms != mtime) {
+        it->stale = true;
+    }
+}
+
+ScopeIndex::Stats ScopeIndex::stats() const {
+    QMutexLocker lock(&mutex_);
+    return stats_;
+}
+
+ScopeIndex::Listing ScopeIndex::listing(const QString& directory) {
+    QMutexLocker lock(&mutex_);
+    auto it = listings_.constFind(directory);
+    if (it != listings_.cend() && !it->stale) {
+        if (it->watched) {
+            ++stats_.directory_hits;
+            return *it;
+        }
+        // Not watched: only trust the entry while the directory's mtime is unchanged
+        const Listing cached = *it;
+        lock.unlock();
+        const bool current = mtimeMs(directory) == cached.mtime_ms;
+        lock.relock();
+        if (current) {
+            ++stats_.directory_hits;
+            return cached;
+        }
+    }
+
+    const quint64 generation = generation_;
+    lock.unlock();
+    Listing fresh = readDirectory(directory);
+    lock.relock();
+    ++stats_.directory_reads;
+    // Invalidated while reading: return what was read but do not keep it
+    if (generation == generation_) {
+        auto existing = listings_.find(directory);
+        fresh.watched = existing != listings_.end() && existing->watched;
+        if (!fresh.watched) {
+            unwatched_.insert(directory);
+        }
+        listings_.insert(directory, fresh);
+    }
+    return fresh;
+}
+
+ScopeIndex::Listing ScopeIndex::readDirectory(const QString& directory) {
+    Listing contents;
+    contents.mtime_ms = mtimeMs(directory);
+    QDirIterator it(directory, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        if (!info.isDir()) {
+            contents.files.append(info.fileName());
+        } else if (!info.isSymLink()) {
+            // Like QDirIterator::Subdirectories without FollowSymlinks
+            contents.directories.append(info.fileName());
+        }
+    }
+    return contents;
+}
+
+}  // namespace opencardev::crankshaft::core::capabilities
@@ -0,0 +1,106 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <functional>
+
+namespace opencardev::crankshaft::core::capabilities {
+
+/**
+ * In-memory index of the directories below a filesystem capability's scope.
+ *
+ * Each directory walked is remembered with its files and subdirectories, so repeat
+ * listings do not touch the disk. The owner keeps entries current by watching the
+ * directories returned by takeUnwatched() and calling invalidate() when one changes. An
+ * entry that is not watched yet (or could not be, once inotify watches run out) is only
+ * served after checking that the directory's mtime has not moved.
+ *
+ * All methods are thread-safe; walks run on worker threads while the owner invalidates
+ * entries from the GUI thread. The lock is not held while reading the disk.
+ */
+class ScopeIndex {
+  public:
+    struct Stats {
+        int directory_hits = 0;   // Directories served from the index
+        int directory_reads = 0;  // Directories listed on disk
+    };
+
+    // Receives relative paths of files; done is set on the last call. Return false to stop.
+    using Sink = std::function<bool(const QStringList& files, bool done)>;
+
+    explicit ScopeIndex(const QString& root);
+
+    QString root() const { return root_; }
+
+    /**
+     * Walk the scope depth-first and pass matching files to sink, batch_size at a time.
+     * The final, possibly short, batch is passed with done set.
+     *
+     * @param name_filters Wildcards matched case-insensitively; empty matches every file
+     * @param max_depth Levels of subdirectories to descend into; negative is unlimited
+     * @param cancelled Checked before each directory; may be null
+     * @return false if the walk was stopped by sink or cancelled
+     */
+    bool walk(const QStringList& name_filters, int max_depth, int batch_size, const Sink& sink,
+              const std::atomic_bool* cancelled = nullptr);
+
+    // Mark an absolute directory path as changed so the next walk reads it again
+    void invalidate(const QString& directory);
+    void clear();
+
+    // Directories read since the last call that still need a watch
+    QStringList takeUnwatched();
+    /**
+     * Record that a directory is now watched. An entry that changed on disk since it was
+     * read (before the watch could report it) is dropped instead.
+     */
+    void setWatched(const QString& directory);
+
+    Stats stats() const;
+
+  private:
+    struct Listing {
+        qint64 mtime_ms = 0;
+        QStringList files;
+        QStringList directories;
+        bool watched = false;
+        bool stale = false;  // Changed on disk; read again on the next walk
+    };
+
+    // Listing of an absolute directory path, from the index when current
+    Listing listing(const QString& directory);
+    static Listing readDirectory(const QString& directory);
+
+    const QString root_;
+    mutable QMutex mutex_;
+    QHash<QString, Listing> listings_;  // Absolute directory path -> contents
+    QSet<QString> unwatched_;
+    quint64 generation_ = 0;  // Bumped by every invalidation, to drop reads it overtook
+    Stats stats_;
+};
+
+}  // namespace opencardev::crankshaft::core::capabilities
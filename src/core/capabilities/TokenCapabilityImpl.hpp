@@ -28,7 +28,7 @@ class TokenCapabilityImpl : public Capability {
     QString id() const override;
     bool isValid() const override;
     QString extensionId() const override;
-    void invalidate();
+    void invalidate() override;
 
   private:
     QString extension_id_;
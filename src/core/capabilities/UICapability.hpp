@@ -43,6 +43,8 @@ class UICapability : public Capability {
     ~UICapability() override = default;
 
     QString id() const override { return "ui"; }
+    static constexpr CapabilitySlot kSlot = CapabilitySlot::UI;
+    CapabilitySlot slot() const final { return kSlot; }
 
     /**
      * UI component slot types.
@@ -40,7 +40,8 @@ void UICapabilityImpl::invalidate() {
 bool UICapabilityImpl::registerMainView(const QString& qmlPath, const QVariantMap& metadata) {
     if (!is_valid_)
         return false;
-    manager_->logCapabilityUsage(extension_id_, "ui", "registerMainView", qmlPath);
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("ui"),
+                                 QStringLiteral("registerMainView"), qmlPath);
     auto* registrar = manager_->uiRegistrar();
     if (!registrar) {
         qWarning() << "UIRegistrar not set; cannot register main view";
@@ -53,7 +54,8 @@ bool UICapabilityImpl::registerMainView(const QString& qmlPath, const QVariantMa
 bool UICapabilityImpl::registerWidget(const QString& qmlPath, const QVariantMap& metadata) {
     if (!is_valid_)
         return false;
-    manager_->logCapabilityUsage(extension_id_, "ui", "registerWidget", qmlPath);
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("ui"),
+                                 QStringLiteral("registerWidget"), qmlPath);
     auto* registrar = manager_->uiRegistrar();
     if (!registrar) {
         qWarning() << "UIRegistrar not set; cannot register widget";
@@ -69,7 +71,8 @@ void UICapabilityImpl::showNotification(const QString& title, const QString& mes
         return;
     Q_UNUSED(duration);
     Q_UNUSED(icon);
-    manager_->logCapabilityUsage(extension_id_, "ui", "showNotification",
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("ui"),
+                                 QStringLiteral("showNotification"),
                                  QString("%1: %2").arg(title, message));
 }
 
@@ -78,12 +81,14 @@ void UICapabilityImpl::updateStatusBar(const QString& itemId, const QString& tex
     if (!is_valid_)
         return;
     Q_UNUSED(icon);
-    manager_->logCapabilityUsage(extension_id_, "ui", "updateStatusBar",
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("ui"),
+                                 QStringLiteral("updateStatusBar"),
                                  QString("%1: %2").arg(itemId, text));
 }
 
 void UICapabilityImpl::unregisterComponent(const QString& componentId) {
     if (!is_valid_)
         return;
-    manager_->logCapabilityUsage(extension_id_, "ui", "unregisterComponent", componentId);
+    manager_->logCapabilityUsage(extension_id_, QStringLiteral("ui"),
+                                 QStringLiteral("unregisterComponent"), componentId);
 }
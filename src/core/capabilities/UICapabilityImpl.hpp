@@ -35,7 +35,7 @@ class UICapabilityImpl : public UICapability {
     UICapabilityImpl(const QString& extension_id, core::CapabilityManager* manager);
     QString extensionId() const override;
     bool isValid() const override;
-    void invalidate();
+    void invalidate() override;
     bool registerMainView(const QString& qmlPath, const QVariantMap& metadata) override;
     bool registerWidget(const QString& qmlPath, const QVariantMap& metadata) override;
     void showNotification(const QString& title, const QString& message, int duration,
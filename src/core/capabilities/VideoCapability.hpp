@@ -47,6 +47,8 @@ class VideoCapability : public Capability {
     ~VideoCapability() override = default;
 
     QString id() const override { return "video"; }
+    static constexpr CapabilitySlot kSlot = CapabilitySlot::Video;
+    CapabilitySlot slot() const final { return kSlot; }
 
     /**
      * Camera/video device information.
@@ -47,6 +47,8 @@ class WirelessCapability : public Capability {
     ~WirelessCapability() override = default;
 
     QString id() const override { return "wireless"; }
+    static constexpr CapabilitySlot kSlot = CapabilitySlot::Wireless;
+    CapabilitySlot slot() const final { return kSlot; }
 
     /**
      * WiFi network information.
@@ -80,6 +80,10 @@ class WirelessCapabilityImpl : public WirelessCapability {
     QString id() const override { return QStringLiteral("wireless"); }
     bool isValid() const override { return is_valid_; }
     QString extensionId() const override { return extension_id_; }
+    void invalidate() override {
+        is_valid_ = false;
+        state_callbacks_.clear();
+    }
 
   private:
     QString extension_id_;
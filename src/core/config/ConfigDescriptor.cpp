@@ -0,0 +1,250 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ConfigDescriptor.hpp"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace opencardev {
+namespace crankshaft {
+namespace core {
+namespace config {
+
+namespace {
+
+constexpr const char* kTranslationContext = "ConfigSchema";
+
+QString copiedString(std::u16string_view text) {
+    if (text.empty()) {
+        return QString();
+    }
+    // Copied: tables compiled into a plugin are unmapped when the plugin is unloaded, while
+    // the page's strings live on in the config manager, its models and emitted values
+    return QString(reinterpret_cast<const QChar*>(text.data()),
+                   static_cast<qsizetype>(text.size()));
+}
+
+QString displayString(const char* text) {
+    if (text == nullptr || *text == '\0') {
+        return QString();
+    }
+    return QCoreApplication::translate(kTranslationContext, text);
+}
+
+QVariant parseJson(std::u16string_view text) {
+    const QByteArray json = QStringView(text.data(), static_cast<qsizetype>(text.size())).toUtf8();
+    QJsonParseError error;
+    // Wrap so scalars and containers parse the same way
+    const QJsonDocument doc = QJsonDocument::fromJson("[" + json + "]", &error);
+    if (error.error != QJsonParseError::NoError) {
+        qWarning() << "Invalid JSON in config descriptor:" << error.errorString();
+        return QVariant();
+    }
+    return doc.array().first().toVariant();
+}
+
+QVariant defaultValue(const ConfigItemDescriptor& item) {
+    const QStringView text(item.default_value.data(),
+                           static_cast<qsizetype>(item.default_value.size()));
+    switch (item.default_kind) {
+    case ConfigDefaultKind::Boolean:
+        return text == u"true";
+    case ConfigDefaultKind::Integer:
+        return text.toInt();
+    case ConfigDefaultKind::Double:
+        return text.toDouble();
+    case ConfigDefaultKind::String:
+        return copiedString(item.default_value);
+    case ConfigDefaultKind::Json:
+        return parseJson(item.default_value);
+    case ConfigDefaultKind::None:
+    default:
+        return QVariant();
+    }
+}
+
+ConfigItem itemFromDescriptor(const ConfigItemDescriptor& descriptor) {
+    ConfigItem item;
+    item.key = copiedString(descriptor.key);
+    item.label = displayString(descriptor.label);
+    item.description = displayString(descriptor.description);
+    item.type = descriptor.type;
+    item.complexity = descriptor.complexity;
+    item.defaultValue = defaultValue(descriptor);
+    if (!descriptor.properties.empty()) {
+        item.properties = parseJson(descriptor.properties).toMap();
+    }
+    item.unit = copiedString(descriptor.unit);
+    item.icon = copiedString(descriptor.icon);
+    item.required = descriptor.required;
+    item.readOnly = descriptor.read_only;
+    item.isSecret = descriptor.secret;
+    return item;
+}
+
+QString schemaString(const QJsonObject& schema, const char* key) {
+    return displayString(schema.value(QLatin1String(key)).toString().toUtf8().constData());
+}
+
+ConfigItem itemFromSchema(const QJsonObject& schema) {
+    ConfigItem item;
+    item.key = schema.value("key").toString();
+    item.label = schemaString(schema, "label");
+    item.description = schemaString(schema, "description");
+    item.type = stringToConfigItemType(schema.value("type").toString());
+    item.complexity = stringToConfigComplexity(schema.value("complexity").toString());
+    item.defaultValue = schema.contains("default") ? schema.value("default").toVariant()
+                                                   : QVariant();
+    item.properties = schema.value("properties").toObject().toVariantMap();
+    item.unit = schema.value("unit").toString();
+    item.icon = schema.value("icon").toString();
+    item.required = schema.value("required").toBool();
+    item.readOnly = schema.value("readOnly").toBool();
+    item.isSecret = schema.value("secret").toBool();
+    return item;
+}
+
+// Through JSON text, so nothing is shared with the original
+QVariant detachedVariant(const QVariant& value) {
+    if (!value.isValid()) {
+        return QVariant();
+    }
+    const QByteArray json =
+        QJsonDocument(QJsonArray{QJsonValue::fromVariant(value)}).toJson(QJsonDocument::Compact);
+    return QJsonDocument::fromJson(json).array().first().toVariant();
+}
+
+QString detachedString(const QString& text) {
+    return text.isNull() ? QString() : QString(text.constData(), text.size());
+}
+
+}  // namespace
+
+ConfigPage configPageFromDescriptor(const ConfigPageDescriptor& descriptor) {
+    ConfigPage page;
+    page.domain = copiedString(descriptor.domain);
+    page.extension = copiedString(descriptor.extension);
+    page.title = displayString(descriptor.title);
+    page.description = displayString(descriptor.description);
+    page.icon = copiedString(descriptor.icon);
+    page.complexity = descriptor.complexity;
+    page.sections.reserve(static_cast<qsizetype>(descriptor.section_count));
+
+    for (std::size_t s = 0; s < descriptor.section_count; ++s) {
+        const ConfigSectionDescriptor& sectionDescriptor = descriptor.sections[s];
+        ConfigSection section;
+        section.key = copiedString(sectionDescriptor.key);
+        section.title = displayString(sectionDescriptor.title);
+        section.description = displayString(sectionDescriptor.description);
+        section.icon = copiedString(sectionDescriptor.icon);
+        section.complexity = sectionDescriptor.complexity;
+        section.items.reserve(static_cast<qsizetype>(sectionDescriptor.item_count));
+        for (std::size_t i = 0; i < sectionDescriptor.item_count; ++i) {
+            section.items.append(itemFromDescriptor(sectionDescriptor.items[i]));
+        }
+        page.sections.append(section);
+    }
+    return page;
+}
+
+bool configPageFromSchemaFile(const QString& path, ConfigPage* page) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Cannot read config schema:" << path;
+        return false;
+    }
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    const QJsonObject schema = doc.object();
+    if (error.error != QJsonParseError::NoError || schema.value("domain").toString().isEmpty() ||
+        schema.value("extension").toString().isEmpty()) {
+        qWarning() << "Invalid config schema:" << path << error.errorString();
+        return false;
+    }
+
+    page->domain = schema.value("domain").toString();
+    page->extension = schema.value("extension").toString();
+    page->title = schemaString(schema, "title");
+    page->description = schemaString(schema, "description");
+    page->icon = schema.value("icon").toString();
+    page->complexity = stringToConfigComplexity(schema.value("complexity").toString());
+    page->sections.clear();
+    for (const QJsonValue& sectionValue : schema.value("sections").toArray()) {
+        const QJsonObject sectionSchema = sectionValue.toObject();
+        ConfigSection section;
+        section.key = sectionSchema.value("key").toString();
+        section.title = schemaString(sectionSchema, "title");
+        section.description = schemaString(sectionSchema, "description");
+        section.icon = sectionSchema.value("icon").toString();
+        section.complexity =
+            stringToConfigComplexity(sectionSchema.value("complexity").toString());
+        for (const QJsonValue& itemValue : sectionSchema.value("items").toArray()) {
+            section.items.append(itemFromSchema(itemValue.toObject()));
+        }
+        page->sections.append(section);
+    }
+    return true;
+}
+
+ConfigPage detachedConfigPage(const ConfigPage& page) {
+    ConfigPage copy;
+    copy.domain = detachedString(page.domain);
+    copy.extension = detachedString(page.extension);
+    copy.title = detachedString(page.title);
+    copy.description = detachedString(page.description);
+    copy.icon = detachedString(page.icon);
+    copy.complexity = page.complexity;
+    for (const ConfigSection& section : page.sections) {
+        ConfigSection sectionCopy;
+        sectionCopy.key = detachedString(section.key);
+        sectionCopy.title = detachedString(section.title);
+        sectionCopy.description = detachedString(section.description);
+        sectionCopy.icon = detachedString(section.icon);
+        sectionCopy.complexity = section.complexity;
+        for (const ConfigItem& item : section.items) {
+            ConfigItem itemCopy;
+            itemCopy.key = detachedString(item.key);
+            itemCopy.label = detachedString(item.label);
+            itemCopy.description = detachedString(item.description);
+            itemCopy.type = item.type;
+            itemCopy.defaultValue = detachedVariant(item.defaultValue);
+            itemCopy.currentValue = detachedVariant(item.currentValue);
+            itemCopy.complexity = item.complexity;
+            itemCopy.properties = detachedVariant(item.properties).toMap();
+            itemCopy.required = item.required;
+            itemCopy.validator = detachedString(item.validator);
+            itemCopy.icon = detachedString(item.icon);
+            itemCopy.unit = detachedString(item.unit);
+            itemCopy.readOnly = item.readOnly;
+            itemCopy.isSecret = item.isSecret;
+            sectionCopy.items.append(itemCopy);
+        }
+        copy.sections.append(sectionCopy);
+    }
+    return copy;
+}
+
+}  // namespace config
+}  // namespace core
+}  // namespace crankshaft
+}  // namespace opencardev
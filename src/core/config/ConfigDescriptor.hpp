@@ -0,0 +1,99 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include "ConfigTypes.hpp"
+
+namespace opencardev {
+namespace crankshaft {
+namespace core {
+namespace config {
+
+/**
+ * Static config page descriptors.
+ *
+ * Tables of these are generated at build time from JSON schemas by
+ * cmake/GenerateConfigSchema.cmake (see crankshaft_add_config_schema()). Identifiers are
+ * UTF-16 literals, copied into the page when it is built; display text is a UTF-8 literal
+ * looked up through QCoreApplication::translate() in the "ConfigSchema" context.
+ */
+
+// JSON type of an item's default value, resolved by the generator
+enum class ConfigDefaultKind { None, Boolean, Integer, Double, String, Json };
+
+struct ConfigItemDescriptor {
+    std::u16string_view key;
+    const char* label;
+    const char* description;
+    ConfigItemType type;
+    ConfigComplexity complexity;
+    ConfigDefaultKind default_kind;
+    std::u16string_view default_value;  // Unquoted for strings, JSON text otherwise
+    std::u16string_view properties;     // JSON object text, empty when absent
+    std::u16string_view unit;
+    std::u16string_view icon;
+    bool required;
+    bool read_only;
+    bool secret;
+};
+
+struct ConfigSectionDescriptor {
+    std::u16string_view key;
+    const char* title;
+    const char* description;
+    std::u16string_view icon;
+    ConfigComplexity complexity;
+    const ConfigItemDescriptor* items;
+    std::size_t item_count;
+};
+
+struct ConfigPageDescriptor {
+    std::u16string_view domain;
+    std::u16string_view extension;
+    const char* title;
+    const char* description;
+    std::u16string_view icon;
+    ConfigComplexity complexity;
+    const ConfigSectionDescriptor* sections;
+    std::size_t section_count;
+};
+
+// Build a runtime page; nothing in it references the descriptor, so pages built from a
+// plugin's tables stay valid after the plugin is unloaded
+ConfigPage configPageFromDescriptor(const ConfigPageDescriptor& descriptor);
+
+/**
+ * Build a page at runtime from a JSON schema in the layout read by
+ * cmake/GenerateConfigSchema.cmake, translated the same way as a descriptor. Used for the
+ * settings of an extension whose library is not loaded. Returns false with a warning if
+ * the file cannot be read or is not a schema.
+ */
+bool configPageFromSchemaFile(const QString& path, ConfigPage* page);
+
+// Copy of a page that shares no string data with the original, so it stays valid after
+// the library that built the original is unloaded
+ConfigPage detachedConfigPage(const ConfigPage& page);
+
+}  // namespace config
+}  // namespace core
+}  // namespace crankshaft
+}  // namespace opencardev
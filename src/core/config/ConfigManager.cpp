@@ -18,23 +18,35 @@
  */
 
 #include "ConfigManager.hpp"
+#include <QCryptographicHash>
 #include <QDataStream>
 #include <QDateTime>
 #include <QDebug>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QStandardPaths>
+#include <QTimer>
 
 namespace opencardev {
 namespace crankshaft {
 namespace core {
 namespace config {
 
+namespace {
+// Provisioning tools often write a file in several steps; wait for them to settle
+constexpr int kReloadDebounceMs = 250;
+}  // namespace
+
 ConfigManager::ConfigManager(QObject* parent)
-    : QObject(parent), current_complexity_(ConfigComplexity::Basic) {}
+    : QObject(parent),
+      current_complexity_(ConfigComplexity::Basic),
+      watcher_(nullptr),
+      reload_timer_(nullptr) {}
 
 ConfigManager::~ConfigManager() {
     save();
@@ -54,6 +66,7 @@ void ConfigManager::registerConfigPage(const ConfigPage& page) {
 void ConfigManager::unregisterConfigPage(const QString& domain, const QString& extension) {
     QString key = makeKey(domain, extension);
     if (config_pages_.remove(key)) {
+        file_stamps_.remove(getConfigFilePath(domain, extension));
         qInfo() << "Unregistered config page:" << key;
         emit configPageUnregistered(domain, extension);
     }
@@ -227,6 +240,8 @@ bool ConfigManager::load() {
             allSuccess = false;
         }
     }
+    // Files created since the watcher was set up are watched from now on
+    watchPageFiles();
     return allSuccess;
 }
 
@@ -266,8 +281,10 @@ bool ConfigManager::saveExtensionConfig(const QString& domain, const QString& ex
         return false;
     }
 
-    file.write(doc.toJson());
+    const QByteArray contents = doc.toJson();
+    file.write(contents);
     file.close();
+    recordFileStamp(filePath, contents);
 
     qDebug() << "Saved config:" << filePath;
     return true;
@@ -286,9 +303,11 @@ bool ConfigManager::loadExtensionConfig(const QString& domain, const QString& ex
         return false;  // Not an error, just no saved config
     }
 
-    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    const QByteArray contents = file.readAll();
     file.close();
+    recordFileStamp(filePath, contents);
 
+    QJsonDocument doc = QJsonDocument::fromJson(contents);
     if (!doc.isObject()) {
         qWarning() << "Invalid config file:" << filePath;
         return false;
@@ -327,9 +346,172 @@ ConfigComplexity ConfigManager::getComplexityLevel() const {
     return current_complexity_;
 }
 
-QString ConfigManager::getConfigFilePath(const QString& domain, const QString& extension) const {
+void ConfigManager::setFileWatchingEnabled(bool enabled) {
+    if (enabled == (watcher_ != nullptr)) {
+        return;
+    }
+
+    if (!enabled) {
+        delete watcher_;
+        watcher_ = nullptr;
+        if (reload_timer_) {
+            reload_timer_->stop();
+        }
+        qInfo() << "Stopped watching config directory";
+        return;
+    }
+
+    const QString configDir = getConfigDirectory();
+    QDir().mkpath(configDir);
+
+    if (!reload_timer_) {
+        reload_timer_ = new QTimer(this);
+        reload_timer_->setSingleShot(true);
+        reload_timer_->setInterval(kReloadDebounceMs);
+        connect(reload_timer_, &QTimer::timeout, this, [this]() { reloadChangedPages(); });
+    }
+
+    watcher_ = new QFileSystemWatcher(this);
+    // Directory events catch new files and atomic replace-by-rename; file events catch
+    // in-place edits. Both just restart the debounce timer.
+    connect(watcher_, &QFileSystemWatcher::directoryChanged, reload_timer_,
+            qOverload<>(&QTimer::start));
+    connect(watcher_, &QFileSystemWatcher::fileChanged, reload_timer_,
+            qOverload<>(&QTimer::start));
+    if (!watcher_->addPath(configDir)) {
+        qWarning() << "Failed to watch config directory:" << configDir;
+    }
+    watchPageFiles();
+
+    qInfo() << "Watching config directory for external changes:" << configDir;
+}
+
+bool ConfigManager::isFileWatchingEnabled() const {
+    return watcher_ != nullptr;
+}
+
+QStringList ConfigManager::reloadChangedPages() {
+    QStringList changedPaths;
+    for (const QString& pageKey : config_pages_.keys()) {
+        changedPaths << reloadPageFromDisk(pageKey);
+    }
+
+    // Replaced files drop out of the watcher and new files are not watched yet
+    watchPageFiles();
+
+    if (!changedPaths.isEmpty()) {
+        qInfo() << "Reloaded" << changedPaths.size() << "externally changed config values";
+        emit configReloaded(changedPaths);
+    }
+    return changedPaths;
+}
+
+QStringList ConfigManager::reloadPageFromDisk(const QString& pageKey) {
+    QStringList changedPaths;
+    auto pageIt = config_pages_.find(pageKey);
+    if (pageIt == config_pages_.end()) {
+        return changedPaths;
+    }
+
+    ConfigPage& page = pageIt.value();
+    const QString filePath = getConfigFilePath(page.domain, page.extension);
+    const QFileInfo info(filePath);
+    if (!info.exists()) {
+        return changedPaths;
+    }
+
+    // Cheap check first: same size and mtime as our last read/write means nothing to do
+    const FileStamp stamp = file_stamps_.value(filePath);
+    if (stamp.size == info.size() && stamp.modified == info.lastModified().toMSecsSinceEpoch()) {
+        return changedPaths;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to read changed config:" << filePath;
+        return changedPaths;
+    }
+    const QByteArray contents = file.readAll();
+    file.close();
+
+    const QByteArray previousDigest = stamp.digest;
+    recordFileStamp(filePath, contents);
+    if (file_stamps_.value(filePath).digest == previousDigest) {
+        return changedPaths;  // Touched or rewritten with identical contents
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(contents, &parseError);
+    if (!doc.isObject()) {
+        qWarning() << "Ignoring invalid config file:" << filePath << parseError.errorString();
+        return changedPaths;
+    }
+
+    const QJsonObject sectionsObj = doc.object().value("config").toObject();
+    for (ConfigSection& section : page.sections) {
+        if (!sectionsObj.contains(section.key)) {
+            continue;
+        }
+
+        const QJsonObject itemsObj = sectionsObj.value(section.key).toObject();
+        for (ConfigItem& item : section.items) {
+            if (!itemsObj.contains(item.key)) {
+                continue;
+            }
+
+            // Compare in JSON form so e.g. QStringList and QVariantList are treated alike
+            const QJsonValue newValue = itemsObj.value(item.key);
+            const QVariant oldValue =
+                item.currentValue.isValid() ? item.currentValue : item.defaultValue;
+            if (QJsonValue::fromVariant(oldValue) == newValue) {
+                continue;
+            }
+
+            item.currentValue = newValue.toVariant();
+            changedPaths << pageKey + "." + section.key + "." + item.key;
+            emit configValueChanged(page.domain, page.extension, section.key, item.key,
+                                    item.currentValue);
+        }
+    }
+
+    qDebug() << "Reloaded config:" << filePath << "changed keys:" << changedPaths.size();
+    return changedPaths;
+}
+
+void ConfigManager::recordFileStamp(const QString& filePath, const QByteArray& contents) {
+    const QFileInfo info(filePath);
+    FileStamp& stamp = file_stamps_[filePath];
+    stamp.size = info.size();
+    stamp.modified = info.lastModified().toMSecsSinceEpoch();
+    stamp.digest = QCryptographicHash::hash(contents, QCryptographicHash::Md5);
+}
+
+void ConfigManager::watchPageFiles() {
+    if (!watcher_) {
+        return;
+    }
+
+    const QDir configDir(getConfigDirectory());
+    const QStringList watched = watcher_->files();
+    QStringList toWatch;
+    for (const QString& name : configDir.entryList(QStringList{"*.json"}, QDir::Files)) {
+        const QString filePath = configDir.filePath(name);
+        if (!watched.contains(filePath)) {
+            toWatch << filePath;
+        }
+    }
+    if (!toWatch.isEmpty()) {
+        watcher_->addPaths(toWatch);
+    }
+}
+
+QString ConfigManager::getConfigDirectory() const {
     QString configPath = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation);
-    return configPath + "/CrankshaftReborn/config/" + domain + "." + extension + ".json";
+    return configPath + "/CrankshaftReborn/config";
+}
+
+QString ConfigManager::getConfigFilePath(const QString& domain, const QString& extension) const {
+    return getConfigDirectory() + "/" + domain + "." + extension + ".json";
 }
 
 QString ConfigManager::makeKey(const QString& domain, const QString& extension) const {
@@ -20,12 +20,17 @@
 #ifndef OPENCARDEV_CRANKSHAFT_CORE_CONFIG_CONFIGMANAGER_HPP
 #define OPENCARDEV_CRANKSHAFT_CORE_CONFIG_CONFIGMANAGER_HPP
 
+#include <QByteArray>
 #include <QMap>
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QVariant>
 #include "ConfigTypes.hpp"
 
+class QFileSystemWatcher;
+class QTimer;
+
 namespace opencardev {
 namespace crankshaft {
 namespace core {
@@ -71,6 +76,15 @@ class ConfigManager : public QObject {
     bool saveExtensionConfig(const QString& domain, const QString& extension);
     bool loadExtensionConfig(const QString& domain, const QString& extension);
 
+    // External change monitoring
+    // Watches the config directory and reloads pages whose files were changed by
+    // another process (e.g. provisioning scripts). Writes made by this manager are ignored.
+    void setFileWatchingEnabled(bool enabled);
+    bool isFileWatchingEnabled() const;
+    // Re-read only the page files that changed on disk since they were last read or
+    // written, apply the differences and return the full paths of the keys that changed.
+    QStringList reloadChangedPages();
+
     // Export/Import
     QVariantMap exportConfig(bool maskSecrets = true) const;
     QVariantMap exportConfig(const QStringList& domainExtensions, bool maskSecrets = true) const;
@@ -99,8 +113,18 @@ class ConfigManager : public QObject {
     void configPageRegistered(const QString& domain, const QString& extension);
     void configPageUnregistered(const QString& domain, const QString& extension);
     void complexityLevelChanged(ConfigComplexity level);
+    // Batched notification after an external reload; paths are "domain.extension.section.key"
+    void configReloaded(const QStringList& changedPaths);
 
   private:
+    // Snapshot of a config file as last read or written by this manager
+    struct FileStamp {
+        qint64 size = -1;
+        qint64 modified = 0;
+        QByteArray digest;
+    };
+
+    QString getConfigDirectory() const;
     QString getConfigFilePath(const QString& domain, const QString& extension) const;
     QString makeKey(const QString& domain, const QString& extension) const;
     bool parseFullPath(const QString& fullPath, QString& domain, QString& extension,
@@ -112,8 +136,15 @@ class ConfigManager : public QObject {
     bool compressToFile(const QByteArray& data, const QString& filePath);
     QByteArray decompressFromFile(const QString& filePath, bool& success);
 
+    QStringList reloadPageFromDisk(const QString& pageKey);
+    void recordFileStamp(const QString& filePath, const QByteArray& contents);
+    void watchPageFiles();
+
     QMap<QString, ConfigPage> config_pages_;  // Key: "domain.extension"
     ConfigComplexity current_complexity_;
+    QMap<QString, FileStamp> file_stamps_;  // Key: config file path
+    QFileSystemWatcher* watcher_;
+    QTimer* reload_timer_;
 };
 
 }  // namespace config
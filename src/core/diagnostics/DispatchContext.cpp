@@ -0,0 +1,155 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DispatchContext.hpp"
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <chrono>
+
+namespace opencardev::crankshaft::core::diagnostics {
+
+namespace {
+
+thread_local bool t_is_main_thread = false;
+
+// Written by the main thread, read by the watchdog while the main thread is stalled
+struct MainThreadState {
+    QMutex mutex;
+    QList<DispatchFrame> frames;
+    DispatchFrame last_capability_call;
+};
+
+MainThreadState& mainThread() {
+    static MainThreadState state;
+    return state;
+}
+
+struct ModuleRegistry {
+    QMutex mutex;
+    QHash<QString, QString> owners;  // Canonical library path -> extension id
+};
+
+ModuleRegistry& modules() {
+    static ModuleRegistry registry;
+    return registry;
+}
+
+QString canonicalPath(const QString& path) {
+    const QString canonical = QFileInfo(path).canonicalFilePath();
+    return canonical.isEmpty() ? path : canonical;
+}
+
+}  // namespace
+
+QVariantMap DispatchFrame::toMap(qint64 now_ns) const {
+    QVariantMap map;
+    map["extension_id"] = extension_id;
+    map["operation"] = operation;
+    map["detail"] = detail;
+    map["elapsed_ms"] = double(now_ns - since_ns) / 1e6;
+    return map;
+}
+
+DispatchScope::DispatchScope(const QString& extension_id, const QString& operation,
+                             const QString& detail)
+    : published_(t_is_main_thread) {
+    if (!published_) {
+        return;
+    }
+    MainThreadState& state = mainThread();
+    QMutexLocker locker(&state.mutex);
+    state.frames.append({extension_id, operation, detail, DispatchContext::nowNs()});
+}
+
+DispatchScope::~DispatchScope() {
+    if (!published_) {
+        return;
+    }
+    MainThreadState& state = mainThread();
+    QMutexLocker locker(&state.mutex);
+    state.frames.removeLast();
+}
+
+void DispatchContext::markMainThread() {
+    t_is_main_thread = true;
+}
+
+bool DispatchContext::isMainThread() {
+    return t_is_main_thread;
+}
+
+QList<DispatchFrame> DispatchContext::mainThreadFrames() {
+    MainThreadState& state = mainThread();
+    QMutexLocker locker(&state.mutex);
+    return state.frames;
+}
+
+void DispatchContext::recordCapabilityCall(const QString& extension_id,
+                                           const QString& capability, const QString& action) {
+    if (!t_is_main_thread) {
+        return;
+    }
+    MainThreadState& state = mainThread();
+    QMutexLocker locker(&state.mutex);
+    state.last_capability_call = {extension_id, capability, action, nowNs()};
+}
+
+QVariantMap DispatchContext::lastCapabilityCall() {
+    MainThreadState& state = mainThread();
+    QMutexLocker locker(&state.mutex);
+    const DispatchFrame& call = state.last_capability_call;
+    if (call.since_ns == 0) {
+        return {};
+    }
+    QVariantMap map;
+    map["extension_id"] = call.extension_id;
+    map["capability"] = call.operation;
+    map["action"] = call.detail;
+    map["age_ms"] = double(nowNs() - call.since_ns) / 1e6;
+    return map;
+}
+
+void DispatchContext::registerModule(const QString& library_path, const QString& extension_id) {
+    ModuleRegistry& registry = modules();
+    QMutexLocker locker(&registry.mutex);
+    registry.owners.insert(canonicalPath(library_path), extension_id);
+}
+
+void DispatchContext::unregisterModule(const QString& library_path) {
+    ModuleRegistry& registry = modules();
+    QMutexLocker locker(&registry.mutex);
+    registry.owners.remove(canonicalPath(library_path));
+}
+
+QString DispatchContext::moduleOwner(const QString& library_path) {
+    const QString path = canonicalPath(library_path);
+    ModuleRegistry& registry = modules();
+    QMutexLocker locker(&registry.mutex);
+    return registry.owners.value(path);
+}
+
+qint64 DispatchContext::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+}  // namespace opencardev::crankshaft::core::diagnostics
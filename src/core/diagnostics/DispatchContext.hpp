@@ -0,0 +1,85 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QVariantMap>
+
+namespace opencardev::crankshaft::core::diagnostics {
+
+// An extension callback, lifecycle method or event dispatch in progress on a thread
+struct DispatchFrame {
+    QString extension_id;  // Empty for core work such as an event bus dispatch
+    QString operation;     // "event", "event callback", "initialize", "start", ...
+    QString detail;        // Event name or pattern, capability action, ...
+    qint64 since_ns = 0;   // Monotonic clock when the frame was entered
+
+    QVariantMap toMap(qint64 now_ns) const;
+};
+
+/**
+ * Records what the current thread is running on behalf of an extension for the
+ * enclosing block, so the stall watchdog can tell who blocked the GUI thread.
+ *
+ * Scopes nest per thread. Only the main thread's frames are published; elsewhere a
+ * scope costs a thread-local check.
+ */
+class DispatchScope {
+  public:
+    DispatchScope(const QString& extension_id, const QString& operation,
+                  const QString& detail = QString());
+    ~DispatchScope();
+
+    DispatchScope(const DispatchScope&) = delete;
+    DispatchScope& operator=(const DispatchScope&) = delete;
+
+  private:
+    bool published_;
+};
+
+/**
+ * What the main thread is doing, readable from any thread: open dispatch frames, the
+ * last capability call, and which extension owns a loaded plugin library.
+ */
+class DispatchContext {
+  public:
+    // Must be called on the main thread before its frames are published
+    static void markMainThread();
+    static bool isMainThread();
+
+    // Frames open on the main thread, outermost first
+    static QList<DispatchFrame> mainThreadFrames();
+
+    // Remember the latest capability call made on the main thread
+    static void recordCapabilityCall(const QString& extension_id, const QString& capability,
+                                     const QString& action);
+    // { extension_id, capability, action, age_ms }; empty if none was made
+    static QVariantMap lastCapabilityCall();
+
+    // Shared library that backs an extension, for attributing sampled stack frames
+    static void registerModule(const QString& library_path, const QString& extension_id);
+    static void unregisterModule(const QString& library_path);
+    static QString moduleOwner(const QString& library_path);
+
+    static qint64 nowNs();
+};
+
+}  // namespace opencardev::crankshaft::core::diagnostics
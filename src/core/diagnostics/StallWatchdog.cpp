@@ -0,0 +1,359 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StallWatchdog.hpp"
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutexLocker>
+#include <chrono>
+#include "../events/event_bus.hpp"
+#include "DispatchContext.hpp"
+
+#if defined(Q_OS_LINUX) && defined(__GLIBC__)
+#define CRANKSHAFT_SAMPLE_STACKS 1
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+#include <cerrno>
+#include <cstdlib>
+#endif
+
+namespace opencardev::crankshaft::core::diagnostics {
+
+namespace {
+
+#ifdef CRANKSHAFT_SAMPLE_STACKS
+
+constexpr int kMaxStackFrames = 48;
+constexpr int kStackSampleTimeoutMs = 50;
+// The signal handler and the kernel's signal trampoline
+constexpr int kHandlerFrames = 2;
+
+struct StackSample {
+    void* frames[kMaxStackFrames];
+    std::atomic<int> depth{0};
+    std::atomic<bool> ready{false};
+};
+
+StackSample g_sample;
+pthread_t g_main_thread;
+
+// Real-time signals are queued and not used by Qt or glibc above SIGRTMIN
+int sampleSignal() {
+    return SIGRTMIN + 4;
+}
+
+void sampleStack(int) {
+    const int saved_errno = errno;
+    g_sample.depth.store(backtrace(g_sample.frames, kMaxStackFrames), std::memory_order_relaxed);
+    g_sample.ready.store(true, std::memory_order_release);
+    errno = saved_errno;
+}
+
+// Called on the GUI thread, the one later samples interrupt
+void installStackSampler() {
+    static bool installed = false;
+    g_main_thread = pthread_self();
+    if (installed) {
+        return;
+    }
+    // The first backtrace() loads libgcc; do that here rather than in the handler
+    void* prime[1];
+    backtrace(prime, 1);
+
+    struct sigaction action {};
+    action.sa_handler = sampleStack;
+    sigemptyset(&action.sa_mask);
+    // Blocking calls interrupted by the sample resume where possible; those the kernel
+    // never restarts (poll, nanosleep, timed waits) return EINTR instead
+    action.sa_flags = SA_RESTART;
+    installed = sigaction(sampleSignal(), &action, nullptr) == 0;
+}
+
+QString symbolName(const char* mangled) {
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+    const QString name = QString::fromLatin1(status == 0 ? demangled : mangled);
+    std::free(demangled);
+    return name;
+}
+
+/**
+ * Interrupt the GUI thread and resolve its stack, innermost first, as
+ * "symbol [library]". owner is set to the extension owning the innermost frame in an
+ * extension plugin library.
+ */
+QVariantList sampleMainThreadStack(QString* owner) {
+    g_sample.ready.store(false, std::memory_order_relaxed);
+    if (pthread_kill(g_main_thread, sampleSignal()) != 0) {
+        return {};
+    }
+    QElapsedTimer clock;
+    clock.start();
+    while (!g_sample.ready.load(std::memory_order_acquire)) {
+        if (clock.elapsed() > kStackSampleTimeoutMs) {
+            return {};
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    QVariantList stack;
+    QHash<QString, QString> owners;
+    const int depth = g_sample.depth.load(std::memory_order_relaxed);
+    for (int i = kHandlerFrames; i < depth; ++i) {
+        Dl_info info{};
+        if (dladdr(g_sample.frames[i], &info) == 0 || !info.dli_fname) {
+            stack.append(QString("0x%1").arg(quintptr(g_sample.frames[i]), 0, 16));
+            continue;
+        }
+        const QString module = QString::fromLocal8Bit(info.dli_fname);
+        if (!owners.contains(module)) {
+            owners.insert(module, DispatchContext::moduleOwner(module));
+        }
+        const QString module_owner = owners.value(module);
+        if (owner->isEmpty()) {
+            *owner = module_owner;
+        }
+        const QString symbol = info.dli_sname ? symbolName(info.dli_sname) : QString("?");
+        stack.append(QString("%1 [%2]").arg(symbol, module_owner.isEmpty()
+                                                        ? QFileInfo(module).fileName()
+                                                        : module_owner));
+    }
+    return stack;
+}
+
+#endif  // CRANKSHAFT_SAMPLE_STACKS
+
+}  // namespace
+
+StallWatchdog::StallWatchdog(EventBus* event_bus, QObject* parent)
+    : QObject(parent),
+      event_bus_(event_bus),
+      threshold_ms_(0),
+      interval_ms_(0),
+      last_beat_ns_(0),
+      stack_sampling_(false),
+      stop_requested_(false),
+      pending_beat_ns_(0) {
+    heartbeat_timer_.setTimerType(Qt::PreciseTimer);
+    connect(&heartbeat_timer_, &QTimer::timeout, this, &StallWatchdog::heartbeat);
+}
+
+StallWatchdog::~StallWatchdog() {
+    stop();
+}
+
+void StallWatchdog::start(int threshold_ms) {
+    stop();
+    if (threshold_ms <= 0) {
+        qInfo() << "GUI stall watchdog disabled";
+        return;
+    }
+
+    threshold_ms_ = threshold_ms;
+    // Beat often enough that a late beat is noticed well within the threshold
+    interval_ms_ = qBound(10, threshold_ms / 2, 100);
+    DispatchContext::markMainThread();
+#ifdef CRANKSHAFT_SAMPLE_STACKS
+    if (stackSampling()) {
+        installStackSampler();
+    }
+#endif
+    last_beat_ns_.store(0, std::memory_order_release);
+    stop_requested_ = false;
+    heartbeat_timer_.start(interval_ms_);
+    thread_ = std::thread([this]() { watch(); });
+    qInfo() << "GUI stall watchdog: reporting stalls over" << threshold_ms << "ms";
+}
+
+void StallWatchdog::stop() {
+    heartbeat_timer_.stop();
+    if (!thread_.joinable()) {
+        return;
+    }
+    {
+        QMutexLocker locker(&wait_mutex_);
+        stop_requested_ = true;
+    }
+    wake_.wakeAll();
+    thread_.join();
+}
+
+void StallWatchdog::setStackSampling(bool enabled) {
+#ifdef CRANKSHAFT_SAMPLE_STACKS
+    if (enabled && isRunning()) {
+        installStackSampler();
+    }
+#else
+    enabled = false;
+#endif
+    stack_sampling_.store(enabled, std::memory_order_relaxed);
+}
+
+QVariantList StallWatchdog::recentStalls() const {
+    QMutexLocker locker(&mutex_);
+    QVariantList stalls;
+    stalls.reserve(reports_.size());
+    for (const QVariantMap& report : reports_) {
+        stalls.append(report);
+    }
+    return stalls;
+}
+
+void StallWatchdog::heartbeat() {
+    const qint64 now_ns = DispatchContext::nowNs();
+    const qint64 previous_ns = last_beat_ns_.exchange(now_ns, std::memory_order_acq_rel);
+
+    QVariantMap report;
+    {
+        QMutexLocker locker(&mutex_);
+        if (pending_.isEmpty()) {
+            return;
+        }
+        // A capture racing with an earlier beat belongs to a stall that already ended
+        const bool current = pending_beat_ns_ == previous_ns;
+        report = pending_;
+        pending_.clear();
+        if (!current) {
+            return;
+        }
+        const double duration_ms = double(now_ns - previous_ns) / 1e6 - interval_ms_;
+        report["duration_ms"] = duration_ms;
+        reports_.prepend(report);
+        while (reports_.size() > kMaxReports) {
+            reports_.removeLast();
+        }
+    }
+
+    const QString blame = report.value("blame").toString();
+    qWarning().noquote() << QString("GUI thread stalled for %1 ms%2")
+                                .arg(report.value("duration_ms").toDouble(), 0, 'f', 0)
+                                .arg(blame.isEmpty()
+                                         ? QString(" (no extension identified)")
+                                         : QString(" in %1: %2 %3")
+                                               .arg(blame, report.value("operation").toString(),
+                                                    report.value("detail").toString()));
+    emit stallDetected(report);
+    if (event_bus_) {
+        event_bus_->publish(QStringLiteral("core.diagnostics.stall"), report);
+    }
+}
+
+void StallWatchdog::watch() {
+    qint64 captured_beat_ns = 0;
+    QMutexLocker locker(&wait_mutex_);
+    while (!stop_requested_) {
+        wake_.wait(&wait_mutex_, interval_ms_);
+        if (stop_requested_) {
+            break;
+        }
+        const qint64 beat_ns = last_beat_ns_.load(std::memory_order_acquire);
+        if (beat_ns == 0 || beat_ns == captured_beat_ns) {
+            continue;
+        }
+        const qint64 late_ns = DispatchContext::nowNs() - beat_ns - qint64(interval_ms_) * 1000000;
+        if (late_ns < qint64(threshold_ms_) * 1000000) {
+            continue;
+        }
+
+        // Once per stall, while the GUI thread is still inside the culprit
+        captured_beat_ns = beat_ns;
+        locker.unlock();
+        const QVariantMap report = captureStall(late_ns);
+        {
+            QMutexLocker pending_locker(&mutex_);
+            pending_ = report;
+            pending_beat_ns_ = beat_ns;
+        }
+        locker.relock();
+    }
+}
+
+QVariantMap StallWatchdog::captureStall(qint64 late_ns) {
+    const qint64 now_ns = DispatchContext::nowNs();
+    QString blame;
+    QString source;
+    QString operation;
+    QString detail;
+
+    // Innermost extension frame: the callback or lifecycle call that is still running
+    const QList<DispatchFrame> open = DispatchContext::mainThreadFrames();
+    QVariantList frames;
+    for (const DispatchFrame& frame : open) {
+        frames.append(frame.toMap(now_ns));
+    }
+    for (auto it = open.crbegin(); it != open.crend(); ++it) {
+        if (!it->extension_id.isEmpty()) {
+            blame = it->extension_id;
+            source = "dispatch";
+            operation = it->operation;
+            detail = it->detail;
+            break;
+        }
+    }
+    if (operation.isEmpty() && !open.isEmpty()) {
+        operation = open.last().operation;
+        detail = open.last().detail;
+    }
+
+    // Extension code running outside any dispatch frame, e.g. from its own timer
+    QVariantList stack;
+#ifdef CRANKSHAFT_SAMPLE_STACKS
+    if (stackSampling()) {
+        QString stack_owner;
+        stack = sampleMainThreadStack(&stack_owner);
+        if (blame.isEmpty() && !stack_owner.isEmpty()) {
+            blame = stack_owner;
+            source = "stack";
+        }
+    }
+#endif
+
+    // A capability call made since the last beat happened during the stall
+    const QVariantMap call = DispatchContext::lastCapabilityCall();
+    const double stalled_ms = double(late_ns) / 1e6 + interval_ms_;
+    if (blame.isEmpty() && !call.isEmpty() && call.value("age_ms").toDouble() <= stalled_ms) {
+        blame = call.value("extension_id").toString();
+        source = "capability call";
+        operation = call.value("capability").toString();
+        detail = call.value("action").toString();
+    }
+
+    QVariantMap report;
+    report["started_at"] = QDateTime::currentMSecsSinceEpoch() - qint64(stalled_ms);
+    report["blame"] = blame;
+    report["blame_source"] = source;
+    report["operation"] = operation;
+    report["detail"] = detail;
+    report["frames"] = frames;
+    report["last_capability_call"] = call;
+    report["stack"] = stack;
+
+    qWarning().noquote() << QString("GUI thread stalled for over %1 ms%2")
+                                .arg(late_ns / 1000000)
+                                .arg(blame.isEmpty() ? QString() : " in " + blame);
+    return report;
+}
+
+}  // namespace opencardev::crankshaft::core::diagnostics
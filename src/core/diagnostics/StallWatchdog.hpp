@@ -0,0 +1,115 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QTimer>
+#include <QVariantList>
+#include <QVariantMap>
+#include <QWaitCondition>
+#include <atomic>
+#include <thread>
+
+namespace opencardev::crankshaft::core {
+class EventBus;
+}
+
+namespace opencardev::crankshaft::core::diagnostics {
+
+/**
+ * Detects stalls of the GUI thread's event loop and blames them on an extension.
+ *
+ * The GUI thread beats a heartbeat timer; a watchdog thread notices when a beat is more
+ * than the threshold late and, while the stall is still in progress, captures:
+ * - the open DispatchScope frames (event dispatch, extension callback or lifecycle call),
+ * - the last capability call made on the GUI thread,
+ * - on Linux, when stack sampling is enabled, a sampled stack of the GUI thread, with frames
+ *   in extension plugin libraries mapped to their extension.
+ *
+ * When the loop runs again the report is completed with the stall's duration, logged,
+ * emitted and published as "core.diagnostics.stall". Time before the event loop first
+ * runs (startup) is not reported.
+ */
+class StallWatchdog : public QObject {
+    Q_OBJECT
+
+  public:
+    static constexpr int kMaxReports = 20;
+
+    explicit StallWatchdog(EventBus* event_bus, QObject* parent = nullptr);
+    ~StallWatchdog() override;
+
+    /**
+     * Watch the calling thread, which must be the GUI thread. Restarts with the new
+     * threshold when already running; a threshold <= 0 stops watching.
+     */
+    void start(int threshold_ms);
+    void stop();
+    bool isRunning() const { return thread_.joinable(); }
+    int thresholdMs() const { return threshold_ms_; }
+
+    /**
+     * Sample the GUI thread's stack when a stall is detected (Linux with glibc only; off by
+     * default). Sampling interrupts the GUI thread with a real-time signal, so a blocking
+     * call it is in may fail with EINTR where SA_RESTART does not apply (poll, nanosleep,
+     * timed waits); and backtrace() is not async-signal-safe, so a sample taken while the
+     * thread holds the loader or allocator lock could deadlock. Meant for development; call on
+     * the GUI thread.
+     */
+    void setStackSampling(bool enabled);
+    bool stackSampling() const { return stack_sampling_.load(std::memory_order_relaxed); }
+
+    /**
+     * Completed reports, newest first: { started_at, duration_ms, blame, operation,
+     * detail, frames, last_capability_call, stack }. blame is the extension held
+     * responsible, or empty when none could be identified.
+     */
+    QVariantList recentStalls() const;
+
+  signals:
+    void stallDetected(const QVariantMap& report);
+
+  private:
+    void heartbeat();
+    void watch();
+    // Runs on the watchdog thread while the GUI thread is stalled
+    QVariantMap captureStall(qint64 late_ns);
+
+    EventBus* event_bus_;
+    QTimer heartbeat_timer_;
+    int threshold_ms_;
+    int interval_ms_;
+    std::atomic<qint64> last_beat_ns_;  // 0 until the event loop first runs
+    std::atomic<bool> stack_sampling_;
+
+    std::thread thread_;
+    QMutex wait_mutex_;
+    QWaitCondition wake_;
+    bool stop_requested_;
+
+    mutable QMutex mutex_;     // Guards the members below
+    QVariantMap pending_;      // Captured during the stall, completed by the next beat
+    qint64 pending_beat_ns_;   // last_beat_ns_ the pending capture belongs to
+    QList<QVariantMap> reports_;
+};
+
+}  // namespace opencardev::crankshaft::core::diagnostics
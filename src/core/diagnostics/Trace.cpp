@@ -0,0 +1,430 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Trace.hpp"
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace opencardev::crankshaft::core::diagnostics {
+
+namespace {
+
+struct TraceEvent {
+    const char* category;
+    const char* name;
+    QString detail;
+    qint64 start_ns;
+    qint64 end_ns;
+    bool instant;
+};
+
+// Events of one thread; only that thread appends, so the lock is uncontended while tracing
+struct ThreadBuffer {
+    qint64 tid = 0;
+    QString name;
+    QMutex mutex;
+    std::vector<TraceEvent> events;
+};
+
+struct Registry {
+    QMutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;  // Kept after their thread exits
+    qint64 origin_ns = 0;
+    qint64 next_tid = 1;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+thread_local std::shared_ptr<ThreadBuffer> t_buffer;
+
+QString defaultThreadName(qint64 tid) {
+    const QCoreApplication* app = QCoreApplication::instance();
+    QThread* thread = QThread::currentThread();
+    if (app != nullptr && thread == app->thread()) {
+        return QStringLiteral("main");
+    }
+    const QString name = thread != nullptr ? thread->objectName() : QString();
+    return name.isEmpty() ? QStringLiteral("thread %1").arg(tid) : name;
+}
+
+ThreadBuffer* threadBuffer() {
+    if (!t_buffer) {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        Registry& reg = registry();
+        QMutexLocker locker(&reg.mutex);
+#ifdef Q_OS_LINUX
+        buffer->tid = static_cast<qint64>(::syscall(SYS_gettid));
+#else
+        buffer->tid = reg.next_tid++;
+#endif
+        buffer->name = defaultThreadName(buffer->tid);
+        reg.buffers.push_back(buffer);
+        t_buffer = std::move(buffer);
+    }
+    return t_buffer.get();
+}
+
+void append(TraceEvent event) {
+    ThreadBuffer* buffer = threadBuffer();
+    QMutexLocker locker(&buffer->mutex);
+    buffer->events.push_back(std::move(event));
+}
+
+// A thread's name and a copy of its events, taken under its lock
+struct ThreadSnapshot {
+    qint64 tid;
+    QString name;
+    std::vector<TraceEvent> events;
+};
+
+std::vector<ThreadSnapshot> snapshot(qint64* origin_ns) {
+    Registry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    *origin_ns = reg.origin_ns;
+    std::vector<ThreadSnapshot> threads;
+    for (const auto& buffer : reg.buffers) {
+        QMutexLocker buffer_locker(&buffer->mutex);
+        if (!buffer->events.empty()) {
+            threads.push_back({buffer->tid, buffer->name, buffer->events});
+        }
+    }
+    return threads;
+}
+
+QString processName() {
+    const QCoreApplication* app = QCoreApplication::instance();
+    return app != nullptr && !app->applicationName().isEmpty() ? app->applicationName()
+                                                               : QStringLiteral("crankshaft");
+}
+
+// Chrome trace event format: complete ("X"), instant ("i") and metadata ("M") events
+QByteArray chromeJson(const std::vector<ThreadSnapshot>& threads, qint64 origin_ns) {
+    const qint64 pid = QCoreApplication::applicationPid();
+    auto micros = [origin_ns](qint64 ns) { return double(ns - origin_ns) / 1000.0; };
+
+    QJsonArray events;
+    events.append(QJsonObject{{"ph", "M"},
+                              {"name", "process_name"},
+                              {"pid", pid},
+                              {"args", QJsonObject{{"name", processName()}}}});
+    for (const ThreadSnapshot& thread : threads) {
+        events.append(QJsonObject{{"ph", "M"},
+                                  {"name", "thread_name"},
+                                  {"pid", pid},
+                                  {"tid", thread.tid},
+                                  {"args", QJsonObject{{"name", thread.name}}}});
+        for (const TraceEvent& event : thread.events) {
+            QJsonObject json{{"name", QString::fromLatin1(event.name)},
+                             {"cat", QString::fromLatin1(event.category)},
+                             {"pid", pid},
+                             {"tid", thread.tid},
+                             {"ts", micros(event.start_ns)}};
+            if (event.instant) {
+                json["ph"] = "i";
+                json["s"] = "t";
+            } else {
+                json["ph"] = "X";
+                json["dur"] = double(event.end_ns - event.start_ns) / 1000.0;
+            }
+            if (!event.detail.isEmpty()) {
+                json["args"] = QJsonObject{{"detail", event.detail}};
+            }
+            events.append(json);
+        }
+    }
+
+    QJsonObject trace;
+    trace["traceEvents"] = events;
+    trace["displayTimeUnit"] = "ms";
+    return QJsonDocument(trace).toJson(QJsonDocument::Compact);
+}
+
+// Minimal protobuf encoder for the handful of Perfetto trace fields written below
+class ProtoWriter {
+  public:
+    void varint(int field, quint64 value) {
+        tag(field, 0);
+        raw(value);
+    }
+    void bytes(int field, const QByteArray& value) {
+        tag(field, 2);
+        raw(quint64(value.size()));
+        data_.append(value);
+    }
+    void string(int field, const QString& value) { bytes(field, value.toUtf8()); }
+    void message(int field, const ProtoWriter& value) { bytes(field, value.data_); }
+    const QByteArray& data() const { return data_; }
+
+  private:
+    void tag(int field, int wire_type) { raw((quint64(field) << 3) | quint64(wire_type)); }
+    void raw(quint64 value) {
+        while (value >= 0x80) {
+            data_.append(char((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        data_.append(char(value));
+    }
+
+    QByteArray data_;
+};
+
+// Field numbers from perfetto/protos/perfetto/trace/*.proto
+namespace pf {
+constexpr int kTracePacket = 1;                    // Trace.packet
+constexpr int kPacketTimestamp = 8;                // TracePacket.timestamp
+constexpr int kPacketSequenceId = 10;              // TracePacket.trusted_packet_sequence_id
+constexpr int kPacketTrackEvent = 11;              // TracePacket.track_event
+constexpr int kPacketSequenceFlags = 13;           // TracePacket.sequence_flags
+constexpr int kPacketTimestampClockId = 58;        // TracePacket.timestamp_clock_id
+constexpr int kPacketTrackDescriptor = 60;         // TracePacket.track_descriptor
+constexpr int kTrackUuid = 1;                      // TrackDescriptor.uuid
+constexpr int kTrackProcess = 3;                   // TrackDescriptor.process
+constexpr int kTrackThread = 4;                    // TrackDescriptor.thread
+constexpr int kTrackParentUuid = 5;                // TrackDescriptor.parent_uuid
+constexpr int kProcessPid = 1;                     // ProcessDescriptor.pid
+constexpr int kProcessName = 6;                    // ProcessDescriptor.process_name
+constexpr int kThreadPid = 1;                      // ThreadDescriptor.pid
+constexpr int kThreadTid = 2;                      // ThreadDescriptor.tid
+constexpr int kThreadName = 5;                     // ThreadDescriptor.thread_name
+constexpr int kEventDebugAnnotation = 4;           // TrackEvent.debug_annotations
+constexpr int kEventType = 9;                      // TrackEvent.type
+constexpr int kEventTrackUuid = 11;                // TrackEvent.track_uuid
+constexpr int kEventCategories = 22;               // TrackEvent.categories
+constexpr int kEventName = 23;                     // TrackEvent.name
+constexpr int kAnnotationStringValue = 6;          // DebugAnnotation.string_value
+constexpr int kAnnotationName = 10;                // DebugAnnotation.name
+constexpr quint64 kTypeSliceBegin = 1;             // TrackEvent.Type
+constexpr quint64 kTypeSliceEnd = 2;
+constexpr quint64 kTypeInstant = 3;
+constexpr quint64 kClockMonotonic = 3;             // BuiltinClock.BUILTIN_CLOCK_MONOTONIC
+constexpr quint64 kIncrementalStateCleared = 1;    // SEQ_INCREMENTAL_STATE_CLEARED
+constexpr quint64 kSequenceId = 1;
+}  // namespace pf
+
+QByteArray perfettoTrace(const std::vector<ThreadSnapshot>& threads) {
+    const qint64 pid = QCoreApplication::applicationPid();
+    const quint64 process_uuid = quint64(pid);
+    QByteArray trace;
+    bool first_packet = true;
+
+    auto appendPacket = [&](ProtoWriter& packet) {
+        packet.varint(pf::kPacketSequenceId, pf::kSequenceId);
+        if (first_packet) {
+            packet.varint(pf::kPacketSequenceFlags, pf::kIncrementalStateCleared);
+            first_packet = false;
+        }
+        ProtoWriter wrapper;
+        wrapper.message(pf::kTracePacket, packet);
+        trace.append(wrapper.data());
+    };
+
+    {
+        ProtoWriter process;
+        process.varint(pf::kProcessPid, quint64(pid));
+        process.string(pf::kProcessName, processName());
+        ProtoWriter track;
+        track.varint(pf::kTrackUuid, process_uuid);
+        track.message(pf::kTrackProcess, process);
+        ProtoWriter packet;
+        packet.message(pf::kPacketTrackDescriptor, track);
+        appendPacket(packet);
+    }
+
+    for (const ThreadSnapshot& thread : threads) {
+        const quint64 track_uuid = (quint64(thread.tid) << 32) | quint64(pid);
+        {
+            ProtoWriter descriptor;
+            descriptor.varint(pf::kThreadPid, quint64(pid));
+            descriptor.varint(pf::kThreadTid, quint64(thread.tid));
+            descriptor.string(pf::kThreadName, thread.name);
+            ProtoWriter track;
+            track.varint(pf::kTrackUuid, track_uuid);
+            track.varint(pf::kTrackParentUuid, process_uuid);
+            track.message(pf::kTrackThread, descriptor);
+            ProtoWriter packet;
+            packet.message(pf::kPacketTrackDescriptor, track);
+            appendPacket(packet);
+        }
+
+        auto appendEvent = [&](qint64 timestamp_ns, quint64 type, const TraceEvent* event) {
+            ProtoWriter track_event;
+            track_event.varint(pf::kEventType, type);
+            track_event.varint(pf::kEventTrackUuid, track_uuid);
+            if (event != nullptr) {
+                track_event.string(pf::kEventCategories, QString::fromLatin1(event->category));
+                track_event.string(pf::kEventName, QString::fromLatin1(event->name));
+                if (!event->detail.isEmpty()) {
+                    ProtoWriter annotation;
+                    annotation.string(pf::kAnnotationName, QStringLiteral("detail"));
+                    annotation.string(pf::kAnnotationStringValue, event->detail);
+                    track_event.message(pf::kEventDebugAnnotation, annotation);
+                }
+            }
+            ProtoWriter packet;
+            packet.varint(pf::kPacketTimestamp, quint64(timestamp_ns));
+            packet.varint(pf::kPacketTimestampClockId, pf::kClockMonotonic);
+            packet.message(pf::kPacketTrackEvent, track_event);
+            appendPacket(packet);
+        };
+
+        // Spans are recorded as they end (innermost first); Perfetto wants begin/end
+        // events in order, so replay them outermost first and close them with a stack
+        std::vector<const TraceEvent*> ordered;
+        ordered.reserve(thread.events.size());
+        for (const TraceEvent& event : thread.events) {
+            ordered.push_back(&event);
+        }
+        std::stable_sort(ordered.begin(), ordered.end(),
+                         [](const TraceEvent* a, const TraceEvent* b) {
+                             if (a->start_ns != b->start_ns) {
+                                 return a->start_ns < b->start_ns;
+                             }
+                             return a->end_ns > b->end_ns;
+                         });
+        std::vector<const TraceEvent*> open;
+        for (const TraceEvent* event : ordered) {
+            while (!open.empty() && open.back()->end_ns <= event->start_ns) {
+                appendEvent(open.back()->end_ns, pf::kTypeSliceEnd, nullptr);
+                open.pop_back();
+            }
+            if (event->instant) {
+                appendEvent(event->start_ns, pf::kTypeInstant, event);
+            } else {
+                appendEvent(event->start_ns, pf::kTypeSliceBegin, event);
+                open.push_back(event);
+            }
+        }
+        while (!open.empty()) {
+            appendEvent(open.back()->end_ns, pf::kTypeSliceEnd, nullptr);
+            open.pop_back();
+        }
+    }
+    return trace;
+}
+
+}  // namespace
+
+void Tracer::start() {
+    Registry& reg = registry();
+    {
+        QMutexLocker locker(&reg.mutex);
+        for (const auto& buffer : reg.buffers) {
+            QMutexLocker buffer_locker(&buffer->mutex);
+            buffer->events.clear();
+        }
+        reg.origin_ns = nowNs();
+    }
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::stop() {
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+void Tracer::setThreadName(const QString& name) {
+    ThreadBuffer* buffer = threadBuffer();
+    QMutexLocker locker(&buffer->mutex);
+    buffer->name = name;
+}
+
+void Tracer::instant(const char* category, const char* name, const QString& detail) {
+    const qint64 now = nowNs();
+    append({category, name, detail, now, now, true});
+}
+
+void Tracer::complete(const char* category, const char* name, const QString& detail,
+                      qint64 start_ns, qint64 end_ns) {
+    append({category, name, detail, start_ns, end_ns, false});
+}
+
+Tracer::Format Tracer::formatFor(const QString& file_path) {
+    const QString suffix = QFileInfo(file_path).suffix().toLower();
+    if (suffix == "pftrace" || suffix == "perfetto-trace" || suffix == "pb") {
+        return Format::Perfetto;
+    }
+    return Format::ChromeJson;
+}
+
+bool Tracer::write(const QString& file_path) {
+    return write(file_path, formatFor(file_path));
+}
+
+bool Tracer::write(const QString& file_path, Format format) {
+    qint64 origin_ns = 0;
+    const std::vector<ThreadSnapshot> threads = snapshot(&origin_ns);
+    const QByteArray data =
+        format == Format::Perfetto ? perfettoTrace(threads) : chromeJson(threads, origin_ns);
+
+    QDir().mkpath(QFileInfo(file_path).absolutePath());
+    QSaveFile file(file_path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qWarning() << "Cannot write trace:" << file_path << file.errorString();
+        return false;
+    }
+
+    size_t events = 0;
+    for (const ThreadSnapshot& thread : threads) {
+        events += thread.events.size();
+    }
+    qInfo() << "Trace written:" << file_path << "-" << events << "events on" << threads.size()
+            << "threads";
+    return true;
+}
+
+int Tracer::eventCount() {
+    Registry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    size_t count = 0;
+    for (const auto& buffer : reg.buffers) {
+        QMutexLocker buffer_locker(&buffer->mutex);
+        count += buffer->events.size();
+    }
+    return int(count);
+}
+
+qint64 Tracer::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+}  // namespace opencardev::crankshaft::core::diagnostics
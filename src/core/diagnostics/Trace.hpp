@@ -0,0 +1,128 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include <utility>
+
+namespace opencardev::crankshaft::core::diagnostics {
+
+/**
+ * Process-wide span recorder for profiling startup and other one-off phases.
+ *
+ * Spans are recorded into per-thread buffers while tracing is enabled and written as a
+ * Chrome trace (JSON, for chrome://tracing and ui.perfetto.dev) or a Perfetto protobuf
+ * trace. While disabled, a span costs one relaxed atomic load.
+ *
+ * Names and categories must be string literals; they are stored as pointers.
+ */
+class Tracer {
+  public:
+    enum class Format { ChromeJson, Perfetto };
+
+    static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Discard anything recorded so far and start recording
+    static void start();
+    static void stop();
+
+    // Name the calling thread's track; defaults to "main" or the QThread's object name
+    static void setThreadName(const QString& name);
+
+    static void instant(const char* category, const char* name,
+                        const QString& detail = QString());
+    // Record a span that has already ended; used by TraceSpan
+    static void complete(const char* category, const char* name, const QString& detail,
+                         qint64 start_ns, qint64 end_ns);
+
+    /**
+     * Write everything recorded so far. ".pftrace", ".perfetto-trace" and ".pb" files are
+     * written as Perfetto protobuf traces, anything else as Chrome trace JSON.
+     *
+     * @return true if the file was written
+     */
+    static bool write(const QString& file_path);
+    static bool write(const QString& file_path, Format format);
+    static Format formatFor(const QString& file_path);
+
+    // Events recorded since start(), across all threads
+    static int eventCount();
+
+    // Monotonic clock spans are timed with (CLOCK_MONOTONIC on Linux)
+    static qint64 nowNs();
+
+  private:
+    static inline std::atomic<bool> enabled_{false};
+};
+
+// Records the enclosing block as a span when tracing is enabled
+class TraceSpan {
+  public:
+    TraceSpan(const char* category, const char* name, QString detail = QString())
+        : category_(category),
+          name_(name),
+          detail_(std::move(detail)),
+          start_ns_(Tracer::isEnabled() ? Tracer::nowNs() : 0) {}
+    ~TraceSpan() {
+        if (start_ns_ != 0) {
+            Tracer::complete(category_, name_, detail_, start_ns_, Tracer::nowNs());
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+  private:
+    const char* category_;
+    const char* name_;
+    QString detail_;
+    qint64 start_ns_;
+};
+
+}  // namespace opencardev::crankshaft::core::diagnostics
+
+#define CRANKSHAFT_TRACE_CONCAT_(a, b) a##b
+#define CRANKSHAFT_TRACE_CONCAT(a, b) CRANKSHAFT_TRACE_CONCAT_(a, b)
+
+#ifndef CRANKSHAFT_DISABLE_TRACING
+// Trace the rest of the enclosing block as a span
+#define CRANKSHAFT_TRACE_SCOPE(category, name)                                              \
+    ::opencardev::crankshaft::core::diagnostics::TraceSpan CRANKSHAFT_TRACE_CONCAT(         \
+        crankshaft_trace_span_, __LINE__)(category, name)
+// As CRANKSHAFT_TRACE_SCOPE, with a detail string evaluated only while tracing
+#define CRANKSHAFT_TRACE_SCOPE_DETAIL(category, name, detail)                               \
+    ::opencardev::crankshaft::core::diagnostics::TraceSpan CRANKSHAFT_TRACE_CONCAT(         \
+        crankshaft_trace_span_, __LINE__)(                                                  \
+        category, name,                                                                     \
+        ::opencardev::crankshaft::core::diagnostics::Tracer::isEnabled() ? QString(detail)  \
+                                                                          : QString())
+#define CRANKSHAFT_TRACE_INSTANT(category, name)                                            \
+    do {                                                                                    \
+        if (::opencardev::crankshaft::core::diagnostics::Tracer::isEnabled()) {             \
+            ::opencardev::crankshaft::core::diagnostics::Tracer::instant(category, name);   \
+        }                                                                                   \
+    } while (false)
+#else
+#define CRANKSHAFT_TRACE_SCOPE(category, name) static_cast<void>(0)
+#define CRANKSHAFT_TRACE_SCOPE_DETAIL(category, name, detail) static_cast<void>(0)
+#define CRANKSHAFT_TRACE_INSTANT(category, name) static_cast<void>(0)
+#endif
@@ -19,7 +19,9 @@
 
 #include "event_bus.hpp"
 #include <QDebug>
+#include <QMutexLocker>
 #include <QRegularExpression>
+#include "../diagnostics/DispatchContext.hpp"
 
 namespace opencardev::crankshaft {
 namespace core {
@@ -31,35 +33,46 @@ EventBus::~EventBus() {
 }
 
 int EventBus::subscribe(const QString& event_name, EventCallback callback) {
-    int id = next_subscription_id_++;
-
     auto subscription = std::make_shared<Subscription>();
-    subscription->id = id;
     subscription->event_name = event_name;
-    subscription->callback = callback;
+    subscription->callback = std::move(callback);
 
+    QMutexLocker locker(&mutex_);
+    const int id = next_subscription_id_++;
+    subscription->id = id;
     subscriptions_[event_name].append(subscription);
+    locker.unlock();
 
     qDebug() << "Subscribed to event:" << event_name << "with ID:" << id;
     return id;
 }
 
 void EventBus::unsubscribe(int subscription_id) {
-    for (auto it = subscriptions_.begin(); it != subscriptions_.end(); ++it) {
+    std::shared_ptr<Subscription> removed;
+    QMutexLocker locker(&mutex_);
+    for (auto it = subscriptions_.begin(); it != subscriptions_.end() && !removed; ++it) {
         auto& subs = it.value();
-        bool removed = false;
         for (int i = subs.size() - 1; i >= 0; --i) {
             if (subs[i]->id == subscription_id) {
-                subs.removeAt(i);
-                removed = true;
+                removed = subs.takeAt(i);
                 break;
             }
         }
-        if (removed) {
-            qDebug() << "Unsubscribed from event with ID:" << subscription_id;
-            return;
-        }
     }
+    locker.unlock();
+    if (!removed) {
+        return;
+    }
+
+    // A publish in flight may still hold the subscription; stop it calling the callback
+    // and release the callback now, as its code may be about to be unloaded. A callback
+    // that unsubscribes itself is released when the last reference goes.
+    QMutexLocker call_locker(&removed->call_mutex);
+    removed->active = false;
+    if (removed->running == 0) {
+        removed->callback = nullptr;
+    }
+    qDebug() << "Unsubscribed from event with ID:" << subscription_id;
 }
 
 void EventBus::publish(const QString& event_name, const QVariantMap& data) {
@@ -67,41 +80,52 @@ void EventBus::publish(const QString& event_name, const QVariantMap& data) {
 
     emit eventPublished(event_name, data);
 
+    // Collect recipients under the lock and call them outside it, so callbacks may
+    // subscribe, unsubscribe or publish themselves
+    QList<std::shared_ptr<Subscription>> recipients;
+    QMutexLocker locker(&mutex_);
+
     // First deliver exact-match subscriptions
-    auto it = subscriptions_.find(event_name);
-    if (it != subscriptions_.end()) {
-        const auto& subs = it.value();
-        for (const auto& subscription : subs) {
-            subscription->callback(data);
-        }
+    auto it = subscriptions_.constFind(event_name);
+    if (it != subscriptions_.cend()) {
+        recipients += it.value();
     }
 
     // Then deliver wildcard pattern subscriptions (e.g., "*.media.play", "navigation.*")
-    auto matchesPattern = [](const QString& pattern, const QString& text) -> bool {
-        // Fast path: no wildcard in pattern => no match handling here
-        if (!pattern.contains('*') && !pattern.contains('?'))
-            return false;
-        // Escape regex special chars, then replace glob wildcards
-        QString rx = QRegularExpression::escape(pattern);
-        rx.replace("\\*", ".*");
-        rx.replace("\\?", ".");
-        QRegularExpression re("^" + rx + "$", QRegularExpression::UseUnicodePropertiesOption);
-        return re.match(text).hasMatch();
-    };
-
     for (auto it2 = subscriptions_.cbegin(); it2 != subscriptions_.cend(); ++it2) {
         const QString& pattern = it2.key();
         // Skip exact key already delivered
         if (pattern == event_name)
             continue;
-        if (!matchesPattern(pattern, event_name))
+        if (!matches(pattern, event_name))
+            continue;
+        recipients += it2.value();
+    }
+    locker.unlock();
+
+    diagnostics::DispatchScope dispatch(QString(), QStringLiteral("event"), event_name);
+    for (const auto& subscription : recipients) {
+        QMutexLocker call_locker(&subscription->call_mutex);
+        if (!subscription->active) {
             continue;
-        const auto& subs = it2.value();
-        for (const auto& subscription : subs) {
-            subscription->callback(data);
         }
+        ++subscription->running;
+        subscription->callback(data);
+        --subscription->running;
     }
 }
 
+bool EventBus::matches(const QString& pattern, const QString& event_name) {
+    // Fast path: no wildcard in pattern => exact comparison
+    if (!pattern.contains('*') && !pattern.contains('?'))
+        return pattern == event_name;
+    // Escape regex special chars, then replace glob wildcards
+    QString rx = QRegularExpression::escape(pattern);
+    rx.replace("\\*", ".*");
+    rx.replace("\\?", ".");
+    QRegularExpression re("^" + rx + "$", QRegularExpression::UseUnicodePropertiesOption);
+    return re.match(event_name).hasMatch();
+}
+
 }  // namespace core
 }  // namespace opencardev::crankshaft
@@ -21,7 +21,9 @@
 
 #include <QHash>
 #include <QList>
+#include <QMutex>
 #include <QObject>
+#include <QRecursiveMutex>
 #include <QString>
 #include <QVariantMap>
 #include <functional>
@@ -32,6 +34,13 @@ namespace core {
 
 using EventCallback = std::function<void(const QVariantMap&)>;
 
+/**
+ * Publish/subscribe hub for core and extension events.
+ *
+ * Subscribing, unsubscribing and publishing are thread-safe; callbacks run synchronously
+ * on the publishing thread, outside the bus lock. Once unsubscribe() returns the callback
+ * is not called again and has been destroyed, unless it is the one currently running.
+ */
 class EventBus : public QObject {
     Q_OBJECT
 
@@ -48,6 +57,10 @@ class EventBus : public QObject {
     // Publish an event
     void publish(const QString& event_name, const QVariantMap& data = QVariantMap());
 
+    // Whether a subscription pattern (an exact name or a glob such as "*.phone.dial")
+    // matches an event name
+    static bool matches(const QString& pattern, const QString& event_name);
+
   signals:
     void eventPublished(const QString& event_name, const QVariantMap& data);
 
@@ -56,8 +69,13 @@ class EventBus : public QObject {
         int id;
         QString event_name;
         EventCallback callback;
+        // Held while the callback runs, so unsubscribe() can release it safely
+        QRecursiveMutex call_mutex;
+        bool active = true;
+        int running = 0;
     };
 
+    mutable QMutex mutex_;
     QHash<QString, QList<std::shared_ptr<Subscription>>> subscriptions_;
     int next_subscription_id_;
 };
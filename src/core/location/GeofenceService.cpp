@@ -0,0 +1,297 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "GeofenceService.hpp"
+#include <QDateTime>
+#include <QDebug>
+#include <QtPositioning/QGeoCircle>
+#include <QtPositioning/QGeoPolygon>
+#include <QtPositioning/QGeoRectangle>
+#include <algorithm>
+#include <cmath>
+
+namespace opencardev::crankshaft::core::location {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kMetresPerDegreeLat = 6371008.8 * kPi / 180.0;
+
+GeoBounds circleBounds(const QGeoCoordinate& centre, double radius_m) {
+    const double lat_span = radius_m / kMetresPerDegreeLat;
+    const double cos_lat = std::max(0.01, std::cos(centre.latitude() * kPi / 180.0));
+    const double lon_span = std::min(180.0, lat_span / cos_lat);
+    return GeoBounds{std::max(-90.0, centre.latitude() - lat_span), centre.longitude() - lon_span,
+                     std::min(90.0, centre.latitude() + lat_span),
+                     centre.longitude() + lon_span};
+}
+
+}  // namespace
+
+GeofenceGrid::GeofenceGrid(double cell_degrees) : cell_degrees_(cell_degrees) {}
+
+GeofenceGrid::CellRange GeofenceGrid::range(const GeoBounds& bounds) const {
+    return CellRange{qint64(std::floor((bounds.south + 90.0) / cell_degrees_)),
+                     qint64(std::floor((bounds.north + 90.0) / cell_degrees_)),
+                     qint64(std::floor((bounds.west + 180.0) / cell_degrees_)),
+                     qint64(std::floor((bounds.east + 180.0) / cell_degrees_))};
+}
+
+void GeofenceGrid::insert(int id, const GeoBounds& bounds) {
+    const CellRange cells = range(bounds);
+    if (cells.size() > kMaxCellsPerFence) {
+        oversized_.append(id);
+        return;
+    }
+    for (qint64 row = cells.first_row; row <= cells.last_row; ++row) {
+        for (qint64 column = cells.first_column; column <= cells.last_column; ++column) {
+            cells_[key(row, column)].append(id);
+        }
+    }
+}
+
+void GeofenceGrid::remove(int id, const GeoBounds& bounds) {
+    const CellRange cells = range(bounds);
+    if (cells.size() > kMaxCellsPerFence) {
+        oversized_.removeOne(id);
+        return;
+    }
+    for (qint64 row = cells.first_row; row <= cells.last_row; ++row) {
+        for (qint64 column = cells.first_column; column <= cells.last_column; ++column) {
+            auto it = cells_.find(key(row, column));
+            if (it == cells_.end()) {
+                continue;
+            }
+            it->removeOne(id);
+            if (it->isEmpty()) {
+                cells_.erase(it);
+            }
+        }
+    }
+}
+
+void GeofenceGrid::clear() {
+    cells_.clear();
+    oversized_.clear();
+}
+
+void GeofenceGrid::query(double latitude, double longitude, QList<int>* candidates) const {
+    const auto it =
+        cells_.constFind(key(qint64(std::floor((latitude + 90.0) / cell_degrees_)),
+                             qint64(std::floor((longitude + 180.0) / cell_degrees_))));
+    if (it != cells_.cend()) {
+        candidates->append(*it);
+    }
+    candidates->append(oversized_);
+}
+
+GeofenceService::GeofenceService(QObject* parent) : QObject(parent), next_fence_id_(1) {}
+
+GeofenceService::~GeofenceService() = default;
+
+int GeofenceService::addFence(const QString& owner, const QString& name, const QGeoShape& area,
+                              int dwell_ms) {
+    if (!area.isValid()) {
+        return -1;
+    }
+    Fence fence;
+    fence.owner = owner;
+    fence.name = name;
+    fence.dwell_ms = std::max(0, dwell_ms);
+    switch (area.type()) {
+        case QGeoShape::CircleType: {
+            const QGeoCircle circle(area);
+            fence.centre = circle.center();
+            fence.radius_m = circle.radius();
+            fence.bounds = circleBounds(fence.centre, fence.radius_m);
+            break;
+        }
+        case QGeoShape::RectangleType:
+        case QGeoShape::PolygonType: {
+            QList<QGeoCoordinate> path;
+            if (area.type() == QGeoShape::RectangleType) {
+                const QGeoRectangle rectangle(area);
+                path = {rectangle.topLeft(), rectangle.topRight(), rectangle.bottomRight(),
+                        rectangle.bottomLeft()};
+            } else {
+                path = QGeoPolygon(area).perimeter();
+            }
+            if (path.size() < 3) {
+                return -1;
+            }
+            fence.circle = false;
+            fence.bounds = GeoBounds{90.0, 180.0, -90.0, -180.0};
+            for (const QGeoCoordinate& vertex : std::as_const(path)) {
+                fence.vertices.append({vertex.latitude(), vertex.longitude()});
+                fence.bounds.south = std::min(fence.bounds.south, vertex.latitude());
+                fence.bounds.north = std::max(fence.bounds.north, vertex.latitude());
+                fence.bounds.west = std::min(fence.bounds.west, vertex.longitude());
+                fence.bounds.east = std::max(fence.bounds.east, vertex.longitude());
+            }
+            break;
+        }
+        default:
+            qWarning() << "Geofence" << name << "of" << owner << "has an unsupported shape";
+            return -1;
+    }
+
+    const int id = next_fence_id_++;
+    grid_.insert(id, fence.bounds);
+    fences_.insert(id, std::move(fence));
+    emit fencesChanged();
+    return id;
+}
+
+bool GeofenceService::removeFence(int fence_id) {
+    const auto it = fences_.constFind(fence_id);
+    if (it == fences_.cend()) {
+        return false;
+    }
+    grid_.remove(fence_id, it->bounds);
+    fences_.erase(it);
+    inside_.remove(fence_id);
+    emit fencesChanged();
+    return true;
+}
+
+int GeofenceService::removeFences(const QString& owner) {
+    QList<int> ids;
+    for (auto it = fences_.cbegin(); it != fences_.cend(); ++it) {
+        if (it->owner == owner) {
+            ids.append(it.key());
+        }
+    }
+    for (int id : std::as_const(ids)) {
+        grid_.remove(id, fences_.value(id).bounds);
+        fences_.remove(id);
+        inside_.remove(id);
+    }
+    if (!ids.isEmpty()) {
+        emit fencesChanged();
+    }
+    return ids.size();
+}
+
+bool GeofenceService::contains(const Fence& fence, const QGeoCoordinate& point) const {
+    const double latitude = point.latitude();
+    const double longitude = point.longitude();
+    if (!fence.bounds.contains(latitude, longitude)) {
+        return false;
+    }
+    if (fence.circle) {
+        return fence.centre.distanceTo(point) <= fence.radius_m;
+    }
+    // Even-odd ray casting; fences are small enough to treat degrees as planar
+    bool inside = false;
+    const qsizetype count = fence.vertices.size();
+    for (qsizetype i = 0, j = count - 1; i < count; j = i++) {
+        const auto& [lat_i, lon_i] = fence.vertices[i];
+        const auto& [lat_j, lon_j] = fence.vertices[j];
+        if ((lat_i > latitude) != (lat_j > latitude) &&
+            longitude < (lon_j - lon_i) * (latitude - lat_i) / (lat_j - lat_i) + lon_i) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+void GeofenceService::collectInside(const QGeoCoordinate& point, QSet<int>* inside) {
+    candidates_.clear();
+    grid_.query(point.latitude(), point.longitude(), &candidates_);
+    stats_.candidates += candidates_.size();
+    for (int id : std::as_const(candidates_)) {
+        const auto it = fences_.constFind(id);
+        if (it != fences_.cend() && contains(*it, point)) {
+            inside->insert(id);
+        }
+    }
+}
+
+QList<int> GeofenceService::fencesAt(const QGeoCoordinate& point) const {
+    QList<int> candidates;
+    grid_.query(point.latitude(), point.longitude(), &candidates);
+    QList<int> inside;
+    for (int id : std::as_const(candidates)) {
+        const auto it = fences_.constFind(id);
+        if (it != fences_.cend() && contains(*it, point)) {
+            inside.append(id);
+        }
+    }
+    return inside;
+}
+
+void GeofenceService::update(const QGeoPositionInfo& fix) {
+    if (!fix.isValid() || (fences_.isEmpty() && inside_.isEmpty())) {
+        return;
+    }
+    ++stats_.fixes;
+    const QGeoCoordinate point = fix.coordinate();
+    const qint64 time_ms = fix.timestamp().toMSecsSinceEpoch();
+    QSet<int> inside;
+    collectInside(point, &inside);
+
+    // Settle the state first and report afterwards: handlers may add or remove fences
+    struct Event {
+        QString owner;
+        QString type;
+        QVariantMap data;
+    };
+    QList<Event> events;
+    const auto report = [&](int id, const Fence& fence, const char* type) {
+        QVariantMap data;
+        data["id"] = id;
+        data["name"] = fence.name;
+        data["latitude"] = point.latitude();
+        data["longitude"] = point.longitude();
+        data["timestamp"] = time_ms;
+        if (qstrcmp(type, "dwell") == 0) {
+            data["dwell_ms"] = fence.dwell_ms;
+        }
+        events.append({fence.owner, QString::fromLatin1(type), data});
+    };
+
+    for (int id : std::as_const(inside_)) {
+        const auto it = fences_.constFind(id);
+        if (!inside.contains(id) && it != fences_.cend()) {
+            report(id, *it, "exit");
+        }
+    }
+    for (int id : std::as_const(inside)) {
+        Fence& fence = fences_[id];
+        if (!inside_.contains(id)) {
+            fence.entered_ms = time_ms;
+            fence.dwell_reported = false;
+            report(id, fence, "enter");
+        }
+        if (fence.dwell_ms > 0 && !fence.dwell_reported &&
+            time_ms - fence.entered_ms >= fence.dwell_ms) {
+            fence.dwell_reported = true;
+            report(id, fence, "dwell");
+        }
+    }
+    inside_ = std::move(inside);
+
+    stats_.events += events.size();
+    for (const Event& event : std::as_const(events)) {
+        emit fenceEvent(event.owner, event.type, event.data);
+    }
+}
+
+}  // namespace opencardev::crankshaft::core::location
@@ -0,0 +1,172 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPair>
+#include <QSet>
+#include <QString>
+#include <QVariantMap>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtPositioning/QGeoPositionInfo>
+#include <QtPositioning/QGeoShape>
+
+namespace opencardev::crankshaft::core::location {
+
+// Latitude/longitude box; fences are assumed not to cross the antimeridian
+struct GeoBounds {
+    double south = 0.0;
+    double west = 0.0;
+    double north = 0.0;
+    double east = 0.0;
+
+    bool contains(double latitude, double longitude) const {
+        return latitude >= south && latitude <= north && longitude >= west && longitude <= east;
+    }
+};
+
+/**
+ * Uniform latitude/longitude grid over fence bounding boxes.
+ *
+ * Each fence is listed in every cell its box overlaps, so a point query reads one cell.
+ * With the default 0.01° cells (about 1.1 km north to south) a city's worth of fences
+ * costs a handful of candidates per fix. A fence covering more than kMaxCellsPerFence
+ * cells, such as a whole low-emission zone at a fine cell size, is kept in a short list
+ * checked on every query instead of being smeared over thousands of cells.
+ */
+class GeofenceGrid {
+  public:
+    static constexpr int kMaxCellsPerFence = 4096;
+
+    explicit GeofenceGrid(double cell_degrees = 0.01);
+
+    void insert(int id, const GeoBounds& bounds);
+    void remove(int id, const GeoBounds& bounds);
+    void clear();
+
+    // Fences whose bounds may contain the point, appended to candidates
+    void query(double latitude, double longitude, QList<int>* candidates) const;
+
+    int cellCount() const { return cells_.size(); }
+
+  private:
+    struct CellRange {
+        qint64 first_row;
+        qint64 last_row;
+        qint64 first_column;
+        qint64 last_column;
+
+        qint64 size() const {
+            return (last_row - first_row + 1) * (last_column - first_column + 1);
+        }
+    };
+
+    CellRange range(const GeoBounds& bounds) const;
+    static quint64 key(qint64 row, qint64 column) {
+        return (quint64(row) << 32) | quint64(quint32(column));
+    }
+
+    double cell_degrees_;
+    QHash<quint64, QList<int>> cells_;
+    QList<int> oversized_;
+};
+
+/**
+ * Geofences registered by extensions, checked against each position fix.
+ *
+ * Fences are circles or polygons (a QGeoRectangle is taken as a four-point polygon).
+ * Entering or leaving a fence, and staying inside it for its dwell time, is reported
+ * through fenceEvent() once per transition; only fences near the fix are tested, through
+ * a GeofenceGrid.
+ */
+class GeofenceService : public QObject {
+    Q_OBJECT
+
+  public:
+    struct Stats {
+        quint64 fixes = 0;
+        quint64 candidates = 0;  // Fences tested exactly, after the grid lookup
+        quint64 events = 0;
+    };
+
+    explicit GeofenceService(QObject* parent = nullptr);
+    ~GeofenceService() override;
+
+    /**
+     * @param owner Extension the fence belongs to; its events are published under its id
+     * @param area QGeoCircle, QGeoRectangle or QGeoPolygon
+     * @param dwell_ms Report a dwell event after this long inside; 0 for none
+     * @return Fence ID, unique for the service's lifetime, or -1 for an unsupported area
+     */
+    int addFence(const QString& owner, const QString& name, const QGeoShape& area,
+                 int dwell_ms = 0);
+    bool removeFence(int fence_id);
+    // Remove every fence of an extension; returns how many there were
+    int removeFences(const QString& owner);
+
+    int fenceCount() const { return fences_.size(); }
+    bool isEmpty() const { return fences_.isEmpty(); }
+    QString owner(int fence_id) const { return fences_.value(fence_id).owner; }
+    // Fences containing a point, in no particular order
+    QList<int> fencesAt(const QGeoCoordinate& point) const;
+
+    // Check a fix against the fences and report transitions; fixes must be in time order
+    void update(const QGeoPositionInfo& fix);
+
+    Stats stats() const { return stats_; }
+
+  signals:
+    /**
+     * type is "enter", "exit" or "dwell"; event holds id, name, latitude, longitude and
+     * timestamp (ms since the epoch) of the fix, and dwell_ms for dwell events.
+     */
+    void fenceEvent(const QString& owner, const QString& type, const QVariantMap& event);
+    // A fence was added or removed
+    void fencesChanged();
+
+  private:
+    struct Fence {
+        QString owner;
+        QString name;
+        bool circle = true;
+        QGeoCoordinate centre;
+        double radius_m = 0.0;
+        QList<QPair<double, double>> vertices;  // Latitude, longitude
+        GeoBounds bounds;
+        int dwell_ms = 0;
+        qint64 entered_ms = 0;
+        bool dwell_reported = false;
+    };
+
+    bool contains(const Fence& fence, const QGeoCoordinate& point) const;
+    void collectInside(const QGeoCoordinate& point, QSet<int>* inside);
+
+    QHash<int, Fence> fences_;
+    GeofenceGrid grid_;
+    QSet<int> inside_;
+    int next_fence_id_;
+    QList<int> candidates_;  // Reused between fixes
+    Stats stats_;
+};
+
+}  // namespace opencardev::crankshaft::core::location
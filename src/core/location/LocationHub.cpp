@@ -0,0 +1,340 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "LocationHub.hpp"
+#include <QDateTime>
+#include <QDebug>
+#include <algorithm>
+#include <limits>
+#include "NmeaSerialSource.hpp"
+#include "ReplaySource.hpp"
+
+namespace opencardev::crankshaft::core::location {
+
+namespace {
+
+// Fixes stamped with local time arrive with jitter; accept one up to a tenth of the
+// interval (at most this much) early rather than waiting a whole extra receiver period.
+// Kept below 100 ms so a 10 Hz receiver's 900 ms fix does not pass for a second.
+constexpr qint64 kMaxIntervalSlackMs = 50;
+// Source interval while geofences are registered, whatever the subscribers ask for
+constexpr int kGeofenceIntervalMs = 1000;
+
+QString describe(const QGeoPositionInfoSource* source) {
+    return source->sourceName().isEmpty() ? QString(source->metaObject()->className())
+                                          : source->sourceName();
+}
+
+qint64 fixTimeMs(const QGeoPositionInfo& info) {
+    return info.timestamp().isValid() ? info.timestamp().toMSecsSinceEpoch()
+                                      : QDateTime::currentMSecsSinceEpoch();
+}
+
+}  // namespace
+
+bool LocationHub::Subscriber::accepts(const QGeoPositionInfo& info, qint64 time_ms) const {
+    if (policy.max_accuracy_m > 0.0 && info.hasAttribute(QGeoPositionInfo::HorizontalAccuracy) &&
+        info.attribute(QGeoPositionInfo::HorizontalAccuracy) > policy.max_accuracy_m) {
+        return false;
+    }
+    if (last_delivered_ms < 0) {
+        return true;
+    }
+    if (!intervalElapsed(time_ms - last_delivered_ms, policy.min_interval_ms)) {
+        return false;
+    }
+    if (policy.min_distance_m > 0.0 && last_delivered.isValid() &&
+        last_delivered.distanceTo(info.coordinate()) < policy.min_distance_m) {
+        return false;
+    }
+    return true;
+}
+
+bool LocationHub::intervalElapsed(qint64 elapsed_ms, int interval_ms) {
+    if (interval_ms <= 0) {
+        return true;
+    }
+    const qint64 slack = std::min<qint64>(interval_ms / 10, kMaxIntervalSlackMs);
+    return elapsed_ms >= interval_ms - slack;
+}
+
+LocationHub::LocationHub(QObject* parent)
+    : QObject(parent),
+      default_source_failed_(false),
+      device_(DeviceMode::Internal),
+      usb_receiver_{kDefaultUsbDevice, NmeaSerialSource::kDefaultBaudRate},
+      hat_receiver_{kDefaultHatDevice, NmeaSerialSource::kDefaultBaudRate},
+      replay_speed_(1.0),
+      replay_loop_(false),
+      device_pinned_(false),
+      next_subscription_id_(1),
+      fixes_received_(0),
+      source_interval_ms_(0),
+      source_running_(false) {
+    connect(&geofences_, &GeofenceService::fencesChanged, this, &LocationHub::updateSource);
+}
+
+LocationHub::~LocationHub() {
+    if (source_) {
+        source_->stopUpdates();
+    }
+}
+
+void LocationHub::setSource(QGeoPositionInfoSource* source) {
+    if (source_ == source) {
+        return;
+    }
+    if (source_) {
+        source_->stopUpdates();
+        source_->deleteLater();
+    }
+    source_ = source;
+    source_running_ = false;
+    default_source_failed_ = false;
+    // Another receiver: its first fix need not agree with the last one's track
+    filter_.reset();
+    if (source_) {
+        source_->setParent(this);
+        connect(source_, &QGeoPositionInfoSource::positionUpdated, this,
+                &LocationHub::publishFix);
+        qInfo() << "Location hub: using position source" << describe(source_);
+    }
+    updateSource();
+}
+
+void LocationHub::useDevice(DeviceMode mode) {
+    if (mode == DeviceMode::MockStatic || mode == DeviceMode::MockIP || mode == device_) {
+        return;
+    }
+    if (device_pinned_) {
+        qInfo() << "Location hub: device pinned, ignoring switch to mode" << int(mode);
+        return;
+    }
+    device_ = mode;
+    if (mode == DeviceMode::Internal) {
+        setSource(nullptr);
+    } else if (mode == DeviceMode::Replay) {
+        useReplay();
+    } else {
+        useSerialReceiver(mode == DeviceMode::USB ? usb_receiver_ : hat_receiver_);
+    }
+}
+
+void LocationHub::pinDevice(DeviceMode mode) {
+    device_pinned_ = false;
+    useDevice(mode);
+    device_pinned_ = true;
+}
+
+void LocationHub::setSerialReceiver(DeviceMode mode, const QString& device, int baud_rate) {
+    if (mode != DeviceMode::USB && mode != DeviceMode::Hat) {
+        return;
+    }
+    SerialReceiver& receiver = mode == DeviceMode::USB ? usb_receiver_ : hat_receiver_;
+    receiver.device = device;
+    receiver.baud_rate = baud_rate;
+    if (device_ == mode) {
+        useSerialReceiver(receiver);
+    }
+}
+
+QString LocationHub::serialDevice(DeviceMode mode) const {
+    if (mode == DeviceMode::USB) {
+        return usb_receiver_.device;
+    }
+    return mode == DeviceMode::Hat ? hat_receiver_.device : QString();
+}
+
+void LocationHub::setReplay(const QString& file, double speed, bool loop) {
+    replay_file_ = file;
+    replay_speed_ = speed;
+    replay_loop_ = loop;
+    if (device_ == DeviceMode::Replay) {
+        useReplay();
+    }
+}
+
+void LocationHub::useReplay() {
+    auto* current = qobject_cast<ReplaySource*>(source_.data());
+    if (!current || current->path() != replay_file_) {
+        current = new ReplaySource;
+        // A missing recording is reported when the source is started
+        current->load(replay_file_);
+    }
+    current->setSpeed(replay_speed_);
+    current->setLoop(replay_loop_);
+    setSource(current);
+}
+
+void LocationHub::useSerialReceiver(const SerialReceiver& receiver) {
+    const auto* current = qobject_cast<NmeaSerialSource*>(source_.data());
+    if (current && current->device() == receiver.device &&
+        current->baudRate() == receiver.baud_rate) {
+        return;
+    }
+    setSource(new NmeaSerialSource(receiver.device, receiver.baud_rate));
+}
+
+void LocationHub::ensureSource() {
+    if (source_ || default_source_failed_) {
+        return;
+    }
+    QGeoPositionInfoSource* source = QGeoPositionInfoSource::createDefaultSource(this);
+    if (!source) {
+        qWarning() << "Location hub: no position source available";
+        default_source_failed_ = true;
+        return;
+    }
+    source_ = source;
+    connect(source_, &QGeoPositionInfoSource::positionUpdated, this, &LocationHub::publishFix);
+    qInfo() << "Location hub: using position source" << describe(source_);
+}
+
+int LocationHub::subscribe(const QString& owner, const Policy& policy, Callback callback) {
+    const int id = next_subscription_id_++;
+    Subscriber subscriber;
+    subscriber.owner = owner;
+    subscriber.policy = policy;
+    subscriber.callback = std::move(callback);
+    subscribers_.insert(id, std::move(subscriber));
+    updateSource();
+    return id;
+}
+
+void LocationHub::unsubscribe(int subscription_id) {
+    if (subscribers_.remove(subscription_id) > 0) {
+        updateSource();
+    }
+}
+
+void LocationHub::updateSource() {
+    if (subscribers_.isEmpty() && geofences_.isEmpty()) {
+        if (source_ && source_running_) {
+            source_->stopUpdates();
+            qDebug() << "Location hub: no subscribers, source stopped";
+        }
+        source_running_ = false;
+        return;
+    }
+
+    ensureSource();
+    if (!source_) {
+        return;
+    }
+
+    // The most demanding subscriber sets the pace; the rest are decimated
+    int interval =
+        geofences_.isEmpty() ? std::numeric_limits<int>::max() : kGeofenceIntervalMs;
+    for (const Subscriber& subscriber : std::as_const(subscribers_)) {
+        interval = std::min(interval, std::max(0, subscriber.policy.min_interval_ms));
+    }
+    interval = std::max(interval, source_->minimumUpdateInterval());
+    if (interval != source_interval_ms_ || !source_running_) {
+        source_->setUpdateInterval(interval);
+        source_interval_ms_ = interval;
+        qDebug() << "Location hub:" << subscribers_.size() << "subscribers, source interval"
+                 << interval << "ms";
+    }
+    if (!source_running_) {
+        source_->startUpdates();
+        source_running_ = true;
+    }
+}
+
+QGeoPositionInfo LocationHub::lastFix() {
+    if (last_fix_.isValid()) {
+        return last_fix_;
+    }
+    ensureSource();
+    return source_ ? source_->lastKnownPosition() : QGeoPositionInfo();
+}
+
+QGeoPositionInfo LocationHub::predictedPosition() const {
+    if (!since_filtered_fix_.isValid()) {
+        return QGeoPositionInfo();
+    }
+    return filter_.predict(since_filtered_fix_.elapsed());
+}
+
+bool LocationHub::isAvailable() {
+    ensureSource();
+    return source_ != nullptr;
+}
+
+QVariantList LocationHub::subscriptionStats() const {
+    QVariantList stats;
+    for (auto it = subscribers_.cbegin(); it != subscribers_.cend(); ++it) {
+        QVariantMap entry;
+        entry["id"] = it.key();
+        entry["owner"] = it->owner;
+        entry["min_interval_ms"] = it->policy.min_interval_ms;
+        entry["min_distance_m"] = it->policy.min_distance_m;
+        entry["max_accuracy_m"] = it->policy.max_accuracy_m;
+        entry["smoothed"] = it->policy.smoothed;
+        entry["delivered"] = it->delivered;
+        entry["skipped"] = it->skipped;
+        stats << entry;
+    }
+    return stats;
+}
+
+void LocationHub::publishFix(const QGeoPositionInfo& info) {
+    if (!info.isValid()) {
+        return;
+    }
+    last_fix_ = info;
+    ++fixes_received_;
+    const qint64 time_ms = fixTimeMs(info);
+
+    const PositionFilter::Result result = filter_.update(info);
+    const bool filtered =
+        result == PositionFilter::Result::Accepted || result == PositionFilter::Result::Initialised;
+    if (filtered) {
+        since_filtered_fix_.start();
+    } else if (result == PositionFilter::Result::Rejected) {
+        qDebug() << "Location hub: outlier fix rejected at" << info.coordinate();
+    }
+    const QGeoPositionInfo smoothed = filtered ? filter_.estimate() : QGeoPositionInfo();
+    // Outliers would read as a brief exit and re-entry
+    if (filtered) {
+        geofences_.update(smoothed);
+    }
+
+    // Callbacks may subscribe or unsubscribe, so walk a snapshot of the ids
+    const QList<int> ids = subscribers_.keys();
+    for (int id : ids) {
+        auto it = subscribers_.find(id);
+        if (it == subscribers_.end()) {
+            continue;
+        }
+        const QGeoPositionInfo& fix = it->policy.smoothed ? smoothed : info;
+        if (!fix.isValid() || !it->accepts(fix, time_ms)) {
+            ++it->skipped;
+            continue;
+        }
+        it->last_delivered_ms = time_ms;
+        it->last_delivered = fix.coordinate();
+        ++it->delivered;
+        const Callback callback = it->callback;
+        callback(fix);
+    }
+}
+
+}  // namespace opencardev::crankshaft::core::location
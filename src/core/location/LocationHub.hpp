@@ -0,0 +1,174 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QGeoCoordinate>
+#include <QMap>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QVariantList>
+#include <QtPositioning/QGeoPositionInfo>
+#include <QtPositioning/QGeoPositionInfoSource>
+#include <functional>
+#include "../capabilities/LocationCapability.hpp"
+#include "GeofenceService.hpp"
+#include "PositionFilter.hpp"
+
+namespace opencardev::crankshaft::core::location {
+
+/**
+ * Single owner of the position source, fanning fixes out to every location capability.
+ *
+ * Each subscriber declares an UpdatePolicy; a fix is delivered to a subscriber only once
+ * its interval has passed, it has moved far enough and the fix is accurate enough. The
+ * source runs while anyone is subscribed, at the shortest interval any subscriber asks
+ * for, so a clock wanting a fix a minute does not keep the receiver at its full rate.
+ *
+ * Every fix also goes through a PositionFilter. Subscribers asking for smoothed fixes get
+ * its estimate instead of the raw fix, and predictedPosition() dead-reckons from it
+ * between fixes. The filtered fixes are checked against the geofences; while any are
+ * registered the source keeps running, at least once a second.
+ *
+ * Lives on the main thread; sources on other threads deliver through publishFix() with
+ * a queued call.
+ */
+class LocationHub : public QObject {
+    Q_OBJECT
+
+  public:
+    using Policy = capabilities::LocationCapability::UpdatePolicy;
+    using Callback = std::function<void(const QGeoPositionInfo&)>;
+    using DeviceMode = capabilities::LocationCapability::DeviceMode;
+
+    // Defaults for the serial receivers; see setSerialReceiver()
+    static constexpr const char* kDefaultUsbDevice = "/dev/ttyACM0";
+    static constexpr const char* kDefaultHatDevice = "/dev/serial0";
+
+    explicit LocationHub(QObject* parent = nullptr);
+    ~LocationHub() override;
+
+    /**
+     * Use a specific position source instead of the platform default, taking ownership.
+     * Pass nullptr to go back to the default, created when next needed.
+     */
+    void setSource(QGeoPositionInfoSource* source);
+    QGeoPositionInfoSource* source() const { return source_; }
+
+    /**
+     * Switch to the receiver behind a device mode: the platform source for Internal, an
+     * NMEA serial receiver for USB and Hat, or a ReplaySource for Replay. The mock modes
+     * are served by each capability and ignored here, as is any switch while pinned.
+     */
+    void useDevice(DeviceMode mode);
+    DeviceMode device() const { return device_; }
+
+    // Switch to a device and keep it, ignoring later useDevice() calls
+    void pinDevice(DeviceMode mode);
+    bool isDevicePinned() const { return device_pinned_; }
+
+    // Serial port and baud rate of the USB or Hat receiver; reopened if in use
+    void setSerialReceiver(DeviceMode mode, const QString& device, int baud_rate);
+    // Serial port of the USB or Hat receiver; empty for other modes
+    QString serialDevice(DeviceMode mode) const;
+
+    // Recording played in Replay mode, at a multiple of real time (0 for maximum speed)
+    void setReplay(const QString& file, double speed, bool loop);
+    QString replayFile() const { return replay_file_; }
+
+    /**
+     * @param owner Extension the subscription is for, for diagnostics
+     * @return Subscription ID, unique for the hub's lifetime
+     */
+    int subscribe(const QString& owner, const Policy& policy, Callback callback);
+    void unsubscribe(int subscription_id);
+    int subscriberCount() const { return subscribers_.size(); }
+
+    // Latest fix, from the source's last known position before the first one arrives
+    QGeoPositionInfo lastFix();
+    // Filtered position extrapolated to now; invalid before the first fix
+    QGeoPositionInfo predictedPosition() const;
+    PositionFilter::Stats filterStats() const { return filter_.stats(); }
+
+    GeofenceService* geofences() { return &geofences_; }
+    bool isAvailable();
+
+    // Interval requested from the source while running, in ms; 0 means its fastest rate
+    int sourceInterval() const { return source_interval_ms_; }
+    bool isSourceRunning() const { return source_running_; }
+
+    // Whether a fix elapsed_ms after the last one delivered is due, allowing for jitter
+    static bool intervalElapsed(qint64 elapsed_ms, int interval_ms);
+
+    quint64 fixesReceived() const { return fixes_received_; }
+    // { id, owner, min_interval_ms, min_distance_m, max_accuracy_m, smoothed, delivered,
+    //   skipped }
+    QVariantList subscriptionStats() const;
+
+  public slots:
+    // Fan a fix out to subscribers; the source is connected here
+    void publishFix(const QGeoPositionInfo& info);
+
+  private:
+    struct Subscriber {
+        QString owner;
+        Policy policy;
+        Callback callback;
+        qint64 last_delivered_ms = -1;
+        QGeoCoordinate last_delivered;
+        quint64 delivered = 0;
+        quint64 skipped = 0;
+
+        bool accepts(const QGeoPositionInfo& info, qint64 time_ms) const;
+    };
+
+    struct SerialReceiver {
+        QString device;
+        int baud_rate;
+    };
+
+    void ensureSource();
+    void useSerialReceiver(const SerialReceiver& receiver);
+    void useReplay();
+    // Start, stop or re-rate the source after the subscriber set changed
+    void updateSource();
+
+    QPointer<QGeoPositionInfoSource> source_;
+    bool default_source_failed_;
+    DeviceMode device_;
+    SerialReceiver usb_receiver_;
+    SerialReceiver hat_receiver_;
+    QString replay_file_;
+    double replay_speed_;
+    bool replay_loop_;
+    bool device_pinned_;
+    QMap<int, Subscriber> subscribers_;
+    int next_subscription_id_;
+    QGeoPositionInfo last_fix_;
+    PositionFilter filter_;
+    GeofenceService geofences_;
+    QElapsedTimer since_filtered_fix_;  // Local time since the filter last took a fix
+    quint64 fixes_received_;
+    int source_interval_ms_;
+    bool source_running_;
+};
+
+}  // namespace opencardev::crankshaft::core::location
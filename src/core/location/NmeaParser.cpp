@@ -0,0 +1,692 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "NmeaParser.hpp"
+#include <QDateTime>
+#include <QHash>
+#include <QTimeZone>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace opencardev::crankshaft::core::location {
+
+namespace {
+
+using Constellation = NmeaParser::Constellation;
+
+constexpr double kKnotsToMetresPerSecond = 0.514444;
+// Typical user equivalent range error of a consumer receiver; accuracy = DOP * UERE when
+// the receiver sends no GST error estimates
+constexpr double kUereMetres = 5.0;
+
+const char* findLineEnd(const char* p, const char* end) {
+    for (; p < end; ++p) {
+        if (*p == '\r' || *p == '\n') {
+            return p;
+        }
+    }
+    return nullptr;
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Plain decimal numbers only, as NMEA uses; no allocation or locale
+bool parseDouble(std::string_view s, double* out) {
+    size_t i = 0;
+    bool negative = false;
+    if (!s.empty() && (s[0] == '-' || s[0] == '+')) {
+        negative = s[0] == '-';
+        i = 1;
+    }
+    double value = 0.0;
+    bool digits = false;
+    for (; i < s.size() && isDigit(s[i]); ++i) {
+        value = value * 10.0 + (s[i] - '0');
+        digits = true;
+    }
+    if (i < s.size() && s[i] == '.') {
+        double scale = 0.1;
+        for (++i; i < s.size() && isDigit(s[i]); ++i) {
+            value += (s[i] - '0') * scale;
+            scale *= 0.1;
+            digits = true;
+        }
+    }
+    if (!digits || i != s.size()) {
+        return false;
+    }
+    *out = negative ? -value : value;
+    return true;
+}
+
+bool parseInt(std::string_view s, int* out) {
+    if (s.empty() || s.size() > 9) {
+        return false;
+    }
+    int value = 0;
+    for (char c : s) {
+        if (!isDigit(c)) {
+            return false;
+        }
+        value = value * 10 + (c - '0');
+    }
+    *out = value;
+    return true;
+}
+
+int twoDigits(std::string_view s, size_t at) {
+    return (s[at] - '0') * 10 + (s[at + 1] - '0');
+}
+
+// hhmmss[.sss] to milliseconds since midnight
+bool parseTime(std::string_view s, int* time_ms) {
+    if (s.size() < 6 || !isDigit(s[0]) || !isDigit(s[1]) || !isDigit(s[2]) || !isDigit(s[3])) {
+        return false;
+    }
+    double seconds = 0.0;
+    if (!parseDouble(s.substr(4), &seconds) || seconds >= 61.0) {
+        return false;
+    }
+    const int hours = twoDigits(s, 0);
+    const int minutes = twoDigits(s, 2);
+    if (hours > 23 || minutes > 59) {
+        return false;
+    }
+    *time_ms = (hours * 3600 + minutes * 60) * 1000 + int(std::lround(seconds * 1000.0));
+    return true;
+}
+
+// ddmmyy
+bool parseDate(std::string_view s, QDate* date) {
+    if (s.size() != 6) {
+        return false;
+    }
+    for (char c : s) {
+        if (!isDigit(c)) {
+            return false;
+        }
+    }
+    const int year = twoDigits(s, 4);
+    const QDate parsed(year < 80 ? 2000 + year : 1900 + year, twoDigits(s, 2), twoDigits(s, 0));
+    if (!parsed.isValid()) {
+        return false;
+    }
+    *date = parsed;
+    return true;
+}
+
+// (d)ddmm.mmmm plus hemisphere to signed decimal degrees
+bool parseAngle(std::string_view value, std::string_view hemisphere, double limit,
+                double* degrees) {
+    double raw = 0.0;
+    if (!parseDouble(value, &raw) || raw < 0.0 || hemisphere.size() != 1) {
+        return false;
+    }
+    const double whole = std::floor(raw / 100.0);
+    double result = whole + (raw - whole * 100.0) / 60.0;
+    if (result > limit) {
+        return false;
+    }
+    const char h = hemisphere[0];
+    if (h == 'S' || h == 'W') {
+        result = -result;
+    } else if (h != 'N' && h != 'E') {
+        return false;
+    }
+    *degrees = result;
+    return true;
+}
+
+Constellation constellationOfTalker(std::string_view talker) {
+    if (talker == "GP") {
+        return Constellation::Gps;
+    }
+    if (talker == "GL") {
+        return Constellation::Glonass;
+    }
+    if (talker == "GA") {
+        return Constellation::Galileo;
+    }
+    if (talker == "GB" || talker == "BD") {
+        return Constellation::BeiDou;
+    }
+    if (talker == "GQ" || talker == "QZ") {
+        return Constellation::Qzss;
+    }
+    if (talker == "GI") {
+        return Constellation::NavIC;
+    }
+    return Constellation::Unknown;  // GN: several constellations
+}
+
+// NMEA 4.10 GSA/GSV system ID
+Constellation constellationOfSystemId(int system_id) {
+    switch (system_id) {
+        case 1:
+            return Constellation::Gps;
+        case 2:
+            return Constellation::Glonass;
+        case 3:
+            return Constellation::Galileo;
+        case 4:
+            return Constellation::BeiDou;
+        case 5:
+            return Constellation::Qzss;
+        case 6:
+            return Constellation::NavIC;
+        default:
+            return Constellation::Unknown;
+    }
+}
+
+// A satellite's constellation, from its talker and the NMEA PRN numbering ranges
+Constellation constellationOf(Constellation talker, int prn) {
+    if (talker == Constellation::Gps || talker == Constellation::Unknown) {
+        if (prn >= 33 && prn <= 64) {
+            return Constellation::Sbas;
+        }
+        if (talker == Constellation::Gps) {
+            return talker;
+        }
+        if (prn >= 1 && prn <= 32) {
+            return Constellation::Gps;
+        }
+        if (prn >= 65 && prn <= 99) {
+            return Constellation::Glonass;
+        }
+        if (prn >= 193 && prn <= 202) {
+            return Constellation::Qzss;
+        }
+        if (prn >= 301 && prn <= 336) {
+            return Constellation::Galileo;
+        }
+        if (prn >= 401 && prn <= 463) {
+            return Constellation::BeiDou;
+        }
+    }
+    return talker;
+}
+
+// GSA reports SBAS satellites among the GPS ones
+Constellation gsaGroupOf(Constellation constellation) {
+    return constellation == Constellation::Sbas ? Constellation::Gps : constellation;
+}
+
+}  // namespace
+
+NmeaParser::NmeaParser()
+    : carry_length_(0),
+      discarding_(false),
+      rmc_seen_(false),
+      gga_seen_(false),
+      epoch_seen_(false),
+      gsa_hdop_(-1.0),
+      gsa_vdop_(-1.0),
+      gst_horizontal_m_(-1.0),
+      gst_vertical_m_(-1.0),
+      satellites_changed_(false) {}
+
+void NmeaParser::feed(const char* data, qsizetype size) {
+    const char* p = data;
+    const char* const end = data + size;
+    while (p < end) {
+        if (carry_length_ == 0 && !discarding_) {
+            const char* start = static_cast<const char*>(std::memchr(p, '$', size_t(end - p)));
+            if (!start) {
+                return;
+            }
+            const char* eol = findLineEnd(start + 1, end);
+            if (eol) {
+                // Whole sentence in this chunk: parse it where it is
+                handleLine(start, eol);
+                p = eol + 1;
+                continue;
+            }
+            const qsizetype partial = end - start;
+            if (partial > kMaxSentenceLength) {
+                ++stats_.malformed;
+                discarding_ = true;
+            } else {
+                std::memcpy(carry_.data(), start, size_t(partial));
+                carry_length_ = int(partial);
+            }
+            return;
+        }
+
+        const char* eol = findLineEnd(p, end);
+        if (discarding_) {
+            if (!eol) {
+                return;
+            }
+            discarding_ = false;
+            p = eol + 1;
+            continue;
+        }
+        const qsizetype piece = (eol ? eol : end) - p;
+        if (carry_length_ + piece > kMaxSentenceLength) {
+            ++stats_.malformed;
+            carry_length_ = 0;
+            discarding_ = eol == nullptr;
+            p = eol ? eol + 1 : end;
+            continue;
+        }
+        std::memcpy(carry_.data() + carry_length_, p, size_t(piece));
+        carry_length_ += int(piece);
+        if (!eol) {
+            return;
+        }
+        handleLine(carry_.data(), carry_.data() + carry_length_);
+        carry_length_ = 0;
+        p = eol + 1;
+    }
+}
+
+void NmeaParser::flush() {
+    if (!epoch_.reported && epoch_.time_ms >= 0) {
+        reportEpoch();
+    }
+    reportSatellites();
+}
+
+void NmeaParser::reset() {
+    carry_length_ = 0;
+    discarding_ = false;
+    epoch_ = Epoch();
+    date_ = QDate();
+    rmc_seen_ = false;
+    gga_seen_ = false;
+    epoch_seen_ = false;
+    gsa_hdop_ = -1.0;
+    gsa_vdop_ = -1.0;
+    gst_horizontal_m_ = -1.0;
+    gst_vertical_m_ = -1.0;
+    gsv_pending_.clear();
+    gsv_view_.clear();
+    used_.clear();
+    satellites_changed_ = false;
+}
+
+void NmeaParser::handleLine(const char* begin, const char* end) {
+    // A sentence that lost its terminator runs into the next one; keep the last
+    for (const char* p = end - 1; p > begin; --p) {
+        if (*p == '$') {
+            begin = p;
+            break;
+        }
+    }
+    const qsizetype length = end - begin;
+    if (length < 6 || length > kMaxSentenceLength || end[-3] != '*') {
+        ++stats_.malformed;
+        return;
+    }
+    const int high = hexValue(end[-2]);
+    const int low = hexValue(end[-1]);
+    if (high < 0 || low < 0) {
+        ++stats_.malformed;
+        return;
+    }
+    unsigned char checksum = 0;
+    for (const char* p = begin + 1; p < end - 3; ++p) {
+        checksum ^= static_cast<unsigned char>(*p);
+    }
+    if (checksum != ((high << 4) | low)) {
+        ++stats_.checksum_errors;
+        return;
+    }
+    ++stats_.sentences;
+    handleSentence(std::string_view(begin + 1, size_t(end - 3 - (begin + 1))));
+}
+
+void NmeaParser::handleSentence(std::string_view body) {
+    Fields fields;
+    int count = 0;
+    size_t start = 0;
+    while (count < kMaxFields) {
+        const size_t comma = body.find(',', start);
+        fields[count++] = body.substr(start, comma == std::string_view::npos ? comma
+                                                                             : comma - start);
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        start = comma + 1;
+    }
+
+    // Proprietary sentences ($P...) are not interpreted
+    const std::string_view address = fields[0];
+    if (address.size() != 5 || address[0] == 'P') {
+        return;
+    }
+    const std::string_view talker = address.substr(0, 2);
+    const std::string_view type = address.substr(2);
+    if (type == "RMC") {
+        handleRmc(fields, count);
+    } else if (type == "GGA") {
+        handleGga(fields, count);
+    } else if (type == "GLL") {
+        handleGll(fields, count);
+    } else if (type == "GST") {
+        handleGst(fields, count);
+    } else if (type == "GSA") {
+        handleGsa(talker, fields, count);
+    } else if (type == "GSV") {
+        handleGsv(talker, fields, count);
+    }
+}
+
+void NmeaParser::handleRmc(const Fields& f, int count) {
+    int time_ms = 0;
+    if (count < 10 || !parseTime(f[1], &time_ms)) {
+        return;
+    }
+    beginEpoch(time_ms);
+    epoch_.has_rmc = true;
+    rmc_seen_ = true;
+    // Status A is a valid fix; NMEA 2.3 adds a mode indicator, N for no fix
+    if (f[2] != "A" || (count > 12 && f[12] == "N")) {
+        epoch_.valid = false;
+    }
+    QDate date;
+    if (parseDate(f[9], &date)) {
+        date_ = date;
+    }
+    double latitude = 0.0;
+    double longitude = 0.0;
+    if (parseAngle(f[3], f[4], 90.0, &latitude) && parseAngle(f[5], f[6], 180.0, &longitude)) {
+        epoch_.latitude = latitude;
+        epoch_.longitude = longitude;
+        epoch_.has_position = true;
+    }
+    double value = 0.0;
+    if (parseDouble(f[7], &value)) {
+        epoch_.speed_mps = value * kKnotsToMetresPerSecond;
+    }
+    if (parseDouble(f[8], &value)) {
+        epoch_.course_deg = value;
+    }
+    completeEpoch();
+}
+
+void NmeaParser::handleGga(const Fields& f, int count) {
+    int time_ms = 0;
+    if (count < 10 || !parseTime(f[1], &time_ms)) {
+        return;
+    }
+    beginEpoch(time_ms);
+    epoch_.has_gga = true;
+    gga_seen_ = true;
+    int quality = 0;
+    if (!parseInt(f[6], &quality) || quality == 0) {
+        epoch_.valid = false;
+    }
+    double latitude = 0.0;
+    double longitude = 0.0;
+    if (!epoch_.has_position && parseAngle(f[2], f[3], 90.0, &latitude) &&
+        parseAngle(f[4], f[5], 180.0, &longitude)) {
+        epoch_.latitude = latitude;
+        epoch_.longitude = longitude;
+        epoch_.has_position = true;
+    }
+    double value = 0.0;
+    if (parseDouble(f[8], &value)) {
+        epoch_.hdop = value;
+    }
+    if (parseDouble(f[9], &value)) {
+        epoch_.altitude_m = value;
+        epoch_.has_altitude = true;
+    }
+    completeEpoch();
+}
+
+void NmeaParser::handleGll(const Fields& f, int count) {
+    int time_ms = 0;
+    if (count < 7 || !parseTime(f[5], &time_ms)) {
+        return;
+    }
+    beginEpoch(time_ms);
+    if (f[6] != "A" || (count > 7 && f[7] == "N")) {
+        epoch_.valid = false;
+    }
+    double latitude = 0.0;
+    double longitude = 0.0;
+    if (!epoch_.has_position && parseAngle(f[1], f[2], 90.0, &latitude) &&
+        parseAngle(f[3], f[4], 180.0, &longitude)) {
+        epoch_.latitude = latitude;
+        epoch_.longitude = longitude;
+        epoch_.has_position = true;
+    }
+    completeEpoch();
+}
+
+void NmeaParser::handleGst(const Fields& f, int count) {
+    // Usually sent after the epoch's fix, so applied from the next one
+    double latitude_sigma = 0.0;
+    double longitude_sigma = 0.0;
+    if (count < 9 || !parseDouble(f[6], &latitude_sigma) ||
+        !parseDouble(f[7], &longitude_sigma)) {
+        return;
+    }
+    gst_horizontal_m_ =
+        std::sqrt(latitude_sigma * latitude_sigma + longitude_sigma * longitude_sigma);
+    double altitude_sigma = 0.0;
+    gst_vertical_m_ = parseDouble(f[8], &altitude_sigma) ? altitude_sigma : -1.0;
+}
+
+void NmeaParser::handleGsa(std::string_view talker, const Fields& f, int count) {
+    if (count < 18) {
+        return;
+    }
+    Constellation group = constellationOfTalker(talker);
+    int system_id = 0;
+    if (count > 18 && parseInt(f[18], &system_id)) {
+        group = constellationOfSystemId(system_id);
+    }
+
+    QSet<int> prns;
+    for (int i = 3; i <= 14; ++i) {
+        int prn = 0;
+        if (parseInt(f[i], &prn) && prn > 0) {
+            // A combined GN sentence without system ID covers one constellation's PRNs
+            if (group == Constellation::Unknown) {
+                group = gsaGroupOf(constellationOf(Constellation::Unknown, prn));
+            }
+            prns.insert(prn);
+        }
+    }
+    double value = 0.0;
+    if (parseDouble(f[16], &value)) {
+        gsa_hdop_ = value;
+    }
+    if (parseDouble(f[17], &value)) {
+        gsa_vdop_ = value;
+    }
+    if (group == Constellation::Unknown) {
+        return;
+    }
+    auto it = used_.find(group);
+    if (it == used_.end() || *it != prns) {
+        used_.insert(group, prns);
+        satellites_changed_ = true;
+    }
+}
+
+void NmeaParser::handleGsv(std::string_view talker, const Fields& f, int count) {
+    int total = 0;
+    int number = 0;
+    if (count < 4 || !parseInt(f[1], &total) || !parseInt(f[2], &number) || number < 1 ||
+        number > total) {
+        return;
+    }
+    // NMEA 4.10 appends a signal ID after the satellite blocks
+    const int blocks = (count - 4) / 4;
+    int signal_id = 0;
+    if ((count - 4) % 4 == 1) {
+        parseInt(f[count - 1], &signal_id);
+    }
+    const Constellation talker_constellation = constellationOfTalker(talker);
+    const int key = int(talker_constellation) * 16 + (signal_id & 0xf);
+
+    QList<Satellite>& pending = gsv_pending_[key];
+    if (number == 1) {
+        pending.clear();
+    }
+    for (int block = 0; block < blocks; ++block) {
+        const int i = 4 + block * 4;
+        Satellite satellite;
+        if (!parseInt(f[i], &satellite.prn) || satellite.prn == 0) {
+            continue;
+        }
+        satellite.constellation = constellationOf(talker_constellation, satellite.prn);
+        if (!parseInt(f[i + 1], &satellite.elevation_deg)) {
+            satellite.elevation_deg = -1;
+        }
+        if (!parseInt(f[i + 2], &satellite.azimuth_deg)) {
+            satellite.azimuth_deg = -1;
+        }
+        if (!parseInt(f[i + 3], &satellite.snr_db)) {
+            satellite.snr_db = -1;
+        }
+        pending.append(satellite);
+    }
+    if (number == total) {
+        gsv_view_.insert(key, pending);
+        gsv_pending_.remove(key);
+        satellites_changed_ = true;
+    }
+}
+
+void NmeaParser::beginEpoch(int time_ms) {
+    if (time_ms == epoch_.time_ms) {
+        return;
+    }
+    // Past midnight before the first RMC of the new day, or without any RMC
+    constexpr int kHalfDayMs = 12 * 3600 * 1000;
+    if (date_.isValid() && epoch_.time_ms - time_ms > kHalfDayMs) {
+        date_ = date_.addDays(1);
+    }
+    if (epoch_.time_ms >= 0) {
+        epoch_seen_ = true;
+        if (!epoch_.reported) {
+            reportEpoch();
+        }
+    }
+    // GSA and GSV follow the epoch's fix; report them once per epoch
+    reportSatellites();
+    epoch_ = Epoch();
+    epoch_.time_ms = time_ms;
+}
+
+void NmeaParser::completeEpoch() {
+    // Wait for both RMC and GGA, unless a whole epoch showed the receiver is not sending
+    // one of them; otherwise the epoch is reported when the next one begins
+    if (epoch_.reported) {
+        return;
+    }
+    if ((epoch_.has_rmc && epoch_.has_gga) ||
+        (epoch_seen_ && (epoch_.has_rmc || !rmc_seen_) && (epoch_.has_gga || !gga_seen_))) {
+        reportEpoch();
+    }
+}
+
+void NmeaParser::reportEpoch() {
+    epoch_.reported = true;
+    if (!epoch_.valid || !epoch_.has_position) {
+        return;
+    }
+
+    const QGeoCoordinate coordinate =
+        epoch_.has_altitude ? QGeoCoordinate(epoch_.latitude, epoch_.longitude, epoch_.altitude_m)
+                            : QGeoCoordinate(epoch_.latitude, epoch_.longitude);
+    const QDate date = date_.isValid() ? date_ : QDateTime::currentDateTimeUtc().date();
+    QGeoPositionInfo info(coordinate,
+                          QDateTime(date, QTime::fromMSecsSinceStartOfDay(epoch_.time_ms),
+                                    QTimeZone::utc()));
+    if (epoch_.speed_mps >= 0.0) {
+        info.setAttribute(QGeoPositionInfo::GroundSpeed, epoch_.speed_mps);
+    }
+    if (epoch_.course_deg >= 0.0) {
+        info.setAttribute(QGeoPositionInfo::Direction, epoch_.course_deg);
+    }
+    const double hdop = epoch_.hdop >= 0.0 ? epoch_.hdop : gsa_hdop_;
+    if (gst_horizontal_m_ >= 0.0) {
+        info.setAttribute(QGeoPositionInfo::HorizontalAccuracy, gst_horizontal_m_);
+    } else if (hdop >= 0.0) {
+        info.setAttribute(QGeoPositionInfo::HorizontalAccuracy, hdop * kUereMetres);
+    }
+    if (gst_vertical_m_ >= 0.0) {
+        info.setAttribute(QGeoPositionInfo::VerticalAccuracy, gst_vertical_m_);
+    } else if (gsa_vdop_ >= 0.0) {
+        info.setAttribute(QGeoPositionInfo::VerticalAccuracy, gsa_vdop_ * kUereMetres);
+    }
+
+    ++stats_.fixes;
+    if (fix_handler_) {
+        fix_handler_(info);
+    }
+}
+
+void NmeaParser::reportSatellites() {
+    if (!satellites_changed_) {
+        return;
+    }
+    satellites_changed_ = false;
+    if (satellite_handler_) {
+        satellite_handler_(satellites());
+    }
+}
+
+QList<NmeaParser::Satellite> NmeaParser::satellites() const {
+    // A satellite tracked on several signals is listed once, with its strongest one
+    QList<Satellite> result;
+    QHash<quint32, qsizetype> index;
+    for (const QList<Satellite>& view : gsv_view_) {
+        for (Satellite satellite : view) {
+            const quint32 key = (quint32(satellite.constellation) << 16) | quint32(satellite.prn);
+            const auto existing = index.constFind(key);
+            if (existing != index.cend()) {
+                Satellite& kept = result[*existing];
+                kept.snr_db = std::max(kept.snr_db, satellite.snr_db);
+                continue;
+            }
+            satellite.in_use =
+                used_.value(gsaGroupOf(satellite.constellation)).contains(satellite.prn);
+            index.insert(key, result.size());
+            result.append(satellite);
+        }
+    }
+    return result;
+}
+
+}  // namespace opencardev::crankshaft::core::location
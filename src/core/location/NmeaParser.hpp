@@ -0,0 +1,155 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QDate>
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QtPositioning/QGeoPositionInfo>
+#include <array>
+#include <functional>
+#include <string_view>
+
+namespace opencardev::crankshaft::core::location {
+
+/**
+ * Incremental NMEA 0183 parser for GNSS receivers.
+ *
+ * Bytes are fed as they are read, in chunks of any size. Sentences that lie wholly inside
+ * a chunk are parsed in place; only a sentence split across reads is copied into a small
+ * carry buffer. Sentences without a valid checksum are dropped.
+ *
+ * RMC, GGA, GLL and GST sentences sharing a UTC time make up one epoch, reported as a
+ * single fix once both RMC and GGA have arrived (or only the one the receiver sends), so
+ * 10 Hz receivers give ten fixes a second. GSA and GSV are understood for every talker
+ * (GP, GL, GA, GB/BD, GQ, GI and combined GN, including the NMEA 4.10 system and signal
+ * IDs); the satellites in view are reported once per epoch when they changed.
+ *
+ * Not thread-safe; use from a single (reader) thread.
+ */
+class NmeaParser {
+  public:
+    // Longest sentence accepted; the standard allows 82 characters
+    static constexpr int kMaxSentenceLength = 128;
+
+    enum class Constellation { Unknown, Gps, Sbas, Glonass, Galileo, BeiDou, Qzss, NavIC };
+
+    struct Satellite {
+        Constellation constellation = Constellation::Unknown;
+        int prn = 0;
+        int elevation_deg = -1;  // -1 when not reported
+        int azimuth_deg = -1;
+        int snr_db = -1;  // -1 when not tracked
+        bool in_use = false;
+    };
+
+    struct Stats {
+        quint64 sentences = 0;        // Sentences with a valid checksum
+        quint64 checksum_errors = 0;  // Sentences dropped for a bad checksum
+        quint64 malformed = 0;        // Overlong, unterminated or without a checksum
+        quint64 fixes = 0;            // Valid fixes reported
+    };
+
+    using FixHandler = std::function<void(const QGeoPositionInfo&)>;
+    using SatelliteHandler = std::function<void(const QList<Satellite>&)>;
+
+    NmeaParser();
+
+    void setFixHandler(FixHandler handler) { fix_handler_ = std::move(handler); }
+    void setSatelliteHandler(SatelliteHandler handler) { satellite_handler_ = std::move(handler); }
+
+    // Parse the next bytes of the stream
+    void feed(const char* data, qsizetype size);
+    // Report the epoch in progress, e.g. at the end of a recording
+    void flush();
+    // Forget partial sentences and receiver state, keeping the handlers and stats
+    void reset();
+
+    const Stats& stats() const { return stats_; }
+    // Satellites in view across all constellations, with those used in the fix marked
+    QList<Satellite> satellites() const;
+
+  private:
+    static constexpr int kMaxFields = 32;
+    using Fields = std::array<std::string_view, kMaxFields>;
+
+    // Sentences sharing a UTC time
+    struct Epoch {
+        int time_ms = -1;  // Milliseconds since midnight UTC
+        bool has_rmc = false;
+        bool has_gga = false;
+        bool reported = false;
+        bool valid = true;  // Cleared by a void RMC or a no-fix GGA
+        bool has_position = false;
+        double latitude = 0.0;
+        double longitude = 0.0;
+        bool has_altitude = false;
+        double altitude_m = 0.0;
+        double speed_mps = -1.0;
+        double course_deg = -1.0;
+        double hdop = -1.0;
+    };
+
+    void handleLine(const char* begin, const char* end);
+    void handleSentence(std::string_view body);
+    void handleRmc(const Fields& f, int count);
+    void handleGga(const Fields& f, int count);
+    void handleGll(const Fields& f, int count);
+    void handleGst(const Fields& f, int count);
+    void handleGsa(std::string_view talker, const Fields& f, int count);
+    void handleGsv(std::string_view talker, const Fields& f, int count);
+
+    // Start a new epoch when time_ms differs from the current one
+    void beginEpoch(int time_ms);
+    void completeEpoch();
+    void reportEpoch();
+    void reportSatellites();
+
+    FixHandler fix_handler_;
+    SatelliteHandler satellite_handler_;
+    Stats stats_;
+
+    // Sentence split across feed() calls, starting at its '$'
+    std::array<char, kMaxSentenceLength> carry_;
+    int carry_length_;
+    bool discarding_;  // Skipping the rest of an overlong sentence
+
+    Epoch epoch_;
+    QDate date_;  // From the last RMC
+    bool rmc_seen_;
+    bool gga_seen_;
+    bool epoch_seen_;  // A whole epoch has been received
+    double gsa_hdop_;  // From the last GSA, for receivers that send no GGA
+    double gsa_vdop_;
+    double gst_horizontal_m_;  // Error estimates from the last GST
+    double gst_vertical_m_;
+
+    // GSV sequences being received, and the last complete one, per constellation and
+    // signal (constellation * 16 + signal ID)
+    QMap<int, QList<Satellite>> gsv_pending_;
+    QMap<int, QList<Satellite>> gsv_view_;
+    // PRNs used in the fix per constellation, from GSA
+    QMap<Constellation, QSet<int>> used_;
+    bool satellites_changed_;
+};
+
+}  // namespace opencardev::crankshaft::core::location
@@ -0,0 +1,292 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "NmeaSerialSource.hpp"
+#include <QDebug>
+#include <QMutexLocker>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include "LocationHub.hpp"
+
+namespace opencardev::crankshaft::core::location {
+
+namespace {
+
+constexpr int kReopenDelayMs = 1000;
+constexpr int kDefaultRequestTimeoutMs = 5000;
+
+speed_t baudConstant(int baud_rate) {
+    switch (baud_rate) {
+        case 4800:
+            return B4800;
+        case 9600:
+            return B9600;
+        case 19200:
+            return B19200;
+        case 38400:
+            return B38400;
+        case 57600:
+            return B57600;
+        case 115200:
+            return B115200;
+        case 230400:
+            return B230400;
+        case 460800:
+            return B460800;
+        default:
+            qWarning() << "Unsupported NMEA baud rate" << baud_rate << "- using 9600";
+            return B9600;
+    }
+}
+
+}  // namespace
+
+NmeaSerialSource::NmeaSerialSource(const QString& device, int baud_rate, QObject* parent)
+    : QGeoPositionInfoSource(parent),
+      device_(device),
+      baud_rate_(baud_rate),
+      error_(NoError),
+      updates_requested_(false),
+      single_update_(false),
+      wake_pipe_{-1, -1},
+      stop_requested_(false),
+      interval_ms_(0),
+      next_fix_wanted_(false) {
+    request_timer_.setSingleShot(true);
+    connect(&request_timer_, &QTimer::timeout, this, [this]() {
+        single_update_ = false;
+        if (!updates_requested_) {
+            stopReader();
+        }
+        setError(UpdateTimeoutError);
+    });
+}
+
+NmeaSerialSource::~NmeaSerialSource() {
+    stopReader();
+}
+
+void NmeaSerialSource::setUpdateInterval(int msec) {
+    QGeoPositionInfoSource::setUpdateInterval(msec);
+    interval_ms_.store(updateInterval(), std::memory_order_relaxed);
+}
+
+QGeoPositionInfo NmeaSerialSource::lastKnownPosition(bool) const {
+    QMutexLocker locker(&mutex_);
+    return last_fix_;
+}
+
+QGeoPositionInfoSource::PositioningMethods NmeaSerialSource::supportedPositioningMethods() const {
+    return SatellitePositioningMethods;
+}
+
+QList<NmeaParser::Satellite> NmeaSerialSource::satellites() const {
+    QMutexLocker locker(&mutex_);
+    return satellites_;
+}
+
+NmeaParser::Stats NmeaSerialSource::parserStats() const {
+    QMutexLocker locker(&mutex_);
+    return stats_;
+}
+
+void NmeaSerialSource::startUpdates() {
+    updates_requested_ = true;
+    startReader();
+}
+
+void NmeaSerialSource::stopUpdates() {
+    updates_requested_ = false;
+    if (!single_update_) {
+        stopReader();
+    }
+}
+
+void NmeaSerialSource::requestUpdate(int timeout) {
+    if (timeout < 0) {
+        setError(UpdateTimeoutError);
+        return;
+    }
+    single_update_ = true;
+    next_fix_wanted_.store(true, std::memory_order_relaxed);
+    request_timer_.start(timeout > 0 ? timeout : kDefaultRequestTimeoutMs);
+    startReader();
+}
+
+void NmeaSerialSource::startReader() {
+    if (thread_.joinable()) {
+        return;
+    }
+    if (::pipe2(wake_pipe_, O_CLOEXEC | O_NONBLOCK) != 0) {
+        qWarning() << "NMEA receiver: cannot create wake pipe:" << strerror(errno);
+        setError(UnknownSourceError);
+        return;
+    }
+    stop_requested_.store(false);
+    thread_ = std::thread(&NmeaSerialSource::run, this);
+}
+
+void NmeaSerialSource::stopReader() {
+    if (!thread_.joinable()) {
+        return;
+    }
+    stop_requested_.store(true);
+    const char wake = 1;
+    if (::write(wake_pipe_[1], &wake, 1) < 0) {
+        qWarning() << "NMEA receiver: cannot wake reader:" << strerror(errno);
+    }
+    thread_.join();
+    ::close(wake_pipe_[0]);
+    ::close(wake_pipe_[1]);
+    wake_pipe_[0] = wake_pipe_[1] = -1;
+}
+
+int NmeaSerialSource::openDevice() const {
+    const int fd = ::open(device_.toLocal8Bit().constData(),
+                          O_RDONLY | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    // Raw 8N1; anything that is not a terminal (a FIFO, say) is read as it is
+    termios tio{};
+    if (::tcgetattr(fd, &tio) == 0) {
+        ::cfmakeraw(&tio);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tio.c_cc[VMIN] = 1;
+        tio.c_cc[VTIME] = 0;
+        const speed_t speed = baudConstant(baud_rate_);
+        ::cfsetispeed(&tio, speed);
+        ::cfsetospeed(&tio, speed);
+        if (::tcsetattr(fd, TCSANOW, &tio) != 0) {
+            qWarning() << "NMEA receiver: cannot configure" << device_ << strerror(errno);
+        }
+    }
+    return fd;
+}
+
+bool NmeaSerialSource::waitForStop(int timeout_ms) const {
+    pollfd wake{wake_pipe_[0], POLLIN, 0};
+    ::poll(&wake, 1, timeout_ms);
+    return stop_requested_.load();
+}
+
+void NmeaSerialSource::run() {
+    NmeaParser parser;
+    qint64 last_posted_ms = -1;
+    parser.setFixHandler([this, &last_posted_ms](const QGeoPositionInfo& info) {
+        const qint64 time_ms = info.timestamp().toMSecsSinceEpoch();
+        const int interval = interval_ms_.load(std::memory_order_relaxed);
+        const bool wanted = next_fix_wanted_.exchange(false, std::memory_order_relaxed);
+        if (!wanted && last_posted_ms >= 0 &&
+            !LocationHub::intervalElapsed(time_ms - last_posted_ms, interval)) {
+            return;
+        }
+        last_posted_ms = time_ms;
+        QMetaObject::invokeMethod(this, [this, info]() { deliver(info); },
+                                  Qt::QueuedConnection);
+    });
+    parser.setSatelliteHandler([this](const QList<NmeaParser::Satellite>& satellites) {
+        {
+            QMutexLocker locker(&mutex_);
+            satellites_ = satellites;
+        }
+        QMetaObject::invokeMethod(
+            this, [this, satellites]() { emit satellitesUpdated(satellites); },
+            Qt::QueuedConnection);
+    });
+
+    char buffer[4096];
+    bool open_failed = false;
+    while (!stop_requested_.load()) {
+        const int fd = openDevice();
+        if (fd < 0) {
+            if (!open_failed) {
+                qWarning() << "NMEA receiver: cannot open" << device_ << strerror(errno);
+                QMetaObject::invokeMethod(this, [this]() { setError(AccessError); },
+                                          Qt::QueuedConnection);
+                open_failed = true;
+            }
+            waitForStop(kReopenDelayMs);
+            continue;
+        }
+        qInfo() << "NMEA receiver: reading" << device_ << "at" << baud_rate_ << "baud";
+        open_failed = false;
+        parser.reset();
+
+        for (;;) {
+            pollfd fds[2] = {{fd, POLLIN, 0}, {wake_pipe_[0], POLLIN, 0}};
+            if (::poll(fds, 2, -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            if (fds[1].revents != 0) {
+                break;
+            }
+            const ssize_t count = ::read(fd, buffer, sizeof(buffer));
+            if (count > 0) {
+                parser.feed(buffer, count);
+                QMutexLocker locker(&mutex_);
+                stats_ = parser.stats();
+                continue;
+            }
+            if (count < 0 && (errno == EAGAIN || errno == EINTR)) {
+                continue;
+            }
+            // Unplugged, or the other end of a pseudo-terminal closed
+            qWarning() << "NMEA receiver: lost" << device_;
+            QMetaObject::invokeMethod(this, [this]() { setError(ClosedError); },
+                                      Qt::QueuedConnection);
+            break;
+        }
+        parser.flush();
+        ::close(fd);
+        if (!stop_requested_.load()) {
+            waitForStop(kReopenDelayMs);
+        }
+    }
+}
+
+void NmeaSerialSource::deliver(const QGeoPositionInfo& info) {
+    {
+        QMutexLocker locker(&mutex_);
+        last_fix_ = info;
+    }
+    emit positionUpdated(info);
+    if (single_update_) {
+        single_update_ = false;
+        request_timer_.stop();
+        if (!updates_requested_) {
+            stopReader();
+        }
+    }
+}
+
+void NmeaSerialSource::setError(Error error) {
+    error_ = error;
+    emit errorOccurred(error);
+}
+
+}  // namespace opencardev::crankshaft::core::location
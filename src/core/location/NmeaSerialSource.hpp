@@ -0,0 +1,106 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QTimer>
+#include <QtPositioning/QGeoPositionInfoSource>
+#include <atomic>
+#include <thread>
+#include "NmeaParser.hpp"
+
+namespace opencardev::crankshaft::core::location {
+
+/**
+ * Position source reading NMEA 0183 from a serial GNSS receiver (USB dongle or Hat UART).
+ *
+ * The device is read on a dedicated thread that parses sentences as they arrive and posts
+ * fixes to the source's thread, decimated to the update interval there already; the GUI
+ * thread is not woken for sentences nobody asked for. An unplugged or unopenable device
+ * is retried every second until updates are stopped.
+ */
+class NmeaSerialSource : public QGeoPositionInfoSource {
+    Q_OBJECT
+
+  public:
+    static constexpr int kDefaultBaudRate = 9600;
+
+    explicit NmeaSerialSource(const QString& device, int baud_rate = kDefaultBaudRate,
+                              QObject* parent = nullptr);
+    ~NmeaSerialSource() override;
+
+    QString device() const { return device_; }
+    int baudRate() const { return baud_rate_; }
+    bool isReading() const { return thread_.joinable(); }
+
+    void setUpdateInterval(int msec) override;
+    QGeoPositionInfo lastKnownPosition(
+        bool fromSatellitePositioningMethodsOnly = false) const override;
+    PositioningMethods supportedPositioningMethods() const override;
+    // 10 Hz, the fastest rate of common receivers
+    int minimumUpdateInterval() const override { return 100; }
+    Error error() const override { return error_; }
+
+    // Satellites in view from the last complete GSV set
+    QList<NmeaParser::Satellite> satellites() const;
+    NmeaParser::Stats parserStats() const;
+
+  public slots:
+    void startUpdates() override;
+    void stopUpdates() override;
+    void requestUpdate(int timeout = 0) override;
+
+  signals:
+    void satellitesUpdated(const QList<NmeaParser::Satellite>& satellites);
+
+  private:
+    void startReader();
+    void stopReader();
+    // Reader thread
+    void run();
+    int openDevice() const;
+    bool waitForStop(int timeout_ms) const;
+    // Source thread
+    void deliver(const QGeoPositionInfo& info);
+    void setError(Error error);
+
+    const QString device_;
+    const int baud_rate_;
+    Error error_;
+    bool updates_requested_;  // startUpdates() rather than a single requestUpdate()
+    bool single_update_;
+    QTimer request_timer_;
+
+    std::thread thread_;
+    int wake_pipe_[2];  // Written by stopReader() to interrupt the reader's poll()
+    std::atomic<bool> stop_requested_;
+    std::atomic<int> interval_ms_;
+    std::atomic<bool> next_fix_wanted_;  // Post the next fix whatever the interval
+
+    mutable QMutex mutex_;  // Guards the members below
+    QGeoPositionInfo last_fix_;
+    QList<NmeaParser::Satellite> satellites_;
+    NmeaParser::Stats stats_;
+};
+
+}  // namespace opencardev::crankshaft::core::location
@@ -0,0 +1,282 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "PositionFilter.hpp"
+#include <QDateTime>
+#include <QTimeZone>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace opencardev::crankshaft::core::location {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kMetresPerDegreeLat = 6371008.8 * kPi / 180.0;  // Mean Earth radius
+// Move the plane's anchor once the estimate is this far from it, which keeps the
+// flat-earth error to centimetres
+constexpr double kMaxAnchorDistanceM = 10000.0;
+// Below this speed the direction of the estimated velocity is mostly noise
+constexpr double kMinHeadingSpeed = 0.5;
+// Velocity uncertainty when starting from a fix that reports no speed, in m/s
+constexpr double kUnknownVelocitySigma = 30.0;
+
+double square(double value) {
+    return value * value;
+}
+
+qint64 fixTimeMs(const QGeoPositionInfo& fix) {
+    return fix.timestamp().isValid() ? fix.timestamp().toMSecsSinceEpoch()
+                                     : QDateTime::currentMSecsSinceEpoch();
+}
+
+double headingOf(double east_velocity, double north_velocity) {
+    const double degrees = std::atan2(east_velocity, north_velocity) * 180.0 / kPi;
+    return degrees < 0.0 ? degrees + 360.0 : degrees;
+}
+
+// Velocity reported with a fix, split into east and north
+bool fixVelocity(const QGeoPositionInfo& fix, double* east, double* north) {
+    if (!fix.hasAttribute(QGeoPositionInfo::GroundSpeed) ||
+        !fix.hasAttribute(QGeoPositionInfo::Direction)) {
+        return false;
+    }
+    const double speed = fix.attribute(QGeoPositionInfo::GroundSpeed);
+    const double heading = fix.attribute(QGeoPositionInfo::Direction) * kPi / 180.0;
+    if (std::isnan(speed) || std::isnan(heading)) {
+        return false;
+    }
+    *east = speed * std::sin(heading);
+    *north = speed * std::cos(heading);
+    return true;
+}
+
+}  // namespace
+
+void PositionFilter::Axis::predict(double dt, double q) {
+    const double dt2 = dt * dt;
+    position += velocity * dt;
+    p00 += 2.0 * dt * p01 + dt2 * p11 + q * dt2 * dt / 3.0;
+    p01 += dt * p11 + q * dt2 / 2.0;
+    p11 += q * dt;
+}
+
+void PositionFilter::Axis::updatePosition(double measured, double variance) {
+    const double s = p00 + variance;
+    const double k0 = p00 / s;
+    const double k1 = p01 / s;
+    const double innovation = measured - position;
+    position += k0 * innovation;
+    velocity += k1 * innovation;
+    p11 -= k1 * p01;
+    p01 -= k0 * p01;
+    p00 -= k0 * p00;
+}
+
+void PositionFilter::Axis::updateVelocity(double measured, double variance) {
+    const double s = p11 + variance;
+    const double k0 = p01 / s;
+    const double k1 = p11 / s;
+    const double innovation = measured - velocity;
+    position += k0 * innovation;
+    velocity += k1 * innovation;
+    p00 -= k0 * p01;
+    p01 -= k0 * p11;
+    p11 -= k1 * p11;
+}
+
+PositionFilter::PositionFilter(const Settings& settings)
+    : settings_(settings),
+      initialised_(false),
+      metres_per_degree_lon_(kMetresPerDegreeLat),
+      time_ms_(0),
+      altitude_(std::numeric_limits<double>::quiet_NaN()),
+      direction_(-1.0),
+      rejections_(0) {}
+
+void PositionFilter::reset() {
+    initialised_ = false;
+    rejections_ = 0;
+    direction_ = -1.0;
+}
+
+PositionFilter::Result PositionFilter::update(const QGeoPositionInfo& fix) {
+    if (!fix.isValid() || !fix.coordinate().isValid()) {
+        return Result::Stale;
+    }
+    if (!initialised_) {
+        initialise(fix);
+        return Result::Initialised;
+    }
+    const qint64 time_ms = fixTimeMs(fix);
+    if (time_ms <= time_ms_) {
+        return Result::Stale;
+    }
+
+    // Work on a copy so an outlier leaves the filter as it was
+    const double dt = double(time_ms - time_ms_) / 1000.0;
+    const double q = square(settings_.acceleration_noise);
+    Axis east = east_;
+    Axis north = north_;
+    east.predict(dt, q);
+    north.predict(dt, q);
+
+    const QGeoCoordinate coordinate = fix.coordinate();
+    double longitude_delta = coordinate.longitude() - anchor_.longitude();
+    if (longitude_delta > 180.0) {
+        longitude_delta -= 360.0;
+    } else if (longitude_delta < -180.0) {
+        longitude_delta += 360.0;
+    }
+    const double measured_east = longitude_delta * metres_per_degree_lon_;
+    const double measured_north =
+        (coordinate.latitude() - anchor_.latitude()) * kMetresPerDegreeLat;
+    const double variance = square(fix.hasAttribute(QGeoPositionInfo::HorizontalAccuracy)
+                                       ? fix.attribute(QGeoPositionInfo::HorizontalAccuracy)
+                                       : settings_.default_accuracy_m);
+
+    const double distance2 = square(measured_east - east.position) / (east.p00 + variance) +
+                             square(measured_north - north.position) / (north.p00 + variance);
+    if (!(distance2 <= settings_.gate)) {
+        ++stats_.rejected;
+        if (++rejections_ < settings_.max_rejections) {
+            return Result::Rejected;
+        }
+        ++stats_.restarts;
+        initialise(fix);
+        return Result::Initialised;
+    }
+
+    rejections_ = 0;
+    east.updatePosition(measured_east, variance);
+    north.updatePosition(measured_north, variance);
+    double east_velocity = 0.0;
+    double north_velocity = 0.0;
+    if (fixVelocity(fix, &east_velocity, &north_velocity)) {
+        const double velocity_variance = square(settings_.velocity_noise);
+        east.updateVelocity(east_velocity, velocity_variance);
+        north.updateVelocity(north_velocity, velocity_variance);
+    }
+    east_ = east;
+    north_ = north;
+    time_ms_ = time_ms;
+    if (coordinate.type() == QGeoCoordinate::Coordinate3D) {
+        altitude_ = coordinate.altitude();
+    }
+    if (std::hypot(east_.velocity, north_.velocity) >= kMinHeadingSpeed) {
+        direction_ = headingOf(east_.velocity, north_.velocity);
+    }
+    ++stats_.accepted;
+
+    if (std::hypot(east_.position, north_.position) > kMaxAnchorDistanceM) {
+        setAnchor(toCoordinate(east_.position, north_.position));
+        east_.position = 0.0;
+        north_.position = 0.0;
+    }
+    return Result::Accepted;
+}
+
+void PositionFilter::initialise(const QGeoPositionInfo& fix) {
+    const QGeoCoordinate coordinate = fix.coordinate();
+    setAnchor(coordinate);
+    const double variance = square(fix.hasAttribute(QGeoPositionInfo::HorizontalAccuracy)
+                                       ? fix.attribute(QGeoPositionInfo::HorizontalAccuracy)
+                                       : settings_.default_accuracy_m);
+    double east_velocity = 0.0;
+    double north_velocity = 0.0;
+    const bool has_velocity = fixVelocity(fix, &east_velocity, &north_velocity);
+    const double velocity_variance =
+        square(has_velocity ? settings_.velocity_noise : kUnknownVelocitySigma);
+    east_ = Axis{0.0, east_velocity, variance, 0.0, velocity_variance};
+    north_ = Axis{0.0, north_velocity, variance, 0.0, velocity_variance};
+
+    time_ms_ = fixTimeMs(fix);
+    altitude_ = coordinate.type() == QGeoCoordinate::Coordinate3D
+                    ? coordinate.altitude()
+                    : std::numeric_limits<double>::quiet_NaN();
+    direction_ = fix.hasAttribute(QGeoPositionInfo::Direction)
+                     ? fix.attribute(QGeoPositionInfo::Direction)
+                     : -1.0;
+    rejections_ = 0;
+    initialised_ = true;
+}
+
+void PositionFilter::setAnchor(const QGeoCoordinate& anchor) {
+    anchor_ = QGeoCoordinate(anchor.latitude(), anchor.longitude());
+    metres_per_degree_lon_ =
+        std::max(1.0, kMetresPerDegreeLat * std::cos(anchor.latitude() * kPi / 180.0));
+}
+
+QGeoCoordinate PositionFilter::toCoordinate(double east, double north) const {
+    const double latitude =
+        std::clamp(anchor_.latitude() + north / kMetresPerDegreeLat, -90.0, 90.0);
+    double longitude = anchor_.longitude() + east / metres_per_degree_lon_;
+    if (longitude > 180.0) {
+        longitude -= 360.0;
+    } else if (longitude < -180.0) {
+        longitude += 360.0;
+    }
+    return std::isnan(altitude_) ? QGeoCoordinate(latitude, longitude)
+                                 : QGeoCoordinate(latitude, longitude, altitude_);
+}
+
+QGeoPositionInfo PositionFilter::makeFix(double east, double north, double east_velocity,
+                                         double north_velocity, double variance,
+                                         qint64 time_ms) const {
+    QGeoPositionInfo fix(toCoordinate(east, north),
+                         QDateTime::fromMSecsSinceEpoch(time_ms, QTimeZone::utc()));
+    const double speed = std::hypot(east_velocity, north_velocity);
+    fix.setAttribute(QGeoPositionInfo::GroundSpeed, speed);
+    if (speed >= kMinHeadingSpeed) {
+        fix.setAttribute(QGeoPositionInfo::Direction, headingOf(east_velocity, north_velocity));
+    } else if (direction_ >= 0.0) {
+        fix.setAttribute(QGeoPositionInfo::Direction, direction_);
+    }
+    fix.setAttribute(QGeoPositionInfo::HorizontalAccuracy, std::sqrt(variance));
+    return fix;
+}
+
+QGeoPositionInfo PositionFilter::estimate() const {
+    if (!initialised_) {
+        return QGeoPositionInfo();
+    }
+    return makeFix(east_.position, north_.position, east_.velocity, north_.velocity,
+                   (east_.p00 + north_.p00) / 2.0, time_ms_);
+}
+
+QGeoPositionInfo PositionFilter::predict(qint64 elapsed_ms) const {
+    if (!initialised_) {
+        return QGeoPositionInfo();
+    }
+    const double dt =
+        double(std::clamp<qint64>(elapsed_ms, 0, settings_.max_prediction_ms)) / 1000.0;
+    // Position variance grown as in Axis::predict(), without touching the state
+    const double dt2 = dt * dt;
+    const double growth = square(settings_.acceleration_noise) * dt2 * dt / 3.0;
+    const double east_variance = east_.p00 + 2.0 * dt * east_.p01 + dt2 * east_.p11 + growth;
+    const double north_variance =
+        north_.p00 + 2.0 * dt * north_.p01 + dt2 * north_.p11 + growth;
+    return makeFix(east_.position + east_.velocity * dt, north_.position + north_.velocity * dt,
+                   east_.velocity, north_.velocity, (east_variance + north_variance) / 2.0,
+                   time_ms_ + std::max<qint64>(elapsed_ms, 0));
+}
+
+}  // namespace opencardev::crankshaft::core::location
@@ -0,0 +1,128 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QtGlobal>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtPositioning/QGeoPositionInfo>
+
+namespace opencardev::crankshaft::core::location {
+
+/**
+ * Constant-velocity Kalman filter over GNSS fixes, with dead reckoning between them.
+ *
+ * The state is position and velocity in metres on a local east/north plane anchored near
+ * the vehicle. Under a white-noise acceleration model the two axes are independent, so
+ * the filter runs as two 2-state filters rather than one 4-state one. Each fix is weighted
+ * by its horizontal accuracy; its speed and heading, when reported, are fused as a
+ * velocity measurement.
+ *
+ * A fix too far from the prediction for the combined uncertainty (a squared Mahalanobis
+ * distance beyond the gate) is rejected as an outlier, such as a multipath jump in an
+ * urban canyon. Several in a row restart the filter from the latest fix: by then it is
+ * more likely the filter that is wrong, after a tunnel or a receiver reset.
+ *
+ * predict() extrapolates the latest estimate without changing the filter. It costs a
+ * handful of multiplications, so the UI can call it on every frame.
+ */
+class PositionFilter {
+  public:
+    struct Settings {
+        // Spectral density of unmodelled acceleration, as a standard deviation in m/s²
+        double acceleration_noise = 2.0;
+        // Assumed for fixes that report no horizontal accuracy, in metres
+        double default_accuracy_m = 10.0;
+        // Standard deviation of a reported speed along its heading, in m/s
+        double velocity_noise = 0.5;
+        // Squared Mahalanobis distance beyond which a fix is an outlier; chi-squared with
+        // two degrees of freedom, so 13.8 rejects 0.1% of good fixes
+        double gate = 13.8;
+        // Consecutive outliers after which the filter restarts from the latest fix
+        int max_rejections = 3;
+        // How far past the latest fix predict() extrapolates before holding position
+        qint64 max_prediction_ms = 2000;
+    };
+
+    enum class Result {
+        Initialised,  // First fix, or a restart; the fix is taken as is
+        Accepted,
+        Rejected,  // Outlier; the estimate is unchanged
+        Stale      // Invalid, or not newer than the latest fix; ignored
+    };
+
+    struct Stats {
+        quint64 accepted = 0;
+        quint64 rejected = 0;
+        quint64 restarts = 0;
+    };
+
+    PositionFilter() : PositionFilter(Settings()) {}
+    explicit PositionFilter(const Settings& settings);
+
+    Result update(const QGeoPositionInfo& fix);
+    void reset();
+    bool isInitialised() const { return initialised_; }
+
+    // Filtered fix at the time of the latest accepted fix, with speed, heading and accuracy
+    QGeoPositionInfo estimate() const;
+    /**
+     * Estimate extrapolated at constant velocity, elapsed_ms after the latest accepted fix
+     * (capped at max_prediction_ms). Timestamped accordingly; invalid before the first fix.
+     */
+    QGeoPositionInfo predict(qint64 elapsed_ms) const;
+
+    const Settings& settings() const { return settings_; }
+    Stats stats() const { return stats_; }
+
+  private:
+    // Position and velocity along one axis, with their covariance
+    struct Axis {
+        double position = 0.0;
+        double velocity = 0.0;
+        double p00 = 0.0;  // Position variance
+        double p01 = 0.0;
+        double p11 = 0.0;  // Velocity variance
+
+        void predict(double dt, double q);
+        void updatePosition(double measured, double variance);
+        void updateVelocity(double measured, double variance);
+    };
+
+    void initialise(const QGeoPositionInfo& fix);
+    void setAnchor(const QGeoCoordinate& anchor);
+    QGeoCoordinate toCoordinate(double east, double north) const;
+    QGeoPositionInfo makeFix(double east, double north, double east_velocity,
+                             double north_velocity, double variance, qint64 time_ms) const;
+
+    Settings settings_;
+    bool initialised_;
+    Axis east_;
+    Axis north_;
+    QGeoCoordinate anchor_;
+    double metres_per_degree_lon_;
+    qint64 time_ms_;      // Of the latest accepted fix
+    double altitude_;     // From the latest accepted fix; NaN if none
+    double direction_;    // Heading kept while too slow to derive one; -1 if unknown
+    int rejections_;      // Consecutive outliers
+    Stats stats_;
+};
+
+}  // namespace opencardev::crankshaft::core::location
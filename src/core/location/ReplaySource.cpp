@@ -0,0 +1,399 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ReplaySource.hpp"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QXmlStreamReader>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "NmeaParser.hpp"
+
+namespace opencardev::crankshaft::core::location {
+
+namespace {
+
+constexpr int kDefaultIntervalMs = 100;
+// Fixes per event loop turn when replaying as fast as possible
+constexpr int kMaxBatch = 100;
+// Speed assumed for GPX points without timestamps
+constexpr double kAssumedSpeedMps = 50.0 / 3.6;
+// Closer points than this give no usable heading
+constexpr double kMinHeadingDistanceM = 0.5;
+
+double interpolateAngle(double from, double to, double fraction) {
+    const double delta = std::fmod(to - from + 540.0, 360.0) - 180.0;
+    return std::fmod(from + delta * fraction + 360.0, 360.0);
+}
+
+bool isGpxFile(const QString& path) {
+    const QString suffix = QFileInfo(path).suffix().toLower();
+    if (suffix == "gpx") {
+        return true;
+    }
+    if (suffix == "nmea" || suffix == "log") {
+        return false;
+    }
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    return file.peek(256).trimmed().startsWith('<');
+}
+
+}  // namespace
+
+ReplaySource::ReplaySource(QObject* parent)
+    : QGeoPositionInfoSource(parent),
+      speed_(1.0),
+      loop_(false),
+      running_(false),
+      error_(NoError),
+      origin_ms_(0),
+      next_ms_(0),
+      cursor_(0),
+      last_heading_(-1.0),
+      fixes_emitted_(0) {
+    timer_.setTimerType(Qt::PreciseTimer);
+    connect(&timer_, &QTimer::timeout, this, &ReplaySource::tick);
+}
+
+ReplaySource::~ReplaySource() = default;
+
+bool ReplaySource::load(const QString& path) {
+    path_ = path;
+    const bool loaded = isGpxFile(path) ? loadGpx(path) : loadNmea(path);
+    if (!loaded || points_.size() < 2) {
+        qWarning() << "Replay: no usable track in" << path;
+        points_.clear();
+        offsets_.clear();
+        setError(error_ == AccessError ? AccessError : UnknownSourceError);
+        return false;
+    }
+    qInfo() << "Replay: loaded" << points_.size() << "points," << duration() / 1000.0
+            << "s from" << path;
+    return true;
+}
+
+bool ReplaySource::loadGpx(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Replay: cannot open" << path << file.errorString();
+        error_ = AccessError;
+        return false;
+    }
+
+    // Prefer the recorded track; fall back to a planned route
+    QList<QGeoPositionInfo> track;
+    QList<QGeoPositionInfo> route;
+    QGeoPositionInfo point;
+    bool in_point = false;
+    double altitude = std::numeric_limits<double>::quiet_NaN();
+    QXmlStreamReader xml(&file);
+    while (!xml.atEnd()) {
+        xml.readNext();
+        const QStringView name = xml.name();
+        if (xml.isStartElement()) {
+            if (name == QLatin1String("trkpt") || name == QLatin1String("rtept")) {
+                const auto attributes = xml.attributes();
+                point = QGeoPositionInfo();
+                point.setCoordinate(QGeoCoordinate(attributes.value("lat").toDouble(),
+                                                   attributes.value("lon").toDouble()));
+                altitude = std::numeric_limits<double>::quiet_NaN();
+                in_point = true;
+            } else if (in_point && name == QLatin1String("ele")) {
+                bool ok = false;
+                const double value = xml.readElementText().toDouble(&ok);
+                altitude = ok ? value : altitude;
+            } else if (in_point && name == QLatin1String("time")) {
+                point.setTimestamp(
+                    QDateTime::fromString(xml.readElementText().trimmed(), Qt::ISODateWithMs));
+            } else if (in_point && name == QLatin1String("speed")) {
+                // GPX 1.0 and Garmin's TrackPointExtension, in m/s
+                bool ok = false;
+                const double value = xml.readElementText().toDouble(&ok);
+                if (ok) {
+                    point.setAttribute(QGeoPositionInfo::GroundSpeed, value);
+                }
+            } else if (in_point && name == QLatin1String("course")) {
+                bool ok = false;
+                const double value = xml.readElementText().toDouble(&ok);
+                if (ok) {
+                    point.setAttribute(QGeoPositionInfo::Direction, value);
+                }
+            }
+        } else if (xml.isEndElement() && in_point &&
+                   (name == QLatin1String("trkpt") || name == QLatin1String("rtept"))) {
+            if (!std::isnan(altitude)) {
+                QGeoCoordinate coordinate = point.coordinate();
+                coordinate.setAltitude(altitude);
+                point.setCoordinate(coordinate);
+            }
+            (name == QLatin1String("trkpt") ? track : route) << point;
+            in_point = false;
+        }
+    }
+    if (xml.hasError()) {
+        qWarning() << "Replay: invalid GPX" << path << "line" << xml.lineNumber()
+                   << xml.errorString();
+        return false;
+    }
+    prepareTrack(track.isEmpty() ? route : track);
+    return true;
+}
+
+bool ReplaySource::loadNmea(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Replay: cannot open" << path << file.errorString();
+        error_ = AccessError;
+        return false;
+    }
+    QList<QGeoPositionInfo> fixes;
+    NmeaParser parser;
+    parser.setFixHandler([&fixes](const QGeoPositionInfo& info) { fixes << info; });
+    const QByteArray data = file.readAll();
+    parser.feed(data.constData(), data.size());
+    parser.flush();
+    if (parser.stats().checksum_errors > 0) {
+        qWarning() << "Replay:" << parser.stats().checksum_errors
+                   << "NMEA sentences with bad checksums skipped in" << path;
+    }
+    prepareTrack(fixes);
+    return true;
+}
+
+void ReplaySource::setTrack(const QList<QGeoPositionInfo>& points) {
+    path_.clear();
+    prepareTrack(points);
+}
+
+void ReplaySource::prepareTrack(QList<QGeoPositionInfo> points) {
+    const bool timed = std::all_of(points.cbegin(), points.cend(), [](const auto& point) {
+        return point.timestamp().isValid();
+    });
+    if (!timed && !points.isEmpty()) {
+        QDateTime time = QDateTime::currentDateTimeUtc();
+        points.first().setTimestamp(time);
+        for (qsizetype i = 1; i < points.size(); ++i) {
+            const double distance =
+                points[i - 1].coordinate().distanceTo(points[i].coordinate());
+            time = time.addMSecs(std::llround(distance / kAssumedSpeedMps * 1000.0));
+            points[i].setTimestamp(time);
+        }
+    }
+
+    points_.clear();
+    offsets_.clear();
+    for (const QGeoPositionInfo& point : std::as_const(points)) {
+        if (!point.coordinate().isValid()) {
+            continue;
+        }
+        const qint64 offset =
+            points_.isEmpty() ? 0 : points_.first().timestamp().msecsTo(point.timestamp());
+        // Repeated or out-of-order timestamps (a stationary receiver, a spliced log)
+        if (!offsets_.isEmpty() && offset <= offsets_.last()) {
+            continue;
+        }
+        points_ << point;
+        offsets_ << offset;
+    }
+    next_ms_ = 0;
+    cursor_ = 0;
+    last_heading_ = -1.0;
+    last_fix_ = QGeoPositionInfo();
+    if (running_) {
+        pass_clock_.start();
+        restartClock();
+    }
+}
+
+qint64 ReplaySource::duration() const {
+    return offsets_.isEmpty() ? 0 : offsets_.last();
+}
+
+void ReplaySource::setSpeed(double speed) {
+    speed_ = std::max(0.0, speed);
+    if (running_) {
+        restartClock();
+    }
+}
+
+void ReplaySource::setUpdateInterval(int msec) {
+    QGeoPositionInfoSource::setUpdateInterval(
+        msec > 0 ? std::max(msec, minimumUpdateInterval()) : 0);
+    if (running_) {
+        restartClock();
+    }
+}
+
+QGeoPositionInfo ReplaySource::lastKnownPosition(bool) const {
+    return last_fix_;
+}
+
+QGeoPositionInfoSource::PositioningMethods ReplaySource::supportedPositioningMethods() const {
+    return SatellitePositioningMethods;
+}
+
+void ReplaySource::startUpdates() {
+    if (points_.size() < 2) {
+        setError(error_ != NoError ? error_ : UnknownSourceError);
+        return;
+    }
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    if (next_ms_ > duration()) {
+        next_ms_ = 0;
+        cursor_ = 0;
+    }
+    if (next_ms_ == 0) {
+        pass_clock_.start();
+    }
+    restartClock();
+}
+
+void ReplaySource::stopUpdates() {
+    running_ = false;
+    timer_.stop();
+}
+
+void ReplaySource::requestUpdate(int) {
+    if (points_.size() < 2) {
+        setError(UpdateTimeoutError);
+        return;
+    }
+    QTimer::singleShot(0, this, [this]() {
+        if (!last_fix_.isValid()) {
+            last_fix_ = interpolate(std::min(next_ms_, duration()));
+        }
+        emit positionUpdated(last_fix_);
+    });
+}
+
+int ReplaySource::outputInterval() const {
+    return updateInterval() > 0 ? updateInterval() : kDefaultIntervalMs;
+}
+
+void ReplaySource::restartClock() {
+    origin_ms_ = next_ms_;
+    wall_clock_.start();
+    const int interval = speed_ > 0.0 ? std::max(1, int(outputInterval() / speed_)) : 0;
+    timer_.start(interval);
+}
+
+QGeoPositionInfo ReplaySource::interpolate(qint64 offset_ms) {
+    while (cursor_ + 2 < points_.size() && offsets_[cursor_ + 1] <= offset_ms) {
+        ++cursor_;
+    }
+    const QGeoPositionInfo& from = points_[cursor_];
+    const QGeoPositionInfo& to = points_[cursor_ + 1];
+    const qint64 span = offsets_[cursor_ + 1] - offsets_[cursor_];
+    const double fraction =
+        std::clamp(double(offset_ms - offsets_[cursor_]) / double(span), 0.0, 1.0);
+
+    const QGeoCoordinate a = from.coordinate();
+    const QGeoCoordinate b = to.coordinate();
+    const double distance = a.distanceTo(b);
+    const double azimuth = a.azimuthTo(b);
+    const double climb = a.type() == QGeoCoordinate::Coordinate3D &&
+                                 b.type() == QGeoCoordinate::Coordinate3D
+                             ? (b.altitude() - a.altitude()) * fraction
+                             : 0.0;
+    QGeoPositionInfo fix(a.atDistanceAndAzimuth(distance * fraction, azimuth, climb),
+                         points_.first().timestamp().addMSecs(offset_ms));
+
+    if (from.hasAttribute(QGeoPositionInfo::GroundSpeed) &&
+        to.hasAttribute(QGeoPositionInfo::GroundSpeed)) {
+        const double a_speed = from.attribute(QGeoPositionInfo::GroundSpeed);
+        const double b_speed = to.attribute(QGeoPositionInfo::GroundSpeed);
+        fix.setAttribute(QGeoPositionInfo::GroundSpeed, a_speed + (b_speed - a_speed) * fraction);
+    } else {
+        fix.setAttribute(QGeoPositionInfo::GroundSpeed, distance * 1000.0 / double(span));
+    }
+
+    if (from.hasAttribute(QGeoPositionInfo::Direction) &&
+        to.hasAttribute(QGeoPositionInfo::Direction)) {
+        last_heading_ = interpolateAngle(from.attribute(QGeoPositionInfo::Direction),
+                                         to.attribute(QGeoPositionInfo::Direction), fraction);
+    } else if (distance >= kMinHeadingDistanceM) {
+        last_heading_ = azimuth;
+    }
+    if (last_heading_ >= 0.0) {
+        fix.setAttribute(QGeoPositionInfo::Direction, last_heading_);
+    }
+
+    for (const auto attribute :
+         {QGeoPositionInfo::HorizontalAccuracy, QGeoPositionInfo::VerticalAccuracy}) {
+        if (from.hasAttribute(attribute)) {
+            fix.setAttribute(attribute, from.attribute(attribute));
+        }
+    }
+    return fix;
+}
+
+void ReplaySource::tick() {
+    const qint64 end = duration();
+    const qint64 due = speed_ > 0.0 ? origin_ms_ + qint64(wall_clock_.elapsed() * speed_)
+                                    : std::numeric_limits<qint64>::max();
+    // Catch up with the wall clock if the event loop was busy
+    int batch = 0;
+    while (running_) {
+        const qint64 offset = std::min(next_ms_, end);
+        if (offset > due || batch == kMaxBatch) {
+            break;
+        }
+        last_fix_ = interpolate(offset);
+        ++fixes_emitted_;
+        ++batch;
+        emit positionUpdated(last_fix_);
+        if (offset == end) {
+            endOfRecording();
+            break;
+        }
+        next_ms_ += outputInterval();
+    }
+}
+
+void ReplaySource::endOfRecording() {
+    qInfo() << "Replay: end of recording," << duration() / 1000.0 << "s replayed in"
+            << pass_clock_.elapsed() << "ms;" << fixes_emitted_ << "fixes so far";
+    if (loop_) {
+        next_ms_ = 0;
+        cursor_ = 0;
+        pass_clock_.start();
+        restartClock();
+        return;
+    }
+    running_ = false;
+    timer_.stop();
+    next_ms_ = duration() + outputInterval();
+    emit finished();
+}
+
+void ReplaySource::setError(Error error) {
+    error_ = error;
+    emit errorOccurred(error);
+}
+
+}  // namespace opencardev::crankshaft::core::location
@@ -0,0 +1,126 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+#include <QTimer>
+#include <QtPositioning/QGeoPositionInfo>
+#include <QtPositioning/QGeoPositionInfoSource>
+
+namespace opencardev::crankshaft::core::location {
+
+/**
+ * Position source replaying a recorded drive from a GPX or NMEA file.
+ *
+ * Fixes are produced at the update interval of the recording's clock (10 Hz by default)
+ * by interpolating between recorded points, whatever their spacing, with speed and
+ * heading taken from the recording where present and derived from the track otherwise.
+ * A GPX track without timestamps is assumed to be driven at 50 km/h.
+ *
+ * Replay runs at real time, at a multiple of it, or as fast as the event loop allows
+ * (speed 0), which makes a whole drive a benchmark of the location pipeline. Fixes carry
+ * the recording's timestamps, so rate policies apply in recording time at any speed.
+ */
+class ReplaySource : public QGeoPositionInfoSource {
+    Q_OBJECT
+
+  public:
+    static constexpr double kAsFastAsPossible = 0.0;
+
+    explicit ReplaySource(QObject* parent = nullptr);
+    ~ReplaySource() override;
+
+    /**
+     * Load a .gpx file (track or route points) or a file of NMEA sentences; other
+     * extensions are recognised by content. Replay restarts from the beginning.
+     *
+     * @return false if the file is unreadable or holds fewer than two usable points
+     */
+    bool load(const QString& path);
+    QString path() const { return path_; }
+    // Replay these points instead; they must be in time order
+    void setTrack(const QList<QGeoPositionInfo>& points);
+    const QList<QGeoPositionInfo>& track() const { return points_; }
+    // Length of the recording in ms
+    qint64 duration() const;
+
+    // Multiple of real time, or kAsFastAsPossible
+    void setSpeed(double speed);
+    double speed() const { return speed_; }
+    // Start again from the beginning at the end of the recording
+    void setLoop(bool loop) { loop_ = loop; }
+    bool loops() const { return loop_; }
+
+    // Offset of the next fix into the recording, in ms
+    qint64 position() const { return next_ms_; }
+    bool isRunning() const { return running_; }
+    quint64 fixesEmitted() const { return fixes_emitted_; }
+
+    void setUpdateInterval(int msec) override;
+    QGeoPositionInfo lastKnownPosition(
+        bool fromSatellitePositioningMethodsOnly = false) const override;
+    PositioningMethods supportedPositioningMethods() const override;
+    int minimumUpdateInterval() const override { return 100; }
+    Error error() const override { return error_; }
+
+  public slots:
+    void startUpdates() override;
+    void stopUpdates() override;
+    void requestUpdate(int timeout = 0) override;
+
+  signals:
+    // The end of the recording was reached without looping
+    void finished();
+
+  private:
+    bool loadGpx(const QString& path);
+    bool loadNmea(const QString& path);
+    // Sort out duplicate timestamps and give untimed points times at a nominal speed
+    void prepareTrack(QList<QGeoPositionInfo> points);
+    QGeoPositionInfo interpolate(qint64 offset_ms);
+    int outputInterval() const;
+    void restartClock();
+    void tick();
+    void endOfRecording();
+    void setError(Error error);
+
+    QString path_;
+    QList<QGeoPositionInfo> points_;
+    QList<qint64> offsets_;  // Of each point from the first, in ms
+    double speed_;
+    bool loop_;
+    bool running_;
+    Error error_;
+
+    QTimer timer_;
+    QElapsedTimer wall_clock_;  // Since replay (re)started at origin_ms_
+    qint64 origin_ms_;
+    qint64 next_ms_;
+    int cursor_;  // Segment of the last interpolation; replay only moves forward
+    double last_heading_;
+    QGeoPositionInfo last_fix_;
+    quint64 fixes_emitted_;
+    QElapsedTimer pass_clock_;  // Since the current pass through the recording began
+};
+
+}  // namespace opencardev::crankshaft::core::location
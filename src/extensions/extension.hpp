@@ -19,10 +19,16 @@
 
 #pragma once
 
+#include <QCoreApplication>
 #include <QHash>
+#include <QMetaObject>
 #include <QString>
+#include <QThread>
 #include <QVariantMap>
+#include <array>
+#include <functional>
 #include <memory>
+#include <type_traits>
 #include "../core/capabilities/Capability.hpp"
 #include "../core/config/ConfigManager.hpp"
 
@@ -35,6 +41,16 @@ namespace capabilities {
 
 namespace extensions {
 
+namespace detail {
+// Whether T is a built-in capability interface, which declares its own slot(), rather than
+// an implementation or a type without a slot
+template <typename T, typename = void>
+struct HasCapabilitySlot : std::false_type {};
+template <typename T>
+struct HasCapabilitySlot<T, std::void_t<decltype(T::kSlot)>>
+    : std::is_same<decltype(&T::slot), core::capabilities::CapabilitySlot (T::*)() const> {};
+}  // namespace detail
+
 enum class ExtensionType {
     Unknown,
     Service,      // Background services (e.g., Bluetooth, GPS)
@@ -66,6 +82,17 @@ class Extension {
     virtual void stop() = 0;
     virtual void cleanup() = 0;
 
+    /**
+     * Whether initialize() may run on a worker thread, concurrently with other
+     * extensions of the same dependency level. Defaults to false.
+     *
+     * Extensions returning true must not leave QObjects with worker thread affinity
+     * behind: create them through runOnMainThread(), or moveToThread() them to the
+     * main thread before initialize() returns. start(), stop(), cleanup() and
+     * registerConfigItems() always run on the main thread.
+     */
+    virtual bool supportsConcurrentInitialize() const { return false; }
+
     // Metadata
     virtual QString id() const = 0;
     virtual QString name() const = 0;
@@ -121,7 +148,32 @@ class Extension {
      */
     void grantCapability(std::shared_ptr<core::capabilities::Capability> capability) {
         if (capability) {
-            capabilities_[capability->id()] = capability;
+            const int slot = static_cast<int>(capability->slot());
+            if (slot >= 0 && slot < int(slots_.size())) {
+                std::atomic_store(&slots_[slot], capability);
+            }
+            capabilities_[capability->id()] = std::move(capability);
+        }
+    }
+
+    /**
+     * Drop a revoked capability. Called by the ExtensionManager when the CapabilityManager
+     * revokes it; the typed slot is cleared atomically, so concurrent lookups see either
+     * the (already invalidated) capability or nothing.
+     *
+     * @param capabilityId Capability ID, or empty to drop all capabilities
+     */
+    void revokeCapability(const QString& capabilityId) {
+        for (auto& slot : slots_) {
+            const auto cap = std::atomic_load(&slot);
+            if (cap && (capabilityId.isEmpty() || cap->id() == capabilityId)) {
+                std::atomic_store(&slot, std::shared_ptr<core::capabilities::Capability>());
+            }
+        }
+        if (capabilityId.isEmpty()) {
+            capabilities_.clear();
+        } else {
+            capabilities_.remove(capabilityId);
         }
     }
 
@@ -137,10 +189,26 @@ class Extension {
     }
 
   protected:
+    /**
+     * Run a thread-affine step (creating QObjects, touching capability state owned by
+     * the GUI thread) on the main thread and wait for it. Runs inline when already there.
+     */
+    static void runOnMainThread(const std::function<void()>& fn) {
+        QCoreApplication* app = QCoreApplication::instance();
+        if (!app || QThread::currentThread() == app->thread()) {
+            fn();
+            return;
+        }
+        QMetaObject::invokeMethod(app, fn, Qt::BlockingQueuedConnection);
+    }
+
     /**
      * Get a capability by type.
      * Returns nullptr if capability not granted or invalid.
      *
+     * Built-in capability interfaces are read from their slot, so this is cheap enough to
+     * call on every event; other types are found by scanning the granted capabilities.
+     *
      * Usage:
      *   auto locationCap = getCapability<LocationCapability>();
      *   if (locationCap) {
@@ -151,13 +219,22 @@ class Extension {
      */
     template <typename T>
     std::shared_ptr<T> getCapability() const {
-        for (const auto& cap : capabilities_) {
-            auto typed = std::dynamic_pointer_cast<T>(cap);
-            if (typed && typed->isValid()) {
-                return typed;
+        if constexpr (detail::HasCapabilitySlot<T>::value) {
+            // slot() is final in T, so only a T is ever stored in T's slot
+            auto cap = std::atomic_load(&slots_[static_cast<int>(T::kSlot)]);
+            if (cap && cap->isValid()) {
+                return std::static_pointer_cast<T>(std::move(cap));
             }
+            return nullptr;
+        } else {
+            for (const auto& cap : capabilities_) {
+                auto typed = std::dynamic_pointer_cast<T>(cap);
+                if (typed && typed->isValid()) {
+                    return typed;
+                }
+            }
+            return nullptr;
         }
-        return nullptr;
     }
 
     /**
@@ -177,6 +254,10 @@ class Extension {
   private:
     // Granted capabilities (capability_id -> capability)
     QHash<QString, std::shared_ptr<core::capabilities::Capability>> capabilities_;
+    // Built-in interfaces by CapabilitySlot; accessed with std::atomic_load/atomic_store
+    std::array<std::shared_ptr<core::capabilities::Capability>,
+               static_cast<size_t>(core::capabilities::CapabilitySlot::Count)>
+        slots_;
 };
 
 }  // namespace extensions
@@ -21,32 +21,199 @@
 #include <QCoreApplication>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
 #include <QFile>
-#include <QJsonDocument>
+#include <QFileInfo>
 #include <QJsonObject>
 #include <QQueue>
+#include <QStandardPaths>
+#include <QThread>
+#include <QThreadPool>
+#include <QUrl>
+#include <QVector>
+#include <algorithm>
 #include "../core/capabilities/Capability.hpp"
 #include "../core/capabilities/CapabilityManager.hpp"
+#include "../core/config/ConfigDescriptor.hpp"
 #include "../core/config/ConfigManager.hpp"
+#include "../core/diagnostics/DispatchContext.hpp"
+#include "../core/diagnostics/Trace.hpp"
+#include "../core/events/event_bus.hpp"
+#include "../core/ui/UIRegistrar.hpp"
+#include "extension_plugin.hpp"
+#include "host/extension_host_proxy.hpp"
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 
 namespace opencardev::crankshaft {
 namespace extensions {
 
+namespace {
+
+// Run extension code with its wall and CPU time charged to the extension, visible to the
+// stall watchdog as the extension's operation, and traced as a span
+template <typename Fn>
+auto charged(core::CapabilityManager* manager, const QString& extension_id,
+             const char* operation, Fn&& fn) {
+    CRANKSHAFT_TRACE_SCOPE_DETAIL("extensions", operation, extension_id);
+    const auto usage = manager ? manager->resourceUsage(extension_id) : nullptr;
+    core::diagnostics::DispatchScope dispatch(extension_id, QString::fromLatin1(operation));
+    core::capabilities::ResourceScope scope(usage.get());
+    return fn();
+}
+
+// One extension's initialize() call, relative to the start of registration
+struct InitSpan {
+    bool ok = false;
+    bool concurrent = false;
+    qint64 start_ms = 0;
+    qint64 duration_ms = 0;
+};
+
+/**
+ * Run initialize() for one dependency level. Extensions that support it run on a thread
+ * pool while the rest run here, on the main thread. The main thread then keeps processing
+ * events until the pool is done, so workers can hand thread-affine steps back to it.
+ */
+void initializeLevel(const QStringList& ids, const QList<std::shared_ptr<Extension>>& batch,
+                     core::CapabilityManager* manager, const QElapsedTimer& clock,
+                     QVector<InitSpan>* spans) {
+    auto initialize = [&](int i) {
+        InitSpan& span = (*spans)[i];
+        span.start_ms = clock.elapsed();
+        span.ok = charged(manager, ids.at(i), "initialize",
+                          [&] { return batch.at(i)->initialize(); });
+        span.duration_ms = clock.elapsed() - span.start_ms;
+    };
+
+    // Off-thread initialisation needs this thread's event loop to serve runOnMainThread()
+    const QCoreApplication* app = QCoreApplication::instance();
+    const bool can_defer = app != nullptr && QThread::currentThread() == app->thread();
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(std::max(QThread::idealThreadCount(), int(ids.size())));
+    QEventLoop loop;
+    int outstanding = 0;
+
+    for (int i = 0; i < ids.size(); ++i) {
+        if (!can_defer || !batch.at(i)->supportsConcurrentInitialize()) {
+            continue;
+        }
+        (*spans)[i].concurrent = true;
+        ++outstanding;
+        pool.start([&, i]() {
+            initialize(i);
+            QMetaObject::invokeMethod(
+                &loop,
+                [&]() {
+                    if (--outstanding == 0) {
+                        loop.quit();
+                    }
+                },
+                Qt::QueuedConnection);
+        });
+    }
+    for (int i = 0; i < ids.size(); ++i) {
+        if (!(*spans)[i].concurrent) {
+            initialize(i);
+        }
+    }
+
+    // A main-thread initialize() that spun its own event loop may have seen them all finish
+    if (outstanding > 0) {
+        loop.exec();
+    }
+}
+
+// Resident set size of this process in bytes, or -1 where it cannot be read
+qint64 residentBytes() {
+#ifdef Q_OS_LINUX
+    QFile statm(QStringLiteral("/proc/self/statm"));
+    if (statm.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> fields = statm.readAll().split(' ');
+        if (fields.size() > 1) {
+            return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+        }
+    }
+#endif
+    return -1;
+}
+
+QString rssChange(qint64 before, qint64 after) {
+    if (before < 0 || after < 0) {
+        return QStringLiteral("unavailable");
+    }
+    return QString("%1%2 KiB (%3 KiB resident)")
+        .arg(after >= before ? "+" : "")
+        .arg((after - before) / 1024)
+        .arg(after / 1024);
+}
+
+// The entry_point library: next to the manifest in the build tree, or under lib/ when
+// installed (manifests and assets live under share/)
+QString pluginLibraryPath(const QString& extension_path, const QString& entry_point) {
+    const QString beside_manifest = QDir(extension_path).absoluteFilePath(entry_point);
+    if (QFileInfo::exists(beside_manifest)) {
+        return beside_manifest;
+    }
+    const QString installed = QCoreApplication::applicationDirPath() +
+                              "/../lib/CrankshaftReborn/extensions/" +
+                              QFileInfo(extension_path).fileName() + "/" + entry_point;
+    return QFileInfo::exists(installed) ? QDir::cleanPath(installed) : beside_manifest;
+}
+
+}  // namespace
+
 ExtensionManager::ExtensionManager(QObject* parent)
     : QObject(parent),
       capability_manager_(nullptr),
       config_manager_(nullptr),
-      extensions_dir_("extensions") {}
+      extensions_dir_("extensions") {
+    connect(&manifest_cache_, &ManifestCache::searchPathChanged, this,
+            &ExtensionManager::availableExtensionsChanged);
+}
 
 ExtensionManager::~ExtensionManager() {
+    if (capability_manager_) {
+        capability_manager_->setCapabilityActivator({});
+        capability_manager_->setRevocationListener({});
+    }
     unloadAll();
 }
 
 void ExtensionManager::initialize(core::CapabilityManager* capability_manager,
                                   core::config::ConfigManager* config_manager) {
+    CRANKSHAFT_TRACE_SCOPE("startup", "ExtensionManager::initialize");
     capability_manager_ = capability_manager;
     config_manager_ = config_manager;
     qInfo() << "Extension manager initialized with capability-based security";
+    if (capability_manager_) {
+        // Requests for a capability type no one provides yet may activate its provider
+        capability_manager_->setCapabilityActivator(
+            [this](const QString& requester_id, const QString& capability_type) {
+                activateCapabilityProviders(requester_id, capability_type);
+            });
+        // Clear revoked capabilities from the extension's typed slots, and from its host
+        capability_manager_->setRevocationListener(
+            [this](const QString& extension_id, const QString& capability_type) {
+                const auto it = extensions_.constFind(extension_id);
+                if (it != extensions_.cend() && it->extension) {
+                    it->extension->revokeCapability(capability_type);
+                    if (it->hosted) {
+                        static_cast<host::ExtensionHostProxy*>(it->extension.get())
+                            ->revokeInHost(capability_type);
+                    }
+                }
+            });
+    }
+    manifest_cache_.open(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+                         "/extension-manifests.bin");
     // Prefer extensions located next to the executable by default
     const QString defaultExtDir = QCoreApplication::applicationDirPath() + "/extensions";
     if (QDir(defaultExtDir).exists()) {
@@ -64,12 +231,77 @@ void ExtensionManager::initialize(core::CapabilityManager* capability_manager,
                     } else {
                         disableExtension(key);
                     }
+                } else if (domain == "system" && extension == "extensions" &&
+                           section == "rate_limits") {
+                    applyRateLimitConfig(key, value);
+                } else if (domain == "system" && extension == "extensions" &&
+                           section == "permissions" && key == "overrides") {
+                    applyPolicyOverrides(value);
                 }
             });
+
+        for (const QString& type : {QStringLiteral("network"), QStringLiteral("event"),
+                                    QStringLiteral("filesystem")}) {
+            applyRateLimitConfig(
+                type, config_manager_->getValue("system", "extensions", "rate_limits", type));
+        }
+        // Before any extension is loaded, so their permission sets compile with the overrides
+        applyPolicyOverrides(
+            config_manager_->getValue("system", "extensions", "permissions", "overrides"));
+    }
+}
+
+QVersionNumber ExtensionManager::coreVersion() {
+    return QVersionNumber::fromString(QStringLiteral(CRANKSHAFT_CORE_VERSION));
+}
+
+void ExtensionManager::applyRateLimitConfig(const QString& capability_type,
+                                            const QVariant& value) {
+    if (!capability_manager_ || !value.isValid()) {
+        return;
+    }
+    // Keep the built-in policy; only the rate is configurable, with a two second burst
+    core::capabilities::RateLimit limit = capability_manager_->defaultRateLimit(capability_type);
+    limit.rate = value.toDouble();
+    limit.burst = limit.rate * 2;
+    capability_manager_->setDefaultRateLimit(capability_type, limit);
+    qInfo() << "Rate limit for" << capability_type << "set to" << limit.rate << "per second";
+    reconfigureHosts();
+}
+
+void ExtensionManager::applyPolicyOverrides(const QVariant& value) {
+    if (!capability_manager_) {
+        return;
+    }
+    const QVariantMap overrides = value.toMap();
+    // Overrides dropped from the config stop applying
+    for (const QString& id : std::as_const(policy_override_ids_)) {
+        if (!overrides.contains(id)) {
+            capability_manager_->setPolicyOverride(id, {}, {});
+        }
+    }
+    for (auto it = overrides.cbegin(); it != overrides.cend(); ++it) {
+        const QVariantMap entry = it.value().toMap();
+        capability_manager_->setPolicyOverride(it.key(), entry.value("allow").toStringList(),
+                                               entry.value("deny").toStringList());
+    }
+    policy_override_ids_ = overrides.keys();
+    if (!overrides.isEmpty()) {
+        qInfo() << "Permission overrides applied for" << policy_override_ids_;
+    }
+    reconfigureHosts();
+}
+
+void ExtensionManager::reconfigureHosts() {
+    for (const ExtensionInfo& info : std::as_const(extensions_)) {
+        if (info.hosted && info.extension) {
+            static_cast<host::ExtensionHostProxy*>(info.extension.get())->reconfigure();
+        }
     }
 }
 
 bool ExtensionManager::loadExtension(const QString& extension_path) {
+    CRANKSHAFT_TRACE_SCOPE_DETAIL("extensions", "ExtensionManager::loadExtension", extension_path);
     qInfo() << "Loading extension from:" << extension_path;
 
     QString manifest_path = extension_path + "/manifest.json";
@@ -99,20 +331,28 @@ bool ExtensionManager::loadExtension(const QString& extension_path) {
         return false;
     }
 
-    // TODO: Load the actual extension library/executable
-    // This would involve loading shared libraries or spawning processes
-
-    // For now, store the manifest for capability granting
     ExtensionInfo info;
     info.manifest = manifest;
     info.path = extension_path;
-    // Dynamic loading not implemented yet, but mark as running so that
-    // dependent extensions consider this satisfied. Replace with actual
-    // load/start when plugin mechanism added.
-    info.is_running = true;
-    // Note: extension pointer will be set when actual extension is created
     extensions_[manifest.id] = info;
 
+    if (manifest.entry_point.isEmpty()) {
+        // No code to run (QML or assets only), but mark as running so that dependent
+        // extensions consider this satisfied
+        extensions_[manifest.id].is_running = true;
+    } else if (!isEnabledByConfig(manifest.id)) {
+        qInfo() << "Extension disabled by config, library not loaded:" << manifest.id;
+    } else if (!initializeExtension(manifest.id)) {
+        qWarning() << "Failed to load or initialise extension:" << manifest.id;
+        extensions_.remove(manifest.id);
+        emit extensionError(manifest.id, "Initialization failed");
+        return false;
+    } else {
+        ExtensionInfo& loaded = extensions_[manifest.id];
+        charged(capability_manager_, manifest.id, "start", [&] { loaded.extension->start(); });
+        loaded.is_running = true;
+    }
+
     qInfo() << "Extension loaded successfully:" << manifest.id;
     emit extensionLoaded(manifest.id);
 
@@ -121,88 +361,634 @@ bool ExtensionManager::loadExtension(const QString& extension_path) {
 
 bool ExtensionManager::registerBuiltInExtension(std::shared_ptr<Extension> extension,
                                                 const QString& extension_path) {
+    CRANKSHAFT_TRACE_SCOPE_DETAIL("extensions", "ExtensionManager::registerBuiltInExtension",
+                                  extension_path);
     if (!extension) {
         qWarning() << "Cannot register null extension";
         return false;
     }
+    const BuiltInExtension built_in{std::move(extension), extension_path};
+    return registerBuiltInExtensions({built_in}) == 1;
+}
 
-    QString manifest_path = extension_path + "/manifest.json";
-    ExtensionManifest manifest = loadManifest(manifest_path);
+int ExtensionManager::registerBuiltInExtensions(const QList<BuiltInExtension>& built_ins) {
+    CRANKSHAFT_TRACE_SCOPE("extensions", "ExtensionManager::registerBuiltInExtensions");
+    QElapsedTimer clock;
+    clock.start();
 
-    if (!manifest.isValid()) {
-        qWarning() << "Invalid manifest for built-in extension:" << extension_path;
-        return false;
-    }
+    // 1. Manifests, on the main thread in registration order
+    QMap<QString, ExtensionManifest> manifests;
+    QStringList registration_order;
+    for (const BuiltInExtension& built_in : built_ins) {
+        const ExtensionManifest manifest = loadManifest(built_in.path + "/manifest.json");
+        if (!manifest.isValid()) {
+            qWarning() << "Invalid manifest for built-in extension:" << built_in.path;
+            continue;
+        }
+        if (!built_in.extension && manifest.entry_point.isEmpty()) {
+            qWarning() << "Built-in extension has neither an instance nor an entry_point:"
+                       << manifest.id;
+            continue;
+        }
+        if (manifests.contains(manifest.id) ||
+            (extensions_.contains(manifest.id) && extensions_[manifest.id].extension)) {
+            qWarning() << "Built-in extension already registered, skipping:" << manifest.id;
+            continue;
+        }
 
-    // Check if already loaded (manifest discovered but extension not instantiated)
-    if (extensions_.contains(manifest.id)) {
-        qDebug() << "Extension manifest already loaded, adding implementation:" << manifest.id;
-        auto& info = extensions_[manifest.id];
-        info.extension = extension;
-
-        // Grant capabilities based on manifest
-        grantCapabilities(extension.get(), manifest);
-
-        // Initialize and start extension
-        if (extension->initialize()) {
-            // Register config items if ConfigManager is available
-            if (config_manager_) {
-                extension->registerConfigItems(config_manager_);
+        // Keeps the entry of a manifest discovered earlier without an implementation
+        ExtensionInfo& info = extensions_[manifest.id];
+        info.extension = built_in.extension;
+        info.manifest = manifest;
+        info.path = built_in.path;
+        info.is_running = false;
+        info.activation_pending = false;
+        // A plugin's settings are listed whether or not, and however late, it is loaded
+        if (!info.extension) {
+            registerSchemaPage(manifest.id);
+        }
+
+        manifests.insert(manifest.id, manifest);
+        registration_order << manifest.id;
+    }
+    manifest_cache_.save();
+
+    // 2. Built-ins with activation triggers are deferred, unless one started now depends
+    //    on them. Everything else has its capabilities granted up front.
+    QSet<QString> deferred;
+    for (const QString& id : registration_order) {
+        if (manifests.value(id).activation.isLazy()) {
+            deferred.insert(id);
+        }
+    }
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (const QString& id : registration_order) {
+            if (deferred.contains(id)) {
+                continue;
+            }
+            for (const QString& dep : manifests.value(id).dependencies) {
+                if (deferred.remove(dep)) {
+                    qInfo() << "Built-in extension" << dep << "starts at boot, needed by" << id;
+                    changed = true;
+                }
             }
-            extension->start();
-            info.is_running = true;
-            qInfo() << "Built-in extension started:" << manifest.id;
-            return true;
+        }
+    }
+    QStringList eager_order;
+    int not_loaded = 0;
+    for (const QString& id : registration_order) {
+        if (deferred.contains(id)) {
+            manifests.remove(id);
+            deferActivation(id);
+        } else if (extensions_.value(id).extension) {
+            eager_order << id;
+        } else if (!isEnabledByConfig(id)) {
+            // Enabling it later loads the library
+            manifests.remove(id);
+            ++not_loaded;
+            qInfo() << "Built-in extension registered but disabled by config:" << id;
+            emit extensionLoaded(id);
+        } else if (loadPlugin(id)) {
+            eager_order << id;
         } else {
-            qWarning() << "Failed to initialize built-in extension:" << manifest.id;
-            emit extensionError(manifest.id, "Initialization failed");
-            return false;
+            manifests.remove(id);
+            extensions_.remove(id);
+            emit extensionError(id, "Plugin failed to load");
         }
     }
+    // After deferring, so grants can activate deferred capability providers
+    registration_order = eager_order;
+    for (const QString& id : registration_order) {
+        grantCapabilities(extensions_.value(id).extension.get(), manifests.value(id));
+    }
 
-    // Store extension info
-    ExtensionInfo info;
-    info.extension = extension;
-    info.manifest = manifest;
-    info.path = extension_path;
-    info.is_running = false;
-    extensions_[manifest.id] = info;
+    // 3. Dependency levels. Built-ins with unresolvable dependencies were never blocked
+    //    from loading, so they form a final level rather than being dropped.
+    QSet<QString> already_loaded;
+    for (const QString& id : extensions_.keys()) {
+        if (!manifests.contains(id)) {
+            already_loaded.insert(id);
+        }
+    }
+    QMap<QString, QStringList> missing_deps;
+    QStringList cycle_group;
+    QList<QStringList> levels =
+        resolveLoadLevels(manifests, already_loaded, missing_deps, cycle_group);
+
+    QStringList unresolved = registration_order;
+    for (const QStringList& level : levels) {
+        for (const QString& id : level) {
+            unresolved.removeOne(id);
+        }
+    }
+    if (!unresolved.isEmpty()) {
+        qWarning() << "Built-in extensions with unresolved dependencies initialise last:"
+                   << unresolved;
+        levels.append(unresolved);
+    }
 
-    // Grant capabilities based on manifest
-    grantCapabilities(extension.get(), manifest);
-
-    // Initialize and start extension
-    if (extension->initialize()) {
-        // Register config items if ConfigManager is available
-        if (config_manager_) {
-            extension->registerConfigItems(config_manager_);
-        }
-        bool shouldStart = true;
-        if (config_manager_) {
-            // Check system.extensions.manage.<id> toggle
-            QVariant v = config_manager_->getValue("system", "extensions", "manage", manifest.id);
-            if (v.isValid())
-                shouldStart = v.toBool();
-        }
-        if (shouldStart) {
-            extension->start();
-            extensions_[manifest.id].is_running = true;
-            qInfo() << "Built-in extension registered and started:" << manifest.id;
-        } else {
-            extensions_[manifest.id].is_running = false;
-            qInfo() << "Built-in extension registered but disabled by config:" << manifest.id;
+    // 4. Initialise a level at a time, starting each level before the next
+    startup_timeline_.clear();
+    int initialised = 0;
+    qint64 serial_ms = 0;
+    for (int level = 0; level < levels.size(); ++level) {
+        QStringList ids = levels.at(level);
+        std::sort(ids.begin(), ids.end(), [&registration_order](const QString& a,
+                                                                const QString& b) {
+            return registration_order.indexOf(a) < registration_order.indexOf(b);
+        });
+
+        QList<std::shared_ptr<Extension>> batch;
+        for (const QString& id : ids) {
+            batch << extensions_.value(id).extension;
+        }
+        QVector<InitSpan> spans(ids.size());
+        initializeLevel(ids, batch, capability_manager_, clock, &spans);
+        // A failed plugin is unloaded below; nothing may outlive its library
+        batch.clear();
+
+        for (int i = 0; i < ids.size(); ++i) {
+            const QString& id = ids.at(i);
+            const InitSpan& span = spans.at(i);
+            qint64 start_ms = 0;
+            if (span.ok) {
+                QElapsedTimer start_clock;
+                start_clock.start();
+                registerConfigItems(id);
+                startBuiltInExtension(id);
+                start_ms = start_clock.elapsed();
+                ++initialised;
+            } else {
+                qWarning() << "Failed to initialize built-in extension:" << id;
+                if (capability_manager_) {
+                    capability_manager_->clearExtensionPermissions(id);
+                }
+                unloadPlugin(id);
+                extensions_.remove(id);
+                emit extensionError(id, "Initialization failed");
+            }
+            serial_ms += span.duration_ms + start_ms;
+
+            QVariantMap entry;
+            entry["id"] = id;
+            entry["level"] = level;
+            entry["concurrent"] = span.concurrent;
+            entry["init_start_ms"] = span.start_ms;
+            entry["init_ms"] = span.duration_ms;
+            entry["start_ms"] = start_ms;
+            entry["ok"] = span.ok;
+            startup_timeline_.append(entry);
         }
-        emit extensionLoaded(manifest.id);
+    }
+
+    // 5. Startup timeline
+    const qint64 total_ms = clock.elapsed();
+    qInfo() << "Built-in extension startup timeline:";
+    for (const QVariant& value : startup_timeline_) {
+        const QVariantMap entry = value.toMap();
+        qInfo().noquote() << QString("  L%1 %2 init %3 ms at +%4 ms (%5), start %6 ms")
+                                 .arg(entry["level"].toInt())
+                                 .arg(entry["id"].toString(), -14)
+                                 .arg(entry["init_ms"].toLongLong())
+                                 .arg(entry["init_start_ms"].toLongLong())
+                                 .arg(entry["concurrent"].toBool() ? "pool" : "main")
+                                 .arg(entry["start_ms"].toLongLong());
+    }
+    qInfo() << "Built-in extensions ready in" << total_ms << "ms across" << levels.size()
+            << "levels; one at a time they take" << serial_ms << "ms";
+    QStringList awaiting;
+    for (const QString& id : deferred) {
+        if (isActivationPending(id)) {
+            awaiting << id;
+        }
+    }
+    if (!awaiting.isEmpty()) {
+        qInfo() << "Built-in extensions awaiting activation:" << awaiting;
+    }
+
+    return initialised + deferred.size() + not_loaded;
+}
+
+bool ExtensionManager::isEnabledByConfig(const QString& extension_id) const {
+    if (!config_manager_) {
         return true;
+    }
+    // Check system.extensions.manage.<id> toggle
+    const QVariant v = config_manager_->getValue("system", "extensions", "manage", extension_id);
+    return !v.isValid() || v.toBool();
+}
+
+bool ExtensionManager::runsInHost(const QString& extension_id) const {
+    const QStringList isolated =
+        qEnvironmentVariable("CRANKSHAFT_EXTENSION_HOST").split(',', Qt::SkipEmptyParts);
+    if (isolated.contains("*") || isolated.contains(extension_id)) {
+        return true;
+    }
+    return config_manager_ &&
+           config_manager_->getValue("system", "extensions", "isolation", extension_id).toBool();
+}
+
+void ExtensionManager::startBuiltInExtension(const QString& extension_id) {
+    ExtensionInfo& info = extensions_[extension_id];
+    if (isEnabledByConfig(extension_id)) {
+        charged(capability_manager_, extension_id, "start", [&] { info.extension->start(); });
+        info.is_running = true;
+        qInfo() << "Built-in extension registered and started:" << extension_id;
     } else {
-        qWarning() << "Failed to initialize built-in extension:" << manifest.id;
-        extensions_.remove(manifest.id);
-        emit extensionError(manifest.id, "Initialization failed");
+        info.is_running = false;
+        qInfo() << "Built-in extension registered but disabled by config:" << extension_id;
+    }
+    emit extensionLoaded(extension_id);
+}
+
+bool ExtensionManager::isPluginBacked(const ExtensionInfo& info) const {
+    return info.plugin || info.hosted || (!info.extension && !info.manifest.entry_point.isEmpty());
+}
+
+bool ExtensionManager::loadPlugin(const QString& extension_id) {
+    CRANKSHAFT_TRACE_SCOPE_DETAIL("extensions", "ExtensionManager::loadPlugin", extension_id);
+    ExtensionInfo& info = extensions_[extension_id];
+    if (info.extension) {
+        return true;
+    }
+    if (!validateManifest(info.manifest)) {
+        return false;
+    }
+
+    const QString library = pluginLibraryPath(info.path, info.manifest.entry_point);
+    auto loader = std::make_shared<QPluginLoader>(library);
+    // Metadata is read from the file without loading it, so an incompatible library never
+    // has its static initialisers run
+    const QJsonObject metadata = loader->metaData();
+    if (metadata.isEmpty()) {
+        qWarning() << "Not an extension plugin:" << library << loader->errorString();
+        return false;
+    }
+    const QString iid = metadata.value("IID").toString();
+    if (iid != QLatin1String(CRANKSHAFT_EXTENSION_PLUGIN_IID)) {
+        qWarning() << "Extension plugin" << library << "was built for" << iid << "- expected"
+                   << CRANKSHAFT_EXTENSION_PLUGIN_IID;
+        return false;
+    }
+    const QString embedded_id = metadata.value("MetaData").toObject().value("id").toString();
+    if (!embedded_id.isEmpty() && embedded_id != extension_id) {
+        qWarning() << "Extension plugin" << library << "belongs to" << embedded_id
+                   << "not" << extension_id;
+        return false;
+    }
+
+    if (runsInHost(extension_id)) {
+        auto proxy = std::make_shared<host::ExtensionHostProxy>(info.manifest, info.path, library,
+                                                                capability_manager_);
+        connect(proxy.get(), &host::ExtensionHostProxy::hostCrashed, this,
+                [this](const QString& id, const QString& reason, bool restarting) {
+                    // A restarted host registers its views again
+                    emit requestUnregisterComponents(id);
+                    emit extensionError(id, "Extension host " + reason);
+                    auto it = extensions_.find(id);
+                    if (!restarting && it != extensions_.end()) {
+                        it->is_running = false;
+                    }
+                });
+        info.extension = std::move(proxy);
+        info.hosted = true;
+        qInfo() << "Extension" << extension_id << "runs in an extension host process";
+        return true;
+    }
+
+    const qint64 rss_before = residentBytes();
+    QElapsedTimer clock;
+    clock.start();
+    if (!loader->load()) {
+        qWarning() << "Failed to load extension plugin:" << loader->errorString();
+        return false;
+    }
+    auto* factory = qobject_cast<ExtensionPlugin*>(loader->instance());
+    std::shared_ptr<Extension> extension = factory ? factory->createExtension() : nullptr;
+    if (!extension || extension->id() != extension_id) {
+        qWarning() << "Extension plugin" << library << "did not create" << extension_id;
+        extension.reset();
+        loader->unload();
+        return false;
+    }
+
+    info.extension = std::move(extension);
+    info.plugin = std::move(loader);
+    // Lets the stall watchdog blame sampled stack frames in the library on the extension
+    core::diagnostics::DispatchContext::registerModule(info.plugin->fileName(), extension_id);
+    qInfo().noquote() << QString("Loaded %1 from %2 in %3 ms, RSS %4")
+                             .arg(extension_id, library)
+                             .arg(clock.elapsed())
+                             .arg(rssChange(rss_before, residentBytes()));
+    return true;
+}
+
+void ExtensionManager::unloadPlugin(const QString& extension_id) {
+    auto it = extensions_.find(extension_id);
+    if (it == extensions_.end() || (!it->plugin && !it->hosted)) {
+        return;
+    }
+
+    const qint64 rss_before = residentBytes();
+    if (capability_manager_) {
+        capability_manager_->clearExtensionPermissions(extension_id);
+    }
+    if (it->hosted) {
+        // Destroying the proxy ends its host process, if still running
+        it->extension.reset();
+        it->hosted = false;
+        it->is_running = false;
+        qInfo() << "Released extension host for" << extension_id;
+        return;
+    }
+    // Its config pages stay: registerConfigItems() kept copies that do not use the library.
+    // Its vtable and destructor live in the library
+    it->extension.reset();
+    const std::shared_ptr<QPluginLoader> loader = std::move(it->plugin);
+    it->plugin.reset();
+    it->is_running = false;
+    core::diagnostics::DispatchContext::unregisterModule(loader->fileName());
+    if (!loader->unload()) {
+        qWarning() << "Extension plugin still in use, not unloaded:" << loader->fileName();
+        return;
+    }
+#ifdef __GLIBC__
+    // Return the heap the extension freed, so the drop shows in RSS
+    malloc_trim(0);
+#endif
+    qInfo().noquote() << QString("Unloaded %1, RSS %2")
+                             .arg(extension_id, rssChange(rss_before, residentBytes()));
+}
+
+bool ExtensionManager::initializeExtension(const QString& extension_id) {
+    ExtensionInfo& info = extensions_[extension_id];
+    const bool loaded_now = !info.extension;
+    if (loaded_now && !loadPlugin(extension_id)) {
+        return false;
+    }
+
+    // Not a shared_ptr: a failed plugin is unloaded below
+    Extension* extension = info.extension.get();
+    grantCapabilities(extension, info.manifest);
+    const bool ok = runInitialize(extension_id, extension);
+    // Unloaded while its initialize() ran on the pool
+    const auto it = extensions_.constFind(extension_id);
+    if (it == extensions_.cend() || it->extension.get() != extension) {
+        return false;
+    }
+    if (!ok) {
+        if (capability_manager_) {
+            capability_manager_->clearExtensionPermissions(extension_id);
+        }
+        unloadPlugin(extension_id);
+        return false;
+    }
+    // Linked-in built-ins registered their config items when they were registered
+    if (loaded_now) {
+        registerConfigItems(extension_id);
+    }
+    return true;
+}
+
+bool ExtensionManager::runInitialize(const QString& extension_id, Extension* extension) {
+    const QCoreApplication* app = QCoreApplication::instance();
+    if (!extension->supportsConcurrentInitialize() || !app ||
+        QThread::currentThread() != app->thread()) {
+        return charged(capability_manager_, extension_id, "initialize",
+                       [&] { return extension->initialize(); });
+    }
+
+    // Activation waits for it either way, but the UI keeps painting and the extension's
+    // runOnMainThread() calls are served meanwhile
+    auto state = std::make_shared<Initialization>();
+    initializing_.insert(extension_id, state);
+    QEventLoop loop;
+    QThreadPool::globalInstance()->start([&, state]() {
+        state->ok = charged(capability_manager_, extension_id, "initialize",
+                            [&] { return extension->initialize(); });
+        state->done = true;
+        QMetaObject::invokeMethod(&loop, &QEventLoop::quit, Qt::QueuedConnection);
+    });
+    loop.exec();
+    initializing_.remove(extension_id);
+    return state->ok;
+}
+
+bool ExtensionManager::awaitInitialization(const QString& extension_id) {
+    const std::shared_ptr<Initialization> state = initializing_.value(extension_id);
+    if (!state) {
+        return true;
+    }
+    // Reentered from the event loop runInitialize() serves. That loop cannot return before
+    // this one does, so wait for the initialize() call itself; finishing posts an event.
+    while (!state->done) {
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    }
+    return state->ok;
+}
+
+void ExtensionManager::registerConfigItems(const QString& extension_id) {
+    ExtensionInfo& info = extensions_[extension_id];
+    if (!config_manager_ || !info.extension) {
+        return;
+    }
+    QList<QPair<QString, QString>> pages;
+    const QMetaObject::Connection recorder = connect(
+        config_manager_, &core::config::ConfigManager::configPageRegistered, this,
+        [&pages](const QString& domain, const QString& extension) {
+            // Deep copies: the arguments may be literals in the plugin's own data
+            pages.append({QString(domain.constData(), domain.size()),
+                          QString(extension.constData(), extension.size())});
+        });
+    info.extension->registerConfigItems(config_manager_);
+    disconnect(recorder);
+    if (!info.plugin) {
+        return;
+    }
+    // The pages it built may hold strings in the library's data. Replace them with copies,
+    // so its settings stay listed and editable once it is disabled and unloaded.
+    for (const auto& page : std::as_const(pages)) {
+        config_manager_->registerConfigPage(core::config::detachedConfigPage(
+            config_manager_->getConfigPage(page.first, page.second)));
+    }
+}
+
+void ExtensionManager::registerSchemaPage(const QString& extension_id) {
+    const ExtensionInfo& info = extensions_[extension_id];
+    if (!config_manager_ || info.manifest.config_schema.isEmpty()) {
+        return;
+    }
+    const QString path = QDir(info.path).absoluteFilePath(info.manifest.config_schema);
+    if (!QFile::exists(path)) {
+        // Pages the plugin builds itself are registered once it is loaded
+        return;
+    }
+    core::config::ConfigPage page;
+    if (core::config::configPageFromSchemaFile(path, &page)) {
+        config_manager_->registerConfigPage(page);
+    }
+}
+
+void ExtensionManager::deferActivation(const QString& extension_id) {
+    ExtensionInfo& info = extensions_[extension_id];
+    info.activation_pending = true;
+    const ExtensionManifest::Activation& activation = info.manifest.activation;
+
+    // A plugin's page came from its schema file; its own items follow once it is loaded
+    registerConfigItems(extension_id);
+    if (!isEnabledByConfig(extension_id)) {
+        // No placeholders or triggers; enabling it later activates it
+        qInfo() << "Built-in extension registered but disabled by config:" << extension_id;
+        return;
+    }
+
+    PendingActivation& pending = pending_activations_[extension_id];
+    pending.since.start();
+
+    // Placeholder views, marked "lazy"; the extension's own registration replaces them
+    core::ui::UIRegistrar* registrar =
+        capability_manager_ ? capability_manager_->uiRegistrar() : nullptr;
+    for (const QVariant& value : activation.views) {
+        QVariantMap metadata = value.toMap();
+        const QString slot = metadata.take("slot").toString();
+        QString qml_path = metadata.take("qml_path").toString();
+        if (QUrl(qml_path).isRelative() && QDir::isRelativePath(qml_path)) {
+            qml_path = QUrl::fromLocalFile(QDir(info.path).absoluteFilePath(qml_path)).toString();
+        }
+        metadata["lazy"] = true;
+        if (registrar) {
+            registrar->registerComponent(extension_id, slot.isEmpty() ? "main" : slot, qml_path,
+                                         metadata);
+        }
+    }
+
+    // First matching event. Activation hops to this thread and completes before the
+    // publisher collects recipients, so the extension receives the triggering event too.
+    core::EventBus* bus = capability_manager_ ? capability_manager_->eventBus() : nullptr;
+    if (bus && !activation.events.isEmpty()) {
+        pending.event_trigger = connect(
+            bus, &core::EventBus::eventPublished, this,
+            [this, extension_id, topics = activation.events](const QString& event_name,
+                                                             const QVariantMap&) {
+                for (const QString& topic : topics) {
+                    if (core::EventBus::matches(topic, event_name)) {
+                        activateExtension(extension_id, "event " + event_name);
+                        return;
+                    }
+                }
+            },
+            Qt::DirectConnection);
+    }
+
+    if (activation.prewarm_after_ms >= 0) {
+        pending.prewarm_timer = new QTimer(this);
+        pending.prewarm_timer->setSingleShot(true);
+        connect(pending.prewarm_timer, &QTimer::timeout, this,
+                [this, extension_id]() { activateExtension(extension_id, "idle prewarm"); });
+        pending.prewarm_timer->start(activation.prewarm_after_ms);
+    }
+
+    qInfo() << "Built-in extension registered, activation deferred:" << extension_id;
+}
+
+void ExtensionManager::disarmActivation(const QString& extension_id) {
+    auto it = pending_activations_.find(extension_id);
+    if (it == pending_activations_.end()) {
+        return;
+    }
+    disconnect(it->event_trigger);
+    if (it->prewarm_timer) {
+        it->prewarm_timer->stop();
+        it->prewarm_timer->deleteLater();
+    }
+    pending_activations_.erase(it);
+}
+
+bool ExtensionManager::isActivationPending(const QString& extension_id) const {
+    auto it = extensions_.constFind(extension_id);
+    return it != extensions_.cend() && it->activation_pending;
+}
+
+bool ExtensionManager::activateExtension(const QString& extension_id, const QString& reason) {
+    if (QThread::currentThread() != thread()) {
+        bool activated = false;
+        QMetaObject::invokeMethod(
+            this, [&]() { activated = activateExtension(extension_id, reason); },
+            Qt::BlockingQueuedConnection);
+        return activated;
+    }
+
+    auto it = extensions_.find(extension_id);
+    if (it == extensions_.end() || (!it->extension && !isPluginBacked(*it))) {
         return false;
     }
+    if (!it->activation_pending) {
+        // Activated by an outer call whose initialize() is still running on the pool
+        return awaitInitialization(extension_id);
+    }
+    const ExtensionManifest manifest = it->manifest;
+    const auto pending = pending_activations_.constFind(extension_id);
+    const qint64 deferred_ms =
+        pending != pending_activations_.cend() ? pending->since.elapsed() : 0;
+    disarmActivation(extension_id);
+    it->activation_pending = false;
+
+    // Deferred dependencies first
+    for (const QString& dep : manifest.dependencies) {
+        if (isActivationPending(dep) &&
+            !activateExtension(dep, QString("dependency of %1").arg(extension_id))) {
+            qWarning() << "Cannot activate" << extension_id << "- dependency failed:" << dep;
+            emit requestUnregisterComponents(extension_id);
+            extensions_.remove(extension_id);
+            emit extensionError(extension_id, QString("Dependency %1 failed").arg(dep));
+            return false;
+        }
+    }
+
+    QElapsedTimer clock;
+    clock.start();
+    if (!initializeExtension(extension_id)) {
+        qWarning() << "Failed to initialize built-in extension:" << extension_id;
+        emit requestUnregisterComponents(extension_id);
+        extensions_.remove(extension_id);
+        emit extensionError(extension_id, "Initialization failed");
+        return false;
+    }
+    const qint64 init_ms = clock.elapsed();
+    startBuiltInExtension(extension_id);
+    qInfo().noquote() << QString("Activated %1 on %2 after %3 ms: init %4 ms, start %5 ms")
+                             .arg(extension_id, reason.isEmpty() ? "request" : reason)
+                             .arg(deferred_ms)
+                             .arg(init_ms)
+                             .arg(clock.elapsed() - init_ms);
+    return true;
+}
+
+void ExtensionManager::activateCapabilityProviders(const QString& requester_id,
+                                                   const QString& capability_type) {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(
+            this, [&]() { activateCapabilityProviders(requester_id, capability_type); },
+            Qt::BlockingQueuedConnection);
+        return;
+    }
+
+    QStringList providers;
+    for (auto it = extensions_.cbegin(); it != extensions_.cend(); ++it) {
+        if (it->activation_pending && it.key() != requester_id &&
+            it->manifest.activation.capabilities.contains(capability_type)) {
+            providers << it.key();
+        }
+    }
+    for (const QString& id : providers) {
+        activateExtension(id, QString("%1 requested by %2").arg(capability_type, requester_id));
+    }
 }
 
 bool ExtensionManager::unloadExtension(const QString& extension_id) {
+    // Not while its initialize() runs on the pool
+    awaitInitialization(extension_id);
     if (!extensions_.contains(extension_id)) {
         return false;
     }
@@ -210,10 +996,17 @@ bool ExtensionManager::unloadExtension(const QString& extension_id) {
     qInfo() << "Unloading extension:" << extension_id;
 
     auto& info = extensions_[extension_id];
-    if (info.extension) {
-        info.extension->stop();
-        info.extension->cleanup();
+    disarmActivation(extension_id);
+    if (info.extension && !info.activation_pending) {
+        charged(capability_manager_, extension_id, "unload", [&] {
+            info.extension->stop();
+            info.extension->cleanup();
+        });
+    }
+    if (capability_manager_) {
+        capability_manager_->clearExtensionPermissions(extension_id);
     }
+    unloadPlugin(extension_id);
 
     extensions_.remove(extension_id);
     emit extensionUnloaded(extension_id);
@@ -222,14 +1015,24 @@ bool ExtensionManager::unloadExtension(const QString& extension_id) {
 }
 
 bool ExtensionManager::enableExtension(const QString& extension_id) {
+    awaitInitialization(extension_id);
     if (!extensions_.contains(extension_id))
         return false;
     auto& info = extensions_[extension_id];
     if (info.is_running)
         return true;
-    if (!info.extension)
-        return false;
-    info.extension->start();
+    if (info.activation_pending)
+        return activateExtension(extension_id, "enable");
+    if (!info.extension) {
+        if (!isPluginBacked(info))
+            return false;
+        if (!initializeExtension(extension_id)) {
+            qWarning() << "Failed to load or initialise extension:" << extension_id;
+            emit extensionError(extension_id, "Initialization failed");
+            return false;
+        }
+    }
+    charged(capability_manager_, extension_id, "start", [&] { info.extension->start(); });
     info.is_running = true;
     qInfo() << "Enabled extension:" << extension_id;
     emit extensionLoaded(extension_id);
@@ -237,24 +1040,37 @@ bool ExtensionManager::enableExtension(const QString& extension_id) {
 }
 
 bool ExtensionManager::disableExtension(const QString& extension_id) {
+    awaitInitialization(extension_id);
     if (!extensions_.contains(extension_id))
         return false;
     auto& info = extensions_[extension_id];
+    if (info.activation_pending) {
+        // Never started; drop its placeholders and triggers until it is enabled again
+        disarmActivation(extension_id);
+        emit requestUnregisterComponents(extension_id);
+        return true;
+    }
     if (!info.is_running)
         return true;
     if (!info.extension)
         return false;
-    info.extension->stop();
+    charged(capability_manager_, extension_id, "stop", [&] { info.extension->stop(); });
     info.is_running = false;
     qInfo() << "Disabled extension:" << extension_id;
     // Unregister UI components
     emit requestUnregisterComponents(extension_id);
+    if (info.plugin || info.hosted) {
+        // Its views are gone; release its code and data until it is enabled again
+        charged(capability_manager_, extension_id, "cleanup",
+                [&] { info.extension->cleanup(); });
+        unloadPlugin(extension_id);
+    }
     emit extensionUnloaded(extension_id);
     return true;
 }
 
-void ExtensionManager::loadAll() {
-    // 1. Aggregate candidate directories (prefer runtime/app dirs over source)
+QStringList ExtensionManager::getExtensionSearchPaths() const {
+    // Prefer runtime/app dirs over source
     QStringList searchPaths;
     const QString envExt = qEnvironmentVariable("CRANKSHAFT_EXTENSIONS_PATH");
     if (!envExt.isEmpty())
@@ -271,6 +1087,14 @@ void ExtensionManager::loadAll() {
     if (scanSource) {
         searchPaths << (QDir::currentPath() + "/extensions");
     }
+    searchPaths.removeDuplicates();
+    return searchPaths;
+}
+
+void ExtensionManager::loadAll() {
+    CRANKSHAFT_TRACE_SCOPE("extensions", "ExtensionManager::loadAll");
+    // 1. Aggregate candidate directories
+    const QStringList searchPaths = getExtensionSearchPaths();
 
     // 2. Discover paths (unique)
     QStringList extension_paths;
@@ -284,6 +1108,7 @@ void ExtensionManager::loadAll() {
 
     if (extension_paths.isEmpty()) {
         qInfo() << "No extensions discovered for loading";
+        manifest_cache_.save();
         return;
     }
 
@@ -311,6 +1136,12 @@ void ExtensionManager::loadAll() {
         pathById.insert(manifest.id, path);
     }
 
+    const ManifestCache::Stats stats = manifest_cache_.stats();
+    qInfo() << "Extension discovery:" << stats.directory_hits << "search paths and"
+            << stats.manifest_hits << "manifests from cache," << stats.directory_scans
+            << "paths scanned," << stats.manifest_parses << "manifests parsed";
+    manifest_cache_.save();
+
     if (manifestsById.isEmpty()) {
         qInfo() << "No valid manifests discovered";
         return;
@@ -379,28 +1210,25 @@ ExtensionManifest ExtensionManager::getManifest(const QString& extension_id) con
 }
 
 QStringList ExtensionManager::discoverExtensions(const QString& search_path) {
-    QStringList extension_paths;
-    QDir dir(search_path);
-
-    if (!dir.exists()) {
-        qWarning() << "Extensions directory does not exist:" << search_path;
-        return extension_paths;
-    }
-
-    QStringList subdirs = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
-    for (const QString& subdir : subdirs) {
-        QString manifest_path = dir.absoluteFilePath(subdir) + "/manifest.json";
-        if (QFile::exists(manifest_path)) {
-            extension_paths.append(dir.absoluteFilePath(subdir));
-        }
-    }
-
+    CRANKSHAFT_TRACE_SCOPE_DETAIL("extensions", "ExtensionManager::discoverExtensions",
+                                  search_path);
+    const QStringList extension_paths = manifest_cache_.discover(search_path);
     qDebug() << "Discovered" << extension_paths.size() << "extensions";
     return extension_paths;
 }
 
+ExtensionManifest ExtensionManager::discoveredManifest(const QString& extension_path) {
+    return loadManifest(extension_path + "/manifest.json");
+}
+
 bool ExtensionManager::validateManifest(const ExtensionManifest& manifest) {
     // Validate version compatibility
+    const QString& required = manifest.requirements.min_core_version;
+    if (!required.isEmpty() && QVersionNumber::fromString(required) > coreVersion()) {
+        qWarning() << "Extension" << manifest.id << "requires core" << required << "but this is"
+                   << coreVersion().toString();
+        return false;
+    }
     // Check platform compatibility
     // Validate permissions
     return true;
@@ -423,25 +1251,11 @@ bool ExtensionManager::checkDependencies(const ExtensionManifest& manifest) {
 }
 
 ExtensionManifest ExtensionManager::loadManifest(const QString& manifest_path) {
-    QFile file(manifest_path);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qWarning() << "Failed to open manifest file:" << manifest_path;
-        return ExtensionManifest();
-    }
-
-    QByteArray data = file.readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-
-    if (!doc.isObject()) {
-        qWarning() << "Invalid JSON in manifest:" << manifest_path;
-        return ExtensionManifest();
-    }
-
-    QVariantMap json = doc.object().toVariantMap();
-    return ExtensionManifest::fromJson(json);
+    return manifest_cache_.manifest(manifest_path);
 }
 
 void ExtensionManager::grantCapabilities(Extension* extension, const ExtensionManifest& manifest) {
+    CRANKSHAFT_TRACE_SCOPE_DETAIL("extensions", "ExtensionManager::grantCapabilities", manifest.id);
     if (!capability_manager_) {
         qWarning() << "Cannot grant capabilities - CapabilityManager not initialized";
         return;
@@ -449,6 +1263,9 @@ void ExtensionManager::grantCapabilities(Extension* extension, const ExtensionMa
 
     qInfo() << "Granting capabilities to extension:" << manifest.id;
     qDebug() << "  Requested permissions:" << manifest.requirements.required_permissions;
+    capability_manager_->setExtensionPermissions(extension->id(),
+                                                 manifest.requirements.required_permissions);
+    capability_manager_->setRateLimits(extension->id(), manifest.requirements.rate_limits);
 
     for (const QString& permission : manifest.requirements.required_permissions) {
         qDebug() << "  Requesting capability:" << permission;
@@ -466,8 +1283,8 @@ void ExtensionManager::grantCapabilities(Extension* extension, const ExtensionMa
 
     // Log the capability grant for security audit
     capability_manager_->logCapabilityUsage(
-        extension->id(), "extension_initialization",
-        QString("Granted %1 capabilities based on manifest permissions")
+        extension->id(), QStringLiteral("extension"), QStringLiteral("initialise"),
+        QString("Granted %1 manifest permissions")
             .arg(manifest.requirements.required_permissions.size()));
 }
 
@@ -548,5 +1365,30 @@ QStringList ExtensionManager::resolveLoadOrder(const QMap<QString, ExtensionMani
     return order;
 }
 
+QList<QStringList> ExtensionManager::resolveLoadLevels(
+    const QMap<QString, ExtensionManifest>& manifests, const QSet<QString>& alreadyLoaded,
+    QMap<QString, QStringList>& missingDeps, QStringList& cycleGroup) {
+    const QStringList order = resolveLoadOrder(manifests, alreadyLoaded, missingDeps, cycleGroup);
+
+    // Topological order puts dependencies first, so one pass assigns every level
+    QHash<QString, int> levelOf;
+    QList<QStringList> levels;
+    for (const QString& id : order) {
+        int level = 0;
+        for (const QString& dep : manifests.value(id).dependencies) {
+            auto it = levelOf.constFind(dep);
+            if (it != levelOf.cend()) {
+                level = std::max(level, it.value() + 1);
+            }
+        }
+        levelOf.insert(id, level);
+        while (levels.size() <= level) {
+            levels.append(QStringList());
+        }
+        levels[level].append(id);
+    }
+    return levels;
+}
+
 }  // namespace extensions
 }  // namespace opencardev::crankshaft
@@ -19,14 +19,23 @@
 
 #pragma once
 
+#include <QElapsedTimer>
+#include <QHash>
 #include <QMap>
 #include <QObject>
+#include <QPluginLoader>
+#include <QPointer>
 #include <QSet>
 #include <QString>
 #include <QStringList>
+#include <QTimer>
+#include <QVariantList>
+#include <QVersionNumber>
+#include <atomic>
 #include <memory>
 #include "extension.hpp"
 #include "extension_manifest.hpp"
+#include "manifest_cache.hpp"
 
 namespace opencardev::crankshaft {
 namespace core {
@@ -48,17 +57,54 @@ class ExtensionManager : public QObject {
     Q_OBJECT
 
   public:
+    // A built-in extension and the directory holding its manifest.json. Without an
+    // instance, it is created from the manifest's entry_point plugin when first started.
+    struct BuiltInExtension {
+        std::shared_ptr<Extension> extension;
+        QString path;
+    };
+
     explicit ExtensionManager(QObject* parent = nullptr);
     ~ExtensionManager() override;
 
     void initialize(core::CapabilityManager* capability_manager,
                     core::config::ConfigManager* config_manager);
 
+    // Version extensions' min_core_version is checked against
+    static QVersionNumber coreVersion();
+
     // Extension lifecycle
+    /**
+     * Load a discovered extension. One with an entry_point is created from its plugin
+     * library and started, unless disabled by config; the library is only loaded then.
+     */
     bool loadExtension(const QString& extension_path);
     bool registerBuiltInExtension(std::shared_ptr<Extension> extension,
                                   const QString& extension_path);
+    /**
+     * Register several built-in extensions, grouped into dependency levels.
+     * Within a level, initialize() runs concurrently on a thread pool for extensions
+     * that support it; capability grants, config registration and start() stay on the
+     * main thread, and a level is started before the next one is initialised.
+     *
+     * Extensions whose manifest declares activation triggers are not initialised here:
+     * their placeholder views and config items are registered and the triggers armed
+     * (see activateExtension()), unless a non-deferred built-in depends on them.
+     *
+     * @return Number of extensions initialised or deferred successfully
+     */
+    int registerBuiltInExtensions(const QList<BuiltInExtension>& built_ins);
+    /**
+     * Initialise and start a built-in whose activation was deferred, after activating any
+     * deferred dependencies. Called when a trigger fires; safe to call for any extension.
+     *
+     * @param reason What triggered activation, for the log
+     * @return true if the extension is initialised (now or already)
+     */
+    bool activateExtension(const QString& extension_id, const QString& reason = QString());
+    bool isActivationPending(const QString& extension_id) const;
     bool unloadExtension(const QString& extension_id);
+    // Plugin-backed extensions are loaded on enable and unloaded again on disable
     bool enableExtension(const QString& extension_id);
     bool disableExtension(const QString& extension_id);
     void loadAll();
@@ -69,14 +115,22 @@ class ExtensionManager : public QObject {
     QStringList getLoadedExtensions() const;
     ExtensionManifest getManifest(const QString& extension_id) const;
 
-    // Extension discovery
+    // Spans from the last registerBuiltInExtensions() call, in milliseconds:
+    // { id, level, concurrent, init_start_ms, init_ms, start_ms, ok }
+    QVariantList startupTimeline() const { return startup_timeline_; }
+
+    // Extension discovery; listings and manifests are served from a persistent cache
+    QStringList getExtensionSearchPaths() const;
     QStringList discoverExtensions(const QString& search_path);
+    ExtensionManifest discoveredManifest(const QString& extension_path);
 
   signals:
     void extensionLoaded(const QString& extension_id);
     void extensionUnloaded(const QString& extension_id);
     void extensionError(const QString& extension_id, const QString& error);
     void requestUnregisterComponents(const QString& extension_id);
+    // An extension was installed in or removed from a search path
+    void availableExtensionsChanged();
 
   private:
     struct ExtensionInfo {
@@ -84,9 +138,14 @@ class ExtensionManager : public QObject {
         ExtensionManifest manifest;
         QString path;
         bool is_running;
+        bool activation_pending;  // Registered, but initialize() deferred until a trigger
+        // Library the extension was created from; null when linked in or not loaded
+        std::shared_ptr<QPluginLoader> plugin;
+        bool hosted;  // extension is an ExtensionHostProxy; the library is in its host
 
         // Make the struct copyable
-        ExtensionInfo() : extension(nullptr), is_running(false) {}
+        ExtensionInfo()
+            : extension(nullptr), is_running(false), activation_pending(false), hosted(false) {}
         ExtensionInfo(const ExtensionInfo&) = default;
         ExtensionInfo& operator=(const ExtensionInfo&) = default;
         ExtensionInfo(ExtensionInfo&&) = default;
@@ -97,17 +156,78 @@ class ExtensionManager : public QObject {
     bool checkDependencies(const ExtensionManifest& manifest);
     ExtensionManifest loadManifest(const QString& manifest_path);
     void grantCapabilities(Extension* extension, const ExtensionManifest& manifest);
+    // Apply system.extensions.rate_limits.<capability> as the system-wide rate
+    void applyRateLimitConfig(const QString& capability_type, const QVariant& value);
+    // Apply system.extensions.permissions.overrides: id (or "*") -> { allow, deny }
+    void applyPolicyOverrides(const QVariant& value);
+    // Pass changed permissions and system rate limits on to extension host processes
+    void reconfigureHosts();
     // Resolve a safe load order using topological sort. Returns ordered list of ids.
     // Populates missingDeps with any extension -> missing dependency list.
     // Populates cycleGroup with extensions participating in a dependency cycle.
     QStringList resolveLoadOrder(const QMap<QString, ExtensionManifest>& manifests,
                                  const QSet<QString>& alreadyLoaded,
                                  QMap<QString, QStringList>& missingDeps, QStringList& cycleGroup);
+    // resolveLoadOrder() grouped into levels; each level depends only on earlier ones
+    QList<QStringList> resolveLoadLevels(const QMap<QString, ExtensionManifest>& manifests,
+                                         const QSet<QString>& alreadyLoaded,
+                                         QMap<QString, QStringList>& missingDeps,
+                                         QStringList& cycleGroup);
+    // system.extensions.manage.<id>; extensions are enabled unless configured otherwise
+    bool isEnabledByConfig(const QString& extension_id) const;
+    // Start an initialised built-in unless disabled by config
+    void startBuiltInExtension(const QString& extension_id);
+    // Whether the extension is created from its entry_point plugin rather than linked in
+    bool isPluginBacked(const ExtensionInfo& info) const;
+    /**
+     * Load the entry_point library and create the extension from it. An isolated
+     * extension gets an ExtensionHostProxy instead, and its library is loaded in a
+     * separate crankshaft-extension-host process.
+     */
+    bool loadPlugin(const QString& extension_id);
+    // CRANKSHAFT_EXTENSION_HOST (comma-separated ids, or "*") or
+    // system.extensions.isolation.<id>
+    bool runsInHost(const QString& extension_id) const;
+    // Destroy the extension, revoking its capabilities, and unload its library
+    void unloadPlugin(const QString& extension_id);
+    // Grant capabilities and run initialize(), loading the plugin first if needed
+    bool initializeExtension(const QString& extension_id);
+    // initialize() on the thread pool when the extension supports it, serving events here
+    // until it returns; otherwise inline
+    bool runInitialize(const QString& extension_id, Extension* extension);
+    // Wait for an initialize() running on the pool; true if there was none
+    bool awaitInitialization(const QString& extension_id);
+    // Let the extension register its config items; a plugin's pages are kept as copies
+    void registerConfigItems(const QString& extension_id);
+    // Register the page in the manifest's config_schema file without loading the library
+    void registerSchemaPage(const QString& extension_id);
+
+    // Armed activation triggers of a deferred built-in
+    struct PendingActivation {
+        QMetaObject::Connection event_trigger;
+        QPointer<QTimer> prewarm_timer;
+        QElapsedTimer since;
+    };
+    // Register placeholders and config, then arm the manifest's activation triggers
+    void deferActivation(const QString& extension_id);
+    void disarmActivation(const QString& extension_id);
+    // Capability activator: activate the deferred providers of a capability type
+    void activateCapabilityProviders(const QString& requester_id, const QString& capability_type);
 
     QMap<QString, ExtensionInfo> extensions_;
     core::CapabilityManager* capability_manager_;
     core::config::ConfigManager* config_manager_;
     QString extensions_dir_;
+    QVariantList startup_timeline_;
+    QHash<QString, PendingActivation> pending_activations_;
+    struct Initialization {
+        std::atomic_bool ok{false};
+        std::atomic_bool done{false};
+    };
+    // Extensions whose initialize() is running on the pool
+    QHash<QString, std::shared_ptr<Initialization>> initializing_;
+    QStringList policy_override_ids_;  // Ids with an override applied from config
+    ManifestCache manifest_cache_;
 };
 
 }  // namespace extensions
@@ -52,6 +52,17 @@ ExtensionManifest ExtensionManifest::fromJson(const QVariantMap& json) {
     for (const auto& perm : permissions) {
         manifest.requirements.required_permissions.append(perm.toString());
     }
+    manifest.requirements.rate_limits = requirements.value("rate_limits").toMap();
+
+    const QVariantMap activation = json.value("activation").toMap();
+    manifest.activation.views = activation.value("views").toList();
+    for (const auto& topic : activation.value("events").toList()) {
+        manifest.activation.events.append(topic.toString());
+    }
+    for (const auto& type : activation.value("capabilities").toList()) {
+        manifest.activation.capabilities.append(type.toString());
+    }
+    manifest.activation.prewarm_after_ms = activation.value("prewarm_after_ms", -1).toInt();
 
     manifest.metadata = json.value("metadata").toMap();
 
@@ -91,8 +102,20 @@ QVariantMap ExtensionManifest::toJson() const {
         perms.append(perm);
     }
     reqs["required_permissions"] = perms;
+    if (!requirements.rate_limits.isEmpty()) {
+        reqs["rate_limits"] = requirements.rate_limits;
+    }
 
     json["requirements"] = reqs;
+
+    if (activation.isLazy()) {
+        QVariantMap act;
+        act["views"] = activation.views;
+        act["events"] = QVariant(activation.events);
+        act["capabilities"] = QVariant(activation.capabilities);
+        act["prewarm_after_ms"] = activation.prewarm_after_ms;
+        json["activation"] = act;
+    }
     json["metadata"] = metadata;
 
     return json;
@@ -43,8 +43,26 @@ struct ExtensionManifest {
     struct Requirements {
         QString min_core_version;
         QStringList required_permissions;
+        QVariantMap rate_limits;  // Capability type -> { rate, burst, policy, max_delay_ms }
     } requirements;
 
+    /**
+     * Deferred activation. A built-in declaring any trigger is registered with its
+     * placeholder views and config at boot, and only initialised and started when the
+     * first trigger fires; one without triggers starts at boot as before.
+     */
+    struct Activation {
+        QVariantList views;         // Placeholder views: { slot, qml_path, title, icon, ... }
+        QStringList events;         // Event bus topics (globs allowed)
+        QStringList capabilities;   // Capability types it provides to other extensions
+        int prewarm_after_ms = -1;  // Activate this long after registration; -1 never
+
+        bool isLazy() const {
+            return !views.isEmpty() || !events.isEmpty() || !capabilities.isEmpty() ||
+                   prewarm_after_ms >= 0;
+        }
+    } activation;
+
     QVariantMap metadata;
 
     static ExtensionManifest fromJson(const QVariantMap& json);
@@ -0,0 +1,67 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QtPlugin>
+#include <memory>
+#include "extension.hpp"
+
+namespace opencardev::crankshaft {
+namespace extensions {
+
+/**
+ * Factory exported by an extension's shared library (its manifest entry_point).
+ *
+ * ExtensionManager loads the library with QPluginLoader when the extension is first
+ * needed and unloads it again when the extension is disabled, so a disabled extension
+ * keeps none of its code or static data resident. Each library declares exactly one
+ * plugin class, embedding its manifest.json as plugin metadata:
+ *
+ *   class NavigationPlugin : public QObject, public ExtensionPlugin {
+ *       Q_OBJECT
+ *       Q_PLUGIN_METADATA(IID CRANKSHAFT_EXTENSION_PLUGIN_IID FILE "manifest.json")
+ *       Q_INTERFACES(opencardev::crankshaft::extensions::ExtensionPlugin)
+ *     public:
+ *       std::shared_ptr<Extension> createExtension() override {
+ *           return std::make_shared<NavigationExtension>();
+ *       }
+ *   };
+ *
+ * Before unloading, the manager stops and cleans up the extension, revokes its
+ * capabilities and destroys it; cleanup() must release anything the core could still
+ * call back into (timers, connections to core objects, QML types).
+ */
+class ExtensionPlugin {
+  public:
+    virtual ~ExtensionPlugin() = default;
+
+    // A new instance; the plugin stays loaded for as long as the instance lives
+    virtual std::shared_ptr<Extension> createExtension() = 0;
+};
+
+}  // namespace extensions
+}  // namespace opencardev::crankshaft
+
+// Extension ABI version. Bump it whenever Extension or the capability interfaces change
+// incompatibly; libraries built against another version are refused without being loaded.
+#define CRANKSHAFT_EXTENSION_PLUGIN_IID "org.opencardev.crankshaft.ExtensionPlugin/1.7"
+
+Q_DECLARE_INTERFACE(opencardev::crankshaft::extensions::ExtensionPlugin,
+                    CRANKSHAFT_EXTENSION_PLUGIN_IID)
@@ -0,0 +1,400 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "extension_host.hpp"
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDebug>
+#include <QLocalSocket>
+#include <QSet>
+#include <QThread>
+#include <atomic>
+#include <utility>
+#include "../../core/capabilities/CapabilityManager.hpp"
+#include "../../core/ui/UIRegistrar.hpp"
+#include "../extension_plugin.hpp"
+
+namespace opencardev::crankshaft {
+namespace extensions {
+namespace host {
+
+namespace {
+
+// Event capability whose bus lives in the core; permissions are enforced there
+class HostEventCapability : public core::capabilities::EventCapability {
+  public:
+    HostEventCapability(const QString& extension_id, ExtensionHost* host)
+        : extension_id_(extension_id), host_(host), is_valid_(true) {}
+
+    QString extensionId() const override { return extension_id_; }
+    bool isValid() const override { return is_valid_; }
+    void invalidate() override {
+        is_valid_ = false;
+        for (int id : std::as_const(subscriptions_)) {
+            host_->unsubscribe(id);
+        }
+        subscriptions_.clear();
+    }
+
+    bool emitEvent(const QString& eventName, const QVariantMap& eventData) override {
+        return is_valid_ && host_->emitEvent(eventName, eventData);
+    }
+    int subscribe(const QString& eventPattern,
+                  std::function<void(const QVariantMap&)> callback) override {
+        if (!is_valid_) {
+            return -1;
+        }
+        const int id = host_->subscribe(eventPattern, std::move(callback));
+        subscriptions_.insert(id);
+        return id;
+    }
+    void unsubscribe(int subscriptionId) override {
+        if (subscriptions_.remove(subscriptionId)) {
+            host_->unsubscribe(subscriptionId);
+        }
+    }
+    bool canEmit(const QString& eventName) const override {
+        Q_UNUSED(eventName);
+        return is_valid_;
+    }
+    bool canSubscribe(const QString& eventPattern) const override {
+        Q_UNUSED(eventPattern);
+        return is_valid_;
+    }
+
+  private:
+    QString extension_id_;
+    ExtensionHost* host_;
+    std::atomic<bool> is_valid_;
+    QSet<int> subscriptions_;
+};
+
+}  // namespace
+
+// Forwards view registration to the core's UI
+class HostUIRegistrar : public core::ui::UIRegistrar {
+  public:
+    explicit HostUIRegistrar(ExtensionHost* host) : host_(host) {}
+
+    void registerComponent(const QString& extensionId, const QString& slotType,
+                           const QString& qmlPath, const QVariantMap& metadata) override {
+        Q_UNUSED(extensionId);
+        host_->registerComponent(slotType, qmlPath, metadata);
+    }
+    void unregisterComponent(const QString& componentId) override {
+        host_->unregisterComponent(componentId);
+    }
+
+  private:
+    ExtensionHost* host_;
+};
+
+ExtensionHost::ExtensionHost(QObject* parent)
+    : QObject(parent),
+      channel_(nullptr),
+      ui_registrar_(std::make_unique<HostUIRegistrar>(this)),
+      next_subscription_id_(1),
+      audit_sequence_(0),
+      events_received_(0),
+      latency_total_ns_(0),
+      latency_max_ns_(0) {}
+
+ExtensionHost::~ExtensionHost() {
+    // Its vtable and destructor live in the library
+    extension_.reset();
+    capabilities_.reset();
+}
+
+bool ExtensionHost::connectToCore(const QString& server_name) {
+    auto* socket = new QLocalSocket(this);
+    socket->connectToServer(server_name);
+    if (!socket->waitForConnected(5000)) {
+        qWarning() << "Extension host cannot connect to" << server_name << socket->errorString();
+        delete socket;
+        return false;
+    }
+    channel_ = new HostChannel(socket, this);
+    connect(channel_, &HostChannel::messageReceived, this, &ExtensionHost::handleMessage);
+    connect(channel_, &HostChannel::disconnected, this, [this]() {
+        qWarning() << "Extension host lost the core; exiting:" << extension_id_;
+        if (extension_) {
+            extension_->stop();
+            extension_->cleanup();
+        }
+        QCoreApplication::exit(1);
+    });
+    return true;
+}
+
+void ExtensionHost::handleMessage(Message type, const QByteArray& body) {
+    QDataStream in(body);
+    in.setVersion(kStreamVersion);
+    quint32 seq = 0;
+
+    switch (type) {
+        case Message::Configure:
+            if (!configure(body)) {
+                QCoreApplication::exit(1);
+            }
+            break;
+        case Message::Initialize:
+            in >> seq;
+            reply(seq, initializeExtension());
+            break;
+        case Message::Start:
+            in >> seq;
+            if (extension_) {
+                extension_->start();
+            }
+            reply(seq, extension_ != nullptr);
+            break;
+        case Message::Stop:
+            in >> seq;
+            if (extension_) {
+                extension_->stop();
+            }
+            reply(seq, extension_ != nullptr);
+            break;
+        case Message::Cleanup:
+            in >> seq;
+            if (extension_) {
+                extension_->cleanup();
+                capabilities_->clearExtensionPermissions(extension_id_);
+                extension_.reset();
+            }
+            if (events_writer_) {
+                events_writer_->flush();
+            }
+            reply(seq, true);
+            QCoreApplication::exit(0);
+            break;
+        case Message::Reconfigure:
+            reconfigure(body);
+            break;
+        case Message::Revoke: {
+            QString capability_type;
+            in >> capability_type;
+            if (!capabilities_) {
+                break;
+            }
+            if (capability_type.isEmpty()) {
+                capabilities_->revokeAllCapabilities(extension_id_);
+            } else {
+                capabilities_->revokeCapability(extension_id_, capability_type);
+            }
+            break;
+        }
+        case Message::Ping: {
+            in >> seq;
+            report();
+            const qint64 mean_ns =
+                events_received_ > 0 ? latency_total_ns_ / qint64(events_received_) : 0;
+            channel_->send(Message::Pong, seq, events_received_, mean_ns, latency_max_ns_);
+            break;
+        }
+        case Message::EventsPending:
+            drainEvents();
+            break;
+        default:
+            qWarning() << "Extension host: unexpected message" << int(type);
+            break;
+    }
+}
+
+bool ExtensionHost::configure(const QByteArray& body) {
+    QDataStream in(body);
+    in.setVersion(kStreamVersion);
+    QString ring_in;
+    QString ring_out;
+    QVariantMap default_rate_limits;
+    in >> extension_id_ >> library_ >> grants_ >> permissions_ >> rate_limits_ >>
+        default_rate_limits >> ring_in >> ring_out;
+    if (in.status() != QDataStream::Ok || !events_in_.open(ring_in) ||
+        !events_out_.open(ring_out)) {
+        qWarning() << "Extension host: invalid configuration";
+        return false;
+    }
+    events_writer_ = std::make_unique<RingWriter>(&events_out_, channel_);
+
+    // Capabilities other than event and UI are created here, so their work stays in
+    // this process
+    capabilities_ = std::make_unique<core::CapabilityManager>(&bus_, nullptr);
+    capabilities_->unregisterCapabilityFactory("event");
+    capabilities_->registerCapabilityFactory(
+        "event", [this](const QString& extensionId, const QVariantMap&) {
+            return std::make_shared<HostEventCapability>(extensionId, this);
+        });
+    capabilities_->setUIRegistrar(ui_registrar_.get());
+    // Clear revoked capabilities from the extension's typed slots, as the core does
+    capabilities_->setRevocationListener(
+        [this](const QString&, const QString& capability_type) {
+            if (extension_) {
+                extension_->revokeCapability(capability_type);
+            }
+        });
+    applyDefaultRateLimits(default_rate_limits);
+    capabilities_->setExtensionPermissions(extension_id_, permissions_);
+    capabilities_->setRateLimits(extension_id_, rate_limits_);
+    qInfo() << "Extension host configured for" << extension_id_ << "from" << library_;
+    return true;
+}
+
+void ExtensionHost::reconfigure(const QByteArray& body) {
+    QDataStream in(body);
+    in.setVersion(kStreamVersion);
+    QVariantMap default_rate_limits;
+    in >> permissions_ >> default_rate_limits;
+    if (in.status() != QDataStream::Ok || !capabilities_) {
+        qWarning() << "Extension host: invalid reconfiguration";
+        return;
+    }
+    applyDefaultRateLimits(default_rate_limits);
+    // Recompiling revokes whatever depended on a withdrawn permission
+    capabilities_->setExtensionPermissions(extension_id_, permissions_);
+}
+
+void ExtensionHost::applyDefaultRateLimits(const QVariantMap& limits) {
+    for (auto it = limits.cbegin(); it != limits.cend(); ++it) {
+        capabilities_->setDefaultRateLimit(
+            it.key(), core::capabilities::RateLimit::fromMap(it.value().toMap()));
+    }
+}
+
+void ExtensionHost::report() {
+    if (!capabilities_) {
+        return;
+    }
+    QList<core::capabilities::AuditEntry> entries;
+    audit_sequence_ = capabilities_->collectAuditLog(audit_sequence_, &entries);
+    QVariantList audit;
+    for (const core::capabilities::AuditEntry& entry : std::as_const(entries)) {
+        if (entry.extension_id == extension_id_) {
+            audit << QVariantList{entry.capability_type, entry.action, entry.details};
+        }
+    }
+    const core::capabilities::ResourceCounters counters =
+        capabilities_->resourceUsage(extension_id_)->counters();
+    channel_->send(Message::Report, audit, counters.wall_ns, counters.cpu_ns, counters.calls,
+                   counters.net_bytes_in, counters.net_bytes_out, counters.fs_bytes_read,
+                   counters.fs_bytes_written);
+}
+
+bool ExtensionHost::initializeExtension() {
+    if (extension_) {
+        return true;
+    }
+    if (!capabilities_) {
+        qWarning() << "Extension host: initialise before configure";
+        return false;
+    }
+
+    loader_.setFileName(library_);
+    if (!loader_.load()) {
+        qWarning() << "Extension host: failed to load" << library_ << loader_.errorString();
+        return false;
+    }
+    auto* factory = qobject_cast<ExtensionPlugin*>(loader_.instance());
+    extension_ = factory ? factory->createExtension() : nullptr;
+    if (!extension_ || extension_->id() != extension_id_) {
+        qWarning() << "Extension plugin" << library_ << "did not create" << extension_id_;
+        extension_.reset();
+        return false;
+    }
+
+    for (const QString& permission : std::as_const(grants_)) {
+        auto capability = capabilities_->grantCapability(extension_id_, permission);
+        if (capability) {
+            extension_->grantCapability(capability);
+        } else {
+            qWarning() << "Extension host: failed to grant capability:" << permission;
+        }
+    }
+    if (!extension_->initialize()) {
+        capabilities_->clearExtensionPermissions(extension_id_);
+        extension_.reset();
+        return false;
+    }
+    return true;
+}
+
+void ExtensionHost::reply(quint32 seq, bool ok) {
+    channel_->send(Message::Reply, seq, ok);
+}
+
+bool ExtensionHost::emitEvent(const QString& event_name, const QVariantMap& data) {
+    return events_writer_ && events_writer_->write(pack(event_name, data, monotonicNs()));
+}
+
+int ExtensionHost::subscribe(const QString& pattern,
+                             std::function<void(const QVariantMap&)> callback) {
+    const int id = next_subscription_id_++;
+    subscriptions_.insert(id, std::move(callback));
+    channel_->send(Message::Subscribe, qint32(id), pattern);
+    return id;
+}
+
+void ExtensionHost::unsubscribe(int subscription_id) {
+    if (subscriptions_.remove(subscription_id) > 0 && channel_) {
+        channel_->send(Message::Unsubscribe, qint32(subscription_id));
+    }
+}
+
+void ExtensionHost::registerComponent(const QString& slot, const QString& qml_path,
+                                      const QVariantMap& metadata) {
+    channel_->send(Message::RegisterComponent, slot, qml_path, metadata);
+}
+
+void ExtensionHost::unregisterComponent(const QString& component_id) {
+    channel_->send(Message::UnregisterComponent, component_id);
+}
+
+void ExtensionHost::drainEvents() {
+    do {
+        QByteArray record;
+        while (events_in_.pop(&record)) {
+            QDataStream in(record);
+            in.setVersion(kStreamVersion);
+            qint32 subscription_id = 0;
+            QVariantMap data;
+            qint64 sent_ns = 0;
+            in >> subscription_id >> data >> sent_ns;
+
+            const qint64 latency_ns = monotonicNs() - sent_ns;
+            ++events_received_;
+            latency_total_ns_ += latency_ns;
+            latency_max_ns_ = qMax(latency_max_ns_, latency_ns);
+
+            // A copy: the callback may unsubscribe itself
+            const auto callback = subscriptions_.value(subscription_id);
+            if (callback) {
+                callback(data);
+            }
+        }
+    } while (!events_in_.sleep());
+
+    if (events_in_.isDead()) {
+        // Nothing more can be trusted from the core's side; it starts a fresh host
+        qWarning() << "Extension host event ring is corrupt; exiting:" << extension_id_;
+        QCoreApplication::exit(1);
+    }
+}
+
+}  // namespace host
+}  // namespace extensions
+}  // namespace opencardev::crankshaft
@@ -0,0 +1,117 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QPluginLoader>
+#include <QStringList>
+#include <QVariantMap>
+#include <functional>
+#include <memory>
+#include "../../core/events/event_bus.hpp"
+#include "../extension.hpp"
+#include "host_channel.hpp"
+#include "ring_writer.hpp"
+#include "shared_ring.hpp"
+
+namespace opencardev::crankshaft {
+namespace core {
+class CapabilityManager;
+}
+
+namespace extensions {
+namespace host {
+
+class HostUIRegistrar;
+
+/**
+ * Runtime of the crankshaft-extension-host process: runs one extension plugin on
+ * behalf of the core's ExtensionManager (see ExtensionHostProxy).
+ *
+ * Capabilities are created in this process, so blocking work (DBus, GStreamer, file
+ * I/O) stalls only the host. Event and UI capabilities are proxied: events go through
+ * the core's event capability for this extension, over the shared-memory rings, and
+ * views are registered with the core's UI.
+ *
+ * The core stays in charge of the others: it sends the extension's effective
+ * permissions and system rate limits, again whenever they change, and revocations. The
+ * host reports its audit records and resource counters back on every ping.
+ */
+class ExtensionHost : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit ExtensionHost(QObject* parent = nullptr);
+    ~ExtensionHost() override;
+
+    // Connect to the core's control socket; the host quits when it disconnects
+    bool connectToCore(const QString& server_name);
+
+    // Proxied capabilities; emitEvent() may be called from any thread
+    bool emitEvent(const QString& event_name, const QVariantMap& data);
+    int subscribe(const QString& pattern, std::function<void(const QVariantMap&)> callback);
+    void unsubscribe(int subscription_id);
+    void registerComponent(const QString& slot, const QString& qml_path,
+                           const QVariantMap& metadata);
+    void unregisterComponent(const QString& component_id);
+
+  private:
+    void handleMessage(Message type, const QByteArray& body);
+    bool configure(const QByteArray& body);
+    void reconfigure(const QByteArray& body);
+    void applyDefaultRateLimits(const QVariantMap& limits);
+    // Audit records and resource counters gathered since the last report
+    void report();
+    bool initializeExtension();
+    void reply(quint32 seq, bool ok);
+    // Deliver events from the core, then sleep on the ring
+    void drainEvents();
+
+    HostChannel* channel_;
+    core::EventBus bus_;  // Required by CapabilityManager; events are proxied
+    std::unique_ptr<HostUIRegistrar> ui_registrar_;
+    std::unique_ptr<core::CapabilityManager> capabilities_;
+    QPluginLoader loader_;
+    std::shared_ptr<Extension> extension_;
+
+    QString extension_id_;
+    QString library_;
+    QStringList grants_;       // Capabilities the core granted, created here on initialise
+    QStringList permissions_;  // Effective permission set, with the core's overrides
+    QVariantMap rate_limits_;
+    quint64 audit_sequence_;   // First audit record not yet reported
+
+    SharedRing events_in_;
+    SharedRing events_out_;
+    std::unique_ptr<RingWriter> events_writer_;
+
+    QHash<int, std::function<void(const QVariantMap&)>> subscriptions_;
+    int next_subscription_id_;
+
+    // Core -> host transport latency
+    quint64 events_received_;
+    qint64 latency_total_ns_;
+    qint64 latency_max_ns_;
+};
+
+}  // namespace host
+}  // namespace extensions
+}  // namespace opencardev::crankshaft
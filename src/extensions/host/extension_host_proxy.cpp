@@ -0,0 +1,642 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "extension_host_proxy.hpp"
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QMutexLocker>
+#include <QUrl>
+#include "../../core/capabilities/CapabilityManager.hpp"
+#include "../../core/capabilities/EventCapability.hpp"
+#include "../../core/capabilities/UICapability.hpp"
+
+namespace opencardev::crankshaft {
+namespace extensions {
+namespace host {
+
+namespace {
+
+constexpr quint32 kRingBytes = 1024 * 1024;
+constexpr int kConnectTimeoutMs = 5000;
+constexpr int kInitializeTimeoutMs = 10000;
+constexpr int kCleanupTimeoutMs = 1000;
+constexpr int kPingIntervalMs = 2000;
+// Three missed pings
+constexpr int kUnresponsiveMs = 3 * kPingIntervalMs;
+constexpr int kRestartWindowMs = 60000;
+constexpr int kRestartBackoffMs = 500;
+// A restart runs from the event loop; this bounds it as a whole
+constexpr int kRestartTimeoutMs = kConnectTimeoutMs + kInitializeTimeoutMs;
+// System rate limits the host enforces itself; events are limited in the core
+constexpr const char* kHostRateLimitedTypes[] = {"network", "filesystem"};
+
+// Counter increase since an earlier reading of the same host
+quint64 increase(quint64 now, quint64 before) {
+    return now > before ? now - before : 0;
+}
+
+}  // namespace
+
+ExtensionHostProxy::ExtensionHostProxy(const ExtensionManifest& manifest,
+                                       const QString& extension_path, const QString& library,
+                                       core::CapabilityManager* capability_manager,
+                                       QObject* parent)
+    : QObject(parent),
+      manifest_(manifest),
+      extension_path_(extension_path),
+      library_(library),
+      capability_manager_(capability_manager),
+      seq_(0),
+      awaited_seq_(0),
+      restart_seq_(0),
+      reply_ok_(false),
+      generation_(0),
+      running_(false),
+      stopping_(false),
+      from_host_total_ns_(0) {
+    // The host's log goes to ours
+    process_.setProcessChannelMode(QProcess::ForwardedChannels);
+    connect(&process_, &QProcess::finished, this, &ExtensionHostProxy::hostFinished);
+    ping_timer_.setInterval(kPingIntervalMs);
+    connect(&ping_timer_, &QTimer::timeout, this, &ExtensionHostProxy::watchdog);
+    restart_timer_.setSingleShot(true);
+    connect(&restart_timer_, &QTimer::timeout, this, [this]() {
+        qWarning() << "Extension host for" << id() << "did not restart in time";
+        failRestart();
+    });
+    connect(&process_, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart && restart_timer_.isActive()) {
+            failRestart();
+        }
+    });
+    lifetime_.start();
+}
+
+ExtensionHostProxy::~ExtensionHostProxy() {
+    shutDownHost(false);
+}
+
+ExtensionType ExtensionHostProxy::type() const {
+    const QString type = manifest_.type.toLower();
+    if (type == "service") {
+        return ExtensionType::Service;
+    }
+    if (type == "ui") {
+        return ExtensionType::UI;
+    }
+    if (type == "integration") {
+        return ExtensionType::Integration;
+    }
+    if (type == "platform") {
+        return ExtensionType::Platform;
+    }
+    return ExtensionType::Unknown;
+}
+
+QString ExtensionHostProxy::hostBinary() {
+    const QString binary = qEnvironmentVariable("CRANKSHAFT_EXTENSION_HOST_BINARY");
+    if (!binary.isEmpty()) {
+        return binary;
+    }
+    return QDir(QCoreApplication::applicationDirPath()).filePath("crankshaft-extension-host");
+}
+
+bool ExtensionHostProxy::initialize() {
+    stopping_ = false;
+    if (!launchHost()) {
+        shutDownHost(false);
+        return false;
+    }
+    const bool ok = request(Message::Initialize, kInitializeTimeoutMs);
+    // Both ends have mapped the rings by now; nothing is left behind if either crashes
+    events_out_.unlink();
+    events_in_.unlink();
+    if (!ok) {
+        qWarning() << "Extension host failed to initialise" << id();
+        shutDownHost(true);
+        return false;
+    }
+    since_pong_.start();
+    ping_timer_.start();
+    qInfo() << "Extension" << id() << "initialised in host process" << hostPid();
+    return true;
+}
+
+void ExtensionHostProxy::start() {
+    running_ = true;
+    if (channel_) {
+        channel_->send(Message::Start, ++seq_);
+    }
+}
+
+void ExtensionHostProxy::stop() {
+    running_ = false;
+    if (channel_) {
+        channel_->send(Message::Stop, ++seq_);
+    }
+}
+
+void ExtensionHostProxy::cleanup() {
+    running_ = false;
+    shutDownHost(true);
+    const TransportStats stats = transportStats();
+    qInfo().noquote() << QString("Extension host for %1 stopped: %2 events in (mean %3 us, "
+                                 "max %4 us), %5 out (mean %6 us, max %7 us), %8 restarts")
+                             .arg(id())
+                             .arg(stats.events_to_host)
+                             .arg(stats.to_host_mean_ns / 1000.0, 0, 'f', 1)
+                             .arg(stats.to_host_max_ns / 1000.0, 0, 'f', 1)
+                             .arg(stats.events_from_host)
+                             .arg(stats.from_host_mean_ns / 1000.0, 0, 'f', 1)
+                             .arg(stats.from_host_max_ns / 1000.0, 0, 'f', 1)
+                             .arg(stats.restarts);
+}
+
+bool ExtensionHostProxy::ping(int timeout_ms) {
+    return channel_ && request(Message::Ping, timeout_ms);
+}
+
+qint64 ExtensionHostProxy::hostPid() const {
+    return process_.processId();
+}
+
+ExtensionHostProxy::TransportStats ExtensionHostProxy::transportStats() const {
+    TransportStats stats = stats_;
+    if (stats.events_from_host > 0) {
+        stats.from_host_mean_ns = from_host_total_ns_ / qint64(stats.events_from_host);
+    }
+    if (events_writer_) {
+        stats.events_dropped += events_writer_->dropped();
+    }
+    return stats;
+}
+
+void ExtensionHostProxy::reconfigure() {
+    if (channel_) {
+        channel_->send(Message::Reconfigure, effectivePermissions(), defaultRateLimits());
+    }
+}
+
+void ExtensionHostProxy::revokeInHost(const QString& capability_type) {
+    // Revocations arrive with the capability manager locked, possibly off this thread
+    QMetaObject::invokeMethod(this, [this, capability_type]() {
+        if (channel_) {
+            channel_->send(Message::Revoke, capability_type);
+        }
+    });
+}
+
+bool ExtensionHostProxy::launchHost() {
+    if (!spawnHost()) {
+        return false;
+    }
+    if (!process_.waitForStarted(kConnectTimeoutMs)) {
+        qWarning() << "Cannot start extension host" << hostBinary() << process_.errorString();
+        return false;
+    }
+    if (!server_->waitForNewConnection(kConnectTimeoutMs)) {
+        qWarning() << "Extension host for" << id() << "did not connect";
+        return false;
+    }
+    attachHost();
+    return true;
+}
+
+bool ExtensionHostProxy::spawnHost() {
+    ++generation_;
+    host_counters_ = core::capabilities::ResourceCounters();
+    const QString tag = QString("%1-%2-%3")
+                            .arg(QCoreApplication::applicationPid())
+                            .arg(id())
+                            .arg(generation_);
+
+    server_ = std::make_unique<QLocalServer>();
+    server_->setSocketOptions(QLocalServer::UserAccessOption);
+    const QString server_name = "crankshaft-host-" + tag;
+    QLocalServer::removeServer(server_name);
+    if (!server_->listen(server_name)) {
+        qWarning() << "Cannot listen for extension host:" << server_->errorString();
+        return false;
+    }
+    if (!events_out_.create("/crankshaft-" + tag + "-c2h", kRingBytes) ||
+        !events_in_.create("/crankshaft-" + tag + "-h2c", kRingBytes)) {
+        return false;
+    }
+
+    process_.start(hostBinary(), {server_name});
+    return true;
+}
+
+void ExtensionHostProxy::attachHost() {
+    channel_ = std::make_unique<HostChannel>(server_->nextPendingConnection());
+    connect(channel_.get(), &HostChannel::messageReceived, this,
+            &ExtensionHostProxy::handleMessage);
+    server_->close();
+    {
+        QMutexLocker lock(&writer_mutex_);
+        events_writer_ = std::make_unique<RingWriter>(&events_out_, channel_.get());
+    }
+
+    channel_->send(Message::Configure, id(), library_, grantedPermissions(),
+                   effectivePermissions(), manifest_.requirements.rate_limits,
+                   defaultRateLimits(), events_out_.name(), events_in_.name());
+}
+
+bool ExtensionHostProxy::request(Message type, int timeout_ms) {
+    if (!channel_) {
+        return false;
+    }
+    awaited_seq_ = ++seq_;
+    reply_ok_ = false;
+    channel_->send(type, awaited_seq_);
+
+    QElapsedTimer clock;
+    clock.start();
+    while (awaited_seq_ != 0) {
+        const int remaining = timeout_ms - int(clock.elapsed());
+        if (remaining <= 0 || !channel_->waitForMessages(remaining)) {
+            qWarning() << "Extension host for" << id() << "did not answer message" << int(type);
+            awaited_seq_ = 0;
+            return false;
+        }
+    }
+    return reply_ok_;
+}
+
+void ExtensionHostProxy::shutDownHost(bool graceful) {
+    stopping_ = true;
+    ping_timer_.stop();
+    restart_timer_.stop();
+    restart_seq_ = 0;
+    if (graceful && channel_ && channel_->isConnected()) {
+        request(Message::Cleanup, kCleanupTimeoutMs);
+    }
+    if (process_.state() != QProcess::NotRunning) {
+        if (!graceful || !process_.waitForFinished(kCleanupTimeoutMs)) {
+            process_.kill();
+            process_.waitForFinished(kCleanupTimeoutMs);
+        }
+    }
+    releaseTransport();
+}
+
+void ExtensionHostProxy::releaseTransport() {
+    // Stop the bus calling into forwardEvent() before the writer goes
+    auto events = getCapability<core::capabilities::EventCapability>();
+    for (int subscription_id : std::as_const(subscriptions_)) {
+        if (events) {
+            events->unsubscribe(subscription_id);
+        }
+    }
+    subscriptions_.clear();
+    {
+        QMutexLocker lock(&writer_mutex_);
+        if (events_writer_) {
+            stats_.events_dropped += events_writer_->dropped();
+        }
+        events_writer_.reset();
+    }
+    channel_.reset();
+    server_.reset();
+    events_out_.close();
+    events_in_.close();
+}
+
+void ExtensionHostProxy::hostFinished(int exit_code, QProcess::ExitStatus status) {
+    if (stopping_) {
+        return;
+    }
+    QString reason = kill_reason_;
+    kill_reason_.clear();
+    if (reason.isEmpty()) {
+        reason = status == QProcess::CrashExit ? QString("crashed")
+                                               : QString("exited with code %1").arg(exit_code);
+    }
+    ping_timer_.stop();
+    restart_timer_.stop();
+    restart_seq_ = 0;
+    releaseTransport();
+
+    const qint64 now_ms = lifetime_.elapsed();
+    crash_times_ms_.append(now_ms);
+    while (!crash_times_ms_.isEmpty() && now_ms - crash_times_ms_.first() > kRestartWindowMs) {
+        crash_times_ms_.removeFirst();
+    }
+    const bool restarting = crash_times_ms_.size() <= kMaxRestarts;
+    qWarning() << "Extension host for" << id() << reason
+               << (restarting ? "- restarting" : "- giving up");
+    emit hostCrashed(id(), reason, restarting);
+
+    if (restarting) {
+        const int backoff_ms = kRestartBackoffMs << (crash_times_ms_.size() - 1);
+        QTimer::singleShot(backoff_ms, this, &ExtensionHostProxy::restartHost);
+    } else {
+        running_ = false;
+    }
+}
+
+void ExtensionHostProxy::restartHost() {
+    if (stopping_) {
+        return;
+    }
+    ++stats_.restarts;
+    // Nothing here blocks: the host connects, then answers Initialize, from the event loop
+    restart_timer_.start(kRestartTimeoutMs);
+    if (!spawnHost()) {
+        failRestart();
+        return;
+    }
+    connect(server_.get(), &QLocalServer::newConnection, this, [this]() {
+        if (!server_ || !server_->hasPendingConnections()) {
+            return;
+        }
+        attachHost();
+        restart_seq_ = ++seq_;
+        channel_->send(Message::Initialize, restart_seq_);
+    });
+}
+
+void ExtensionHostProxy::finishRestart(bool ok) {
+    restart_timer_.stop();
+    restart_seq_ = 0;
+    if (!ok) {
+        failRestart();
+        return;
+    }
+    events_out_.unlink();
+    events_in_.unlink();
+    since_pong_.start();
+    ping_timer_.start();
+    if (running_) {
+        start();
+    }
+    qInfo() << "Extension host for" << id() << "restarted as process" << hostPid();
+}
+
+void ExtensionHostProxy::failRestart() {
+    restart_timer_.stop();
+    restart_seq_ = 0;
+    // A failed restart ends in hostFinished() again, which counts it as a crash
+    kill_reason_ = "failed to restart";
+    if (process_.state() != QProcess::NotRunning) {
+        process_.kill();
+    } else {
+        hostFinished(-1, QProcess::NormalExit);
+    }
+}
+
+void ExtensionHostProxy::watchdog() {
+    if (since_pong_.elapsed() > kUnresponsiveMs) {
+        kill_reason_ = "stopped responding";
+        process_.kill();
+        return;
+    }
+    if (channel_) {
+        channel_->send(Message::Ping, ++seq_);
+    }
+}
+
+void ExtensionHostProxy::handleMessage(Message type, const QByteArray& body) {
+    QDataStream in(body);
+    in.setVersion(kStreamVersion);
+
+    switch (type) {
+        case Message::Reply: {
+            quint32 seq = 0;
+            bool ok = false;
+            in >> seq >> ok;
+            if (seq != 0 && seq == restart_seq_) {
+                finishRestart(ok);
+            } else if (seq == awaited_seq_) {
+                reply_ok_ = ok;
+                awaited_seq_ = 0;
+            }
+            break;
+        }
+        case Message::Pong: {
+            quint32 seq = 0;
+            in >> seq >> stats_.events_to_host >> stats_.to_host_mean_ns >>
+                stats_.to_host_max_ns;
+            since_pong_.restart();
+            if (seq == awaited_seq_) {
+                reply_ok_ = true;
+                awaited_seq_ = 0;
+            }
+            break;
+        }
+        case Message::Subscribe: {
+            qint32 host_id = 0;
+            QString pattern;
+            in >> host_id >> pattern;
+            subscribeForHost(host_id, pattern);
+            break;
+        }
+        case Message::Unsubscribe: {
+            qint32 host_id = 0;
+            in >> host_id;
+            auto events = getCapability<core::capabilities::EventCapability>();
+            if (events && subscriptions_.contains(host_id)) {
+                events->unsubscribe(subscriptions_.take(host_id));
+            }
+            break;
+        }
+        case Message::RegisterComponent: {
+            QString slot;
+            QString qml_path;
+            QVariantMap metadata;
+            in >> slot >> qml_path >> metadata;
+            registerComponentForHost(slot, qml_path, metadata);
+            break;
+        }
+        case Message::UnregisterComponent: {
+            QString component_id;
+            in >> component_id;
+            if (auto ui = getCapability<core::capabilities::UICapability>()) {
+                ui->unregisterComponent(component_id);
+            }
+            break;
+        }
+        case Message::Report: {
+            QVariantList audit;
+            core::capabilities::ResourceCounters counters;
+            in >> audit >> counters.wall_ns >> counters.cpu_ns >> counters.calls >>
+                counters.net_bytes_in >> counters.net_bytes_out >> counters.fs_bytes_read >>
+                counters.fs_bytes_written;
+            if (in.status() == QDataStream::Ok) {
+                recordReport(audit, counters);
+            }
+            break;
+        }
+        case Message::EventsPending:
+            drainEvents();
+            break;
+        default:
+            qWarning() << "Extension host for" << id() << "sent unexpected message"
+                       << int(type);
+            break;
+    }
+}
+
+void ExtensionHostProxy::subscribeForHost(qint32 host_id, const QString& pattern) {
+    auto events = getCapability<core::capabilities::EventCapability>();
+    if (!events) {
+        qWarning() << "Extension" << id() << "subscribed without the event capability";
+        return;
+    }
+    // Permissions are checked here, against this extension's grant
+    const int subscription_id = events->subscribe(
+        pattern, [this, host_id](const QVariantMap& data) { forwardEvent(host_id, data); });
+    if (subscription_id < 0) {
+        qWarning() << "Extension" << id() << "may not subscribe to" << pattern;
+        return;
+    }
+    subscriptions_.insert(host_id, subscription_id);
+}
+
+void ExtensionHostProxy::registerComponentForHost(const QString& slot, const QString& qml_path,
+                                                  const QVariantMap& metadata) {
+    auto ui = getCapability<core::capabilities::UICapability>();
+    if (!ui) {
+        qWarning() << "Extension" << id() << "registered a view without the ui capability";
+        return;
+    }
+    const QString path = viewPath(qml_path);
+    if (slot == "main") {
+        ui->registerMainView(path, metadata);
+    } else if (slot == "widget") {
+        ui->registerWidget(path, metadata);
+    } else {
+        qWarning() << "Extension" << id() << "registered a view in unknown slot" << slot;
+    }
+}
+
+void ExtensionHostProxy::forwardEvent(qint32 host_id, const QVariantMap& data) {
+    QMutexLocker lock(&writer_mutex_);
+    if (events_writer_) {
+        events_writer_->write(pack(host_id, data, monotonicNs()));
+    }
+}
+
+void ExtensionHostProxy::drainEvents() {
+    auto events = getCapability<core::capabilities::EventCapability>();
+    do {
+        QByteArray record;
+        while (events_in_.pop(&record)) {
+            QDataStream in(record);
+            in.setVersion(kStreamVersion);
+            QString event_name;
+            QVariantMap data;
+            qint64 sent_ns = 0;
+            in >> event_name >> data >> sent_ns;
+
+            const qint64 latency_ns = monotonicNs() - sent_ns;
+            ++stats_.events_from_host;
+            from_host_total_ns_ += latency_ns;
+            stats_.from_host_max_ns = qMax(stats_.from_host_max_ns, latency_ns);
+
+            // Permissions and rate limits apply as if the extension were in-process
+            if (events) {
+                events->emitEvent(event_name, data);
+            }
+        }
+    } while (!events_in_.sleep());
+
+    if (events_in_.isDead()) {
+        // The host wrote garbage into shared memory; a fresh one gets fresh rings
+        kill_reason_ = "corrupted its event ring";
+        process_.kill();
+    }
+}
+
+void ExtensionHostProxy::recordReport(const QVariantList& audit,
+                                      const core::capabilities::ResourceCounters& counters) {
+    if (!capability_manager_) {
+        return;
+    }
+    // Logged on arrival, so within a ping interval of when the host recorded them
+    for (const QVariant& record : audit) {
+        const QVariantList fields = record.toList();
+        if (fields.size() == 3) {
+            capability_manager_->logCapabilityUsage(id(), fields.at(0).toString(),
+                                                    fields.at(1).toString(),
+                                                    fields.at(2).toString());
+        }
+    }
+
+    core::capabilities::ResourceCounters added;
+    added.wall_ns = increase(counters.wall_ns, host_counters_.wall_ns);
+    added.cpu_ns = increase(counters.cpu_ns, host_counters_.cpu_ns);
+    added.calls = increase(counters.calls, host_counters_.calls);
+    added.net_bytes_in = increase(counters.net_bytes_in, host_counters_.net_bytes_in);
+    added.net_bytes_out = increase(counters.net_bytes_out, host_counters_.net_bytes_out);
+    added.fs_bytes_read = increase(counters.fs_bytes_read, host_counters_.fs_bytes_read);
+    added.fs_bytes_written =
+        increase(counters.fs_bytes_written, host_counters_.fs_bytes_written);
+    capability_manager_->resourceUsage(id())->addCounters(added);
+    host_counters_ = counters;
+}
+
+QString ExtensionHostProxy::viewPath(const QString& qml_path) const {
+    if (!qml_path.startsWith("qrc:/") && !qml_path.startsWith(":/")) {
+        return qml_path;
+    }
+    // qrc:/<prefix>/<file> is looked up as <extension path>/<file>
+    const QString resource = qml_path.mid(qml_path.indexOf(":/") + 2);
+    const QString file = QDir(extension_path_).filePath(resource.section('/', 1));
+    if (QFile::exists(file)) {
+        return QUrl::fromLocalFile(file).toString();
+    }
+    qWarning() << "View" << qml_path << "of hosted extension" << id()
+               << "is compiled into its plugin; ship it as" << file;
+    return qml_path;
+}
+
+QStringList ExtensionHostProxy::grantedPermissions() const {
+    QStringList granted;
+    for (const QString& permission : manifest_.requirements.required_permissions) {
+        if (hasCapability(permission.section('.', 0, 0))) {
+            granted << permission;
+        }
+    }
+    return granted;
+}
+
+QStringList ExtensionHostProxy::effectivePermissions() const {
+    if (!capability_manager_) {
+        return manifest_.requirements.required_permissions;
+    }
+    return capability_manager_->effectivePermissions(id());
+}
+
+QVariantMap ExtensionHostProxy::defaultRateLimits() const {
+    QVariantMap limits;
+    if (capability_manager_) {
+        for (const char* type : kHostRateLimitedTypes) {
+            limits.insert(type, capability_manager_->defaultRateLimit(type).toMap());
+        }
+    }
+    return limits;
+}
+
+}  // namespace host
+}  // namespace extensions
+}  // namespace opencardev::crankshaft
@@ -0,0 +1,191 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QLocalServer>
+#include <QMutex>
+#include <QObject>
+#include <QProcess>
+#include <QTimer>
+#include <memory>
+#include "../../core/capabilities/ResourceAccounting.hpp"
+#include "../extension.hpp"
+#include "../extension_manifest.hpp"
+#include "host_channel.hpp"
+#include "ring_writer.hpp"
+#include "shared_ring.hpp"
+
+namespace opencardev::crankshaft {
+namespace core {
+class CapabilityManager;
+}
+
+namespace extensions {
+namespace host {
+
+/**
+ * Stand-in for an extension that runs in a crankshaft-extension-host process.
+ *
+ * ExtensionManager grants capabilities to the proxy as to any extension. Events and
+ * views are served through those grants: subscriptions and emits cross the process
+ * boundary over two shared-memory rings, views are registered on the host's behalf.
+ * Other capabilities are created inside the host from the permissions granted here,
+ * under this extension's effective permissions and the system rate limits. Changes to
+ * either, and revocations, are passed on to the host; its audit records and resource
+ * counters come back into the core's with every ping.
+ *
+ * A host that crashes, exits, stops answering pings or corrupts its event ring is
+ * restarted with backoff, at most kMaxRestarts times a minute; its extension is
+ * initialised and, if it was running, started again. Restarts never block the GUI
+ * thread.
+ */
+class ExtensionHostProxy : public QObject, public Extension {
+    Q_OBJECT
+
+  public:
+    static constexpr int kMaxRestarts = 3;
+
+    struct TransportStats {
+        quint64 events_to_host = 0;    // Delivered, as reported by the host
+        quint64 events_from_host = 0;
+        quint64 events_dropped = 0;    // Rings full for too long
+        qint64 to_host_mean_ns = 0;    // Ring latency, as reported by the host
+        qint64 to_host_max_ns = 0;
+        qint64 from_host_mean_ns = 0;
+        qint64 from_host_max_ns = 0;
+        int restarts = 0;
+    };
+
+    /**
+     * @param extension_path Directory holding the manifest
+     * @param library Plugin library the host loads
+     * @param capability_manager Source of the extension's policy, and where the host's
+     *        audit records and usage are recorded; may be null
+     */
+    ExtensionHostProxy(const ExtensionManifest& manifest, const QString& extension_path,
+                       const QString& library, core::CapabilityManager* capability_manager,
+                       QObject* parent = nullptr);
+    ~ExtensionHostProxy() override;
+
+    // Spawns the host and waits, bounded, for the extension's initialize()
+    bool initialize() override;
+    void start() override;
+    void stop() override;
+    void cleanup() override;
+
+    QString id() const override { return manifest_.id; }
+    QString name() const override { return manifest_.name; }
+    QString version() const override { return manifest_.version; }
+    ExtensionType type() const override;
+
+    // $CRANKSHAFT_EXTENSION_HOST_BINARY, else crankshaft-extension-host beside the app
+    static QString hostBinary();
+
+    // Round trip to the host; refreshes the host-side transport stats
+    bool ping(int timeout_ms);
+    qint64 hostPid() const;
+    TransportStats transportStats() const;
+
+    // Send the current effective permissions and system rate limits to the host
+    void reconfigure();
+    // Revoke a capability (empty for all) inside the host too; callable from any thread
+    void revokeInHost(const QString& capability_type);
+
+  signals:
+    // The host went away unexpectedly; restarting is false once it is given up on
+    void hostCrashed(const QString& extension_id, const QString& reason, bool restarting);
+
+  private:
+    // Spawn the host and wait, bounded, for it to connect
+    bool launchHost();
+    // Listen, create the rings and start the process, without waiting for it
+    bool spawnHost();
+    // Take the host's connection and send it its configuration
+    void attachHost();
+    // Wait for the Reply (or Pong) to a message carrying a fresh sequence number
+    bool request(Message type, int timeout_ms);
+    // Stop the host, politely first if graceful, and release its transport
+    void shutDownHost(bool graceful);
+    void releaseTransport();
+    void hostFinished(int exit_code, QProcess::ExitStatus status);
+    // Spawn a new host and initialise it from the event loop, bounded by restart_timer_
+    void restartHost();
+    void finishRestart(bool ok);
+    void failRestart();
+    void watchdog();
+
+    void handleMessage(Message type, const QByteArray& body);
+    void subscribeForHost(qint32 host_id, const QString& pattern);
+    void registerComponentForHost(const QString& slot, const QString& qml_path,
+                                  const QVariantMap& metadata);
+    // Called on the publishing thread
+    void forwardEvent(qint32 host_id, const QVariantMap& data);
+    void drainEvents();
+    // Record the host's audit trail and resource use as this extension's
+    void recordReport(const QVariantList& audit,
+                      const core::capabilities::ResourceCounters& counters);
+    // qrc views live in the host; serve the copy shipped in the extension directory
+    QString viewPath(const QString& qml_path) const;
+    // Manifest permissions whose capability was granted to this proxy
+    QStringList grantedPermissions() const;
+    // Compiled permissions, with the system's overrides, and system rate limits by type
+    QStringList effectivePermissions() const;
+    QVariantMap defaultRateLimits() const;
+
+    ExtensionManifest manifest_;
+    QString extension_path_;
+    QString library_;
+    core::CapabilityManager* capability_manager_;
+
+    QProcess process_;
+    std::unique_ptr<QLocalServer> server_;
+    std::unique_ptr<HostChannel> channel_;
+    SharedRing events_out_;  // core -> host
+    SharedRing events_in_;   // host -> core
+    QMutex writer_mutex_;    // Guards events_writer_ against releaseTransport()
+    std::unique_ptr<RingWriter> events_writer_;
+    QHash<qint32, int> subscriptions_;  // Host subscription ID -> our subscription ID
+
+    quint32 seq_;
+    quint32 awaited_seq_;
+    quint32 restart_seq_;  // Initialize sent by restartHost(); 0 when none is pending
+    bool reply_ok_;
+    int generation_;
+    bool running_;
+    bool stopping_;
+    QString kill_reason_;
+    QTimer ping_timer_;
+    QTimer restart_timer_;
+    QElapsedTimer since_pong_;
+    QElapsedTimer lifetime_;
+    QList<qint64> crash_times_ms_;
+
+    TransportStats stats_;
+    qint64 from_host_total_ns_;
+    // Cumulative counters of the current host process, as last reported
+    core::capabilities::ResourceCounters host_counters_;
+};
+
+}  // namespace host
+}  // namespace extensions
+}  // namespace opencardev::crankshaft
@@ -0,0 +1,77 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "host_channel.hpp"
+#include <QDebug>
+#include <QtEndian>
+
+namespace opencardev::crankshaft {
+namespace extensions {
+namespace host {
+
+HostChannel::HostChannel(QLocalSocket* socket, QObject* parent)
+    : QObject(parent), socket_(socket) {
+    socket_->setParent(this);
+    connect(socket_, &QLocalSocket::readyRead, this, &HostChannel::readFrames);
+    connect(socket_, &QLocalSocket::disconnected, this, &HostChannel::disconnected);
+}
+
+void HostChannel::sendFrame(Message type, const QByteArray& body) {
+    if (!isConnected()) {
+        return;
+    }
+    char header[5];
+    qToBigEndian<quint32>(quint32(body.size() + 1), header);
+    header[4] = char(type);
+    socket_->write(header, sizeof(header));
+    socket_->write(body);
+    // Control messages are rare and latency-sensitive; do not wait for the event loop
+    socket_->flush();
+}
+
+bool HostChannel::waitForMessages(int timeout_ms) {
+    return isConnected() && socket_->waitForReadyRead(timeout_ms);
+}
+
+bool HostChannel::isConnected() const {
+    return socket_->state() == QLocalSocket::ConnectedState;
+}
+
+void HostChannel::readFrames() {
+    while (socket_->bytesAvailable() >= 4) {
+        char header[4];
+        socket_->peek(header, sizeof(header));
+        const quint32 size = qFromBigEndian<quint32>(header);
+        if (size == 0 || size > kMaxFrameBytes) {
+            qWarning() << "Extension host channel: invalid frame of" << size << "bytes";
+            socket_->abort();
+            return;
+        }
+        if (socket_->bytesAvailable() < qint64(4 + size)) {
+            return;
+        }
+        socket_->skip(4);
+        const QByteArray frame = socket_->read(size);
+        emit messageReceived(Message(quint8(frame.at(0))), frame.mid(1));
+    }
+}
+
+}  // namespace host
+}  // namespace extensions
+}  // namespace opencardev::crankshaft
@@ -0,0 +1,72 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QLocalSocket>
+#include <QObject>
+#include "host_protocol.hpp"
+
+namespace opencardev::crankshaft {
+namespace extensions {
+namespace host {
+
+/**
+ * Framed control channel over a connected QLocalSocket; used by both ends.
+ * Frames are delivered in order through messageReceived(), also from inside
+ * waitForMessages().
+ */
+class HostChannel : public QObject {
+    Q_OBJECT
+
+  public:
+    // Takes ownership of the socket
+    explicit HostChannel(QLocalSocket* socket, QObject* parent = nullptr);
+
+    template <typename... Args>
+    void send(Message type, const Args&... args) {
+        sendFrame(type, pack(args...));
+    }
+    void sendFrame(Message type, const QByteArray& body);
+
+    /**
+     * Block until new frames have been handled or timeout_ms passes. Only for the
+     * socket's thread; for request/reply steps that cannot return to the event loop.
+     *
+     * @return false on timeout or disconnect
+     */
+    bool waitForMessages(int timeout_ms);
+
+    bool isConnected() const;
+    QLocalSocket* socket() const { return socket_; }
+
+  signals:
+    void messageReceived(Message type, const QByteArray& body);
+    void disconnected();
+
+  private:
+    void readFrames();
+
+    QLocalSocket* socket_;
+};
+
+}  // namespace host
+}  // namespace extensions
+}  // namespace opencardev::crankshaft
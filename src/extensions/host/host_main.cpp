@@ -0,0 +1,46 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCoreApplication>
+#include <QDebug>
+#include "extension_host.hpp"
+
+using namespace opencardev::crankshaft::extensions::host;
+
+// crankshaft-extension-host <server name>: spawned by ExtensionManager, never by hand
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    // Same settings and data locations as the core
+    app.setOrganizationName("OpenCarDev");
+    app.setOrganizationDomain("getcrankshaft.com");
+    app.setApplicationName("Crankshaft Reborn");
+    app.setApplicationVersion("1.0.0");
+
+    const QStringList args = app.arguments();
+    if (args.size() != 2) {
+        qWarning() << "Usage:" << args.value(0) << "<server name>";
+        return 2;
+    }
+
+    ExtensionHost host;
+    if (!host.connectToCore(args.at(1))) {
+        return 1;
+    }
+    return app.exec();
+}
@@ -0,0 +1,88 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QtGlobal>
+#include <chrono>
+
+namespace opencardev::crankshaft {
+namespace extensions {
+namespace host {
+
+/**
+ * Wire protocol between ExtensionManager and an out-of-process extension host.
+ *
+ * Control messages travel over a Unix domain socket as length-prefixed frames: a quint32
+ * size, a quint8 Message, then QDataStream-encoded arguments. Events travel over two
+ * single-producer rings in shared memory (see SharedRing); EventsPending on the socket
+ * wakes a reader that has drained its ring and gone idle.
+ */
+enum class Message : quint8 {
+    // core -> host
+    Configure = 1,  // id, library path, capabilities to grant, permissions, rate limits,
+                    // default rate limits, ring names (in, out)
+    Initialize,     // seq; answered by Reply
+    Start,          // seq
+    Stop,           // seq
+    Cleanup,        // seq; the host exits after replying
+    Ping,           // seq; answered by Report, then Pong
+    Reconfigure,    // permissions, default rate limits; capabilities that lost one are revoked
+    Revoke,         // capability type, empty for all
+
+    // host -> core
+    Reply = 32,           // seq, ok
+    Pong,                 // seq, events received, mean latency ns, max latency ns
+    Subscribe,            // host subscription id, pattern
+    Unsubscribe,          // host subscription id
+    RegisterComponent,    // slot, qml path, metadata
+    UnregisterComponent,  // component id
+    Report,               // audit records since the last Report, then the resource counters
+                          // wall ns, cpu ns, calls, net in, net out, fs read, fs written
+
+    // either way
+    EventsPending = 64,
+};
+
+constexpr QDataStream::Version kStreamVersion = QDataStream::Qt_6_0;
+// Frames larger than this are treated as a protocol error
+constexpr quint32 kMaxFrameBytes = 16 * 1024 * 1024;
+
+// Monotonic clock shared by both processes, used to timestamp events in the rings
+inline qint64 monotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// QDataStream-encode a message's arguments
+template <typename... Args>
+QByteArray pack(const Args&... args) {
+    QByteArray body;
+    QDataStream out(&body, QIODevice::WriteOnly);
+    out.setVersion(kStreamVersion);
+    (out << ... << args);
+    return body;
+}
+
+}  // namespace host
+}  // namespace extensions
+}  // namespace opencardev::crankshaft
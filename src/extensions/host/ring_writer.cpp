@@ -0,0 +1,126 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ring_writer.hpp"
+#include <QDebug>
+#include <QMutexLocker>
+#include <QThread>
+
+namespace opencardev::crankshaft {
+namespace extensions {
+namespace host {
+
+namespace {
+
+// Records kept while the ring is full, before write() starts dropping
+constexpr int kMaxQueuedRecords = 4096;
+
+}  // namespace
+
+RingWriter::RingWriter(SharedRing* ring, HostChannel* channel, QObject* parent)
+    : QObject(parent), ring_(ring), channel_(channel), written_(0), dropped_(0) {
+    retry_timer_.setInterval(1);
+    connect(&retry_timer_, &QTimer::timeout, this, &RingWriter::flush);
+}
+
+bool RingWriter::write(const QByteArray& record) {
+    bool wake = false;
+    bool queued = false;
+    {
+        QMutexLocker lock(&mutex_);
+        if (quint32(record.size()) > ring_->maxRecordSize()) {
+            ++dropped_;
+            qWarning() << "Event of" << record.size() << "bytes is too large for ring"
+                       << ring_->name();
+            return false;
+        }
+        // Queued records go first, so a reader never sees events out of order
+        if (queued_.isEmpty() && ring_->push(record, &wake)) {
+            ++written_;
+        } else if (queued_.size() < kMaxQueuedRecords) {
+            queued_.enqueue(record);
+            queued = true;
+        } else {
+            ++dropped_;
+            if ((dropped_ & (dropped_ - 1)) == 0) {
+                qWarning() << "Ring" << ring_->name() << "is full;" << dropped_
+                           << "events dropped";
+            }
+            return false;
+        }
+    }
+
+    const bool on_thread = QThread::currentThread() == thread();
+    if (queued) {
+        if (on_thread) {
+            retry_timer_.start();
+        } else {
+            QMetaObject::invokeMethod(&retry_timer_, qOverload<>(&QTimer::start),
+                                      Qt::QueuedConnection);
+        }
+    }
+    if (wake) {
+        if (on_thread) {
+            wakeReader();
+        } else {
+            QMetaObject::invokeMethod(this, &RingWriter::wakeReader, Qt::QueuedConnection);
+        }
+    }
+    return true;
+}
+
+void RingWriter::flush() {
+    bool wake = false;
+    {
+        QMutexLocker lock(&mutex_);
+        while (!queued_.isEmpty()) {
+            bool woken = false;
+            if (!ring_->push(queued_.head(), &woken)) {
+                break;
+            }
+            wake = wake || woken;
+            queued_.dequeue();
+            ++written_;
+        }
+        if (queued_.isEmpty()) {
+            retry_timer_.stop();
+        }
+    }
+    if (wake) {
+        wakeReader();
+    }
+}
+
+quint64 RingWriter::written() const {
+    QMutexLocker lock(&mutex_);
+    return written_;
+}
+
+quint64 RingWriter::dropped() const {
+    QMutexLocker lock(&mutex_);
+    return dropped_;
+}
+
+void RingWriter::wakeReader() {
+    channel_->send(Message::EventsPending);
+}
+
+}  // namespace host
+}  // namespace extensions
+}  // namespace opencardev::crankshaft
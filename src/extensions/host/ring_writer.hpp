@@ -0,0 +1,70 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QMutex>
+#include <QObject>
+#include <QQueue>
+#include <QTimer>
+#include "host_channel.hpp"
+#include "shared_ring.hpp"
+
+namespace opencardev::crankshaft {
+namespace extensions {
+namespace host {
+
+/**
+ * Producer end of an event ring, usable from any thread. Records that do not fit wait
+ * in a bounded queue that is retried every millisecond, keeping their order; a reader
+ * that went to sleep is woken with EventsPending on the control channel.
+ *
+ * Lives on the channel's thread; neither the ring nor the channel is owned.
+ */
+class RingWriter : public QObject {
+    Q_OBJECT
+
+  public:
+    RingWriter(SharedRing* ring, HostChannel* channel, QObject* parent = nullptr);
+
+    // @return false if the record was dropped: too large, or the queue is full
+    bool write(const QByteArray& record);
+
+    // Move queued records into the ring
+    void flush();
+
+    quint64 written() const;
+    quint64 dropped() const;
+
+  private:
+    void wakeReader();
+
+    SharedRing* ring_;
+    HostChannel* channel_;
+    mutable QMutex mutex_;  // The ring has one producer at a time
+    QQueue<QByteArray> queued_;
+    QTimer retry_timer_;
+    quint64 written_;
+    quint64 dropped_;
+};
+
+}  // namespace host
+}  // namespace extensions
+}  // namespace opencardev::crankshaft
@@ -0,0 +1,265 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "shared_ring.hpp"
+#include <QDebug>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace opencardev::crankshaft {
+namespace extensions {
+namespace host {
+
+namespace {
+
+constexpr quint32 kRingMagic = 0x43535247;  // "CSRG"
+constexpr quint32 kWrapMarker = 0xffffffff;
+constexpr size_t kDataOffset = 256;
+constexpr quint32 kMinCapacity = 64;
+
+static_assert(std::atomic<quint64>::is_always_lock_free,
+              "the ring needs address-free 64-bit atomics");
+
+constexpr quint32 align4(quint32 size) {
+    return (size + 3) & ~quint32(3);
+}
+
+}  // namespace
+
+// Producer and consumer positions on separate cache lines. Positions only grow; the
+// offset into the data area is the position modulo the capacity.
+struct SharedRing::Header {
+    quint32 magic;
+    quint32 capacity;
+    alignas(64) std::atomic<quint64> head;  // Written by the producer
+    alignas(64) std::atomic<quint64> tail;  // Written by the consumer
+    alignas(64) std::atomic<quint32> reader_sleeping;
+};
+
+SharedRing::~SharedRing() {
+    close();
+}
+
+bool SharedRing::create(const QString& name, quint32 capacity) {
+    close();
+    quint32 rounded = kMinCapacity;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+
+    const QByteArray path = name.toLocal8Bit();
+    shm_unlink(path.constData());
+    const int fd = shm_open(path.constData(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        qWarning() << "Cannot create shared ring" << name << std::strerror(errno);
+        return false;
+    }
+    name_ = name;
+    owner_ = true;
+    const bool ok = map(fd, true, rounded);
+    ::close(fd);
+    if (!ok) {
+        unlink();
+        close();
+    }
+    return ok;
+}
+
+bool SharedRing::open(const QString& name) {
+    close();
+    const int fd = shm_open(name.toLocal8Bit().constData(), O_RDWR, 0);
+    if (fd < 0) {
+        qWarning() << "Cannot open shared ring" << name << std::strerror(errno);
+        return false;
+    }
+    name_ = name;
+    const bool ok = map(fd, false, 0);
+    ::close(fd);
+    if (!ok) {
+        close();
+    }
+    return ok;
+}
+
+bool SharedRing::map(int fd, bool initialise, quint32 capacity) {
+    static_assert(sizeof(Header) <= kDataOffset, "ring header overlaps its data");
+    if (initialise) {
+        if (ftruncate(fd, off_t(kDataOffset + capacity)) != 0) {
+            qWarning() << "Cannot size shared ring" << name_ << std::strerror(errno);
+            return false;
+        }
+    } else {
+        struct stat info;
+        if (fstat(fd, &info) != 0 || size_t(info.st_size) <= kDataOffset) {
+            qWarning() << "Shared ring" << name_ << "is not initialised";
+            return false;
+        }
+        capacity = quint32(size_t(info.st_size) - kDataOffset);
+    }
+
+    const size_t bytes = kDataOffset + capacity;
+    void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED) {
+        qWarning() << "Cannot map shared ring" << name_ << std::strerror(errno);
+        return false;
+    }
+    mapped_bytes_ = bytes;
+    header_ = static_cast<Header*>(memory);
+    data_ = static_cast<char*>(memory) + kDataOffset;
+
+    if (initialise) {
+        // The reader starts asleep, so the first record wakes it
+        new (header_) Header{kRingMagic, capacity, {0}, {0}, {1}};
+    } else if (header_->magic != kRingMagic || header_->capacity != capacity ||
+               capacity < kMinCapacity || (capacity & (capacity - 1)) != 0) {
+        qWarning() << "Shared ring" << name_ << "has an unexpected layout";
+        return false;
+    }
+    capacity_ = capacity;
+    dead_ = false;
+    return true;
+}
+
+void SharedRing::markDead(const char* reason) {
+    if (!dead_) {
+        qWarning() << "Shared ring" << name_ << "is corrupt:" << reason;
+    }
+    dead_ = true;
+}
+
+void SharedRing::unlink() {
+    if (owner_ && !name_.isEmpty()) {
+        shm_unlink(name_.toLocal8Bit().constData());
+        owner_ = false;
+    }
+}
+
+void SharedRing::close() {
+    unlink();
+    if (header_) {
+        munmap(header_, mapped_bytes_);
+    }
+    header_ = nullptr;
+    data_ = nullptr;
+    mapped_bytes_ = 0;
+    capacity_ = 0;
+    dead_ = false;
+    name_.clear();
+}
+
+quint32 SharedRing::maxRecordSize() const {
+    // A quarter of the ring, so one large record cannot starve the others
+    return header_ ? capacity_ / 4 - 4 : 0;
+}
+
+bool SharedRing::push(const QByteArray& record, bool* wake) {
+    *wake = false;
+    if (!header_ || dead_ || quint32(record.size()) > maxRecordSize()) {
+        return false;
+    }
+    const quint32 capacity = capacity_;
+    const quint32 need = align4(4 + quint32(record.size()));
+    const quint64 head = header_->head.load(std::memory_order_relaxed);
+    const quint64 tail = header_->tail.load(std::memory_order_acquire);
+    if (tail > head || head - tail > capacity) {
+        markDead("reader position out of range");
+        return false;
+    }
+    const quint64 offset = head & (capacity - 1);
+    // A record never wraps; the rest of the data area is skipped instead
+    const quint64 skip = capacity - offset < need ? capacity - offset : 0;
+    if (capacity - (head - tail) < skip + need) {
+        return false;
+    }
+
+    if (skip > 0) {
+        std::memcpy(data_ + offset, &kWrapMarker, 4);
+    }
+    const quint64 at = (head + skip) & (capacity - 1);
+    const quint32 size = quint32(record.size());
+    std::memcpy(data_ + at, &size, 4);
+    std::memcpy(data_ + at + 4, record.constData(), size);
+
+    // Publishing the record and checking for a sleeping reader pair with sleep()
+    header_->head.store(head + skip + need, std::memory_order_seq_cst);
+    *wake = header_->reader_sleeping.exchange(0, std::memory_order_seq_cst) != 0;
+    return true;
+}
+
+bool SharedRing::pop(QByteArray* record) {
+    if (!header_ || dead_) {
+        return false;
+    }
+    const quint32 capacity = capacity_;
+    quint64 tail = header_->tail.load(std::memory_order_relaxed);
+    const quint64 head = header_->head.load(std::memory_order_acquire);
+    if (tail == head) {
+        return false;
+    }
+    if (tail > head || head - tail > capacity || (head & 3) != 0) {
+        markDead("writer position out of range");
+        return false;
+    }
+
+    quint64 offset = tail & (capacity - 1);
+    quint32 size = 0;
+    std::memcpy(&size, data_ + offset, 4);
+    if (size == kWrapMarker) {
+        if (offset == 0) {
+            markDead("wrap marker at the start of the data");
+            return false;
+        }
+        tail += capacity - offset;
+        offset = 0;
+        std::memcpy(&size, data_, 4);
+    }
+    // A record never wraps and never extends past what the writer published
+    if (size > maxRecordSize() || offset + 4 + size > capacity ||
+        tail + align4(4 + size) > head) {
+        markDead("record size out of range");
+        return false;
+    }
+    *record = QByteArray(data_ + offset + 4, qsizetype(size));
+    header_->tail.store(tail + align4(4 + size), std::memory_order_release);
+    return true;
+}
+
+bool SharedRing::sleep() {
+    if (!header_ || dead_) {
+        return true;
+    }
+    header_->reader_sleeping.store(1, std::memory_order_seq_cst);
+    if (header_->head.load(std::memory_order_seq_cst) !=
+        header_->tail.load(std::memory_order_relaxed)) {
+        header_->reader_sleeping.store(0, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace host
+}  // namespace extensions
+}  // namespace opencardev::crankshaft
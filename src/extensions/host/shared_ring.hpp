@@ -0,0 +1,101 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+
+namespace opencardev::crankshaft {
+namespace extensions {
+namespace host {
+
+/**
+ * Single-producer, single-consumer ring of byte records in POSIX shared memory.
+ *
+ * One process create()s the ring and the other open()s it by name; each end then only
+ * pushes or only pops. Records are copied once into the ring and once out of it, with
+ * no system call on either path. A reader that has drained the ring calls sleep() before
+ * returning to its event loop; the writer's push() then reports that the reader must be
+ * woken, which the caller does over its control channel.
+ *
+ * The other process is not trusted to keep the shared header intact. The capacity is
+ * taken once when the ring is mapped, and positions or record sizes that cannot be
+ * right mark the ring dead; it then neither pushes nor pops, and its owner should end
+ * the peer.
+ */
+class SharedRing {
+  public:
+    SharedRing() = default;
+    ~SharedRing();
+    SharedRing(const SharedRing&) = delete;
+    SharedRing& operator=(const SharedRing&) = delete;
+
+    // Create a ring of at least capacity bytes (rounded up to a power of two)
+    bool create(const QString& name, quint32 capacity);
+    bool open(const QString& name);
+    // Remove the name; mappings stay valid until both ends close
+    void unlink();
+    void close();
+
+    bool isOpen() const { return header_ != nullptr; }
+    // The peer wrote something inconsistent; nothing more is read or written
+    bool isDead() const { return dead_; }
+    QString name() const { return name_; }
+
+    // Largest record push() accepts
+    quint32 maxRecordSize() const;
+
+    /**
+     * Append a record.
+     *
+     * @param wake Set when the reader went to sleep and must be woken
+     * @return false if the ring is full or the record too large; nothing was written
+     */
+    bool push(const QByteArray& record, bool* wake);
+
+    // Take the oldest record; false when empty or dead
+    bool pop(QByteArray* record);
+
+    /**
+     * Mark the reader as sleeping. Returns false, without sleeping, if a record arrived
+     * since the last pop(); the reader must then drain the ring again. A dead ring
+     * always sleeps.
+     */
+    bool sleep();
+
+  private:
+    struct Header;
+
+    bool map(int fd, bool initialise, quint32 capacity);
+    void markDead(const char* reason);
+
+    QString name_;
+    Header* header_ = nullptr;
+    char* data_ = nullptr;
+    size_t mapped_bytes_ = 0;
+    quint32 capacity_ = 0;  // Never re-read from the shared header
+    bool owner_ = false;
+    bool dead_ = false;
+};
+
+}  // namespace host
+}  // namespace extensions
+}  // namespace opencardev::crankshaft
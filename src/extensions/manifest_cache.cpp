@@ -0,0 +1,298 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "manifest_cache.hpp"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <algorithm>
+
+namespace opencardev::crankshaft {
+namespace extensions {
+
+namespace {
+
+constexpr quint32 kCacheMagic = 0x43534d43;  // "CSMC"
+// Bump whenever ExtensionManifest or the entry layout changes
+constexpr quint16 kFormatVersion = 2;
+constexpr QDataStream::Version kStreamVersion = QDataStream::Qt_6_0;
+
+qint64 mtimeMs(const QFileInfo& info) {
+    return info.lastModified().toMSecsSinceEpoch();
+}
+
+}  // namespace
+
+ManifestCache::ManifestCache(QObject* parent) : QObject(parent), dirty_(false) {
+    connect(&watcher_, &QFileSystemWatcher::directoryChanged, this,
+            [this](const QString& path) {
+                // A candidate directory changed: its search path may have a new extension
+                const QString search_path = watched_candidates_.contains(path)
+                                                ? QFileInfo(path).absolutePath()
+                                                : path;
+                qInfo() << "Extension search path changed:" << search_path;
+                invalidate(search_path);
+                emit searchPathChanged(search_path);
+            });
+}
+
+ManifestCache::~ManifestCache() = default;
+
+bool ManifestCache::open(const QString& file_path) {
+    file_path_ = file_path;
+
+    QFile file(file_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "No extension discovery cache at" << file_path;
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(kStreamVersion);
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != kCacheMagic || version != kFormatVersion) {
+        qInfo() << "Discarding outdated extension discovery cache:" << file_path;
+        dirty_ = true;
+        return false;
+    }
+
+    QHash<QString, DirectoryEntry> directories;
+    QHash<QString, ManifestEntry> manifests;
+    qint32 count = 0;
+    in >> count;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString path;
+        DirectoryEntry entry;
+        in >> path >> entry.mtime_ms >> entry.extension_dirs >> entry.candidate_dirs;
+        directories.insert(path, entry);
+    }
+    count = 0;
+    in >> count;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString path;
+        ManifestEntry entry;
+        in >> path >> entry.size >> entry.mtime_ms >> entry.sha1;
+        readManifest(in, &entry.manifest);
+        manifests.insert(path, entry);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "Discarding corrupt extension discovery cache:" << file_path;
+        dirty_ = true;
+        return false;
+    }
+
+    directories_ = directories;
+    manifests_ = manifests;
+    qInfo() << "Extension discovery cache loaded:" << directories_.size() << "search paths,"
+            << manifests_.size() << "manifests";
+    return true;
+}
+
+bool ManifestCache::save() {
+    if (file_path_.isEmpty() || !dirty_) {
+        return true;
+    }
+
+    QDir().mkpath(QFileInfo(file_path_).absolutePath());
+    QSaveFile file(file_path_);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write extension discovery cache:" << file_path_
+                   << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(kStreamVersion);
+    out << kCacheMagic << kFormatVersion;
+    out << qint32(directories_.size());
+    for (auto it = directories_.cbegin(); it != directories_.cend(); ++it) {
+        out << it.key() << it->mtime_ms << it->extension_dirs << it->candidate_dirs;
+    }
+    out << qint32(manifests_.size());
+    for (auto it = manifests_.cbegin(); it != manifests_.cend(); ++it) {
+        out << it.key() << it->size << it->mtime_ms << it->sha1;
+        writeManifest(out, it->manifest);
+    }
+
+    if (!file.commit()) {
+        qWarning() << "Cannot write extension discovery cache:" << file_path_
+                   << file.errorString();
+        return false;
+    }
+    dirty_ = false;
+    return true;
+}
+
+QStringList ManifestCache::discover(const QString& search_path) {
+    const QFileInfo info(search_path);
+    const QString key = info.absoluteFilePath();
+    if (!info.isDir()) {
+        qWarning() << "Extensions directory does not exist:" << search_path;
+        if (directories_.remove(key) > 0) {
+            dirty_ = true;
+        }
+        return {};
+    }
+    watch(key);
+
+    // Adding, removing or renaming an extension directory updates the search path's mtime
+    const qint64 mtime = mtimeMs(info);
+    auto it = directories_.constFind(key);
+    if (it != directories_.cend() && it->mtime_ms == mtime &&
+        std::none_of(it->candidate_dirs.cbegin(), it->candidate_dirs.cend(),
+                     [](const QString& path) { return QFile::exists(path + "/manifest.json"); })) {
+        watchCandidates(key, it->candidate_dirs);
+        ++stats_.directory_hits;
+        return it->extension_dirs;
+    }
+
+    ++stats_.directory_scans;
+    DirectoryEntry entry;
+    entry.mtime_ms = mtime;
+    const QDir dir(key);
+    for (const QString& subdir : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        const QString path = dir.absoluteFilePath(subdir);
+        if (QFile::exists(path + "/manifest.json")) {
+            entry.extension_dirs.append(path);
+        } else {
+            entry.candidate_dirs.append(path);
+        }
+    }
+    watchCandidates(key, entry.candidate_dirs);
+    directories_.insert(key, entry);
+    dirty_ = true;
+    return entry.extension_dirs;
+}
+
+ExtensionManifest ManifestCache::manifest(const QString& manifest_path) {
+    const QFileInfo info(manifest_path);
+    const QString key = info.absoluteFilePath();
+    auto it = manifests_.find(key);
+    if (!info.isFile()) {
+        qWarning() << "Failed to open manifest file:" << manifest_path;
+        if (it != manifests_.end()) {
+            manifests_.erase(it);
+            dirty_ = true;
+        }
+        return ExtensionManifest();
+    }
+
+    if (it != manifests_.end() && it->size == info.size() && it->mtime_ms == mtimeMs(info)) {
+        ++stats_.manifest_hits;
+        return it->manifest;
+    }
+
+    QFile file(manifest_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open manifest file:" << manifest_path;
+        return ExtensionManifest();
+    }
+    const QByteArray data = file.readAll();
+    const QByteArray sha1 = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+    dirty_ = true;
+
+    // Touched or rewritten without changes: keep the parsed manifest
+    if (it != manifests_.end() && it->sha1 == sha1) {
+        it->size = info.size();
+        it->mtime_ms = mtimeMs(info);
+        ++stats_.manifest_hits;
+        return it->manifest;
+    }
+
+    const QJsonDocument doc = QJsonDocument::fromJson(data);
+    if (!doc.isObject()) {
+        qWarning() << "Invalid JSON in manifest:" << manifest_path;
+        manifests_.remove(key);
+        return ExtensionManifest();
+    }
+
+    ++stats_.manifest_parses;
+    ManifestEntry entry;
+    entry.size = info.size();
+    entry.mtime_ms = mtimeMs(info);
+    entry.sha1 = sha1;
+    entry.manifest = ExtensionManifest::fromJson(doc.object().toVariantMap());
+    manifests_.insert(key, entry);
+    return entry.manifest;
+}
+
+void ManifestCache::invalidate(const QString& search_path) {
+    if (directories_.remove(QFileInfo(search_path).absoluteFilePath()) > 0) {
+        dirty_ = true;
+    }
+}
+
+void ManifestCache::watch(const QString& search_path) {
+    if (!watcher_.directories().contains(search_path)) {
+        watcher_.addPath(search_path);
+    }
+}
+
+void ManifestCache::watchCandidates(const QString& search_path, const QStringList& candidates) {
+    for (auto it = watched_candidates_.begin(); it != watched_candidates_.end();) {
+        if (QFileInfo(*it).absolutePath() == search_path && !candidates.contains(*it)) {
+            watcher_.removePath(*it);
+            it = watched_candidates_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (const QString& path : candidates) {
+        if (!watched_candidates_.contains(path) && watcher_.addPath(path)) {
+            watched_candidates_.insert(path);
+        }
+    }
+}
+
+void ManifestCache::writeManifest(QDataStream& out, const ExtensionManifest& manifest) {
+    out << manifest.id << manifest.name << manifest.version << manifest.description
+        << manifest.author << manifest.type << manifest.dependencies << manifest.platforms
+        << manifest.entry_point << manifest.config_schema;
+    out << manifest.requirements.min_core_version << manifest.requirements.required_permissions
+        << manifest.requirements.rate_limits;
+    out << manifest.activation.views << manifest.activation.events
+        << manifest.activation.capabilities << qint32(manifest.activation.prewarm_after_ms);
+    out << manifest.metadata;
+}
+
+void ManifestCache::readManifest(QDataStream& in, ExtensionManifest* manifest) {
+    in >> manifest->id >> manifest->name >> manifest->version >> manifest->description >>
+        manifest->author >> manifest->type >> manifest->dependencies >> manifest->platforms >>
+        manifest->entry_point >> manifest->config_schema;
+    in >> manifest->requirements.min_core_version >>
+        manifest->requirements.required_permissions >> manifest->requirements.rate_limits;
+    qint32 prewarm_after_ms = -1;
+    in >> manifest->activation.views >> manifest->activation.events >>
+        manifest->activation.capabilities >> prewarm_after_ms;
+    manifest->activation.prewarm_after_ms = prewarm_after_ms;
+    in >> manifest->metadata;
+}
+
+}  // namespace extensions
+}  // namespace opencardev::crankshaft
@@ -0,0 +1,121 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include "extension_manifest.hpp"
+
+namespace opencardev::crankshaft {
+namespace extensions {
+
+/**
+ * Persistent cache of extension discovery results and parsed manifests.
+ *
+ * Each search path is keyed by its directory mtime and remembers the extension
+ * directories found below it, so an unchanged path is not listed again. Subdirectories
+ * without a manifest are remembered too and checked again, since copying a manifest into
+ * an existing directory leaves the search path's mtime alone. Each manifest is
+ * keyed by its size and mtime, with a SHA-1 of its content as a fallback when only the
+ * timestamp moved; an unchanged manifest is served without reading or parsing the JSON.
+ *
+ * The cache is kept in a single binary file written with QDataStream. Search paths are
+ * watched through one QFileSystemWatcher (a single inotify instance on Linux), with the
+ * subdirectories still waiting for a manifest, so installing or removing an extension
+ * invalidates the path's listing while running.
+ */
+class ManifestCache : public QObject {
+    Q_OBJECT
+
+  public:
+    struct Stats {
+        int directory_hits = 0;   // Search paths served from the cache
+        int directory_scans = 0;  // Search paths listed on disk
+        int manifest_hits = 0;    // Manifests served from the cache
+        int manifest_parses = 0;  // Manifests read and parsed
+    };
+
+    explicit ManifestCache(QObject* parent = nullptr);
+    ~ManifestCache() override;
+
+    /**
+     * Load a cache file. A missing, corrupt or outdated file leaves the cache empty; it
+     * is rewritten by the next save().
+     *
+     * @return true if cached entries were loaded
+     */
+    bool open(const QString& file_path);
+
+    // Write the cache file if anything changed; no-op before open()
+    bool save();
+
+    // Extension directories (those holding a manifest.json) directly below search_path
+    QStringList discover(const QString& search_path);
+
+    // Parsed manifest, from the cache when unchanged on disk; invalid if unreadable
+    ExtensionManifest manifest(const QString& manifest_path);
+
+    // Drop the listing of a search path so the next discover() scans it
+    void invalidate(const QString& search_path);
+
+    Stats stats() const { return stats_; }
+
+  signals:
+    // An extension directory was added to, removed from or renamed in a search path
+    void searchPathChanged(const QString& search_path);
+
+  private:
+    struct DirectoryEntry {
+        qint64 mtime_ms = 0;
+        QStringList extension_dirs;
+        QStringList candidate_dirs;  // No manifest.json yet, e.g. an install being copied
+    };
+
+    struct ManifestEntry {
+        qint64 size = 0;
+        qint64 mtime_ms = 0;
+        QByteArray sha1;
+        ExtensionManifest manifest;
+    };
+
+    void watch(const QString& search_path);
+    // Watch a search path's candidate directories, and stop watching those no longer one
+    void watchCandidates(const QString& search_path, const QStringList& candidates);
+
+    static void writeManifest(QDataStream& out, const ExtensionManifest& manifest);
+    static void readManifest(QDataStream& in, ExtensionManifest* manifest);
+
+    QString file_path_;
+    QHash<QString, DirectoryEntry> directories_;  // Search path -> listing
+    QHash<QString, ManifestEntry> manifests_;     // manifest.json path -> parsed manifest
+    QFileSystemWatcher watcher_;
+    QSet<QString> watched_candidates_;
+    Stats stats_;
+    bool dirty_;
+};
+
+}  // namespace extensions
+}  // namespace opencardev::crankshaft
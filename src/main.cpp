@@ -24,10 +24,13 @@
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
 #include <QStandardPaths>
+#include <QTimer>
 #include <QUrl>
 #include "core/application/application.hpp"
+#include "core/diagnostics/Trace.hpp"
 #include "extensions/extension_manager.hpp"
 #include "ui/EventBridge.hpp"
+#include "ui/ExtensionDiagnosticsBridge.hpp"
 #include "ui/ExtensionRegistry.hpp"
 #include "ui/I18nManager.hpp"
 #include "ui/IconRegistry.hpp"
@@ -40,14 +43,24 @@
 #include "ui/UIRegistrarImpl.hpp"
 // Temporarily disabled due to GCC 14/Qt6 ABI incompatibility
 // #include "ui/BluetoothBridge.hpp"
-#include "../extensions/bluetooth/bluetooth_extension.hpp"
-#include "../extensions/dialer/dialer_extension.hpp"
-#include "../extensions/media_player/media_player_extension.hpp"
-#include "../extensions/navigation/navigation_extension.hpp"
-#include "../extensions/wireless/wireless_extension.hpp"
 
 int main(int argc, char* argv[]) {
+    using opencardev::crankshaft::core::diagnostics::Tracer;
+
+    // CRANKSHAFT_TRACE_FILE=<path> records startup spans and writes them once the event loop
+    // is running: Chrome trace JSON, or a Perfetto trace for a .pftrace file
+    const QString traceFile = qEnvironmentVariable("CRANKSHAFT_TRACE_FILE");
+    qint64 appStartNs = 0;
+    if (!traceFile.isEmpty()) {
+        Tracer::start();
+        Tracer::setThreadName(QStringLiteral("main"));
+        appStartNs = Tracer::nowNs();
+    }
+
     QApplication app(argc, argv);
+    if (Tracer::isEnabled()) {
+        Tracer::complete("startup", "QApplication", QString(), appStartNs, Tracer::nowNs());
+    }
     app.setOrganizationName("OpenCarDev");
     app.setOrganizationDomain("getcrankshaft.com");
     app.setApplicationName("Crankshaft Reborn");
@@ -55,10 +68,9 @@ int main(int argc, char* argv[]) {
 
     opencardev::crankshaft::core::Application application;
 
-    // Register built-in extensions BEFORE initialize()
+    // Locate the built-in extensions BEFORE initialize(); each is a plugin library
+    // (its manifest's entry_point) loaded when it is first started
     // Navigation extension
-    auto navigationExtension =
-        std::make_shared<opencardev::crankshaft::extensions::navigation::NavigationExtension>();
     QString navExtensionPath =
         QDir(QCoreApplication::applicationDirPath()).filePath("extensions/navigation");
     if (!QFile::exists(navExtensionPath + "/manifest.json")) {
@@ -71,8 +83,6 @@ int main(int argc, char* argv[]) {
     }
 
     // Bluetooth extension
-    auto bluetoothExtension =
-        std::make_shared<opencardev::crankshaft::extensions::bluetooth::BluetoothExtension>();
     QString btExtensionPath =
         QDir(QCoreApplication::applicationDirPath()).filePath("extensions/bluetooth");
     if (!QFile::exists(btExtensionPath + "/manifest.json")) {
@@ -83,8 +93,6 @@ int main(int argc, char* argv[]) {
     }
 
     // Media Player extension
-    auto mediaPlayerExtension =
-        std::make_shared<opencardev::crankshaft::extensions::media::MediaPlayerExtension>();
     QString mpExtensionPath =
         QDir(QCoreApplication::applicationDirPath()).filePath("extensions/media_player");
     if (!QFile::exists(mpExtensionPath + "/manifest.json")) {
@@ -95,8 +103,6 @@ int main(int argc, char* argv[]) {
     }
 
     // Dialer extension
-    auto dialerExtension =
-        std::make_shared<opencardev::crankshaft::extensions::dialer::DialerExtension>();
     QString dialerExtensionPath =
         QDir(QCoreApplication::applicationDirPath()).filePath("extensions/dialer");
     if (!QFile::exists(dialerExtensionPath + "/manifest.json")) {
@@ -107,8 +113,6 @@ int main(int argc, char* argv[]) {
     }
 
     // Wireless extension
-    auto wirelessExtension =
-        std::make_shared<opencardev::crankshaft::extensions::wireless::WirelessExtension>();
     QString wirelessExtensionPath =
         QDir(QCoreApplication::applicationDirPath()).filePath("extensions/wireless");
     if (!QFile::exists(wirelessExtensionPath + "/manifest.json")) {
@@ -126,23 +130,30 @@ int main(int argc, char* argv[]) {
     Q_INIT_RESOURCE(icons);
 
     // Register QML singletons and initialize managers
-    CrankshaftReborn::UI::ThemeManager::registerQmlType();
-    CrankshaftReborn::UI::ThemeManager::instance()->initialize();
-    // I18n manager for translations
-    opencardev::crankshaft::ui::I18nManager::registerQmlType();
-    // Icon registry singleton
-    opencardev::crankshaft::ui::IconRegistry::registerQmlType();
-    NavigationBridge::registerQmlType();
-    NavigationBridge::initialise(application.capabilityManager());
-    // QML Event bridge for simple publish from UI
-    opencardev::crankshaft::ui::EventBridge::registerQmlType();
-    opencardev::crankshaft::ui::EventBridge::initialise(application.eventBus());
-    // Config Manager bridge for QML Config UI
-    opencardev::crankshaft::ui::ConfigManagerBridge::registerQmlType();
-    opencardev::crankshaft::ui::ConfigManagerBridge::initialise(application.configManager());
-    // Temporarily disabled due to GCC 14/Qt6 ABI incompatibility
-    // BluetoothBridge::registerQmlType();
-    // BluetoothBridge::initialise(&application);
+    {
+        CRANKSHAFT_TRACE_SCOPE("startup", "register QML singletons");
+        CrankshaftReborn::UI::ThemeManager::registerQmlType();
+        CrankshaftReborn::UI::ThemeManager::instance()->initialize();
+        // I18n manager for translations
+        opencardev::crankshaft::ui::I18nManager::registerQmlType();
+        // Icon registry singleton
+        opencardev::crankshaft::ui::IconRegistry::registerQmlType();
+        NavigationBridge::registerQmlType();
+        NavigationBridge::initialise(application.capabilityManager());
+        // QML Event bridge for simple publish from UI
+        opencardev::crankshaft::ui::EventBridge::registerQmlType();
+        opencardev::crankshaft::ui::EventBridge::initialise(application.eventBus());
+        // Config Manager bridge for QML Config UI
+        opencardev::crankshaft::ui::ConfigManagerBridge::registerQmlType();
+        opencardev::crankshaft::ui::ConfigManagerBridge::initialise(application.configManager());
+        // Per-extension resource usage for the extension manager's diagnostics view
+        opencardev::crankshaft::ui::ExtensionDiagnosticsBridge::registerQmlType();
+        opencardev::crankshaft::ui::ExtensionDiagnosticsBridge::initialise(
+            application.eventBus(), application.capabilityManager());
+        // Temporarily disabled due to GCC 14/Qt6 ABI incompatibility
+        // BluetoothBridge::registerQmlType();
+        // BluetoothBridge::initialise(&application);
+    }
 
     // Create ExtensionRegistry BEFORE starting extensions so they can register views
     opencardev::crankshaft::ui::ExtensionRegistry extensionRegistry(application.extensionManager());
@@ -154,166 +165,21 @@ int main(int argc, char* argv[]) {
         &extensionRegistry,
         &opencardev::crankshaft::ui::ExtensionRegistry::unregisterExtensionComponents);
 
-    // Register core UI settings page
-    {
-        using namespace opencardev::crankshaft::core::config;
-        ConfigPage page;
-        page.domain = "system";
-        page.extension = "ui";
-        page.title = QObject::tr("User Interface");
-        page.description = QObject::tr("Global UI preferences including keyboard shortcuts");
-        page.icon = "Settings";  // icon name or path; translation not required
-        page.complexity = ConfigComplexity::Basic;
-
-        // General section
-        ConfigSection general;
-        general.key = "general";
-        general.title = QObject::tr("General");
-        general.description = QObject::tr("General user interface preferences");
-        general.complexity = ConfigComplexity::Basic;
-
-        ConfigItem language;
-        language.key = "language";
-        language.label = QObject::tr("Language");
-        language.description = QObject::tr("Application language (requires translation files)");
-        language.type = ConfigItemType::Selection;
-        language.properties["options"] = QStringList{"en_GB"};
-        language.defaultValue = QStringLiteral("en_GB");
-        language.complexity = ConfigComplexity::Basic;
-        general.items.append(language);
-
-        // First-run flag: when true the application will open directly into
-        // the General settings page to encourage initial configuration.
-        // Automatically set to false after first run logic executes.
-        ConfigItem enableFirstRun;
-        enableFirstRun.key = "enablefirstrun";
-        enableFirstRun.label = "Enable first run setup";  // internal, not translated
-        enableFirstRun.description =
-            "Show General settings on first application launch";  // internal
-        enableFirstRun.type = ConfigItemType::Boolean;
-        enableFirstRun.defaultValue = true;
-        enableFirstRun.complexity = ConfigComplexity::Basic;
-        general.items.append(enableFirstRun);
-
-        ConfigSection shortcuts;
-        shortcuts.key = "shortcuts";
-        shortcuts.title = "Keyboard Shortcuts";
-        shortcuts.description = "Configure global shortcut keys";
-        shortcuts.complexity = ConfigComplexity::Basic;
-
-        ConfigItem openSettings;
-        openSettings.key = "open_settings";
-        openSettings.label = "Open settings";
-        openSettings.description = "Shortcut key to open the Settings page";
-        openSettings.type = ConfigItemType::String;
-        openSettings.defaultValue = QStringLiteral("S");
-        openSettings.complexity = ConfigComplexity::Basic;
-        shortcuts.items.append(openSettings);
-
-        ConfigItem toggleTheme;
-        toggleTheme.key = "toggle_theme";
-        toggleTheme.label = "Toggle theme";
-        toggleTheme.description = "Shortcut key to toggle light/dark theme";
-        toggleTheme.type = ConfigItemType::String;
-        toggleTheme.defaultValue = QStringLiteral("T");
-        toggleTheme.complexity = ConfigComplexity::Basic;
-        shortcuts.items.append(toggleTheme);
-
-        ConfigItem goHome;
-        goHome.key = "go_home";
-        goHome.label = "Go to Home";
-        goHome.description = "Shortcut key to switch to the Home tab";
-        goHome.type = ConfigItemType::String;
-        goHome.defaultValue = QStringLiteral("H");
-        goHome.complexity = ConfigComplexity::Basic;
-        shortcuts.items.append(goHome);
-
-        ConfigItem cycleLeft;
-        cycleLeft.key = "cycle_left";
-        cycleLeft.label = "Cycle tabs left";
-        cycleLeft.description = "Shortcut key to cycle to the previous tab";
-        cycleLeft.type = ConfigItemType::String;
-        cycleLeft.defaultValue = QStringLiteral("A");
-        cycleLeft.complexity = ConfigComplexity::Basic;
-        shortcuts.items.append(cycleLeft);
-
-        ConfigItem cycleRight;
-        cycleRight.key = "cycle_right";
-        cycleRight.label = "Cycle tabs right";
-        cycleRight.description = "Shortcut key to cycle to the next tab";
-        cycleRight.type = ConfigItemType::String;
-        cycleRight.defaultValue = QStringLiteral("D");
-        cycleRight.complexity = ConfigComplexity::Basic;
-        shortcuts.items.append(cycleRight);
-
-        ConfigItem showHelp;
-        showHelp.key = "show_help";
-        showHelp.label = "Show shortcuts help";
-        showHelp.description = "Shortcut key to toggle the on-screen shortcuts help overlay";
-        showHelp.type = ConfigItemType::String;
-        showHelp.defaultValue = QStringLiteral("?");
-        showHelp.complexity = ConfigComplexity::Basic;
-        shortcuts.items.append(showHelp);
-
-        page.sections.append(general);
-        page.sections.append(shortcuts);
-        application.configManager()->registerConfigPage(page);
-    }
-
-    // Register system.extensions management page (enable/disable + hot reload)
-    {
-        using namespace opencardev::crankshaft::core::config;
-        ConfigPage page;
-        page.domain = "system";
-        page.extension = "extensions";
-        page.title = "Extensions";
-        page.description = "Enable or disable built-in extensions";
-        page.icon = "Extensions";
-        page.complexity = ConfigComplexity::Basic;
-
-        ConfigSection manage;
-        manage.key = "manage";
-        manage.title = "Manage Extensions";
-        manage.description = "Toggle extensions on or off";
-        manage.complexity = ConfigComplexity::Basic;
-
-        auto makeToggle = [](const QString& key, const QString& label, const QString& desc) {
-            ConfigItem item;
-            item.key = key;
-            item.label = label;
-            item.description = desc;
-            item.type = ConfigItemType::Boolean;
-            item.defaultValue = true;
-            item.complexity = ConfigComplexity::Basic;
-            return item;
-        };
-
-        manage.items.append(
-            makeToggle("navigation", "Enable Navigation", "Show the Navigation tab and services"));
-        manage.items.append(
-            makeToggle("bluetooth", "Enable Bluetooth", "Enable Bluetooth integration"));
-        manage.items.append(
-            makeToggle("media_player", "Enable Media Player", "Enable media playback controls"));
-        manage.items.append(
-            makeToggle("dialer", "Enable Dialler", "Enable phone dialler integration"));
-        manage.items.append(
-            makeToggle("wireless", "Enable Wireless", "Enable wireless settings integration"));
-
-        page.sections.append(manage);
-        application.configManager()->registerConfigPage(page);
-    }
-
     // Inject UI registrar implementation into core (decouples core from UI)
     opencardev::crankshaft::ui::UIRegistrarImpl uiRegistrar;
     application.capabilityManager()->setUIRegistrar(&uiRegistrar);
 
-    // Now register the built-in extension (after ExtensionRegistry is created)
-    application.extensionManager()->registerBuiltInExtension(navigationExtension, navExtensionPath);
-    application.extensionManager()->registerBuiltInExtension(bluetoothExtension, btExtensionPath);
-    application.extensionManager()->registerBuiltInExtension(mediaPlayerExtension, mpExtensionPath);
-    application.extensionManager()->registerBuiltInExtension(dialerExtension, dialerExtensionPath);
-    application.extensionManager()->registerBuiltInExtension(wirelessExtension,
-                                                             wirelessExtensionPath);
+    // Now register the built-in extensions (after ExtensionRegistry is created). Independent
+    // extensions initialise concurrently; see the startup timeline in the log.
+    application.extensionManager()->registerBuiltInExtensions({
+        {nullptr, navExtensionPath},
+        {nullptr, btExtensionPath},
+        {nullptr, mpExtensionPath},
+        {nullptr, dialerExtensionPath},
+        {nullptr, wirelessExtensionPath},
+    });
+    // Then any other discovered extensions; built-ins take precedence over the same id
+    application.extensionManager()->loadAll();
 
     // Set up QML engine and import paths
     QQmlApplicationEngine engine;
@@ -387,6 +253,7 @@ int main(int argc, char* argv[]) {
     }
 
     if (!mainUrl.isEmpty()) {
+        CRANKSHAFT_TRACE_SCOPE_DETAIL("ui", "QQmlApplicationEngine::load", mainUrl.toString());
         qDebug() << "Loading QML from:" << mainUrl;
         engine.load(mainUrl);
     } else {
@@ -402,5 +269,17 @@ int main(int argc, char* argv[]) {
 
     qDebug() << "QML loaded successfully, entering event loop";
 
+    if (!traceFile.isEmpty()) {
+        QTimer::singleShot(0, &app,
+                           []() { CRANKSHAFT_TRACE_INSTANT("startup", "event loop running"); });
+        // CRANKSHAFT_TRACE_DURATION_MS keeps recording past startup, e.g. to see the first
+        // frames or deferred extension activation
+        const int traceDurationMs = qEnvironmentVariableIntValue("CRANKSHAFT_TRACE_DURATION_MS");
+        QTimer::singleShot(qMax(0, traceDurationMs), &app, [traceFile]() {
+            Tracer::write(traceFile);
+            Tracer::stop();
+        });
+    }
+
     return app.exec();
 }
@@ -19,8 +19,10 @@
 
 #include "ConfigManagerBridge.hpp"
 #include <QDebug>
+#include <QQmlEngine>
 #include "../core/config/ConfigManager.hpp"
 #include "../core/config/ConfigTypes.hpp"
+#include "ConfigModels.hpp"
 
 namespace opencardev {
 namespace crankshaft {
@@ -29,7 +31,13 @@ namespace ui {
 ConfigManagerBridge* ConfigManagerBridge::instance_ = nullptr;
 
 ConfigManagerBridge::ConfigManagerBridge(QObject* parent)
-    : QObject(parent), config_manager_(nullptr) {}
+    : QObject(parent),
+      config_manager_(nullptr),
+      page_model_(new ConfigPageModel(this)),
+      filtered_pages_(new ConfigComplexityFilterModel(this)) {
+    filtered_pages_->setSourceModel(page_model_);
+    QQmlEngine::setObjectOwnership(filtered_pages_, QQmlEngine::CppOwnership);
+}
 
 ConfigManagerBridge* ConfigManagerBridge::instance() {
     if (instance_ == nullptr) {
@@ -50,6 +58,7 @@ void ConfigManagerBridge::initialise(core::config::ConfigManager* manager) {
     }
     instance_->config_manager_ = manager;
     instance_->connectSignals();
+    instance_->populateModels();
     qDebug() << "ConfigManagerBridge initialised";
 }
 
@@ -66,6 +75,65 @@ void ConfigManagerBridge::connectSignals() {
             [this](core::config::ConfigComplexity level) {
                 emit complexityLevelChanged(core::config::configComplexityToString(level));
             });
+
+    // Keep the models in step with the manager instead of rebuilding them from scratch
+    connect(config_manager_, &core::config::ConfigManager::configValueChanged, this,
+            [this](const QString& domain, const QString& extension, const QString& section,
+                   const QString& key, const QVariant& value) {
+                ConfigSectionModel* model = section_models_.value(domain + "." + extension);
+                if (model != nullptr) {
+                    model->updateValue(section, key, value);
+                }
+            });
+    connect(config_manager_, &core::config::ConfigManager::configPageRegistered, this,
+            [this](const QString& domain, const QString& extension) {
+                const auto page = config_manager_->getConfigPage(domain, extension);
+                page_model_->addOrUpdatePage(page);
+                ConfigSectionModel* model = section_models_.value(page.getFullKey());
+                if (model != nullptr) {
+                    model->setPage(page);
+                }
+            });
+    connect(config_manager_, &core::config::ConfigManager::configPageUnregistered, this,
+            [this](const QString& domain, const QString& extension) {
+                page_model_->removePage(domain, extension);
+                ConfigSectionModel* model = section_models_.value(domain + "." + extension);
+                if (model != nullptr) {
+                    // QML may still hold the model, so empty it rather than delete it
+                    model->setPage(core::config::ConfigPage());
+                }
+            });
+    connect(config_manager_, &core::config::ConfigManager::complexityLevelChanged, this,
+            [this](core::config::ConfigComplexity level) {
+                filtered_pages_->setComplexityLevel(static_cast<int>(level));
+                for (ConfigSectionModel* model : std::as_const(section_models_)) {
+                    model->setComplexityLevel(static_cast<int>(level));
+                }
+                for (ConfigComplexityFilterModel* filter : std::as_const(filtered_sections_)) {
+                    filter->setComplexityLevel(static_cast<int>(level));
+                }
+            });
+}
+
+void ConfigManagerBridge::populateModels() {
+    if (config_manager_ == nullptr) {
+        return;
+    }
+
+    const int level = static_cast<int>(config_manager_->getComplexityLevel());
+    filtered_pages_->setComplexityLevel(level);
+    for (const auto& page : config_manager_->getAllConfigPages()) {
+        page_model_->addOrUpdatePage(page);
+    }
+    for (ConfigComplexityFilterModel* filter : std::as_const(filtered_sections_)) {
+        filter->setComplexityLevel(level);
+    }
+    for (auto it = section_models_.cbegin(); it != section_models_.cend(); ++it) {
+        const int dot = it.key().indexOf('.');
+        it.value()->setComplexityLevel(level);
+        it.value()->setPage(
+            config_manager_->getConfigPage(it.key().left(dot), it.key().mid(dot + 1)));
+    }
 }
 
 QVariantList ConfigManagerBridge::getAllConfigPages() const {
@@ -107,6 +175,41 @@ QVariantMap ConfigManagerBridge::getConfigPage(const QString& domain,
     return page.toMap();
 }
 
+QObject* ConfigManagerBridge::pagesModel() const {
+    return filtered_pages_;
+}
+
+QObject* ConfigManagerBridge::sectionsModel(const QString& domain, const QString& extension) {
+    const QString pageKey = domain + "." + extension;
+    ConfigComplexityFilterModel* filter = filtered_sections_.value(pageKey);
+    if (filter != nullptr) {
+        return filter;
+    }
+
+    // Built once per page and then patched in place; QML bindings survive value changes
+    auto* model = new ConfigSectionModel(this);
+    filter = new ConfigComplexityFilterModel(this);
+    filter->setSourceModel(model);
+    QQmlEngine::setObjectOwnership(filter, QQmlEngine::CppOwnership);
+    section_models_.insert(pageKey, model);
+    filtered_sections_.insert(pageKey, filter);
+
+    if (config_manager_ != nullptr) {
+        const int level = static_cast<int>(config_manager_->getComplexityLevel());
+        model->setComplexityLevel(level);
+        filter->setComplexityLevel(level);
+        model->setPage(config_manager_->getConfigPage(domain, extension));
+    } else {
+        qWarning() << "ConfigManager not initialised";
+    }
+    return filter;
+}
+
+QVariantMap ConfigManagerBridge::getPageInfo(const QString& domain,
+                                             const QString& extension) const {
+    return page_model_->pageInfo(domain, extension).toMap();
+}
+
 QVariant ConfigManagerBridge::getValue(const QString& domain, const QString& extension,
                                        const QString& section, const QString& key) const {
     if (config_manager_ == nullptr) {
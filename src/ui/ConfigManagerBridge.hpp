@@ -20,6 +20,7 @@
 #pragma once
 
 #include <qqml.h>
+#include <QHash>
 #include <QObject>
 #include <QVariantList>
 #include <QVariantMap>
@@ -30,10 +31,16 @@ class ConfigManager;
 
 namespace opencardev::crankshaft::ui {
 
+class ConfigComplexityFilterModel;
+class ConfigPageModel;
+class ConfigSectionModel;
+
 class ConfigManagerBridge : public QObject {
     Q_OBJECT
     QML_ELEMENT
     QML_SINGLETON
+    // Registered pages filtered by the current complexity level; updated incrementally
+    Q_PROPERTY(QObject* pagesModel READ pagesModel CONSTANT)
 
   public:
     static ConfigManagerBridge* instance();
@@ -45,6 +52,13 @@ class ConfigManagerBridge : public QObject {
     Q_INVOKABLE QVariantList getConfigPagesByDomain(const QString& domain) const;
     Q_INVOKABLE QVariantMap getConfigPage(const QString& domain, const QString& extension) const;
 
+    // Models
+    QObject* pagesModel() const;
+    // Sections of one page, filtered by complexity; each row exposes an "items" model
+    Q_INVOKABLE QObject* sectionsModel(const QString& domain, const QString& extension);
+    // Page metadata without sections (title, description, icon, ...)
+    Q_INVOKABLE QVariantMap getPageInfo(const QString& domain, const QString& extension) const;
+
     // Value access
     Q_INVOKABLE QVariant getValue(const QString& domain, const QString& extension,
                                   const QString& section, const QString& key) const;
@@ -93,9 +107,14 @@ class ConfigManagerBridge : public QObject {
     ~ConfigManagerBridge() override = default;
 
     void connectSignals();
+    void populateModels();
 
     static ConfigManagerBridge* instance_;
     core::config::ConfigManager* config_manager_;
+    ConfigPageModel* page_model_;
+    ConfigComplexityFilterModel* filtered_pages_;
+    QHash<QString, ConfigSectionModel*> section_models_;  // Keyed by "domain.extension"
+    QHash<QString, ConfigComplexityFilterModel*> filtered_sections_;
 };
 
 }  // namespace opencardev::crankshaft::ui
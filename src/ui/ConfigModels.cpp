@@ -0,0 +1,358 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ConfigModels.hpp"
+#include <QQmlEngine>
+#include <algorithm>
+
+namespace opencardev::crankshaft::ui {
+
+using core::config::ConfigItem;
+using core::config::ConfigPage;
+using core::config::ConfigSection;
+using core::config::configComplexityToString;
+using core::config::configItemTypeToString;
+
+// ============================================================================
+// ConfigComplexityFilterModel
+// ============================================================================
+
+ConfigComplexityFilterModel::ConfigComplexityFilterModel(QObject* parent)
+    : QSortFilterProxyModel(parent), complexity_level_(0) {
+    connect(this, &QAbstractItemModel::rowsInserted, this,
+            &ConfigComplexityFilterModel::countChanged);
+    connect(this, &QAbstractItemModel::rowsRemoved, this,
+            &ConfigComplexityFilterModel::countChanged);
+    connect(this, &QAbstractItemModel::modelReset, this,
+            &ConfigComplexityFilterModel::countChanged);
+    connect(this, &QAbstractItemModel::layoutChanged, this,
+            &ConfigComplexityFilterModel::countChanged);
+}
+
+void ConfigComplexityFilterModel::setComplexityLevel(int level) {
+    if (complexity_level_ == level) {
+        return;
+    }
+    complexity_level_ = level;
+    invalidateFilter();
+    emit complexityLevelChanged();
+    emit countChanged();
+}
+
+QVariantMap ConfigComplexityFilterModel::get(int row) const {
+    QVariantMap result;
+    const QModelIndex idx = index(row, 0);
+    if (!idx.isValid()) {
+        return result;
+    }
+    const QHash<int, QByteArray> roles = roleNames();
+    for (auto it = roles.cbegin(); it != roles.cend(); ++it) {
+        result.insert(QString::fromUtf8(it.value()), idx.data(it.key()));
+    }
+    return result;
+}
+
+bool ConfigComplexityFilterModel::filterAcceptsRow(int sourceRow,
+                                                   const QModelIndex& sourceParent) const {
+    const QModelIndex idx = sourceModel()->index(sourceRow, 0, sourceParent);
+    return idx.data(kConfigComplexityRole).toInt() <= complexity_level_;
+}
+
+// ============================================================================
+// ConfigItemModel
+// ============================================================================
+
+ConfigItemModel::ConfigItemModel(const QList<ConfigItem>& items, QObject* parent)
+    : QAbstractListModel(parent), items_(items) {
+    for (int row = 0; row < items_.size(); ++row) {
+        row_by_key_.insert(items_[row].key, row);
+    }
+}
+
+int ConfigItemModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : items_.size();
+}
+
+QVariant ConfigItemModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= items_.size()) {
+        return QVariant();
+    }
+
+    const ConfigItem& item = items_[index.row()];
+    switch (role) {
+    case ComplexityRole:
+        return static_cast<int>(item.complexity);
+    case KeyRole:
+        return item.key;
+    case LabelRole:
+        return item.label;
+    case DescriptionRole:
+        return item.description;
+    case TypeRole:
+        return configItemTypeToString(item.type);
+    case ValueRole:
+        return item.currentValue.isValid() ? item.currentValue : item.defaultValue;
+    case DefaultValueRole:
+        return item.defaultValue;
+    case PropertiesRole:
+        return item.properties;
+    case RequiredRole:
+        return item.required;
+    case ReadOnlyRole:
+        return item.readOnly;
+    case SecretRole:
+        return item.isSecret;
+    case UnitRole:
+        return item.unit;
+    case IconRole:
+        return item.icon;
+    case ComplexityNameRole:
+        return configComplexityToString(item.complexity);
+    case ItemDataRole:
+        return item.toMap();
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> ConfigItemModel::roleNames() const {
+    return {{ComplexityRole, "complexity"},
+            {KeyRole, "key"},
+            {LabelRole, "label"},
+            {DescriptionRole, "description"},
+            {TypeRole, "type"},
+            {ValueRole, "value"},
+            {DefaultValueRole, "defaultValue"},
+            {PropertiesRole, "properties"},
+            {RequiredRole, "required"},
+            {ReadOnlyRole, "readOnly"},
+            {SecretRole, "isSecret"},
+            {UnitRole, "unit"},
+            {IconRole, "icon"},
+            {ComplexityNameRole, "complexityName"},
+            {ItemDataRole, "itemData"}};
+}
+
+bool ConfigItemModel::updateValue(const QString& key, const QVariant& value) {
+    const auto it = row_by_key_.constFind(key);
+    if (it == row_by_key_.cend()) {
+        return false;
+    }
+
+    items_[it.value()].currentValue = value;
+    const QModelIndex idx = index(it.value());
+    emit dataChanged(idx, idx, {ValueRole, ItemDataRole});
+    return true;
+}
+
+// ============================================================================
+// ConfigSectionModel
+// ============================================================================
+
+ConfigSectionModel::ConfigSectionModel(QObject* parent)
+    : QAbstractListModel(parent), complexity_level_(0) {}
+
+int ConfigSectionModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : sections_.size();
+}
+
+QVariant ConfigSectionModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= sections_.size()) {
+        return QVariant();
+    }
+
+    const SectionEntry& entry = sections_[index.row()];
+    switch (role) {
+    case ComplexityRole:
+        return static_cast<int>(entry.section.complexity);
+    case KeyRole:
+        return entry.section.key;
+    case TitleRole:
+        return entry.section.title;
+    case DescriptionRole:
+        return entry.section.description;
+    case IconRole:
+        return entry.section.icon;
+    case ComplexityNameRole:
+        return configComplexityToString(entry.section.complexity);
+    case ItemsRole:
+        return QVariant::fromValue(static_cast<QObject*>(entry.filtered_items));
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> ConfigSectionModel::roleNames() const {
+    return {{ComplexityRole, "complexity"},   {KeyRole, "key"},
+            {TitleRole, "title"},             {DescriptionRole, "description"},
+            {IconRole, "icon"},               {ComplexityNameRole, "complexityName"},
+            {ItemsRole, "items"}};
+}
+
+void ConfigSectionModel::setPage(const ConfigPage& page) {
+    beginResetModel();
+    clearSections();
+    for (const ConfigSection& section : page.sections) {
+        SectionEntry entry;
+        entry.section = section;
+        entry.section.items.clear();
+        entry.items = new ConfigItemModel(section.items, this);
+        entry.filtered_items = new ConfigComplexityFilterModel(this);
+        entry.filtered_items->setSourceModel(entry.items);
+        entry.filtered_items->setComplexityLevel(complexity_level_);
+        // Parented to this model; QML must never garbage-collect them
+        QQmlEngine::setObjectOwnership(entry.filtered_items, QQmlEngine::CppOwnership);
+        row_by_key_.insert(section.key, sections_.size());
+        sections_.append(entry);
+    }
+    endResetModel();
+}
+
+bool ConfigSectionModel::updateValue(const QString& section, const QString& key,
+                                     const QVariant& value) {
+    const auto it = row_by_key_.constFind(section);
+    if (it == row_by_key_.cend()) {
+        return false;
+    }
+    return sections_[it.value()].items->updateValue(key, value);
+}
+
+void ConfigSectionModel::setComplexityLevel(int level) {
+    complexity_level_ = level;
+    for (const SectionEntry& entry : sections_) {
+        entry.filtered_items->setComplexityLevel(level);
+    }
+}
+
+void ConfigSectionModel::clearSections() {
+    for (const SectionEntry& entry : sections_) {
+        entry.filtered_items->deleteLater();
+        entry.items->deleteLater();
+    }
+    sections_.clear();
+    row_by_key_.clear();
+}
+
+// ============================================================================
+// ConfigPageModel
+// ============================================================================
+
+ConfigPageModel::ConfigPageModel(QObject* parent) : QAbstractListModel(parent) {}
+
+int ConfigPageModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : pages_.size();
+}
+
+QVariant ConfigPageModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= pages_.size()) {
+        return QVariant();
+    }
+
+    const ConfigPage& page = pages_[index.row()];
+    switch (role) {
+    case ComplexityRole:
+        return static_cast<int>(page.complexity);
+    case DomainRole:
+        return page.domain;
+    case ExtensionRole:
+        return page.extension;
+    case TitleRole:
+        return page.title;
+    case DescriptionRole:
+        return page.description;
+    case IconRole:
+        return page.icon;
+    case ComplexityNameRole:
+        return configComplexityToString(page.complexity);
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> ConfigPageModel::roleNames() const {
+    return {{ComplexityRole, "complexity"},   {DomainRole, "domain"},
+            {ExtensionRole, "extension"},     {TitleRole, "title"},
+            {DescriptionRole, "description"}, {IconRole, "icon"},
+            {ComplexityNameRole, "complexityName"}};
+}
+
+void ConfigPageModel::addOrUpdatePage(const ConfigPage& page) {
+    ConfigPage info = page;
+    info.sections.clear();
+
+    const int existing = findRow(page.domain, page.extension);
+    if (existing >= 0) {
+        pages_[existing] = info;
+        const QModelIndex idx = index(existing);
+        emit dataChanged(idx, idx);
+        return;
+    }
+
+    const auto pos = std::upper_bound(pages_.begin(), pages_.end(), info, pageLessThan);
+    const int row = static_cast<int>(std::distance(pages_.begin(), pos));
+    beginInsertRows(QModelIndex(), row, row);
+    pages_.insert(row, info);
+    endInsertRows();
+}
+
+void ConfigPageModel::removePage(const QString& domain, const QString& extension) {
+    const int row = findRow(domain, extension);
+    if (row < 0) {
+        return;
+    }
+    beginRemoveRows(QModelIndex(), row, row);
+    pages_.removeAt(row);
+    endRemoveRows();
+}
+
+ConfigPage ConfigPageModel::pageInfo(const QString& domain, const QString& extension) const {
+    const int row = findRow(domain, extension);
+    return row >= 0 ? pages_[row] : ConfigPage();
+}
+
+int ConfigPageModel::findRow(const QString& domain, const QString& extension) const {
+    for (int row = 0; row < pages_.size(); ++row) {
+        if (pages_[row].domain == domain && pages_[row].extension == extension) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+bool ConfigPageModel::pageLessThan(const ConfigPage& a, const ConfigPage& b) {
+    // Keep the sidebar order the settings screen has always used: system first, then
+    // user interface, then remaining domains alphabetically.
+    static const QStringList kPriorityDomains = {"system", "user interface"};
+    auto rank = [](const QString& domain) {
+        const int idx = kPriorityDomains.indexOf(domain);
+        return idx >= 0 ? idx : kPriorityDomains.size();
+    };
+
+    const int rankA = rank(a.domain);
+    const int rankB = rank(b.domain);
+    if (rankA != rankB) {
+        return rankA < rankB;
+    }
+    if (a.domain != b.domain) {
+        return a.domain < b.domain;
+    }
+    return a.extension < b.extension;
+}
+
+}  // namespace opencardev::crankshaft::ui
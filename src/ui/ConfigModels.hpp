@@ -0,0 +1,179 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QList>
+#include <QSortFilterProxyModel>
+#include <QVariantMap>
+#include "../core/config/ConfigTypes.hpp"
+
+namespace opencardev::crankshaft::ui {
+
+// Role shared by all config models so one proxy type can filter any level of the tree
+constexpr int kConfigComplexityRole = Qt::UserRole + 1;
+
+/**
+ * Filters config rows whose minimum complexity is above the current level.
+ * Exposes count/get() so QML can inspect rows without a delegate.
+ */
+class ConfigComplexityFilterModel : public QSortFilterProxyModel {
+    Q_OBJECT
+    Q_PROPERTY(int complexityLevel READ complexityLevel WRITE setComplexityLevel NOTIFY
+                   complexityLevelChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+  public:
+    explicit ConfigComplexityFilterModel(QObject* parent = nullptr);
+
+    int complexityLevel() const { return complexity_level_; }
+    void setComplexityLevel(int level);
+    int count() const { return rowCount(); }
+
+    Q_INVOKABLE QVariantMap get(int row) const;
+
+  signals:
+    void complexityLevelChanged();
+    void countChanged();
+
+  protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+
+  private:
+    int complexity_level_;
+};
+
+/**
+ * Items of a single config section. Values are patched in place via updateValue().
+ */
+class ConfigItemModel : public QAbstractListModel {
+    Q_OBJECT
+
+  public:
+    enum Roles {
+        ComplexityRole = kConfigComplexityRole,
+        KeyRole,
+        LabelRole,
+        DescriptionRole,
+        TypeRole,
+        ValueRole,
+        DefaultValueRole,
+        PropertiesRole,
+        RequiredRole,
+        ReadOnlyRole,
+        SecretRole,
+        UnitRole,
+        IconRole,
+        ComplexityNameRole,
+        ItemDataRole  // Full item map, as consumed by ConfigItemView
+    };
+
+    explicit ConfigItemModel(const QList<core::config::ConfigItem>& items,
+                             QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    bool updateValue(const QString& key, const QVariant& value);
+
+  private:
+    QList<core::config::ConfigItem> items_;
+    QHash<QString, int> row_by_key_;
+};
+
+/**
+ * Sections of a single config page. Each row carries its own filtered item model.
+ */
+class ConfigSectionModel : public QAbstractListModel {
+    Q_OBJECT
+
+  public:
+    enum Roles {
+        ComplexityRole = kConfigComplexityRole,
+        KeyRole,
+        TitleRole,
+        DescriptionRole,
+        IconRole,
+        ComplexityNameRole,
+        ItemsRole
+    };
+
+    explicit ConfigSectionModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // Rebuild from a (re-)registered page
+    void setPage(const core::config::ConfigPage& page);
+    bool updateValue(const QString& section, const QString& key, const QVariant& value);
+    void setComplexityLevel(int level);
+
+  private:
+    struct SectionEntry {
+        core::config::ConfigSection section;  // Metadata only; items live in the item model
+        ConfigItemModel* items;
+        ConfigComplexityFilterModel* filtered_items;
+    };
+
+    void clearSections();
+
+    QList<SectionEntry> sections_;
+    QHash<QString, int> row_by_key_;
+    int complexity_level_;
+};
+
+/**
+ * Registered config pages (metadata only), ordered with system pages first.
+ */
+class ConfigPageModel : public QAbstractListModel {
+    Q_OBJECT
+
+  public:
+    enum Roles {
+        ComplexityRole = kConfigComplexityRole,
+        DomainRole,
+        ExtensionRole,
+        TitleRole,
+        DescriptionRole,
+        IconRole,
+        ComplexityNameRole
+    };
+
+    explicit ConfigPageModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    void addOrUpdatePage(const core::config::ConfigPage& page);
+    void removePage(const QString& domain, const QString& extension);
+    core::config::ConfigPage pageInfo(const QString& domain, const QString& extension) const;
+
+  private:
+    int findRow(const QString& domain, const QString& extension) const;
+    static bool pageLessThan(const core::config::ConfigPage& a, const core::config::ConfigPage& b);
+
+    QList<core::config::ConfigPage> pages_;  // Sections stripped
+};
+
+}  // namespace opencardev::crankshaft::ui
@@ -0,0 +1,147 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ExtensionDiagnosticsBridge.hpp"
+#include <QDateTime>
+#include <QDebug>
+#include <QQmlEngine>
+#include <algorithm>
+#include <utility>
+#include "../core/capabilities/CapabilityManager.hpp"
+#include "../core/events/event_bus.hpp"
+
+namespace opencardev::crankshaft::ui {
+
+namespace {
+
+// Stall reports kept for the diagnostics view
+constexpr int kMaxStalls = 20;
+
+// Counters turned into per-second rates, and the name of the rate field
+const std::pair<const char*, const char*> kRateFields[] = {
+    {"net_bytes_in", "net_in_rate"},       {"net_bytes_out", "net_out_rate"},
+    {"fs_bytes_read", "fs_read_rate"},     {"fs_bytes_written", "fs_write_rate"},
+    {"events_emitted", "events_out_rate"}, {"events_received", "events_in_rate"},
+};
+
+}  // namespace
+
+ExtensionDiagnosticsBridge* ExtensionDiagnosticsBridge::instance_ = nullptr;
+
+ExtensionDiagnosticsBridge* ExtensionDiagnosticsBridge::instance() {
+    if (!instance_) {
+        instance_ = new ExtensionDiagnosticsBridge();
+    }
+    return instance_;
+}
+
+void ExtensionDiagnosticsBridge::registerQmlType() {
+    qmlRegisterSingletonType<ExtensionDiagnosticsBridge>(
+        "CrankshaftReborn.UI", 1, 0, "ExtensionDiagnosticsBridge",
+        [](QQmlEngine*, QJSEngine*) -> QObject* {
+            QObject* bridge = ExtensionDiagnosticsBridge::instance();
+            QQmlEngine::setObjectOwnership(bridge, QQmlEngine::CppOwnership);
+            return bridge;
+        });
+}
+
+void ExtensionDiagnosticsBridge::initialise(core::EventBus* bus,
+                                            core::CapabilityManager* manager) {
+    ExtensionDiagnosticsBridge* bridge = instance();
+    bridge->capability_manager_ = manager;
+    if (bus) {
+        bus->subscribe(QStringLiteral("core.diagnostics.resources"),
+                       [bridge](const QVariantMap& snapshot) {
+                           bridge->applySample(snapshot.value("extensions").toList(),
+                                               snapshot.value("timestamp").toLongLong());
+                       });
+        bus->subscribe(QStringLiteral("core.diagnostics.stall"),
+                       [bridge](const QVariantMap& report) { bridge->addStall(report); });
+    }
+    qInfo() << "ExtensionDiagnosticsBridge initialised";
+}
+
+ExtensionDiagnosticsBridge::ExtensionDiagnosticsBridge(QObject* parent)
+    : QObject(parent), capability_manager_(nullptr), previous_timestamp_ms_(0) {}
+
+void ExtensionDiagnosticsBridge::refresh() {
+    if (!capability_manager_) {
+        return;
+    }
+    applySample(capability_manager_->getResourceUsage(), QDateTime::currentMSecsSinceEpoch());
+}
+
+void ExtensionDiagnosticsBridge::applySample(const QVariantList& sample, qint64 timestampMs) {
+    const qint64 elapsedMs = previous_timestamp_ms_ > 0 ? timestampMs - previous_timestamp_ms_ : 0;
+    // Rates are meaningless over a very short window (e.g. refresh() right after a snapshot),
+    // so such samples are dropped and the previous one stays the baseline
+    const bool haveWindow = elapsedMs >= 250;
+    if (!haveWindow && previous_timestamp_ms_ > 0) {
+        return;
+    }
+
+    QVariantList rows;
+    QHash<QString, QVariantMap> totals;
+    rows.reserve(sample.size());
+    for (const QVariant& value : sample) {
+        QVariantMap row = value.toMap();
+        const QString id = row.value("id").toString();
+        const QVariantMap before = previous_.value(id);
+
+        double cpuPercent = 0.0;
+        if (haveWindow && !before.isEmpty()) {
+            const double cpuMs = row.value("cpu_ms").toDouble() - before.value("cpu_ms").toDouble();
+            cpuPercent = std::max(0.0, cpuMs * 100.0 / double(elapsedMs));
+        }
+        row["cpu_percent"] = cpuPercent;
+
+        for (const auto& field : kRateFields) {
+            double rate = 0.0;
+            if (haveWindow && !before.isEmpty()) {
+                const double delta = row.value(field.first).toDouble() -
+                                     before.value(field.first).toDouble();
+                rate = std::max(0.0, delta * 1000.0 / double(elapsedMs));
+            }
+            row[field.second] = rate;
+        }
+
+        totals.insert(id, row);
+        rows.append(row);
+    }
+
+    std::stable_sort(rows.begin(), rows.end(), [](const QVariant& a, const QVariant& b) {
+        return a.toMap().value("cpu_percent").toDouble() >
+               b.toMap().value("cpu_percent").toDouble();
+    });
+
+    previous_ = totals;
+    previous_timestamp_ms_ = timestampMs;
+    extensions_ = rows;
+    emit extensionsChanged();
+}
+
+void ExtensionDiagnosticsBridge::addStall(const QVariantMap& report) {
+    stalls_.prepend(report);
+    while (stalls_.size() > kMaxStalls) {
+        stalls_.removeLast();
+    }
+    emit stallsChanged();
+}
+
+}  // namespace opencardev::crankshaft::ui
@@ -0,0 +1,81 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <qqml.h>
+#include <QHash>
+#include <QObject>
+#include <QVariantList>
+#include <QVariantMap>
+
+namespace opencardev::crankshaft::core {
+class CapabilityManager;
+class EventBus;
+}  // namespace opencardev::crankshaft::core
+
+namespace opencardev::crankshaft::ui {
+
+/**
+ * Live per-extension resource usage for the extension manager's diagnostics view.
+ *
+ * Follows the "core.diagnostics.resources" snapshots published by CapabilityManager and
+ * turns consecutive snapshots into rates (CPU share, bytes and events per second), and
+ * keeps the GUI stalls reported by the StallWatchdog as "core.diagnostics.stall".
+ */
+class ExtensionDiagnosticsBridge : public QObject {
+    Q_OBJECT
+    QML_ELEMENT
+    QML_SINGLETON
+    // One row per extension, busiest first: totals plus *_rate fields and cpu_percent
+    Q_PROPERTY(QVariantList extensions READ extensions NOTIFY extensionsChanged)
+    // Recent GUI stalls, newest first: { started_at, duration_ms, blame, operation, detail, ... }
+    Q_PROPERTY(QVariantList stalls READ stalls NOTIFY stallsChanged)
+
+  public:
+    static ExtensionDiagnosticsBridge* instance();
+    static void registerQmlType();
+    static void initialise(core::EventBus* bus, core::CapabilityManager* manager);
+
+    QVariantList extensions() const { return extensions_; }
+    QVariantList stalls() const { return stalls_; }
+
+    // Take a sample now rather than waiting for the next snapshot
+    Q_INVOKABLE void refresh();
+
+  signals:
+    void extensionsChanged();
+    void stallsChanged();
+
+  private:
+    explicit ExtensionDiagnosticsBridge(QObject* parent = nullptr);
+    ~ExtensionDiagnosticsBridge() override = default;
+
+    void applySample(const QVariantList& sample, qint64 timestampMs);
+    void addStall(const QVariantMap& report);
+
+    static ExtensionDiagnosticsBridge* instance_;
+    core::CapabilityManager* capability_manager_;
+    QVariantList extensions_;
+    QVariantList stalls_;
+    QHash<QString, QVariantMap> previous_;  // Extension id -> previous totals
+    qint64 previous_timestamp_ms_;
+};
+
+}  // namespace opencardev::crankshaft::ui
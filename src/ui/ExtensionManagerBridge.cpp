@@ -19,9 +19,6 @@
 
 #include "ExtensionManagerBridge.hpp"
 #include <QDebug>
-#include <QFile>
-#include <QJsonDocument>
-#include <QJsonObject>
 #include <QQmlEngine>
 #include "../extensions/extension_manager.hpp"
 #include "../extensions/extension_manifest.hpp"
@@ -65,6 +62,8 @@ void ExtensionManagerBridge::connectSignals() {
             &ExtensionManagerBridge::extensionUnloaded);
     connect(extension_manager_, &extensions::ExtensionManager::extensionError, this,
             &ExtensionManagerBridge::extensionError);
+    connect(extension_manager_, &extensions::ExtensionManager::availableExtensionsChanged, this,
+            &ExtensionManagerBridge::extensionsRefreshed);
 }
 
 QVariantList ExtensionManagerBridge::getLoadedExtensions() const {
@@ -104,21 +103,9 @@ QVariantList ExtensionManagerBridge::getAvailableExtensions() const {
     for (const QString& path : searchPaths) {
         QStringList extensions = extension_manager_->discoverExtensions(path);
         for (const QString& extPath : extensions) {
-            QString manifestPath = extPath + "/manifest.json";
-            QFile file(manifestPath);
-            if (!file.open(QIODevice::ReadOnly)) {
-                continue;
-            }
-
-            QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-            file.close();
-
-            if (!doc.isObject()) {
-                continue;
-            }
-
-            QVariantMap json = doc.object().toVariantMap();
-            extensions::ExtensionManifest manifest = extensions::ExtensionManifest::fromJson(json);
+            // Served from the discovery cache unless the manifest changed on disk
+            extensions::ExtensionManifest manifest =
+                extension_manager_->discoveredManifest(extPath);
 
             if (!manifest.isValid() || discoveredIds.contains(manifest.id)) {
                 continue;
@@ -60,6 +60,33 @@ QObject* ExtensionRegistry::qmlInstance(QQmlEngine* engine, QJSEngine* scriptEng
 
 void ExtensionRegistry::registerComponent(const QString& extensionId, const QString& slotType,
                                           const QString& qmlPath, const QVariantMap& metadata) {
+    // An activated extension registering its view takes over the placeholder in place, so a
+    // view opened while the placeholder was showing is not torn down
+    for (ComponentInfo& existing : components_) {
+        if (existing.extension_id != extensionId || existing.slot_type != slotType ||
+            !existing.metadata.value("lazy").toBool()) {
+            continue;
+        }
+        const bool moved = existing.qml_path != qmlPath;
+        existing.qml_path = qmlPath;
+        for (auto it = metadata.cbegin(); it != metadata.cend(); ++it) {
+            existing.metadata.insert(it.key(), it.value());
+        }
+        existing.metadata["qmlPath"] = qmlPath;
+        existing.metadata.remove("lazy");
+
+        qInfo() << "ExtensionRegistry: Activated placeholder" << existing.component_id << "from"
+                << extensionId << "(" << slotType << ")";
+
+        emit componentRegistered(extensionId, existing.component_id);
+        if (moved && slotType == "main") {
+            emit mainComponentsChanged();
+        } else if (moved && slotType == "widget") {
+            emit widgetsChanged();
+        }
+        return;
+    }
+
     ComponentInfo info;
     info.component_id = QString("%1_%2").arg(extensionId).arg(next_component_id_++);
     info.extension_id = extensionId;
@@ -140,6 +167,24 @@ void ExtensionRegistry::unregisterExtensionComponents(const QString& extensionId
     }
 }
 
+void ExtensionRegistry::notifyViewOpened(const QString& componentId) {
+    // Copied out of the loop: activation replaces the placeholder, erasing it from
+    // components_ while the call is still running
+    QString extensionId;
+    for (const ComponentInfo& info : std::as_const(components_)) {
+        if (info.component_id == componentId) {
+            if (info.metadata.value("lazy").toBool()) {
+                extensionId = info.extension_id;
+            }
+            break;
+        }
+    }
+    if (!extensionId.isEmpty() && extension_manager_) {
+        const QString reason = "view " + componentId;
+        extension_manager_->activateExtension(extensionId, reason);
+    }
+}
+
 QVariantList ExtensionRegistry::mainComponents() const {
     QVariantList result;
 
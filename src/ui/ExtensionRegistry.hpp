@@ -40,6 +40,7 @@ namespace ui {
  * - Extensions register UI components via UICapability
  * - ExtensionRegistry collects and exposes registered components
  * - QML loads extension UI components in isolated contexts
+ * - Deferred extensions are represented by placeholder components until activated
  *
  * Usage in QML:
  *   Repeater {
@@ -102,6 +103,14 @@ class ExtensionRegistry : public QObject {
      */
     Q_INVOKABLE void unregisterExtensionComponents(const QString& extensionId);
 
+    /**
+     * Called by QML when a view is first shown. Opening the placeholder of a deferred
+     * extension (metadata "lazy": true) activates that extension before its view loads.
+     *
+     * @param componentId Component ID of the view
+     */
+    Q_INVOKABLE void notifyViewOpened(const QString& componentId);
+
     /**
      * Get all registered main view components.
      *
@@ -23,6 +23,7 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QQmlEngine>
+#include "../core/diagnostics/Trace.hpp"
 #include "../extensions/extension_manager.hpp"
 
 namespace opencardev {
@@ -78,6 +79,7 @@ QStringList I18nManager::availableLocales() const {
 }
 
 bool I18nManager::setLocale(const QString& locale) {
+    CRANKSHAFT_TRACE_SCOPE_DETAIL("ui", "I18nManager::setLocale", locale);
     if (current_locale_ == locale)
         return true;
 
@@ -22,6 +22,7 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QQmlEngine>
+#include "../core/diagnostics/Trace.hpp"
 
 namespace opencardev::crankshaft::ui {
 
@@ -44,6 +45,7 @@ void IconRegistry::registerQmlType() {
 }
 
 void IconRegistry::buildIndex() {
+    CRANKSHAFT_TRACE_SCOPE("ui", "IconRegistry::buildIndex");
     // Scan compiled resources under /icons/mdi
     QDir rootDir(":/icons");
     qDebug() << "IconRegistry: Root exists:" << rootDir.exists();
@@ -104,10 +104,35 @@ void NavigationBridge::applyToCapability() {
         mode = DM::MockStatic;
     else if (gpsDevice_.startsWith("Mock") && gpsDevice_.contains("IP"))
         mode = DM::MockIP;
+    else if (gpsDevice_ == "Replay")
+        mode = DM::Replay;
     locCap->setDeviceMode(mode);
     qInfo() << "NavigationBridge applied GPS device:" << gpsDevice_;
 }
 
+QVariantMap NavigationBridge::predictedPosition() const {
+    QVariantMap result;
+    result["valid"] = false;
+    if (!capability_manager_)
+        return result;
+    auto locCap = capability_manager_->getLocationCapability("navigation");
+    if (!locCap)
+        return result;
+    const QGeoPositionInfo info = locCap->predictPosition();
+    if (!info.isValid())
+        return result;
+    result["valid"] = true;
+    result["latitude"] = info.coordinate().latitude();
+    result["longitude"] = info.coordinate().longitude();
+    result["speed"] = info.hasAttribute(QGeoPositionInfo::GroundSpeed)
+                          ? info.attribute(QGeoPositionInfo::GroundSpeed)
+                          : 0.0;
+    result["heading"] = info.hasAttribute(QGeoPositionInfo::Direction)
+                            ? info.attribute(QGeoPositionInfo::Direction)
+                            : -1.0;
+    return result;
+}
+
 void NavigationBridge::setGpsDevice(const QString& device) {
     if (device == gpsDevice_)
         return;
@@ -68,6 +68,9 @@ class NavigationBridge : public QObject {
     QString geocodingProvider() const { return geocodingProviderId_; }
     QVariantList availableProviders() const;
 
+    // Smoothed position for this frame: { valid, latitude, longitude, speed, heading }
+    Q_INVOKABLE QVariantMap predictedPosition() const;
+
   public slots:
     void setGpsDevice(const QString& device);
     void setGeocodingProvider(const QString& providerId);
@@ -24,6 +24,7 @@
 #include <QFile>
 #include <QSettings>
 #include <QStandardPaths>
+#include "../core/diagnostics/Trace.hpp"
 
 namespace CrankshaftReborn {
 namespace UI {
@@ -41,6 +42,7 @@ ThemeManager* ThemeManager::instance() {
 }
 
 void ThemeManager::initialize(const QString& themesPath) {
+    CRANKSHAFT_TRACE_SCOPE("ui", "ThemeManager::initialize");
     // Set themes path
     if (themesPath.isEmpty()) {
         // Try multiple locations
@@ -0,0 +1,107 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+
+#include "core/application/application.hpp"
+#include "core/config/ConfigManager.hpp"
+#include "core/location/LocationHub.hpp"
+
+using namespace opencardev::crankshaft::core;
+
+/**
+ * Settings saved in one run must be in effect from the start of the next. Each test saves
+ * values through a first Application, then checks that a second one, started the way main()
+ * starts it, picks them up during initialize().
+ */
+class TestApplicationStartup : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase() {
+        QVERIFY(home_.isValid());
+        // Keep saved pages and audit logs out of the user's own directories
+        qputenv("XDG_CONFIG_HOME", (home_.path() + "/config").toUtf8());
+        qputenv("XDG_DATA_HOME", (home_.path() + "/data").toUtf8());
+    }
+
+    void saved_policy_overrides_apply_at_startup() {
+        saveValue("extensions", "permissions", "overrides",
+                  QVariantMap{{"policy_ext", QVariantMap{{"allow", QStringList{"network"}}}}});
+
+        Application application;
+        QVERIFY(application.initialize());
+        CapabilityManager* caps = application.capabilityManager();
+        caps->setExtensionPermissions("policy_ext", {"event"});
+        QVERIFY(caps->hasPermission("policy_ext", "network"));
+    }
+
+    void saved_rate_limits_apply_at_startup() {
+        saveValue("extensions", "rate_limits", "network", 5);
+
+        Application application;
+        QVERIFY(application.initialize());
+        const capabilities::RateLimit limit =
+            application.capabilityManager()->defaultRateLimit("network");
+        QCOMPARE(limit.rate, 5.0);
+        QCOMPARE(limit.burst, 10.0);
+    }
+
+    void saved_stall_threshold_applies_at_startup() {
+        saveValue("extensions", "diagnostics", "stall_threshold_ms", 400);
+
+        Application application;
+        QVERIFY(application.initialize());
+        QCOMPARE(application.stallWatchdog()->thresholdMs(), 400);
+    }
+
+    void saved_serial_receivers_apply_at_startup() {
+        saveValue("location", "receivers", "usb_device", "/dev/ttyUSB3");
+
+        Application application;
+        QVERIFY(application.initialize());
+        location::LocationHub* hub = application.capabilityManager()->locationHub();
+        QCOMPARE(hub->serialDevice(location::LocationHub::DeviceMode::USB),
+                 QString("/dev/ttyUSB3"));
+    }
+
+    void saved_replay_applies_at_startup() {
+        saveValue("location", "replay", "file", "/tmp/drive.nmea");
+
+        Application application;
+        QVERIFY(application.initialize());
+        location::LocationHub* hub = application.capabilityManager()->locationHub();
+        QCOMPARE(hub->replayFile(), QString("/tmp/drive.nmea"));
+    }
+
+  private:
+    // Save a system setting the way the settings UI would, then shut down
+    static void saveValue(const QString& extension, const QString& section, const QString& key,
+                          const QVariant& value) {
+        Application application;
+        QVERIFY(application.initialize());
+        QVERIFY(application.configManager()->setValue("system", extension, section, key, value));
+    }
+
+    QTemporaryDir home_;
+};
+
+QTEST_MAIN(TestApplicationStartup)
+#include "test_application_startup.moc"
@@ -35,6 +35,10 @@ private slots:
     void initTestCase() {
         // Ensure predictable test environment
         qputenv("QT_HASH_SEED", QByteArray("1"));
+        // Saved pages go to a throwaway config directory, never the user's own
+        QVERIFY(home_.isValid());
+        qputenv("XDG_CONFIG_HOME", home_.path().toUtf8());
+        QCOMPARE(QStandardPaths::writableLocation(QStandardPaths::ConfigLocation), home_.path());
     }
 
     void register_and_get_set_values() {
@@ -175,8 +179,7 @@ private slots:
         mgr.registerConfigPage(page);
         QVERIFY(mgr.setValue("core","backup","game","level", 42));
 
-        QString tmpPath = QDir::temp().filePath("config_backup_test.json.gz");
-        QFile::remove(tmpPath);
+        QString tmpPath = QDir(home_.path()).filePath("config_backup_test.json.gz");
 
         QVERIFY2(mgr.backupToFile(tmpPath, /*maskSecrets=*/false, /*compress=*/true), "backupToFile failed");
 
@@ -184,8 +187,100 @@ private slots:
         QVERIFY(mgr.setValue("core","backup","game","level", 7));
         QVERIFY2(mgr.restoreFromFile(tmpPath, /*overwriteExisting=*/true), "restoreFromFile failed");
         QCOMPARE(mgr.getValue("core","backup","game","level").toInt(), 42);
+    }
+
+    void external_change_reloads_only_changed_keys() {
+        ConfigManager mgr;
+
+        ConfigItem level;
+        level.key = "level";
+        level.label = "Level";
+        level.type = ConfigItemType::Integer;
+        level.defaultValue = 1;
+
+        ConfigItem name;
+        name.key = "name";
+        name.label = "Name";
+        name.type = ConfigItemType::String;
+        name.defaultValue = "initial";
+
+        ConfigSection sec;
+        sec.key = "general";
+        sec.title = "General";
+        sec.items = { level, name };
 
-        QFile::remove(tmpPath);
+        ConfigPage page;
+        page.domain = "core";
+        page.extension = "watch";
+        page.title = "Watch";
+        page.sections = { sec };
+
+        mgr.registerConfigPage(page);
+        mgr.resetToDefaults("core","watch");
+
+        QSignalSpy reloadedSpy(&mgr, &ConfigManager::configReloaded);
+        QSignalSpy valueSpy(&mgr, &ConfigManager::configValueChanged);
+
+        // Our own write must not be reported as an external change
+        QVERIFY(mgr.reloadChangedPages().isEmpty());
+        QCOMPARE(reloadedSpy.count(), 0);
+
+        // Simulate a provisioning script rewriting the file with one changed value
+        const QString filePath = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation) +
+                                 "/CrankshaftReborn/config/core.watch.json";
+        QFile file(filePath);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("{\"domain\":\"core\",\"extension\":\"watch\",\"version\":\"1.0\","
+                   "\"config\":{\"general\":{\"level\":1234,\"name\":\"initial\"}}}");
+        file.close();
+
+        const QStringList changed = mgr.reloadChangedPages();
+        QCOMPARE(changed, QStringList{"core.watch.general.level"});
+        QCOMPARE(reloadedSpy.count(), 1);
+        QCOMPARE(valueSpy.count(), 1);
+        QCOMPARE(mgr.getValue("core","watch","general","level").toInt(), 1234);
+        QCOMPARE(mgr.getValue("core","watch","general","name").toString(), QString("initial"));
+
+        // Nothing changed since the last reload
+        QVERIFY(mgr.reloadChangedPages().isEmpty());
+    }
+
+    void load_reports_malformed_files() {
+        ConfigManager mgr;
+
+        ConfigItem level;
+        level.key = "level";
+        level.label = "Level";
+        level.type = ConfigItemType::Integer;
+        level.defaultValue = 1;
+
+        ConfigSection sec;
+        sec.key = "general";
+        sec.title = "General";
+        sec.items = { level };
+
+        ConfigPage page;
+        page.domain = "core";
+        page.extension = "broken";
+        page.title = "Broken";
+        page.sections = { sec };
+
+        mgr.registerConfigPage(page);
+        mgr.resetToDefaults("core","broken");
+        QVERIFY(mgr.setValue("core","broken","general","level", 7));
+        QVERIFY(mgr.load());
+        QCOMPARE(mgr.getValue("core","broken","general","level").toInt(), 7);
+
+        const QString filePath = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation) +
+                                 "/CrankshaftReborn/config/core.broken.json";
+        QFile file(filePath);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("{\"config\": {\"general\": ");
+        file.close();
+        QVERIFY(!mgr.load());
+        QCOMPARE(mgr.getValue("core","broken","general","level").toInt(), 7);
+
+        QFile::remove(filePath);
     }
 
     void complexity_level_set_get() {
@@ -193,6 +288,9 @@ private slots:
         mgr.setComplexityLevel(ConfigComplexity::Advanced);
         QCOMPARE(mgr.getComplexityLevel(), ConfigComplexity::Advanced);
     }
+
+private:
+    QTemporaryDir home_;
 };
 
 QTEST_MAIN(TestConfigManager)
@@ -47,6 +47,9 @@ private slots:
         core::EventBus eventBus;
         core::CapabilityManager capManager(&eventBus, nullptr);
 
+        capManager.setExtensionPermissions("media_player", {"event"});
+        capManager.setExtensionPermissions("tester", {"event"});
+
         // Prepare media player extension and grant event capability
         extensions::media::MediaPlayerExtension media;
         auto mediaEventCap = capManager.grantCapability("media_player", "event");
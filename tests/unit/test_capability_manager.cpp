@@ -18,7 +18,10 @@
  */
 
 #include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "core/capabilities/AuditStore.hpp"
 #include "core/capabilities/CapabilityManager.hpp"
+#include "core/capabilities/TokenCapabilityImpl.hpp"
 #include "core/events/event_bus.hpp"
 
 using namespace opencardev::crankshaft::core;
@@ -31,6 +34,7 @@ private slots:
     void grant_and_revoke_single_capability() {
         EventBus bus;
         CapabilityManager mgr(&bus, nullptr);
+        mgr.setExtensionPermissions("test_ext", {"ui"});
 
         auto cap = mgr.grantCapability("test_ext", "ui");
         QVERIFY(cap != nullptr);
@@ -43,6 +47,7 @@ private slots:
     void grant_multiple_then_revoke_all() {
         EventBus bus;
         CapabilityManager mgr(&bus, nullptr);
+        mgr.setExtensionPermissions("extA", {"event", "filesystem"});
 
         QVERIFY(mgr.grantCapability("extA", "event") != nullptr);
         QVERIFY(mgr.grantCapability("extA", "filesystem") != nullptr);
@@ -57,12 +62,175 @@ private slots:
     void token_capability_basic() {
         EventBus bus;
         CapabilityManager mgr(&bus, nullptr);
+        mgr.setExtensionPermissions("phone_ui", {"contacts"});
 
         auto contacts = mgr.grantCapability("phone_ui", "contacts");
         QVERIFY(contacts != nullptr);
         QCOMPARE(contacts->id(), QString("contacts"));
         QVERIFY(mgr.hasCapability("phone_ui", "contacts"));
     }
+
+    void revoke_all_invalidates_held_capabilities() {
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        mgr.setExtensionPermissions("extB", {"phone", "ui"});
+
+        auto token = mgr.grantCapability("extB", "phone");
+        auto ui = mgr.grantCapability("extB", "ui");
+        QVERIFY(token && token->isValid());
+        QVERIFY(ui && ui->isValid());
+
+        mgr.revokeAllCapabilities("extB");
+        // Extensions may still hold the pointers; they must be dead after revocation
+        QVERIFY(!token->isValid());
+        QVERIFY(!ui->isValid());
+    }
+
+    void custom_factory_can_be_registered_and_removed() {
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        mgr.setExtensionPermissions("extC", {"custom"});
+
+        QVERIFY(mgr.grantCapability("extC", "custom") == nullptr);
+        QVERIFY(mgr.registerCapabilityFactory(
+            "custom", [](const QString& extensionId, const QVariantMap&) {
+                return createTokenCapabilityInstance(extensionId, "custom");
+            }));
+        QVERIFY(!mgr.registerCapabilityFactory(
+            "custom", [](const QString&, const QVariantMap&) { return nullptr; }));
+        QVERIFY(mgr.registeredCapabilityTypes().contains("custom"));
+
+        auto cap = mgr.grantCapability("extC", "custom");
+        QVERIFY(cap && cap->isValid());
+
+        mgr.unregisterCapabilityFactory("custom");
+        QVERIFY(!cap->isValid());
+        QVERIFY(!mgr.hasCapability("extC", "custom"));
+        QVERIFY(mgr.grantCapability("extC", "custom") == nullptr);
+    }
+
+    void undeclared_permissions_are_denied() {
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+
+        QVERIFY(mgr.grantCapability("unknown_ext", "ui") == nullptr);
+        mgr.setExtensionPermissions("extD", {"ui"});
+        QVERIFY(mgr.grantCapability("extD", "network") == nullptr);
+        QVERIFY(mgr.grantCapability("extD", "ui") != nullptr);
+        QVERIFY(!mgr.hasPermission("extD", "network"));
+    }
+
+    void policy_override_revokes_only_affected_capabilities() {
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        mgr.setExtensionPermissions("extE", {"ui", "event"});
+
+        auto ui = mgr.grantCapability("extE", "ui");
+        auto event =
+            std::dynamic_pointer_cast<EventCapability>(mgr.grantCapability("extE", "event"));
+        QVERIFY(ui && event);
+        QVERIFY(event->canSubscribe("*"));
+        QVERIFY(event->canSubscribe("core.started"));
+
+        // Denying a scoped permission revokes the event capability but leaves ui alone
+        mgr.setPolicyOverride("*", {}, {"event.wildcard"});
+        QVERIFY(!event->isValid());
+        QVERIFY(ui->isValid());
+
+        event = std::dynamic_pointer_cast<EventCapability>(mgr.grantCapability("extE", "event"));
+        QVERIFY(event);
+        QVERIFY(!event->canSubscribe("*"));
+        QVERIFY(event->canSubscribe("core.started"));
+        QVERIFY(event->canSubscribe("extE.anything"));
+
+        // Allow overrides grant undeclared permissions
+        mgr.setPolicyOverride("extE", {"network"}, {});
+        QVERIFY(mgr.hasPermission("extE", "network"));
+        QVERIFY(mgr.effectivePermissions("extE").contains("network"));
+    }
+
+    void audit_log_is_newest_first_and_filtered() {
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+
+        mgr.logCapabilityUsage("extA", "network", "get", "http://example.com/a");
+        mgr.logCapabilityUsage("extB", "location", "getCurrentPosition");
+        mgr.logCapabilityUsage("extA", "network", "post", QString(100, QLatin1Char('x')));
+
+        const auto all = mgr.getAuditLog(QString(), 0);
+        QCOMPARE(all.size(), 3);
+        QCOMPARE(all[0]["action"].toString(), QString("post"));
+        QCOMPARE(all[2]["details"].toString(), QString("http://example.com/a"));
+        QVERIFY(all[0]["timestamp"].toLongLong() > 0);
+        // Long details keep a fixed-size prefix
+        QVERIFY(all[0]["details"].toString().size() < 100);
+
+        const auto extA = mgr.getAuditLog("extA", 1);
+        QCOMPARE(extA.size(), 1);
+        QCOMPARE(extA[0]["extension_id"].toString(), QString("extA"));
+        QCOMPARE(extA[0]["capability_type"].toString(), QString("network"));
+        QVERIFY(mgr.getAuditLog("unknown", 0).isEmpty());
+    }
+
+    void audit_log_keeps_most_recent_entries_when_full() {
+        AuditLog log;
+        const int total = int(AuditLog::kCapacity) + 10;
+        for (int i = 0; i < total; ++i) {
+            log.append("ext", "event", "emit", QString::number(i));
+        }
+
+        const auto entries = log.entries(QString(), 0);
+        QCOMPARE(entries.size(), int(AuditLog::kCapacity));
+        QCOMPARE(entries.first()["details"].toString(), QString::number(total - 1));
+        QCOMPARE(entries.last()["details"].toString(), QString::number(10));
+    }
+
+    void audit_store_persists_and_queries_by_filter() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+
+        {
+            AuditLog log;
+            AuditStore store(&log, dir.path());
+            QVERIFY(store.open());
+            for (int i = 0; i < 30; ++i) {
+                log.append(i % 2 == 0 ? "nav" : "media", i % 3 == 0 ? "network" : "location",
+                           "get", QString::number(i));
+            }
+            store.flush();
+            QCOMPARE(store.recordCount(), quint64(30));
+        }
+
+        // Reopen: the previous segment is sealed and indexed on disk
+        AuditLog log;
+        AuditStore store(&log, dir.path());
+        QVERIFY(store.open());
+        QCOMPARE(store.recordCount(), quint64(30));
+
+        AuditQuery query;
+        query.extension_id = "nav";
+        query.capability_type = "network";
+        query.limit = 2;
+        auto page = store.query(query);
+        QCOMPARE(page.entries.size(), 2);
+        QVERIFY(page.has_more);
+        QCOMPARE(page.entries.at(0).details, QString("24"));
+        QCOMPARE(page.entries.at(1).details, QString("18"));
+
+        query.before = page.next_cursor;
+        query.limit = 10;
+        page = store.query(query);
+        QVERIFY(!page.has_more);
+        QStringList rest;
+        for (const auto& entry : page.entries) {
+            rest << entry.details;
+        }
+        QCOMPARE(rest, QStringList({"12", "6", "0"}));
+
+        AuditQuery future;
+        future.from_ms = QDateTime::currentMSecsSinceEpoch() + 60000;
+        QVERIFY(store.query(future).entries.isEmpty());
+    }
 };
 
 QTEST_MAIN(TestCapabilityManager)
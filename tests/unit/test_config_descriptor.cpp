@@ -0,0 +1,121 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#include <QTemporaryFile>
+#include "test_schema.hpp"  // Generated from tests/data/config/test_schema.json
+#include "core/config/ConfigDescriptor.hpp"
+#include "core/config/ConfigTypes.hpp"
+
+using namespace opencardev::crankshaft::core::config;
+
+class TestConfigDescriptor : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void generated_descriptor_builds_the_page() {
+        const ConfigPage page = configPageFromDescriptor(schema::kTestPage);
+        QCOMPARE(page.domain, QString("test"));
+        QCOMPARE(page.extension, QString("descriptor"));
+        QCOMPARE(page.title, QString("Descriptor Test"));
+        QCOMPARE(page.icon, QString("qrc:/icons/test.svg"));
+        QCOMPARE(page.complexity, ConfigComplexity::Advanced);
+        QCOMPARE(page.sections.size(), 2);
+
+        const ConfigSection& values = page.sections.at(0);
+        QCOMPARE(values.key, QString("values"));
+        QCOMPARE(values.icon, QString("Tune"));
+        QCOMPARE(values.complexity, ConfigComplexity::Basic);
+        QCOMPARE(values.items.size(), 7);
+        QVERIFY(page.sections.at(1).items.isEmpty());
+
+        const ConfigItem& flag = values.items.at(0);
+        QCOMPARE(flag.type, ConfigItemType::Boolean);
+        QCOMPARE(flag.defaultValue, QVariant(true));
+        QVERIFY(flag.description.isEmpty());
+
+        const ConfigItem& count = values.items.at(1);
+        QCOMPARE(count.defaultValue.typeId(), QMetaType::Int);
+        QCOMPARE(count.defaultValue.toInt(), 42);
+        QCOMPARE(count.properties.value("maxValue").toInt(), 100);
+        QCOMPARE(count.unit, QString("%"));
+
+        const ConfigItem& ratio = values.items.at(2);
+        QCOMPARE(ratio.defaultValue.typeId(), QMetaType::Double);
+        QCOMPARE(ratio.defaultValue.toDouble(), 2.5);
+        QCOMPARE(ratio.complexity, ConfigComplexity::Expert);
+
+        // Escaped on the way into the C++ literal, and back
+        const ConfigItem& quoted = values.items.at(3);
+        QCOMPARE(quoted.label, QString("Say \"hello\""));
+        QCOMPARE(quoted.description, QString("Back\\slash and a\ttab"));
+        QCOMPARE(quoted.defaultValue.toString(), QString("C:\\temp \"x\""));
+
+        const ConfigItem& choices = values.items.at(4);
+        QCOMPARE(choices.type, ConfigItemType::MultiSelection);
+        QCOMPARE(choices.defaultValue.toStringList(), QStringList({"a", "c"}));
+        QCOMPARE(choices.properties.value("options").toStringList(),
+                 QStringList({"a", "b", "c"}));
+
+        const ConfigItem& mapping = values.items.at(5);
+        QCOMPARE(mapping.defaultValue.toMap().value("x").toInt(), 1);
+        QCOMPARE(mapping.defaultValue.toMap().value("y").toString(), QString("two"));
+
+        const ConfigItem& token = values.items.at(6);
+        QVERIFY(!token.defaultValue.isValid());
+        QCOMPARE(token.icon, QString("Key"));
+        QCOMPARE(token.complexity, ConfigComplexity::Developer);
+        QVERIFY(token.required);
+        QVERIFY(token.readOnly);
+        QVERIFY(token.isSecret);
+    }
+
+    void schema_file_gives_the_same_page_as_the_descriptor() {
+        ConfigPage page;
+        QVERIFY(configPageFromSchemaFile(TEST_CONFIG_SCHEMA, &page));
+        QCOMPARE(page.toMap(), configPageFromDescriptor(schema::kTestPage).toMap());
+    }
+
+    void unreadable_or_invalid_schema_files_are_refused() {
+        ConfigPage page;
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Cannot read config schema"));
+        QVERIFY(!configPageFromSchemaFile("/nonexistent/config_schema.json", &page));
+
+        QTemporaryFile file;
+        QVERIFY(file.open());
+        file.write(R"({ "title": "No domain or extension" })");
+        file.flush();
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Invalid config schema"));
+        QVERIFY(!configPageFromSchemaFile(file.fileName(), &page));
+    }
+
+    void detached_page_shares_no_strings() {
+        const ConfigPage page = configPageFromDescriptor(schema::kTestPage);
+        const ConfigPage copy = detachedConfigPage(page);
+        QCOMPARE(copy.toMap(), page.toMap());
+        QVERIFY(copy.domain.constData() != page.domain.constData());
+        const ConfigItem& item = page.sections.at(0).items.at(3);
+        const ConfigItem& copied = copy.sections.at(0).items.at(3);
+        QVERIFY(copied.label.constData() != item.label.constData());
+        QCOMPARE(copied.defaultValue, item.defaultValue);
+    }
+};
+
+QTEST_MAIN(TestConfigDescriptor)
+#include "test_config_descriptor.moc"
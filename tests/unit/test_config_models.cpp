@@ -0,0 +1,278 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QAbstractItemModelTester>
+#include <QStandardPaths>
+#include <QtTest/QtTest>
+#include "core/config/ConfigManager.hpp"
+#include "core/config/ConfigTypes.hpp"
+#include "ui/ConfigManagerBridge.hpp"
+#include "ui/ConfigModels.hpp"
+
+using namespace opencardev::crankshaft::core::config;
+using namespace opencardev::crankshaft::ui;
+
+namespace {
+
+ConfigItem item(const QString& key, ConfigComplexity complexity, const QVariant& value) {
+    ConfigItem result;
+    result.key = key;
+    result.label = key;
+    result.type = ConfigItemType::Integer;
+    result.defaultValue = value;
+    result.complexity = complexity;
+    return result;
+}
+
+ConfigSection section(const QString& key, ConfigComplexity complexity,
+                      const QList<ConfigItem>& items) {
+    ConfigSection result;
+    result.key = key;
+    result.title = key;
+    result.complexity = complexity;
+    result.items = items;
+    return result;
+}
+
+ConfigPage page(const QString& domain, const QString& extension,
+                ConfigComplexity complexity = ConfigComplexity::Basic) {
+    ConfigPage result;
+    result.domain = domain;
+    result.extension = extension;
+    result.title = extension;
+    result.complexity = complexity;
+    result.sections = {
+        section("general", ConfigComplexity::Basic,
+                {item("volume", ConfigComplexity::Basic, 50),
+                 item("latency", ConfigComplexity::Expert, 20)}),
+        section("tuning", ConfigComplexity::Expert, {item("gain", ConfigComplexity::Basic, 3)}),
+    };
+    return result;
+}
+
+QStringList column(const QAbstractItemModel& model, int role) {
+    QStringList values;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        values.append(model.index(row, 0).data(role).toString());
+    }
+    return values;
+}
+
+// Item model behind one section row, unwrapped from its complexity filter
+QAbstractItemModel* itemsOf(const QAbstractItemModel& sections, int row) {
+    return qobject_cast<QAbstractItemModel*>(
+        sections.index(row, 0).data(ConfigSectionModel::ItemsRole).value<QObject*>());
+}
+
+}  // namespace
+
+class TestConfigModels : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase() {
+        // Keep values saved by the bridge test out of the user's configuration
+        QStandardPaths::setTestModeEnabled(true);
+    }
+
+    void page_model_keeps_system_pages_first() {
+        ConfigPageModel model;
+        QAbstractItemModelTester tester(&model,
+                                        QAbstractItemModelTester::FailureReportingMode::QtTest);
+
+        model.addOrUpdatePage(page("thirdparty", "weather"));
+        model.addOrUpdatePage(page("user interface", "theme"));
+        model.addOrUpdatePage(page("core", "media"));
+        model.addOrUpdatePage(page("system", "extensions"));
+        model.addOrUpdatePage(page("core", "bluetooth"));
+
+        QCOMPARE(column(model, ConfigPageModel::ExtensionRole),
+                 QStringList({"extensions", "theme", "bluetooth", "media", "weather"}));
+        // Sections are not part of the page list
+        QVERIFY(model.pageInfo("core", "media").sections.isEmpty());
+        QCOMPARE(model.pageInfo("core", "media").title, QString("media"));
+        QVERIFY(model.pageInfo("core", "missing").domain.isEmpty());
+    }
+
+    void page_model_updates_and_removes_rows_in_place() {
+        ConfigPageModel model;
+        QAbstractItemModelTester tester(&model,
+                                        QAbstractItemModelTester::FailureReportingMode::QtTest);
+        model.addOrUpdatePage(page("core", "media"));
+        model.addOrUpdatePage(page("core", "navigation"));
+
+        QSignalSpy resets(&model, &QAbstractItemModel::modelReset);
+        QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+        QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+        QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+
+        ConfigPage renamed = page("core", "navigation");
+        renamed.title = "Maps";
+        model.addOrUpdatePage(renamed);
+        QCOMPARE(model.rowCount(), 2);
+        QCOMPARE(inserted.count(), 0);
+        QCOMPARE(changed.count(), 1);
+        QCOMPARE(changed.at(0).at(0).toModelIndex().row(), 1);
+        QCOMPARE(model.index(1, 0).data(ConfigPageModel::TitleRole).toString(), QString("Maps"));
+
+        model.removePage("core", "media");
+        model.removePage("core", "missing");
+        QCOMPARE(removed.count(), 1);
+        QCOMPARE(column(model, ConfigPageModel::ExtensionRole), QStringList({"navigation"}));
+        QCOMPARE(resets.count(), 0);
+    }
+
+    void complexity_filter_hides_rows_above_the_level() {
+        ConfigPageModel pages;
+        ConfigComplexityFilterModel filter;
+        filter.setSourceModel(&pages);
+        QAbstractItemModelTester tester(&filter,
+                                        QAbstractItemModelTester::FailureReportingMode::QtTest);
+        QSignalSpy counts(&filter, &ConfigComplexityFilterModel::countChanged);
+
+        pages.addOrUpdatePage(page("core", "basic"));
+        pages.addOrUpdatePage(page("core", "expert", ConfigComplexity::Expert));
+        pages.addOrUpdatePage(page("core", "developer", ConfigComplexity::Developer));
+        QCOMPARE(filter.count(), 1);
+        QCOMPARE(filter.get(0).value("extension").toString(), QString("basic"));
+        QCOMPARE(filter.get(0).value("complexityName").toString(),
+                 configComplexityToString(ConfigComplexity::Basic));
+        QVERIFY(filter.get(1).isEmpty());
+
+        counts.clear();
+        filter.setComplexityLevel(static_cast<int>(ConfigComplexity::Expert));
+        QCOMPARE(filter.count(), 2);
+        QVERIFY(!counts.isEmpty());
+        QCOMPARE(column(filter, ConfigPageModel::ExtensionRole),
+                 QStringList({"basic", "expert"}));
+
+        // Pages added later are filtered as they arrive
+        pages.addOrUpdatePage(page("core", "advanced", ConfigComplexity::Advanced));
+        QCOMPARE(column(filter, ConfigPageModel::ExtensionRole),
+                 QStringList({"advanced", "basic", "expert"}));
+
+        filter.setComplexityLevel(static_cast<int>(ConfigComplexity::Basic));
+        QCOMPARE(column(filter, ConfigPageModel::ExtensionRole), QStringList({"basic"}));
+    }
+
+    void section_model_exposes_filtered_items() {
+        ConfigSectionModel sections;
+        ConfigComplexityFilterModel filter;
+        filter.setSourceModel(&sections);
+        QAbstractItemModelTester sectionTester(
+            &sections, QAbstractItemModelTester::FailureReportingMode::QtTest);
+        QAbstractItemModelTester filterTester(
+            &filter, QAbstractItemModelTester::FailureReportingMode::QtTest);
+
+        sections.setPage(page("core", "media"));
+        QCOMPARE(column(sections, ConfigSectionModel::KeyRole),
+                 QStringList({"general", "tuning"}));
+        QCOMPARE(column(filter, ConfigSectionModel::KeyRole), QStringList({"general"}));
+
+        QAbstractItemModel* items = itemsOf(sections, 0);
+        QVERIFY(items != nullptr);
+        QAbstractItemModelTester itemTester(
+            items, QAbstractItemModelTester::FailureReportingMode::QtTest);
+        QCOMPARE(column(*items, ConfigItemModel::KeyRole), QStringList({"volume"}));
+
+        sections.setComplexityLevel(static_cast<int>(ConfigComplexity::Expert));
+        QCOMPARE(column(*items, ConfigItemModel::KeyRole), QStringList({"volume", "latency"}));
+        const QVariantMap latency = items->index(1, 0).data(ConfigItemModel::ItemDataRole).toMap();
+        QCOMPARE(latency.value("key").toString(), QString("latency"));
+        QCOMPARE(items->index(1, 0).data(ConfigItemModel::ValueRole).toInt(), 20);
+    }
+
+    void section_model_patches_values_without_a_reset() {
+        ConfigSectionModel sections;
+        QAbstractItemModelTester tester(&sections,
+                                        QAbstractItemModelTester::FailureReportingMode::QtTest);
+        sections.setPage(page("core", "media"));
+        QAbstractItemModel* items = itemsOf(sections, 0);
+        QVERIFY(items != nullptr);
+        QAbstractItemModelTester itemTester(
+            items, QAbstractItemModelTester::FailureReportingMode::QtTest);
+
+        QSignalSpy sectionResets(&sections, &QAbstractItemModel::modelReset);
+        QSignalSpy itemResets(items, &QAbstractItemModel::modelReset);
+        QSignalSpy changed(items, &QAbstractItemModel::dataChanged);
+
+        QVERIFY(sections.updateValue("general", "volume", 75));
+        QCOMPARE(items->index(0, 0).data(ConfigItemModel::ValueRole).toInt(), 75);
+        QCOMPARE(items->index(0, 0).data(ConfigItemModel::DefaultValueRole).toInt(), 50);
+        QCOMPARE(changed.count(), 1);
+        const auto roles = changed.at(0).at(2).value<QList<int>>();
+        QVERIFY(roles.contains(ConfigItemModel::ValueRole));
+
+        QVERIFY(!sections.updateValue("general", "missing", 1));
+        QVERIFY(!sections.updateValue("missing", "volume", 1));
+        QCOMPARE(changed.count(), 1);
+        QCOMPARE(sectionResets.count(), 0);
+        QCOMPARE(itemResets.count(), 0);
+    }
+
+    void bridge_keeps_models_in_step_with_the_manager() {
+        ConfigManager manager;
+        manager.setComplexityLevel(ConfigComplexity::Basic);
+        ConfigManagerBridge::initialise(&manager);
+        ConfigManagerBridge* bridge = ConfigManagerBridge::instance();
+
+        auto* pages = qobject_cast<QAbstractItemModel*>(bridge->pagesModel());
+        QVERIFY(pages != nullptr);
+        QAbstractItemModelTester pageTester(
+            pages, QAbstractItemModelTester::FailureReportingMode::QtTest);
+
+        manager.registerConfigPage(page("core", "bridged"));
+        manager.resetToDefaults("core", "bridged");
+        QVERIFY(column(*pages, ConfigPageModel::ExtensionRole).contains("bridged"));
+
+        auto* sections =
+            qobject_cast<QAbstractItemModel*>(bridge->sectionsModel("core", "bridged"));
+        QVERIFY(sections != nullptr);
+        QVERIFY(bridge->sectionsModel("core", "bridged") == sections);
+        QAbstractItemModelTester sectionTester(
+            sections, QAbstractItemModelTester::FailureReportingMode::QtTest);
+        QCOMPARE(column(*sections, ConfigSectionModel::KeyRole), QStringList({"general"}));
+        QAbstractItemModel* items = itemsOf(*sections, 0);
+        QVERIFY(items != nullptr);
+
+        // A value change patches the item in place
+        QSignalSpy sectionResets(sections, &QAbstractItemModel::modelReset);
+        QVERIFY(manager.setValue("core", "bridged", "general", "volume", 90));
+        QCOMPARE(items->index(0, 0).data(ConfigItemModel::ValueRole).toInt(), 90);
+        QCOMPARE(sectionResets.count(), 0);
+
+        // Raising the level reveals expert sections and items without rebuilding
+        manager.setComplexityLevel(ConfigComplexity::Expert);
+        QCOMPARE(column(*sections, ConfigSectionModel::KeyRole),
+                 QStringList({"general", "tuning"}));
+        QCOMPARE(column(*items, ConfigItemModel::KeyRole), QStringList({"volume", "latency"}));
+        QCOMPARE(sectionResets.count(), 0);
+
+        // Unregistering drops the page and empties, but keeps, its section model
+        manager.unregisterConfigPage("core", "bridged");
+        QVERIFY(!column(*pages, ConfigPageModel::ExtensionRole).contains("bridged"));
+        QCOMPARE(sections->rowCount(), 0);
+        QVERIFY(bridge->sectionsModel("core", "bridged") == sections);
+
+        manager.setComplexityLevel(ConfigComplexity::Basic);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestConfigModels)
+#include "test_config_models.moc"
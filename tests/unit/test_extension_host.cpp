@@ -0,0 +1,301 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include "core/capabilities/CapabilityManager.hpp"
+#include "core/events/event_bus.hpp"
+#include "extensions/extension_manifest.hpp"
+#include "extensions/host/extension_host_proxy.hpp"
+#include "extensions/host/shared_ring.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace opencardev::crankshaft::extensions;
+using namespace opencardev::crankshaft::extensions::host;
+using opencardev::crankshaft::core::CapabilityManager;
+using opencardev::crankshaft::core::EventBus;
+
+namespace {
+
+QString ringName(const QString& suffix) {
+    return QString("/crankshaft-test-%1-%2").arg(QCoreApplication::applicationPid()).arg(suffix);
+}
+
+ExtensionManifest testPluginManifest(const QString& library = TEST_PLUGIN_PATH) {
+    ExtensionManifest manifest;
+    manifest.id = "test_plugin";
+    manifest.name = "Test plugin";
+    manifest.version = "1.0.0";
+    manifest.type = "service";
+    manifest.entry_point = QFileInfo(library).fileName();
+    manifest.requirements.required_permissions = {"event"};
+    return manifest;
+}
+
+// Run the event loop until the bus delivers the event, or timeout_ms passes
+bool waitForEvent(EventBus& bus, const QString& event_name, int timeout_ms,
+                  QVariantMap* data = nullptr) {
+    QEventLoop loop;
+    bool received = false;
+    const int subscription = bus.subscribe(event_name, [&](const QVariantMap& event_data) {
+        received = true;
+        if (data) {
+            *data = event_data;
+        }
+        loop.quit();
+    });
+    QTimer::singleShot(timeout_ms, &loop, &QEventLoop::quit);
+    if (!received) {
+        loop.exec();
+    }
+    bus.unsubscribe(subscription);
+    return received;
+}
+
+}  // namespace
+
+class TestExtensionHost : public QObject {
+    Q_OBJECT
+
+  private:
+    QTemporaryDir tempDir;
+
+  private slots:
+    void initTestCase() {
+        QVERIFY(tempDir.isValid());
+        qputenv("CRANKSHAFT_EXTENSION_HOST_BINARY", EXTENSION_HOST_PATH);
+    }
+
+    void ring_round_trips_records_in_order() {
+        SharedRing writer;
+        SharedRing reader;
+        QVERIFY(writer.create(ringName("order"), 4096));
+        QVERIFY(reader.open(ringName("order")));
+        writer.unlink();
+
+        bool wake = false;
+        for (int i = 0; i < 10; ++i) {
+            QVERIFY(writer.push(QByteArray::number(i), &wake));
+        }
+        for (int i = 0; i < 10; ++i) {
+            QByteArray record;
+            QVERIFY(reader.pop(&record));
+            QCOMPARE(record, QByteArray::number(i));
+        }
+        QByteArray record;
+        QVERIFY(!reader.pop(&record));
+    }
+
+    void ring_wraps_around_and_refuses_when_full() {
+        SharedRing writer;
+        SharedRing reader;
+        QVERIFY(writer.create(ringName("wrap"), 256));
+        QVERIFY(reader.open(ringName("wrap")));
+        writer.unlink();
+        bool wake = false;
+        QVERIFY(!writer.push(QByteArray(int(writer.maxRecordSize()) + 1, 'x'), &wake));
+
+        // Odd sizes move the wrap point around the data area
+        for (int i = 0; i < 500; ++i) {
+            const QByteArray sent(1 + i % int(writer.maxRecordSize()), char('a' + i % 26));
+            QVERIFY(writer.push(sent, &wake));
+            QByteArray received;
+            QVERIFY(reader.pop(&received));
+            QCOMPARE(received, sent);
+        }
+
+        int pushed = 0;
+        while (writer.push(QByteArray(40, 'f'), &wake)) {
+            ++pushed;
+        }
+        QVERIFY(pushed > 0);
+        QByteArray received;
+        QVERIFY(reader.pop(&received));
+        QVERIFY(writer.push(QByteArray(40, 'f'), &wake));
+    }
+
+    void ring_with_a_corrupt_record_is_dead() {
+        SharedRing writer;
+        SharedRing reader;
+        QVERIFY(writer.create(ringName("corrupt"), 4096));
+        QVERIFY(reader.open(ringName("corrupt")));
+        bool wake = false;
+        QVERIFY(writer.push("hello", &wake));
+
+        // A misbehaving peer overwrites the first record's size; data starts 256 bytes in
+        const int fd = shm_open(ringName("corrupt").toLocal8Bit().constData(), O_RDWR, 0);
+        QVERIFY(fd >= 0);
+        void* memory = mmap(nullptr, 256 + 4096, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        QVERIFY(memory != MAP_FAILED);
+        const quint32 size = 0x7fffffff;
+        std::memcpy(static_cast<char*>(memory) + 256, &size, 4);
+        munmap(memory, 256 + 4096);
+        writer.unlink();
+
+        // The reader gives up instead of spinning on the record
+        QByteArray record;
+        QVERIFY(!reader.pop(&record));
+        QVERIFY(reader.isDead());
+        QVERIFY(reader.sleep());
+        QVERIFY(writer.push("again", &wake));
+        QVERIFY(!reader.pop(&record));
+    }
+
+    void ring_wakes_a_sleeping_reader_once() {
+        SharedRing writer;
+        SharedRing reader;
+        QVERIFY(writer.create(ringName("wake"), 4096));
+        QVERIFY(reader.open(ringName("wake")));
+        writer.unlink();
+
+        // A new ring's reader starts asleep
+        bool wake = false;
+        QVERIFY(writer.push("first", &wake));
+        QVERIFY(wake);
+        QVERIFY(writer.push("second", &wake));
+        QVERIFY(!wake);
+
+        QByteArray record;
+        QVERIFY(reader.pop(&record));
+        QVERIFY(!reader.sleep());  // "second" is still pending
+        QVERIFY(reader.pop(&record));
+        QVERIFY(reader.sleep());
+        QVERIFY(writer.push("third", &wake));
+        QVERIFY(wake);
+    }
+
+    void hosted_extension_exchanges_events_with_the_core() {
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        mgr.setExtensionPermissions("test_plugin", {"event"});
+        ExtensionHostProxy proxy(testPluginManifest(), tempDir.path(), TEST_PLUGIN_PATH, &mgr);
+        proxy.grantCapability(mgr.grantCapability("test_plugin", "event"));
+
+        QVERIFY(proxy.initialize());
+        QVERIFY(proxy.hostPid() != QCoreApplication::applicationPid());
+        proxy.start();
+        QVERIFY(waitForEvent(bus, "test_plugin.started", 5000));
+
+        constexpr int kRoundTrips = 1000;
+        QElapsedTimer clock;
+        clock.start();
+        for (int i = 0; i < kRoundTrips; ++i) {
+            QVariantMap pong;
+            bus.publish("test_plugin.ping", {{"n", i}});
+            QVERIFY(waitForEvent(bus, "test_plugin.pong", 1000, &pong));
+            QCOMPARE(pong.value("n").toInt(), i);
+        }
+        const double round_trip_us = clock.nsecsElapsed() / 1000.0 / kRoundTrips;
+
+        QVERIFY(proxy.ping(1000));
+        const ExtensionHostProxy::TransportStats stats = proxy.transportStats();
+        QCOMPARE(stats.events_to_host, quint64(kRoundTrips));
+        QCOMPARE(stats.events_from_host, quint64(kRoundTrips + 1));
+        QCOMPARE(stats.events_dropped, quint64(0));
+        qInfo().noquote() << QString("Round trip %1 us; ring latency to host %2 us (max %3), "
+                                     "from host %4 us (max %5)")
+                                 .arg(round_trip_us, 0, 'f', 1)
+                                 .arg(stats.to_host_mean_ns / 1000.0, 0, 'f', 1)
+                                 .arg(stats.to_host_max_ns / 1000.0, 0, 'f', 1)
+                                 .arg(stats.from_host_mean_ns / 1000.0, 0, 'f', 1)
+                                 .arg(stats.from_host_max_ns / 1000.0, 0, 'f', 1);
+        // Loose bound for loaded CI machines; the target is well under 100 us
+        QVERIFY(stats.to_host_mean_ns < 2000000);
+        QVERIFY(stats.from_host_mean_ns < 2000000);
+
+        proxy.stop();
+        proxy.cleanup();
+        QCOMPARE(proxy.hostPid(), qint64(0));
+    }
+
+    void crashed_host_is_restarted() {
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        mgr.setExtensionPermissions("test_plugin", {"event"});
+        ExtensionHostProxy proxy(testPluginManifest(TEST_CRASHING_PLUGIN_PATH), tempDir.path(),
+                                 TEST_CRASHING_PLUGIN_PATH, &mgr);
+        proxy.grantCapability(mgr.grantCapability("test_plugin", "event"));
+        QSignalSpy crashes(&proxy, &ExtensionHostProxy::hostCrashed);
+
+        QVERIFY(proxy.initialize());
+        proxy.start();
+        QVERIFY(waitForEvent(bus, "test_plugin.started", 5000));
+        const qint64 first_pid = proxy.hostPid();
+
+        // The core survives the extension taking its process down
+        bus.publish("test_plugin.crash");
+        QVERIFY(waitForEvent(bus, "test_plugin.started", 10000));
+        QCOMPARE(crashes.count(), 1);
+        QCOMPARE(crashes.at(0).at(0).toString(), QString("test_plugin"));
+        QCOMPARE(crashes.at(0).at(2).toBool(), true);
+        QVERIFY(proxy.hostPid() != first_pid);
+        QCOMPARE(proxy.transportStats().restarts, 1);
+
+        QVariantMap pong;
+        bus.publish("test_plugin.ping", {{"n", 7}});
+        QVERIFY(waitForEvent(bus, "test_plugin.pong", 1000, &pong));
+        QCOMPARE(pong.value("n").toInt(), 7);
+
+        proxy.cleanup();
+    }
+
+    void host_follows_core_policy_and_reports_back() {
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        mgr.setExtensionPermissions("test_plugin", {"event"});
+        ExtensionHostProxy proxy(testPluginManifest(), tempDir.path(), TEST_PLUGIN_PATH, &mgr);
+        proxy.grantCapability(mgr.grantCapability("test_plugin", "event"));
+        mgr.setRevocationListener([&proxy](const QString&, const QString& capability_type) {
+            proxy.revokeInHost(capability_type);
+        });
+        QVERIFY(proxy.initialize());
+
+        const auto count = [&mgr](const QString& action) {
+            int n = 0;
+            for (const QVariantMap& entry : mgr.getAuditLog("test_plugin", 0)) {
+                n += entry.value("capability_type") == "event" && entry.value("action") == action;
+            }
+            return n;
+        };
+        // The host's own grant comes back with the next ping; Report precedes Pong
+        QVERIFY(proxy.ping(1000));
+        QCOMPARE(count("granted"), 2);
+
+        // An override in the core revokes the capability in both processes
+        mgr.setPolicyOverride("test_plugin", {}, {"event"});
+        proxy.reconfigure();
+        QVERIFY(proxy.ping(1000));
+        QCOMPARE(count("revoked"), 2);
+
+        mgr.setRevocationListener({});
+        proxy.cleanup();
+    }
+};
+
+QTEST_MAIN(TestExtensionHost)
+#include "test_extension_host.moc"
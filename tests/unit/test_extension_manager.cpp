@@ -20,11 +20,68 @@
 #include <QtTest/QtTest>
 #include <QFile>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QTemporaryDir>
+#include <QThread>
+#include "core/capabilities/CapabilityManager.hpp"
+#include "core/capabilities/EventCapability.hpp"
+#include "core/capabilities/LocationCapability.hpp"
+#include "core/capabilities/TokenCapabilityImpl.hpp"
+#include "core/config/ConfigManager.hpp"
+#include "core/events/event_bus.hpp"
 #include "extensions/extension_manager.hpp"
 #include "extensions/extension_manifest.hpp"
 
 using namespace opencardev::crankshaft::extensions;
+using opencardev::crankshaft::core::CapabilityManager;
+using opencardev::crankshaft::core::EventBus;
+using namespace opencardev::crankshaft::core::config;
+
+namespace {
+
+// Built-in stand-in whose initialize() takes a while and may fail
+class SlowExtension : public Extension {
+  public:
+    SlowExtension(const QString& id, int init_ms, bool concurrent, bool succeeds = true)
+        : id_(id), init_ms_(init_ms), concurrent_(concurrent), succeeds_(succeeds) {}
+
+    bool initialize() override {
+        QThread::msleep(init_ms_);
+        initialised_on_main_ = QThread::currentThread() == qApp->thread();
+        ++initialize_calls_;
+        if (on_initialize_) {
+            on_initialize_();
+        }
+        return succeeds_;
+    }
+    void start() override { started_ = true; }
+    void stop() override {}
+    void cleanup() override {}
+    bool supportsConcurrentInitialize() const override { return concurrent_; }
+
+    template <typename T>
+    std::shared_ptr<T> capability() const {
+        return getCapability<T>();
+    }
+
+    QString id() const override { return id_; }
+    QString name() const override { return id_; }
+    QString version() const override { return "1.0.0"; }
+    ExtensionType type() const override { return ExtensionType::Service; }
+
+    bool started_ = false;
+    bool initialised_on_main_ = false;
+    int initialize_calls_ = 0;
+    std::function<void()> on_initialize_;
+
+  private:
+    QString id_;
+    int init_ms_;
+    bool concurrent_;
+    bool succeeds_;
+};
+
+}  // namespace
 
 class TestExtensionManager : public QObject {
     Q_OBJECT
@@ -32,7 +89,9 @@ class TestExtensionManager : public QObject {
 private:
     QTemporaryDir tempDir;
 
-    void createExtensionManifest(const QString& id, const QStringList& deps = QStringList()) {
+    void createExtensionManifest(const QString& id, const QStringList& deps = QStringList(),
+                                 const QString& activationJson = QString(),
+                                 const QStringList& permissions = QStringList()) {
         QString extPath = tempDir.path() + "/extensions/" + id;
         QDir().mkpath(extPath);
         
@@ -45,20 +104,51 @@ private:
             if (i < deps.size() - 1) depsJson += ",";
         }
         
+        QStringList quotedPermissions;
+        for (const QString& permission : permissions) {
+            quotedPermissions << QString("\"%1\"").arg(permission);
+        }
+
         QString json = QString(
             "{\n"
             "  \"id\": \"%1\",\n"
             "  \"name\": \"%1 Test\",\n"
             "  \"version\": \"1.0.0\",\n"
             "  \"dependencies\": [%2],\n"
-            "  \"requirements\": { \"required_permissions\": [] }\n"
+            "  %3"
+            "  \"requirements\": { \"required_permissions\": [%4] }\n"
             "}"
-        ).arg(id, depsJson);
+        ).arg(id, depsJson,
+              activationJson.isEmpty() ? QString() : "\"activation\": " + activationJson + ",\n",
+              quotedPermissions.join(","));
         
         f.write(json.toUtf8());
         f.close();
     }
 
+    QString createPluginManifest(const QString& id, const QString& entryPoint,
+                                 const QString& minCoreVersion) {
+        const QString extPath = tempDir.path() + "/plugins/" + id;
+        QDir().mkpath(extPath);
+        QFile f(extPath + "/manifest.json");
+        if (!f.open(QIODevice::WriteOnly)) {
+            return QString();
+        }
+        f.write(QString("{\n"
+                        "  \"id\": \"%1\",\n"
+                        "  \"name\": \"%1 Test\",\n"
+                        "  \"version\": \"1.0.0\",\n"
+                        "  \"entry_point\": \"%2\",\n"
+                        "  \"requirements\": {\n"
+                        "    \"min_core_version\": \"%3\",\n"
+                        "    \"required_permissions\": [\"event\"]\n"
+                        "  }\n"
+                        "}")
+                    .arg(id, entryPoint, minCoreVersion)
+                    .toUtf8());
+        return extPath;
+    }
+
 private slots:
     void initTestCase() {
         QVERIFY(tempDir.isValid());
@@ -170,6 +260,411 @@ private slots:
         }
         QVERIFY(cycleErrors >= 2);
     }
+
+    void test_built_ins_initialise_concurrently_by_level() {
+        QDir extDir(tempDir.path() + "/extensions");
+        extDir.removeRecursively();
+        QDir().mkpath(tempDir.path() + "/extensions");
+
+        createExtensionManifest("pool_a");
+        createExtensionManifest("pool_b");
+        createExtensionManifest("pool_dep", {"pool_a"});
+        const QString root = tempDir.path() + "/extensions/";
+
+        auto a = std::make_shared<SlowExtension>("pool_a", 100, true);
+        auto b = std::make_shared<SlowExtension>("pool_b", 100, true);
+        auto dep = std::make_shared<SlowExtension>("pool_dep", 10, false);
+
+        ExtensionManager mgr;
+        QSignalSpy loadedSpy(&mgr, &ExtensionManager::extensionLoaded);
+        QElapsedTimer timer;
+        timer.start();
+        // Dependent registered first: levels, not registration order, decide
+        QCOMPARE(mgr.registerBuiltInExtensions({{dep, root + "pool_dep"},
+                                                {a, root + "pool_a"},
+                                                {b, root + "pool_b"}}),
+                 3);
+        // Both 100 ms initialisers overlap on the pool
+        QVERIFY(timer.elapsed() < 190);
+
+        QVERIFY(a->started_ && b->started_ && dep->started_);
+        QVERIFY(!a->initialised_on_main_);
+        QVERIFY(dep->initialised_on_main_);
+        QCOMPARE(loadedSpy.count(), 3);
+
+        QHash<QString, QVariantMap> spans;
+        for (const QVariant& value : mgr.startupTimeline()) {
+            spans.insert(value.toMap()["id"].toString(), value.toMap());
+        }
+        QCOMPARE(spans.size(), 3);
+        QCOMPARE(spans["pool_a"]["level"].toInt(), 0);
+        QCOMPARE(spans["pool_b"]["level"].toInt(), 0);
+        QCOMPARE(spans["pool_dep"]["level"].toInt(), 1);
+        QVERIFY(spans["pool_a"]["concurrent"].toBool());
+        QVERIFY(!spans["pool_dep"]["concurrent"].toBool());
+        QVERIFY(spans["pool_dep"]["init_start_ms"].toLongLong() >=
+                spans["pool_a"]["init_start_ms"].toLongLong() +
+                    spans["pool_a"]["init_ms"].toLongLong());
+    }
+
+    void test_failed_built_in_is_removed() {
+        QDir extDir(tempDir.path() + "/extensions");
+        extDir.removeRecursively();
+        QDir().mkpath(tempDir.path() + "/extensions");
+
+        createExtensionManifest("good_ext");
+        createExtensionManifest("bad_ext");
+        const QString root = tempDir.path() + "/extensions/";
+
+        auto good = std::make_shared<SlowExtension>("good_ext", 0, true);
+        auto bad = std::make_shared<SlowExtension>("bad_ext", 0, true, false);
+
+        ExtensionManager mgr;
+        QSignalSpy errorSpy(&mgr, &ExtensionManager::extensionError);
+        QCOMPARE(mgr.registerBuiltInExtensions({{good, root + "good_ext"},
+                                                {bad, root + "bad_ext"}}),
+                 1);
+
+        QCOMPARE(errorSpy.count(), 1);
+        QCOMPARE(errorSpy.first().at(0).toString(), QString("bad_ext"));
+        QVERIFY(mgr.getLoadedExtensions().contains("good_ext"));
+        QVERIFY(!mgr.getLoadedExtensions().contains("bad_ext"));
+        QVERIFY(!bad->started_);
+    }
+
+    void test_deferred_built_in_activates_on_first_event() {
+        QDir extDir(tempDir.path() + "/extensions");
+        extDir.removeRecursively();
+        QDir().mkpath(tempDir.path() + "/extensions");
+
+        createExtensionManifest("lazy_ext", {}, "{ \"events\": [\"*.lazy.wake\"] }");
+        const QString root = tempDir.path() + "/extensions/";
+
+        EventBus bus;
+        CapabilityManager caps(&bus, nullptr);
+        ExtensionManager mgr;
+        mgr.initialize(&caps, nullptr);
+
+        auto lazy = std::make_shared<SlowExtension>("lazy_ext", 0, false);
+        int wakeups = 0;
+        lazy->on_initialize_ = [&]() {
+            bus.subscribe("*.lazy.wake", [&](const QVariantMap&) { ++wakeups; });
+        };
+        QCOMPARE(mgr.registerBuiltInExtensions({{lazy, root + "lazy_ext"}}), 1);
+        QVERIFY(mgr.isLoaded("lazy_ext"));
+        QVERIFY(mgr.isActivationPending("lazy_ext"));
+        QCOMPARE(lazy->initialize_calls_, 0);
+
+        bus.publish("other.unrelated");
+        QVERIFY(mgr.isActivationPending("lazy_ext"));
+
+        // The triggering event reaches the subscription made during activation
+        bus.publish("ui.lazy.wake");
+        QVERIFY(!mgr.isActivationPending("lazy_ext"));
+        QVERIFY(lazy->started_);
+        QCOMPARE(wakeups, 1);
+
+        bus.publish("ui.lazy.wake");
+        QCOMPARE(lazy->initialize_calls_, 1);
+        QCOMPARE(wakeups, 2);
+    }
+
+    void test_deferred_concurrent_built_in_initialises_on_the_pool() {
+        QDir extDir(tempDir.path() + "/extensions");
+        extDir.removeRecursively();
+        QDir().mkpath(tempDir.path() + "/extensions");
+
+        createExtensionManifest("lazy_pool", {}, "{ \"events\": [\"*.pool.wake\"] }");
+        const QString root = tempDir.path() + "/extensions/";
+
+        EventBus bus;
+        CapabilityManager caps(&bus, nullptr);
+        ExtensionManager mgr;
+        mgr.initialize(&caps, nullptr);
+
+        auto lazy = std::make_shared<SlowExtension>("lazy_pool", 100, true);
+        QCOMPARE(mgr.registerBuiltInExtensions({{lazy, root + "lazy_pool"}}), 1);
+        QVERIFY(mgr.isActivationPending("lazy_pool"));
+
+        // The main thread keeps serving events while the extension initialises
+        int ticks = 0;
+        QTimer ticker;
+        connect(&ticker, &QTimer::timeout, [&]() { ++ticks; });
+        ticker.start(10);
+        // Asked for again from an event served meanwhile: waits rather than racing it
+        bool reentered = false;
+        QTimer::singleShot(20, [&]() { reentered = mgr.activateExtension("lazy_pool"); });
+
+        bus.publish("ui.pool.wake");
+        QVERIFY(!mgr.isActivationPending("lazy_pool"));
+        QVERIFY(!lazy->initialised_on_main_);
+        QVERIFY(lazy->started_);
+        QVERIFY(ticks > 0);
+        QVERIFY(reentered);
+        QCOMPARE(lazy->initialize_calls_, 1);
+    }
+
+    void test_capability_request_activates_provider_and_dependencies() {
+        QDir extDir(tempDir.path() + "/extensions");
+        extDir.removeRecursively();
+        QDir().mkpath(tempDir.path() + "/extensions");
+
+        createExtensionManifest("lazy_base", {}, "{ \"prewarm_after_ms\": 60000 }");
+        createExtensionManifest("provider", {"lazy_base"},
+                                "{ \"capabilities\": [\"test.widget\"] }");
+        const QString root = tempDir.path() + "/extensions/";
+
+        EventBus bus;
+        CapabilityManager caps(&bus, nullptr);
+        ExtensionManager mgr;
+        mgr.initialize(&caps, nullptr);
+
+        auto base = std::make_shared<SlowExtension>("lazy_base", 0, false);
+        auto provider = std::make_shared<SlowExtension>("provider", 0, false);
+        provider->on_initialize_ = [&]() {
+            caps.registerCapabilityFactory("test.widget", [&](const QString& id,
+                                                              const QVariantMap&) {
+                return caps.grantCapability(id, "event");
+            });
+        };
+        QCOMPARE(mgr.registerBuiltInExtensions({{provider, root + "provider"},
+                                                {base, root + "lazy_base"}}),
+                 2);
+        QVERIFY(mgr.isActivationPending("provider"));
+        QVERIFY(mgr.isActivationPending("lazy_base"));
+
+        // Without the permission the request neither activates nor succeeds
+        QVERIFY(!caps.grantCapability("consumer", "test.widget"));
+        QVERIFY(mgr.isActivationPending("provider"));
+
+        caps.setExtensionPermissions("consumer", {"test.widget", "event"});
+        QVERIFY(caps.grantCapability("consumer", "test.widget"));
+        QVERIFY(!mgr.isActivationPending("provider"));
+        QVERIFY(!mgr.isActivationPending("lazy_base"));
+        QVERIFY(base->started_ && provider->started_);
+    }
+
+    void test_capability_slots_follow_grants_and_revocation() {
+        QDir extDir(tempDir.path() + "/extensions");
+        extDir.removeRecursively();
+        QDir().mkpath(tempDir.path() + "/extensions");
+        createExtensionManifest("slotted", {}, QString(), {"event", "contacts"});
+
+        using namespace opencardev::crankshaft::core::capabilities;
+        EventBus bus;
+        CapabilityManager caps(&bus, nullptr);
+        ExtensionManager mgr;
+        mgr.initialize(&caps, nullptr);
+
+        auto ext = std::make_shared<SlowExtension>("slotted", 0, false);
+        QCOMPARE(mgr.registerBuiltInExtensions({{ext, tempDir.path() + "/extensions/slotted"}}),
+                 1);
+
+        // Built-in interfaces come from their slot, other types from the scan
+        const auto events = ext->capability<EventCapability>();
+        QVERIFY(events);
+        QVERIFY(std::static_pointer_cast<Capability>(events) ==
+                caps.grantCapability("slotted", "event"));
+        QVERIFY(ext->capability<TokenCapabilityImpl>());
+        QVERIFY(!ext->capability<LocationCapability>());
+
+        caps.revokeCapability("slotted", "event");
+        QVERIFY(!events->isValid());
+        QVERIFY(!ext->capability<EventCapability>());
+        QVERIFY(!ext->hasCapability("event"));
+        QVERIFY(ext->capability<TokenCapabilityImpl>());
+
+        caps.revokeAllCapabilities("slotted");
+        QVERIFY(!ext->capability<TokenCapabilityImpl>());
+        QVERIFY(!ext->hasCapability("contacts"));
+    }
+
+    void test_policy_overrides_follow_config() {
+        // Keep the saved page out of the user's own config
+        qputenv("XDG_CONFIG_HOME", (tempDir.path() + "/config").toUtf8());
+        ConfigManager config;
+        ConfigItem overrides;
+        overrides.key = "overrides";
+        overrides.type = ConfigItemType::Custom;
+        overrides.defaultValue = QVariantMap();
+        ConfigSection permissions;
+        permissions.key = "permissions";
+        permissions.items << overrides;
+        ConfigPage page;
+        page.domain = "system";
+        page.extension = "extensions";
+        page.sections << permissions;
+        config.registerConfigPage(page);
+        QVERIFY(config.setValue(
+            "system", "extensions", "permissions", "overrides",
+            QVariantMap{{"policy_ext", QVariantMap{{"allow", QStringList{"network"}}}}}));
+
+        EventBus bus;
+        CapabilityManager caps(&bus, nullptr);
+        ExtensionManager mgr;
+        mgr.initialize(&caps, &config);
+        caps.setExtensionPermissions("policy_ext", {"event"});
+        QVERIFY(caps.hasPermission("policy_ext", "network"));
+        QVERIFY(caps.hasPermission("policy_ext", "event.wildcard"));
+
+        // A changed setting replaces the overrides; the one for policy_ext is dropped
+        QVERIFY(config.setValue(
+            "system", "extensions", "permissions", "overrides",
+            QVariantMap{{"*", QVariantMap{{"deny", QStringList{"event.wildcard"}}}}}));
+        QVERIFY(!caps.hasPermission("policy_ext", "network"));
+        QVERIFY(!caps.hasPermission("policy_ext", "event.wildcard"));
+        QVERIFY(caps.hasPermission("policy_ext", "event"));
+
+        QVERIFY(config.setValue("system", "extensions", "permissions", "overrides",
+                                QVariantMap()));
+        QVERIFY(caps.hasPermission("policy_ext", "event.wildcard"));
+    }
+
+    void test_plugin_requiring_newer_core_is_refused() {
+        const QString path = createPluginManifest("future_ext", TEST_PLUGIN_PATH, "99.0.0");
+        ExtensionManager mgr;
+        QSignalSpy errorSpy(&mgr, &ExtensionManager::extensionError);
+
+        QVERIFY(!mgr.loadExtension(path));
+        QVERIFY(!mgr.isLoaded("future_ext"));
+        QCOMPARE(errorSpy.count(), 1);
+    }
+
+    void test_plugin_with_missing_library_is_refused() {
+        const QString path = createPluginManifest("missing_ext", "missing_ext.so", "1.0.0");
+        ExtensionManager mgr;
+
+        QVERIFY(!mgr.loadExtension(path));
+        QVERIFY(!mgr.isLoaded("missing_ext"));
+    }
+
+    void test_plugin_is_unloaded_when_disabled() {
+        const QString path = createPluginManifest("test_plugin", TEST_PLUGIN_PATH, "1.0.0");
+        EventBus bus;
+        CapabilityManager caps(&bus, nullptr);
+        ExtensionManager mgr;
+        mgr.initialize(&caps, nullptr);
+
+        QList<int> starts;
+        bus.subscribe("test_plugin.started",
+                      [&](const QVariantMap& data) { starts << data.value("instances").toInt(); });
+
+        QVERIFY(mgr.loadExtension(path));
+        QCOMPARE(starts, QList<int>{1});
+        QVERIFY(caps.hasCapability("test_plugin", "event"));
+
+        QVERIFY(mgr.disableExtension("test_plugin"));
+        QVERIFY(mgr.isLoaded("test_plugin"));
+        QVERIFY(!caps.hasCapability("test_plugin", "event"));
+
+        // The library was unloaded, so its static data starts over
+        QVERIFY(mgr.enableExtension("test_plugin"));
+        QCOMPARE(starts, (QList<int>{1, 1}));
+        QVERIFY(mgr.unloadExtension("test_plugin"));
+        QVERIFY(!mgr.isLoaded("test_plugin"));
+    }
+
+    void test_plugin_config_page_outlives_the_library() {
+        qputenv("XDG_CONFIG_HOME", (tempDir.path() + "/config").toUtf8());
+        const QString path = createPluginManifest("test_plugin", TEST_PLUGIN_PATH, "1.0.0");
+        EventBus bus;
+        CapabilityManager caps(&bus, nullptr);
+        ConfigManager config;
+        ExtensionManager mgr;
+        mgr.initialize(&caps, &config);
+
+        QVERIFY(mgr.loadExtension(path));
+        QVERIFY(config.hasConfigPage("test", "test_plugin"));
+
+        // Disabling unloads the library; its settings stay listed and readable
+        QVERIFY(mgr.disableExtension("test_plugin"));
+        QVERIFY(config.hasConfigPage("test", "test_plugin"));
+        QCOMPARE(config.getConfigPage("test", "test_plugin").title, QString("Test plugin"));
+        QCOMPARE(config.getValue("test", "test_plugin", "general", "greeting").toString(),
+                 QString("hello"));
+        QVERIFY(mgr.unloadExtension("test_plugin"));
+    }
+
+    void test_lazy_plugin_config_page_comes_from_its_schema() {
+        qputenv("XDG_CONFIG_HOME", (tempDir.path() + "/config").toUtf8());
+        const QString extPath = tempDir.path() + "/builtin/schema_ext";
+        QDir().mkpath(extPath);
+        QFile manifest(extPath + "/manifest.json");
+        QVERIFY(manifest.open(QIODevice::WriteOnly));
+        manifest.write(QString("{\n"
+                               "  \"id\": \"test_plugin\",\n"
+                               "  \"name\": \"Schema Test\",\n"
+                               "  \"version\": \"1.0.0\",\n"
+                               "  \"entry_point\": \"%1\",\n"
+                               "  \"config_schema\": \"config_schema.json\",\n"
+                               "  \"activation\": { \"events\": [\"test_plugin.wake\"] }\n"
+                               "}")
+                           .arg(TEST_PLUGIN_PATH)
+                           .toUtf8());
+        manifest.close();
+        QFile schema(extPath + "/config_schema.json");
+        QVERIFY(schema.open(QIODevice::WriteOnly));
+        schema.write(R"({
+          "domain": "test", "extension": "test_plugin", "title": "Test plugin",
+          "sections": [ { "key": "general", "title": "General", "items": [
+            { "key": "greeting", "label": "Greeting", "type": "string", "default": "hello" },
+            { "key": "volume", "label": "Volume", "type": "integer",
+              "properties": { "minValue": 0, "maxValue": 10 }, "default": 5 } ] } ]
+        })");
+        schema.close();
+
+        EventBus bus;
+        CapabilityManager caps(&bus, nullptr);
+        ConfigManager config;
+        ExtensionManager mgr;
+        mgr.initialize(&caps, &config);
+        QCOMPARE(mgr.registerBuiltInExtensions({{nullptr, extPath}}), 1);
+
+        // Listed before anything loads the library
+        QVERIFY(mgr.isActivationPending("test_plugin"));
+        QVERIFY(config.hasConfigPage("test", "test_plugin"));
+        QCOMPARE(config.getValue("test", "test_plugin", "general", "volume").toInt(), 5);
+        const ConfigItem volume =
+            config.getConfigPage("test", "test_plugin").sections.first().items.last();
+        QCOMPARE(volume.type, ConfigItemType::Integer);
+        QCOMPARE(volume.properties.value("maxValue").toInt(), 10);
+
+        bus.publish("test_plugin.wake");
+        QVERIFY(!mgr.isActivationPending("test_plugin"));
+        QCOMPARE(config.getValue("test", "test_plugin", "general", "greeting").toString(),
+                 QString("hello"));
+        QVERIFY(mgr.unloadExtension("test_plugin"));
+    }
+
+    void test_disabled_plugin_receives_no_events() {
+        const QString path = createPluginManifest("test_plugin", TEST_PLUGIN_PATH, "1.0.0");
+        EventBus bus;
+        CapabilityManager caps(&bus, nullptr);
+        ExtensionManager mgr;
+        mgr.initialize(&caps, nullptr);
+
+        // Subscribed first, so their bus ids match the plugin's own subscription ids
+        int starts = 0;
+        int pongs = 0;
+        bus.subscribe("test_plugin.started", [&](const QVariantMap&) { ++starts; });
+        bus.subscribe("test_plugin.pong", [&](const QVariantMap&) { ++pongs; });
+
+        QVERIFY(mgr.loadExtension(path));
+        bus.publish("test_plugin.ping");
+        QCOMPARE(pongs, 1);
+
+        // Its callbacks went with the library; delivering to them would crash
+        QVERIFY(mgr.disableExtension("test_plugin"));
+        bus.publish("test_plugin.ping");
+        QCOMPARE(pongs, 1);
+
+        // Other subscribers are untouched
+        bus.publish("test_plugin.started");
+        bus.publish("test_plugin.pong");
+        QCOMPARE(starts, 2);
+        QCOMPARE(pongs, 2);
+        QVERIFY(mgr.unloadExtension("test_plugin"));
+    }
 };
 
 QTEST_MAIN(TestExtensionManager)
@@ -0,0 +1,156 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QtTest/QtTest>
+#include <QFile>
+#include <QTemporaryDir>
+#include "core/capabilities/CapabilityManager.hpp"
+#include "core/events/event_bus.hpp"
+
+using namespace opencardev::crankshaft::core;
+using namespace opencardev::crankshaft::core::capabilities;
+
+namespace {
+
+using AccessHint = FileSystemCapability::AccessHint;
+
+void write(const QString& path, const QByteArray& data) {
+    QFile f(path);
+    QVERIFY(f.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(f.write(data), qint64(data.size()));
+}
+
+QByteArray pattern(int size) {
+    QByteArray data(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i) {
+        data[i] = char(i * 31 % 251);
+    }
+    return data;
+}
+
+}  // namespace
+
+class TestFileSystemMap : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void init() {
+        QVERIFY(dir_.isValid());
+        mgr_ = std::make_unique<CapabilityManager>(&bus_, nullptr);
+        mgr_->setExtensionPermissions("maps", {"filesystem"});
+        files_ = std::dynamic_pointer_cast<FileSystemCapability>(
+            mgr_->grantCapability("maps", "filesystem", {{"scope_path", dir_.path()}}));
+        QVERIFY(files_);
+    }
+
+    void cleanup() {
+        files_.reset();
+        mgr_.reset();
+    }
+
+    void mapping_shows_the_file_contents() {
+        const QByteArray data = pattern(3 * 4096 + 123);
+        write(dir_.filePath("tile.bin"), data);
+
+        const auto region = files_->mapFile("tile.bin", AccessHint::Sequential);
+        QVERIFY(region);
+        QVERIFY(region->isValid());
+        QCOMPARE(region->size(), qint64(data.size()));
+        QCOMPARE(QByteArray::fromRawData(reinterpret_cast<const char*>(region->data()),
+                                         int(region->size())),
+                 data);
+
+#ifdef Q_OS_UNIX
+        QVERIFY(region->advise(AccessHint::Random));
+        // Unaligned ranges are widened to the page they start in
+        QVERIFY(region->advise(AccessHint::WillNeed, 4097, 100));
+#endif
+        QVERIFY(!region->advise(AccessHint::Normal, data.size()));
+        QVERIFY(!region->advise(AccessHint::Normal, -1));
+    }
+
+    void mapping_is_the_page_cache_not_a_copy() {
+        write(dir_.filePath("live.bin"), QByteArray(4096, 'a'));
+        const auto region = files_->mapFile("live.bin");
+        QVERIFY(region);
+        QCOMPARE(char(region->data()[10]), 'a');
+
+        // A later write to the file shows through the existing mapping
+        QFile f(dir_.filePath("live.bin"));
+        QVERIFY(f.open(QIODevice::ReadWrite));
+        QVERIFY(f.seek(10));
+        QCOMPARE(f.write("b", 1), qint64(1));
+        f.close();
+        QCOMPARE(char(region->data()[10]), 'b');
+    }
+
+    void empty_missing_and_outside_files() {
+        write(dir_.filePath("empty.bin"), QByteArray());
+        const auto empty = files_->mapFile("empty.bin");
+        QVERIFY(empty);
+        QVERIFY(empty->isValid());
+        QCOMPARE(empty->size(), qint64(0));
+        QVERIFY(!empty->advise(AccessHint::WillNeed));
+
+        QVERIFY(!files_->mapFile("missing.bin"));
+        QVERIFY(!files_->mapFile("../outside.bin"));
+        QVERIFY(!files_->mapFile("/etc/hostname"));
+    }
+
+    void revoking_the_capability_invalidates_every_region() {
+        write(dir_.filePath("a.bin"), pattern(8192));
+        write(dir_.filePath("b.bin"), pattern(100));
+        const auto a = files_->mapFile("a.bin");
+        auto b = files_->mapFile("b.bin");
+        QVERIFY(a && b);
+        // Released early; revocation must not trip over it
+        b.reset();
+
+        mgr_->revokeAllCapabilities("maps");
+        QVERIFY(!a->isValid());
+        QVERIFY(a->data() == nullptr);
+        QCOMPARE(a->size(), qint64(0));
+        QVERIFY(!a->advise(AccessHint::Random));
+        QVERIFY(!files_->mapFile("a.bin"));
+    }
+
+    void pointers_taken_before_revocation_stay_readable() {
+        const QByteArray data = pattern(2 * 4096);
+        write(dir_.filePath("held.bin"), data);
+        const auto region = files_->mapFile("held.bin");
+        QVERIFY(region);
+        // An extension thread still reading through this when the capability goes
+        const uchar* pages = region->data();
+
+        mgr_->revokeAllCapabilities("maps");
+        QVERIFY(region->data() == nullptr);
+        QCOMPARE(QByteArray::fromRawData(reinterpret_cast<const char*>(pages), data.size()),
+                 data);
+    }
+
+  private:
+    QTemporaryDir dir_;
+    EventBus bus_;
+    std::unique_ptr<CapabilityManager> mgr_;
+    std::shared_ptr<FileSystemCapability> files_;
+};
+
+QTEST_MAIN(TestFileSystemMap)
+#include "test_filesystem_map.moc"
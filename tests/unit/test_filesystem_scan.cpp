@@ -0,0 +1,269 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QtTest/QtTest>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThread>
+#include "core/capabilities/CapabilityManager.hpp"
+#include "core/capabilities/ScopeIndex.hpp"
+#include "core/events/event_bus.hpp"
+
+using namespace opencardev::crankshaft::core;
+using namespace opencardev::crankshaft::core::capabilities;
+
+namespace {
+
+void touch(const QString& path) {
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile f(path);
+    QVERIFY(f.open(QIODevice::WriteOnly));
+}
+
+// tiles/<z>/<x>/<y>.png for z < 3, x < 4, y < 5, plus a few files at the top
+QStringList populate(const QString& root) {
+    QStringList files{"index.json", "README.txt"};
+    for (int z = 0; z < 3; ++z) {
+        for (int x = 0; x < 4; ++x) {
+            for (int y = 0; y < 5; ++y) {
+                files.append(QString("tiles/%1/%2/%3.png").arg(z).arg(x).arg(y));
+            }
+        }
+    }
+    for (const QString& file : files) {
+        touch(root + "/" + file);
+    }
+    files.sort();
+    return files;
+}
+
+std::shared_ptr<FileSystemCapability> grantFiles(CapabilityManager& mgr, const QString& scope) {
+    mgr.setExtensionPermissions("maps", {"filesystem"});
+    return std::dynamic_pointer_cast<FileSystemCapability>(
+        mgr.grantCapability("maps", "filesystem", {{"scope_path", scope}}));
+}
+
+struct Collected {
+    QList<QStringList> batches;
+    bool finished = false;
+
+    QStringList files() const {
+        QStringList all;
+        for (const QStringList& batch : batches) {
+            all += batch;
+        }
+        all.sort();
+        return all;
+    }
+};
+
+}  // namespace
+
+class TestFileSystemScan : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void scan_streams_the_same_files_as_listFiles_in_batches() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QStringList expected = populate(dir.path());
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        auto files = grantFiles(mgr, dir.path());
+        QVERIFY(files);
+
+        Collected collected;
+        FileSystemCapability::ScanOptions options;
+        options.batch_size = 7;
+        const QThread* gui = QThread::currentThread();
+        bool onGuiThread = true;
+        const int scanId = files->scanFiles(options, [&](const QStringList& batch, bool done) {
+            onGuiThread = onGuiThread && QThread::currentThread() == gui;
+            collected.batches.append(batch);
+            collected.finished = done;
+        });
+        QVERIFY(scanId > 0);
+        // Nothing is delivered synchronously
+        QVERIFY(collected.batches.isEmpty());
+
+        QTRY_VERIFY(collected.finished);
+        QVERIFY(onGuiThread);
+        QCOMPARE(collected.files(), expected);
+        QCOMPARE(collected.batches.size(), (expected.size() + 6) / 7);
+        for (const QStringList& batch : collected.batches) {
+            QVERIFY(batch.size() <= 7);
+        }
+
+        QStringList listed = files->listFiles();
+        listed.sort();
+        QCOMPARE(listed, expected);
+    }
+
+    void name_filters_and_depth_limit_the_scan() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        populate(dir.path());
+        touch(dir.path() + "/tiles/overview.PNG");
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        auto files = grantFiles(mgr, dir.path());
+
+        const auto scan = [&](const QStringList& filters, int depth) {
+            Collected collected;
+            FileSystemCapability::ScanOptions options;
+            options.name_filters = filters;
+            options.max_depth = depth;
+            files->scanFiles(options, [&](const QStringList& batch, bool done) {
+                collected.batches.append(batch);
+                collected.finished = done;
+            });
+            [&]() { QTRY_VERIFY(collected.finished); }();
+            return collected.files();
+        };
+
+        QCOMPARE(scan({}, 0), QStringList({"README.txt", "index.json"}));
+        QCOMPARE(scan({"*.png"}, 1), QStringList({"tiles/overview.PNG"}));
+        QCOMPARE(scan({"*.png"}, 2), QStringList({"tiles/overview.PNG"}));
+        QCOMPARE(scan({"*.png"}, 3).size(), 1 + 3 * 4 * 5);
+        QCOMPARE(scan({"*.png", "*.txt"}, -1).size(), 1 + 1 + 3 * 4 * 5);
+    }
+
+    void cancelled_scan_delivers_nothing_more() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        populate(dir.path());
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        auto files = grantFiles(mgr, dir.path());
+
+        int calls = 0;
+        int scanId = -1;
+        FileSystemCapability::ScanOptions options;
+        options.batch_size = 1;
+        scanId = files->scanFiles(options, [&](const QStringList&, bool) {
+            ++calls;
+            files->cancelScan(scanId);
+        });
+        QTRY_COMPARE(calls, 1);
+        QTest::qWait(100);
+        QCOMPARE(calls, 1);
+
+        // Revoking the capability cancels running scans and refuses new ones
+        calls = 0;
+        files->scanFiles(options, [&](const QStringList&, bool) { ++calls; });
+        mgr.revokeAllCapabilities("maps");
+        QTest::qWait(100);
+        QCOMPARE(calls, 0);
+        QCOMPARE(files->scanFiles(options, [](const QStringList&, bool) {}), -1);
+    }
+
+    void listings_stay_current_after_changes() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        populate(dir.path());
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        auto files = grantFiles(mgr, dir.path());
+        QVERIFY(!files->listFiles().contains("tiles/9/new.png"));
+
+        // Through the capability: visible at once, without waiting for the watcher
+        QVERIFY(files->createDirectory("tiles/9"));
+        std::unique_ptr<QFile> out(files->openFile("tiles/9/new.png", QIODevice::WriteOnly));
+        QVERIFY(out);
+        QVERIFY(files->listFiles().contains("tiles/9/new.png"));
+        QVERIFY(files->deleteFile("tiles/0/0/0.png"));
+        QVERIFY(!files->listFiles().contains("tiles/0/0/0.png"));
+
+        // Behind its back: picked up through the watches
+        touch(dir.path() + "/tiles/1/1/extra.png");
+        QTRY_VERIFY(files->listFiles().contains("tiles/1/1/extra.png"));
+        QVERIFY(QDir(dir.path() + "/tiles/2").removeRecursively());
+        QTRY_VERIFY(!files->listFiles().contains("tiles/2/0/0.png"));
+        touch(dir.path() + "/tiles/2/0/again.png");
+        QTRY_VERIFY(files->listFiles().contains("tiles/2/0/again.png"));
+    }
+
+    void index_serves_repeat_walks_without_reading() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QStringList expected = populate(dir.path());
+        ScopeIndex index(dir.path());
+        const auto walk = [&index]() {
+            QStringList all;
+            index.walk({}, -1, 16, [&all](const QStringList& batch, bool) {
+                all += batch;
+                return true;
+            });
+            all.sort();
+            return all;
+        };
+
+        // Root, tiles, 3 zoom levels and 12 columns
+        const int directories = 1 + 1 + 3 + 3 * 4;
+        QCOMPARE(walk(), expected);
+        QCOMPARE(index.stats().directory_reads, directories);
+        QCOMPARE(index.takeUnwatched().size(), directories);
+        QVERIFY(index.takeUnwatched().isEmpty());
+
+        QCOMPARE(walk(), expected);
+        QCOMPARE(index.stats().directory_reads, directories);
+        QCOMPARE(index.stats().directory_hits, directories);
+
+        // An unwatched directory is read again once its mtime moves...
+        QThread::msleep(50);
+        touch(dir.path() + "/tiles/0/0/late.png");
+        QVERIFY(walk().contains("tiles/0/0/late.png"));
+        QCOMPARE(index.stats().directory_reads, directories + 1);
+
+        // ...a watched one only when invalidated
+        const QString column = QDir::cleanPath(dir.path() + "/tiles/0/1");
+        index.setWatched(column);
+        QThread::msleep(50);
+        touch(column + "/later.png");
+        QVERIFY(!walk().contains("tiles/0/1/later.png"));
+        index.invalidate(column);
+        QVERIFY(walk().contains("tiles/0/1/later.png"));
+    }
+
+    void walk_stops_when_cancelled_or_refused() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        populate(dir.path());
+        ScopeIndex index(dir.path());
+
+        int batches = 0;
+        QVERIFY(!index.walk({}, -1, 1, [&batches](const QStringList&, bool) {
+            return ++batches < 3;
+        }));
+        QCOMPARE(batches, 3);
+
+        std::atomic_bool cancelled{true};
+        batches = 0;
+        QVERIFY(!index.walk({}, -1, 1, [&batches](const QStringList&, bool) {
+            ++batches;
+            return true;
+        }, &cancelled));
+        QCOMPARE(batches, 0);
+    }
+};
+
+QTEST_MAIN(TestFileSystemScan)
+#include "test_filesystem_scan.moc"
@@ -0,0 +1,237 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QtTest/QtTest>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QTimeZone>
+#include <QtPositioning/QGeoCircle>
+#include <QtPositioning/QGeoPath>
+#include <QtPositioning/QGeoPolygon>
+#include <QtPositioning/QGeoRectangle>
+#include <algorithm>
+#include <random>
+#include "core/location/GeofenceService.hpp"
+
+using namespace opencardev::crankshaft::core::location;
+
+namespace {
+
+const QGeoCoordinate kHome(51.5, -0.125);
+constexpr qint64 kStartMs = 1792324800000;  // 2026-10-18 12:00 UTC
+
+QGeoPositionInfo fixAt(const QGeoCoordinate& coordinate, qint64 time_ms) {
+    return QGeoPositionInfo(coordinate, QDateTime::fromMSecsSinceEpoch(time_ms, QTimeZone::utc()));
+}
+
+// Uniform in [0, 1) from the engine's raw output, so every standard library draws the same
+double uniform(std::mt19937& engine) {
+    return double(engine()) / 4294967296.0;
+}
+
+// Ten thousand fences over a 40 km square: circles of 50-500 m and hexagons of 100-800 m
+QList<QGeoShape> cityOfFences(std::mt19937& engine) {
+    QList<QGeoShape> shapes;
+    for (int i = 0; i < 10000; ++i) {
+        const double distance = 20000.0 * std::sqrt(uniform(engine));
+        const QGeoCoordinate centre = kHome.atDistanceAndAzimuth(distance, 360.0 * uniform(engine));
+        if (i % 5 != 0) {
+            shapes << QGeoCircle(centre, 50.0 + 450.0 * uniform(engine));
+            continue;
+        }
+        const double radius = 100.0 + 700.0 * uniform(engine);
+        QGeoPolygon hexagon;
+        for (int corner = 0; corner < 6; ++corner) {
+            hexagon.addCoordinate(centre.atDistanceAndAzimuth(radius, 60.0 * corner));
+        }
+        shapes << hexagon;
+    }
+    return shapes;
+}
+
+}  // namespace
+
+class TestGeofence : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void grid_returns_only_nearby_fences() {
+        GeofenceGrid grid(0.01);
+        grid.insert(1, GeoBounds{51.500, -0.130, 51.505, -0.120});
+        grid.insert(2, GeoBounds{52.000, 1.000, 52.005, 1.005});
+        // Larger than kMaxCellsPerFence cells: always a candidate
+        grid.insert(3, GeoBounds{40.0, -10.0, 60.0, 10.0});
+
+        QList<int> candidates;
+        grid.query(51.502, -0.125, &candidates);
+        std::sort(candidates.begin(), candidates.end());
+        QCOMPARE(candidates, QList<int>({1, 3}));
+
+        candidates.clear();
+        grid.remove(1, GeoBounds{51.500, -0.130, 51.505, -0.120});
+        grid.remove(3, GeoBounds{40.0, -10.0, 60.0, 10.0});
+        grid.query(51.502, -0.125, &candidates);
+        QVERIFY(candidates.isEmpty());
+        QCOMPARE(grid.cellCount(), 1);
+    }
+
+    void circle_reports_enter_dwell_and_exit() {
+        GeofenceService service;
+        const int home = service.addFence("demo", "home", QGeoCircle(kHome, 100.0), 30000);
+        QVERIFY(home > 0);
+        QSignalSpy events(&service, &GeofenceService::fenceEvent);
+
+        // Drive in from 500 m west at 10 m/s, park for a minute, drive off east
+        qint64 time_ms = kStartMs;
+        for (double distance = 500.0; distance > 0.0; distance -= 10.0, time_ms += 1000) {
+            service.update(fixAt(kHome.atDistanceAndAzimuth(distance, 270.0), time_ms));
+        }
+        QCOMPARE(events.count(), 1);
+        QCOMPARE(events.at(0).at(0).toString(), QString("demo"));
+        QCOMPARE(events.at(0).at(1).toString(), QString("enter"));
+        const QVariantMap enter = events.at(0).at(2).toMap();
+        QCOMPARE(enter["id"].toInt(), home);
+        QCOMPARE(enter["name"].toString(), QString("home"));
+        QVERIFY(kHome.distanceTo(QGeoCoordinate(enter["latitude"].toDouble(),
+                                                enter["longitude"].toDouble())) <= 100.0);
+        const qint64 entered_ms = enter["timestamp"].toLongLong();
+
+        for (int second = 0; second < 60; ++second, time_ms += 1000) {
+            service.update(fixAt(kHome, time_ms));
+        }
+        QCOMPARE(events.count(), 2);
+        QCOMPARE(events.at(1).at(1).toString(), QString("dwell"));
+        QCOMPARE(events.at(1).at(2).toMap()["timestamp"].toLongLong(), entered_ms + 30000);
+        QCOMPARE(events.at(1).at(2).toMap()["dwell_ms"].toInt(), 30000);
+
+        for (double distance = 10.0; distance < 500.0; distance += 10.0, time_ms += 1000) {
+            service.update(fixAt(kHome.atDistanceAndAzimuth(distance, 90.0), time_ms));
+        }
+        QCOMPARE(events.count(), 3);
+        QCOMPARE(events.at(2).at(1).toString(), QString("exit"));
+        QCOMPARE(service.stats().events, quint64(3));
+    }
+
+    void polygons_and_rectangles_match_qt() {
+        GeofenceService service;
+        // A concave "L" and a rectangle overlapping its foot
+        QGeoPolygon zone({QGeoCoordinate(51.50, -0.13), QGeoCoordinate(51.52, -0.13),
+                          QGeoCoordinate(51.52, -0.12), QGeoCoordinate(51.51, -0.12),
+                          QGeoCoordinate(51.51, -0.10), QGeoCoordinate(51.50, -0.10)});
+        QGeoRectangle rectangle(QGeoCoordinate(51.505, -0.105), QGeoCoordinate(51.495, -0.095));
+        const int l = service.addFence("demo", "zone", zone);
+        const int r = service.addFence("demo", "rectangle", rectangle);
+        QVERIFY(l > 0 && r > 0);
+        // Not supported as an area
+        QCOMPARE(service.addFence("demo", "path", QGeoPath({kHome, QGeoCoordinate(51.6, -0.1)})),
+                 -1);
+        QCOMPARE(service.addFence("demo", "nothing", QGeoShape()), -1);
+
+        std::mt19937 engine(7);
+        for (int i = 0; i < 2000; ++i) {
+            const QGeoCoordinate point(51.49 + 0.04 * uniform(engine),
+                                       -0.14 + 0.05 * uniform(engine));
+            const QList<int> inside = service.fencesAt(point);
+            QCOMPARE(inside.contains(l), zone.contains(point));
+            QCOMPARE(inside.contains(r), rectangle.contains(point));
+        }
+    }
+
+    void removed_fences_are_forgotten() {
+        GeofenceService service;
+        QSignalSpy changed(&service, &GeofenceService::fencesChanged);
+        const int a = service.addFence("a", "a", QGeoCircle(kHome, 100.0));
+        service.addFence("b", "b", QGeoCircle(kHome, 200.0));
+        service.addFence("b", "c", QGeoCircle(kHome, 300.0));
+        QCOMPARE(changed.count(), 3);
+
+        QSignalSpy events(&service, &GeofenceService::fenceEvent);
+        service.update(fixAt(kHome, kStartMs));
+        QCOMPARE(events.count(), 3);
+
+        // Removed while inside: no exit
+        QCOMPARE(service.removeFences("b"), 2);
+        QVERIFY(service.removeFence(a));
+        QVERIFY(!service.removeFence(a));
+        QVERIFY(service.isEmpty());
+        service.update(fixAt(kHome.atDistanceAndAzimuth(1000.0, 0.0), kStartMs + 1000));
+        QCOMPARE(events.count(), 3);
+    }
+
+    void grid_agrees_with_brute_force() {
+        std::mt19937 engine(1);
+        const QList<QGeoShape> shapes = cityOfFences(engine);
+        GeofenceService service;
+        for (const QGeoShape& shape : shapes) {
+            QVERIFY(service.addFence("demo", QString(), shape) > 0);
+        }
+
+        int matches = 0;
+        for (int i = 0; i < 200; ++i) {
+            const QGeoCoordinate point = kHome.atDistanceAndAzimuth(
+                20000.0 * std::sqrt(uniform(engine)), 360.0 * uniform(engine));
+            QList<int> inside = service.fencesAt(point);
+            std::sort(inside.begin(), inside.end());
+            QList<int> expected;
+            for (int id = 1; id <= shapes.size(); ++id) {
+                if (shapes.at(id - 1).contains(point)) {
+                    expected << id;
+                }
+            }
+            QCOMPARE(inside, expected);
+            matches += expected.size();
+        }
+        QVERIFY(matches > 0);
+    }
+
+    // 10k fences, a ten-minute drive across them at 10 Hz
+    void benchmark_10k_fences_at_10hz() {
+        std::mt19937 engine(1);
+        GeofenceService service;
+        for (const QGeoShape& shape : cityOfFences(engine)) {
+            service.addFence("demo", QString(), shape);
+        }
+        QList<QGeoPositionInfo> drive;
+        const QGeoCoordinate start = kHome.atDistanceAndAzimuth(15000.0, 225.0);
+        for (int i = 0; i < 6000; ++i) {
+            drive << fixAt(start.atDistanceAndAzimuth(i * 2.0, 45.0), kStartMs + i * 100);
+        }
+
+        int events = 0;
+        connect(&service, &GeofenceService::fenceEvent, this, [&events]() { ++events; });
+        QElapsedTimer clock;
+        clock.start();
+        QBENCHMARK {
+            for (const QGeoPositionInfo& fix : std::as_const(drive)) {
+                service.update(fix);
+            }
+        }
+        const GeofenceService::Stats stats = service.stats();
+        qInfo("%llu fixes in %lld ms, %.1f candidates and %.2f events per fix", stats.fixes,
+              clock.elapsed(), double(stats.candidates) / stats.fixes,
+              double(stats.events) / stats.fixes);
+        QVERIFY(events > 0);
+        // The grid, not the fence count, bounds the work per fix
+        QVERIFY(double(stats.candidates) / stats.fixes < 100.0);
+    }
+};
+
+QTEST_MAIN(TestGeofence)
+#include "test_geofence.moc"
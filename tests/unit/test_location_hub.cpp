@@ -0,0 +1,265 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QtTest/QtTest>
+#include <QtPositioning/QGeoCircle>
+#include <QtPositioning/QGeoPositionInfoSource>
+#include "core/capabilities/CapabilityManager.hpp"
+#include "core/capabilities/LocationCapability.hpp"
+#include "core/events/event_bus.hpp"
+#include "core/location/LocationHub.hpp"
+
+using namespace opencardev::crankshaft::core;
+using opencardev::crankshaft::core::capabilities::LocationCapability;
+using opencardev::crankshaft::core::location::LocationHub;
+
+namespace {
+
+// Position source driven by the test; records how the hub configures it
+class FakeSource : public QGeoPositionInfoSource {
+  public:
+    explicit FakeSource(QObject* parent = nullptr) : QGeoPositionInfoSource(parent) {}
+
+    QGeoPositionInfo lastKnownPosition(bool = false) const override { return {}; }
+    PositioningMethods supportedPositioningMethods() const override {
+        return SatellitePositioningMethods;
+    }
+    int minimumUpdateInterval() const override { return 100; }
+    Error error() const override { return NoError; }
+
+    void startUpdates() override { running = true; }
+    void stopUpdates() override { running = false; }
+    void requestUpdate(int = 0) override {}
+
+    bool running = false;
+};
+
+QGeoPositionInfo fixAt(qint64 time_ms, double lat, double lon, double accuracy_m = 5.0) {
+    QGeoPositionInfo info(QGeoCoordinate(lat, lon),
+                          QDateTime::fromMSecsSinceEpoch(time_ms, Qt::UTC));
+    info.setAttribute(QGeoPositionInfo::HorizontalAccuracy, accuracy_m);
+    return info;
+}
+
+}  // namespace
+
+class TestLocationHub : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void source_runs_at_the_fastest_subscribers_rate() {
+        LocationHub hub;
+        auto* source = new FakeSource;
+        hub.setSource(source);
+        QVERIFY(!source->running);
+
+        LocationHub::Policy slow;
+        slow.min_interval_ms = 60000;
+        const int clock = hub.subscribe("clock", slow, [](const QGeoPositionInfo&) {});
+        QVERIFY(source->running);
+        QCOMPARE(source->updateInterval(), 60000);
+
+        LocationHub::Policy fast;
+        fast.min_interval_ms = 10;  // Below the source's minimum
+        const int nav = hub.subscribe("navigation", fast, [](const QGeoPositionInfo&) {});
+        QCOMPARE(hub.sourceInterval(), 100);
+
+        hub.unsubscribe(nav);
+        QCOMPARE(source->updateInterval(), 60000);
+        hub.unsubscribe(clock);
+        QVERIFY(!source->running);
+        QVERIFY(!hub.isSourceRunning());
+    }
+
+    void fixes_are_decimated_per_subscriber() {
+        LocationHub hub;
+        hub.setSource(new FakeSource);
+
+        int every = 0;
+        int per_second = 0;
+        hub.subscribe("navigation", {}, [&](const QGeoPositionInfo&) { ++every; });
+        LocationHub::Policy policy;
+        policy.min_interval_ms = 1000;
+        hub.subscribe("clock", policy, [&](const QGeoPositionInfo&) { ++per_second; });
+
+        // Two seconds at 10 Hz
+        for (int i = 0; i < 20; ++i) {
+            hub.publishFix(fixAt(1000000 + i * 100, 51.5, -0.12 + i * 0.0001));
+        }
+        QCOMPARE(every, 20);
+        QCOMPARE(per_second, 2);
+        QCOMPARE(hub.fixesReceived(), quint64(20));
+
+        const QVariantList stats = hub.subscriptionStats();
+        QCOMPARE(stats.size(), 2);
+        QCOMPARE(stats.at(1).toMap()["skipped"].toULongLong(), quint64(18));
+    }
+
+    void distance_and_accuracy_filters() {
+        LocationHub hub;
+        hub.setSource(new FakeSource);
+
+        QList<QGeoPositionInfo> received;
+        LocationHub::Policy policy;
+        policy.min_distance_m = 50.0;
+        policy.max_accuracy_m = 20.0;
+        hub.subscribe("weather", policy,
+                      [&](const QGeoPositionInfo& info) { received << info; });
+
+        hub.publishFix(fixAt(1000, 51.5, -0.12, 100.0));   // Too inaccurate
+        hub.publishFix(fixAt(2000, 51.5, -0.12));          // First accurate fix
+        hub.publishFix(fixAt(3000, 51.5001, -0.12));       // About 11 m away
+        hub.publishFix(fixAt(4000, 51.501, -0.12));        // About 111 m away
+        QCOMPARE(received.size(), 2);
+        QCOMPARE(received.at(1).coordinate().latitude(), 51.501);
+        QCOMPARE(hub.lastFix().coordinate().latitude(), 51.501);
+    }
+
+    void smoothed_subscribers_do_not_see_outliers() {
+        LocationHub hub;
+        hub.setSource(new FakeSource);
+
+        QList<QGeoPositionInfo> raw;
+        QList<QGeoPositionInfo> smoothed;
+        hub.subscribe("recorder", {}, [&](const QGeoPositionInfo& info) { raw << info; });
+        LocationHub::Policy policy;
+        policy.smoothed = true;
+        hub.subscribe("navigation", policy,
+                      [&](const QGeoPositionInfo& info) { smoothed << info; });
+        QVERIFY(!hub.predictedPosition().isValid());
+
+        // Ten seconds heading north at about 11 m/s, then a 500 m jump east
+        for (int i = 0; i < 10; ++i) {
+            hub.publishFix(fixAt(1000000 + i * 1000, 51.5 + i * 0.0001, -0.12));
+        }
+        hub.publishFix(fixAt(1010000, 51.501, -0.113));
+        QCOMPARE(raw.size(), 11);
+        QCOMPARE(smoothed.size(), 10);
+        QCOMPARE(hub.filterStats().rejected, quint64(1));
+        QVERIFY(smoothed.last().attribute(QGeoPositionInfo::GroundSpeed) > 5.0);
+
+        const QGeoPositionInfo predicted = hub.predictedPosition();
+        QVERIFY(predicted.isValid());
+        QVERIFY(predicted.coordinate().distanceTo(QGeoCoordinate(51.5009, -0.12)) < 10.0);
+        QCOMPARE(hub.subscriptionStats().at(1).toMap()["smoothed"].toBool(), true);
+    }
+
+    void capabilities_share_the_hub_until_revoked() {
+        CapabilityManager mgr(nullptr, nullptr);
+        LocationHub* hub = mgr.locationHub();
+        QVERIFY(hub);
+        auto* source = new FakeSource;
+        hub->setSource(source);
+        mgr.setExtensionPermissions("navigation", {"location"});
+        mgr.setExtensionPermissions("clock", {"location"});
+
+        auto nav = std::dynamic_pointer_cast<LocationCapability>(
+            mgr.grantCapability("navigation", "location"));
+        auto clock = std::dynamic_pointer_cast<LocationCapability>(
+            mgr.grantCapability("clock", "location"));
+        QVERIFY(nav && clock);
+
+        int nav_fixes = 0;
+        int clock_fixes = 0;
+        nav->subscribeToUpdates([&](const QGeoCoordinate&) { ++nav_fixes; });
+        LocationCapability::UpdatePolicy policy;
+        policy.min_interval_ms = 1000;
+        clock->subscribeToUpdates(policy, [&](const QGeoPositionInfo&) { ++clock_fixes; });
+        QCOMPARE(hub->subscriberCount(), 2);
+        QCOMPARE(hub->sourceInterval(), 100);
+
+        for (int i = 0; i < 10; ++i) {
+            hub->publishFix(fixAt(5000 + i * 100, 51.5, -0.12));
+        }
+        QCOMPARE(nav_fixes, 10);
+        QCOMPARE(clock_fixes, 1);
+        QCOMPARE(nav->getCurrentPosition().latitude(), 51.5);
+        QCOMPARE(nav->getAccuracy(), 5.0);
+
+        mgr.revokeCapability("navigation", "location");
+        QCOMPARE(hub->subscriberCount(), 1);
+        QCOMPARE(hub->sourceInterval(), 1000);
+        hub->publishFix(fixAt(7000, 51.5, -0.12));
+        QCOMPARE(nav_fixes, 10);
+        QCOMPARE(clock_fixes, 2);
+
+        mgr.revokeAllCapabilities("clock");
+        QCOMPARE(hub->subscriberCount(), 0);
+        QVERIFY(!source->running);
+    }
+
+    void geofence_events_reach_the_owner_namespace() {
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        LocationHub* hub = mgr.locationHub();
+        auto* source = new FakeSource;
+        hub->setSource(source);
+        mgr.setExtensionPermissions("demo", {"location"});
+        auto location = std::dynamic_pointer_cast<LocationCapability>(
+            mgr.grantCapability("demo", "location"));
+        QVERIFY(location);
+
+        QStringList received;
+        bus.subscribe("demo.geofence.*", [&](const QVariantMap& event) {
+            received << event["name"].toString();
+        });
+        const int fence =
+            location->addGeofence("home", QGeoCircle(QGeoCoordinate(51.5, -0.12), 50.0));
+        QVERIFY(fence > 0);
+        // Fences alone keep the receiver running
+        QVERIFY(source->running);
+        QCOMPARE(hub->sourceInterval(), 1000);
+
+        hub->publishFix(fixAt(1000000, 51.5006, -0.12));  // About 67 m north
+        hub->publishFix(fixAt(1001000, 51.5, -0.12));
+        QCOMPARE(received, QStringList({"home"}));
+
+        // Another extension cannot remove it; revoking the capability does
+        mgr.setExtensionPermissions("other", {"location"});
+        auto other = std::dynamic_pointer_cast<LocationCapability>(
+            mgr.grantCapability("other", "location"));
+        other->removeGeofence(fence);
+        QCOMPARE(hub->geofences()->fenceCount(), 1);
+        mgr.revokeCapability("demo", "location");
+        QCOMPARE(hub->geofences()->fenceCount(), 0);
+        QVERIFY(!source->running);
+    }
+
+    void mock_mode_leaves_the_hub() {
+        CapabilityManager mgr(nullptr, nullptr);
+        LocationHub* hub = mgr.locationHub();
+        hub->setSource(new FakeSource);
+        mgr.setExtensionPermissions("demo", {"location"});
+        auto location = std::dynamic_pointer_cast<LocationCapability>(
+            mgr.grantCapability("demo", "location"));
+        QVERIFY(location);
+
+        location->subscribeToUpdates([](const QGeoCoordinate&) {});
+        QCOMPARE(hub->subscriberCount(), 1);
+        location->setDeviceMode(LocationCapability::DeviceMode::MockStatic);
+        QCOMPARE(hub->subscriberCount(), 0);
+        QCOMPARE(location->getCurrentPosition().latitude(), 51.5074);
+        location->setDeviceMode(LocationCapability::DeviceMode::Internal);
+        QCOMPARE(hub->subscriberCount(), 1);
+    }
+};
+
+QTEST_MAIN(TestLocationHub)
+#include "test_location_hub.moc"
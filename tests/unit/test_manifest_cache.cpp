@@ -0,0 +1,172 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QtTest/QtTest>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include "extensions/manifest_cache.hpp"
+
+using namespace opencardev::crankshaft::extensions;
+
+namespace {
+
+void writeManifest(const QString& dir, const QString& id, const QString& version) {
+    QDir().mkpath(dir);
+    QFile f(dir + "/manifest.json");
+    QVERIFY(f.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    f.write(QString("{ \"id\": \"%1\", \"name\": \"%1\", \"version\": \"%2\", "
+                    "\"dependencies\": [\"base\"], "
+                    "\"requirements\": { \"required_permissions\": [\"event\"] }, "
+                    "\"activation\": { \"events\": [\"%1.*\"], \"prewarm_after_ms\": 50 } }")
+                .arg(id, version)
+                .toUtf8());
+}
+
+}  // namespace
+
+class TestManifestCache : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void unchanged_boot_is_served_from_the_cache_file() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString extensions = dir.path() + "/extensions";
+        writeManifest(extensions + "/alpha", "alpha", "1.0.0");
+        writeManifest(extensions + "/beta", "beta", "1.0.0");
+        const QString cacheFile = dir.path() + "/cache/extension-manifests.bin";
+
+        {
+            ManifestCache cache;
+            QVERIFY(!cache.open(cacheFile));
+            const QStringList found = cache.discover(extensions);
+            QCOMPARE(found.size(), 2);
+            for (const QString& path : found) {
+                QVERIFY(cache.manifest(path + "/manifest.json").isValid());
+            }
+            QCOMPARE(cache.stats().directory_scans, 1);
+            QCOMPARE(cache.stats().manifest_parses, 2);
+            QVERIFY(cache.save());
+        }
+
+        ManifestCache cache;
+        QVERIFY(cache.open(cacheFile));
+        const QStringList found = cache.discover(extensions);
+        QCOMPARE(found.size(), 2);
+        const ExtensionManifest alpha = cache.manifest(extensions + "/alpha/manifest.json");
+        QCOMPARE(alpha.id, QString("alpha"));
+        QCOMPARE(alpha.dependencies, QStringList{"base"});
+        QCOMPARE(alpha.requirements.required_permissions, QStringList{"event"});
+        QCOMPARE(alpha.activation.events, QStringList{"alpha.*"});
+        QCOMPARE(alpha.activation.prewarm_after_ms, 50);
+        cache.manifest(extensions + "/beta/manifest.json");
+
+        QCOMPARE(cache.stats().directory_hits, 1);
+        QCOMPARE(cache.stats().directory_scans, 0);
+        QCOMPARE(cache.stats().manifest_hits, 2);
+        QCOMPARE(cache.stats().manifest_parses, 0);
+    }
+
+    void edited_manifest_is_reparsed() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.path() + "/ext/manifest.json";
+        writeManifest(dir.path() + "/ext", "ext", "1.0.0");
+
+        ManifestCache cache;
+        QCOMPARE(cache.manifest(path).version, QString("1.0.0"));
+
+        // Rewritten with identical content: the hash matches, nothing is parsed
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        const QByteArray content = file.readAll();
+        file.close();
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write(content);
+        file.close();
+        QCOMPARE(cache.manifest(path).version, QString("1.0.0"));
+        QCOMPARE(cache.stats().manifest_parses, 1);
+
+        // A different size is noticed even within the timestamp resolution
+        writeManifest(dir.path() + "/ext", "ext", "2.0.0-beta");
+        QCOMPARE(cache.manifest(path).version, QString("2.0.0-beta"));
+        QCOMPARE(cache.stats().manifest_parses, 2);
+    }
+
+    void installing_an_extension_invalidates_the_listing() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString extensions = dir.path() + "/extensions";
+        writeManifest(extensions + "/alpha", "alpha", "1.0.0");
+
+        ManifestCache cache;
+        QSignalSpy changed(&cache, &ManifestCache::searchPathChanged);
+        QCOMPARE(cache.discover(extensions).size(), 1);
+
+        writeManifest(extensions + "/gamma", "gamma", "1.0.0");
+        QTRY_VERIFY(changed.count() > 0);
+        QCOMPARE(cache.discover(extensions).size(), 2);
+        QCOMPARE(cache.stats().directory_scans, 2);
+    }
+
+    void extension_copied_into_an_existing_directory_is_found() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString extensions = dir.path() + "/extensions";
+        writeManifest(extensions + "/alpha", "alpha", "1.0.0");
+        // An install that made its directory but has not copied the manifest yet
+        QVERIFY(QDir().mkpath(extensions + "/gamma"));
+        const QString file = dir.path() + "/cache.bin";
+        {
+            ManifestCache cache;
+            cache.open(file);
+            QCOMPARE(cache.discover(extensions).size(), 1);
+            QVERIFY(cache.save());
+        }
+
+        // Only the subdirectory changes, not the search path
+        writeManifest(extensions + "/gamma", "gamma", "1.0.0");
+        ManifestCache cache;
+        QVERIFY(cache.open(file));
+        QCOMPARE(cache.discover(extensions).size(), 2);
+        QCOMPARE(cache.stats().directory_scans, 1);
+    }
+
+    void manifest_copied_while_running_invalidates_the_listing() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString extensions = dir.path() + "/extensions";
+        writeManifest(extensions + "/alpha", "alpha", "1.0.0");
+        QVERIFY(QDir().mkpath(extensions + "/gamma"));
+
+        ManifestCache cache;
+        QSignalSpy changed(&cache, &ManifestCache::searchPathChanged);
+        QCOMPARE(cache.discover(extensions).size(), 1);
+
+        writeManifest(extensions + "/gamma", "gamma", "1.0.0");
+        QTRY_VERIFY(changed.count() > 0);
+        QCOMPARE(changed.last().at(0).toString(), QFileInfo(extensions).absoluteFilePath());
+        QCOMPARE(cache.discover(extensions).size(), 2);
+    }
+};
+
+QTEST_MAIN(TestManifestCache)
+#include "test_manifest_cache.moc"
@@ -0,0 +1,259 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QtTest/QtTest>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTimeZone>
+#include <fcntl.h>
+#include <pty.h>
+#include <termios.h>
+#include <unistd.h>
+#include "core/location/LocationHub.hpp"
+#include "core/location/NmeaParser.hpp"
+#include "core/location/NmeaSerialSource.hpp"
+
+using namespace opencardev::crankshaft::core::location;
+
+namespace {
+
+// Recorded with the test's generator; see tests/data/nmea
+QByteArray recording(const QString& name) {
+    QFile file(QStringLiteral(TEST_NMEA_DIR "/") + name);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qFatal("Missing NMEA recording %s", qPrintable(name));
+    }
+    return file.readAll();
+}
+
+QList<QGeoPositionInfo> parseAll(const QByteArray& data, int chunk,
+                                 NmeaParser::Stats* stats = nullptr,
+                                 QList<NmeaParser::Satellite>* satellites = nullptr) {
+    NmeaParser parser;
+    QList<QGeoPositionInfo> fixes;
+    parser.setFixHandler([&](const QGeoPositionInfo& info) { fixes << info; });
+    for (qsizetype i = 0; i < data.size(); i += chunk) {
+        parser.feed(data.constData() + i, std::min<qsizetype>(chunk, data.size() - i));
+    }
+    parser.flush();
+    if (stats) {
+        *stats = parser.stats();
+    }
+    if (satellites) {
+        *satellites = parser.satellites();
+    }
+    return fixes;
+}
+
+// Pseudo-terminal standing in for a receiver's serial port
+struct PseudoTerminal {
+    int master = -1;
+    int slave = -1;
+    QString path;
+
+    PseudoTerminal() {
+        char name[128] = {};
+        termios raw{};
+        ::cfmakeraw(&raw);
+        if (::openpty(&master, &slave, name, &raw, nullptr) == 0) {
+            path = QString::fromLocal8Bit(name);
+        }
+    }
+    ~PseudoTerminal() {
+        ::close(master);
+        ::close(slave);
+    }
+
+    bool write(const QByteArray& data) const {
+        qsizetype written = 0;
+        while (written < data.size()) {
+            const ssize_t count =
+                ::write(master, data.constData() + written, size_t(data.size() - written));
+            if (count <= 0) {
+                return false;
+            }
+            written += count;
+        }
+        return true;
+    }
+};
+
+}  // namespace
+
+class TestNmeaSource : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void parses_a_10hz_multi_constellation_recording() {
+        const QByteArray data = recording("ublox_10hz.nmea");
+        NmeaParser::Stats stats;
+        QList<NmeaParser::Satellite> satellites;
+        const QList<QGeoPositionInfo> fixes = parseAll(data, data.size(), &stats, &satellites);
+
+        QCOMPARE(fixes.size(), 30);
+        QCOMPARE(stats.checksum_errors, quint64(0));
+        QCOMPARE(stats.malformed, quint64(0));
+        for (int i = 1; i < fixes.size(); ++i) {
+            QCOMPARE(fixes[i - 1].timestamp().msecsTo(fixes[i].timestamp()), qint64(100));
+        }
+        const QGeoPositionInfo& last = fixes.last();
+        QCOMPARE(last.timestamp().date(), QDate(2026, 10, 18));
+        QVERIFY(qAbs(last.attribute(QGeoPositionInfo::GroundSpeed) - 50 / 3.6) < 0.01);
+        QCOMPARE(last.attribute(QGeoPositionInfo::Direction), 90.0);
+        QVERIFY(qAbs(last.coordinate().altitude() - 21.4) < 1e-9);
+        // 2.9 s east at 50 km/h
+        QVERIFY(qAbs(fixes.first().coordinate().distanceTo(last.coordinate()) - 40.3) < 0.5);
+        // From GST once one has been received, HDOP * UERE before
+        QVERIFY(qAbs(fixes.first().attribute(QGeoPositionInfo::HorizontalAccuracy) - 3.5) <
+                1e-9);
+        QVERIFY(qAbs(last.attribute(QGeoPositionInfo::HorizontalAccuracy) - 1.5) < 1e-9);
+
+        // GPS (with one SBAS), GLONASS, Galileo and BeiDou; L1 and L5 GPS signals merged
+        QCOMPARE(satellites.size(), 22);
+        QMap<NmeaParser::Constellation, int> in_view;
+        int in_use = 0;
+        for (const auto& satellite : satellites) {
+            ++in_view[satellite.constellation];
+            in_use += satellite.in_use ? 1 : 0;
+        }
+        QCOMPARE(in_use, 18);
+        QCOMPARE(in_view.value(NmeaParser::Constellation::Gps), 8);
+        QCOMPARE(in_view.value(NmeaParser::Constellation::Sbas), 1);
+        QCOMPARE(in_view.value(NmeaParser::Constellation::Glonass), 5);
+        QCOMPARE(in_view.value(NmeaParser::Constellation::Galileo), 4);
+        QCOMPARE(in_view.value(NmeaParser::Constellation::BeiDou), 4);
+    }
+
+    void sentences_split_across_reads_give_the_same_fixes() {
+        const QByteArray data = recording("ublox_10hz.nmea");
+        const QList<QGeoPositionInfo> whole = parseAll(data, data.size());
+        for (int chunk : {1, 7, 64, 4096}) {
+            const QList<QGeoPositionInfo> split = parseAll(data, chunk);
+            QCOMPARE(split.size(), whole.size());
+            for (int i = 0; i < whole.size(); ++i) {
+                QCOMPARE(split[i], whole[i]);
+            }
+        }
+    }
+
+    void corrupt_sentences_are_dropped() {
+        NmeaParser::Stats stats;
+        const QList<QGeoPositionInfo> fixes = parseAll(recording("gps_1hz.nmea"), 5, &stats);
+
+        // No fix in the first second; the third second's RMC fails its checksum, so that
+        // fix comes from GGA alone and carries no speed
+        QCOMPARE(stats.checksum_errors, quint64(1));
+        QCOMPARE(fixes.size(), 4);
+        QVERIFY(!fixes[1].hasAttribute(QGeoPositionInfo::GroundSpeed));
+        QVERIFY(fixes[2].hasAttribute(QGeoPositionInfo::GroundSpeed));
+        // HDOP 1.8, VDOP 2.3 at 5 m UERE
+        QCOMPARE(fixes[2].attribute(QGeoPositionInfo::HorizontalAccuracy), 9.0);
+        QCOMPARE(fixes[2].attribute(QGeoPositionInfo::VerticalAccuracy), 11.5);
+
+        // Midnight passes in the sentence whose RMC, and so the new date, was lost
+        QCOMPARE(fixes[0].timestamp(),
+                 QDateTime(QDate(2026, 1, 18), QTime(23, 59, 59), QTimeZone::utc()));
+        QCOMPARE(fixes[1].timestamp(),
+                 QDateTime(QDate(2026, 1, 19), QTime(0, 0, 0), QTimeZone::utc()));
+    }
+
+    void overlong_and_unterminated_sentences_are_skipped() {
+        QByteArray data = "$GPGGA," + QByteArray(300, '1') + "\r\n";
+        data += "$GPRMC,120000.00,A,5130.0000,N,00007.0000,W,0.0,,010126";  // Cut short
+        data += recording("gps_1hz.nmea");
+        NmeaParser::Stats stats;
+        const QList<QGeoPositionInfo> fixes = parseAll(data, 16, &stats);
+        QCOMPARE(stats.malformed, quint64(1));
+        QCOMPARE(fixes.size(), 4);
+    }
+
+    void serial_source_feeds_the_hub_through_a_pseudo_terminal() {
+        PseudoTerminal pty;
+        QVERIFY(!pty.path.isEmpty());
+
+        LocationHub hub;
+        auto* source = new NmeaSerialSource(pty.path, 115200);
+        QSignalSpy satellites(source, &NmeaSerialSource::satellitesUpdated);
+        hub.setSource(source);
+
+        QList<QGeoPositionInfo> navigation;
+        QList<QGeoPositionInfo> clock;
+        const int all = hub.subscribe("navigation", {}, [&](const QGeoPositionInfo& info) {
+            navigation << info;
+        });
+        LocationHub::Policy once_a_second;
+        once_a_second.min_interval_ms = 1000;
+        const int decimated = hub.subscribe(
+            "clock", once_a_second, [&](const QGeoPositionInfo& info) { clock << info; });
+        QVERIFY(source->isReading());
+        QCOMPARE(hub.sourceInterval(), 100);
+
+        QVERIFY(pty.write(recording("ublox_10hz.nmea")));
+        QTRY_COMPARE(navigation.size(), 30);
+        QCOMPARE(clock.size(), 3);
+        QVERIFY(satellites.count() >= 1);
+        QCOMPARE(source->satellites().size(), 22);
+        QCOMPARE(source->lastKnownPosition(), navigation.last());
+        QCOMPARE(source->parserStats().fixes, quint64(30));
+
+        hub.unsubscribe(all);
+        hub.unsubscribe(decimated);
+        QVERIFY(!source->isReading());
+    }
+
+    void reader_posts_fixes_at_the_update_interval() {
+        PseudoTerminal pty;
+        NmeaSerialSource source(pty.path);
+        QSignalSpy updates(&source, &QGeoPositionInfoSource::positionUpdated);
+        source.setUpdateInterval(1000);
+        source.startUpdates();
+
+        QVERIFY(pty.write(recording("ublox_10hz.nmea")));
+        QTRY_COMPARE(source.parserStats().fixes, quint64(30));
+        QTRY_COMPARE(updates.count(), 3);
+        source.stopUpdates();
+        QVERIFY(!source.isReading());
+    }
+
+    void single_update_stops_the_reader_again() {
+        PseudoTerminal pty;
+        NmeaSerialSource source(pty.path);
+        QSignalSpy updates(&source, &QGeoPositionInfoSource::positionUpdated);
+        source.requestUpdate(2000);
+        QVERIFY(source.isReading());
+
+        QVERIFY(pty.write(recording("gps_1hz.nmea")));
+        QTRY_COMPARE(updates.count(), 1);
+        QVERIFY(!source.isReading());
+    }
+
+    void missing_device_reports_an_access_error() {
+        NmeaSerialSource source(QStringLiteral("/nonexistent/ttyGNSS"));
+        QSignalSpy errors(&source, &QGeoPositionInfoSource::errorOccurred);
+        source.startUpdates();
+        QTRY_COMPARE(errors.count(), 1);
+        QCOMPARE(source.error(), QGeoPositionInfoSource::AccessError);
+        source.stopUpdates();
+        QVERIFY(!source.isReading());
+    }
+};
+
+QTEST_MAIN(TestNmeaSource)
+#include "test_nmea_source.moc"
@@ -0,0 +1,99 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Extension plugin loaded by test_extension_manager through QPluginLoader, and run in an
+// extension host by test_extension_host. Built a second time with TEST_PLUGIN_CRASH_HOOK
+// as the fixture for the host crash test.
+
+#include <QObject>
+#ifdef TEST_PLUGIN_CRASH_HOOK
+#include <cstdlib>
+#endif
+#include "core/capabilities/EventCapability.hpp"
+#include "core/config/ConfigManager.hpp"
+#include "extensions/extension_plugin.hpp"
+
+using namespace opencardev::crankshaft::extensions;
+using opencardev::crankshaft::core::capabilities::EventCapability;
+using namespace opencardev::crankshaft::core::config;
+
+namespace {
+
+// Static data of the library; starts over each time it is loaded
+int g_instances = 0;
+
+class TestPluginExtension : public Extension {
+  public:
+    TestPluginExtension() { ++g_instances; }
+
+    bool initialize() override { return true; }
+    void start() override {
+        auto events = getCapability<EventCapability>();
+        if (!events) {
+            return;
+        }
+        // Echo pings back as pongs
+        events->subscribe("test_plugin.ping",
+                          [events](const QVariantMap& data) { events->emitEvent("pong", data); });
+#ifdef TEST_PLUGIN_CRASH_HOOK
+        // A crash request takes the process down
+        events->subscribe("test_plugin.crash", [](const QVariantMap&) { std::abort(); });
+#endif
+        events->emitEvent("started", {{"instances", g_instances}});
+    }
+    void stop() override {}
+    void cleanup() override {}
+    // Literals in the library's data, which the manager must not keep after unloading it
+    void registerConfigItems(ConfigManager* manager) override {
+        ConfigItem greeting;
+        greeting.key = QStringLiteral("greeting");
+        greeting.label = QStringLiteral("Greeting");
+        greeting.defaultValue = QStringLiteral("hello");
+        ConfigSection section;
+        section.key = QStringLiteral("general");
+        section.title = QStringLiteral("General");
+        section.items << greeting;
+        ConfigPage page;
+        page.domain = QStringLiteral("test");
+        page.extension = QStringLiteral("test_plugin");
+        page.title = QStringLiteral("Test plugin");
+        page.sections << section;
+        manager->registerConfigPage(page);
+    }
+
+    QString id() const override { return "test_plugin"; }
+    QString name() const override { return "Test plugin"; }
+    QString version() const override { return "1.0.0"; }
+    ExtensionType type() const override { return ExtensionType::Service; }
+};
+
+}  // namespace
+
+class TestPlugin : public QObject, public ExtensionPlugin {
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID CRANKSHAFT_EXTENSION_PLUGIN_IID)
+    Q_INTERFACES(opencardev::crankshaft::extensions::ExtensionPlugin)
+
+  public:
+    std::shared_ptr<Extension> createExtension() override {
+        return std::make_shared<TestPluginExtension>();
+    }
+};
+
+#include "test_plugin_extension.moc"
@@ -0,0 +1,174 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QtTest/QtTest>
+#include <QTimeZone>
+#include <cmath>
+#include <random>
+#include "core/location/PositionFilter.hpp"
+
+using namespace opencardev::crankshaft::core::location;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+const QGeoCoordinate kStart(51.5, -0.125);
+constexpr qint64 kStartMs = 1792324800000;  // 2026-10-18 12:00 UTC
+constexpr double kSpeed = 15.0;              // Due east, in m/s
+constexpr double kNoise = 5.0;               // Per axis, in metres
+
+QGeoCoordinate truthAt(int second) {
+    return kStart.atDistanceAndAzimuth(kSpeed * second, 90.0);
+}
+
+QGeoPositionInfo fixAt(const QGeoCoordinate& coordinate, qint64 time_ms, double accuracy = kNoise) {
+    QGeoPositionInfo fix(coordinate, QDateTime::fromMSecsSinceEpoch(time_ms, QTimeZone::utc()));
+    fix.setAttribute(QGeoPositionInfo::HorizontalAccuracy, accuracy);
+    return fix;
+}
+
+// Gaussian noise from the engine's raw output, so every standard library draws the same
+class Noise {
+  public:
+    double next() {
+        const double u1 = (double(engine_()) + 1.0) / 4294967296.0;
+        const double u2 = double(engine_()) / 4294967296.0;
+        return kNoise * std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * kPi * u2);
+    }
+
+    QGeoCoordinate around(const QGeoCoordinate& truth) {
+        return truth.atDistanceAndAzimuth(next(), 0.0).atDistanceAndAzimuth(next(), 90.0);
+    }
+
+  private:
+    std::mt19937 engine_{42};
+};
+
+}  // namespace
+
+class TestPositionFilter : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void smooths_a_noisy_1hz_drive() {
+        PositionFilter filter;
+        Noise noise;
+        double raw_error = 0.0;
+        double filtered_error = 0.0;
+        for (int second = 0; second < 60; ++second) {
+            const QGeoCoordinate measured = noise.around(truthAt(second));
+            const auto result = filter.update(fixAt(measured, kStartMs + second * 1000));
+            QVERIFY(result != PositionFilter::Result::Stale);
+            // Once settled
+            if (second >= 10) {
+                raw_error += std::pow(measured.distanceTo(truthAt(second)), 2);
+                filtered_error +=
+                    std::pow(filter.estimate().coordinate().distanceTo(truthAt(second)), 2);
+            }
+        }
+        QVERIFY2(filtered_error < 0.8 * raw_error,
+                 qPrintable(QString("raw %1, filtered %2").arg(raw_error).arg(filtered_error)));
+
+        const QGeoPositionInfo estimate = filter.estimate();
+        QCOMPARE(estimate.timestamp().toMSecsSinceEpoch(), kStartMs + 59000);
+        QVERIFY(qAbs(estimate.attribute(QGeoPositionInfo::GroundSpeed) - kSpeed) < 5.0);
+        QVERIFY(qAbs(estimate.attribute(QGeoPositionInfo::Direction) - 90.0) < 15.0);
+        QVERIFY(estimate.attribute(QGeoPositionInfo::HorizontalAccuracy) < kNoise);
+        QCOMPARE(filter.stats().accepted, quint64(59));
+    }
+
+    void predicts_between_fixes_from_reported_velocity() {
+        PositionFilter filter;
+        Noise noise;
+        for (int second = 0; second < 20; ++second) {
+            QGeoPositionInfo fix = fixAt(noise.around(truthAt(second)), kStartMs + second * 1000);
+            fix.setAttribute(QGeoPositionInfo::GroundSpeed, kSpeed);
+            fix.setAttribute(QGeoPositionInfo::Direction, 90.0);
+            filter.update(fix);
+        }
+        const QGeoPositionInfo estimate = filter.estimate();
+        QVERIFY(qAbs(estimate.attribute(QGeoPositionInfo::GroundSpeed) - kSpeed) < 0.5);
+
+        // Half a second on, at 60 Hz frame times: moving east at the estimated speed
+        const QGeoPositionInfo predicted = filter.predict(500);
+        QCOMPARE(predicted.timestamp().toMSecsSinceEpoch(), kStartMs + 19500);
+        QVERIFY(qAbs(estimate.coordinate().distanceTo(predicted.coordinate()) - kSpeed / 2) <
+                0.5);
+        QVERIFY(qAbs(estimate.coordinate().azimuthTo(predicted.coordinate()) - 90.0) < 2.0);
+        QVERIFY(predicted.attribute(QGeoPositionInfo::HorizontalAccuracy) >
+                estimate.attribute(QGeoPositionInfo::HorizontalAccuracy));
+
+        // Prediction does not change the filter, and holds position past its horizon
+        QCOMPARE(filter.estimate().coordinate(), estimate.coordinate());
+        const QGeoPositionInfo held = filter.predict(60000);
+        const double horizon = filter.settings().max_prediction_ms / 1000.0;
+        QVERIFY(qAbs(estimate.coordinate().distanceTo(held.coordinate()) - kSpeed * horizon) <
+                2.0);
+    }
+
+    void rejects_an_outlier() {
+        PositionFilter filter;
+        Noise noise;
+        for (int second = 0; second < 30; ++second) {
+            filter.update(fixAt(noise.around(truthAt(second)), kStartMs + second * 1000));
+        }
+        // A 300 m multipath jump
+        const QGeoCoordinate jump = truthAt(30).atDistanceAndAzimuth(300.0, 0.0);
+        QCOMPARE(filter.update(fixAt(jump, kStartMs + 30000)), PositionFilter::Result::Rejected);
+        QCOMPARE(filter.estimate().timestamp().toMSecsSinceEpoch(), kStartMs + 29000);
+
+        QCOMPARE(filter.update(fixAt(noise.around(truthAt(31)), kStartMs + 31000)),
+                 PositionFilter::Result::Accepted);
+        QVERIFY(filter.estimate().coordinate().distanceTo(truthAt(31)) < 3.0 * kNoise);
+        QCOMPARE(filter.stats().rejected, quint64(1));
+    }
+
+    void restarts_after_consecutive_outliers() {
+        PositionFilter filter;
+        for (int second = 0; second < 10; ++second) {
+            filter.update(fixAt(truthAt(second), kStartMs + second * 1000));
+        }
+        // The receiver now reports a different place for good
+        const QGeoCoordinate moved = kStart.atDistanceAndAzimuth(5000.0, 0.0);
+        const int max_rejections = filter.settings().max_rejections;
+        for (int i = 0; i < max_rejections - 1; ++i) {
+            QCOMPARE(filter.update(fixAt(moved, kStartMs + (10 + i) * 1000)),
+                     PositionFilter::Result::Rejected);
+        }
+        QCOMPARE(filter.update(fixAt(moved, kStartMs + (9 + max_rejections) * 1000)),
+                 PositionFilter::Result::Initialised);
+        QVERIFY(filter.estimate().coordinate().distanceTo(moved) < 0.01);
+        QCOMPARE(filter.stats().restarts, quint64(1));
+    }
+
+    void ignores_stale_and_invalid_fixes() {
+        PositionFilter filter;
+        QCOMPARE(filter.update(QGeoPositionInfo()), PositionFilter::Result::Stale);
+        QVERIFY(!filter.predict(0).isValid());
+        QCOMPARE(filter.update(fixAt(kStart, kStartMs)), PositionFilter::Result::Initialised);
+        QCOMPARE(filter.update(fixAt(truthAt(1), kStartMs)), PositionFilter::Result::Stale);
+        QCOMPARE(filter.update(fixAt(truthAt(1), kStartMs - 1000)), PositionFilter::Result::Stale);
+        filter.reset();
+        QVERIFY(!filter.isInitialised());
+    }
+};
+
+QTEST_MAIN(TestPositionFilter)
+#include "test_position_filter.moc"
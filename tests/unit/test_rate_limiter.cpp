@@ -0,0 +1,255 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#include <QNetworkReply>
+#include <QTemporaryDir>
+#include <QThread>
+#include <algorithm>
+#include "core/capabilities/CapabilityManager.hpp"
+#include "core/capabilities/RateLimiter.hpp"
+#include "core/events/event_bus.hpp"
+#include "extensions/extension.hpp"
+
+using namespace opencardev::crankshaft;
+using namespace opencardev::crankshaft::core;
+using namespace opencardev::crankshaft::core::capabilities;
+
+namespace {
+
+// Misbehaving extension that calls each capability in a tight loop
+class SaturatingExtension : public extensions::Extension {
+  public:
+    bool initialize() override { return true; }
+    void start() override {}
+    void stop() override {}
+    void cleanup() override {}
+    QString id() const override { return "saturator"; }
+    QString name() const override { return "Saturator"; }
+    QString version() const override { return "1.0.0"; }
+    extensions::ExtensionType type() const override { return extensions::ExtensionType::Service; }
+
+    // Returns how many of the calls were admitted
+    int hammerNetwork(int calls) {
+        auto network = getCapability<NetworkCapability>();
+        int admitted = 0;
+        for (int i = 0; i < calls; ++i) {
+            if (QNetworkReply* reply = network->get(QUrl("http://127.0.0.1:9/"))) {
+                reply->abort();
+                reply->deleteLater();
+                ++admitted;
+            }
+        }
+        return admitted;
+    }
+
+    int hammerEvents(int calls) {
+        auto events = getCapability<EventCapability>();
+        int admitted = 0;
+        for (int i = 0; i < calls; ++i) {
+            admitted += events->emitEvent("tick", {{"n", i}}) ? 1 : 0;
+        }
+        return admitted;
+    }
+
+    int hammerFilesystem(int calls) {
+        auto filesystem = getCapability<FileSystemCapability>();
+        int admitted = 0;
+        for (int i = 0; i < calls; ++i) {
+            admitted += filesystem->createDirectory(QString("dir%1").arg(i)) ? 1 : 0;
+        }
+        return admitted;
+    }
+};
+
+RateLimit limit(double rate, double burst, RateLimitPolicy policy) {
+    RateLimit result;
+    result.rate = rate;
+    result.burst = burst;
+    result.policy = policy;
+    return result;
+}
+
+}  // namespace
+
+class TestRateLimiter : public QObject {
+    Q_OBJECT
+
+  private:
+    std::unique_ptr<SaturatingExtension> loadSaturator(CapabilityManager& mgr,
+                                                      const QVariantMap& rateLimits,
+                                                      const QString& scopePath) {
+        auto ext = std::make_unique<SaturatingExtension>();
+        mgr.setExtensionPermissions(ext->id(), {"network", "event", "filesystem"});
+        mgr.setRateLimits(ext->id(), rateLimits);
+        ext->grantCapability(mgr.grantCapability(ext->id(), "network"));
+        ext->grantCapability(mgr.grantCapability(ext->id(), "event"));
+        ext->grantCapability(
+            mgr.grantCapability(ext->id(), "filesystem", {{"scope_path", scopePath}}));
+        return ext;
+    }
+
+  private slots:
+    void bucket_allows_burst_then_rejects() {
+        RateLimitBucket bucket(limit(1, 3, RateLimitPolicy::Reject));
+        for (int i = 0; i < 3; ++i) {
+            QVERIFY(bucket.acquire(RateLimitBucket::kNoDeferral).decision ==
+                    RateLimitBucket::Decision::Allow);
+        }
+        QVERIFY(bucket.acquire(RateLimitBucket::kCanWait).decision ==
+                RateLimitBucket::Decision::Reject);
+        QCOMPARE(bucket.counters().allowed, quint64(3));
+        QCOMPARE(bucket.counters().rejected, quint64(1));
+        QVERIFY(bucket.msUntilAvailable() > 0);
+    }
+
+    void delay_degrades_to_reject_when_caller_cannot_wait() {
+        RateLimitBucket bucket(limit(10, 1, RateLimitPolicy::Delay));
+        QVERIFY(bucket.acquire(RateLimitBucket::kNoDeferral).decision ==
+                RateLimitBucket::Decision::Allow);
+        QVERIFY(bucket.acquire(RateLimitBucket::kNoDeferral).decision ==
+                RateLimitBucket::Decision::Reject);
+
+        const auto verdict = bucket.acquire(RateLimitBucket::kCanWait);
+        QVERIFY(verdict.decision == RateLimitBucket::Decision::Delay);
+        QVERIFY(verdict.delay_ms > 0 && verdict.delay_ms <= 100);
+    }
+
+    void network_default_rejects_rather_than_delays() {
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        QVERIFY(mgr.defaultRateLimit("network").policy == RateLimitPolicy::Reject);
+    }
+
+    void manifest_limits_cannot_exceed_system_defaults() {
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        mgr.setDefaultRateLimit("network", limit(10, 10, RateLimitPolicy::Reject));
+        mgr.setRateLimits("greedy", {{"network", QVariantMap{{"rate", 1000}, {"burst", 1000}}}});
+        mgr.setExtensionPermissions("greedy", {"network"});
+        QVERIFY(mgr.grantCapability("greedy", "network"));
+
+        const auto network = mgr.getRateLimitUsage("greedy").value("network").toMap();
+        QCOMPARE(network["limit"].toMap()["rate"].toDouble(), 10.0);
+        QCOMPARE(network["limit"].toMap()["burst"].toDouble(), 10.0);
+    }
+
+    void saturating_extension_is_throttled_per_capability() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+
+        const QVariantMap rejectFive{{"rate", 1}, {"burst", 5}, {"policy", "reject"}};
+        auto ext = loadSaturator(
+            mgr, {{"network", rejectFive}, {"event", rejectFive}, {"filesystem", rejectFive}},
+            dir.path());
+
+        QCOMPARE(ext->hammerNetwork(100), 5);
+        QCOMPARE(ext->hammerEvents(100), 5);
+        QCOMPARE(ext->hammerFilesystem(100), 5);
+
+        const QVariantMap usage = mgr.getRateLimitUsage(ext->id());
+        for (const QString& type : {"network", "event", "filesystem"}) {
+            const QVariantMap counters = usage.value(type).toMap();
+            QCOMPARE(counters["allowed"].toULongLong(), quint64(5));
+            QCOMPARE(counters["rejected"].toULongLong(), quint64(95));
+        }
+
+        // Rejections are audited
+        const auto audit = mgr.getAuditLog(ext->id(), 0);
+        const auto limited = std::count_if(audit.cbegin(), audit.cend(), [](const QVariantMap& e) {
+            return e["action"].toString() == "rate_limited";
+        });
+        QCOMPARE(int(limited), 285);
+    }
+
+    void coalesced_events_deliver_the_latest_payload() {
+        QTemporaryDir dir;
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        auto ext = loadSaturator(
+            mgr, {{"event", QVariantMap{{"rate", 20}, {"burst", 2}, {"policy", "coalesce"}}}},
+            dir.path());
+
+        QList<int> received;
+        bus.subscribe("saturator.tick", [&](const QVariantMap& data) {
+            received.append(data["n"].toInt());
+        });
+
+        // Every call is accepted, but the flood collapses to the burst plus the last value
+        QCOMPARE(ext->hammerEvents(50), 50);
+        QCOMPARE(received.size(), 2);
+        QTRY_COMPARE(received.size(), 3);
+        QCOMPARE(received.last(), 49);
+        QVERIFY(mgr.getRateLimitUsage(ext->id())["event"].toMap()["coalesced"].toULongLong() >=
+                48);
+    }
+
+    void delayed_events_are_all_delivered_in_order() {
+        QTemporaryDir dir;
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        auto ext = loadSaturator(
+            mgr, {{"event", QVariantMap{{"rate", 50}, {"burst", 1}, {"policy", "delay"}}}},
+            dir.path());
+
+        QList<int> received;
+        bus.subscribe("saturator.tick", [&](const QVariantMap& data) {
+            received.append(data["n"].toInt());
+        });
+
+        QCOMPARE(ext->hammerEvents(5), 5);
+        QCOMPARE(received.size(), 1);
+        QTRY_COMPARE(received.size(), 5);
+        QCOMPARE(received, QList<int>({0, 1, 2, 3, 4}));
+    }
+
+    void delayed_events_from_the_gui_thread_are_delivered() {
+        QCOMPARE(QThread::currentThread(), QCoreApplication::instance()->thread());
+        QTemporaryDir dir;
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        auto ext = loadSaturator(
+            mgr, {{"event", QVariantMap{{"rate", 20}, {"burst", 1}, {"policy", "delay"}}}},
+            dir.path());
+
+        // Unlike synchronous calls, a delayed event is not turned into a rejection here
+        QEventLoop loop;
+        QList<int> received;
+        bus.subscribe("saturator.tick", [&](const QVariantMap& data) {
+            received.append(data["n"].toInt());
+            if (received.size() == 3) {
+                loop.quit();
+            }
+        });
+        QCOMPARE(ext->hammerEvents(3), 3);
+        QCOMPARE(received, QList<int>{0});
+
+        QTimer::singleShot(5000, &loop, &QEventLoop::quit);
+        loop.exec();
+        QCOMPARE(received, QList<int>({0, 1, 2}));
+        const QVariantMap counters = mgr.getRateLimitUsage(ext->id())["event"].toMap();
+        QCOMPARE(counters["delayed"].toULongLong(), quint64(2));
+        QCOMPARE(counters["rejected"].toULongLong(), quint64(0));
+    }
+};
+
+QTEST_MAIN(TestRateLimiter)
+#include "test_rate_limiter.moc"
@@ -0,0 +1,205 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QtTest/QtTest>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTimeZone>
+#include "core/location/LocationHub.hpp"
+#include "core/location/ReplaySource.hpp"
+
+using namespace opencardev::crankshaft::core::location;
+
+namespace {
+
+const QGeoCoordinate kStart(51.5, -0.125);
+const QDateTime kStartTime(QDate(2026, 10, 18), QTime(12, 0), QTimeZone::utc());
+
+// A straight drive east, one point every 10 s (or untimed), 100 m apart
+QString writeGpx(const QTemporaryDir& dir, int points, bool timed) {
+    const QString path = dir.filePath(timed ? "drive.gpx" : "untimed.gpx");
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qFatal("Cannot write %s", qPrintable(path));
+    }
+    QByteArray gpx = "<?xml version=\"1.0\"?>\n<gpx version=\"1.1\"><trk><trkseg>\n";
+    for (int i = 0; i < points; ++i) {
+        const QGeoCoordinate point = kStart.atDistanceAndAzimuth(100.0 * i, 90.0);
+        gpx += QString("<trkpt lat=\"%1\" lon=\"%2\"><ele>%3</ele>")
+                   .arg(point.latitude(), 0, 'f', 8)
+                   .arg(point.longitude(), 0, 'f', 8)
+                   .arg(20 + i)
+                   .toUtf8();
+        if (timed) {
+            gpx += "<time>" + kStartTime.addSecs(10 * i).toString(Qt::ISODate).toUtf8() +
+                   "</time>";
+        }
+        gpx += "</trkpt>\n";
+    }
+    gpx += "</trkseg></trk></gpx>\n";
+    file.write(gpx);
+    return path;
+}
+
+QList<QGeoPositionInfo> replayAll(ReplaySource& source) {
+    QList<QGeoPositionInfo> fixes;
+    QObject::connect(&source, &QGeoPositionInfoSource::positionUpdated,
+                     [&fixes](const QGeoPositionInfo& info) { fixes << info; });
+    QSignalSpy finished(&source, &ReplaySource::finished);
+    source.startUpdates();
+    if (!finished.wait(10000)) {
+        qWarning() << "Replay did not finish";
+    }
+    return fixes;
+}
+
+}  // namespace
+
+class TestReplaySource : public QObject {
+    Q_OBJECT
+
+  private:
+    QTemporaryDir dir_;
+
+  private slots:
+    void gpx_is_interpolated_with_speed_and_heading() {
+        ReplaySource source;
+        QVERIFY(source.load(writeGpx(dir_, 3, true)));
+        QCOMPARE(source.track().size(), 3);
+        QCOMPARE(source.duration(), qint64(20000));
+
+        source.setSpeed(ReplaySource::kAsFastAsPossible);
+        source.setUpdateInterval(1000);
+        const QList<QGeoPositionInfo> fixes = replayAll(source);
+        QCOMPARE(fixes.size(), 21);
+        QVERIFY(!source.isRunning());
+
+        // Halfway between the first two points, stamped with the recording's time
+        const QGeoPositionInfo& fix = fixes.at(5);
+        QCOMPARE(fix.timestamp(), kStartTime.addSecs(5));
+        QVERIFY(qAbs(fix.coordinate().distanceTo(kStart) - 50.0) < 0.5);
+        QVERIFY(qAbs(fix.coordinate().altitude() - 20.5) < 0.01);
+        QVERIFY(qAbs(fix.attribute(QGeoPositionInfo::GroundSpeed) - 10.0) < 0.1);
+        QVERIFY(qAbs(fix.attribute(QGeoPositionInfo::Direction) - 90.0) < 0.5);
+
+        // The last recorded point is always emitted
+        QVERIFY(fixes.last().coordinate().distanceTo(source.track().last().coordinate()) < 0.01);
+        QCOMPARE(fixes.last().timestamp(), kStartTime.addSecs(20));
+    }
+
+    void nmea_recording_replays_every_epoch() {
+        ReplaySource source;
+        QVERIFY(source.load(QStringLiteral(TEST_NMEA_DIR "/ublox_10hz.nmea")));
+        QCOMPARE(source.track().size(), 30);
+        QCOMPARE(source.duration(), qint64(2900));
+
+        source.setSpeed(ReplaySource::kAsFastAsPossible);
+        const QList<QGeoPositionInfo> fixes = replayAll(source);
+        QCOMPARE(fixes.size(), 30);
+        for (int i = 0; i < fixes.size(); ++i) {
+            QCOMPARE(fixes[i].timestamp(), source.track()[i].timestamp());
+            QVERIFY(fixes[i].coordinate().distanceTo(source.track()[i].coordinate()) < 0.01);
+        }
+    }
+
+    void replay_runs_at_a_multiple_of_real_time() {
+        ReplaySource source;
+        QVERIFY(source.load(writeGpx(dir_, 3, true)));
+        source.setSpeed(10.0);
+        source.setUpdateInterval(1000);
+
+        QElapsedTimer clock;
+        clock.start();
+        const QList<QGeoPositionInfo> fixes = replayAll(source);
+        // 20 s of recording at 10x
+        QCOMPARE(fixes.size(), 21);
+        QVERIFY2(clock.elapsed() >= 1900, qPrintable(QString::number(clock.elapsed())));
+    }
+
+    void looping_replay_starts_again() {
+        ReplaySource source;
+        QVERIFY(source.load(writeGpx(dir_, 3, true)));
+        source.setSpeed(ReplaySource::kAsFastAsPossible);
+        source.setUpdateInterval(1000);
+        source.setLoop(true);
+
+        QSignalSpy finished(&source, &ReplaySource::finished);
+        QList<QGeoPositionInfo> fixes;
+        connect(&source, &QGeoPositionInfoSource::positionUpdated,
+                [&fixes](const QGeoPositionInfo& info) { fixes << info; });
+        source.startUpdates();
+        QTRY_VERIFY(fixes.size() > 50);
+        source.stopUpdates();
+        QCOMPARE(finished.count(), 0);
+        QCOMPARE(fixes.at(21).timestamp(), kStartTime);
+    }
+
+    void untimed_gpx_is_driven_at_nominal_speed() {
+        ReplaySource source;
+        QVERIFY(source.load(writeGpx(dir_, 3, false)));
+        // 200 m at 50 km/h
+        QVERIFY(qAbs(source.duration() - 14400) < 10);
+
+        source.setSpeed(ReplaySource::kAsFastAsPossible);
+        const QList<QGeoPositionInfo> fixes = replayAll(source);
+        QVERIFY(fixes.size() > 100);
+        QVERIFY(qAbs(fixes.at(10).attribute(QGeoPositionInfo::GroundSpeed) - 50.0 / 3.6) < 0.1);
+    }
+
+    void missing_recording_reports_an_error() {
+        ReplaySource source;
+        QVERIFY(!source.load(dir_.filePath("missing.gpx")));
+        QCOMPARE(source.error(), QGeoPositionInfoSource::AccessError);
+        QSignalSpy errors(&source, &QGeoPositionInfoSource::errorOccurred);
+        source.startUpdates();
+        QCOMPARE(errors.count(), 1);
+        QVERIFY(!source.isRunning());
+    }
+
+    void pinned_replay_feeds_the_hub() {
+        LocationHub hub;
+        hub.setReplay(writeGpx(dir_, 3, true), ReplaySource::kAsFastAsPossible, false);
+        hub.pinDevice(LocationHub::DeviceMode::Replay);
+        QVERIFY(qobject_cast<ReplaySource*>(hub.source()));
+
+        // A GPS device chosen in the UI does not displace the replay
+        hub.useDevice(LocationHub::DeviceMode::USB);
+        QCOMPARE(hub.device(), LocationHub::DeviceMode::Replay);
+        QVERIFY(qobject_cast<ReplaySource*>(hub.source()));
+
+        // Decimated in recording time, whatever the replay speed
+        int fast = 0;
+        hub.subscribe("fast", LocationHub::Policy(), [&fast](const QGeoPositionInfo&) { ++fast; });
+        LocationHub::Policy policy;
+        policy.min_interval_ms = 5000;
+        QList<QGeoPositionInfo> fixes;
+        hub.subscribe("slow", policy, [&fixes](const QGeoPositionInfo& info) { fixes << info; });
+        QSignalSpy finished(hub.source(), SIGNAL(finished()));
+        QVERIFY(finished.wait(10000));
+        QCOMPARE(hub.fixesReceived(), quint64(201));
+        QCOMPARE(fast, 201);
+        QCOMPARE(fixes.size(), 5);
+        QCOMPARE(fixes.last().timestamp(), kStartTime.addSecs(20));
+    }
+};
+
+QTEST_MAIN(TestReplaySource)
+#include "test_replay_source.moc"
@@ -0,0 +1,143 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include "core/capabilities/CapabilityManager.hpp"
+#include "core/capabilities/ResourceAccounting.hpp"
+#include "core/events/event_bus.hpp"
+
+using namespace opencardev::crankshaft::core;
+using namespace opencardev::crankshaft::core::capabilities;
+
+namespace {
+
+void spin(int ms) {
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < ms) {
+    }
+}
+
+template <typename T>
+std::shared_ptr<T> grant(CapabilityManager& mgr, const QString& id, const QString& type,
+                         const QVariantMap& options = {}) {
+    return std::dynamic_pointer_cast<T>(mgr.grantCapability(id, type, options));
+}
+
+}  // namespace
+
+class TestResourceAccounting : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void nested_scopes_charge_each_extension_exclusively() {
+        ResourceAccounting accounting;
+        auto outer = accounting.usage("outer");
+        auto inner = accounting.usage("inner");
+
+        {
+            ResourceScope outerScope(outer.get());
+            spin(20);
+            {
+                ResourceScope innerScope(inner.get());
+                spin(40);
+            }
+        }
+
+        const auto outerCounters = accounting.counters("outer");
+        const auto innerCounters = accounting.counters("inner");
+        QCOMPARE(outerCounters.calls, quint64(1));
+        QCOMPARE(innerCounters.calls, quint64(1));
+        QVERIFY(innerCounters.wall_ns >= 40000000ULL);
+        QVERIFY(innerCounters.cpu_ns > 0);
+        // The inner span is not charged to the outer extension as well
+        QVERIFY(outerCounters.wall_ns >= 20000000ULL);
+        QVERIFY(outerCounters.wall_ns < 40000000ULL);
+    }
+
+    void null_scope_is_a_no_op() {
+        ResourceAccounting accounting;
+        auto usage = accounting.usage("ext");
+        {
+            ResourceScope scope(usage.get());
+            ResourceScope ignored(nullptr);
+            spin(5);
+        }
+        QCOMPARE(accounting.counters("ext").calls, quint64(1));
+    }
+
+    void capabilities_charge_events_and_file_bytes() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        mgr.setExtensionPermissions("emitter", {"event", "filesystem"});
+        mgr.setExtensionPermissions("listener", {"event"});
+
+        auto listenerEvents = grant<EventCapability>(mgr, "listener", "event");
+        QVERIFY(listenerEvents->subscribe("*.ping", [](const QVariantMap&) { spin(5); }) > 0);
+
+        auto emitterEvents = grant<EventCapability>(mgr, "emitter", "event");
+        QVERIFY(emitterEvents->emitEvent("ping", {}));
+
+        auto files = grant<FileSystemCapability>(mgr, "emitter", "filesystem",
+                                                 {{"scope_path", dir.path()}});
+        std::unique_ptr<QFile> out(files->openFile("data.bin", QIODevice::WriteOnly));
+        QVERIFY(out);
+        QCOMPARE(out->write(QByteArray(100, 'x')), qint64(100));
+        out->close();
+        std::unique_ptr<QFile> in(files->openFile("data.bin", QIODevice::ReadOnly));
+        QVERIFY(in);
+        QCOMPARE(in->readAll().size(), 100);
+
+        const QVariantList snapshot = mgr.getResourceUsage();
+        QCOMPARE(snapshot.size(), 2);
+        const QVariantMap emitter = snapshot.at(0).toMap();
+        const QVariantMap listener = snapshot.at(1).toMap();
+        QCOMPARE(emitter["id"].toString(), QString("emitter"));
+        QCOMPARE(emitter["events_emitted"].toULongLong(), quint64(1));
+        QCOMPARE(emitter["fs_bytes_written"].toULongLong(), quint64(100));
+        QCOMPARE(emitter["fs_bytes_read"].toULongLong(), quint64(100));
+        QCOMPARE(listener["events_received"].toULongLong(), quint64(1));
+        QCOMPARE(listener["calls"].toULongLong(), quint64(1));
+        QVERIFY(listener["wall_ms"].toDouble() >= 5.0);
+    }
+
+    void snapshots_are_published_on_the_bus() {
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        mgr.resourceUsage("ext")->addNetworkIn(42);
+
+        QVariantMap received;
+        bus.subscribe("core.diagnostics.resources",
+                      [&](const QVariantMap& snapshot) { received = snapshot; });
+        mgr.enableResourceSnapshots(10);
+
+        QTRY_VERIFY(!received.isEmpty());
+        QCOMPARE(received["interval_ms"].toInt(), 10);
+        const QVariantList extensions = received["extensions"].toList();
+        QCOMPARE(extensions.size(), 1);
+        QCOMPARE(extensions.first().toMap()["net_bytes_in"].toULongLong(), quint64(42));
+    }
+};
+
+QTEST_MAIN(TestResourceAccounting)
+#include "test_resource_accounting.moc"
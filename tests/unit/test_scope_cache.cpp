@@ -0,0 +1,251 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QtTest/QtTest>
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThread>
+#include "core/capabilities/CapabilityManager.hpp"
+#include "core/capabilities/ScopeCache.hpp"
+#include "core/events/event_bus.hpp"
+
+using namespace opencardev::crankshaft::core;
+using namespace opencardev::crankshaft::core::capabilities;
+
+namespace {
+
+constexpr int kTileBytes = 10240;
+
+using CacheQuota = FileSystemCapability::CacheQuota;
+
+QString tile(int i) {
+    return QString("tiles/%1.png").arg(i);
+}
+
+}  // namespace
+
+class TestScopeCache : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void init() {
+        dir_ = std::make_unique<QTemporaryDir>();
+        QVERIFY(dir_->isValid());
+        mgr_ = std::make_unique<CapabilityManager>(&bus_, nullptr);
+        mgr_->setExtensionPermissions("maps", {"filesystem"});
+        files_ = std::dynamic_pointer_cast<FileSystemCapability>(
+            mgr_->grantCapability("maps", "filesystem", {{"scope_path", dir_->path()}}));
+        QVERIFY(files_);
+        QVERIFY(files_->createDirectory("tiles"));
+    }
+
+    void cleanup() {
+        files_.reset();
+        mgr_.reset();
+        // Let a background eviction finish before its directory goes
+        QThreadPool::globalInstance()->waitForDone();
+        dir_.reset();
+    }
+
+    void over_quota_evicts_the_least_recently_read() {
+        for (int i = 0; i < 10; ++i) {
+            writeTile(i);
+        }
+        // Read the first half afterwards, so the second half is least recently used
+        for (int i = 0; i < 5; ++i) {
+            QThread::msleep(2);
+            readTile(i);
+        }
+        QCOMPARE(files_->cacheStats().bytes, qint64(10 * kTileBytes));
+        QCOMPARE(files_->cacheStats().files, 10);
+
+        CacheQuota quota;
+        quota.max_bytes = 6 * kTileBytes;
+        files_->setCacheQuota(quota);
+
+        // Down to 90% of the quota: five tiles go
+        QTRY_COMPARE(files_->cacheStats().evicted_files, quint64(5));
+        const auto stats = files_->cacheStats();
+        QCOMPARE(stats.evicted_bytes, qint64(5 * kTileBytes));
+        QCOMPARE(stats.bytes, qint64(5 * kTileBytes));
+        QCOMPARE(stats.files, 5);
+        for (int i = 0; i < 10; ++i) {
+            QCOMPARE(files_->fileExists(tile(i)), i < 5);
+        }
+        QStringList listed = files_->listFiles();
+        listed.sort();
+        QCOMPARE(listed, QStringList({tile(0), tile(1), tile(2), tile(3), tile(4)}));
+    }
+
+    void lfu_policy_keeps_the_most_read() {
+        for (int i = 0; i < 4; ++i) {
+            writeTile(i);
+        }
+        // Tile 0 is read most but longest ago
+        for (int n = 0; n < 3; ++n) {
+            readTile(0);
+        }
+        for (int i = 1; i < 4; ++i) {
+            QThread::msleep(2);
+            readTile(i);
+        }
+
+        CacheQuota quota;
+        quota.max_bytes = 3 * kTileBytes;
+        quota.policy = FileSystemCapability::EvictionPolicy::LeastFrequentlyUsed;
+        files_->setCacheQuota(quota);
+
+        // 90% of three tiles leaves two: the most read, then the most recent
+        QTRY_COMPARE(files_->cacheStats().evicted_files, quint64(2));
+        QVERIFY(files_->fileExists(tile(0)));
+        QVERIFY(!files_->fileExists(tile(1)));
+        QVERIFY(!files_->fileExists(tile(2)));
+        QVERIFY(files_->fileExists(tile(3)));
+    }
+
+    void writes_past_the_quota_evict_in_the_background() {
+        CacheQuota quota;
+        quota.max_bytes = 4 * kTileBytes;
+        files_->setCacheQuota(quota);
+
+        // Held open for writing throughout: never a candidate
+        std::unique_ptr<QFile> open(files_->openFile("tiles/open.png", QIODevice::WriteOnly));
+        QVERIFY(open);
+        QCOMPARE(open->write(QByteArray(kTileBytes, 'o')), qint64(kTileBytes));
+
+        for (int i = 0; i < 20; ++i) {
+            QThread::msleep(2);
+            writeTile(i);
+        }
+        QTRY_VERIFY(files_->cacheStats().bytes <= quota.max_bytes);
+        QVERIFY(files_->cacheStats().evicted_files >= 16);
+        QVERIFY(QFile::exists(dir_->filePath("tiles/open.png")));
+        // Written last, so the most recently used
+        QVERIFY(files_->fileExists(tile(19)));
+
+        // Closing counts its size, and makes it the most recently used in turn
+        open->close();
+        QTRY_VERIFY(files_->cacheStats().bytes <= quota.max_bytes);
+        QVERIFY(files_->fileExists("tiles/open.png"));
+    }
+
+    void files_already_on_disk_are_indexed_by_mtime() {
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+        for (int i = 0; i < 4; ++i) {
+            QFile f(dir_->filePath(tile(i)));
+            QVERIFY(f.open(QIODevice::WriteOnly));
+            f.write(QByteArray(kTileBytes, 'x'));
+            QVERIFY(f.flush());
+            // Tile 0 is the newest
+            QVERIFY(f.setFileTime(now.addSecs(-60 * i), QFileDevice::FileModificationTime));
+        }
+        QCOMPARE(files_->cacheStats().files, 0);
+
+        CacheQuota quota;
+        quota.max_bytes = 2 * kTileBytes;
+        files_->setCacheQuota(quota);
+
+        QTRY_COMPARE(files_->cacheStats().evicted_files, quint64(3));
+        QCOMPARE(files_->cacheStats().files, 1);
+        QVERIFY(files_->fileExists(tile(0)));
+    }
+
+    void low_free_space_evicts_regardless_of_the_quota() {
+        for (int i = 0; i < 3; ++i) {
+            writeTile(i);
+        }
+        // More free space than any volume has: everything that can go, goes
+        CacheQuota quota;
+        quota.min_free_bytes = files_->availableSpace() + (1LL << 50);
+        files_->setCacheQuota(quota);
+        QTRY_COMPARE(files_->cacheStats().evicted_files, quint64(3));
+        QCOMPARE(files_->cacheStats().bytes, qint64(0));
+    }
+
+    void hit_rate_counts_reads_and_failed_lookups() {
+        writeTile(0);
+        QVERIFY(files_->fileExists(tile(0)));
+        readTile(0);
+        QVERIFY(files_->mapFile(tile(0)));
+        QVERIFY(!files_->fileExists(tile(1)));
+        QVERIFY(!files_->openFile(tile(1), QIODevice::ReadOnly));
+
+        const auto stats = files_->cacheStats();
+        QCOMPARE(stats.hits, quint64(2));
+        QCOMPARE(stats.misses, quint64(2));
+        QCOMPARE(stats.hitRate(), 0.5);
+    }
+
+    void deletes_are_forgotten() {
+        writeTile(0);
+        writeTile(1);
+        QVERIFY(files_->deleteFile(tile(0)));
+        QCOMPARE(files_->cacheStats().files, 1);
+        QCOMPARE(files_->cacheStats().bytes, qint64(kTileBytes));
+    }
+
+    void a_file_pinned_before_opening_is_not_evicted() {
+        writeTile(0);
+        writeTile(1);
+        auto cache = std::make_shared<ScopeCache>(std::make_shared<ScopeIndex>(dir_->path()));
+        cache->load();
+        // Pinned as a write is about to open it, with nothing read since
+        cache->writeStarted(tile(0));
+        CacheQuota quota;
+        quota.max_bytes = kTileBytes;
+        cache->setQuota(quota);
+
+        QCOMPARE(cache->evict(), qint64(kTileBytes));
+        QVERIFY(QFile::exists(dir_->filePath(tile(0))));
+        QVERIFY(!QFile::exists(dir_->filePath(tile(1))));
+        QCOMPARE(cache->stats().files, 1);
+        QCOMPARE(cache->stats().bytes, qint64(kTileBytes));
+    }
+
+    void a_failed_open_for_writing_leaves_no_entry() {
+        // The directory does not exist, so the open fails after the file was pinned
+        QVERIFY(!files_->openFile("missing/tile.png", QIODevice::WriteOnly));
+        QCOMPARE(files_->cacheStats().files, 0);
+        QCOMPARE(files_->cacheStats().bytes, qint64(0));
+        writeTile(0);
+        QCOMPARE(files_->cacheStats().files, 1);
+    }
+
+  private:
+    void writeTile(int i) {
+        std::unique_ptr<QFile> out(files_->openFile(tile(i), QIODevice::WriteOnly));
+        QVERIFY(out);
+        QCOMPARE(out->write(QByteArray(kTileBytes, char('a' + i))), qint64(kTileBytes));
+    }
+
+    void readTile(int i) {
+        std::unique_ptr<QFile> in(files_->openFile(tile(i), QIODevice::ReadOnly));
+        QVERIFY(in);
+    }
+
+    std::unique_ptr<QTemporaryDir> dir_;
+    EventBus bus_;
+    std::unique_ptr<CapabilityManager> mgr_;
+    std::shared_ptr<FileSystemCapability> files_;
+};
+
+QTEST_MAIN(TestScopeCache)
+#include "test_scope_cache.moc"
@@ -0,0 +1,121 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QThread>
+#include "core/capabilities/CapabilityManager.hpp"
+#include "core/capabilities/EventCapability.hpp"
+#include "core/diagnostics/DispatchContext.hpp"
+#include "core/diagnostics/StallWatchdog.hpp"
+#include "core/events/event_bus.hpp"
+
+using namespace opencardev::crankshaft::core;
+using namespace opencardev::crankshaft::core::diagnostics;
+using opencardev::crankshaft::core::capabilities::EventCapability;
+
+class TestStallWatchdog : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void blocking_event_callback_is_blamed_on_its_extension() {
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        mgr.setExtensionPermissions("slow", {"event"});
+        auto events = std::dynamic_pointer_cast<EventCapability>(
+            mgr.grantCapability("slow", "event"));
+        QVERIFY(events);
+        events->subscribe("slow.block", [](const QVariantMap&) { QThread::msleep(400); });
+
+        QVariantMap published;
+        bus.subscribe("core.diagnostics.stall",
+                      [&](const QVariantMap& report) { published = report; });
+        StallWatchdog watchdog(&bus);
+        QSignalSpy stalls(&watchdog, &StallWatchdog::stallDetected);
+        watchdog.start(100);
+        QTest::qWait(100);
+
+        bus.publish("slow.block");
+        QTRY_COMPARE(stalls.count(), 1);
+
+        const QVariantMap report = stalls.at(0).at(0).toMap();
+        QCOMPARE(report["blame"].toString(), QString("slow"));
+        QCOMPARE(report["blame_source"].toString(), QString("dispatch"));
+        QCOMPARE(report["operation"].toString(), QString("event callback"));
+        QCOMPARE(report["detail"].toString(), QString("slow.block"));
+        QVERIFY(report["duration_ms"].toDouble() >= 300.0);
+        // The bus dispatch, then the extension's callback
+        const QVariantList frames = report["frames"].toList();
+        QCOMPARE(frames.size(), 2);
+        QCOMPARE(frames.at(0).toMap()["operation"].toString(), QString("event"));
+        QCOMPARE(frames.at(0).toMap()["detail"].toString(), QString("slow.block"));
+
+        QCOMPARE(published["blame"].toString(), QString("slow"));
+        QCOMPARE(watchdog.recentStalls().size(), 1);
+        // Stack sampling is opt-in
+        QVERIFY(report["stack"].toList().isEmpty());
+    }
+
+    void stall_after_a_capability_call_is_blamed_on_its_caller() {
+        EventBus bus;
+        CapabilityManager mgr(&bus, nullptr);
+        StallWatchdog watchdog(&bus);
+        watchdog.setStackSampling(true);
+        QSignalSpy stalls(&watchdog, &StallWatchdog::stallDetected);
+        watchdog.start(100);
+        QTest::qWait(100);
+
+        // Extension code running from its own timer, outside any dispatch frame
+        mgr.logCapabilityUsage("chatty", "network", "get", "http://example.invalid");
+        QThread::msleep(400);
+        QTRY_COMPARE(stalls.count(), 1);
+
+        const QVariantMap report = stalls.at(0).at(0).toMap();
+        QCOMPARE(report["blame"].toString(), QString("chatty"));
+        QCOMPARE(report["blame_source"].toString(), QString("capability call"));
+        QCOMPARE(report["operation"].toString(), QString("network"));
+        QCOMPARE(report["detail"].toString(), QString("get"));
+#if defined(Q_OS_LINUX) && defined(__GLIBC__)
+        QVERIFY(!report["stack"].toList().isEmpty());
+#endif
+    }
+
+    void short_blocks_are_not_reported() {
+        EventBus bus;
+        StallWatchdog watchdog(&bus);
+        QSignalSpy stalls(&watchdog, &StallWatchdog::stallDetected);
+        watchdog.start(200);
+        QTest::qWait(100);
+
+        QThread::msleep(30);
+        QTest::qWait(300);
+        QCOMPARE(stalls.count(), 0);
+    }
+
+    void zero_threshold_disables_the_watchdog() {
+        StallWatchdog watchdog(nullptr);
+        watchdog.start(100);
+        QVERIFY(watchdog.isRunning());
+        watchdog.start(0);
+        QVERIFY(!watchdog.isRunning());
+    }
+};
+
+QTEST_MAIN(TestStallWatchdog)
+#include "test_stall_watchdog.moc"
@@ -0,0 +1,227 @@
+/*
+ * Project: Crankshaft
+ * This file is part of Crankshaft project.
+ * Copyright (C) 2025 OpenCarDev Team
+ *
+ *  Crankshaft is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Crankshaft is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Crankshaft. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QThread>
+#include <algorithm>
+#include "core/diagnostics/Trace.hpp"
+
+using namespace opencardev::crankshaft::core::diagnostics;
+
+namespace {
+
+// One protobuf field: varint value or length-delimited payload
+struct ProtoField {
+    int number = 0;
+    quint64 value = 0;
+    QByteArray bytes;
+};
+
+QList<ProtoField> parseProto(const QByteArray& data) {
+    QList<ProtoField> fields;
+    int pos = 0;
+    auto varint = [&]() {
+        quint64 value = 0;
+        for (int shift = 0; pos < data.size(); shift += 7) {
+            const quint8 byte = quint8(data.at(pos++));
+            value |= quint64(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                break;
+            }
+        }
+        return value;
+    };
+    while (pos < data.size()) {
+        const quint64 tag = varint();
+        ProtoField field;
+        field.number = int(tag >> 3);
+        if ((tag & 7) == 0) {
+            field.value = varint();
+        } else {
+            const int size = int(varint());
+            field.bytes = data.mid(pos, size);
+            pos += size;
+        }
+        fields << field;
+    }
+    return fields;
+}
+
+ProtoField findField(const QList<ProtoField>& fields, int number) {
+    for (const ProtoField& field : fields) {
+        if (field.number == number) {
+            return field;
+        }
+    }
+    return {};
+}
+
+QJsonArray readChromeEvents(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    return QJsonDocument::fromJson(file.readAll()).object()["traceEvents"].toArray();
+}
+
+QJsonObject findEvent(const QJsonArray& events, const QString& name) {
+    for (const QJsonValue& value : events) {
+        if (value.toObject()["name"].toString() == name) {
+            return value.toObject();
+        }
+    }
+    return {};
+}
+
+}  // namespace
+
+class TestTrace : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void cleanup() { Tracer::stop(); }
+
+    void disabled_tracer_records_nothing() {
+        Tracer::start();
+        Tracer::stop();
+        {
+            CRANKSHAFT_TRACE_SCOPE("test", "ignored");
+            CRANKSHAFT_TRACE_INSTANT("test", "ignored instant");
+        }
+        QCOMPARE(Tracer::eventCount(), 0);
+    }
+
+    void nested_spans_are_written_as_chrome_json() {
+        QTemporaryDir dir;
+        Tracer::start();
+        {
+            CRANKSHAFT_TRACE_SCOPE("test", "outer");
+            QThread::msleep(2);
+            {
+                CRANKSHAFT_TRACE_SCOPE_DETAIL("test", "inner", QStringLiteral("detail text"));
+                QThread::msleep(2);
+            }
+            CRANKSHAFT_TRACE_INSTANT("test", "marker");
+        }
+        Tracer::stop();
+        QCOMPARE(Tracer::eventCount(), 3);
+
+        const QString path = dir.filePath("startup.json");
+        QCOMPARE(Tracer::formatFor(path), Tracer::Format::ChromeJson);
+        QVERIFY(Tracer::write(path));
+
+        const QJsonArray events = readChromeEvents(path);
+        const QJsonObject outer = findEvent(events, "outer");
+        const QJsonObject inner = findEvent(events, "inner");
+        QCOMPARE(outer["ph"].toString(), QString("X"));
+        QCOMPARE(inner["ph"].toString(), QString("X"));
+        QCOMPARE(inner["cat"].toString(), QString("test"));
+        QCOMPARE(inner["args"].toObject()["detail"].toString(), QString("detail text"));
+        QVERIFY(inner["ts"].toDouble() >= outer["ts"].toDouble());
+        QVERIFY(inner["ts"].toDouble() + inner["dur"].toDouble() <=
+                outer["ts"].toDouble() + outer["dur"].toDouble());
+        QVERIFY(inner["dur"].toDouble() >= 2000.0);
+        QCOMPARE(findEvent(events, "marker")["ph"].toString(), QString("i"));
+        QCOMPARE(findEvent(events, "process_name")["ph"].toString(), QString("M"));
+    }
+
+    void each_thread_gets_its_own_track() {
+        QTemporaryDir dir;
+        Tracer::start();
+        { CRANKSHAFT_TRACE_SCOPE("test", "on main"); }
+        QThread* worker = QThread::create([]() {
+            Tracer::setThreadName(QStringLiteral("worker"));
+            CRANKSHAFT_TRACE_SCOPE("test", "on worker");
+        });
+        worker->start();
+        QVERIFY(worker->wait(5000));
+        delete worker;
+        Tracer::stop();
+
+        const QString path = dir.filePath("threads.json");
+        QVERIFY(Tracer::write(path));
+        const QJsonArray events = readChromeEvents(path);
+        const int main_tid = findEvent(events, "on main")["tid"].toInt();
+        const int worker_tid = findEvent(events, "on worker")["tid"].toInt();
+        QVERIFY(main_tid != worker_tid);
+
+        bool named = false;
+        for (const QJsonValue& value : events) {
+            const QJsonObject event = value.toObject();
+            if (event["name"].toString() == "thread_name" && event["tid"].toInt() == worker_tid) {
+                named = event["args"].toObject()["name"].toString() == "worker";
+            }
+        }
+        QVERIFY(named);
+    }
+
+    void perfetto_trace_has_balanced_slices() {
+        QTemporaryDir dir;
+        Tracer::start();
+        {
+            CRANKSHAFT_TRACE_SCOPE("test", "outer");
+            { CRANKSHAFT_TRACE_SCOPE_DETAIL("test", "first", QStringLiteral("a")); }
+            { CRANKSHAFT_TRACE_SCOPE("test", "second"); }
+        }
+        Tracer::stop();
+
+        const QString path = dir.filePath("startup.pftrace");
+        QCOMPARE(Tracer::formatFor(path), Tracer::Format::Perfetto);
+        QVERIFY(Tracer::write(path));
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+
+        // Trace.packet -> TracePacket.track_event -> TrackEvent.type / name
+        QStringList begins;
+        int ends = 0;
+        int depth = 0;
+        int max_depth = 0;
+        int descriptors = 0;
+        for (const ProtoField& packet : parseProto(file.readAll())) {
+            QCOMPARE(packet.number, 1);
+            const QList<ProtoField> fields = parseProto(packet.bytes);
+            if (!findField(fields, 60).bytes.isEmpty()) {
+                ++descriptors;
+                continue;
+            }
+            const QList<ProtoField> event = parseProto(findField(fields, 11).bytes);
+            QVERIFY(findField(fields, 8).value > 0);
+            if (findField(event, 9).value == 1) {
+                begins << QString::fromUtf8(findField(event, 23).bytes);
+                max_depth = std::max(max_depth, ++depth);
+            } else if (findField(event, 9).value == 2) {
+                ++ends;
+                --depth;
+                QVERIFY(depth >= 0);
+            }
+        }
+        QCOMPARE(descriptors, 2);  // Process and main thread
+        QCOMPARE(begins, QStringList({"outer", "first", "second"}));
+        QCOMPARE(ends, 3);
+        QCOMPARE(max_depth, 2);
+    }
+};
+
+QTEST_MAIN(TestTrace)
+#include "test_trace.moc"
@@ -1,7 +1,10 @@
 import QtQuick 2.15
 
 QtObject {
+    property var pagesModel: null
     function getConfigPage(domain, extension) { return null; }
+    function getPageInfo(domain, extension) { return ({}); }
+    function sectionsModel(domain, extension) { return null; }
     function getAllConfigPages() { return []; }
     function getValue(key, defaultValue) { return defaultValue; }
     function setValue(key, value) { }